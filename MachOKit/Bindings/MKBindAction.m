@@ -32,6 +32,7 @@
 #import "MKMachO+Segments.h"
 #import "MKSegment.h"
 #import "MKSection.h"
+#import "MKNodeSerializer.h"
 
 static NSSet *_subclasses = NULL;
 //----------------------------------------------------------------------------//
@@ -152,6 +153,10 @@ static NSSet *_subclasses = NULL;
 	return [(MKBackedNode*)self.parent nodeAddress:type] + _nodeOffset;
 }
 
+//|++++++++++++++++++++++++++++++++++++|//
++ (BOOL)hasInvariantLayout
+{ return YES; }
+
 //|++++++++++++++++++++++++++++++++++++|//
 - (MKNodeDescription*)layout
 {
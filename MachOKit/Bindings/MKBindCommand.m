@@ -28,6 +28,7 @@
 #import "MKBindCommand.h"
 #import "MKInternal.h"
 #import "MKBindingsInfo.h"
+#import "MKNodeSerializer.h"
 
 static NSSet *_subclasses = NULL;
 //----------------------------------------------------------------------------//
@@ -175,6 +176,10 @@ static NSSet *_subclasses = NULL;
 #pragma mark -  MKNode
 //◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦//
 
+//|++++++++++++++++++++++++++++++++++++|//
++ (BOOL)hasInvariantLayout
+{ return YES; }
+
 //|++++++++++++++++++++++++++++++++++++|//
 - (MKNodeDescription*)layout
 {
@@ -56,6 +56,8 @@ struct MKBindContext
     uint8_t type;
     uint8_t symbolFlags;
     bool useThreadedRebaseBind;
+    // Set by the bind handler to stop the current command.
+    bool stop;
     uint64_t count;
     union {
         uint64_t raw; // already byte swapped
@@ -96,7 +96,7 @@
     
     bindContext->count = self.count;
     
-    for (uint64_t i = 0; i < bindContext->count; i++) {
+    for (uint64_t i = 0; i < bindContext->count && !bindContext->stop; i++) {
         binder();
         
         mk_error_t err;
@@ -0,0 +1,165 @@
+//----------------------------------------------------------------------------//
+//|
+//|             MachOKit - A Lightweight Mach-O Parsing Library
+//! @file       MKBindTable.h
+//!
+//! @author     D.V.
+//! @copyright  Copyright (c) 2014-2015 D.V. All rights reserved.
+//|
+//| Permission is hereby granted, free of charge, to any person obtaining a
+//| copy of this software and associated documentation files (the "Software"),
+//| to deal in the Software without restriction, including without limitation
+//| the rights to use, copy, modify, merge, publish, distribute, sublicense,
+//| and/or sell copies of the Software, and to permit persons to whom the
+//| Software is furnished to do so, subject to the following conditions:
+//|
+//| The above copyright notice and this permission notice shall be included
+//| in all copies or substantial portions of the Software.
+//|
+//| THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+//| OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+//| MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+//| IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+//| CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+//| TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+//| SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+//----------------------------------------------------------------------------//
+
+#include <MachOKit/macho.h>
+#import <Foundation/Foundation.h>
+
+#import <MachOKit/MKLinkEditNode.h>
+#import <MachOKit/MKBindingsFieldType.h>
+
+NS_ASSUME_NONNULL_BEGIN
+
+//----------------------------------------------------------------------------//
+//! @name       Bind Table Kinds
+//! @relates    MKBindTable
+//
+typedef NS_ENUM(NSUInteger, MKBindTableKind) {
+    //! The opcodes at \c bind_off in \c LC_DYLD_INFO.
+    MKBindTableKindBind = 0,
+    //! The opcodes at \c weak_bind_off in \c LC_DYLD_INFO.
+    MKBindTableKindWeakBind,
+    //! The opcodes at \c lazy_bind_off in \c LC_DYLD_INFO.
+    MKBindTableKindLazyBind
+};
+
+
+
+//----------------------------------------------------------------------------//
+//! @name       Streamed Binds
+//! @relates    MKBindTable
+//!
+//! A bind produced while running the bind opcodes.  The \c symbolName
+//! points into the mapped opcode stream and is only valid for the duration
+//! of the enumeration block.
+//
+typedef struct MKBindTableEntry {
+    MKBindType type;
+    uint8_t symbolFlags;
+    uint32_t segmentIndex;
+    int64_t libraryOrdinal;
+    int64_t addend;
+    //! The offset of the bound location from the start of its segment.
+    uint64_t segmentOffset;
+    //! The VM address of the bound location.
+    mk_vm_address_t address;
+    const char *symbolName;
+} MKBindTableEntry;
+
+
+
+//----------------------------------------------------------------------------//
+//! @name       Bind Table Records
+//! @relates    MKBindTable
+//!
+//! Records are owned by the \ref MKBindTable instance that produced them and
+//! remain valid for its lifetime.
+//
+
+//! A distinct symbol and library pair referenced by one or more bound
+//! locations.
+typedef struct MKBindTableSymbol {
+    const char *name;
+    int64_t libraryOrdinal;
+    uint8_t flags;
+} MKBindTableSymbol;
+
+//! A bound location.
+typedef struct MKBindTableLocation {
+    uint64_t segmentOffset;
+    int64_t addend;
+    //! Index into the \c symbols of the table.
+    uint32_t symbolIndex;
+    uint16_t segmentIndex;
+    MKBindType type;
+} MKBindTableLocation;
+
+
+
+//----------------------------------------------------------------------------//
+//! An instance of \c MKBindTable runs the bind opcodes of an image directly
+//! over the mapped opcode stream, including threaded binds, without
+//! creating an \ref MKBindCommand or \ref MKBindAction node per opcode or
+//! per bound location.
+//!
+//! Binds can either be streamed with
+//! \ref -enumerateBindsWithError:usingBlock:, or collected into a compact
+//! table that stores each distinct symbol and library pair once.
+//!
+//! @note
+//! Threaded rebases are not reported.  Use \ref MKBindingsInfo if you need
+//! them.
+//
+@interface MKBindTable : MKLinkEditNode {
+@package
+    MKBindTableKind _kind;
+    BOOL _tableBuilt;
+    NSUInteger _symbolCount;
+    MKBindTableSymbol *_symbols;
+    NSUInteger _locationCount;
+    MKBindTableLocation *_locations;
+    char *_strings;
+}
+
+//! Initializes the receiver with the opcodes of the given \a kind.  An image
+//! without any opcodes of that kind yields an empty table.
+- (nullable instancetype)initWithImage:(MKMachOImage*)image kind:(MKBindTableKind)kind error:(NSError**)error;
+
+@property (nonatomic, assign, readonly) MKBindTableKind kind;
+
+//◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦//
+#pragma mark -  Streaming
+//! @name       Streaming
+//◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦//
+
+//! Runs the bind opcodes, invoking \a block for each bound location in
+//! opcode order.  Set \a stop to \c YES to end the enumeration early.
+//!
+//! @return
+//! \c NO if the opcodes could not be mapped or are malformed.  Binds
+//! preceding the malformed opcode will already have been reported.
+- (BOOL)enumerateBindsWithError:(NSError**)error usingBlock:(void (^)(const MKBindTableEntry *entry, BOOL *stop))block;
+
+//◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦//
+#pragma mark -  Compact Table
+//! @name       Compact Table
+//!
+//! The table is built on first access.  If the opcodes are malformed, the
+//! table holds the binds preceding the malformed opcode and a warning is
+//! recorded on the receiver.
+//◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦//
+
+@property (nonatomic, assign, readonly) NSUInteger symbolCount;
+//! The distinct symbol and library pairs, in order of first use.
+@property (nonatomic, assign, readonly, nullable) const MKBindTableSymbol *symbols;
+
+@property (nonatomic, assign, readonly) NSUInteger locationCount;
+//! The bound locations, in opcode order.
+@property (nonatomic, assign, readonly, nullable) const MKBindTableLocation *locations;
+
+@end
+
+NS_ASSUME_NONNULL_END
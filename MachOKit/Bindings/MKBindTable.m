@@ -0,0 +1,747 @@
+//----------------------------------------------------------------------------//
+//|
+//|             MachOKit - A Lightweight Mach-O Parsing Library
+//|             MKBindTable.m
+//|
+//|             D.V.
+//|             Copyright (c) 2014-2015 D.V. All rights reserved.
+//|
+//| Permission is hereby granted, free of charge, to any person obtaining a
+//| copy of this software and associated documentation files (the "Software"),
+//| to deal in the Software without restriction, including without limitation
+//| the rights to use, copy, modify, merge, publish, distribute, sublicense,
+//| and/or sell copies of the Software, and to permit persons to whom the
+//| Software is furnished to do so, subject to the following conditions:
+//|
+//| The above copyright notice and this permission notice shall be included
+//| in all copies or substantial portions of the Software.
+//|
+//| THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+//| OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+//| MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+//| IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+//| CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+//| TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+//| SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+//----------------------------------------------------------------------------//
+
+
+#import "MKBindTable.h"
+#import "MKInternal.h"
+#import "MKMachO.h"
+#import "MKMachO+Segments.h"
+#import "MKLCDyldInfo.h"
+#import "MKSegment.h"
+
+#include "_mach_trie.h"
+#include <malloc/malloc.h>
+
+//! An entry in the ordinal table of a threaded bind.
+struct MKBindTableThreadedSymbol {
+    const char *symbolName;
+    int64_t libraryOrdinal;
+    int64_t addend;
+    uint8_t symbolFlags;
+};
+
+//! State used while collecting streamed binds into the compact table.
+struct MKBindTableBuilder {
+    MKBindTableSymbol *symbols;
+    uint64_t *symbolHashes;
+    size_t *nameOffsets;
+    size_t symbolCount;
+    size_t symbolCapacity;
+    // Open-addressed, holds (symbol index + 1).
+    uint32_t *slots;
+    size_t slotCount;
+    MKBindTableLocation *locations;
+    size_t locationCount;
+    size_t locationCapacity;
+    char *strings;
+    size_t stringsLength;
+    size_t stringsCapacity;
+    // The most recently interned symbol.  Consecutive binds almost always
+    // share a symbol.
+    const char *lastName;
+    int64_t lastOrdinal;
+    uint8_t lastFlags;
+    uint32_t lastIndex;
+};
+
+//|++++++++++++++++++++++++++++++++++++|//
+static uint64_t
+MKBindTableSymbolHash(const char *name, int64_t ordinal, uint8_t flags)
+{
+    uint64_t hash = 0xcbf29ce484222325ULL;
+    for (const char *c = name; *c != '\0'; c++) {
+        hash ^= (uint8_t)*c;
+        hash *= 0x100000001b3ULL;
+    }
+    hash ^= (uint64_t)ordinal;
+    hash *= 0x100000001b3ULL;
+    hash ^= flags;
+    hash *= 0x100000001b3ULL;
+    return hash;
+}
+
+//|++++++++++++++++++++++++++++++++++++|//
+static bool
+MKBindTableBuilderGrow(void **buffer, size_t *capacity, size_t required, size_t elementSize)
+{
+    if (required <= *capacity)
+        return true;
+    
+    size_t newCapacity = *capacity ? *capacity : 64;
+    while (newCapacity < required)
+        newCapacity *= 2;
+    
+    void *newBuffer = realloc(*buffer, newCapacity * elementSize);
+    if (newBuffer == NULL)
+        return false;
+    
+    *buffer = newBuffer;
+    *capacity = newCapacity;
+    return true;
+}
+
+//|++++++++++++++++++++++++++++++++++++|//
+static bool
+MKBindTableBuilderRehash(struct MKBindTableBuilder *builder, size_t slotCount)
+{
+    uint32_t *slots = calloc(slotCount, sizeof(uint32_t));
+    if (slots == NULL)
+        return false;
+    
+    for (size_t i = 0; i < builder->symbolCount; i++) {
+        size_t slot = (size_t)builder->symbolHashes[i] & (slotCount - 1);
+        while (slots[slot] != 0)
+            slot = (slot + 1) & (slotCount - 1);
+        slots[slot] = (uint32_t)(i + 1);
+    }
+    
+    free(builder->slots);
+    builder->slots = slots;
+    builder->slotCount = slotCount;
+    return true;
+}
+
+//|++++++++++++++++++++++++++++++++++++|//
+static bool
+MKBindTableBuilderInternSymbol(struct MKBindTableBuilder *builder, const char *name, int64_t ordinal, uint8_t flags, uint32_t *index)
+{
+    if (name == NULL)
+        name = "";
+    
+    if (builder->symbolCount > 0 && name == builder->lastName && ordinal == builder->lastOrdinal && flags == builder->lastFlags) {
+        *index = builder->lastIndex;
+        return true;
+    }
+    
+    uint64_t hash = MKBindTableSymbolHash(name, ordinal, flags);
+    size_t slot = 0;
+    
+    if (builder->slotCount > 0) {
+        slot = (size_t)hash & (builder->slotCount - 1);
+        
+        while (builder->slots[slot] != 0) {
+            uint32_t candidate = builder->slots[slot] - 1;
+            MKBindTableSymbol *symbol = &builder->symbols[candidate];
+            
+            if (builder->symbolHashes[candidate] == hash && symbol->libraryOrdinal == ordinal && symbol->flags == flags && strcmp(builder->strings + builder->nameOffsets[candidate], name) == 0) {
+                *index = candidate;
+                goto found;
+            }
+            
+            slot = (slot + 1) & (builder->slotCount - 1);
+        }
+    }
+    
+    // Not yet interned.
+    if (builder->symbolCount >= UINT32_MAX - 1)
+        return false;
+    
+    {
+        size_t symbolCapacity = builder->symbolCapacity;
+        if (!MKBindTableBuilderGrow((void**)&builder->symbols, &symbolCapacity, builder->symbolCount + 1, sizeof(MKBindTableSymbol)))
+            return false;
+        symbolCapacity = builder->symbolCapacity;
+        if (!MKBindTableBuilderGrow((void**)&builder->symbolHashes, &symbolCapacity, builder->symbolCount + 1, sizeof(uint64_t)))
+            return false;
+        symbolCapacity = builder->symbolCapacity;
+        if (!MKBindTableBuilderGrow((void**)&builder->nameOffsets, &symbolCapacity, builder->symbolCount + 1, sizeof(size_t)))
+            return false;
+        builder->symbolCapacity = symbolCapacity;
+        
+        size_t nameLength = strlen(name) + 1;
+        if (!MKBindTableBuilderGrow((void**)&builder->strings, &builder->stringsCapacity, builder->stringsLength + nameLength, sizeof(char)))
+            return false;
+        memcpy(builder->strings + builder->stringsLength, name, nameLength);
+        
+        *index = (uint32_t)builder->symbolCount;
+        builder->symbols[*index] = (MKBindTableSymbol){ .name = NULL, .libraryOrdinal = ordinal, .flags = flags };
+        builder->symbolHashes[*index] = hash;
+        builder->nameOffsets[*index] = builder->stringsLength;
+        builder->stringsLength += nameLength;
+        builder->symbolCount++;
+    }
+    
+    // Keep the load factor under 3/4.
+    if (builder->symbolCount * 4 > builder->slotCount * 3) {
+        if (!MKBindTableBuilderRehash(builder, builder->slotCount ? builder->slotCount * 2 : 256))
+            return false;
+    } else {
+        builder->slots[slot] = *index + 1;
+    }
+    
+found:
+    builder->lastName = name;
+    builder->lastOrdinal = ordinal;
+    builder->lastFlags = flags;
+    builder->lastIndex = *index;
+    return true;
+}
+
+
+
+//----------------------------------------------------------------------------//
+@implementation MKBindTable
+
+@synthesize kind = _kind;
+
+//|++++++++++++++++++++++++++++++++++++|//
+- (instancetype)initWithImage:(MKMachOImage*)image kind:(MKBindTableKind)kind error:(NSError**)error
+{
+    NSParameterAssert(image != nil);
+    
+    // Find LC_DYLD_INFO
+    MKLCDyldInfo *dyldInfoLoadCommand = [image loadCommandsOfType:LC_DYLD_INFO].firstObject;
+    if (dyldInfoLoadCommand == nil)
+        dyldInfoLoadCommand = [image loadCommandsOfType:LC_DYLD_INFO_ONLY].firstObject;
+    
+    if (dyldInfoLoadCommand == nil) {
+        MK_ERROR_OUT = [NSError mk_errorWithDomain:MKErrorDomain code:MK_ENOT_FOUND description:@"Image does not contain a LC_DYLD_INFO load command."];
+        return nil;
+    }
+    
+    uint32_t offset, size;
+    switch (kind) {
+        case MKBindTableKindBind:
+            offset = dyldInfoLoadCommand.bind_off;
+            size = dyldInfoLoadCommand.bind_size;
+            break;
+        case MKBindTableKindWeakBind:
+            offset = dyldInfoLoadCommand.weak_bind_off;
+            size = dyldInfoLoadCommand.weak_bind_size;
+            break;
+        case MKBindTableKindLazyBind:
+            offset = dyldInfoLoadCommand.lazy_bind_off;
+            size = dyldInfoLoadCommand.lazy_bind_size;
+            break;
+        default:
+            MK_ERROR_OUT = [NSError mk_errorWithDomain:MKErrorDomain code:MK_EINVAL description:@"Unknown bind table kind [%lu].", (unsigned long)kind];
+            return nil;
+    }
+    
+    // An offset of zero indicates that the image does not have any binds
+    // of this kind.
+    if (offset == 0)
+        size = 0;
+    
+    self = [super initWithSize:size offset:offset inImage:image error:error];
+    if (self == nil) return nil;
+    
+    _kind = kind;
+    
+    return self;
+}
+
+//|++++++++++++++++++++++++++++++++++++|//
+- (instancetype)initWithSize:(mk_vm_size_t)size offset:(mk_vm_offset_t)offset inImage:(MKMachOImage*)image error:(NSError**)error
+{
+    self = [super initWithSize:size offset:offset inImage:image error:error];
+    if (self == nil) return nil;
+    
+    _kind = MKBindTableKindBind;
+    
+    return self;
+}
+
+//|++++++++++++++++++++++++++++++++++++|//
+- (instancetype)initWithParent:(MKNode*)parent error:(NSError**)error
+{ return [self initWithImage:parent.macho kind:MKBindTableKindBind error:error]; }
+
+//|++++++++++++++++++++++++++++++++++++|//
+- (void)dealloc
+{
+    free(_symbols);
+    free(_locations);
+    free(_strings);
+}
+
+//◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦//
+#pragma mark -  Estimating Memory Usage
+//◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦//
+
+//|++++++++++++++++++++++++++++++++++++|//
+- (NSUInteger)estimatedMemoryCost
+{
+    // The table is built on first access.  Until then only the opcodes are
+    // retained.
+    @synchronized(self) {
+        return super.estimatedMemoryCost + malloc_size(_symbols) + malloc_size(_locations) + malloc_size(_strings);
+    }
+}
+
+//◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦//
+#pragma mark -  Streaming
+//◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦//
+
+//|++++++++++++++++++++++++++++++++++++|//
+- (MKSegment*)_segmentAtIndex:(uint32_t)index error:(NSError**)error
+{
+    MKResult<MKSegment*> *segment = [self.macho segmentAtIndex:index];
+    if (segment.value == nil) {
+        if (segment.error) {
+            MK_ERROR_OUT = [NSError mk_errorWithDomain:MKErrorDomain code:MK_EINTERNAL_ERROR underlyingError:segment.error description:@"Could not load segment at index [%u].", index];
+        } else {
+            MK_ERROR_OUT = [NSError mk_errorWithDomain:MKErrorDomain code:MK_ENOT_FOUND description:@"No segment at index [%u].", index];
+        }
+    }
+    return segment.value;
+}
+
+//|++++++++++++++++++++++++++++++++++++|//
+- (BOOL)_runOpcodes:(const uint8_t*)start length:(vm_size_t)length error:(NSError**)error handler:(BOOL (^)(const MKBindTableEntry *entry))handler
+{
+    MKDataModel *dataModel = self.dataModel;
+    size_t pointerSize = dataModel.pointerSize;
+    BOOL stopAtDone = (_kind != MKBindTableKindLazyBind);
+    
+    const uint8_t *p = start;
+    const uint8_t *end = start + length;
+    
+    MKSegment *segment = nil;
+    NSError *memoryMapError = nil;
+    mk_vm_address_t segmentAddress = 0;
+    mk_vm_size_t segmentSize = 0;
+    
+    MKBindTableEntry entry = { 0 };
+    struct MKBindTableThreadedSymbol *ordinalTable = NULL;
+    size_t ordinalTableCount = 0;
+    size_t ordinalTableCapacity = 0;
+    BOOL useThreadedRebaseBind = NO;
+    BOOL success = NO;
+    mk_error_t err;
+    
+    mk_budget_meter_t meter;
+    MKBudgetMeterInit(&meter, self);
+    
+#define READ_ULEB(VALUE) do { \
+    size_t ulebSize; \
+    if ((err = _mk_mach_trie_copy_uleb128(p, end, &VALUE, &ulebSize))) { \
+        MK_ERROR_OUT = [NSError mk_errorWithDomain:MKErrorDomain code:err description:@"Invalid uleb128 at offset [%td].", p - start]; \
+        goto finish; \
+    } \
+    p += ulebSize; \
+} while (0)
+    
+#define READ_SLEB(VALUE) do { \
+    size_t slebSize; \
+    if ((err = _mk_mach_trie_copy_sleb128(p, end, &VALUE, &slebSize))) { \
+        MK_ERROR_OUT = [NSError mk_errorWithDomain:MKErrorDomain code:err description:@"Invalid sleb128 at offset [%td].", p - start]; \
+        goto finish; \
+    } \
+    p += slebSize; \
+} while (0)
+    
+#define CHECK_LOCATION(OFFSET, LENGTH) do { \
+    if (segment == nil) { \
+        MK_ERROR_OUT = [NSError mk_errorWithDomain:MKErrorDomain code:MK_ENOT_FOUND description:@"No segment set."]; \
+        goto finish; \
+    } \
+    if ((OFFSET) >= segmentSize || segmentSize - (OFFSET) < (LENGTH)) { \
+        MK_ERROR_OUT = [NSError mk_errorWithDomain:MKErrorDomain code:MK_EOUT_OF_RANGE description:@"The offset [%" PRIu64 "] is not within %@ segment (index %u).", (uint64_t)(OFFSET), segment, entry.segmentIndex]; \
+        goto finish; \
+    } \
+} while (0)
+    
+#define CHARGE(OPCODES, NODES) do { \
+    if ((err = mk_budget_meter_charge(&meter, OPCODES, NODES, 0))) { \
+        MK_ERROR_OUT = [NSError mk_errorWithDomain:MKErrorDomain code:err description:@"Exceeded the work budget at offset [%td].", p - start]; \
+        goto finish; \
+    } \
+} while (0)
+    
+#define DO_BIND() do { \
+    CHARGE(0, 1); \
+    CHECK_LOCATION(entry.segmentOffset, pointerSize); \
+    entry.address = segmentAddress + entry.segmentOffset; \
+    if (!handler(&entry)) { success = YES; goto finish; } \
+} while (0)
+    
+    while (p < end)
+    {
+        uint8_t opcode = *p & BIND_OPCODE_MASK;
+        uint8_t immediate = *p & BIND_IMMEDIATE_MASK;
+        p++;
+        
+        CHARGE(1, 0);
+        
+        switch (opcode) {
+            case BIND_OPCODE_DONE:
+                // There may be additional padding at the end of the opcodes.
+                // Lazy bind opcodes are separated by DONE.
+                if (stopAtDone) {
+                    success = YES;
+                    goto finish;
+                }
+                break;
+            case BIND_OPCODE_SET_DYLIB_ORDINAL_IMM:
+                entry.libraryOrdinal = immediate;
+                break;
+            case BIND_OPCODE_SET_DYLIB_ORDINAL_ULEB:
+            {
+                uint64_t ordinal;
+                READ_ULEB(ordinal);
+                entry.libraryOrdinal = (int64_t)ordinal;
+                break;
+            }
+            case BIND_OPCODE_SET_DYLIB_SPECIAL_IMM:
+                // The immediate is a negative number, sign extend it.
+                entry.libraryOrdinal = (immediate == 0) ? 0 : (int8_t)(BIND_OPCODE_MASK | immediate);
+                break;
+            case BIND_OPCODE_SET_SYMBOL_TRAILING_FLAGS_IMM:
+            {
+                const uint8_t *terminator = memchr(p, '\0', (size_t)(end - p));
+                if (terminator == NULL) {
+                    MK_ERROR_OUT = [NSError mk_errorWithDomain:MKErrorDomain code:MK_EINVALID_DATA description:@"Unterminated symbol name at offset [%td].", p - start];
+                    goto finish;
+                }
+                entry.symbolName = (const char*)p;
+                entry.symbolFlags = immediate;
+                p = terminator + 1;
+                break;
+            }
+            case BIND_OPCODE_SET_TYPE_IMM:
+                entry.type = immediate;
+                break;
+            case BIND_OPCODE_SET_ADDEND_SLEB:
+                READ_SLEB(entry.addend);
+                break;
+            case BIND_OPCODE_SET_SEGMENT_AND_OFFSET_ULEB:
+                READ_ULEB(entry.segmentOffset);
+                entry.segmentIndex = immediate;
+                segment = [self _segmentAtIndex:immediate error:error];
+                if (segment == nil)
+                    goto finish;
+                segmentAddress = segment.vmAddress;
+                segmentSize = segment.vmSize;
+                break;
+            case BIND_OPCODE_ADD_ADDR_ULEB:
+            {
+                uint64_t delta;
+                READ_ULEB(delta);
+                entry.segmentOffset += delta;
+                break;
+            }
+            case BIND_OPCODE_DO_BIND:
+                if (useThreadedRebaseBind) {
+                    // Threaded binds only record the symbol.  The locations
+                    // are discovered by BIND_SUBOPCODE_THREADED_APPLY.
+                    if (!MKBindTableBuilderGrow((void**)&ordinalTable, &ordinalTableCapacity, ordinalTableCount + 1, sizeof(*ordinalTable))) {
+                        MK_ERROR_OUT = [NSError mk_errorWithDomain:MKErrorDomain code:MK_EINTERNAL_ERROR description:@"Could not grow the ordinal table."];
+                        goto finish;
+                    }
+                    ordinalTable[ordinalTableCount++] = (struct MKBindTableThreadedSymbol){
+                        .symbolName = entry.symbolName,
+                        .libraryOrdinal = entry.libraryOrdinal,
+                        .addend = entry.addend,
+                        .symbolFlags = entry.symbolFlags
+                    };
+                } else {
+                    DO_BIND();
+                    entry.segmentOffset += pointerSize;
+                }
+                break;
+            case BIND_OPCODE_DO_BIND_ADD_ADDR_ULEB:
+            {
+                uint64_t delta;
+                READ_ULEB(delta);
+                DO_BIND();
+                entry.segmentOffset += delta + pointerSize;
+                break;
+            }
+            case BIND_OPCODE_DO_BIND_ADD_ADDR_IMM_SCALED:
+                DO_BIND();
+                entry.segmentOffset += immediate * pointerSize + pointerSize;
+                break;
+            case BIND_OPCODE_DO_BIND_ULEB_TIMES_SKIPPING_ULEB:
+            {
+                uint64_t count, skip;
+                READ_ULEB(count);
+                READ_ULEB(skip);
+                // Each bind must land within the segment, which bounds the
+                // count for any well-formed stream.
+                if (count > segmentSize) {
+                    MK_ERROR_OUT = [NSError mk_errorWithDomain:MKErrorDomain code:MK_EOUT_OF_RANGE description:@"Bind count [%" PRIu64 "] exceeds the size of the segment.", count];
+                    goto finish;
+                }
+                for (uint64_t i = 0; i < count; i++) {
+                    DO_BIND();
+                    entry.segmentOffset += skip + pointerSize;
+                }
+                break;
+            }
+            case BIND_OPCODE_THREADED:
+                switch (immediate) {
+                    case BIND_SUBOPCODE_THREADED_SET_BIND_ORDINAL_TABLE_SIZE_ULEB:
+                    {
+                        uint64_t count;
+                        READ_ULEB(count);
+                        // Every entry in the table is added by a DO_BIND
+                        // opcode.
+                        if (count > length) {
+                            MK_ERROR_OUT = [NSError mk_errorWithDomain:MKErrorDomain code:MK_ESIZE description:@"Ordinal table size [%" PRIu64 "] exceeds the size of the bind opcodes.", count];
+                            goto finish;
+                        }
+                        ordinalTableCount = 0;
+                        if (!MKBindTableBuilderGrow((void**)&ordinalTable, &ordinalTableCapacity, (size_t)count, sizeof(*ordinalTable))) {
+                            MK_ERROR_OUT = [NSError mk_errorWithDomain:MKErrorDomain code:MK_EINTERNAL_ERROR description:@"Could not allocate the ordinal table."];
+                            goto finish;
+                        }
+                        useThreadedRebaseBind = YES;
+                        break;
+                    }
+                    case BIND_SUBOPCODE_THREADED_APPLY:
+                    {
+                        // Threaded bind opcodes should only appear in 64-bit
+                        // binaries.
+                        if (pointerSize != 8) {
+                            MK_ERROR_OUT = [NSError mk_errorWithDomain:MKErrorDomain code:MK_EUNAVAILABLE description:@"Unsupported pointer size [%zu].", pointerSize];
+                            goto finish;
+                        }
+                        
+                        uint64_t delta;
+                        do {
+                            CHARGE(0, 1);
+                            CHECK_LOCATION(entry.segmentOffset, sizeof(uint64_t));
+                            
+                            uint64_t value;
+                            if ([segment.memoryMap copyBytesAtOffset:entry.segmentOffset fromAddress:segment.nodeContextAddress into:&value length:sizeof(value) requireFull:YES error:&memoryMapError] < sizeof(value)) {
+                                MK_ERROR_OUT = [NSError mk_errorWithDomain:MKErrorDomain code:MK_EINTERNAL_ERROR underlyingError:memoryMapError description:@"Could not read value at offset [%" PRIu64 "] in %@ segment.", entry.segmentOffset, segment];
+                                goto finish;
+                            }
+                            value = MKSwapLValue64(value, dataModel);
+                            
+                            // Bit 62 distinguishes binds from rebases.  The
+                            // ordinal is bits [0..15].
+                            if (value & (1ULL << 62)) {
+                                uint16_t ordinal = value & 0xFFFF;
+                                if (ordinal >= ordinalTableCount) {
+                                    MK_ERROR_OUT = [NSError mk_errorWithDomain:MKErrorDomain code:MK_EOUT_OF_RANGE description:@"No entry in ordinalTable for index [%" PRIu16 "].", ordinal];
+                                    goto finish;
+                                }
+                                
+                                MKBindTableEntry threadedEntry = entry;
+                                threadedEntry.type = BIND_TYPE_THREADED_BIND;
+                                threadedEntry.symbolName = ordinalTable[ordinal].symbolName;
+                                threadedEntry.symbolFlags = ordinalTable[ordinal].symbolFlags;
+                                threadedEntry.libraryOrdinal = ordinalTable[ordinal].libraryOrdinal;
+                                threadedEntry.addend = ordinalTable[ordinal].addend;
+                                threadedEntry.address = segmentAddress + entry.segmentOffset;
+                                
+                                if (!handler(&threadedEntry)) {
+                                    success = YES;
+                                    goto finish;
+                                }
+                            }
+                            
+                            // The delta is bits [51..61], in units of pointers.
+                            delta = ((value >> 51) & 0x7FF) * pointerSize;
+                            entry.segmentOffset += delta;
+                        } while (delta != 0);
+                        break;
+                    }
+                    default:
+                        MK_ERROR_OUT = [NSError mk_errorWithDomain:MKErrorDomain code:MK_EINVALID_DATA description:@"Unknown threaded bind subopcode [%u] at offset [%td].", immediate, p - start - 1];
+                        goto finish;
+                }
+                break;
+            default:
+                MK_ERROR_OUT = [NSError mk_errorWithDomain:MKErrorDomain code:MK_EINVALID_DATA description:@"Unknown bind opcode [0x%x] at offset [%td].", opcode, p - start - 1];
+                goto finish;
+        }
+    }
+    
+    success = YES;
+    
+#undef DO_BIND
+#undef CHARGE
+#undef CHECK_LOCATION
+#undef READ_SLEB
+#undef READ_ULEB
+    
+finish:
+    free(ordinalTable);
+    return success;
+}
+
+//|++++++++++++++++++++++++++++++++++++|//
+- (BOOL)_enumerateBindsWithError:(NSError**)error handler:(BOOL (^)(const MKBindTableEntry *entry))handler
+{
+    if (self.nodeSize == 0)
+        return YES;
+    
+    __block BOOL success = NO;
+    __block NSError *localError = nil;
+    
+    [self adviseAccess:MKMemoryAccessAdviceSequential];
+    
+    [self.memoryMap remapBytesAtOffset:0 fromAddress:self.nodeContextAddress length:self.nodeSize requireFull:YES withHandler:^(vm_address_t address, vm_size_t length, NSError *e) {
+        if (address == 0 || length == 0) {
+            localError = [NSError mk_errorWithDomain:MKErrorDomain code:MK_ENOT_FOUND underlyingError:e description:@"Could not map the bind opcodes."];
+            return;
+        }
+        
+        NSError *opcodesError = nil;
+        success = [self _runOpcodes:(const uint8_t*)address length:length error:&opcodesError handler:handler];
+        localError = opcodesError;
+    }];
+    
+    if (!success)
+        MK_ERROR_OUT = localError;
+    
+    return success;
+}
+
+//|++++++++++++++++++++++++++++++++++++|//
+- (BOOL)enumerateBindsWithError:(NSError**)error usingBlock:(void (^)(const MKBindTableEntry *entry, BOOL *stop))block
+{
+    NSParameterAssert(block != nil);
+    
+    return [self _enumerateBindsWithError:error handler:^BOOL(const MKBindTableEntry *entry) {
+        BOOL stop = NO;
+        block(entry, &stop);
+        return !stop;
+    }];
+}
+
+//◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦//
+#pragma mark -  Compact Table
+//◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦//
+
+//|++++++++++++++++++++++++++++++++++++|//
+- (void)_buildTable
+{
+    struct MKBindTableBuilder builder = { 0 };
+    struct MKBindTableBuilder *b = &builder;
+    __block BOOL outOfMemory = NO;
+    NSError *bindError = nil;
+    
+    BOOL success = [self _enumerateBindsWithError:&bindError handler:^BOOL(const MKBindTableEntry *entry) {
+        uint32_t symbolIndex;
+        if (!MKBindTableBuilderInternSymbol(b, entry->symbolName, entry->libraryOrdinal, entry->symbolFlags, &symbolIndex) ||
+            !MKBindTableBuilderGrow((void**)&b->locations, &b->locationCapacity, b->locationCount + 1, sizeof(MKBindTableLocation))) {
+            outOfMemory = YES;
+            return NO;
+        }
+        
+        b->locations[b->locationCount++] = (MKBindTableLocation){
+            .segmentOffset = entry->segmentOffset,
+            .addend = entry->addend,
+            .symbolIndex = symbolIndex,
+            .segmentIndex = (uint16_t)entry->segmentIndex,
+            .type = entry->type
+        };
+        return YES;
+    }];
+    
+    if (!success && bindError.code == MK_EBUDGET_EXCEEDED)
+        MK_PUSH_WARNING_WITH_ERROR(locations, MK_EBUDGET_EXCEEDED, bindError, @"Bind table generation stopped after %zu locations.", builder.locationCount);
+    else if (!success)
+        MK_PUSH_WARNING_WITH_ERROR(locations, MK_EINTERNAL_ERROR, bindError, @"Bind table generation failed.");
+    else if (outOfMemory)
+        MK_PUSH_WARNING(locations, MK_EINTERNAL_ERROR, @"Bind table generation ran out of memory.");
+    
+    // The string buffer is no longer growing.  Resolve the names.
+    for (size_t i = 0; i < builder.symbolCount; i++)
+        builder.symbols[i].name = builder.strings + builder.nameOffsets[i];
+    
+    free(builder.slots);
+    free(builder.symbolHashes);
+    free(builder.nameOffsets);
+    
+    _symbols = builder.symbols;
+    _symbolCount = builder.symbolCount;
+    _locations = builder.locations;
+    _locationCount = builder.locationCount;
+    _strings = builder.strings;
+    _tableBuilt = YES;
+}
+
+//|++++++++++++++++++++++++++++++++++++|//
+//! Builds the table on first access.  The accessors may be called from
+//! several threads; only one of them builds the table.
+- (void)_buildTableIfNeeded
+{
+    @synchronized(self) {
+        if (!_tableBuilt) [self _buildTable];
+    }
+}
+
+//|++++++++++++++++++++++++++++++++++++|//
+- (NSUInteger)symbolCount
+{
+    [self _buildTableIfNeeded];
+    return _symbolCount;
+}
+
+//|++++++++++++++++++++++++++++++++++++|//
+- (const MKBindTableSymbol *)symbols
+{
+    [self _buildTableIfNeeded];
+    return _symbols;
+}
+
+//|++++++++++++++++++++++++++++++++++++|//
+- (NSUInteger)locationCount
+{
+    [self _buildTableIfNeeded];
+    return _locationCount;
+}
+
+//|++++++++++++++++++++++++++++++++++++|//
+- (const MKBindTableLocation *)locations
+{
+    [self _buildTableIfNeeded];
+    return _locations;
+}
+
+//◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦//
+#pragma mark -  MKNode
+//◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦//
+
+//|++++++++++++++++++++++++++++++++++++|//
+- (MKNodeDescription*)layout
+{
+    MKNodeFieldBuilder *symbolCount = [MKNodeFieldBuilder
+        builderWithProperty:MK_PROPERTY(symbolCount)
+        type:MKNodeFieldTypeUnsignedQuadWord.sharedInstance
+    ];
+    symbolCount.description = @"Symbols";
+    symbolCount.options = MKNodeFieldOptionDisplayAsDetail;
+    
+    MKNodeFieldBuilder *locationCount = [MKNodeFieldBuilder
+        builderWithProperty:MK_PROPERTY(locationCount)
+        type:MKNodeFieldTypeUnsignedQuadWord.sharedInstance
+    ];
+    locationCount.description = @"Locations";
+    locationCount.options = MKNodeFieldOptionDisplayAsDetail;
+    
+    return [MKNodeDescription nodeDescriptionWithParentDescription:super.layout fields:@[
+        symbolCount.build,
+        locationCount.build
+    ]];
+}
+
+@end
@@ -111,7 +111,7 @@
             return NO;
         }
         
-    } while (delta != 0);
+    } while (delta != 0 && !bindContext->stop);
     
     return YES;
 }
@@ -58,6 +58,9 @@
         return self;
     }
     
+    // The opcodes are read once, in order.
+    [self adviseAccess:MKMemoryAccessAdviceSequential];
+    
     // Load Bind Commands
     [self _parseCommands];
     
@@ -121,10 +124,18 @@
         NSMutableArray<__kindof MKBindCommand*> *commands = [[NSMutableArray alloc] initWithCapacity:(NSUInteger)self.nodeSize/8];
         mk_vm_offset_t offset = 0;
         
+        mk_budget_meter_t meter;
+        MKBudgetMeterInit(&meter, self);
+        
         while (offset < self.nodeSize)
         {
             NSError *bindCommandError = nil;
             
+            if (mk_budget_meter_charge(&meter, 1, 0, 0)) {
+                MK_PUSH_WARNING(commands, MK_EBUDGET_EXCEEDED, @"Exceeded the work budget before the bind command at offset [%" MK_VM_PRIuOFFSET "].", offset);
+                break;
+            }
+            
             MKBindCommand *command = [MKBindCommand commandAtOffset:offset fromParent:self error:&bindCommandError];
             if (command == nil) {
                 MK_PUSH_WARNING_WITH_ERROR(commands, MK_EINTERNAL_ERROR, bindCommandError, @"Could not parse bind command at offset [%" MK_VM_PRIuOFFSET "].", offset);
@@ -156,14 +167,26 @@
         __block BOOL keepGoing = YES;
         __block NSError *bindingError = nil;
         __block struct MKBindContext context = { 0, .info = (__bridge void *)self };
+        // A single command can repeat a bind an arbitrary number of times.
+        __block mk_budget_meter_t meter;
+        MKBudgetMeterInit(&meter, self);
         
         void (^doBind)(void) = ^{
+            if (mk_budget_meter_charge(&meter, 0, 1, 0)) {
+                MK_PUSH_WARNING(actions, MK_EBUDGET_EXCEEDED, @"Exceeded the work budget after %lu actions.", (unsigned long)actions.count);
+                keepGoing = NO;
+                context.stop = true;
+                return;
+            }
+            
             MKBindAction *action = [MKBindAction actionWithContext:&context error:&bindingError];
             
-            if (action)
+            if (action) {
                 [actions addObject:action];
-            else
+            } else {
                 keepGoing = NO;
+                context.stop = true;
+            }
         };
         
         for (MKBindCommand *command in _commands) {
@@ -189,6 +212,14 @@
     }
 }
 
+//◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦//
+#pragma mark -  Estimating Memory Usage
+//◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦//
+
+//|++++++++++++++++++++++++++++++++++++|//
+- (NSUInteger)estimatedMemoryCost
+{ return super.estimatedMemoryCost + MKEstimatedMemoryCostOfNodes(_commands) + MKEstimatedMemoryCostOfNodes(_actions); }
+
 //◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦//
 #pragma mark -  MKNode
 //◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦//
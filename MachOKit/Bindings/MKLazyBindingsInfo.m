@@ -61,14 +61,26 @@
         __block BOOL keepGoing = YES;
         __block NSError *bindingError = nil;
         __block struct MKBindContext context = { 0, .type = BIND_TYPE_POINTER, .info = (__bridge void *)self };
+        // A single command can repeat a bind an arbitrary number of times.
+        __block mk_budget_meter_t meter;
+        MKBudgetMeterInit(&meter, self);
         
         void (^doBind)(void) = ^{
+            if (mk_budget_meter_charge(&meter, 0, 1, 0)) {
+                MK_PUSH_WARNING(actions, MK_EBUDGET_EXCEEDED, @"Exceeded the work budget after %lu actions.", (unsigned long)actions.count);
+                keepGoing = NO;
+                context.stop = true;
+                return;
+            }
+            
             MKBindAction *action = [[MKBindActionLazyBind alloc] initWithContext:&context error:&bindingError];
             
-            if (action)
+            if (action) {
                 [actions addObject:action];
-            else
+            } else {
                 keepGoing = NO;
+                context.stop = true;
+            }
             
             // TODO - Should we reset the context?
         };
@@ -27,6 +27,7 @@
 
 #import "MKMachO+Bindings.h"
 #import "MKInternal.h"
+#import "_MKMachOImage+NodeCache.h"
 
 #import "MKBindingsInfo.h"
 #import "MKWeakBindingsInfo.h"
@@ -42,58 +43,49 @@
 //|++++++++++++++++++++++++++++++++++++|//
 - (MKResult*)bindingsInfo
 {
-    if (_bindingsInfo == nil)
-    {
+    return [self _subtreeForKey:@"bindingsInfo" storage:&_bindingsInfo builder:^MKResult* {
         NSError *bindingsInfoError = nil;
         
         MKBindingsInfo *bindingsInfo = [[MKBindingsInfo alloc] initWithParent:self error:&bindingsInfoError];
         if (bindingsInfo)
-            _bindingsInfo = [[MKResult alloc] initWithValue:bindingsInfo];
+            return [[MKResult alloc] initWithValue:bindingsInfo];
         else if (bindingsInfoError /* Only failed if we have an error */)
-            _bindingsInfo = [[MKResult alloc] initWithError:bindingsInfoError];
+            return [[MKResult alloc] initWithError:bindingsInfoError];
         else
-            _bindingsInfo = [MKResult new];
-    }
-    
-    return _bindingsInfo;
+            return [MKResult new];
+    }];
 }
 
 //|++++++++++++++++++++++++++++++++++++|//
 - (MKResult*)weakBindingsInfo
 {
-    if (_weakBindingsInfo == nil)
-    {
+    return [self _subtreeForKey:@"weakBindingsInfo" storage:&_weakBindingsInfo builder:^MKResult* {
         NSError *bindingsInfoError = nil;
         
         MKWeakBindingsInfo *bindingsInfo = [[MKWeakBindingsInfo alloc] initWithParent:self error:&bindingsInfoError];
         if (bindingsInfo)
-            _weakBindingsInfo = [[MKResult alloc] initWithValue:bindingsInfo];
+            return [[MKResult alloc] initWithValue:bindingsInfo];
         else if (bindingsInfoError /* Only failed if we have an error */)
-            _weakBindingsInfo = [[MKResult alloc] initWithError:bindingsInfoError];
+            return [[MKResult alloc] initWithError:bindingsInfoError];
         else
-            _weakBindingsInfo = [MKResult new];
-    }
-    
-    return _weakBindingsInfo;
+            return [MKResult new];
+    }];
 }
 
 //|++++++++++++++++++++++++++++++++++++|//
 - (MKResult*)lazyBindingsInfo
 {
-    if (_lazyBindingsInfo == nil)
-    {
+    return [self _subtreeForKey:@"lazyBindingsInfo" storage:&_lazyBindingsInfo builder:^MKResult* {
         NSError *bindingsInfoError = nil;
         
         MKLazyBindingsInfo *bindingsInfo = [[MKLazyBindingsInfo alloc] initWithParent:self error:&bindingsInfoError];
         if (bindingsInfo)
-            _lazyBindingsInfo = [[MKResult alloc] initWithValue:bindingsInfo];
+            return [[MKResult alloc] initWithValue:bindingsInfo];
         else if (bindingsInfoError /* Only failed if we have an error */)
-            _lazyBindingsInfo = [[MKResult alloc] initWithError:bindingsInfoError];
+            return [[MKResult alloc] initWithError:bindingsInfoError];
         else
-            _lazyBindingsInfo = [MKResult new];
-    }
-    
-    return _lazyBindingsInfo;
+            return [MKResult new];
+    }];
 }
 
 //◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦//
@@ -0,0 +1,138 @@
+//----------------------------------------------------------------------------//
+//|
+//|             MachOKit - A Lightweight Mach-O Parsing Library
+//! @file       MKCodeDirectory.h
+//!
+//! @author     D.V.
+//! @copyright  Copyright (c) 2014-2015 D.V. All rights reserved.
+//|
+//| Permission is hereby granted, free of charge, to any person obtaining a
+//| copy of this software and associated documentation files (the "Software"),
+//| to deal in the Software without restriction, including without limitation
+//| the rights to use, copy, modify, merge, publish, distribute, sublicense,
+//| and/or sell copies of the Software, and to permit persons to whom the
+//| Software is furnished to do so, subject to the following conditions:
+//|
+//| The above copyright notice and this permission notice shall be included
+//| in all copies or substantial portions of the Software.
+//|
+//| THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+//| OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+//| MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+//| IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+//| CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+//| TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+//| SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+//----------------------------------------------------------------------------//
+
+#include <MachOKit/macho.h>
+#import <Foundation/Foundation.h>
+
+#import <MachOKit/MKCodeSignatureBlob.h>
+
+@class MKSegment;
+
+NS_ASSUME_NONNULL_BEGIN
+
+//----------------------------------------------------------------------------//
+//! @name       Code Directory Hash Types
+//! @relates    MKCodeDirectory
+//!
+typedef NS_ENUM(uint8_t, MKCodeSignatureHashType) {
+    MKCodeSignatureHashTypeNone                 = 0,
+    MKCodeSignatureHashTypeSHA1                 = 1,
+    MKCodeSignatureHashTypeSHA256               = 2,
+    MKCodeSignatureHashTypeSHA256Truncated      = 3,
+    MKCodeSignatureHashTypeSHA384               = 4
+};
+
+
+
+//----------------------------------------------------------------------------//
+//! An \c MKCodeDirectory parses a CodeDirectory blob, which holds a hash of
+//! each page of the signed code and of the other blobs in the signature.
+//
+@interface MKCodeDirectory : MKCodeSignatureBlob {
+@package
+    uint32_t _version;
+    uint32_t _flags;
+    uint32_t _hashOffset;
+    uint32_t _identOffset;
+    uint32_t _nSpecialSlots;
+    uint32_t _nCodeSlots;
+    uint64_t _codeLimit;
+    uint8_t _hashSize;
+    MKCodeSignatureHashType _hashType;
+    uint8_t _platform;
+    uint8_t _pageSize;
+    uint32_t _teamOffset;
+    uint64_t _execSegBase;
+    uint64_t _execSegLimit;
+    uint64_t _execSegFlags;
+    NSString *_identifier;
+    NSString *_teamIdentifier;
+    NSData *_hashes;
+}
+
+@property (nonatomic, readonly) uint32_t version;
+@property (nonatomic, readonly) uint32_t flags;
+@property (nonatomic, readonly) uint32_t hashOffset;
+@property (nonatomic, readonly) uint32_t identOffset;
+@property (nonatomic, readonly) uint32_t nSpecialSlots;
+@property (nonatomic, readonly) uint32_t nCodeSlots;
+//! The limit of the signed code.  Taken from \c codeLimit64 if it is
+//! present and not zero.
+@property (nonatomic, readonly) uint64_t codeLimit;
+@property (nonatomic, readonly) uint8_t hashSize;
+@property (nonatomic, readonly) MKCodeSignatureHashType hashType;
+@property (nonatomic, readonly) uint8_t platform;
+//! The base 2 logarithm of the page size, or \c 0 if the code is hashed as
+//! a single page.
+@property (nonatomic, readonly) uint8_t pageSize;
+@property (nonatomic, readonly) uint32_t teamOffset;
+@property (nonatomic, readonly) uint64_t execSegBase;
+@property (nonatomic, readonly) uint64_t execSegLimit;
+@property (nonatomic, readonly) uint64_t execSegFlags;
+
+//! The signing identifier.
+@property (nonatomic, strong, readonly, nullable) NSString *identifier;
+//! The team identifier, if present.
+@property (nonatomic, strong, readonly, nullable) NSString *teamIdentifier;
+
+//! The number of bytes hashed by each code slot, except the last.
+@property (nonatomic, readonly) uint64_t bytesPerPage;
+
+//! Returns the hash of the page at \a index, or \c nil.
+- (nullable NSData*)hashForCodeSlot:(uint32_t)index;
+
+//! Returns the hash stored in the special slot \a slot, such as
+//! \ref MKCodeSignatureSlotRequirements, or \c nil.
+- (nullable NSData*)hashForSpecialSlot:(MKCodeSignatureSlot)slot;
+
+//◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦//
+#pragma mark -  Verifying Page Hashes
+//! @name       Verifying Page Hashes
+//!
+//! Pages are hashed from the memory map of the image.  Groups of pages are
+//! hashed concurrently.  Verifying an image loaded from memory is only
+//! meaningful for pages that are not modified at runtime, such as those
+//! backing \c __TEXT.
+//◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦//
+
+//! Hashes the pages in \a pageRange and returns the indexes of the pages
+//! whose hash does not match the corresponding code slot.  Returns \c nil
+//! if a page could not be read or the hash type is not supported.
+- (nullable NSIndexSet*)mismatchedPagesInRange:(NSRange)pageRange error:(NSError**)error;
+
+//! Returns the range of pages covering the file contents of \a segment.
+- (NSRange)pageRangeForSegment:(MKSegment*)segment;
+
+//! Verifies every page of the signed code.
+- (BOOL)verifyWithError:(NSError**)error;
+
+//! Verifies only the pages that back \a segment.
+- (BOOL)verifySegment:(MKSegment*)segment error:(NSError**)error;
+
+@end
+
+NS_ASSUME_NONNULL_END
@@ -0,0 +1,416 @@
+//----------------------------------------------------------------------------//
+//|
+//|             MachOKit - A Lightweight Mach-O Parsing Library
+//|             MKCodeDirectory.m
+//|
+//|             D.V.
+//|             Copyright (c) 2014-2015 D.V. All rights reserved.
+//|
+//| Permission is hereby granted, free of charge, to any person obtaining a
+//| copy of this software and associated documentation files (the "Software"),
+//| to deal in the Software without restriction, including without limitation
+//| the rights to use, copy, modify, merge, publish, distribute, sublicense,
+//| and/or sell copies of the Software, and to permit persons to whom the
+//| Software is furnished to do so, subject to the following conditions:
+//|
+//| The above copyright notice and this permission notice shall be included
+//| in all copies or substantial portions of the Software.
+//|
+//| THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+//| OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+//| MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+//| IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+//| CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+//| TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+//| SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+//----------------------------------------------------------------------------//
+
+
+#import "MKCodeDirectory.h"
+#import "MKInternal.h"
+#import "MKMachO.h"
+#import "MKMachO+Segments.h"
+#import "MKSegment.h"
+#import "_MKCodeSignature.h"
+
+#include <libkern/OSByteOrder.h>
+#include <dispatch/dispatch.h>
+
+//! The number of pages hashed by each unit of concurrent work.
+#define MKCodeDirectoryPagesPerChunk    16
+
+//----------------------------------------------------------------------------//
+//! A range of the file, and where it can be read from.
+typedef struct MKCodeDirectoryFileRange {
+    uint64_t fileOffset;
+    uint64_t fileSize;
+    mk_vm_address_t contextAddress;
+    // Unretained.  The memory maps are kept alive by the image.
+    __unsafe_unretained MKMemoryMap *memoryMap;
+} MKCodeDirectoryFileRange;
+
+//|++++++++++++++++++++++++++++++++++++|//
+static const MKCodeDirectoryFileRange*
+MKCodeDirectoryFindFileRange(const MKCodeDirectoryFileRange *ranges, NSUInteger count, uint64_t offset, uint64_t length)
+{
+    for (NSUInteger i = 0; i < count; i++) {
+        if (offset >= ranges[i].fileOffset && offset - ranges[i].fileOffset < ranges[i].fileSize && length <= ranges[i].fileSize - (offset - ranges[i].fileOffset))
+            return &ranges[i];
+    }
+    return NULL;
+}
+
+
+
+//----------------------------------------------------------------------------//
+@implementation MKCodeDirectory
+
+@synthesize version = _version;
+@synthesize flags = _flags;
+@synthesize hashOffset = _hashOffset;
+@synthesize identOffset = _identOffset;
+@synthesize nSpecialSlots = _nSpecialSlots;
+@synthesize nCodeSlots = _nCodeSlots;
+@synthesize codeLimit = _codeLimit;
+@synthesize hashSize = _hashSize;
+@synthesize hashType = _hashType;
+@synthesize platform = _platform;
+@synthesize pageSize = _pageSize;
+@synthesize teamOffset = _teamOffset;
+@synthesize execSegBase = _execSegBase;
+@synthesize execSegLimit = _execSegLimit;
+@synthesize execSegFlags = _execSegFlags;
+@synthesize identifier = _identifier;
+@synthesize teamIdentifier = _teamIdentifier;
+
+//|++++++++++++++++++++++++++++++++++++|//
++ (uint32_t)canInstantiateWithMagic:(MKCodeSignatureMagic)magic
+{ return (magic == MKCodeSignatureMagicCodeDirectory) ? 50 : 0; }
+
+//|++++++++++++++++++++++++++++++++++++|//
+- (instancetype)initWithOffset:(mk_vm_offset_t)offset fromParent:(MKBackedNode*)parent error:(NSError**)error
+{
+    self = [super initWithOffset:offset fromParent:parent error:error];
+    if (self == nil) return nil;
+    
+    NSError *memoryMapError = nil;
+    NSData *data = [self.memoryMap dataAtOffset:0 fromAddress:self.nodeContextAddress length:self.length requireFull:YES error:&memoryMapError];
+    if (data == nil) {
+        MK_ERROR_OUT = [NSError mk_errorWithDomain:MKErrorDomain code:MK_EINTERNAL_ERROR underlyingError:memoryMapError description:@"Could not read CodeDirectory."];
+        return nil;
+    }
+    
+    // Fields beyond those of the blob's version read as zero.
+    struct mk_cs_code_directory cd = { 0 };
+    memcpy(&cd, data.bytes, MIN(data.length, sizeof(cd)));
+    
+    if (data.length < offsetof(struct mk_cs_code_directory, scatterOffset)) {
+        MK_ERROR_OUT = [NSError mk_errorWithDomain:MKErrorDomain code:MK_EINVALID_DATA description:@"CodeDirectory length [%lu] is smaller than the minimum CodeDirectory.", (unsigned long)data.length];
+        return nil;
+    }
+    
+    _version = OSSwapBigToHostInt32(cd.version);
+    _flags = OSSwapBigToHostInt32(cd.flags);
+    _hashOffset = OSSwapBigToHostInt32(cd.hashOffset);
+    _identOffset = OSSwapBigToHostInt32(cd.identOffset);
+    _nSpecialSlots = OSSwapBigToHostInt32(cd.nSpecialSlots);
+    _nCodeSlots = OSSwapBigToHostInt32(cd.nCodeSlots);
+    _codeLimit = OSSwapBigToHostInt32(cd.codeLimit);
+    _hashSize = cd.hashSize;
+    _hashType = cd.hashType;
+    _platform = cd.platform;
+    _pageSize = cd.pageSize;
+    
+    if (_version >= MK_CS_CODE_DIRECTORY_SUPPORTS_TEAM_ID)
+        _teamOffset = OSSwapBigToHostInt32(cd.teamOffset);
+    if (_version >= MK_CS_CODE_DIRECTORY_SUPPORTS_CODE_LIMIT_64 && cd.codeLimit64)
+        _codeLimit = OSSwapBigToHostInt64(cd.codeLimit64);
+    if (_version >= MK_CS_CODE_DIRECTORY_SUPPORTS_EXEC_SEGMENT) {
+        _execSegBase = OSSwapBigToHostInt64(cd.execSegBase);
+        _execSegLimit = OSSwapBigToHostInt64(cd.execSegLimit);
+        _execSegFlags = OSSwapBigToHostInt64(cd.execSegFlags);
+    }
+    
+    const char *bytes = data.bytes;
+    
+    if (_identOffset < data.length)
+        _identifier = [[NSString alloc] initWithBytes:bytes + _identOffset length:strnlen(bytes + _identOffset, data.length - _identOffset) encoding:NSUTF8StringEncoding];
+    else
+        MK_PUSH_WARNING(identifier, MK_EOUT_OF_RANGE, @"Identifier offset [%" PRIu32 "] is beyond the end of the CodeDirectory.", _identOffset);
+    
+    if (_teamOffset != 0 && _teamOffset < data.length)
+        _teamIdentifier = [[NSString alloc] initWithBytes:bytes + _teamOffset length:strnlen(bytes + _teamOffset, data.length - _teamOffset) encoding:NSUTF8StringEncoding];
+    else if (_teamOffset != 0)
+        MK_PUSH_WARNING(teamIdentifier, MK_EOUT_OF_RANGE, @"Team identifier offset [%" PRIu32 "] is beyond the end of the CodeDirectory.", _teamOffset);
+    
+    // The special slots are stored in reverse order, before hashOffset.
+    uint64_t specialLength = (uint64_t)_nSpecialSlots * _hashSize;
+    uint64_t codeLength = (uint64_t)_nCodeSlots * _hashSize;
+    if (specialLength <= _hashOffset && (uint64_t)_hashOffset + codeLength <= data.length)
+        _hashes = [data subdataWithRange:NSMakeRange((NSUInteger)(_hashOffset - specialLength), (NSUInteger)(specialLength + codeLength))];
+    else
+        MK_PUSH_WARNING(nCodeSlots, MK_EOUT_OF_RANGE, @"Hash slots are not within the CodeDirectory.");
+    
+    return self;
+}
+
+//◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦//
+#pragma mark -  Hashes
+//◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦//
+
+//|++++++++++++++++++++++++++++++++++++|//
+- (uint64_t)bytesPerPage
+{
+    if (_pageSize == 0 || _pageSize >= 64)
+        return _codeLimit;
+    return 1ULL << _pageSize;
+}
+
+//|++++++++++++++++++++++++++++++++++++|//
+- (NSData*)hashForCodeSlot:(uint32_t)index
+{
+    if (_hashes == nil || index >= _nCodeSlots)
+        return nil;
+    return [_hashes subdataWithRange:NSMakeRange((NSUInteger)(((uint64_t)_nSpecialSlots + index) * _hashSize), _hashSize)];
+}
+
+//|++++++++++++++++++++++++++++++++++++|//
+- (NSData*)hashForSpecialSlot:(MKCodeSignatureSlot)slot
+{
+    if (_hashes == nil || slot == 0 || slot > _nSpecialSlots)
+        return nil;
+    return [_hashes subdataWithRange:NSMakeRange((NSUInteger)(((uint64_t)_nSpecialSlots - slot) * _hashSize), _hashSize)];
+}
+
+//◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦//
+#pragma mark -  Verifying Page Hashes
+//◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦//
+
+//|++++++++++++++++++++++++++++++++++++|//
+- (NSIndexSet*)mismatchedPagesInRange:(NSRange)pageRange error:(NSError**)error
+{
+    if (_hashes == nil) {
+        MK_ERROR_OUT = [NSError mk_errorWithDomain:MKErrorDomain code:MK_EINVALID_DATA description:@"CodeDirectory hash slots are not valid."];
+        return nil;
+    }
+    if (NSMaxRange(pageRange) > _nCodeSlots) {
+        MK_ERROR_OUT = [NSError mk_errorWithDomain:MKErrorDomain code:MK_EOUT_OF_RANGE description:@"Page range %@ is beyond the [%" PRIu32 "] code slots.", NSStringFromRange(pageRange), _nCodeSlots];
+        return nil;
+    }
+    
+    void (*hashFunction)(const void*, size_t, uint8_t*);
+    size_t digestLength;
+    switch (_hashType) {
+        case MKCodeSignatureHashTypeSHA1:
+            hashFunction = MKCodeSignatureSHA1;
+            digestLength = MK_CS_SHA1_DIGEST_LENGTH;
+            break;
+        case MKCodeSignatureHashTypeSHA256:
+        case MKCodeSignatureHashTypeSHA256Truncated:
+            hashFunction = MKCodeSignatureSHA256;
+            digestLength = MK_CS_SHA256_DIGEST_LENGTH;
+            break;
+        default:
+            MK_ERROR_OUT = [NSError mk_errorWithDomain:MKErrorDomain code:MK_EUNAVAILABLE description:@"Unsupported CodeDirectory hash type [%" PRIu8 "].", (uint8_t)_hashType];
+            return nil;
+    }
+    if (_hashSize == 0 || _hashSize > digestLength) {
+        MK_ERROR_OUT = [NSError mk_errorWithDomain:MKErrorDomain code:MK_EINVALID_DATA description:@"CodeDirectory hash size [%" PRIu8 "] is not valid for hash type [%" PRIu8 "].", _hashSize, (uint8_t)_hashType];
+        return nil;
+    }
+    
+    // Determine where each part of the file can be read from.  An image read
+    // from a file is contiguous.  An image in memory must be read through
+    // its segments.
+    MKMachOImage *image = self.macho;
+    NSArray<MKResult<MKSegment*>*> *segments = image.isFromMemory ? image.segments : nil;
+    
+    MKCodeDirectoryFileRange *fileRanges = calloc(MAX(segments.count, (NSUInteger)1), sizeof(MKCodeDirectoryFileRange));
+    if (fileRanges == NULL) {
+        MK_ERROR_OUT = [NSError mk_errorWithDomain:MKErrorDomain code:MK_EINTERNAL_ERROR description:@"Could not allocate the file range table."];
+        return nil;
+    }
+    
+    NSUInteger fileRangeCount = 0;
+    if (segments == nil) {
+        fileRanges[fileRangeCount++] = (MKCodeDirectoryFileRange){ 0, UINT64_MAX, image.nodeContextAddress, image.memoryMap };
+    } else {
+        for (MKResult<MKSegment*> *segment in segments) {
+            if (segment.value == nil || segment.value.fileSize == 0)
+                continue;
+            fileRanges[fileRangeCount++] = (MKCodeDirectoryFileRange){ segment.value.fileOffset, segment.value.fileSize, segment.value.nodeContextAddress, segment.value.memoryMap };
+        }
+    }
+    
+    const uint8_t *expectedHashes = (const uint8_t*)_hashes.bytes + (uint64_t)_nSpecialSlots * _hashSize;
+    uint64_t bytesPerPage = self.bytesPerPage;
+    uint64_t codeLimit = _codeLimit;
+    uint8_t hashSize = _hashSize;
+    
+    NSMutableIndexSet *mismatched = [NSMutableIndexSet indexSet];
+    __block NSError *readError = nil;
+    
+    size_t chunkCount = (pageRange.length + MKCodeDirectoryPagesPerChunk - 1) / MKCodeDirectoryPagesPerChunk;
+    
+    dispatch_apply(chunkCount, dispatch_get_global_queue(QOS_CLASS_UTILITY, 0), ^(size_t chunk) {
+    @autoreleasepool {
+        NSUInteger first = pageRange.location + chunk * MKCodeDirectoryPagesPerChunk;
+        NSUInteger last = MIN(first + MKCodeDirectoryPagesPerChunk, NSMaxRange(pageRange));
+        
+        for (NSUInteger page = first; page < last; page++)
+        {
+            uint64_t fileOffset = (uint64_t)page * bytesPerPage;
+            uint64_t length = (fileOffset < codeLimit) ? MIN(bytesPerPage, codeLimit - fileOffset) : 0;
+            __block BOOL matches = NO;
+            
+            const MKCodeDirectoryFileRange *fileRange = MKCodeDirectoryFindFileRange(fileRanges, fileRangeCount, fileOffset, length);
+            if (length == 0 || fileRange == NULL) {
+                // A code slot beyond the code limit, or a page that is not
+                // backed by the file, can not match.
+                @synchronized (mismatched) { [mismatched addIndex:page]; }
+                continue;
+            }
+            
+            [fileRange->memoryMap remapBytesAtOffset:(mk_vm_offset_t)(fileOffset - fileRange->fileOffset) fromAddress:fileRange->contextAddress length:length requireFull:YES withHandler:^(vm_address_t address, vm_size_t __unused mappedLength, NSError *e) {
+                if (address == 0) {
+                    @synchronized (mismatched) { if (readError == nil) readError = e; }
+                    return;
+                }
+                
+                uint8_t digest[MK_CS_SHA256_DIGEST_LENGTH];
+                hashFunction((const void*)address, (size_t)length, digest);
+                matches = (memcmp(digest, expectedHashes + (uint64_t)page * hashSize, hashSize) == 0);
+            }];
+            
+            if (matches == NO)
+                @synchronized (mismatched) { [mismatched addIndex:page]; }
+        }
+    }
+    });
+    
+    free(fileRanges);
+    
+    if (readError) {
+        MK_ERROR_OUT = [NSError mk_errorWithDomain:MKErrorDomain code:MK_EINTERNAL_ERROR underlyingError:readError description:@"Could not read the signed code."];
+        return nil;
+    }
+    
+    return mismatched;
+}
+
+//|++++++++++++++++++++++++++++++++++++|//
+- (NSRange)pageRangeForSegment:(MKSegment*)segment
+{
+    uint64_t bytesPerPage = self.bytesPerPage;
+    if (bytesPerPage == 0 || segment.fileSize == 0)
+        return NSMakeRange(0, 0);
+    
+    uint64_t first = segment.fileOffset / bytesPerPage;
+    uint64_t end = (segment.fileOffset + segment.fileSize + bytesPerPage - 1) / bytesPerPage;
+    
+    first = MIN(first, (uint64_t)_nCodeSlots);
+    end = MIN(end, (uint64_t)_nCodeSlots);
+    return NSMakeRange((NSUInteger)first, (NSUInteger)(end - first));
+}
+
+//|++++++++++++++++++++++++++++++++++++|//
+- (BOOL)_verifyPagesInRange:(NSRange)pageRange error:(NSError**)error
+{
+    NSIndexSet *mismatched = [self mismatchedPagesInRange:pageRange error:error];
+    if (mismatched == nil)
+        return NO;
+    
+    if (mismatched.count) {
+        MK_ERROR_OUT = [NSError mk_errorWithDomain:MKErrorDomain code:MK_EINVALID_DATA description:@"Hash mismatch for [%lu] of [%lu] pages, beginning with page [%lu].", (unsigned long)mismatched.count, (unsigned long)pageRange.length, (unsigned long)mismatched.firstIndex];
+        return NO;
+    }
+    
+    return YES;
+}
+
+//|++++++++++++++++++++++++++++++++++++|//
+- (BOOL)verifyWithError:(NSError**)error
+{ return [self _verifyPagesInRange:NSMakeRange(0, _nCodeSlots) error:error]; }
+
+//|++++++++++++++++++++++++++++++++++++|//
+- (BOOL)verifySegment:(MKSegment*)segment error:(NSError**)error
+{ return [self _verifyPagesInRange:[self pageRangeForSegment:segment] error:error]; }
+
+//◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦//
+#pragma mark -  MKNode
+//◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦//
+
+//|++++++++++++++++++++++++++++++++++++|//
+- (MKNodeDescription*)layout
+{
+#define FIELD(NAME, TYPE, DESCRIPTION) \
+    MKNodeFieldBuilder *NAME = [MKNodeFieldBuilder \
+        builderWithProperty:MK_PROPERTY(NAME) \
+        type:TYPE.sharedInstance \
+        offset:offsetof(struct mk_cs_code_directory, NAME) \
+        size:sizeof(((struct mk_cs_code_directory*)0)->NAME) \
+    ]; \
+    NAME.description = DESCRIPTION; \
+    NAME.options = MKNodeFieldOptionDisplayAsDetail;
+    
+    FIELD(version, MKNodeFieldTypeUnsignedDoubleWord, @"Version")
+    version.formatter = NSFormatter.mk_hex32Formatter;
+    FIELD(flags, MKNodeFieldTypeUnsignedDoubleWord, @"Flags")
+    flags.formatter = NSFormatter.mk_hex32Formatter;
+    FIELD(hashOffset, MKNodeFieldTypeUnsignedDoubleWord, @"Hash Offset")
+    FIELD(identOffset, MKNodeFieldTypeUnsignedDoubleWord, @"Identifier Offset")
+    FIELD(nSpecialSlots, MKNodeFieldTypeUnsignedDoubleWord, @"Special Slots")
+    FIELD(nCodeSlots, MKNodeFieldTypeUnsignedDoubleWord, @"Code Slots")
+    FIELD(hashSize, MKNodeFieldTypeUnsignedByte, @"Hash Size")
+    FIELD(hashType, MKNodeFieldTypeUnsignedByte, @"Hash Type")
+    FIELD(platform, MKNodeFieldTypeUnsignedByte, @"Platform")
+    FIELD(pageSize, MKNodeFieldTypeUnsignedByte, @"Page Size (log2)")
+#undef FIELD
+    
+    MKNodeFieldBuilder *codeLimit = [MKNodeFieldBuilder
+        builderWithProperty:MK_PROPERTY(codeLimit)
+        type:MKNodeFieldTypeUnsignedQuadWord.sharedInstance
+    ];
+    codeLimit.description = @"Code Limit";
+    codeLimit.options = MKNodeFieldOptionDisplayAsDetail;
+    
+    MKNodeFieldBuilder *identifier = [MKNodeFieldBuilder
+        builderWithProperty:MK_PROPERTY(identifier)
+        type:MKNodeFieldTypeString.sharedInstance
+    ];
+    identifier.description = @"Identifier";
+    identifier.options = MKNodeFieldOptionDisplayAsDetail;
+    
+    MKNodeFieldBuilder *teamIdentifier = [MKNodeFieldBuilder
+        builderWithProperty:MK_PROPERTY(teamIdentifier)
+        type:MKNodeFieldTypeString.sharedInstance
+    ];
+    teamIdentifier.description = @"Team Identifier";
+    teamIdentifier.options = MKNodeFieldOptionDisplayAsDetail;
+    
+    return [MKNodeDescription nodeDescriptionWithParentDescription:super.layout fields:@[
+        version.build,
+        flags.build,
+        hashOffset.build,
+        identOffset.build,
+        nSpecialSlots.build,
+        nCodeSlots.build,
+        codeLimit.build,
+        hashSize.build,
+        hashType.build,
+        platform.build,
+        pageSize.build,
+        identifier.build,
+        teamIdentifier.build
+    ]];
+}
+
+//◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦//
+#pragma mark -  NSObject
+//◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦//
+
+//|++++++++++++++++++++++++++++++++++++|//
+- (NSString*)description
+{ return @"Code Directory"; }
+
+@end
@@ -0,0 +1,92 @@
+//----------------------------------------------------------------------------//
+//|
+//|             MachOKit - A Lightweight Mach-O Parsing Library
+//! @file       MKCodeSignature.h
+//!
+//! @author     D.V.
+//! @copyright  Copyright (c) 2014-2015 D.V. All rights reserved.
+//|
+//| Permission is hereby granted, free of charge, to any person obtaining a
+//| copy of this software and associated documentation files (the "Software"),
+//| to deal in the Software without restriction, including without limitation
+//| the rights to use, copy, modify, merge, publish, distribute, sublicense,
+//| and/or sell copies of the Software, and to permit persons to whom the
+//| Software is furnished to do so, subject to the following conditions:
+//|
+//| The above copyright notice and this permission notice shall be included
+//| in all copies or substantial portions of the Software.
+//|
+//| THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+//| OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+//| MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+//| IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+//| CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+//| TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+//| SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+//----------------------------------------------------------------------------//
+
+#include <MachOKit/macho.h>
+#import <Foundation/Foundation.h>
+
+#import <MachOKit/MKLinkEditNode.h>
+#import <MachOKit/MKCodeSignatureBlob.h>
+
+@class MKCodeDirectory;
+@class MKCodeSignatureRequirements;
+@class MKCodeSignatureEntitlements;
+@class MKSegment;
+
+NS_ASSUME_NONNULL_BEGIN
+
+//----------------------------------------------------------------------------//
+//! An \c MKCodeSignature parses the embedded signature referenced by the
+//! \c LC_CODE_SIGNATURE load command.  The signature is a SuperBlob whose
+//! index references the CodeDirectory, requirements, entitlements and other
+//! blobs.
+//
+@interface MKCodeSignature : MKLinkEditNode {
+@package
+    MKCodeSignatureMagic _magic;
+    uint32_t _length;
+    uint32_t _count;
+    NSArray<MKCodeSignatureBlob*> *_blobs;
+}
+
+- (nullable instancetype)initWithImage:(MKMachOImage*)image error:(NSError**)error;
+
+//! The SuperBlob magic.
+@property (nonatomic, assign, readonly) MKCodeSignatureMagic magic;
+//! The length of the SuperBlob.
+@property (nonatomic, assign, readonly) uint32_t length;
+//! The number of entries in the SuperBlob index.
+@property (nonatomic, assign, readonly) uint32_t count;
+
+//! The blobs referenced from the SuperBlob index.
+@property (nonatomic, strong, readonly) NSArray<MKCodeSignatureBlob*> *blobs;
+
+//! Returns the blob referenced from \a slot, or \c nil.
+- (nullable __kindof MKCodeSignatureBlob*)blobForSlot:(MKCodeSignatureSlot)slot;
+
+//! The primary and alternate CodeDirectories.
+@property (nonatomic, strong, readonly) NSArray<MKCodeDirectory*> *codeDirectories;
+//! The CodeDirectory with the strongest supported hash type.
+@property (nonatomic, strong, readonly, nullable) MKCodeDirectory *codeDirectory;
+//! The requirements set, if present.
+@property (nonatomic, strong, readonly, nullable) MKCodeSignatureRequirements *requirements;
+//! The entitlements, if present.
+@property (nonatomic, strong, readonly, nullable) MKCodeSignatureEntitlements *entitlements;
+
+//◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦//
+#pragma mark -  Verifying Page Hashes
+//! @name       Verifying Page Hashes
+//◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦//
+
+//! Verifies every page of the signed code against \ref codeDirectory.
+- (BOOL)verifyWithError:(NSError**)error;
+
+//! Verifies the pages backing \a segment against \ref codeDirectory.
+- (BOOL)verifySegment:(MKSegment*)segment error:(NSError**)error;
+
+@end
+
+NS_ASSUME_NONNULL_END
@@ -0,0 +1,297 @@
+//----------------------------------------------------------------------------//
+//|
+//|             MachOKit - A Lightweight Mach-O Parsing Library
+//|             MKCodeSignature.m
+//|
+//|             D.V.
+//|             Copyright (c) 2014-2015 D.V. All rights reserved.
+//|
+//| Permission is hereby granted, free of charge, to any person obtaining a
+//| copy of this software and associated documentation files (the "Software"),
+//| to deal in the Software without restriction, including without limitation
+//| the rights to use, copy, modify, merge, publish, distribute, sublicense,
+//| and/or sell copies of the Software, and to permit persons to whom the
+//| Software is furnished to do so, subject to the following conditions:
+//|
+//| The above copyright notice and this permission notice shall be included
+//| in all copies or substantial portions of the Software.
+//|
+//| THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+//| OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+//| MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+//| IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+//| CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+//| TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+//| SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+//----------------------------------------------------------------------------//
+
+
+#import "MKCodeSignature.h"
+#import "MKInternal.h"
+#import "MKMachO.h"
+#import "MKLCCodeSignature.h"
+#import "MKCodeDirectory.h"
+#import "MKCodeSignatureRequirements.h"
+#import "MKCodeSignatureEntitlements.h"
+#import "_MKCodeSignature.h"
+
+#include <libkern/OSByteOrder.h>
+
+//|++++++++++++++++++++++++++++++++++++|//
+//! Ranks the supported CodeDirectory hash types, strongest first.
+static NSUInteger
+MKCodeSignatureHashTypeRank(MKCodeSignatureHashType hashType)
+{
+    switch (hashType) {
+        case MKCodeSignatureHashTypeSHA256:             return 3;
+        case MKCodeSignatureHashTypeSHA256Truncated:    return 2;
+        case MKCodeSignatureHashTypeSHA1:               return 1;
+        default:                                        return 0;
+    }
+}
+
+
+
+//----------------------------------------------------------------------------//
+@implementation MKCodeSignature
+
+@synthesize magic = _magic;
+@synthesize length = _length;
+@synthesize count = _count;
+@synthesize blobs = _blobs;
+
+//|++++++++++++++++++++++++++++++++++++|//
+- (instancetype)initWithSize:(mk_vm_size_t)size offset:(mk_vm_offset_t)offset inImage:(MKMachOImage*)image error:(NSError**)error
+{
+    self = [super initWithSize:size offset:offset inImage:image error:error];
+    if (self == nil) return nil;
+    
+    struct mk_cs_super_blob header;
+    NSError *memoryMapError = nil;
+    
+    if ([self.memoryMap copyBytesAtOffset:0 fromAddress:self.nodeContextAddress into:&header length:sizeof(header) requireFull:YES error:&memoryMapError] < sizeof(header)) {
+        MK_ERROR_OUT = [NSError mk_errorWithDomain:MKErrorDomain code:MK_EINTERNAL_ERROR underlyingError:memoryMapError description:@"Could not read code signature header."];
+        return nil;
+    }
+    
+    _magic = OSSwapBigToHostInt32(header.magic);
+    _length = OSSwapBigToHostInt32(header.length);
+    _count = OSSwapBigToHostInt32(header.count);
+    
+    if (_magic != MKCodeSignatureMagicEmbeddedSignature) {
+        MK_ERROR_OUT = [NSError mk_errorWithDomain:MKErrorDomain code:MK_EINVALID_DATA description:@"Unexpected code signature magic [0x%08" PRIx32 "].", (uint32_t)_magic];
+        return nil;
+    }
+    
+    // The SuperBlob may be followed by padding, but must not extend past
+    // the end of the data referenced by the load command.
+    if (_length < sizeof(header) || _length > self.nodeSize) {
+        MK_ERROR_OUT = [NSError mk_errorWithDomain:MKErrorDomain code:MK_EINVALID_DATA description:@"Code signature length [%" PRIu32 "] is not within the [%" MK_VM_PRIuSIZE "] bytes of signature data.", _length, self.nodeSize];
+        return nil;
+    }
+    
+    uint32_t count = _count;
+    if ((uint64_t)count * sizeof(struct mk_cs_blob_index) > _length - sizeof(header)) {
+        MK_PUSH_WARNING(count, MK_EINVALID_DATA, @"Code signature index count [%" PRIu32 "] exceeds the length of the signature.", count);
+        count = (uint32_t)((_length - sizeof(header)) / sizeof(struct mk_cs_blob_index));
+    }
+    
+    NSMutableArray<MKCodeSignatureBlob*> *blobs = [[NSMutableArray alloc] initWithCapacity:count];
+    
+    for (uint32_t i = 0; i < count; i++)
+    {
+        struct mk_cs_blob_index index;
+        mk_vm_offset_t indexOffset = sizeof(header) + i * sizeof(index);
+        
+        if ([self.memoryMap copyBytesAtOffset:indexOffset fromAddress:self.nodeContextAddress into:&index length:sizeof(index) requireFull:YES error:&memoryMapError] < sizeof(index)) {
+            MK_PUSH_WARNING_WITH_ERROR(blobs, MK_EINTERNAL_ERROR, memoryMapError, @"Could not read code signature index entry [%" PRIu32 "].", i);
+            break;
+        }
+        
+        NSError *blobError = nil;
+        MKCodeSignatureBlob *blob = [MKCodeSignatureBlob blobAtOffset:OSSwapBigToHostInt32(index.offset) slot:OSSwapBigToHostInt32(index.type) fromParent:self error:&blobError];
+        if (blob == nil) {
+            MK_PUSH_WARNING_WITH_ERROR(blobs, MK_EINTERNAL_ERROR, blobError, @"Could not parse code signature blob [%" PRIu32 "].", i);
+            continue;
+        }
+        
+        [blobs addObject:blob];
+    }
+    
+    _blobs = blobs;
+    
+    return self;
+}
+
+//|++++++++++++++++++++++++++++++++++++|//
+- (instancetype)initWithImage:(MKMachOImage*)image error:(NSError**)error
+{
+    NSParameterAssert(image != nil);
+    
+    // Find LC_CODE_SIGNATURE
+    MKLCCodeSignature *codeSignatureLoadCommand = nil;
+    {
+        NSArray *commands = [image loadCommandsOfType:LC_CODE_SIGNATURE];
+        if (commands.count > 1)
+            MK_PUSH_WARNING(nil, MK_EINVALID_DATA, @"Image contains multiple LC_CODE_SIGNATURE load commands.  Ignoring %@.", commands.lastObject);
+        
+        if (commands.count == 0) {
+            MK_ERROR_OUT = [NSError mk_errorWithDomain:MKErrorDomain code:MK_ENOT_FOUND description:@"Image does not contain a LC_CODE_SIGNATURE load command."];
+            return nil;
+        }
+        
+        codeSignatureLoadCommand = commands.firstObject;
+    }
+    
+    return [self initWithSize:codeSignatureLoadCommand.datasize offset:codeSignatureLoadCommand.dataoff inImage:image error:error];
+}
+
+//|++++++++++++++++++++++++++++++++++++|//
+- (instancetype)initWithParent:(MKNode*)parent error:(NSError**)error
+{ return [self initWithImage:parent.macho error:error]; }
+
+//◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦//
+#pragma mark -  Blobs
+//◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦//
+
+//|++++++++++++++++++++++++++++++++++++|//
+- (MKCodeSignatureBlob*)blobForSlot:(MKCodeSignatureSlot)slot
+{
+    for (MKCodeSignatureBlob *blob in _blobs) {
+        if (blob.slot == slot)
+            return blob;
+    }
+    return nil;
+}
+
+//|++++++++++++++++++++++++++++++++++++|//
+- (NSArray<MKCodeDirectory*> *)codeDirectories
+{
+    NSMutableArray<MKCodeDirectory*> *codeDirectories = [NSMutableArray array];
+    for (MKCodeSignatureBlob *blob in _blobs) {
+        if ([blob isKindOfClass:MKCodeDirectory.class])
+            [codeDirectories addObject:(MKCodeDirectory*)blob];
+    }
+    return codeDirectories;
+}
+
+//|++++++++++++++++++++++++++++++++++++|//
+- (MKCodeDirectory*)codeDirectory
+{
+    MKCodeDirectory *best = nil;
+    for (MKCodeDirectory *codeDirectory in self.codeDirectories) {
+        if (best == nil || MKCodeSignatureHashTypeRank(codeDirectory.hashType) > MKCodeSignatureHashTypeRank(best.hashType))
+            best = codeDirectory;
+    }
+    return best;
+}
+
+//|++++++++++++++++++++++++++++++++++++|//
+- (MKCodeSignatureRequirements*)requirements
+{
+    MKCodeSignatureBlob *blob = [self blobForSlot:MKCodeSignatureSlotRequirements];
+    return [blob isKindOfClass:MKCodeSignatureRequirements.class] ? (MKCodeSignatureRequirements*)blob : nil;
+}
+
+//|++++++++++++++++++++++++++++++++++++|//
+- (MKCodeSignatureEntitlements*)entitlements
+{
+    MKCodeSignatureBlob *blob = [self blobForSlot:MKCodeSignatureSlotEntitlements];
+    return [blob isKindOfClass:MKCodeSignatureEntitlements.class] ? (MKCodeSignatureEntitlements*)blob : nil;
+}
+
+//◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦//
+#pragma mark -  Verifying Page Hashes
+//◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦//
+
+//|++++++++++++++++++++++++++++++++++++|//
+- (BOOL)verifyWithError:(NSError**)error
+{
+    MKCodeDirectory *codeDirectory = self.codeDirectory;
+    if (codeDirectory == nil) {
+        MK_ERROR_OUT = [NSError mk_errorWithDomain:MKErrorDomain code:MK_ENOT_FOUND description:@"Code signature does not contain a CodeDirectory."];
+        return NO;
+    }
+    
+    return [codeDirectory verifyWithError:error];
+}
+
+//|++++++++++++++++++++++++++++++++++++|//
+- (BOOL)verifySegment:(MKSegment*)segment error:(NSError**)error
+{
+    MKCodeDirectory *codeDirectory = self.codeDirectory;
+    if (codeDirectory == nil) {
+        MK_ERROR_OUT = [NSError mk_errorWithDomain:MKErrorDomain code:MK_ENOT_FOUND description:@"Code signature does not contain a CodeDirectory."];
+        return NO;
+    }
+    
+    return [codeDirectory verifySegment:segment error:error];
+}
+
+//◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦//
+#pragma mark -  Estimating Memory Usage
+//◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦//
+
+//|++++++++++++++++++++++++++++++++++++|//
+- (NSUInteger)estimatedMemoryCost
+{ return super.estimatedMemoryCost + MKEstimatedMemoryCostOfNodes(_blobs); }
+
+//◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦//
+#pragma mark -  MKNode
+//◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦//
+
+//|++++++++++++++++++++++++++++++++++++|//
+- (MKNodeDescription*)layout
+{
+    MKNodeFieldBuilder *magic = [MKNodeFieldBuilder
+        builderWithProperty:MK_PROPERTY(magic)
+        type:MKNodeFieldTypeUnsignedDoubleWord.sharedInstance
+        offset:offsetof(struct mk_cs_super_blob, magic)
+        size:sizeof(uint32_t)
+    ];
+    magic.description = @"Magic";
+    magic.formatter = NSFormatter.mk_hex32Formatter;
+    magic.options = MKNodeFieldOptionDisplayAsDetail;
+    
+    MKNodeFieldBuilder *length = [MKNodeFieldBuilder
+        builderWithProperty:MK_PROPERTY(length)
+        type:MKNodeFieldTypeUnsignedDoubleWord.sharedInstance
+        offset:offsetof(struct mk_cs_super_blob, length)
+        size:sizeof(uint32_t)
+    ];
+    length.description = @"Length";
+    length.options = MKNodeFieldOptionDisplayAsDetail;
+    
+    MKNodeFieldBuilder *count = [MKNodeFieldBuilder
+        builderWithProperty:MK_PROPERTY(count)
+        type:MKNodeFieldTypeUnsignedDoubleWord.sharedInstance
+        offset:offsetof(struct mk_cs_super_blob, count)
+        size:sizeof(uint32_t)
+    ];
+    count.description = @"Count";
+    count.options = MKNodeFieldOptionDisplayAsDetail;
+    
+    MKNodeFieldBuilder *blobs = [MKNodeFieldBuilder
+        builderWithProperty:MK_PROPERTY(blobs)
+        type:[MKNodeFieldTypeCollection typeWithCollectionType:[MKNodeFieldTypeNode typeWithNodeType:MKCodeSignatureBlob.class]]
+    ];
+    blobs.description = @"Blobs";
+    blobs.options = MKNodeFieldOptionDisplayAsChild | MKNodeFieldOptionDisplayContainerContentsAsChild;
+    
+    return [MKNodeDescription nodeDescriptionWithParentDescription:super.layout fields:@[
+        magic.build,
+        length.build,
+        count.build,
+        blobs.build
+    ]];
+}
+
+//◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦//
+#pragma mark -  NSObject
+//◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦//
+
+//|++++++++++++++++++++++++++++++++++++|//
+- (NSString*)description
+{ return @"Code Signature"; }
+
+@end
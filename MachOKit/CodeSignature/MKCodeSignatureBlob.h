@@ -0,0 +1,107 @@
+//----------------------------------------------------------------------------//
+//|
+//|             MachOKit - A Lightweight Mach-O Parsing Library
+//! @file       MKCodeSignatureBlob.h
+//!
+//! @author     D.V.
+//! @copyright  Copyright (c) 2014-2015 D.V. All rights reserved.
+//|
+//| Permission is hereby granted, free of charge, to any person obtaining a
+//| copy of this software and associated documentation files (the "Software"),
+//| to deal in the Software without restriction, including without limitation
+//| the rights to use, copy, modify, merge, publish, distribute, sublicense,
+//| and/or sell copies of the Software, and to permit persons to whom the
+//| Software is furnished to do so, subject to the following conditions:
+//|
+//| The above copyright notice and this permission notice shall be included
+//| in all copies or substantial portions of the Software.
+//|
+//| THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+//| OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+//| MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+//| IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+//| CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+//| TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+//| SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+//----------------------------------------------------------------------------//
+
+#include <MachOKit/macho.h>
+#import <Foundation/Foundation.h>
+
+#import <MachOKit/MKOffsetNode.h>
+
+NS_ASSUME_NONNULL_BEGIN
+
+//----------------------------------------------------------------------------//
+//! @name       Code Signature Blob Magic
+//! @relates    MKCodeSignatureBlob
+//!
+typedef NS_ENUM(uint32_t, MKCodeSignatureMagic) {
+    MKCodeSignatureMagicRequirement             = 0xfade0c00,
+    MKCodeSignatureMagicRequirements            = 0xfade0c01,
+    MKCodeSignatureMagicCodeDirectory           = 0xfade0c02,
+    MKCodeSignatureMagicEmbeddedSignature       = 0xfade0cc0,
+    MKCodeSignatureMagicDetachedSignature       = 0xfade0cc1,
+    MKCodeSignatureMagicBlobWrapper             = 0xfade0b01,
+    MKCodeSignatureMagicEntitlements            = 0xfade7171,
+    MKCodeSignatureMagicDEREntitlements         = 0xfade7172
+};
+
+//----------------------------------------------------------------------------//
+//! @name       Code Signature Slots
+//! @relates    MKCodeSignatureBlob
+//!
+typedef NS_ENUM(uint32_t, MKCodeSignatureSlot) {
+    MKCodeSignatureSlotCodeDirectory            = 0,
+    MKCodeSignatureSlotInfo                     = 1,
+    MKCodeSignatureSlotRequirements             = 2,
+    MKCodeSignatureSlotResourceDirectory        = 3,
+    MKCodeSignatureSlotApplication              = 4,
+    MKCodeSignatureSlotEntitlements             = 5,
+    MKCodeSignatureSlotDEREntitlements          = 7,
+    MKCodeSignatureSlotAlternateCodeDirectories = 0x1000,
+    MKCodeSignatureSlotAlternateCodeDirectoryLimit = 0x1005,
+    MKCodeSignatureSlotSignature                = 0x10000
+};
+
+
+
+//----------------------------------------------------------------------------//
+//! An \c MKCodeSignatureBlob is a blob referenced from the index of an
+//! embedded code signature.  Subclasses parse the blob types that MachOKit
+//! understands; other blobs are represented by this class.
+//!
+//! Unlike the rest of a Mach-O, code signature blobs are always big-endian.
+//
+@interface MKCodeSignatureBlob : MKOffsetNode {
+@package
+    MKCodeSignatureSlot _slot;
+    MKCodeSignatureMagic _magic;
+    uint32_t _length;
+}
+
+//! Returns the subclass of \c MKCodeSignatureBlob that is most suitable for
+//! parsing a blob with the provided \a magic.
++ (Class)classForMagic:(MKCodeSignatureMagic)magic;
+
+//! Subclasses should override this method to indicate whether they can
+//! parse a blob with the provided \a magic.
++ (uint32_t)canInstantiateWithMagic:(MKCodeSignatureMagic)magic;
+
+//! Creates an instance of the most suitable subclass for the blob at
+//! \a offset from \a parent, which is referenced from \a slot.
++ (nullable instancetype)blobAtOffset:(mk_vm_offset_t)offset slot:(MKCodeSignatureSlot)slot fromParent:(MKBackedNode*)parent error:(NSError**)error;
+
+//! The slot that the blob is referenced from.
+@property (nonatomic, assign, readonly) MKCodeSignatureSlot slot;
+//! The blob magic.
+@property (nonatomic, assign, readonly) MKCodeSignatureMagic magic;
+//! The length of the blob, including the magic and length.
+@property (nonatomic, assign, readonly) uint32_t length;
+
+//! The contents of the blob, following the magic and length.
+@property (nonatomic, strong, readonly, nullable) NSData *payload;
+
+@end
+
+NS_ASSUME_NONNULL_END
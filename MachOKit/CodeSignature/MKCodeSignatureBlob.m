@@ -0,0 +1,168 @@
+//----------------------------------------------------------------------------//
+//|
+//|             MachOKit - A Lightweight Mach-O Parsing Library
+//|             MKCodeSignatureBlob.m
+//|
+//|             D.V.
+//|             Copyright (c) 2014-2015 D.V. All rights reserved.
+//|
+//| Permission is hereby granted, free of charge, to any person obtaining a
+//| copy of this software and associated documentation files (the "Software"),
+//| to deal in the Software without restriction, including without limitation
+//| the rights to use, copy, modify, merge, publish, distribute, sublicense,
+//| and/or sell copies of the Software, and to permit persons to whom the
+//| Software is furnished to do so, subject to the following conditions:
+//|
+//| The above copyright notice and this permission notice shall be included
+//| in all copies or substantial portions of the Software.
+//|
+//| THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+//| OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+//| MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+//| IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+//| CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+//| TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+//| SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+//----------------------------------------------------------------------------//
+
+
+#import "MKCodeSignatureBlob.h"
+#import "MKInternal.h"
+#import "_MKCodeSignature.h"
+
+#include <libkern/OSByteOrder.h>
+
+//----------------------------------------------------------------------------//
+@implementation MKCodeSignatureBlob
+
+@synthesize slot = _slot;
+@synthesize magic = _magic;
+@synthesize length = _length;
+
+//|++++++++++++++++++++++++++++++++++++|//
++ (uint32_t)canInstantiateWithMagic:(MKCodeSignatureMagic)magic
+{
+#pragma unused (magic)
+    return (self == MKCodeSignatureBlob.class) ? 10 : 0;
+}
+
+//|++++++++++++++++++++++++++++++++++++|//
++ (Class)classForMagic:(MKCodeSignatureMagic)magic
+{
+    return [self bestSubclassWithRanking:^(Class cls) {
+        return [cls canInstantiateWithMagic:magic];
+    }];
+}
+
+//◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦//
+#pragma mark -  Creating a Blob
+//◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦//
+
+//|++++++++++++++++++++++++++++++++++++|//
++ (instancetype)blobAtOffset:(mk_vm_offset_t)offset slot:(MKCodeSignatureSlot)slot fromParent:(MKBackedNode*)parent error:(NSError**)error
+{
+    NSError *memoryMapError = nil;
+    
+    uint32_t magic = [parent.memoryMap readDoubleWordAtOffset:offset fromAddress:parent.nodeContextAddress withDataModel:nil error:&memoryMapError];
+    if (memoryMapError) {
+        MK_ERROR_OUT = [NSError mk_errorWithDomain:MKErrorDomain code:MK_EINTERNAL_ERROR underlyingError:memoryMapError description:@"Could not read blob magic at offset [%" MK_VM_PRIuOFFSET "] from %@.", offset, parent.compactDescription];
+        return nil;
+    }
+    
+    Class blobClass = [self classForMagic:OSSwapBigToHostInt32(magic)];
+    if (blobClass == NULL) {
+        NSString *reason = [NSString stringWithFormat:@"No class for code signature blob."];
+        @throw [NSException exceptionWithName:NSInternalInconsistencyException reason:reason userInfo:nil];
+    }
+    
+    MKCodeSignatureBlob *blob = [[blobClass alloc] initWithOffset:offset fromParent:parent error:error];
+    if (blob) blob->_slot = slot;
+    return blob;
+}
+
+//|++++++++++++++++++++++++++++++++++++|//
+- (instancetype)initWithOffset:(mk_vm_offset_t)offset fromParent:(MKBackedNode*)parent error:(NSError**)error
+{
+    self = [super initWithOffset:offset fromParent:parent error:error];
+    if (self == nil) return nil;
+    
+    struct mk_cs_blob blob;
+    NSError *memoryMapError = nil;
+    
+    if ([self.memoryMap copyBytesAtOffset:offset fromAddress:parent.nodeContextAddress into:&blob length:sizeof(blob) requireFull:YES error:&memoryMapError] < sizeof(blob)) {
+        MK_ERROR_OUT = [NSError mk_errorWithDomain:MKErrorDomain code:MK_EINTERNAL_ERROR underlyingError:memoryMapError description:@"Could not read blob header."];
+        return nil;
+    }
+    
+    _magic = OSSwapBigToHostInt32(blob.magic);
+    _length = OSSwapBigToHostInt32(blob.length);
+    
+    if (_length < sizeof(blob)) {
+        MK_ERROR_OUT = [NSError mk_errorWithDomain:MKErrorDomain code:MK_EINVALID_DATA description:@"Blob length [%" PRIu32 "] is smaller than the blob header.", _length];
+        return nil;
+    }
+    
+    // The blob must lie within its parent.
+    if ((mk_vm_size_t)offset + _length > parent.nodeSize) {
+        MK_ERROR_OUT = [NSError mk_errorWithDomain:MKErrorDomain code:MK_EINVALID_DATA description:@"Blob at offset [%" MK_VM_PRIuOFFSET "] with length [%" PRIu32 "] extends past the end of %@.", offset, _length, parent.compactDescription];
+        return nil;
+    }
+    
+    return self;
+}
+
+//◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦//
+#pragma mark -  Values
+//◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦//
+
+//|++++++++++++++++++++++++++++++++++++|//
+- (NSData*)payload
+{
+    return [self.memoryMap dataAtOffset:sizeof(struct mk_cs_blob) fromAddress:self.nodeContextAddress length:_length - sizeof(struct mk_cs_blob) requireFull:YES error:NULL];
+}
+
+//◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦//
+#pragma mark -  MKNode
+//◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦//
+
+//|++++++++++++++++++++++++++++++++++++|//
+- (mk_vm_size_t)nodeSize
+{ return _length; }
+
+//|++++++++++++++++++++++++++++++++++++|//
+- (MKNodeDescription*)layout
+{
+    MKNodeFieldBuilder *magic = [MKNodeFieldBuilder
+        builderWithProperty:MK_PROPERTY(magic)
+        type:MKNodeFieldTypeUnsignedDoubleWord.sharedInstance
+        offset:offsetof(struct mk_cs_blob, magic)
+        size:sizeof(uint32_t)
+    ];
+    magic.description = @"Magic";
+    magic.formatter = NSFormatter.mk_hex32Formatter;
+    magic.options = MKNodeFieldOptionDisplayAsDetail;
+    
+    MKNodeFieldBuilder *length = [MKNodeFieldBuilder
+        builderWithProperty:MK_PROPERTY(length)
+        type:MKNodeFieldTypeUnsignedDoubleWord.sharedInstance
+        offset:offsetof(struct mk_cs_blob, length)
+        size:sizeof(uint32_t)
+    ];
+    length.description = @"Length";
+    length.options = MKNodeFieldOptionDisplayAsDetail;
+    
+    return [MKNodeDescription nodeDescriptionWithParentDescription:super.layout fields:@[
+        magic.build,
+        length.build
+    ]];
+}
+
+//◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦//
+#pragma mark -  NSObject
+//◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦//
+
+//|++++++++++++++++++++++++++++++++++++|//
+- (NSString*)description
+{ return [NSString stringWithFormat:@"Blob (0x%08" PRIx32 ")", (uint32_t)_magic]; }
+
+@end
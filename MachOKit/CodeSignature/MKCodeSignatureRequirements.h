@@ -0,0 +1,65 @@
+//----------------------------------------------------------------------------//
+//|
+//|             MachOKit - A Lightweight Mach-O Parsing Library
+//! @file       MKCodeSignatureRequirements.h
+//!
+//! @author     D.V.
+//! @copyright  Copyright (c) 2014-2015 D.V. All rights reserved.
+//|
+//| Permission is hereby granted, free of charge, to any person obtaining a
+//| copy of this software and associated documentation files (the "Software"),
+//| to deal in the Software without restriction, including without limitation
+//| the rights to use, copy, modify, merge, publish, distribute, sublicense,
+//| and/or sell copies of the Software, and to permit persons to whom the
+//| Software is furnished to do so, subject to the following conditions:
+//|
+//| The above copyright notice and this permission notice shall be included
+//| in all copies or substantial portions of the Software.
+//|
+//| THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+//| OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+//| MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+//| IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+//| CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+//| TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+//| SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+//----------------------------------------------------------------------------//
+
+#include <MachOKit/macho.h>
+#import <Foundation/Foundation.h>
+
+#import <MachOKit/MKCodeSignatureBlob.h>
+
+NS_ASSUME_NONNULL_BEGIN
+
+//----------------------------------------------------------------------------//
+//! @name       Requirement Types
+//! @relates    MKCodeSignatureRequirements
+//!
+typedef NS_ENUM(uint32_t, MKCodeSignatureRequirementType) {
+    MKCodeSignatureRequirementTypeHost          = 1,
+    MKCodeSignatureRequirementTypeGuest         = 2,
+    MKCodeSignatureRequirementTypeDesignated    = 3,
+    MKCodeSignatureRequirementTypeLibrary       = 4,
+    MKCodeSignatureRequirementTypePlugin        = 5
+};
+
+
+
+//----------------------------------------------------------------------------//
+//! An \c MKCodeSignatureRequirements parses the requirements set referenced
+//! from the \ref MKCodeSignatureSlotRequirements slot.  Each requirement is
+//! itself a blob, whose \c slot is its \ref MKCodeSignatureRequirementType.
+//! The requirement expressions are not decoded.
+//
+@interface MKCodeSignatureRequirements : MKCodeSignatureBlob {
+@package
+    NSArray<MKCodeSignatureBlob*> *_requirements;
+}
+
+//! The requirement blobs.
+@property (nonatomic, strong, readonly) NSArray<MKCodeSignatureBlob*> *requirements;
+
+@end
+
+NS_ASSUME_NONNULL_END
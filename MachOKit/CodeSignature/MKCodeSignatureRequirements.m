@@ -0,0 +1,118 @@
+//----------------------------------------------------------------------------//
+//|
+//|             MachOKit - A Lightweight Mach-O Parsing Library
+//|             MKCodeSignatureRequirements.m
+//|
+//|             D.V.
+//|             Copyright (c) 2014-2015 D.V. All rights reserved.
+//|
+//| Permission is hereby granted, free of charge, to any person obtaining a
+//| copy of this software and associated documentation files (the "Software"),
+//| to deal in the Software without restriction, including without limitation
+//| the rights to use, copy, modify, merge, publish, distribute, sublicense,
+//| and/or sell copies of the Software, and to permit persons to whom the
+//| Software is furnished to do so, subject to the following conditions:
+//|
+//| The above copyright notice and this permission notice shall be included
+//| in all copies or substantial portions of the Software.
+//|
+//| THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+//| OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+//| MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+//| IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+//| CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+//| TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+//| SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+//----------------------------------------------------------------------------//
+
+
+#import "MKCodeSignatureRequirements.h"
+#import "MKInternal.h"
+#import "_MKCodeSignature.h"
+
+#include <libkern/OSByteOrder.h>
+
+//----------------------------------------------------------------------------//
+@implementation MKCodeSignatureRequirements
+
+@synthesize requirements = _requirements;
+
+//|++++++++++++++++++++++++++++++++++++|//
++ (uint32_t)canInstantiateWithMagic:(MKCodeSignatureMagic)magic
+{ return (magic == MKCodeSignatureMagicRequirements) ? 50 : 0; }
+
+//|++++++++++++++++++++++++++++++++++++|//
+- (instancetype)initWithOffset:(mk_vm_offset_t)offset fromParent:(MKBackedNode*)parent error:(NSError**)error
+{
+    self = [super initWithOffset:offset fromParent:parent error:error];
+    if (self == nil) return nil;
+    
+    NSMutableArray<MKCodeSignatureBlob*> *requirements = [NSMutableArray array];
+    NSError *memoryMapError = nil;
+    
+    struct mk_cs_super_blob header;
+    if (self.length < sizeof(header) || [self.memoryMap copyBytesAtOffset:0 fromAddress:self.nodeContextAddress into:&header length:sizeof(header) requireFull:YES error:&memoryMapError] < sizeof(header)) {
+        MK_PUSH_WARNING_WITH_ERROR(requirements, MK_EINVALID_DATA, memoryMapError, @"Could not read requirements header.");
+        _requirements = requirements;
+        return self;
+    }
+    
+    uint32_t count = OSSwapBigToHostInt32(header.count);
+    if ((uint64_t)count * sizeof(struct mk_cs_blob_index) > self.length - sizeof(header)) {
+        MK_PUSH_WARNING(requirements, MK_EINVALID_DATA, @"Requirements count [%" PRIu32 "] exceeds the length of the blob.", count);
+        count = (uint32_t)((self.length - sizeof(header)) / sizeof(struct mk_cs_blob_index));
+    }
+    
+    for (uint32_t i = 0; i < count; i++)
+    {
+        struct mk_cs_blob_index index;
+        mk_vm_offset_t indexOffset = sizeof(header) + i * sizeof(index);
+        
+        if ([self.memoryMap copyBytesAtOffset:indexOffset fromAddress:self.nodeContextAddress into:&index length:sizeof(index) requireFull:YES error:&memoryMapError] < sizeof(index)) {
+            MK_PUSH_WARNING_WITH_ERROR(requirements, MK_EINTERNAL_ERROR, memoryMapError, @"Could not read requirements index entry [%" PRIu32 "].", i);
+            break;
+        }
+        
+        NSError *blobError = nil;
+        MKCodeSignatureBlob *requirement = [MKCodeSignatureBlob blobAtOffset:OSSwapBigToHostInt32(index.offset) slot:OSSwapBigToHostInt32(index.type) fromParent:self error:&blobError];
+        if (requirement == nil) {
+            MK_PUSH_WARNING_WITH_ERROR(requirements, MK_EINTERNAL_ERROR, blobError, @"Could not parse requirement [%" PRIu32 "].", i);
+            continue;
+        }
+        
+        [requirements addObject:requirement];
+    }
+    
+    _requirements = requirements;
+    
+    return self;
+}
+
+//◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦//
+#pragma mark -  MKNode
+//◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦//
+
+//|++++++++++++++++++++++++++++++++++++|//
+- (MKNodeDescription*)layout
+{
+    MKNodeFieldBuilder *requirements = [MKNodeFieldBuilder
+        builderWithProperty:MK_PROPERTY(requirements)
+        type:[MKNodeFieldTypeCollection typeWithCollectionType:[MKNodeFieldTypeNode typeWithNodeType:MKCodeSignatureBlob.class]]
+    ];
+    requirements.description = @"Requirements";
+    requirements.options = MKNodeFieldOptionDisplayAsChild | MKNodeFieldOptionDisplayContainerContentsAsChild;
+    
+    return [MKNodeDescription nodeDescriptionWithParentDescription:super.layout fields:@[
+        requirements.build
+    ]];
+}
+
+//◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦//
+#pragma mark -  NSObject
+//◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦//
+
+//|++++++++++++++++++++++++++++++++++++|//
+- (NSString*)description
+{ return @"Requirements"; }
+
+@end
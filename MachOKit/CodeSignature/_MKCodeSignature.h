@@ -0,0 +1,106 @@
+//----------------------------------------------------------------------------//
+//|
+//|             MachOKit - A Lightweight Mach-O Parsing Library
+//! @file       _MKCodeSignature.h
+//!
+//! @author     D.V.
+//! @copyright  Copyright (c) 2014-2015 D.V. All rights reserved.
+//|
+//| Permission is hereby granted, free of charge, to any person obtaining a
+//| copy of this software and associated documentation files (the "Software"),
+//| to deal in the Software without restriction, including without limitation
+//| the rights to use, copy, modify, merge, publish, distribute, sublicense,
+//| and/or sell copies of the Software, and to permit persons to whom the
+//| Software is furnished to do so, subject to the following conditions:
+//|
+//| The above copyright notice and this permission notice shall be included
+//| in all copies or substantial portions of the Software.
+//|
+//| THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+//| OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+//| MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+//| IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+//| CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+//| TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+//| SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+//----------------------------------------------------------------------------//
+
+#ifndef _MKCodeSignature_h
+#define _MKCodeSignature_h
+
+#include <stddef.h>
+#include <stdint.h>
+
+//----------------------------------------------------------------------------//
+#pragma mark -  Structures
+//
+// The embedded code signature structures, from <kern/cs_blobs.h>, which is
+// not part of the user-space SDK.  All fields are big-endian.
+//----------------------------------------------------------------------------//
+
+struct mk_cs_blob {
+    uint32_t magic;
+    uint32_t length;
+};
+
+struct mk_cs_blob_index {
+    uint32_t type;
+    uint32_t offset;
+};
+
+struct mk_cs_super_blob {
+    uint32_t magic;
+    uint32_t length;
+    uint32_t count;
+    // struct mk_cs_blob_index index[];
+};
+
+struct mk_cs_code_directory {
+    uint32_t magic;
+    uint32_t length;
+    uint32_t version;
+    uint32_t flags;
+    uint32_t hashOffset;
+    uint32_t identOffset;
+    uint32_t nSpecialSlots;
+    uint32_t nCodeSlots;
+    uint32_t codeLimit;
+    uint8_t hashSize;
+    uint8_t hashType;
+    uint8_t platform;
+    uint8_t pageSize;
+    uint32_t spare2;
+    // Version 0x20100
+    uint32_t scatterOffset;
+    // Version 0x20200
+    uint32_t teamOffset;
+    // Version 0x20300
+    uint32_t spare3;
+    uint64_t codeLimit64;
+    // Version 0x20400
+    uint64_t execSegBase;
+    uint64_t execSegLimit;
+    uint64_t execSegFlags;
+} __attribute__((packed));
+
+#define MK_CS_CODE_DIRECTORY_SUPPORTS_SCATTER           0x20100
+#define MK_CS_CODE_DIRECTORY_SUPPORTS_TEAM_ID           0x20200
+#define MK_CS_CODE_DIRECTORY_SUPPORTS_CODE_LIMIT_64     0x20300
+#define MK_CS_CODE_DIRECTORY_SUPPORTS_EXEC_SEGMENT      0x20400
+
+//----------------------------------------------------------------------------//
+#pragma mark -  Hashing
+//----------------------------------------------------------------------------//
+
+#define MK_CS_SHA1_DIGEST_LENGTH        20
+#define MK_CS_SHA256_DIGEST_LENGTH      32
+
+//! Computes the SHA-1 digest of \a length bytes at \a data.
+void
+MKCodeSignatureSHA1(const void *data, size_t length, uint8_t digest[MK_CS_SHA1_DIGEST_LENGTH]);
+
+//! Computes the SHA-256 digest of \a length bytes at \a data.
+void
+MKCodeSignatureSHA256(const void *data, size_t length, uint8_t digest[MK_CS_SHA256_DIGEST_LENGTH]);
+
+#endif /* _MKCodeSignature_h */
@@ -0,0 +1,213 @@
+//----------------------------------------------------------------------------//
+//|
+//|             MachOKit - A Lightweight Mach-O Parsing Library
+//|             _MKCodeSignatureHash.c
+//|
+//|             D.V.
+//|             Copyright (c) 2014-2015 D.V. All rights reserved.
+//|
+//| Permission is hereby granted, free of charge, to any person obtaining a
+//| copy of this software and associated documentation files (the "Software"),
+//| to deal in the Software without restriction, including without limitation
+//| the rights to use, copy, modify, merge, publish, distribute, sublicense,
+//| and/or sell copies of the Software, and to permit persons to whom the
+//| Software is furnished to do so, subject to the following conditions:
+//|
+//| The above copyright notice and this permission notice shall be included
+//| in all copies or substantial portions of the Software.
+//|
+//| THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+//| OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+//| MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+//| IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+//| CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+//| TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+//| SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+//----------------------------------------------------------------------------//
+
+
+#include "_MKCodeSignature.h"
+#include <string.h>
+
+// Page hashes dominate the cost of verifying a code signature, and the
+// signatures we verify only use SHA-1 and SHA-256.  These are small,
+// portable implementations of FIPS 180-4 that do not depend on a platform
+// crypto library.
+
+//|++++++++++++++++++++++++++++++++++++|//
+static inline uint32_t
+MKCSRotateLeft(uint32_t x, unsigned n)
+{ return (x << n) | (x >> (32 - n)); }
+
+//|++++++++++++++++++++++++++++++++++++|//
+static inline uint32_t
+MKCSRotateRight(uint32_t x, unsigned n)
+{ return (x >> n) | (x << (32 - n)); }
+
+//|++++++++++++++++++++++++++++++++++++|//
+static inline uint32_t
+MKCSLoadBigEndian32(const uint8_t *p)
+{ return ((uint32_t)p[0] << 24) | ((uint32_t)p[1] << 16) | ((uint32_t)p[2] << 8) | (uint32_t)p[3]; }
+
+//|++++++++++++++++++++++++++++++++++++|//
+static inline void
+MKCSStoreBigEndian32(uint8_t *p, uint32_t v)
+{
+    p[0] = (uint8_t)(v >> 24);
+    p[1] = (uint8_t)(v >> 16);
+    p[2] = (uint8_t)(v >> 8);
+    p[3] = (uint8_t)v;
+}
+
+//|++++++++++++++++++++++++++++++++++++|//
+//! Invokes \a block for each 64 byte block of the padded message.  Both
+//! digests share the Merkle–Damgård padding with a 64-bit big-endian length.
+static void
+MKCSForEachPaddedBlock(const void *data, size_t length, void *state, void (*block)(void *state, const uint8_t chunk[64]))
+{
+    const uint8_t *bytes = data;
+    size_t remaining = length;
+    
+    while (remaining >= 64) {
+        block(state, bytes);
+        bytes += 64;
+        remaining -= 64;
+    }
+    
+    uint8_t tail[128] = { 0 };
+    memcpy(tail, bytes, remaining);
+    tail[remaining] = 0x80;
+    
+    size_t tailLength = (remaining < 56) ? 64 : 128;
+    uint64_t bits = (uint64_t)length * 8;
+    for (int i = 0; i < 8; i++)
+        tail[tailLength - 1 - i] = (uint8_t)(bits >> (8 * i));
+    
+    block(state, tail);
+    if (tailLength == 128)
+        block(state, tail + 64);
+}
+
+//----------------------------------------------------------------------------//
+#pragma mark -  SHA-1
+//----------------------------------------------------------------------------//
+
+//|++++++++++++++++++++++++++++++++++++|//
+static void
+MKCSSHA1Block(void *state, const uint8_t chunk[64])
+{
+    uint32_t *h = state;
+    uint32_t w[80];
+    
+    for (int i = 0; i < 16; i++)
+        w[i] = MKCSLoadBigEndian32(chunk + 4 * i);
+    for (int i = 16; i < 80; i++)
+        w[i] = MKCSRotateLeft(w[i - 3] ^ w[i - 8] ^ w[i - 14] ^ w[i - 16], 1);
+    
+    uint32_t a = h[0], b = h[1], c = h[2], d = h[3], e = h[4];
+    
+    for (int i = 0; i < 80; i++) {
+        uint32_t f, k;
+        if (i < 20) {
+            f = (b & c) | (~b & d);
+            k = 0x5a827999;
+        } else if (i < 40) {
+            f = b ^ c ^ d;
+            k = 0x6ed9eba1;
+        } else if (i < 60) {
+            f = (b & c) | (b & d) | (c & d);
+            k = 0x8f1bbcdc;
+        } else {
+            f = b ^ c ^ d;
+            k = 0xca62c1d6;
+        }
+        
+        uint32_t t = MKCSRotateLeft(a, 5) + f + e + k + w[i];
+        e = d;
+        d = c;
+        c = MKCSRotateLeft(b, 30);
+        b = a;
+        a = t;
+    }
+    
+    h[0] += a; h[1] += b; h[2] += c; h[3] += d; h[4] += e;
+}
+
+//|++++++++++++++++++++++++++++++++++++|//
+void
+MKCodeSignatureSHA1(const void *data, size_t length, uint8_t digest[MK_CS_SHA1_DIGEST_LENGTH])
+{
+    uint32_t h[5] = { 0x67452301, 0xefcdab89, 0x98badcfe, 0x10325476, 0xc3d2e1f0 };
+    
+    MKCSForEachPaddedBlock(data, length, h, MKCSSHA1Block);
+    
+    for (int i = 0; i < 5; i++)
+        MKCSStoreBigEndian32(digest + 4 * i, h[i]);
+}
+
+//----------------------------------------------------------------------------//
+#pragma mark -  SHA-256
+//----------------------------------------------------------------------------//
+
+static const uint32_t MKCSSHA256RoundConstants[64] = {
+    0x428a2f98, 0x71374491, 0xb5c0fbcf, 0xe9b5dba5, 0x3956c25b, 0x59f111f1, 0x923f82a4, 0xab1c5ed5,
+    0xd807aa98, 0x12835b01, 0x243185be, 0x550c7dc3, 0x72be5d74, 0x80deb1fe, 0x9bdc06a7, 0xc19bf174,
+    0xe49b69c1, 0xefbe4786, 0x0fc19dc6, 0x240ca1cc, 0x2de92c6f, 0x4a7484aa, 0x5cb0a9dc, 0x76f988da,
+    0x983e5152, 0xa831c66d, 0xb00327c8, 0xbf597fc7, 0xc6e00bf3, 0xd5a79147, 0x06ca6351, 0x14292967,
+    0x27b70a85, 0x2e1b2138, 0x4d2c6dfc, 0x53380d13, 0x650a7354, 0x766a0abb, 0x81c2c92e, 0x92722c85,
+    0xa2bfe8a1, 0xa81a664b, 0xc24b8b70, 0xc76c51a3, 0xd192e819, 0xd6990624, 0xf40e3585, 0x106aa070,
+    0x19a4c116, 0x1e376c08, 0x2748774c, 0x34b0bcb5, 0x391c0cb3, 0x4ed8aa4a, 0x5b9cca4f, 0x682e6ff3,
+    0x748f82ee, 0x78a5636f, 0x84c87814, 0x8cc70208, 0x90befffa, 0xa4506ceb, 0xbef9a3f7, 0xc67178f2
+};
+
+//|++++++++++++++++++++++++++++++++++++|//
+static void
+MKCSSHA256Block(void *state, const uint8_t chunk[64])
+{
+    uint32_t *h = state;
+    uint32_t w[64];
+    
+    for (int i = 0; i < 16; i++)
+        w[i] = MKCSLoadBigEndian32(chunk + 4 * i);
+    for (int i = 16; i < 64; i++) {
+        uint32_t s0 = MKCSRotateRight(w[i - 15], 7) ^ MKCSRotateRight(w[i - 15], 18) ^ (w[i - 15] >> 3);
+        uint32_t s1 = MKCSRotateRight(w[i - 2], 17) ^ MKCSRotateRight(w[i - 2], 19) ^ (w[i - 2] >> 10);
+        w[i] = w[i - 16] + s0 + w[i - 7] + s1;
+    }
+    
+    uint32_t a = h[0], b = h[1], c = h[2], d = h[3], e = h[4], f = h[5], g = h[6], k = h[7];
+    
+    for (int i = 0; i < 64; i++) {
+        uint32_t S1 = MKCSRotateRight(e, 6) ^ MKCSRotateRight(e, 11) ^ MKCSRotateRight(e, 25);
+        uint32_t ch = (e & f) ^ (~e & g);
+        uint32_t t1 = k + S1 + ch + MKCSSHA256RoundConstants[i] + w[i];
+        uint32_t S0 = MKCSRotateRight(a, 2) ^ MKCSRotateRight(a, 13) ^ MKCSRotateRight(a, 22);
+        uint32_t maj = (a & b) ^ (a & c) ^ (b & c);
+        uint32_t t2 = S0 + maj;
+        
+        k = g;
+        g = f;
+        f = e;
+        e = d + t1;
+        d = c;
+        c = b;
+        b = a;
+        a = t1 + t2;
+    }
+    
+    h[0] += a; h[1] += b; h[2] += c; h[3] += d; h[4] += e; h[5] += f; h[6] += g; h[7] += k;
+}
+
+//|++++++++++++++++++++++++++++++++++++|//
+void
+MKCodeSignatureSHA256(const void *data, size_t length, uint8_t digest[MK_CS_SHA256_DIGEST_LENGTH])
+{
+    uint32_t h[8] = {
+        0x6a09e667, 0xbb67ae85, 0x3c6ef372, 0xa54ff53a, 0x510e527f, 0x9b05688c, 0x1f83d9ab, 0x5be0cd19
+    };
+    
+    MKCSForEachPaddedBlock(data, length, h, MKCSSHA256Block);
+    
+    for (int i = 0; i < 8; i++)
+        MKCSStoreBigEndian32(digest + 4 * i, h[i]);
+}
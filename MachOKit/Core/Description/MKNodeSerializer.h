@@ -0,0 +1,120 @@
+//----------------------------------------------------------------------------//
+//|
+//|             MachOKit - A Lightweight Mach-O Parsing Library
+//! @file       MKNodeSerializer.h
+//!
+//! @author     D.V.
+//! @copyright  Copyright (c) 2014-2015 D.V. All rights reserved.
+//|
+//| Permission is hereby granted, free of charge, to any person obtaining a
+//| copy of this software and associated documentation files (the "Software"),
+//| to deal in the Software without restriction, including without limitation
+//| the rights to use, copy, modify, merge, publish, distribute, sublicense,
+//| and/or sell copies of the Software, and to permit persons to whom the
+//| Software is furnished to do so, subject to the following conditions:
+//|
+//| The above copyright notice and this permission notice shall be included
+//| in all copies or substantial portions of the Software.
+//|
+//| THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+//| OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+//| MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+//| IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+//| CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+//| TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+//| SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+//----------------------------------------------------------------------------//
+
+#import <MachOKit/MKBase.h>
+#import <MachOKit/MKNode.h>
+
+NS_ASSUME_NONNULL_BEGIN
+
+//----------------------------------------------------------------------------//
+//! @name       Node Serialization Formats
+//! @relates    MKNodeSerializer
+//!
+typedef NS_ENUM(NSUInteger, MKNodeSerializationFormat) {
+    //! Compact JSON.  Each top-level node is followed by a newline.
+    MKNodeSerializationFormatJSON               = 0,
+    //! CBOR (RFC 8949).  Nodes and collections are encoded as
+    //! indefinite-length maps and arrays so that they can be streamed.
+    MKNodeSerializationFormatCBOR               = 1
+};
+
+//----------------------------------------------------------------------------//
+//! @name       Node Serialization Options
+//! @relates    MKNodeSerializer
+//!
+typedef NS_OPTIONS(NSUInteger, MKNodeSerializationOptions) {
+    MKNodeSerializationOptionNone               = 0,
+    //! Write the value of fields that have a \c valueFormatter as the
+    //! formatted string rather than the raw value.
+    MKNodeSerializationOptionFormattedValues    = (1U << 0),
+    //! Include fields with the \ref MKNodeFieldOptionHidden option.
+    MKNodeSerializationOptionHiddenFields       = (1U << 1),
+    //! Include the warnings of each node.
+    MKNodeSerializationOptionWarnings           = (1U << 2)
+};
+
+
+
+//----------------------------------------------------------------------------//
+//! An \c MKNodeSerializer writes a node, and the nodes reachable from its
+//! fields, as structured data.
+//!
+//! Output is buffered and written incrementally to a file descriptor or
+//! appended to a mutable data object, so memory use does not grow with the
+//! size of the output.  The \c layout of each node class is compiled into
+//! a plan the first time the class is encountered.  Fields read with a
+//! simple key are then read by calling the getter directly, without going
+//! through KVC or boxing scalar values.  Formatters are only consulted when
+//! \ref MKNodeSerializationOptionFormattedValues is set.
+//!
+//! A node is written as a map with a \c $class key, followed by its
+//! fields.  A node that is already being written further up the tree is
+//! written as a map with only a \c $ref key.
+//!
+//! A serializer is not thread safe.
+//
+@interface MKNodeSerializer : NSObject
+
+//! Writes the output to \a fileDescriptor, which is not closed.
+- (instancetype)initWithFileDescriptor:(int)fileDescriptor format:(MKNodeSerializationFormat)format options:(MKNodeSerializationOptions)options NS_DESIGNATED_INITIALIZER;
+
+//! Appends the output to \a data.
+- (instancetype)initWithMutableData:(NSMutableData*)data format:(MKNodeSerializationFormat)format options:(MKNodeSerializationOptions)options;
+
+- (instancetype)init NS_UNAVAILABLE;
+
+@property (nonatomic, readonly) MKNodeSerializationFormat format;
+@property (nonatomic, readonly) MKNodeSerializationOptions options;
+
+//! The maximum depth of nested nodes to write.  Nodes below this depth are
+//! written as a \c $ref map.  Defaults to \c NSUIntegerMax.
+@property (nonatomic, assign) NSUInteger maximumDepth;
+
+//! Writes \a node, and flushes the output.  Returns \c NO if the output
+//! could not be written.
+- (BOOL)serializeNode:(MKNode*)node error:(NSError**)error;
+
+//! Writes any buffered output.
+- (BOOL)flushWithError:(NSError**)error;
+
+@end
+
+
+
+//----------------------------------------------------------------------------//
+@interface MKNode (MKNodeSerializer)
+
+//! Whether the fields in the \c layout of every instance of the receiver,
+//! and of its subclasses, are the same.  If \c YES, a
+//! \ref MKNodeSerializer compiles the layout once for the class.  Otherwise
+//! the layout of each instance is read, and instances with the same fields
+//! share a compiled layout.  The default is \c NO.
++ (BOOL)hasInvariantLayout;
+
+@end
+
+NS_ASSUME_NONNULL_END
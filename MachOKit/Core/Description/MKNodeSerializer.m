@@ -0,0 +1,893 @@
+//----------------------------------------------------------------------------//
+//|
+//|             MachOKit - A Lightweight Mach-O Parsing Library
+//|             MKNodeSerializer.m
+//|
+//|             D.V.
+//|             Copyright (c) 2014-2015 D.V. All rights reserved.
+//|
+//| Permission is hereby granted, free of charge, to any person obtaining a
+//| copy of this software and associated documentation files (the "Software"),
+//| to deal in the Software without restriction, including without limitation
+//| the rights to use, copy, modify, merge, publish, distribute, sublicense,
+//| and/or sell copies of the Software, and to permit persons to whom the
+//| Software is furnished to do so, subject to the following conditions:
+//|
+//| The above copyright notice and this permission notice shall be included
+//| in all copies or substantial portions of the Software.
+//|
+//| THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+//| OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+//| MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+//| IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+//| CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+//| TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+//| SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+//----------------------------------------------------------------------------//
+
+
+#import "MKNodeSerializer.h"
+#import "MKInternal.h"
+#import "MKBackedNode.h"
+#import "MKNodeField.h"
+#import "MKNodeFieldOperationReadKeyPath.h"
+
+#include <objc/runtime.h>
+#include <libkern/OSByteOrder.h>
+#include <unistd.h>
+#include <errno.h>
+
+//! The size of the output buffer.
+#define MKNodeSerializerBufferSize      (64 * 1024)
+
+//----------------------------------------------------------------------------//
+//! How the value of a field is read.
+typedef NS_ENUM(uint8_t, MKNodeSerializerAccessor) {
+    //! Evaluate the value recipe of the field.
+    MKNodeSerializerAccessorRecipe      = 0,
+    //! Call a getter that returns an object.
+    MKNodeSerializerAccessorObject,
+    //! Call a getter that returns a signed integer.
+    MKNodeSerializerAccessorSigned,
+    //! Call a getter that returns an unsigned integer.
+    MKNodeSerializerAccessorUnsigned,
+    //! Call a getter that returns a bool or a BOOL.
+    MKNodeSerializerAccessorBoolean,
+    //! Call a getter that returns a floating point value.
+    MKNodeSerializerAccessorDouble
+};
+
+//----------------------------------------------------------------------------//
+typedef struct MKNodeSerializerFieldPlan {
+    // Unretained.  The plan retains its fields, which retain their
+    // formatters.
+    __unsafe_unretained MKNodeField *field;
+    __unsafe_unretained NSFormatter *formatter;
+    MKNodeFieldOptions options;
+    SEL getter;
+    IMP imp;
+    MKNodeSerializerAccessor accessor;
+    //! The Objective-C type encoding of the getter's return value.
+    char returnType;
+    //! The range of the encoded key within the keys of the plan.
+    NSRange key;
+} MKNodeSerializerFieldPlan;
+
+
+
+//----------------------------------------------------------------------------//
+//! The compiled \c layout of a node class.
+@interface _MKNodeSerializerPlan : NSObject {
+@package
+    NSArray<MKNodeField*> *_fields;
+    MKNodeSerializerFieldPlan *_entries;
+    NSUInteger _count;
+    //! The encoded field keys, followed by the encoded \c $class key and
+    //! class name.
+    NSMutableData *_keys;
+    NSRange _classKeyAndValue;
+}
+@end
+
+@implementation _MKNodeSerializerPlan
+- (void)dealloc
+{ free(_entries); }
+@end
+
+
+
+//----------------------------------------------------------------------------//
+@implementation MKNodeSerializer {
+    int _fileDescriptor;
+    NSMutableData *_data;
+    uint8_t *_buffer;
+    size_t _bufferLength;
+    NSError *_error;
+    //! Whether a JSON separator is needed before the next value.
+    BOOL _needsSeparator;
+    //! Plans for classes with an invariant layout.
+    NSMapTable<Class, _MKNodeSerializerPlan*> *_plans;
+    //! Plans for other nodes, keyed by their class and fields.
+    NSMutableDictionary<NSArray*, _MKNodeSerializerPlan*> *_layoutPlans;
+    //! The nodes that are being written.
+    NSHashTable *_path;
+    NSUInteger _depth;
+}
+
+@synthesize format = _format;
+@synthesize options = _options;
+@synthesize maximumDepth = _maximumDepth;
+
+//|++++++++++++++++++++++++++++++++++++|//
+- (instancetype)initWithFileDescriptor:(int)fileDescriptor format:(MKNodeSerializationFormat)format options:(MKNodeSerializationOptions)options
+{
+    self = [super init];
+    if (self == nil) return nil;
+    
+    _fileDescriptor = fileDescriptor;
+    _format = format;
+    _options = options;
+    _maximumDepth = NSUIntegerMax;
+    _plans = [NSMapTable strongToStrongObjectsMapTable];
+    _layoutPlans = [NSMutableDictionary dictionary];
+    _path = [NSHashTable hashTableWithOptions:NSPointerFunctionsOpaqueMemory | NSPointerFunctionsOpaquePersonality];
+    
+    _buffer = malloc(MKNodeSerializerBufferSize);
+    if (_buffer == NULL)
+        return nil;
+    
+    return self;
+}
+
+//|++++++++++++++++++++++++++++++++++++|//
+- (instancetype)initWithMutableData:(NSMutableData*)data format:(MKNodeSerializationFormat)format options:(MKNodeSerializationOptions)options
+{
+    NSParameterAssert(data != nil);
+    
+    self = [self initWithFileDescriptor:-1 format:format options:options];
+    if (self == nil) return nil;
+    
+    _data = data;
+    
+    return self;
+}
+
+//|++++++++++++++++++++++++++++++++++++|//
+- (instancetype)init
+{ @throw [NSException exceptionWithName:NSInvalidArgumentException reason:@"-init unavailable." userInfo:nil]; }
+
+//|++++++++++++++++++++++++++++++++++++|//
+- (void)dealloc
+{
+    free(_buffer);
+}
+
+//◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦//
+#pragma mark -  Output
+//◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦//
+
+//|++++++++++++++++++++++++++++++++++++|//
+- (void)_writeOut:(const uint8_t*)bytes length:(size_t)length
+{
+    if (_error) return;
+    
+    if (_data) {
+        [_data appendBytes:bytes length:length];
+        return;
+    }
+    
+    while (length > 0) {
+        ssize_t written = write(_fileDescriptor, bytes, length);
+        if (written < 0) {
+            if (errno == EINTR)
+                continue;
+            
+            NSError *posixError = [NSError errorWithDomain:NSPOSIXErrorDomain code:errno userInfo:nil];
+            _error = [NSError mk_errorWithDomain:MKErrorDomain code:MK_EINTERNAL_ERROR underlyingError:posixError description:@"Could not write to file descriptor [%d].", _fileDescriptor];
+            return;
+        }
+        
+        bytes += written;
+        length -= (size_t)written;
+    }
+}
+
+//|++++++++++++++++++++++++++++++++++++|//
+- (BOOL)flushWithError:(NSError**)error
+{
+    if (_bufferLength) {
+        [self _writeOut:_buffer length:_bufferLength];
+        _bufferLength = 0;
+    }
+    
+    if (_error) {
+        MK_ERROR_OUT = _error;
+        return NO;
+    }
+    
+    return YES;
+}
+
+//|++++++++++++++++++++++++++++++++++++|//
+static inline void
+MKNodeSerializerWrite(MKNodeSerializer *self, const void *bytes, size_t length)
+{
+    if (self->_bufferLength + length > MKNodeSerializerBufferSize) {
+        [self flushWithError:NULL];
+        
+        if (length >= MKNodeSerializerBufferSize) {
+            [self _writeOut:bytes length:length];
+            return;
+        }
+    }
+    
+    memcpy(self->_buffer + self->_bufferLength, bytes, length);
+    self->_bufferLength += length;
+}
+
+//|++++++++++++++++++++++++++++++++++++|//
+static inline void
+MKNodeSerializerWriteByte(MKNodeSerializer *self, uint8_t byte)
+{
+    if (self->_bufferLength == MKNodeSerializerBufferSize)
+        [self flushWithError:NULL];
+    self->_buffer[self->_bufferLength++] = byte;
+}
+
+//◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦//
+#pragma mark -  Encoding
+//◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦//
+
+//|++++++++++++++++++++++++++++++++++++|//
+//! Writes a CBOR initial byte and argument.
+static void
+MKNodeSerializerCBORHead(void (^write)(const void*, size_t), uint8_t major, uint64_t value)
+{
+    uint8_t head[9];
+    size_t length;
+    
+    major <<= 5;
+    if (value < 24) {
+        head[0] = major | (uint8_t)value;
+        length = 1;
+    } else if (value <= UINT8_MAX) {
+        head[0] = major | 24;
+        head[1] = (uint8_t)value;
+        length = 2;
+    } else if (value <= UINT16_MAX) {
+        head[0] = major | 25;
+        OSWriteBigInt16(head, 1, (uint16_t)value);
+        length = 3;
+    } else if (value <= UINT32_MAX) {
+        head[0] = major | 26;
+        OSWriteBigInt32(head, 1, (uint32_t)value);
+        length = 5;
+    } else {
+        head[0] = major | 27;
+        OSWriteBigInt64(head, 1, value);
+        length = 9;
+    }
+    
+    write(head, length);
+}
+
+//|++++++++++++++++++++++++++++++++++++|//
+//! Writes \a bytes as the body of a JSON string, without the quotes.
+static void
+MKNodeSerializerJSONEscape(void (^write)(const void*, size_t), const uint8_t *bytes, size_t length)
+{
+    static const char hex[] = "0123456789abcdef";
+    size_t run = 0;
+    
+    for (size_t i = 0; i < length; i++) {
+        uint8_t c = bytes[i];
+        if (c >= 0x20 && c != '"' && c != '\\')
+            continue;
+        
+        write(bytes + run, i - run);
+        run = i + 1;
+        
+        switch (c) {
+            case '"':   write("\\\"", 2); break;
+            case '\\':  write("\\\\", 2); break;
+            case '\n':  write("\\n", 2); break;
+            case '\r':  write("\\r", 2); break;
+            case '\t':  write("\\t", 2); break;
+            default: {
+                char escape[6] = { '\\', 'u', '0', '0', hex[c >> 4], hex[c & 0xf] };
+                write(escape, sizeof(escape));
+                break;
+            }
+        }
+    }
+    
+    write(bytes + run, length - run);
+}
+
+//|++++++++++++++++++++++++++++++++++++|//
+//! Encodes a map key in \a format.
+static void
+MKNodeSerializerEncodeKey(MKNodeSerializationFormat format, NSMutableData *output, NSString *key)
+{
+    void (^write)(const void*, size_t) = ^(const void *bytes, size_t length) {
+        [output appendBytes:bytes length:length];
+    };
+    NSData *utf8 = [key dataUsingEncoding:NSUTF8StringEncoding];
+    
+    if (format == MKNodeSerializationFormatCBOR) {
+        MKNodeSerializerCBORHead(write, 3, utf8.length);
+        write(utf8.bytes, utf8.length);
+    } else {
+        write("\"", 1);
+        MKNodeSerializerJSONEscape(write, utf8.bytes, utf8.length);
+        write("\":", 2);
+    }
+}
+
+//|++++++++++++++++++++++++++++++++++++|//
+- (void)_beginValue
+{
+    if (_format == MKNodeSerializationFormatJSON && _needsSeparator)
+        MKNodeSerializerWriteByte(self, ',');
+    _needsSeparator = YES;
+}
+
+//|++++++++++++++++++++++++++++++++++++|//
+- (void)_writeEncodedKey:(const void*)bytes length:(size_t)length
+{
+    [self _beginValue];
+    MKNodeSerializerWrite(self, bytes, length);
+    _needsSeparator = NO;
+}
+
+//|++++++++++++++++++++++++++++++++++++|//
+- (void)_writeKey:(NSString*)key
+{
+    NSMutableData *encoded = [NSMutableData data];
+    MKNodeSerializerEncodeKey(_format, encoded, key);
+    [self _writeEncodedKey:encoded.bytes length:encoded.length];
+}
+
+//|++++++++++++++++++++++++++++++++++++|//
+- (void)_beginContainer:(BOOL)isMap
+{
+    [self _beginValue];
+    if (_format == MKNodeSerializationFormatCBOR)
+        MKNodeSerializerWriteByte(self, isMap ? 0xbf : 0x9f);
+    else
+        MKNodeSerializerWriteByte(self, isMap ? '{' : '[');
+    _needsSeparator = NO;
+}
+
+//|++++++++++++++++++++++++++++++++++++|//
+- (void)_endContainer:(BOOL)isMap
+{
+    if (_format == MKNodeSerializationFormatCBOR)
+        MKNodeSerializerWriteByte(self, 0xff);
+    else
+        MKNodeSerializerWriteByte(self, isMap ? '}' : ']');
+    _needsSeparator = YES;
+}
+
+//|++++++++++++++++++++++++++++++++++++|//
+- (void)_writeNull
+{
+    [self _beginValue];
+    if (_format == MKNodeSerializationFormatCBOR)
+        MKNodeSerializerWriteByte(self, 0xf6);
+    else
+        MKNodeSerializerWrite(self, "null", 4);
+}
+
+//|++++++++++++++++++++++++++++++++++++|//
+- (void)_writeBoolean:(BOOL)value
+{
+    [self _beginValue];
+    if (_format == MKNodeSerializationFormatCBOR)
+        MKNodeSerializerWriteByte(self, value ? 0xf5 : 0xf4);
+    else if (value)
+        MKNodeSerializerWrite(self, "true", 4);
+    else
+        MKNodeSerializerWrite(self, "false", 5);
+}
+
+//|++++++++++++++++++++++++++++++++++++|//
+- (void)_writeUnsigned:(uint64_t)value
+{
+    [self _beginValue];
+    if (_format == MKNodeSerializationFormatCBOR) {
+        MKNodeSerializerCBORHead(^(const void *bytes, size_t length) { MKNodeSerializerWrite(self, bytes, length); }, 0, value);
+    } else {
+        char text[24];
+        int length = snprintf(text, sizeof(text), "%" PRIu64, value);
+        MKNodeSerializerWrite(self, text, (size_t)length);
+    }
+}
+
+//|++++++++++++++++++++++++++++++++++++|//
+- (void)_writeSigned:(int64_t)value
+{
+    if (value >= 0) {
+        [self _writeUnsigned:(uint64_t)value];
+        return;
+    }
+    
+    [self _beginValue];
+    if (_format == MKNodeSerializationFormatCBOR) {
+        MKNodeSerializerCBORHead(^(const void *bytes, size_t length) { MKNodeSerializerWrite(self, bytes, length); }, 1, ~(uint64_t)value);
+    } else {
+        char text[24];
+        int length = snprintf(text, sizeof(text), "%" PRIi64, value);
+        MKNodeSerializerWrite(self, text, (size_t)length);
+    }
+}
+
+//|++++++++++++++++++++++++++++++++++++|//
+- (void)_writeDouble:(double)value
+{
+    if (_format == MKNodeSerializationFormatJSON && !isfinite(value)) {
+        // JSON can not represent infinities or NaN.
+        [self _writeNull];
+        return;
+    }
+    
+    [self _beginValue];
+    if (_format == MKNodeSerializationFormatCBOR) {
+        uint8_t encoded[9] = { 0xfb };
+        uint64_t bits;
+        memcpy(&bits, &value, sizeof(bits));
+        OSWriteBigInt64(encoded, 1, bits);
+        MKNodeSerializerWrite(self, encoded, sizeof(encoded));
+    } else {
+        char text[32];
+        int length = snprintf(text, sizeof(text), "%.17g", value);
+        MKNodeSerializerWrite(self, text, (size_t)length);
+    }
+}
+
+//|++++++++++++++++++++++++++++++++++++|//
+- (void)_writeUTF8:(const uint8_t*)bytes length:(size_t)length
+{
+    [self _beginValue];
+    if (_format == MKNodeSerializationFormatCBOR) {
+        MKNodeSerializerCBORHead(^(const void *b, size_t l) { MKNodeSerializerWrite(self, b, l); }, 3, length);
+        MKNodeSerializerWrite(self, bytes, length);
+    } else {
+        MKNodeSerializerWriteByte(self, '"');
+        MKNodeSerializerJSONEscape(^(const void *b, size_t l) { MKNodeSerializerWrite(self, b, l); }, bytes, length);
+        MKNodeSerializerWriteByte(self, '"');
+    }
+}
+
+//|++++++++++++++++++++++++++++++++++++|//
+- (void)_writeString:(NSString*)string
+{
+    const char *utf8 = CFStringGetCStringPtr((__bridge CFStringRef)string, kCFStringEncodingUTF8);
+    if (utf8) {
+        [self _writeUTF8:(const uint8_t*)utf8 length:strlen(utf8)];
+    } else {
+        NSData *data = [string dataUsingEncoding:NSUTF8StringEncoding allowLossyConversion:YES];
+        [self _writeUTF8:data.bytes length:data.length];
+    }
+}
+
+//|++++++++++++++++++++++++++++++++++++|//
+- (void)_writeData:(NSData*)data
+{
+    if (_format == MKNodeSerializationFormatCBOR) {
+        [self _beginValue];
+        MKNodeSerializerCBORHead(^(const void *b, size_t l) { MKNodeSerializerWrite(self, b, l); }, 2, data.length);
+        [data enumerateByteRangesUsingBlock:^(const void *bytes, NSRange byteRange, BOOL __unused *stop) {
+            MKNodeSerializerWrite(self, bytes, byteRange.length);
+        }];
+    } else {
+        // JSON has no byte strings.  Write the data as hex.
+        static const char hex[] = "0123456789abcdef";
+        [self _beginValue];
+        MKNodeSerializerWriteByte(self, '"');
+        [data enumerateByteRangesUsingBlock:^(const void *bytes, NSRange byteRange, BOOL __unused *stop) {
+            for (NSUInteger i = 0; i < byteRange.length; i++) {
+                uint8_t byte = ((const uint8_t*)bytes)[i];
+                MKNodeSerializerWriteByte(self, (uint8_t)hex[byte >> 4]);
+                MKNodeSerializerWriteByte(self, (uint8_t)hex[byte & 0xf]);
+            }
+        }];
+        MKNodeSerializerWriteByte(self, '"');
+    }
+}
+
+//|++++++++++++++++++++++++++++++++++++|//
+- (void)_writeNumber:(NSNumber*)number
+{
+    if ((__bridge CFBooleanRef)number == kCFBooleanTrue || (__bridge CFBooleanRef)number == kCFBooleanFalse) {
+        [self _writeBoolean:number.boolValue];
+        return;
+    }
+    
+    switch (number.objCType[0]) {
+        case 'f':
+        case 'd':
+            [self _writeDouble:number.doubleValue];
+            break;
+        case 'C':
+        case 'S':
+        case 'I':
+        case 'L':
+        case 'Q':
+            [self _writeUnsigned:number.unsignedLongLongValue];
+            break;
+        default:
+            [self _writeSigned:number.longLongValue];
+            break;
+    }
+}
+
+//◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦//
+#pragma mark -  Plans
+//◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦//
+
+//|++++++++++++++++++++++++++++++++++++|//
+- (void)_compileAccessorForEntry:(MKNodeSerializerFieldPlan*)entry ofClass:(Class)cls
+{
+    entry->accessor = MKNodeSerializerAccessorRecipe;
+    
+    // Formatted values are computed from the boxed value.
+    if (entry->formatter && (_options & MKNodeSerializationOptionFormattedValues))
+        return;
+    
+    id<MKNodeFieldValueRecipe> recipe = entry->field.valueRecipe;
+    if ([recipe isKindOfClass:MKNodeFieldOperationReadKeyPath.class] == NO)
+        return;
+    
+    NSString *keyPath = ((MKNodeFieldOperationReadKeyPath*)recipe)->_keyPath ?: entry->field.name;
+    if ([keyPath rangeOfString:@"."].location != NSNotFound)
+        return;
+    
+    SEL getter = NSSelectorFromString(keyPath);
+    Method method = class_getInstanceMethod(cls, getter);
+    if (method == NULL || method_getNumberOfArguments(method) != 2)
+        return;
+    
+    char returnType[16];
+    method_getReturnType(method, returnType, sizeof(returnType));
+    
+    // Skip type qualifiers.
+    const char *type = returnType;
+    while (*type && strchr("rnNoORV", *type))
+        type++;
+    
+    switch (*type) {
+        case '@':
+            entry->accessor = MKNodeSerializerAccessorObject;
+            break;
+        case 'c':
+            // BOOL is a signed char where it is not a bool.  No node has a
+            // char property.
+            entry->accessor = MKNodeSerializerAccessorBoolean;
+            break;
+        case 's': case 'i': case 'l': case 'q':
+            entry->accessor = MKNodeSerializerAccessorSigned;
+            break;
+        case 'C': case 'S': case 'I': case 'L': case 'Q':
+            entry->accessor = MKNodeSerializerAccessorUnsigned;
+            break;
+        case 'B':
+            entry->accessor = MKNodeSerializerAccessorBoolean;
+            break;
+        case 'f': case 'd':
+            entry->accessor = MKNodeSerializerAccessorDouble;
+            break;
+        default:
+            // Structures and other types go through KVC.
+            return;
+    }
+    
+    entry->returnType = *type;
+    entry->getter = getter;
+    entry->imp = method_getImplementation(method);
+}
+
+//|++++++++++++++++++++++++++++++++++++|//
+- (NSArray<MKNodeField*> *)_fieldsOfNode:(MKNode*)node
+{
+    NSMutableArray<MKNodeField*> *fields = [NSMutableArray array];
+    
+    for (MKNodeField *field in node.layout.allFields) {
+        if ((field.options & MKNodeFieldOptionHidden) && (_options & MKNodeSerializationOptionHiddenFields) == 0)
+            continue;
+        [fields addObject:field];
+    }
+    
+    return fields;
+}
+
+//|++++++++++++++++++++++++++++++++++++|//
+- (_MKNodeSerializerPlan*)_compilePlanForClass:(Class)cls fields:(NSArray<MKNodeField*> *)fields
+{
+    _MKNodeSerializerPlan *plan = [_MKNodeSerializerPlan new];
+    plan->_fields = fields;
+    plan->_count = fields.count;
+    plan->_entries = calloc(MAX(fields.count, (NSUInteger)1), sizeof(MKNodeSerializerFieldPlan));
+    plan->_keys = [NSMutableData data];
+    if (plan->_entries == NULL)
+        return nil;
+    
+    for (NSUInteger i = 0; i < fields.count; i++) {
+        MKNodeSerializerFieldPlan *entry = &plan->_entries[i];
+        entry->field = fields[i];
+        entry->formatter = fields[i].valueFormatter;
+        entry->options = fields[i].options;
+        
+        NSUInteger keyStart = plan->_keys.length;
+        MKNodeSerializerEncodeKey(_format, plan->_keys, fields[i].name);
+        entry->key = NSMakeRange(keyStart, plan->_keys.length - keyStart);
+        
+        [self _compileAccessorForEntry:entry ofClass:cls];
+    }
+    
+    // The class name is the first entry of every node.
+    NSUInteger classStart = plan->_keys.length;
+    MKNodeSerializerEncodeKey(_format, plan->_keys, @"$class");
+    if (_format == MKNodeSerializationFormatCBOR) {
+        NSData *name = [NSStringFromClass(cls) dataUsingEncoding:NSUTF8StringEncoding];
+        MKNodeSerializerCBORHead(^(const void *bytes, size_t length) { [plan->_keys appendBytes:bytes length:length]; }, 3, name.length);
+        [plan->_keys appendData:name];
+    } else {
+        // Class names do not need escaping.
+        [plan->_keys appendData:[[NSString stringWithFormat:@"\"%@\"", NSStringFromClass(cls)] dataUsingEncoding:NSUTF8StringEncoding]];
+    }
+    plan->_classKeyAndValue = NSMakeRange(classStart, plan->_keys.length - classStart);
+    
+    return plan;
+}
+
+//|++++++++++++++++++++++++++++++++++++|//
+- (_MKNodeSerializerPlan*)_planForNode:(MKNode*)node
+{
+    Class cls = node.class;
+    _MKNodeSerializerPlan *plan;
+    
+    if ([cls hasInvariantLayout]) {
+        plan = [_plans objectForKey:cls];
+        if (plan == nil) {
+            plan = [self _compilePlanForClass:cls fields:[self _fieldsOfNode:node]];
+            if (plan) [_plans setObject:plan forKey:cls];
+        }
+        
+        return plan;
+    }
+    
+    // Nodes of the same class whose layouts have the same fields share a
+    // plan.
+    NSArray<MKNodeField*> *fields = [self _fieldsOfNode:node];
+    NSMutableArray *key = [NSMutableArray arrayWithCapacity:1 + 2 * fields.count];
+    [key addObject:cls];
+    for (MKNodeField *field in fields) {
+        [key addObject:field.name];
+        [key addObject:field.valueFormatter ?: NSNull.null];
+    }
+    
+    plan = _layoutPlans[key];
+    if (plan == nil) {
+        plan = [self _compilePlanForClass:cls fields:fields];
+        if (plan) _layoutPlans[key] = plan;
+    }
+    
+    return plan;
+}
+
+//◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦//
+#pragma mark -  Writing Nodes
+//◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦//
+
+//|++++++++++++++++++++++++++++++++++++|//
+- (void)_writeReferenceToNode:(MKNode*)node
+{
+    NSString *reference;
+    if ([node isKindOfClass:MKAddressedNode.class])
+        reference = [NSString stringWithFormat:@"%@ 0x%" MK_VM_PRIxADDR, node.class, [(MKAddressedNode*)node nodeContextAddress]];
+    else
+        reference = [NSString stringWithFormat:@"%@ %p", node.class, node];
+    
+    [self _beginContainer:YES];
+    [self _writeKey:@"$ref"];
+    [self _writeString:reference];
+    [self _endContainer:YES];
+}
+
+//|++++++++++++++++++++++++++++++++++++|//
+- (void)_writeValue:(id)value entry:(const MKNodeSerializerFieldPlan*)entry
+{
+    if ([value isKindOfClass:MKResult.class])
+        value = [(MKResult*)value value];
+    
+    if (value == nil || value == NSNull.null) {
+        [self _writeNull];
+        return;
+    }
+    
+    BOOL isLeaf = entry && (entry->options & MKNodeFieldOptionIgnoreContainerContents);
+    
+    if ([value isKindOfClass:MKNode.class]) {
+        if (!isLeaf) {
+            [self _writeNode:value];
+            return;
+        }
+    }
+    else if ([value isKindOfClass:NSString.class]) {
+        if (entry == NULL || entry->formatter == nil || (_options & MKNodeSerializationOptionFormattedValues) == 0) {
+            [self _writeString:value];
+            return;
+        }
+    }
+    else if ([value isKindOfClass:NSDictionary.class]) {
+        const MKNodeSerializerFieldPlan *childEntry = isLeaf ? entry : NULL;
+        [self _beginContainer:YES];
+        [(NSDictionary*)value enumerateKeysAndObjectsUsingBlock:^(id key, id obj, BOOL __unused *stop) {
+            @autoreleasepool {
+                [self _writeKey:[key description]];
+                [self _writeValue:obj entry:childEntry];
+            }
+        }];
+        [self _endContainer:YES];
+        return;
+    }
+    else if ([value conformsToProtocol:@protocol(NSFastEnumeration)]) {
+        const MKNodeSerializerFieldPlan *childEntry = isLeaf ? entry : NULL;
+        [self _beginContainer:NO];
+        for (id item in value)
+        @autoreleasepool {
+            [self _writeValue:item entry:childEntry];
+        }
+        [self _endContainer:NO];
+        return;
+    }
+    
+    if (entry && entry->formatter && ((_options & MKNodeSerializationOptionFormattedValues) || isLeaf)) {
+        [self _writeString:[entry->formatter stringForObjectValue:value] ?: @""];
+        return;
+    }
+    
+    if ([value isKindOfClass:NSNumber.class])
+        [self _writeNumber:value];
+    else if ([value isKindOfClass:NSData.class])
+        [self _writeData:value];
+    else if ([value isKindOfClass:NSUUID.class])
+        [self _writeString:[(NSUUID*)value UUIDString]];
+    else
+        [self _writeString:[value description]];
+}
+
+//|++++++++++++++++++++++++++++++++++++|//
+- (void)_writeField:(const MKNodeSerializerFieldPlan*)entry ofNode:(MKNode*)node
+{
+    id target = node;
+    SEL getter = entry->getter;
+    
+#define CALL_GETTER(TYPE) ((TYPE (*)(id, SEL))entry->imp)(target, getter)
+    switch (entry->accessor) {
+        case MKNodeSerializerAccessorObject:
+            [self _writeValue:CALL_GETTER(id) entry:entry];
+            break;
+        case MKNodeSerializerAccessorSigned:
+            switch (entry->returnType) {
+                case 'c': [self _writeSigned:CALL_GETTER(signed char)]; break;
+                case 's': [self _writeSigned:CALL_GETTER(short)]; break;
+                case 'i': [self _writeSigned:CALL_GETTER(int)]; break;
+                case 'l': [self _writeSigned:CALL_GETTER(long)]; break;
+                default:  [self _writeSigned:CALL_GETTER(long long)]; break;
+            }
+            break;
+        case MKNodeSerializerAccessorUnsigned:
+            switch (entry->returnType) {
+                case 'C': [self _writeUnsigned:CALL_GETTER(unsigned char)]; break;
+                case 'S': [self _writeUnsigned:CALL_GETTER(unsigned short)]; break;
+                case 'I': [self _writeUnsigned:CALL_GETTER(unsigned int)]; break;
+                case 'L': [self _writeUnsigned:CALL_GETTER(unsigned long)]; break;
+                default:  [self _writeUnsigned:CALL_GETTER(unsigned long long)]; break;
+            }
+            break;
+        case MKNodeSerializerAccessorBoolean:
+            if (entry->returnType == 'c')
+                [self _writeBoolean:CALL_GETTER(signed char) != 0];
+            else
+                [self _writeBoolean:CALL_GETTER(bool)];
+            break;
+        case MKNodeSerializerAccessorDouble:
+            if (entry->returnType == 'f')
+                [self _writeDouble:CALL_GETTER(float)];
+            else
+                [self _writeDouble:CALL_GETTER(double)];
+            break;
+        default:
+            [self _writeValue:[entry->field.valueRecipe valueForField:entry->field ofNode:node] entry:entry];
+            break;
+    }
+#undef CALL_GETTER
+}
+
+//|++++++++++++++++++++++++++++++++++++|//
+- (void)_writeNode:(MKNode*)node
+{
+    if (_depth >= _maximumDepth || [_path containsObject:node]) {
+        [self _writeReferenceToNode:node];
+        return;
+    }
+    
+    _MKNodeSerializerPlan *plan = [self _planForNode:node];
+    if (plan == nil) {
+        [self _writeReferenceToNode:node];
+        return;
+    }
+    
+    [_path addObject:node];
+    _depth++;
+    
+    [self _beginContainer:YES];
+    [self _writeEncodedKey:(const uint8_t*)plan->_keys.bytes + plan->_classKeyAndValue.location length:plan->_classKeyAndValue.length];
+    _needsSeparator = YES;
+    
+    if ([node isKindOfClass:MKAddressedNode.class]) {
+        [self _writeKey:@"$address"];
+        [self _writeUnsigned:[(MKAddressedNode*)node nodeContextAddress]];
+    }
+    if ([node isKindOfClass:MKBackedNode.class]) {
+        [self _writeKey:@"$size"];
+        [self _writeUnsigned:[(MKBackedNode*)node nodeSize]];
+    }
+    
+    const uint8_t *keys = plan->_keys.bytes;
+    for (NSUInteger i = 0; i < plan->_count; i++)
+    @autoreleasepool {
+        const MKNodeSerializerFieldPlan *entry = &plan->_entries[i];
+        [self _writeEncodedKey:keys + entry->key.location length:entry->key.length];
+        [self _writeField:entry ofNode:node];
+    }
+    
+    if ((_options & MKNodeSerializationOptionWarnings) && node.warnings.count) {
+        [self _writeKey:@"$warnings"];
+        [self _beginContainer:NO];
+        for (NSError *warning in node.warnings)
+        @autoreleasepool {
+            NSMutableString *message = [NSMutableString stringWithFormat:@"%@: %@", warning.mk_property, warning.localizedDescription];
+            for (NSError *w = warning.userInfo[NSUnderlyingErrorKey]; w != nil; w = w.userInfo[NSUnderlyingErrorKey])
+                [message appendFormat:@" -> %@", w.localizedDescription];
+            [self _writeString:message];
+        }
+        [self _endContainer:NO];
+    }
+    
+    [self _endContainer:YES];
+    
+    _depth--;
+    [_path removeObject:node];
+}
+
+//|++++++++++++++++++++++++++++++++++++|//
+- (BOOL)serializeNode:(MKNode*)node error:(NSError**)error
+{
+    NSParameterAssert(node != nil);
+    
+    @autoreleasepool {
+        _needsSeparator = NO;
+        [self _writeNode:node];
+        
+        if (_format == MKNodeSerializationFormatJSON)
+            MKNodeSerializerWriteByte(self, '\n');
+    }
+    
+    return [self flushWithError:error];
+}
+
+@end
+
+
+
+//----------------------------------------------------------------------------//
+@implementation MKNode (MKNodeSerializer)
+
+//|++++++++++++++++++++++++++++++++++++|//
++ (BOOL)hasInvariantLayout
+{ return NO; }
+
+@end
@@ -64,4 +64,13 @@ MKPtrTargetClass(struct MKPtr *ptr);
 _mk_internal_extern MKResult<__kindof MKBackedNode*> *
 MKPtrPointee(struct MKPtr *ptr);
 
+//! Per-image cache of resolved pointees, shared by every \c MKPtr whose
+//! pointee is looked up from the image.  The cache holds at most 65536
+//! pointees; it is emptied when it fills.
+struct MKPtrPointeeCache;
+
+//! Releases the cached pointees and frees \a cache.
+_mk_internal_extern void
+MKPtrPointeeCacheFree(struct MKPtrPointeeCache * __nullable cache);
+
 NS_ASSUME_NONNULL_END
@@ -62,6 +62,175 @@ NSString * const MKInitializationContextDeferredProvider = @"MKInitializationCon
 
 NSString * const MKInitializationContextErrorKey = @"MKInitializationContextErrorKey";
 
+//----------------------------------------------------------------------------//
+#pragma mark -  Resolution Budget
+//----------------------------------------------------------------------------//
+
+// Initializing a pointee may resolve pointers of its own.  Nested resolutions
+// on a thread are charged to the meter of the outermost resolution, which
+// bounds the work done for a chain of self-referential pointers.
+static __thread mk_budget_meter_t MKPtrResolutionMeter;
+static __thread unsigned MKPtrResolutionDepth;
+
+//----------------------------------------------------------------------------//
+#pragma mark -  Pointee Cache
+//----------------------------------------------------------------------------//
+
+struct MKPtrPointeeCacheEntry {
+    mk_vm_address_t address;
+    Class targetClass;
+    // Retained.  NULL marks an empty slot.
+    MKResult *pointee;
+};
+
+struct MKPtrPointeeCache {
+    struct MKPtrPointeeCacheEntry *slots;
+    size_t slotCount;
+    size_t count;
+};
+
+// The most pointees cached per image.  Each entry retains its pointee, so the
+// cache is flushed when it fills rather than growing with the image.
+#define MKPtrPointeeCacheMaximumCount   (1U << 16)
+
+//|++++++++++++++++++++++++++++++++++++|//
+static inline size_t
+MKPtrPointeeCacheSlot(mk_vm_address_t address, Class targetClass, size_t slotCount)
+{
+    uint64_t hash = (uint64_t)address ^ ((uint64_t)(uintptr_t)targetClass >> 3);
+    hash *= 0x9E3779B97F4A7C15ULL;
+    return (size_t)(hash >> 32) & (slotCount - 1);
+}
+
+//|++++++++++++++++++++++++++++++++++++|//
+static struct MKPtrPointeeCacheEntry*
+MKPtrPointeeCacheFind(struct MKPtrPointeeCache *cache, mk_vm_address_t address, Class targetClass)
+{
+    size_t slot = MKPtrPointeeCacheSlot(address, targetClass, cache->slotCount);
+    while (cache->slots[slot].pointee) {
+        if (cache->slots[slot].address == address && cache->slots[slot].targetClass == targetClass)
+            break;
+        slot = (slot + 1) & (cache->slotCount - 1);
+    }
+    return &cache->slots[slot];
+}
+
+//|++++++++++++++++++++++++++++++++++++|//
+static bool
+MKPtrPointeeCacheRehash(struct MKPtrPointeeCache *cache, size_t slotCount)
+{
+    struct MKPtrPointeeCacheEntry *oldSlots = cache->slots;
+    size_t oldSlotCount = cache->slotCount;
+    
+    struct MKPtrPointeeCacheEntry *slots = calloc(slotCount, sizeof(*slots));
+    if (slots == NULL)
+        return false;
+    
+    cache->slots = slots;
+    cache->slotCount = slotCount;
+    
+    for (size_t i = 0; i < oldSlotCount; i++) {
+        if (oldSlots[i].pointee)
+            *MKPtrPointeeCacheFind(cache, oldSlots[i].address, oldSlots[i].targetClass) = oldSlots[i];
+    }
+    
+    free(oldSlots);
+    return true;
+}
+
+//|++++++++++++++++++++++++++++++++++++|//
+static void
+MKPtrPointeeCacheFlush(struct MKPtrPointeeCache *cache)
+{
+    for (size_t i = 0; i < cache->slotCount; i++)
+        [cache->slots[i].pointee release];
+    
+    memset(cache->slots, 0, cache->slotCount * sizeof(*cache->slots));
+    cache->count = 0;
+}
+
+//|++++++++++++++++++++++++++++++++++++|//
+void
+MKPtrPointeeCacheFree(struct MKPtrPointeeCache *cache)
+{
+    if (cache == NULL)
+        return;
+    
+    MKPtrPointeeCacheFlush(cache);
+    free(cache->slots);
+    free(cache);
+}
+
+//|++++++++++++++++++++++++++++++++++++|//
+//! Returns a retained reference to the pointee cached for (\a address,
+//! \a targetClass) in \a image, or \c nil.
+static MKResult*
+MKPtrPointeeCacheCopy(MKMachOImage *image, mk_vm_address_t address, Class targetClass)
+{
+    @synchronized(image) {
+        struct MKPtrPointeeCache *cache = image->_pointeeCache;
+        if (cache == NULL)
+            return nil;
+        
+        return [MKPtrPointeeCacheFind(cache, address, targetClass)->pointee retain];
+    }
+}
+
+//|++++++++++++++++++++++++++++++++++++|//
+//! Caches \a pointee, consuming the caller's reference, and returns a retained
+//! reference to the cached pointee.  If another thread resolved the same
+//! pointee first, its result is returned instead.
+static MKResult*
+MKPtrPointeeCacheInsert(MKMachOImage *image, mk_vm_address_t address, Class targetClass, MKResult *pointee)
+{
+    @synchronized(image) {
+        struct MKPtrPointeeCache *cache = image->_pointeeCache;
+        if (cache == NULL) {
+            cache = calloc(1, sizeof(*cache));
+            if (cache == NULL || !MKPtrPointeeCacheRehash(cache, 256)) {
+                free(cache);
+                return pointee;
+            }
+            image->_pointeeCache = cache;
+        }
+        
+        struct MKPtrPointeeCacheEntry *entry = MKPtrPointeeCacheFind(cache, address, targetClass);
+        if (entry->pointee) {
+            [pointee release];
+            return [entry->pointee retain];
+        }
+        
+        if (cache->count >= MKPtrPointeeCacheMaximumCount) {
+            MKPtrPointeeCacheFlush(cache);
+            entry = MKPtrPointeeCacheFind(cache, address, targetClass);
+        }
+        
+        // Keep the load factor under 1/2.
+        if ((cache->count + 1) * 2 > cache->slotCount) {
+            if (!MKPtrPointeeCacheRehash(cache, cache->slotCount * 2))
+                return pointee;
+            entry = MKPtrPointeeCacheFind(cache, address, targetClass);
+        }
+        
+        *entry = (struct MKPtrPointeeCacheEntry){ address, targetClass, [pointee retain] };
+        cache->count++;
+        return pointee;
+    }
+}
+
+//|++++++++++++++++++++++++++++++++++++|//
+//! The pointee only depends on the address and target class if no other
+//! information is passed to its initializer.
+static bool
+MKPtrContextIsCacheable(NSDictionary *context)
+{
+    for (NSString *key in context) {
+        if (![key isEqualToString:MKInitializationContextTargetClass])
+            return false;
+    }
+    return true;
+}
+
 //|++++++++++++++++++++++++++++++++++++|//
 bool
 MKPtrInitialize(struct MKPtr *ptr, MKBackedNode *node, mk_vm_address_t addr, NSDictionary *ctx, __unused NSError **error)
@@ -151,9 +320,9 @@ MKPtrPointee(struct MKPtr *ptr)
 				NSError *underlyingError = deferredContext.error;
 				
 				NSString *keys[3]; id values[3]; NSUInteger count = 0;
-				if (description) keys[count] = NSLocalizedDescriptionKey; values[count] = description; count++;
-				if (underlyingError) keys[count] = NSUnderlyingErrorKey; values[count] = underlyingError; count++;
-				if (context) keys[count] = MKInitializationContextErrorKey; values[count] = context; count++;
+				if (description) { keys[count] = NSLocalizedDescriptionKey; values[count] = description; count++; }
+				if (underlyingError) { keys[count] = NSUnderlyingErrorKey; values[count] = underlyingError; count++; }
+				if (context) { keys[count] = MKInitializationContextErrorKey; values[count] = context; count++; }
 				NSDictionary *userInfo = [[NSDictionary alloc] initWithObjects:values forKeys:keys count:count];
 				
 				NSError *error = [[NSError alloc] initWithDomain:MKErrorDomain code:MK_EINTERNAL_ERROR userInfo:userInfo];
@@ -178,9 +347,9 @@ MKPtrPointee(struct MKPtr *ptr)
 			NSError *underlyingError = boundingNode.error;
 			
 			NSString *keys[3]; id values[3]; NSUInteger count = 0;
-			if (description) keys[count] = NSLocalizedDescriptionKey; values[count] = description; count++;
-			if (underlyingError) keys[count] = NSUnderlyingErrorKey; values[count] = underlyingError; count++;
-			if (context) keys[count] = MKInitializationContextErrorKey; values[count] = context; count++;
+			if (description) { keys[count] = NSLocalizedDescriptionKey; values[count] = description; count++; }
+			if (underlyingError) { keys[count] = NSUnderlyingErrorKey; values[count] = underlyingError; count++; }
+			if (context) { keys[count] = MKInitializationContextErrorKey; values[count] = context; count++; }
 			NSDictionary *userInfo = [[NSDictionary alloc] initWithObjects:values forKeys:keys count:count];
 			
 			NSError *error = [[NSError alloc] initWithDomain:MKErrorDomain code:MK_ENOT_FOUND userInfo:userInfo];
@@ -194,6 +363,43 @@ MKPtrPointee(struct MKPtr *ptr)
 			goto done;
 		}
         
+        Class targetClass = context[MKInitializationContextTargetClass];
+        NSCAssert(targetClass == nil || [targetClass isSubclassOfClass:MKNode.class], @"The target class of a pointer must be an MKNode, not %@.", NSStringFromClass(targetClass));
+        
+        // Pointers resolved from the image root are memoized per image, keyed
+        // by address and target class.  Missing pointees and errors are cached
+        // as well.
+        MKMachOImage *cacheImage = nil;
+        if ([boundingNode.value isKindOfClass:MKMachOImage.class] && MKPtrContextIsCacheable(context)) {
+            cacheImage = (MKMachOImage*)boundingNode.value;
+            pointee = MKPtrPointeeCacheCopy(cacheImage, ptr->address, targetClass);
+            if (pointee)
+                goto done;
+        }
+        
+        if (MKPtrResolutionDepth == 0)
+            MKBudgetMeterInit(&MKPtrResolutionMeter, boundingNode.value);
+        
+        if (mk_budget_meter_charge(&MKPtrResolutionMeter, 0, 1, 0)) {
+            NSString *description = [[NSString alloc] initWithFormat:@"Exceeded the work budget while resolving the pointee at address [%" MK_VM_PRIxADDR "].", ptr->address];
+            
+            NSString *keys[2]; id values[2]; NSUInteger count = 0;
+            keys[count] = NSLocalizedDescriptionKey; values[count] = description; count++;
+            if (context) { keys[count] = MKInitializationContextErrorKey; values[count] = context; count++; }
+            NSDictionary *userInfo = [[NSDictionary alloc] initWithObjects:values forKeys:keys count:count];
+            
+            NSError *error = [[NSError alloc] initWithDomain:MKErrorDomain code:MK_EBUDGET_EXCEEDED userInfo:userInfo];
+            
+            // Not cached.  A later resolution starts with a fresh budget.
+            pointee = [[MKResult resultWithError:error] retain];
+            
+            [error release];
+            [userInfo release];
+            [description release];
+            
+            goto done;
+        }
+        
         NSMutableDictionary *previousContext = [[NSMutableDictionary alloc] init];
         [context enumerateKeysAndObjectsUsingBlock:^(NSString *key, id obj, __unused BOOL *stop) {
             NSMutableDictionary *threadDict = NSThread.currentThread.threadDictionary;
@@ -201,15 +407,18 @@ MKPtrPointee(struct MKPtr *ptr)
             threadDict[key] = obj;
         }];
         
-        Class targetClass = context[MKInitializationContextTargetClass];
-        NSCAssert(targetClass == nil || [targetClass isSubclassOfClass:MKNode.class], @"The target class of a pointer must be an MKNode, not %@.", NSStringFromClass(targetClass));
+        MKPtrResolutionDepth++;
         pointee = [[boundingNode.value childNodeAtVMAddress:ptr->address targetClass:targetClass] retain];
+        MKPtrResolutionDepth--;
         
         [context enumerateKeysAndObjectsUsingBlock:^(NSString *key, __unused id obj, __unused BOOL *stop) {
             NSMutableDictionary *threadDict = NSThread.currentThread.threadDictionary;
             threadDict[key] = previousContext[key];
         }];
         [previousContext release];
+        
+        if (cacheImage && pointee)
+            pointee = MKPtrPointeeCacheInsert(cacheImage, ptr->address, targetClass, pointee);
 		
     done:
 		if (pointee == nil || pointee.none) {
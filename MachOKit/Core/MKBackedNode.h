@@ -60,6 +60,10 @@ NS_ASSUME_NONNULL_BEGIN
 //! the node.
 @property (nonatomic, strong, readonly, nullable) NSData *data;
 
+//! Advises the memory map of the receiver that the memory represented by
+//! the receiver is about to be read as described by \a advice.
+- (void)adviseAccess:(MKMemoryAccessAdvice)advice;
+
 //◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦//
 #pragma mark -  Looking Up Ancestor Nodes By Address
 //! @name       Looking Up Ancestor Nodes By Address
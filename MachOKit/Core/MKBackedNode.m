@@ -50,6 +50,14 @@
 - (mk_vm_size_t)nodeSize
 { @throw [NSException exceptionWithName:NSInvalidArgumentException reason:@"Subclasses must implement -nodeSize." userInfo:nil]; }
 
+//|++++++++++++++++++++++++++++++++++++|//
+- (NSUInteger)estimatedMemoryCost
+{
+    // Parsed nodes are generally at least as large as the data they parse.
+    mk_vm_size_t nodeSize = self.nodeSize;
+    return MAX(super.estimatedMemoryCost, (NSUInteger)MIN(nodeSize, (mk_vm_size_t)NSUIntegerMax));
+}
+
 //◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦//
 #pragma mark -  Accessing the Underlying Data
 //◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦//
@@ -58,6 +66,10 @@
 - (NSData*)data
 { return [self.memoryMap dataAtOffset:0 fromAddress:self.nodeContextAddress length:self.nodeSize requireFull:YES error:NULL]; }
 
+//|++++++++++++++++++++++++++++++++++++|//
+- (void)adviseAccess:(MKMemoryAccessAdvice)advice
+{ [self.memoryMap adviseAccess:advice atOffset:0 fromAddress:self.nodeContextAddress length:self.nodeSize]; }
+
 //◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦//
 #pragma mark -  Looking Up Ancestor Nodes By Address
 //◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦//
@@ -105,6 +105,17 @@ NS_ASSUME_NONNULL_BEGIN
 //! is represented by an instance of \c NSError.
 @property (nonatomic, strong) NSArray<NSError*> *warnings;
 
+//◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦//
+#pragma mark -  Estimating Memory Usage
+//! @name       Estimating Memory Usage
+//◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦//
+
+//! An estimate of the bytes retained by this node and its children, used as
+//! the cost of the node in an \ref MKNodeCache.  The default is the instance
+//! size of the node.  Subclasses that own out-of-line storage should override
+//! the getter for this property.
+@property (nonatomic, assign, readonly) NSUInteger estimatedMemoryCost;
+
 //◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦//
 #pragma mark -  Navigating the Node Tree
 //! @name       Navigating the Node Tree
@@ -0,0 +1,105 @@
+//----------------------------------------------------------------------------//
+//|
+//|             MachOKit - A Lightweight Mach-O Parsing Library
+//! @file       MKNodeCache.h
+//!
+//! @author     D.V.
+//! @copyright  Copyright (c) 2014-2015 D.V. All rights reserved.
+//|
+//| Permission is hereby granted, free of charge, to any person obtaining a
+//| copy of this software and associated documentation files (the "Software"),
+//| to deal in the Software without restriction, including without limitation
+//| the rights to use, copy, modify, merge, publish, distribute, sublicense,
+//| and/or sell copies of the Software, and to permit persons to whom the
+//| Software is furnished to do so, subject to the following conditions:
+//|
+//| The above copyright notice and this permission notice shall be included
+//| in all copies or substantial portions of the Software.
+//|
+//| THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+//| OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+//| MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+//| IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+//| CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+//| TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+//| SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+//----------------------------------------------------------------------------//
+
+#import <Foundation/Foundation.h>
+
+NS_ASSUME_NONNULL_BEGIN
+
+//----------------------------------------------------------------------------//
+//! An instance of \c MKNodeCache holds lazily parsed subtrees, such as the
+//! symbol table or the bindings of an image, within a memory budget.
+//!
+//! Each entry is keyed by its owning node and a name, and carries a cost
+//! estimating the bytes it retains.  When the total cost of the cache exceeds
+//! its budget, the least recently used entries are evicted.  Owners re-parse
+//! an evicted subtree the next time it is requested.
+//!
+//! A cache may be shared by many images to enforce a process-wide budget.
+//! All methods are safe to call from multiple threads.
+//
+@interface MKNodeCache : NSObject
+
+//! Returns a cache shared by the process, with no budget.
++ (instancetype)sharedCache;
+
+- (instancetype)initWithMemoryBudget:(NSUInteger)memoryBudget NS_DESIGNATED_INITIALIZER;
+
+//◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦//
+#pragma mark -  Budget
+//! @name       Budget
+//◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦//
+
+//! The maximum total cost of the entries in the cache, in bytes.  A value of
+//! \c 0 means the cache is unbounded.  Lowering the budget evicts entries
+//! immediately.
+@property (nonatomic, assign) NSUInteger memoryBudget;
+
+//! The sum of the costs of the entries currently in the cache.
+@property (nonatomic, assign, readonly) NSUInteger totalCost;
+
+//! The number of entries currently in the cache.
+@property (nonatomic, assign, readonly) NSUInteger count;
+
+//◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦//
+#pragma mark -  Statistics
+//! @name       Statistics
+//◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦//
+
+//! The number of entries evicted to stay within the budget.
+@property (nonatomic, assign, readonly) NSUInteger evictionCount;
+
+//! The number of entries that were stored again after having been evicted.
+//! Each re-parse is work that a larger budget would have avoided.
+@property (nonatomic, assign, readonly) NSUInteger reparseCount;
+
+//! Resets \ref evictionCount and \ref reparseCount to zero.
+- (void)resetStatistics;
+
+//◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦//
+#pragma mark -  Accessing Entries
+//! @name       Accessing Entries
+//◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦//
+
+//! Returns the entry stored by \a owner under \a key, or \c nil if there is
+//! no such entry or it has been evicted.
+- (nullable id)objectForOwner:(id)owner key:(NSString*)key;
+
+//! Stores \a object under \a key for \a owner.  The cache does not retain
+//! \a owner; owners must call \ref -removeObjectsForOwner: before they are
+//! deallocated.
+- (void)setObject:(id)object cost:(NSUInteger)cost owner:(id)owner key:(NSString*)key;
+
+//! Removes every entry stored by \a owner.
+- (void)removeObjectsForOwner:(id)owner;
+
+//! Removes every entry from the cache.  Removed entries are not counted as
+//! evictions.
+- (void)removeAllObjects;
+
+@end
+
+NS_ASSUME_NONNULL_END
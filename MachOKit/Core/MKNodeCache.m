@@ -0,0 +1,338 @@
+//----------------------------------------------------------------------------//
+//|
+//|             MachOKit - A Lightweight Mach-O Parsing Library
+//|             MKNodeCache.m
+//|
+//|             D.V.
+//|             Copyright (c) 2014-2015 D.V. All rights reserved.
+//|
+//| Permission is hereby granted, free of charge, to any person obtaining a
+//| copy of this software and associated documentation files (the "Software"),
+//| to deal in the Software without restriction, including without limitation
+//| the rights to use, copy, modify, merge, publish, distribute, sublicense,
+//| and/or sell copies of the Software, and to permit persons to whom the
+//| Software is furnished to do so, subject to the following conditions:
+//|
+//| The above copyright notice and this permission notice shall be included
+//| in all copies or substantial portions of the Software.
+//|
+//| THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+//| OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+//| MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+//| IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+//| CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+//| TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+//| SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+//----------------------------------------------------------------------------//
+
+
+#import "MKNodeCache.h"
+#import "MKInternal.h"
+
+//----------------------------------------------------------------------------//
+@interface _MKNodeCacheEntry : NSObject {
+@package
+    __unsafe_unretained id _owner;
+    NSString *_key;
+    id _object;
+    NSUInteger _cost;
+    // Recency list, most recently used first.  The entries are retained by
+    // their owner's record.
+    __unsafe_unretained _MKNodeCacheEntry *_previous;
+    __unsafe_unretained _MKNodeCacheEntry *_next;
+}
+@end
+
+@implementation _MKNodeCacheEntry
+@end
+
+//----------------------------------------------------------------------------//
+@interface _MKNodeCacheOwner : NSObject {
+@package
+    NSMutableDictionary<NSString*, _MKNodeCacheEntry*> *_entries;
+    // Keys whose entry was evicted and has not been stored again.
+    NSMutableSet<NSString*> *_evicted;
+}
+@end
+
+@implementation _MKNodeCacheOwner
+
+- (instancetype)init
+{
+    self = [super init];
+    if (self == nil) return nil;
+    
+    _entries = [[NSMutableDictionary alloc] init];
+    _evicted = [[NSMutableSet alloc] init];
+    
+    return self;
+}
+
+@end
+
+
+
+//----------------------------------------------------------------------------//
+@implementation MKNodeCache
+{
+    NSMapTable<id, _MKNodeCacheOwner*> *_owners;
+    _MKNodeCacheEntry *_head;
+    _MKNodeCacheEntry *_tail;
+    NSUInteger _count;
+    NSUInteger _totalCost;
+    NSUInteger _evictionCount;
+    NSUInteger _reparseCount;
+}
+
+//|++++++++++++++++++++++++++++++++++++|//
++ (instancetype)sharedCache
+{
+    static MKNodeCache *s_SharedCache = nil;
+    static dispatch_once_t onceToken;
+    dispatch_once(&onceToken, ^{
+        s_SharedCache = [[MKNodeCache alloc] initWithMemoryBudget:0];
+    });
+    return s_SharedCache;
+}
+
+//|++++++++++++++++++++++++++++++++++++|//
+- (instancetype)initWithMemoryBudget:(NSUInteger)memoryBudget
+{
+    self = [super init];
+    if (self == nil) return nil;
+    
+    _memoryBudget = memoryBudget;
+    // Owners are compared by pointer and never retained, so that an owner
+    // can remove its entries from -dealloc.
+    _owners = [[NSMapTable alloc] initWithKeyOptions:NSPointerFunctionsOpaqueMemory | NSPointerFunctionsOpaquePersonality valueOptions:NSPointerFunctionsStrongMemory capacity:0];
+    
+    return self;
+}
+
+//|++++++++++++++++++++++++++++++++++++|//
+- (instancetype)init
+{ return [self initWithMemoryBudget:0]; }
+
+//◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦//
+#pragma mark -  Recency List
+//◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦//
+
+//|++++++++++++++++++++++++++++++++++++|//
+- (void)_unlinkEntry:(_MKNodeCacheEntry*)entry
+{
+    if (entry->_previous)
+        entry->_previous->_next = entry->_next;
+    else
+        _head = entry->_next;
+    
+    if (entry->_next)
+        entry->_next->_previous = entry->_previous;
+    else
+        _tail = entry->_previous;
+    
+    entry->_previous = nil;
+    entry->_next = nil;
+}
+
+//|++++++++++++++++++++++++++++++++++++|//
+- (void)_linkEntryAtHead:(_MKNodeCacheEntry*)entry
+{
+    entry->_previous = nil;
+    entry->_next = _head;
+    if (_head)
+        _head->_previous = entry;
+    _head = entry;
+    if (_tail == nil)
+        _tail = entry;
+}
+
+//|++++++++++++++++++++++++++++++++++++|//
+- (void)_removeEntry:(_MKNodeCacheEntry*)entry fromOwner:(_MKNodeCacheOwner*)ownerRecord
+{
+    [self _unlinkEntry:entry];
+    _count--;
+    _totalCost -= entry->_cost;
+    // The record holds the only strong reference to the entry.
+    NSString *key = entry->_key;
+    [ownerRecord->_entries removeObjectForKey:key];
+}
+
+//|++++++++++++++++++++++++++++++++++++|//
+- (void)_evictEntriesSparing:(_MKNodeCacheEntry*)spared
+{
+    if (_memoryBudget == 0)
+        return;
+    
+    _MKNodeCacheEntry *candidate = _tail;
+    while (_totalCost > _memoryBudget && candidate)
+    {
+        _MKNodeCacheEntry *previous = candidate->_previous;
+        
+        // The entry being stored is never evicted, even if it alone exceeds
+        // the budget.  Its owner is about to return it.
+        if (candidate != spared)
+        {
+            _MKNodeCacheOwner *ownerRecord = [_owners objectForKey:candidate->_owner];
+            [ownerRecord->_evicted addObject:candidate->_key];
+            [self _removeEntry:candidate fromOwner:ownerRecord];
+            _evictionCount++;
+        }
+        
+        candidate = previous;
+    }
+}
+
+//◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦//
+#pragma mark -  Budget
+//◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦//
+
+//|++++++++++++++++++++++++++++++++++++|//
+- (NSUInteger)memoryBudget
+{
+    @synchronized(self) {
+        return _memoryBudget;
+    }
+}
+
+//|++++++++++++++++++++++++++++++++++++|//
+- (void)setMemoryBudget:(NSUInteger)memoryBudget
+{
+    @synchronized(self) {
+        _memoryBudget = memoryBudget;
+        [self _evictEntriesSparing:nil];
+    }
+}
+
+//|++++++++++++++++++++++++++++++++++++|//
+- (NSUInteger)totalCost
+{
+    @synchronized(self) {
+        return _totalCost;
+    }
+}
+
+//|++++++++++++++++++++++++++++++++++++|//
+- (NSUInteger)count
+{
+    @synchronized(self) {
+        return _count;
+    }
+}
+
+//◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦//
+#pragma mark -  Statistics
+//◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦//
+
+//|++++++++++++++++++++++++++++++++++++|//
+- (NSUInteger)evictionCount
+{
+    @synchronized(self) {
+        return _evictionCount;
+    }
+}
+
+//|++++++++++++++++++++++++++++++++++++|//
+- (NSUInteger)reparseCount
+{
+    @synchronized(self) {
+        return _reparseCount;
+    }
+}
+
+//|++++++++++++++++++++++++++++++++++++|//
+- (void)resetStatistics
+{
+    @synchronized(self) {
+        _evictionCount = 0;
+        _reparseCount = 0;
+    }
+}
+
+//◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦//
+#pragma mark -  Accessing Entries
+//◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦//
+
+//|++++++++++++++++++++++++++++++++++++|//
+- (id)objectForOwner:(id)owner key:(NSString*)key
+{
+    @synchronized(self) {
+        _MKNodeCacheOwner *ownerRecord = [_owners objectForKey:owner];
+        _MKNodeCacheEntry *entry = ownerRecord ? ownerRecord->_entries[key] : nil;
+        if (entry == nil)
+            return nil;
+        
+        if (entry != _head) {
+            [self _unlinkEntry:entry];
+            [self _linkEntryAtHead:entry];
+        }
+        
+        return entry->_object;
+    }
+}
+
+//|++++++++++++++++++++++++++++++++++++|//
+- (void)setObject:(id)object cost:(NSUInteger)cost owner:(id)owner key:(NSString*)key
+{
+    NSParameterAssert(object);
+    NSParameterAssert(owner);
+    NSParameterAssert(key);
+    
+    @synchronized(self) {
+        _MKNodeCacheOwner *ownerRecord = [_owners objectForKey:owner];
+        if (ownerRecord == nil) {
+            ownerRecord = [[_MKNodeCacheOwner alloc] init];
+            [_owners setObject:ownerRecord forKey:owner];
+        }
+        
+        _MKNodeCacheEntry *existing = ownerRecord->_entries[key];
+        if (existing)
+            [self _removeEntry:existing fromOwner:ownerRecord];
+        
+        if ([ownerRecord->_evicted containsObject:key]) {
+            [ownerRecord->_evicted removeObject:key];
+            _reparseCount++;
+        }
+        
+        _MKNodeCacheEntry *entry = [[_MKNodeCacheEntry alloc] init];
+        entry->_owner = owner;
+        entry->_key = [key copy];
+        entry->_object = object;
+        entry->_cost = cost;
+        
+        ownerRecord->_entries[entry->_key] = entry;
+        [self _linkEntryAtHead:entry];
+        _count++;
+        _totalCost += cost;
+        
+        [self _evictEntriesSparing:entry];
+    }
+}
+
+//|++++++++++++++++++++++++++++++++++++|//
+- (void)removeObjectsForOwner:(id)owner
+{
+    @synchronized(self) {
+        _MKNodeCacheOwner *ownerRecord = [_owners objectForKey:owner];
+        if (ownerRecord == nil)
+            return;
+        
+        for (_MKNodeCacheEntry *entry in ownerRecord->_entries.allValues)
+            [self _removeEntry:entry fromOwner:ownerRecord];
+        
+        [_owners removeObjectForKey:owner];
+    }
+}
+
+//|++++++++++++++++++++++++++++++++++++|//
+- (void)removeAllObjects
+{
+    @synchronized(self) {
+        _head = nil;
+        _tail = nil;
+        _count = 0;
+        _totalCost = 0;
+        [_owners removeAllObjects];
+    }
+}
+
+@end
@@ -0,0 +1,75 @@
+//----------------------------------------------------------------------------//
+//|
+//|             MachOKit - A Lightweight Mach-O Parsing Library
+//! @file       MKBlockSource.h
+//!
+//! @author     D.V.
+//! @copyright  Copyright (c) 2014-2015 D.V. All rights reserved.
+//|
+//| Permission is hereby granted, free of charge, to any person obtaining a
+//| copy of this software and associated documentation files (the "Software"),
+//| to deal in the Software without restriction, including without limitation
+//| the rights to use, copy, modify, merge, publish, distribute, sublicense,
+//| and/or sell copies of the Software, and to permit persons to whom the
+//| Software is furnished to do so, subject to the following conditions:
+//|
+//| The above copyright notice and this permission notice shall be included
+//| in all copies or substantial portions of the Software.
+//|
+//| THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+//| OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+//| MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+//| IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+//| CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+//| TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+//| SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+//----------------------------------------------------------------------------//
+
+#import <MachOKit/MKBase.h>
+
+NS_ASSUME_NONNULL_BEGIN
+
+//----------------------------------------------------------------------------//
+//! The \c MKBlockSource protocol is adopted by objects that supply the
+//! contents of a chunked memory map one fixed size block at a time.
+//!
+//! A block source lets a memory map be created for input that can not be
+//! mapped in full, such as an entry in a compressed archive or the output
+//! of a pipe.  The memory map decides which blocks to read and keeps a
+//! bounded number of them in memory.  Reads of a block source are always
+//! serialized by the memory map.
+//
+@protocol MKBlockSource <NSObject>
+
+//! The size of each block, in bytes.  Every block except the last one
+//! holds exactly this many bytes.  Must not change.
+@property (nonatomic, readonly) mk_vm_size_t blockSize;
+
+//! Reads the block at \a index into \a buffer, which has room for
+//! \ref blockSize bytes.
+//!
+//! @param  length
+//!         On return, the number of bytes read.  This is less than
+//!         \ref blockSize for the last block, and zero if \a index is past
+//!         the end of the contents.
+//! @return
+//!         \c NO if the block could not be read, in which case \a error
+//!         describes the failure.
+- (BOOL)readBlockAtIndex:(uint64_t)index into:(void*)buffer length:(mk_vm_size_t*)length error:(NSError**)error;
+
+@optional
+
+//! \c YES if the source can only read its blocks in order, starting from
+//! the first one.  The memory map then reads each block once, in order,
+//! and reads ahead past any blocks that are skipped.  The default is
+//! \c NO.
+@property (nonatomic, readonly, getter=isSequential) BOOL sequential;
+
+//! Returns a sequential source to its first block, so that a block that
+//! has been dropped from the memory map's cache can be read again.
+//! Sequential sources that do not implement this method fail such reads.
+- (BOOL)rewind:(NSError**)error;
+
+@end
+
+NS_ASSUME_NONNULL_END
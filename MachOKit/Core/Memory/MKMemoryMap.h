@@ -28,10 +28,37 @@
 #import <MachOKit/MKBase.h>
 #import <MachOKit/MKDataModel.h>
 
+@protocol MKBlockSource;
+
 NS_ASSUME_NONNULL_BEGIN
 
 //----------------------------------------------------------------------------//
-@interface MKMemoryMap : NSObject
+//! @name       Memory Access Advice
+//! @relates    MKMemoryMap
+//!
+//! Describes how a range of context memory is about to be read.
+//
+typedef NS_ENUM(NSUInteger, MKMemoryAccessAdvice) {
+    //! No particular pattern.  Cancels earlier advice for the range.
+    MKMemoryAccessAdviceNormal          = 0,
+    //! The range will be read once, from its start to its end.
+    MKMemoryAccessAdviceSequential,
+    //! The range will be read in no particular order.
+    MKMemoryAccessAdviceRandom,
+    //! The range will be read soon.  Reading it ahead is worthwhile.
+    MKMemoryAccessAdviceWillNeed,
+    //! The range will not be read again soon.
+    MKMemoryAccessAdviceDontNeed
+};
+
+
+
+//----------------------------------------------------------------------------//
+@interface MKMemoryMap : NSObject {
+@package
+    mk_context_statistics_t _statistics;
+    mk_context_budget_t _budget;
+}
 
 //◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦//
 #pragma mark -  Creating A Memory Mapping
@@ -47,6 +74,23 @@ NS_ASSUME_NONNULL_BEGIN
 //! task's memory.
 + (nullable instancetype)memoryMapWithTask:(mach_port_t)task error:(NSError**)error;
 
+//! Creates and returns an \ref MKMemoryMap whose contents are read from
+//! \a source one block at a time, for input that can not be mapped in full
+//! such as a compressed archive entry or a pipe.
+//!
+//! No more than \a maximumCachedBlocks blocks are kept in memory.  Reads
+//! that span blocks are copied into a buffer that is freed once the
+//! handler returns, and blocks that a handler is still using stay alive
+//! until it returns.  Such a read copies at most 64 MiB, or one block if
+//! blocks are larger.  A longer read fails if it requires the full range,
+//! and is truncated otherwise.  Blocks that follow consecutive reads are read ahead
+//! in the background; see \ref -adviseAccess:atOffset:fromAddress:length:
+//! to change how far.
+//!
+//! @param  maximumCachedBlocks
+//!         Must be at least two.
++ (nullable instancetype)memoryMapWithBlockSource:(id<MKBlockSource>)source maximumCachedBlocks:(NSUInteger)maximumCachedBlocks error:(NSError**)error;
+
 //◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦//
 #pragma mark -  About Context Memory
 //! @name       About Context Memory
@@ -100,6 +144,58 @@ NS_ASSUME_NONNULL_BEGIN
 
 - (uint64_t)readQuadWordAtOffset:(mk_vm_offset_t)offset fromAddress:(mk_vm_address_t)contextAddress withDataModel:(nullable MKDataModel*)dataModel error:(NSError**)error;
 
+//◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦//
+#pragma mark -  Advising Context Memory Access
+//! @name       Advising Context Memory Access
+//◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦//
+
+//! Advises the receiver that the \a length bytes at (\a contextAddress +
+//! \a offset) are about to be read as described by \a advice.
+//!
+//! Advice is only a hint.  It never changes the contents of the memory and
+//! is silently ignored for ranges, or parts of ranges, that are not in the
+//! receiver.  The default implementation does nothing.  Subclasses backed
+//! by a file pass the advice on to the kernel.  Memory maps created with a
+//! block source read ahead on \c MKMemoryAccessAdviceWillNeed, widen or
+//! disable their readahead for sequential or random access, and drop
+//! cached blocks on \c MKMemoryAccessAdviceDontNeed.
+- (void)adviseAccess:(MKMemoryAccessAdvice)advice atOffset:(mk_vm_offset_t)offset fromAddress:(mk_vm_address_t)contextAddress length:(mk_vm_size_t)length;
+
+//◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦//
+#pragma mark -  Statistics
+//! @name       Statistics
+//◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦//
+
+//! The statistics block of the receiver.  Remaps and copies performed by the
+//! receiver are counted here, and images created with the receiver install
+//! it in their \c mk_context_t so that work done by libMachO on their behalf
+//! is counted as well.
+@property (nonatomic, readonly) mk_context_statistics_t *statistics NS_RETURNS_INNER_POINTER;
+
+//! Returns a copy of the current value of each counter.
+- (mk_context_statistics_t)statisticsSnapshot;
+
+//! Resets each counter to zero.
+- (void)resetStatistics;
+
+//◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦//
+#pragma mark -  Work Budget
+//! @name       Work Budget
+//◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦//
+
+//! The work budget applied to each parse performed on behalf of images
+//! created with the receiver.  Like the statistics block, images install
+//! the budget in their \c mk_context_t.  A parse that exceeds the budget
+//! stops early and records a warning with the code \c MK_EBUDGET_EXCEEDED
+//! on the node that was being parsed.  The default budget is unlimited.
+//!
+//! Set the budget before creating images with the receiver, and do not
+//! change it while they are being parsed.
+@property (nonatomic, assign) mk_context_budget_t budget;
+
+//! The budget of the receiver, for installing in an \c mk_context_t.
+@property (nonatomic, readonly) mk_context_budget_t *budgetPointer NS_RETURNS_INNER_POINTER;
+
 @end
 
 NS_ASSUME_NONNULL_END
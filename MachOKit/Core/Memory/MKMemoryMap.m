@@ -30,6 +30,7 @@
 #import "_MKFileMemoryMap.h"
 #import "_MKMemoryMemoryMap.h"
 #import "_MKTaskMemoryMap.h"
+#import "_MKChunkedMemoryMap.h"
 
 //----------------------------------------------------------------------------//
 @implementation MKMemoryMap
@@ -45,6 +46,10 @@
 + (instancetype)memoryMapWithTask:(mach_port_t)task error:(NSError**)error
 { return [[_MKTaskMemoryMap alloc] initWithTask:task error:error]; }
 
+//|++++++++++++++++++++++++++++++++++++|//
++ (instancetype)memoryMapWithBlockSource:(id<MKBlockSource>)source maximumCachedBlocks:(NSUInteger)maximumCachedBlocks error:(NSError**)error
+{ return [[_MKChunkedMemoryMap alloc] initWithBlockSource:source maximumCachedBlocks:maximumCachedBlocks error:error]; }
+
 //|++++++++++++++++++++++++++++++++++++|//
 - (id)init
 {
@@ -147,6 +152,7 @@
             return;
         
         memcpy(buffer, (void*)address, (vm_size_t)MIN(length, (mk_vm_size_t)mappingLength));
+        __atomic_fetch_add(&self->_statistics.bytes_copied, MIN(length, (mk_vm_size_t)mappingLength), __ATOMIC_RELAXED);
         retValue = (vm_size_t)length;
     }];
     
@@ -217,4 +223,54 @@
         return retValue;
 }
 
+//◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦//
+#pragma mark -  Advising Context Memory Access
+//◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦//
+
+//|++++++++++++++++++++++++++++++++++++|//
+- (void)adviseAccess:(MKMemoryAccessAdvice)advice atOffset:(mk_vm_offset_t)offset fromAddress:(mk_vm_address_t)contextAddress length:(mk_vm_size_t)length
+{
+    // Advice is optional.  Subclasses that can act on it override this method.
+}
+
+//◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦//
+#pragma mark -  Statistics
+//◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦//
+
+//|++++++++++++++++++++++++++++++++++++|//
+- (mk_context_statistics_t*)statistics
+{ return &_statistics; }
+
+//|++++++++++++++++++++++++++++++++++++|//
+- (mk_context_statistics_t)statisticsSnapshot
+{
+    mk_context_t context = { .statistics = &_statistics };
+    mk_context_statistics_t snapshot;
+    mk_context_statistics_snapshot(&context, &snapshot);
+    return snapshot;
+}
+
+//|++++++++++++++++++++++++++++++++++++|//
+- (void)resetStatistics
+{
+    mk_context_t context = { .statistics = &_statistics };
+    mk_context_statistics_reset(&context);
+}
+
+//◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦//
+#pragma mark -  Work Budget
+//◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦//
+
+//|++++++++++++++++++++++++++++++++++++|//
+- (mk_context_budget_t)budget
+{ return _budget; }
+
+//|++++++++++++++++++++++++++++++++++++|//
+- (void)setBudget:(mk_context_budget_t)budget
+{ _budget = budget; }
+
+//|++++++++++++++++++++++++++++++++++++|//
+- (mk_context_budget_t*)budgetPointer
+{ return &_budget; }
+
 @end
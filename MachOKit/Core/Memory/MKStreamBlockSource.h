@@ -0,0 +1,58 @@
+//----------------------------------------------------------------------------//
+//|
+//|             MachOKit - A Lightweight Mach-O Parsing Library
+//! @file       MKStreamBlockSource.h
+//!
+//! @author     D.V.
+//! @copyright  Copyright (c) 2014-2015 D.V. All rights reserved.
+//|
+//| Permission is hereby granted, free of charge, to any person obtaining a
+//| copy of this software and associated documentation files (the "Software"),
+//| to deal in the Software without restriction, including without limitation
+//| the rights to use, copy, modify, merge, publish, distribute, sublicense,
+//| and/or sell copies of the Software, and to permit persons to whom the
+//| Software is furnished to do so, subject to the following conditions:
+//|
+//| The above copyright notice and this permission notice shall be included
+//| in all copies or substantial portions of the Software.
+//|
+//| THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+//| OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+//| MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+//| IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+//| CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+//| TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+//| SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+//----------------------------------------------------------------------------//
+
+#import <MachOKit/MKBlockSource.h>
+
+NS_ASSUME_NONNULL_BEGIN
+
+//----------------------------------------------------------------------------//
+//! An \c MKStreamBlockSource is a sequential block source that reads its
+//! blocks from an \c NSInputStream.
+//!
+//! The stream is obtained from a provider block, which is invoked again
+//! each time the source is rewound.  A provider that opens a pipe, or
+//! otherwise can not produce the contents a second time, should return
+//! \c nil when invoked again.  Decompression is left to the stream; wrap
+//! the input in a stream that inflates it before handing it to the source.
+//
+@interface MKStreamBlockSource : NSObject <MKBlockSource>
+
+//! Initializes the source with a \a streamProvider that returns an unopened
+//! stream positioned at the start of the contents.
+- (instancetype)initWithStreamProvider:(NSInputStream* _Nullable (^)(void))streamProvider blockSize:(mk_vm_size_t)blockSize NS_DESIGNATED_INITIALIZER;
+
+//! Initializes a source that reads \a stream once.  The source can not be
+//! rewound.
+- (instancetype)initWithStream:(NSInputStream*)stream blockSize:(mk_vm_size_t)blockSize;
+
+- (instancetype)init NS_UNAVAILABLE;
+
+@property (nonatomic, readonly) mk_vm_size_t blockSize;
+
+@end
+
+NS_ASSUME_NONNULL_END
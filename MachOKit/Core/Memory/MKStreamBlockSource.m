@@ -0,0 +1,147 @@
+//----------------------------------------------------------------------------//
+//|
+//|             MachOKit - A Lightweight Mach-O Parsing Library
+//|             MKStreamBlockSource.m
+//|
+//|             D.V.
+//|             Copyright (c) 2014-2015 D.V. All rights reserved.
+//|
+//| Permission is hereby granted, free of charge, to any person obtaining a
+//| copy of this software and associated documentation files (the "Software"),
+//| to deal in the Software without restriction, including without limitation
+//| the rights to use, copy, modify, merge, publish, distribute, sublicense,
+//| and/or sell copies of the Software, and to permit persons to whom the
+//| Software is furnished to do so, subject to the following conditions:
+//|
+//| The above copyright notice and this permission notice shall be included
+//| in all copies or substantial portions of the Software.
+//|
+//| THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+//| OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+//| MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+//| IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+//| CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+//| TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+//| SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+//----------------------------------------------------------------------------//
+
+#import "MKStreamBlockSource.h"
+#import "MKInternal.h"
+
+//----------------------------------------------------------------------------//
+@implementation MKStreamBlockSource
+{
+    NSInputStream* (^_streamProvider)(void);
+    NSInputStream *_stream;
+    uint64_t _nextIndex;
+    BOOL _exhausted;
+}
+
+@synthesize blockSize = _blockSize;
+
+//|++++++++++++++++++++++++++++++++++++|//
+- (instancetype)initWithStreamProvider:(NSInputStream* (^)(void))streamProvider blockSize:(mk_vm_size_t)blockSize
+{
+    NSParameterAssert(streamProvider);
+    NSParameterAssert(blockSize > 0 && blockSize <= NSUIntegerMax);
+    
+    self = [super init];
+    if (self == nil) return nil;
+    
+    _streamProvider = [streamProvider copy];
+    _blockSize = blockSize;
+    
+    return self;
+}
+
+//|++++++++++++++++++++++++++++++++++++|//
+- (instancetype)initWithStream:(NSInputStream*)stream blockSize:(mk_vm_size_t)blockSize
+{
+    NSParameterAssert(stream);
+    
+    __block NSInputStream *once = stream;
+    return [self initWithStreamProvider:^NSInputStream* {
+        NSInputStream *retValue = once;
+        once = nil;
+        return retValue;
+    } blockSize:blockSize];
+}
+
+//|++++++++++++++++++++++++++++++++++++|//
+- (instancetype)init
+{
+    @throw [NSException exceptionWithName:NSGenericException reason:@"-init unavailable." userInfo:nil];
+}
+
+//|++++++++++++++++++++++++++++++++++++|//
+- (void)dealloc
+{
+    [_stream close];
+}
+
+//◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦//
+#pragma mark -  MKBlockSource
+//◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦//
+
+//|++++++++++++++++++++++++++++++++++++|//
+- (BOOL)isSequential
+{ return YES; }
+
+//|++++++++++++++++++++++++++++++++++++|//
+- (BOOL)_openStream:(NSError**)error
+{
+    [_stream close];
+    _stream = _streamProvider();
+    _nextIndex = 0;
+    _exhausted = NO;
+    
+    if (_stream == nil) {
+        MK_ERROR_OUT = [NSError mk_errorWithDomain:MKErrorDomain code:MK_EUNAVAILABLE description:@"The stream provider of %@ did not return a stream.", self];
+        return NO;
+    }
+    
+    [_stream open];
+    return YES;
+}
+
+//|++++++++++++++++++++++++++++++++++++|//
+- (BOOL)rewind:(NSError**)error
+{ return [self _openStream:error]; }
+
+//|++++++++++++++++++++++++++++++++++++|//
+- (BOOL)readBlockAtIndex:(uint64_t)index into:(void*)buffer length:(mk_vm_size_t*)length error:(NSError**)error
+{
+    *length = 0;
+    
+    if (_stream == nil && [self _openStream:error] == NO)
+        return NO;
+    
+    if (index != _nextIndex) {
+        MK_ERROR_OUT = [NSError mk_errorWithDomain:MKErrorDomain code:MK_EINVAL description:@"Block %" PRIu64 " was requested but the next block of %@ is %" PRIu64 ".", index, self, _nextIndex];
+        return NO;
+    }
+    
+    NSUInteger filled = 0;
+    while (!_exhausted && filled < (NSUInteger)_blockSize)
+    {
+        NSInteger bytesRead = [_stream read:(uint8_t*)buffer + filled maxLength:(NSUInteger)_blockSize - filled];
+        if (bytesRead < 0) {
+            MK_ERROR_OUT = [NSError mk_errorWithDomain:MKErrorDomain code:MK_ECLIENT_ERROR underlyingError:_stream.streamError description:@"Failed to read block %" PRIu64 " from %@.", index, self];
+            return NO;
+        } else if (bytesRead == 0) {
+            _exhausted = YES;
+        } else {
+            filled += (NSUInteger)bytesRead;
+        }
+    }
+    
+    // The next read past the end returns zero bytes without touching the
+    // stream.
+    if (filled > 0)
+        _nextIndex++;
+    
+    *length = filled;
+    return YES;
+}
+
+@end
@@ -0,0 +1,478 @@
+//----------------------------------------------------------------------------//
+//|
+//|             MachOKit - A Lightweight Mach-O Parsing Library
+//|             _MKChunkedMemoryMap.m
+//|
+//|             D.V.
+//|             Copyright (c) 2014-2015 D.V. All rights reserved.
+//|
+//| Permission is hereby granted, free of charge, to any person obtaining a
+//| copy of this software and associated documentation files (the "Software"),
+//| to deal in the Software without restriction, including without limitation
+//| the rights to use, copy, modify, merge, publish, distribute, sublicense,
+//| and/or sell copies of the Software, and to permit persons to whom the
+//| Software is furnished to do so, subject to the following conditions:
+//|
+//| The above copyright notice and this permission notice shall be included
+//| in all copies or substantial portions of the Software.
+//|
+//| THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+//| OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+//| MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+//| IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+//| CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+//| TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+//| SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+//----------------------------------------------------------------------------//
+
+#import "_MKChunkedMemoryMap.h"
+#import "MKInternal.h"
+
+//! Sentinel for an unknown block index.
+#define MK_CHUNKED_NO_BLOCK     UINT64_MAX
+
+//! The most bytes copied by a remap that spans blocks, unless a single block
+//! is larger.
+#define MK_CHUNKED_MAX_SPAN     (64ULL << 20)
+
+//----------------------------------------------------------------------------//
+@interface _MKChunkedMemoryMapBlock : NSObject {
+@package
+    uint64_t _index;
+    NSData *_bytes;
+    // Recency list, most recently used first.  The blocks are retained by
+    // the map's index.
+    __unsafe_unretained _MKChunkedMemoryMapBlock *_previous;
+    __unsafe_unretained _MKChunkedMemoryMapBlock *_next;
+}
+@end
+
+@implementation _MKChunkedMemoryMapBlock
+@end
+
+
+
+//----------------------------------------------------------------------------//
+@implementation _MKChunkedMemoryMap
+{
+    id<MKBlockSource> _source;
+    mk_vm_size_t _blockSize;
+    mk_vm_size_t _maximumSpan;
+    BOOL _sequential;
+    NSUInteger _maximumCachedBlocks;
+    // Guarded by @synchronized on _source.
+    uint64_t _nextSequentialIndex;
+    // Guarded by @synchronized on self.
+    NSMutableDictionary<NSNumber*, _MKChunkedMemoryMapBlock*> *_blocks;
+    _MKChunkedMemoryMapBlock *_head;
+    _MKChunkedMemoryMapBlock *_tail;
+    uint64_t _endIndex;
+    uint64_t _lastMissIndex;
+    NSUInteger _readaheadBlocks;
+    BOOL _sequentialAdvice;
+    BOOL _readaheadPending;
+}
+
+//|++++++++++++++++++++++++++++++++++++|//
+- (instancetype)initWithBlockSource:(id<MKBlockSource>)source maximumCachedBlocks:(NSUInteger)maximumCachedBlocks error:(NSError**)error
+{
+    self = [super init];
+    if (self == nil) return nil;
+    
+    if (source == nil) {
+        MK_ERROR_OUT = [NSError mk_errorWithDomain:MKErrorDomain code:MK_EINVAL description:@"A block source is required."];
+        return nil;
+    }
+    
+    _blockSize = source.blockSize;
+    if (_blockSize == 0) {
+        MK_ERROR_OUT = [NSError mk_errorWithDomain:MKErrorDomain code:MK_EINVAL description:@"Invalid block size [%" MK_VM_PRIuSIZE "] for %@.", _blockSize, source];
+        return nil;
+    }
+    
+    // A block that spans the end of a read is needed alongside the block
+    // before it.
+    if (maximumCachedBlocks < 2) {
+        MK_ERROR_OUT = [NSError mk_errorWithDomain:MKErrorDomain code:MK_EINVAL description:@"At least two blocks must be cached, not %lu.", (unsigned long)maximumCachedBlocks];
+        return nil;
+    }
+    
+    _source = source;
+    _maximumSpan = MAX((mk_vm_size_t)MK_CHUNKED_MAX_SPAN, _blockSize);
+    _sequential = [source respondsToSelector:@selector(isSequential)] && source.sequential;
+    _maximumCachedBlocks = maximumCachedBlocks;
+    _blocks = [[NSMutableDictionary alloc] initWithCapacity:maximumCachedBlocks];
+    _endIndex = MK_CHUNKED_NO_BLOCK;
+    _lastMissIndex = MK_CHUNKED_NO_BLOCK;
+    _readaheadBlocks = 1;
+    
+    return self;
+}
+
+//◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦//
+#pragma mark -  Block Cache
+//◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦//
+//  These methods must be called while synchronized on self.
+
+//|++++++++++++++++++++++++++++++++++++|//
+- (void)_unlinkBlock:(_MKChunkedMemoryMapBlock*)block
+{
+    if (block->_previous)
+        block->_previous->_next = block->_next;
+    else
+        _head = block->_next;
+    
+    if (block->_next)
+        block->_next->_previous = block->_previous;
+    else
+        _tail = block->_previous;
+    
+    block->_previous = nil;
+    block->_next = nil;
+}
+
+//|++++++++++++++++++++++++++++++++++++|//
+- (void)_linkBlockAtHead:(_MKChunkedMemoryMapBlock*)block
+{
+    block->_previous = nil;
+    block->_next = _head;
+    if (_head)
+        _head->_previous = block;
+    _head = block;
+    if (_tail == nil)
+        _tail = block;
+}
+
+//|++++++++++++++++++++++++++++++++++++|//
+- (void)_removeBlock:(_MKChunkedMemoryMapBlock*)block
+{
+    [self _unlinkBlock:block];
+    // The index holds the only strong reference to the block.  Readers that
+    // are still using its bytes hold their own reference to the data.
+    [_blocks removeObjectForKey:@(block->_index)];
+}
+
+//|++++++++++++++++++++++++++++++++++++|//
+- (NSData*)_cachedBytesForBlockAtIndex:(uint64_t)index
+{
+    _MKChunkedMemoryMapBlock *block = _blocks[@(index)];
+    if (block == nil)
+        return nil;
+    
+    if (block != _head) {
+        [self _unlinkBlock:block];
+        [self _linkBlockAtHead:block];
+    }
+    
+    return block->_bytes;
+}
+
+//|++++++++++++++++++++++++++++++++++++|//
+- (void)_cacheBytes:(NSData*)bytes forBlockAtIndex:(uint64_t)index
+{
+    if (_blocks[@(index)])
+        return;
+    
+    _MKChunkedMemoryMapBlock *block = [_MKChunkedMemoryMapBlock new];
+    block->_index = index;
+    block->_bytes = bytes;
+    _blocks[@(index)] = block;
+    [self _linkBlockAtHead:block];
+    
+    while (_blocks.count > _maximumCachedBlocks)
+        [self _removeBlock:_tail];
+}
+
+//◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦//
+#pragma mark -  Reading Blocks
+//◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦//
+
+//|++++++++++++++++++++++++++++++++++++|//
+//! Reads a single block from the source, and caches it if \a cache is
+//! \c YES.  Returns empty data for a block past the end of the contents.
+//! Must be called while synchronized on the source.
+- (NSData*)_readBlockAtIndex:(uint64_t)index cache:(BOOL)cache error:(NSError**)error
+{
+    NSMutableData *bytes = [[NSMutableData alloc] initWithLength:(NSUInteger)_blockSize];
+    mk_vm_size_t length = 0;
+    
+    if ([_source readBlockAtIndex:index into:bytes.mutableBytes length:&length error:error] == NO)
+        return nil;
+    
+    if (length > _blockSize) {
+        MK_ERROR_OUT = [NSError mk_errorWithDomain:MKErrorDomain code:MK_ECLIENT_INVALID_RESULT description:@"%@ returned %" MK_VM_PRIuSIZE " bytes for block %" PRIu64 ", which is larger than its block size.", _source, length, index];
+        return nil;
+    }
+    
+    bytes.length = (NSUInteger)length;
+    
+    @synchronized(self) {
+        // A short block is the last one.
+        if (length < _blockSize)
+            _endIndex = MIN(_endIndex, (length ? index + 1 : index));
+        if (length && cache)
+            [self _cacheBytes:bytes forBlockAtIndex:index];
+    }
+    
+    return bytes;
+}
+
+//|++++++++++++++++++++++++++++++++++++|//
+- (NSData*)_loadBlockAtIndex:(uint64_t)index error:(NSError**)error
+{
+    @synchronized(_source) {
+        // Another reader, or the readahead, may have read the block while
+        // this one was waiting for the source.
+        @synchronized(self) {
+            NSData *bytes = [self _cachedBytesForBlockAtIndex:index];
+            if (bytes)
+                return bytes;
+            if (index >= _endIndex)
+                return [NSData data];
+        }
+        
+        if (_sequential == NO)
+            return [self _readBlockAtIndex:index cache:YES error:error];
+        
+        // A sequential source must be rewound to return to a block that has
+        // been dropped from the cache.
+        if (index < _nextSequentialIndex)
+        {
+            if ([_source respondsToSelector:@selector(rewind:)] == NO) {
+                MK_ERROR_OUT = [NSError mk_errorWithDomain:MKErrorDomain code:(NSInteger)(MK_EUNAVAILABLE | MK_EMEMORY_ERROR) description:@"Block %" PRIu64 " is no longer cached and %@ can not be rewound.", index, _source];
+                return nil;
+            }
+            if ([_source rewind:error] == NO)
+                return nil;
+            
+            _nextSequentialIndex = 0;
+        }
+        
+        // Blocks before the requested one are read on the way.  Only those
+        // close enough to the requested block to be read soon are kept, so
+        // that a long skip does not flush the cache.
+        NSData *bytes = nil;
+        while (_nextSequentialIndex <= index)
+        {
+            uint64_t current = _nextSequentialIndex;
+            bytes = [self _readBlockAtIndex:current cache:(current + _maximumCachedBlocks / 2 >= index) error:error];
+            if (bytes == nil)
+                return nil;
+            if (bytes.length == 0)
+                return bytes;
+            
+            _nextSequentialIndex++;
+        }
+        
+        return bytes;
+    }
+}
+
+//|++++++++++++++++++++++++++++++++++++|//
+- (void)_readAheadFromIndex:(uint64_t)index count:(NSUInteger)count
+{
+    @synchronized(self) {
+        if (count == 0 || _readaheadPending || index >= _endIndex)
+            return;
+        _readaheadPending = YES;
+    }
+    
+    // Never read ahead more than half the cache, so that the blocks being
+    // read now are not dropped for blocks that may never be read.
+    count = MIN(count, MAX(_maximumCachedBlocks / 2, (NSUInteger)1));
+    
+    dispatch_async(dispatch_get_global_queue(QOS_CLASS_UTILITY, 0), ^{
+        for (uint64_t i = index; i < index + count; i++) {
+            NSData *bytes = [self _loadBlockAtIndex:i error:NULL];
+            if (bytes.length == 0)
+                break;
+        }
+        
+        @synchronized(self) {
+            self->_readaheadPending = NO;
+        }
+    });
+}
+
+//|++++++++++++++++++++++++++++++++++++|//
+- (NSData*)_bytesForBlockAtIndex:(uint64_t)index error:(NSError**)error
+{
+    NSUInteger readahead = 0;
+    
+    @synchronized(self) {
+        NSData *bytes = [self _cachedBytesForBlockAtIndex:index];
+        if (bytes)
+            return bytes;
+        if (index >= _endIndex)
+            return [NSData data];
+        
+        // Read ahead after consecutive misses, or on every miss once the
+        // caller has advised that it reads sequentially.
+        if (_sequentialAdvice || (_lastMissIndex != MK_CHUNKED_NO_BLOCK && index == _lastMissIndex + 1))
+            readahead = _readaheadBlocks;
+        _lastMissIndex = index;
+    }
+    
+    NSData *bytes = [self _loadBlockAtIndex:index error:error];
+    if (bytes.length)
+        [self _readAheadFromIndex:index + 1 count:readahead];
+    
+    return bytes;
+}
+
+//◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦//
+#pragma mark -  Accessing Context Memory
+//◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦//
+
+//|++++++++++++++++++++++++++++++++++++|//
+- (void)remapBytesAtOffset:(mk_vm_offset_t)offset fromAddress:(mk_vm_address_t)contextAddress length:(mk_vm_size_t)length requireFull:(BOOL)requireFull withHandler:(void (^)(vm_address_t address, vm_size_t length, NSError *error))handler
+{
+    mk_error_t err;
+    mk_vm_address_t offsetAddress;
+    NSError *localError = nil;
+    
+    __atomic_fetch_add(&_statistics.remap, 1, __ATOMIC_RELAXED);
+    
+    // Compute the offset address.
+    if ((err = mk_vm_address_apply_offset(contextAddress, offset, &offsetAddress))) {
+        NSError *error = [NSError mk_errorWithDomain:MKErrorDomain code:(NSInteger)(err | MK_EMEMORY_ERROR) description:@"Arithmetic error [%s] adding offset [%" MK_VM_PRIuOFFSET "] to address [0x%" MK_VM_PRIxADDR "].", mk_error_string(err), offset, contextAddress];
+        handler(0, 0, error);
+        return;
+    }
+    
+    if (requireFull && MK_VM_SIZE_MAX - length < offsetAddress) {
+        NSError *error = [NSError mk_errorWithDomain:MKErrorDomain code:(NSInteger)(MK_EOVERFLOW | MK_EMEMORY_ERROR) description:@"Input range (offset address = 0x%" MK_VM_PRIxADDR ", length = %" MK_VM_PRIxSIZE ") overflows.", offsetAddress, length];
+        handler(0, 0, error);
+        return;
+    }
+    
+    uint64_t index = offsetAddress / _blockSize;
+    mk_vm_size_t blockOffset = offsetAddress % _blockSize;
+    
+    // The bytes must stay alive until the handler returns, even if the block
+    // is dropped from the cache in the meantime.
+    NSData *first __attribute__((objc_precise_lifetime)) = [self _bytesForBlockAtIndex:index error:&localError];
+    if (first == nil) {
+        handler(0, 0, localError);
+        return;
+    }
+    
+    // The start of the range must be within the contents.
+    if (blockOffset >= first.length) {
+        NSError *error = [NSError mk_errorWithDomain:MKErrorDomain code:(NSInteger)(MK_EBAD_ACCESS | MK_EMEMORY_ERROR) description:@"Input range (offset address = 0x%" MK_VM_PRIxADDR ", length = %" MK_VM_PRIxSIZE ") is not within %@", offsetAddress, length, self];
+        handler(0, 0, error);
+        return;
+    }
+    
+    // Fast path - the range is within a single block.
+    mk_vm_size_t available = first.length - blockOffset;
+    if (length <= available || available < _blockSize - blockOffset) {
+        if (requireFull && length > available) {
+            NSError *error = [NSError mk_errorWithDomain:MKErrorDomain code:(NSInteger)(MK_EBAD_ACCESS | MK_EMEMORY_ERROR) description:@"Input range (offset address = 0x%" MK_VM_PRIxADDR ", length = %" MK_VM_PRIxSIZE ") is not within %@", offsetAddress, length, self];
+            handler(0, 0, error);
+            return;
+        }
+        
+        handler((vm_address_t)first.bytes + (vm_address_t)blockOffset, (vm_size_t)MIN(length, available), nil);
+        return;
+    }
+    
+    // The range spans blocks.  Copy it into a buffer that lives for the
+    // duration of the handler.  The buffer grows as blocks are read, so a
+    // long range that runs past the end of the contents only costs the
+    // bytes that exist.  A range longer than the maximum span is truncated,
+    // so that a bogus length can not exhaust memory.
+    if (length > _maximumSpan) {
+        if (requireFull) {
+            NSError *error = [NSError mk_errorWithDomain:MKErrorDomain code:(NSInteger)(MK_ESIZE | MK_EMEMORY_ERROR) description:@"Input range (offset address = 0x%" MK_VM_PRIxADDR ", length = %" MK_VM_PRIxSIZE ") is longer than the %" MK_VM_PRIuSIZE " bytes that %@ can remap at once.", offsetAddress, length, _maximumSpan, self];
+            handler(0, 0, error);
+            return;
+        }
+        length = _maximumSpan;
+    }
+    
+    NSMutableData *span = [[NSMutableData alloc] initWithBytes:(const uint8_t*)first.bytes + blockOffset length:(NSUInteger)available];
+    mk_vm_size_t remaining = length - available;
+    
+    while (remaining > 0)
+    {
+        NSData *bytes = [self _bytesForBlockAtIndex:++index error:&localError];
+        if (bytes == nil) {
+            if (requireFull) {
+                handler(0, 0, localError);
+                return;
+            }
+            break;
+        }
+        
+        mk_vm_size_t used = MIN(remaining, (mk_vm_size_t)bytes.length);
+        [span appendBytes:bytes.bytes length:(NSUInteger)used];
+        remaining -= used;
+        
+        if (bytes.length < _blockSize)
+            break;
+    }
+    
+    if (requireFull && remaining > 0) {
+        NSError *error = [NSError mk_errorWithDomain:MKErrorDomain code:(NSInteger)(MK_EBAD_ACCESS | MK_EMEMORY_ERROR) description:@"Input range (offset address = 0x%" MK_VM_PRIxADDR ", length = %" MK_VM_PRIxSIZE ") is not within %@", offsetAddress, length, self];
+        handler(0, 0, error);
+        return;
+    }
+    
+    __atomic_fetch_add(&_statistics.bytes_copied, span.length, __ATOMIC_RELAXED);
+    handler((vm_address_t)span.bytes, (vm_size_t)span.length, nil);
+}
+
+//◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦//
+#pragma mark -  Advising Context Memory Access
+//◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦//
+
+//|++++++++++++++++++++++++++++++++++++|//
+- (void)adviseAccess:(MKMemoryAccessAdvice)advice atOffset:(mk_vm_offset_t)offset fromAddress:(mk_vm_address_t)contextAddress length:(mk_vm_size_t)length
+{
+    mk_vm_address_t offsetAddress;
+    if (mk_vm_address_apply_offset(contextAddress, offset, &offsetAddress) || length == 0)
+        return;
+    
+    length = MIN(length, MK_VM_SIZE_MAX - offsetAddress);
+    uint64_t firstIndex = offsetAddress / _blockSize;
+    uint64_t lastIndex = (offsetAddress + length - 1) / _blockSize;
+    
+    // The access pattern advice applies to the whole map rather than to the
+    // range, since the readahead window is shared by all readers.
+    switch (advice) {
+        case MKMemoryAccessAdviceNormal:
+            @synchronized(self) {
+                _readaheadBlocks = 1;
+                _sequentialAdvice = NO;
+            }
+            break;
+        case MKMemoryAccessAdviceSequential:
+            @synchronized(self) {
+                _readaheadBlocks = MAX(_maximumCachedBlocks / 2, (NSUInteger)1);
+                _sequentialAdvice = YES;
+            }
+            break;
+        case MKMemoryAccessAdviceRandom:
+            @synchronized(self) {
+                _readaheadBlocks = 0;
+                _sequentialAdvice = NO;
+            }
+            break;
+        case MKMemoryAccessAdviceWillNeed:
+            [self _readAheadFromIndex:firstIndex count:(NSUInteger)MIN(lastIndex - firstIndex + 1, (uint64_t)NSUIntegerMax)];
+            break;
+        case MKMemoryAccessAdviceDontNeed:
+            @synchronized(self) {
+                for (_MKChunkedMemoryMapBlock *block in _blocks.allValues) {
+                    if (block->_index >= firstIndex && block->_index <= lastIndex)
+                        [self _removeBlock:block];
+                }
+            }
+            break;
+        default:
+            break;
+    }
+}
+
+@end
@@ -28,6 +28,8 @@
 #import "_MKFileMemoryMap.h"
 #import "MKInternal.h"
 
+#include <sys/mman.h>
+
 //----------------------------------------------------------------------------//
 @implementation _MKFileMemoryMap
 
@@ -55,6 +57,8 @@
     mk_error_t err;
     mk_vm_address_t offsetAddress;
     
+    __atomic_fetch_add(&_statistics.remap, 1, __ATOMIC_RELAXED);
+    
     // Compute the offset address.
     if ((err = mk_vm_address_apply_offset(contextAddress, offset, &offsetAddress))) {
         NSError *error = [NSError mk_errorWithDomain:MKErrorDomain code:(NSInteger)(err | MK_EMEMORY_ERROR) description:@"Arithmetic error [%s] adding offset [%" MK_VM_PRIuOFFSET "] to address [0x%" MK_VM_PRIxADDR "].", mk_error_string(err), offset, contextAddress];
@@ -79,6 +83,65 @@
     handler(fileOffset, mappingLength, nil);
 }
 
+//◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦//
+#pragma mark -  Advising Context Memory Access
+//◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦//
+
+//|++++++++++++++++++++++++++++++++++++|//
+- (void)adviseAccess:(MKMemoryAccessAdvice)advice atOffset:(mk_vm_offset_t)offset fromAddress:(mk_vm_address_t)contextAddress length:(mk_vm_size_t)length
+{
+    mk_vm_address_t offsetAddress;
+    if (mk_vm_address_apply_offset(contextAddress, offset, &offsetAddress))
+        return;
+    
+    mk_vm_size_t fileLength = (mach_vm_size_t)_fileData.length;
+    if (offsetAddress >= fileLength || length == 0)
+        return;
+    
+    length = MIN(length, fileLength - offsetAddress);
+    
+    int behavior;
+    switch (advice) {
+        case MKMemoryAccessAdviceNormal:
+            behavior = MADV_NORMAL;
+            break;
+        case MKMemoryAccessAdviceSequential:
+            behavior = MADV_SEQUENTIAL;
+            break;
+        case MKMemoryAccessAdviceRandom:
+            behavior = MADV_RANDOM;
+            break;
+        case MKMemoryAccessAdviceWillNeed:
+            behavior = MADV_WILLNEED;
+            break;
+        case MKMemoryAccessAdviceDontNeed:
+            behavior = MADV_DONTNEED;
+            break;
+        default:
+            return;
+    }
+    
+    // madvise() works on whole pages.  The file is usually mapped, in which
+    // case MADV_WILLNEED starts reading the range ahead.  If NSData read the
+    // file instead, the advice only affects how its pages are paged out.
+    // Pages that are only partly in the range are given the advice unless it
+    // is MADV_DONTNEED, which must not lower the priority of bytes outside
+    // the range.
+    vm_address_t start = (vm_address_t)_fileData.bytes + (vm_address_t)offsetAddress;
+    vm_address_t end = start + (vm_size_t)length;
+    if (behavior == MADV_DONTNEED) {
+        start = round_page(start);
+        end = trunc_page(end);
+    } else {
+        start = trunc_page(start);
+        end = round_page(end);
+    }
+    
+    if (end > start)
+        madvise((void*)start, end - start, behavior);
+}
+
+//|++++++++++++++++++++++++++++++++++++|//
 - (NSData *)data {
     return _fileData;
 }
@@ -28,6 +28,7 @@
 
 - (void)remapBytesAtOffset:(mk_vm_offset_t)offset fromAddress:(mk_vm_address_t)contextAddress length:(mk_vm_size_t)length requireFull:(BOOL)requireFull withHandler:(void (^)(vm_address_t, vm_size_t, NSError * _Nullable))handler {
 //    NSLog(@"---> %p %p %llu %p %llu %llu", _addr, _fileoff, _fileoff, _size, offset, contextAddress);
+    __atomic_fetch_add(&_statistics.remap, 1, __ATOMIC_RELAXED);
     handler((uint64_t)_addr + (contextAddress - _fileoff), length, nil);
 }
 
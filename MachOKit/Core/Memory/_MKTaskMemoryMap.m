@@ -64,6 +64,8 @@
 	// TODO - Investigate caching mappings.  This is too much work to be doing thousands of times.
     mk_error_t mkErr;
     
+    __atomic_fetch_add(&_statistics.remap, 1, __ATOMIC_RELAXED);
+    
     // Compute the offset address
     if ((mkErr = mk_vm_address_apply_offset(contextAddress, offset, &contextAddress))) {
         NSError *error = [NSError mk_errorWithDomain:MKErrorDomain code:(mkErr | MK_EMEMORY_ERROR) description:@"Arithmetic error [%s] adding offset [%" MK_VM_PRIuOFFSET "] to address [0x%" MK_VM_PRIxADDR "].", mk_error_string(mkErr), offset, contextAddress];
@@ -0,0 +1,568 @@
+//
+//  DSCExtractor.c
+//  MachOKit
+//
+
+#include "DSCExtractor.h"
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <limits.h>
+#include <unistd.h>
+#include <stdatomic.h>
+#include <sys/uio.h>
+#include <sys/mman.h>
+#include <sys/param.h>
+#include <sys/stat.h>
+#include <mach-o/loader.h>
+#include <mach-o/nlist.h>
+#include <mach-o/reloc.h>
+#include <dispatch/dispatch.h>
+
+#ifndef IOV_MAX
+#define IOV_MAX 1024
+#endif
+
+#define DSC_EXTRACT_BOUNCE_SIZE (1024 * 1024)
+
+static uint64_t _dsc_extract_align(uint64_t value, uint64_t alignment)
+{
+    return (value + alignment - 1) & ~(alignment - 1);
+}
+
+static int _dsc_extract_add_chunk(DSCExtractLayout *layout, DSCExtractChunk chunk)
+{
+    if (chunk.size == 0) return 0;
+
+    if (layout->chunkCount == layout->chunkCapacity) {
+        unsigned capacity = layout->chunkCapacity ? layout->chunkCapacity * 2 : 32;
+        DSCExtractChunk *chunks = realloc(layout->chunks, capacity * sizeof(DSCExtractChunk));
+        if (!chunks) return -1;
+        layout->chunks = chunks;
+        layout->chunkCapacity = capacity;
+    }
+    layout->chunks[layout->chunkCount++] = chunk;
+    return 0;
+}
+
+// Adds a chunk sourced from the cache.  Mapped ranges are referenced in place,
+// ranges whose mapping failed to mmap are copied from the cache file when the
+// layout is written.
+static int _dsc_extract_add_vm_chunk(DyldSharedCache *sharedCache, DSCExtractLayout *layout, uint64_t dstOffset, uint64_t vmaddr, uint64_t size)
+{
+    if (size == 0) return 0;
+
+    DyldSharedCacheMapping *mapping = dsc_lookup_mapping(sharedCache, vmaddr, size);
+    if (!mapping) {
+        // Leave the range zero filled rather than failing the whole image.
+        // The caller reports the image as incomplete.
+        layout->unmappedSize += size;
+        return 0;
+    }
+
+    DSCExtractChunk chunk = { .dstOffset = dstOffset, .size = size };
+    uint64_t contentOffset = vmaddr - mapping->vmaddr;
+    if (mapping->ptr != (void *)-1) {
+        chunk.src = (const void *)((uintptr_t)mapping->ptr + contentOffset);
+    } else {
+        chunk.file = mapping->file;
+        chunk.fileOffset = mapping->fileoff + contentOffset;
+    }
+    return _dsc_extract_add_chunk(layout, chunk);
+}
+
+static int _dsc_extract_chunk_compare(const void *a, const void *b)
+{
+    const DSCExtractChunk *chunkA = a;
+    const DSCExtractChunk *chunkB = b;
+    if (chunkA->dstOffset < chunkB->dstOffset) return -1;
+    if (chunkA->dstOffset > chunkB->dstOffset) return 1;
+    return 0;
+}
+
+typedef struct DSCExtractLinkEdit {
+    DyldSharedCache *sharedCache;
+    DSCExtractLayout *layout;
+    uint64_t vmaddr;
+    uint64_t fileoff;
+    uint64_t cursor;
+} DSCExtractLinkEdit;
+
+// Relocates one __LINKEDIT blob to the output cursor and rewrites its offset.
+static int _dsc_extract_move_linkedit(DSCExtractLinkEdit *linkEdit, uint32_t *offset, uint64_t size)
+{
+    if (size == 0 || *offset == 0) {
+        *offset = 0;
+        return 0;
+    }
+
+    uint64_t vmaddr = linkEdit->vmaddr + (*offset - linkEdit->fileoff);
+    if (_dsc_extract_add_vm_chunk(linkEdit->sharedCache, linkEdit->layout, linkEdit->cursor, vmaddr, size) != 0) return -1;
+
+    *offset = (uint32_t)linkEdit->cursor;
+    linkEdit->cursor = _dsc_extract_align(linkEdit->cursor + size, 8);
+    return 0;
+}
+
+// The cache shares one string pool between all images.  Rebuild the image's
+// nlist entries against a compact pool holding only the strings it references.
+static int _dsc_extract_rebuild_symtab(DSCExtractLinkEdit *linkEdit, struct symtab_command *symtab)
+{
+    DSCExtractLayout *layout = linkEdit->layout;
+    if (symtab->nsyms == 0) {
+        symtab->symoff = symtab->stroff = symtab->strsize = 0;
+        return 0;
+    }
+
+    int r = -1;
+    bool needFreeSymbols = false, needFreeStrings = false;
+    uint64_t symbolsSize = (uint64_t)symtab->nsyms * sizeof(struct nlist_64);
+    struct nlist_64 *symbols = dsc_find_buffer(linkEdit->sharedCache, linkEdit->vmaddr + (symtab->symoff - linkEdit->fileoff), symbolsSize, &needFreeSymbols);
+    const char *strings = dsc_find_buffer(linkEdit->sharedCache, linkEdit->vmaddr + (symtab->stroff - linkEdit->fileoff), symtab->strsize, &needFreeStrings);
+    if (!symbols || !strings) goto out;
+
+    // Leading NUL so that n_strx 0 keeps meaning "no name".
+    uint64_t poolSize = 1;
+    for (uint32_t i = 0; i < symtab->nsyms; i++) {
+        uint32_t strx = symbols[i].n_un.n_strx;
+        if (strx == 0 || strx >= symtab->strsize) continue;
+        poolSize += strnlen(strings + strx, symtab->strsize - strx) + 1;
+    }
+    poolSize = _dsc_extract_align(poolSize, 8);
+    if (poolSize > UINT32_MAX) goto out;
+
+    layout->symbols = malloc(symbolsSize);
+    layout->strings = calloc(poolSize, 1);
+    if (!layout->symbols || !layout->strings) goto out;
+
+    struct nlist_64 *newSymbols = layout->symbols;
+    uint32_t poolCursor = 1;
+    for (uint32_t i = 0; i < symtab->nsyms; i++) {
+        newSymbols[i] = symbols[i];
+        uint32_t strx = symbols[i].n_un.n_strx;
+        if (strx == 0 || strx >= symtab->strsize) {
+            newSymbols[i].n_un.n_strx = 0;
+            continue;
+        }
+        size_t length = strnlen(strings + strx, symtab->strsize - strx);
+        memcpy(layout->strings + poolCursor, strings + strx, length);
+        newSymbols[i].n_un.n_strx = poolCursor;
+        poolCursor += length + 1;
+    }
+
+    DSCExtractChunk symbolChunk = { .dstOffset = linkEdit->cursor, .size = symbolsSize, .src = layout->symbols };
+    if (_dsc_extract_add_chunk(layout, symbolChunk) != 0) goto out;
+    symtab->symoff = (uint32_t)linkEdit->cursor;
+    linkEdit->cursor = _dsc_extract_align(linkEdit->cursor + symbolsSize, 8);
+
+    DSCExtractChunk stringChunk = { .dstOffset = linkEdit->cursor, .size = poolSize, .src = layout->strings };
+    if (_dsc_extract_add_chunk(layout, stringChunk) != 0) goto out;
+    symtab->stroff = (uint32_t)linkEdit->cursor;
+    symtab->strsize = (uint32_t)poolSize;
+    linkEdit->cursor += poolSize;
+
+    r = 0;
+out:
+    if (needFreeSymbols) free(symbols);
+    if (needFreeStrings) free((void *)strings);
+    return r;
+}
+
+static bool _dsc_extract_is_zerofill(uint32_t flags)
+{
+    uint32_t type = flags & SECTION_TYPE;
+    return type == S_ZEROFILL || type == S_GB_ZEROFILL || type == S_THREAD_LOCAL_ZEROFILL;
+}
+
+int dsc_image_build_extract_layout(DyldSharedCache *sharedCache, DyldSharedCacheImage *image, DSCExtractLayout *layoutOut)
+{
+    memset(layoutOut, 0, sizeof(*layoutOut));
+    // Failures that do not set errno are reported as EINVAL.
+    errno = 0;
+
+    struct mach_header_64 mh;
+    bool needFree = false;
+    void *buffer = dsc_find_buffer(sharedCache, image->address, sizeof(mh), &needFree);
+    if (!buffer) {
+        errno = EFAULT;
+        return -1;
+    }
+    memcpy(&mh, buffer, sizeof(mh));
+    if (needFree) free(buffer);
+
+    // 32-bit caches are not supported.
+    if (mh.magic != MH_MAGIC_64) {
+        errno = ENOTSUP;
+        return -1;
+    }
+
+    uint32_t headerSize = sizeof(mh) + mh.sizeofcmds;
+    layoutOut->header = malloc(headerSize);
+    if (!layoutOut->header) return -1;
+    layoutOut->headerSize = headerSize;
+    if (dsc_read_from_vmaddr(sharedCache, image->address, headerSize, layoutOut->header) != 0) {
+        needFree = false;
+        buffer = dsc_find_buffer(sharedCache, image->address, headerSize, &needFree);
+        if (!buffer) goto fail;
+        memcpy(layoutOut->header, buffer, headerSize);
+        if (needFree) free(buffer);
+    }
+
+    DSCExtractChunk headerChunk = { .dstOffset = 0, .size = headerSize, .src = layoutOut->header };
+    if (_dsc_extract_add_chunk(layoutOut, headerChunk) != 0) goto fail;
+
+    uint64_t pageSize = (mh.cputype == CPU_TYPE_ARM64) ? 0x4000 : 0x1000;
+    uint8_t *commands = (uint8_t *)layoutOut->header + sizeof(mh);
+    uint8_t *commandsEnd = commands + mh.sizeofcmds;
+    struct segment_command_64 *linkEditSegment = NULL;
+
+    // __TEXT is placed at offset 0 so that it covers the header.  Every other
+    // segment follows it at the next page boundary.
+    uint64_t cursor = headerSize;
+    for (uint8_t *p = commands; p < commandsEnd; p += ((struct load_command *)p)->cmdsize) {
+        struct load_command *lc = (struct load_command *)p;
+        if (p + sizeof(struct load_command) > commandsEnd || lc->cmdsize < sizeof(struct load_command) || p + lc->cmdsize > commandsEnd) goto fail;
+        if (lc->cmd == LC_SEGMENT_64 && strncmp(((struct segment_command_64 *)lc)->segname, SEG_TEXT, 16) == 0) {
+            cursor = MAX(((struct segment_command_64 *)lc)->filesize, headerSize);
+        }
+    }
+
+    for (uint8_t *p = commands; p + sizeof(struct load_command) <= commandsEnd; p += ((struct load_command *)p)->cmdsize) {
+        struct load_command *lc = (struct load_command *)p;
+        if (lc->cmd != LC_SEGMENT_64) continue;
+
+        struct segment_command_64 *seg = (struct segment_command_64 *)lc;
+        if (strncmp(seg->segname, SEG_LINKEDIT, 16) == 0) {
+            linkEditSegment = seg;
+            continue;
+        }
+
+        bool isText = strncmp(seg->segname, SEG_TEXT, 16) == 0;
+        uint64_t fileoff = 0;
+        if (isText) {
+            if (_dsc_extract_add_vm_chunk(sharedCache, layoutOut, headerSize, seg->vmaddr + headerSize, seg->filesize > headerSize ? seg->filesize - headerSize : 0) != 0) goto fail;
+        } else {
+            fileoff = seg->filesize ? _dsc_extract_align(cursor, pageSize) : 0;
+            if (_dsc_extract_add_vm_chunk(sharedCache, layoutOut, fileoff, seg->vmaddr, seg->filesize) != 0) goto fail;
+            if (seg->filesize) cursor = fileoff + seg->filesize;
+        }
+
+        struct section_64 *sections = (struct section_64 *)(seg + 1);
+        for (uint32_t i = 0; i < seg->nsects; i++) {
+            if ((uint8_t *)&sections[i + 1] > commandsEnd) goto fail;
+            if (_dsc_extract_is_zerofill(sections[i].flags)) {
+                sections[i].offset = 0;
+            } else {
+                sections[i].offset = (uint32_t)(fileoff + (sections[i].addr - seg->vmaddr));
+            }
+        }
+        seg->fileoff = fileoff;
+    }
+
+    if (!linkEditSegment) {
+        layoutOut->fileSize = cursor;
+        goto done;
+    }
+
+    DSCExtractLinkEdit linkEdit = {
+        .sharedCache = sharedCache,
+        .layout = layoutOut,
+        .vmaddr = linkEditSegment->vmaddr,
+        .fileoff = linkEditSegment->fileoff,
+        .cursor = _dsc_extract_align(cursor, pageSize),
+    };
+    uint64_t linkEditStart = linkEdit.cursor;
+
+    for (uint8_t *p = commands; p + sizeof(struct load_command) <= commandsEnd; p += ((struct load_command *)p)->cmdsize) {
+        struct load_command *lc = (struct load_command *)p;
+        int r = 0;
+        switch (lc->cmd) {
+            case LC_DYLD_INFO:
+            case LC_DYLD_INFO_ONLY: {
+                struct dyld_info_command *info = (struct dyld_info_command *)lc;
+                r |= _dsc_extract_move_linkedit(&linkEdit, &info->rebase_off, info->rebase_size);
+                r |= _dsc_extract_move_linkedit(&linkEdit, &info->bind_off, info->bind_size);
+                r |= _dsc_extract_move_linkedit(&linkEdit, &info->weak_bind_off, info->weak_bind_size);
+                r |= _dsc_extract_move_linkedit(&linkEdit, &info->lazy_bind_off, info->lazy_bind_size);
+                r |= _dsc_extract_move_linkedit(&linkEdit, &info->export_off, info->export_size);
+                break;
+            }
+            case LC_SYMTAB:
+                r = _dsc_extract_rebuild_symtab(&linkEdit, (struct symtab_command *)lc);
+                break;
+            case LC_DYSYMTAB: {
+                struct dysymtab_command *dysymtab = (struct dysymtab_command *)lc;
+                r |= _dsc_extract_move_linkedit(&linkEdit, &dysymtab->tocoff, (uint64_t)dysymtab->ntoc * sizeof(struct dylib_table_of_contents));
+                r |= _dsc_extract_move_linkedit(&linkEdit, &dysymtab->modtaboff, (uint64_t)dysymtab->nmodtab * sizeof(struct dylib_module_64));
+                r |= _dsc_extract_move_linkedit(&linkEdit, &dysymtab->extrefsymoff, (uint64_t)dysymtab->nextrefsyms * sizeof(struct dylib_reference));
+                r |= _dsc_extract_move_linkedit(&linkEdit, &dysymtab->indirectsymoff, (uint64_t)dysymtab->nindirectsyms * sizeof(uint32_t));
+                r |= _dsc_extract_move_linkedit(&linkEdit, &dysymtab->extreloff, (uint64_t)dysymtab->nextrel * sizeof(struct relocation_info));
+                r |= _dsc_extract_move_linkedit(&linkEdit, &dysymtab->locreloff, (uint64_t)dysymtab->nlocrel * sizeof(struct relocation_info));
+                break;
+            }
+            case LC_CODE_SIGNATURE:
+            case LC_SEGMENT_SPLIT_INFO:
+            case LC_FUNCTION_STARTS:
+            case LC_DATA_IN_CODE:
+            case LC_DYLIB_CODE_SIGN_DRS:
+            case LC_LINKER_OPTIMIZATION_HINT:
+            case LC_DYLD_EXPORTS_TRIE:
+            case LC_DYLD_CHAINED_FIXUPS: {
+                struct linkedit_data_command *data = (struct linkedit_data_command *)lc;
+                r = _dsc_extract_move_linkedit(&linkEdit, &data->dataoff, data->datasize);
+                break;
+            }
+            default:
+                break;
+        }
+        if (r != 0) goto fail;
+    }
+
+    linkEditSegment->fileoff = linkEditStart;
+    linkEditSegment->filesize = linkEdit.cursor - linkEditStart;
+    linkEditSegment->vmsize = _dsc_extract_align(linkEditSegment->filesize, pageSize);
+    layoutOut->fileSize = linkEdit.cursor;
+
+done:
+    qsort(layoutOut->chunks, layoutOut->chunkCount, sizeof(DSCExtractChunk), _dsc_extract_chunk_compare);
+    return 0;
+
+fail:
+    dsc_extract_layout_free(layoutOut);
+    if (errno == 0) errno = EINVAL;
+    return -1;
+}
+
+void dsc_extract_layout_free(DSCExtractLayout *layout)
+{
+    if (!layout) return;
+    free(layout->chunks);
+    free(layout->header);
+    free(layout->symbols);
+    free(layout->strings);
+    memset(layout, 0, sizeof(*layout));
+}
+
+static int _dsc_extract_pwritev(int fd, struct iovec *iov, int iovcnt, uint64_t offset)
+{
+    while (iovcnt > 0) {
+        ssize_t written;
+#if defined(__APPLE__)
+        if (__builtin_available(macOS 11.0, iOS 14.0, tvOS 14.0, watchOS 7.0, *)) {
+            written = pwritev(fd, iov, iovcnt, (off_t)offset);
+        } else {
+            written = pwrite(fd, iov->iov_base, iov->iov_len, (off_t)offset);
+        }
+#else
+        written = pwritev(fd, iov, iovcnt, (off_t)offset);
+#endif
+        if (written < 0) {
+            if (errno == EINTR) continue;
+            return -1;
+        }
+
+        offset += written;
+        while (iovcnt > 0 && (size_t)written >= iov->iov_len) {
+            written -= iov->iov_len;
+            iov++;
+            iovcnt--;
+        }
+        if (iovcnt > 0) {
+            iov->iov_base = (uint8_t *)iov->iov_base + written;
+            iov->iov_len -= written;
+        }
+    }
+    return 0;
+}
+
+// Copies a range of a cache file whose mapping could not be mmap'd through a
+// bounce buffer.
+static int _dsc_extract_copy_file(int fd, DSCExtractChunk *chunk, void **bounce)
+{
+    uint64_t done = 0;
+    if (!*bounce) {
+        *bounce = malloc(DSC_EXTRACT_BOUNCE_SIZE);
+        if (!*bounce) return -1;
+    }
+    while (done < chunk->size) {
+        size_t length = (size_t)MIN(chunk->size - done, DSC_EXTRACT_BOUNCE_SIZE);
+        ssize_t nread = pread(chunk->file->fd, *bounce, length, (off_t)(chunk->fileOffset + done));
+        if (nread < 0 && errno == EINTR) continue;
+        if (nread <= 0) {
+            if (nread == 0) errno = EIO;
+            return -1;
+        }
+        struct iovec iov = { .iov_base = *bounce, .iov_len = (size_t)nread };
+        if (_dsc_extract_pwritev(fd, &iov, 1, chunk->dstOffset + done) != 0) return -1;
+        done += (uint64_t)nread;
+    }
+    return 0;
+}
+
+// Asks the kernel to start reading a chunk's source before it is written, so
+// that the reads for an image overlap instead of faulting one page at a time.
+static void _dsc_extract_prefetch_chunk(const DSCExtractChunk *chunk)
+{
+    if (chunk->src) {
+        uintptr_t pageMask = (uintptr_t)getpagesize() - 1;
+        uintptr_t start = (uintptr_t)chunk->src & ~pageMask;
+        uintptr_t end = ((uintptr_t)chunk->src + (uintptr_t)chunk->size + pageMask) & ~pageMask;
+        madvise((void *)start, end - start, MADV_WILLNEED);
+    } else if (chunk->file) {
+        struct radvisory advisory = {
+            .ra_offset = (off_t)chunk->fileOffset,
+            .ra_count = (int)MIN(chunk->size, (uint64_t)INT_MAX)
+        };
+        fcntl(chunk->file->fd, F_RDADVISE, &advisory);
+    }
+}
+
+int dsc_extract_layout_write(DSCExtractLayout *layout, int fd)
+{
+    if (ftruncate(fd, (off_t)layout->fileSize) != 0) return -1;
+
+    for (unsigned i = 0; i < layout->chunkCount; i++) {
+        _dsc_extract_prefetch_chunk(&layout->chunks[i]);
+    }
+
+    int r = 0;
+    void *bounce = NULL;
+    struct iovec iov[IOV_MAX];
+    int iovcnt = 0;
+    uint64_t runStart = 0, runEnd = 0;
+
+    // Adjacent mapped chunks are coalesced into one vectored write.
+    for (unsigned i = 0; i < layout->chunkCount && r == 0; i++) {
+        DSCExtractChunk *chunk = &layout->chunks[i];
+        bool contiguous = iovcnt > 0 && chunk->dstOffset == runEnd;
+        if (iovcnt > 0 && (!chunk->src || !contiguous || iovcnt == IOV_MAX)) {
+            r = _dsc_extract_pwritev(fd, iov, iovcnt, runStart);
+            iovcnt = 0;
+            if (r != 0) break;
+        }
+
+        if (!chunk->src) {
+            r = _dsc_extract_copy_file(fd, chunk, &bounce);
+            continue;
+        }
+
+        if (iovcnt == 0) runStart = chunk->dstOffset;
+        iov[iovcnt++] = (struct iovec){ .iov_base = (void *)chunk->src, .iov_len = (size_t)chunk->size };
+        runEnd = chunk->dstOffset + chunk->size;
+    }
+    if (r == 0 && iovcnt > 0) {
+        r = _dsc_extract_pwritev(fd, iov, iovcnt, runStart);
+    }
+
+    free(bounce);
+    return r;
+}
+
+static int _dsc_image_extract(DyldSharedCache *sharedCache, DyldSharedCacheImage *image, const char *outputPath, int openFlags)
+{
+    DSCExtractLayout layout;
+    if (dsc_image_build_extract_layout(sharedCache, image, &layout) != 0) return -1;
+
+    int r = -1;
+    int fd = open(outputPath, O_WRONLY | O_CREAT | openFlags, 0755);
+    if (fd >= 0) {
+        r = dsc_extract_layout_write(&layout, fd);
+        // Keep the errno of the first failure.
+        int savedErrno = errno;
+        if (close(fd) != 0 && r == 0) r = -1;
+        else errno = savedErrno;
+    }
+
+    if (r == 0 && layout.unmappedSize != 0) r = DSC_EXTRACT_INCOMPLETE;
+
+    dsc_extract_layout_free(&layout);
+    return r;
+}
+
+int dsc_image_extract(DyldSharedCache *sharedCache, DyldSharedCacheImage *image, const char *outputPath)
+{
+    return _dsc_image_extract(sharedCache, image, outputPath, O_TRUNC);
+}
+
+// Builds the output path of an image, which mirrors its install path under
+// outputDir, and creates the directories leading to it.  Returns 0 on
+// success, or -1 with errno set.
+static int _dsc_extract_output_path(const char *outputDir, const char *imagePath, char *outputPath, size_t size)
+{
+    // The install path comes from the cache file.  Refuse any that would
+    // leave outputDir.
+    for (const char *c = imagePath; *c; ) {
+        size_t length = strcspn(c, "/");
+        if ((length == 1 && c[0] == '.') || (length == 2 && c[0] == '.' && c[1] == '.')) {
+            errno = EINVAL;
+            return -1;
+        }
+        c += length;
+        while (*c == '/') c++;
+    }
+
+    while (*imagePath == '/') imagePath++;
+    if (*imagePath == '\0') {
+        errno = EINVAL;
+        return -1;
+    }
+
+    if (snprintf(outputPath, size, "%s/%s", outputDir, imagePath) >= (int)size) {
+        errno = ENAMETOOLONG;
+        return -1;
+    }
+
+    // Another worker may be creating the same directories.
+    for (char *slash = strchr(outputPath + strlen(outputDir) + 1, '/'); slash; slash = strchr(slash + 1, '/')) {
+        *slash = '\0';
+        int r = mkdir(outputPath, 0755);
+        int savedErrno = errno;
+        *slash = '/';
+        if (r != 0 && savedErrno != EEXIST) {
+            errno = savedErrno;
+            return -1;
+        }
+    }
+
+    return 0;
+}
+
+uint64_t dsc_extract_images(DyldSharedCache *sharedCache, const char *outputDir, unsigned workerCount)
+{
+    uint64_t imageCount = sharedCache->containedImageCount;
+    if (imageCount == 0) return 0;
+
+    if (workerCount == 0) {
+        long cpuCount = sysconf(_SC_NPROCESSORS_ONLN);
+        workerCount = cpuCount > 0 ? (unsigned)cpuCount : 1;
+    }
+    if (workerCount > imageCount) workerCount = (unsigned)imageCount;
+
+    // Workers pull images from a shared counter so that a few large images
+    // do not leave the other workers idle.
+    _Atomic uint64_t nextIndex = 0;
+    _Atomic uint64_t extractedCount = 0;
+    _Atomic uint64_t *next = &nextIndex;
+    _Atomic uint64_t *extracted = &extractedCount;
+
+    dispatch_apply(workerCount, dispatch_get_global_queue(QOS_CLASS_UTILITY, 0), ^(size_t worker) {
+        char outputPath[PATH_MAX];
+        uint64_t index;
+        while ((index = atomic_fetch_add(next, 1)) < imageCount) {
+            DyldSharedCacheImage *image = &sharedCache->containedImages[index];
+            if (!image->path) continue;
+
+            if (_dsc_extract_output_path(outputDir, image->path, outputPath, sizeof(outputPath)) != 0) continue;
+
+            // Never overwrite a file, so that two images with the same path
+            // are not both counted.
+            if (_dsc_image_extract(sharedCache, image, outputPath, O_EXCL) >= 0) {
+                atomic_fetch_add(extracted, 1);
+            }
+        }
+    });
+
+    return extractedCount;
+}
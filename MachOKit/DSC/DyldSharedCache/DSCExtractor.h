@@ -0,0 +1,67 @@
+//
+//  DSCExtractor.h
+//  MachOKit
+//
+//  Builds a standalone Mach-O from an image in the shared cache.  The output
+//  layout (rewritten load commands, segment placement and a rebuilt
+//  __LINKEDIT) is computed up front as a list of chunks; writing is then a
+//  single pass of positioned writes with no intermediate copies.
+//
+
+#ifndef DSC_EXTRACTOR_H
+#define DSC_EXTRACTOR_H
+
+#include "DyldSharedCache.h"
+
+typedef struct DSCExtractChunk {
+    // Offset of the chunk in the output file.
+    uint64_t dstOffset;
+    uint64_t size;
+    // Source bytes when they are mapped (or owned by the layout).
+    const void *src;
+    // Otherwise the chunk is copied from the cache file at fileOffset.
+    DyldSharedCacheFile *file;
+    uint64_t fileOffset;
+} DSCExtractChunk;
+
+typedef struct DSCExtractLayout {
+    uint64_t fileSize;
+    // Chunks, sorted by dstOffset and never overlapping.
+    unsigned chunkCount;
+    unsigned chunkCapacity;
+    DSCExtractChunk *chunks;
+    // Rewritten mach_header_64 and load commands.
+    void *header;
+    uint32_t headerSize;
+    // Rebuilt symbol table and compacted string pool.
+    void *symbols;
+    char *strings;
+    // Bytes of the image that are not in any mapping of the cache.  They are
+    // left zero filled in the output.
+    uint64_t unmappedSize;
+} DSCExtractLayout;
+
+// Returned by dsc_image_extract() when the image was written but some of its
+// ranges were not in the cache and were left zero filled.
+#define DSC_EXTRACT_INCOMPLETE 1
+
+// Computes the output layout for a 64-bit image.  Returns 0 on success, or
+// -1 with errno set.
+int dsc_image_build_extract_layout(DyldSharedCache *sharedCache, DyldSharedCacheImage *image, DSCExtractLayout *layoutOut);
+// Writes a layout to fd, which must be open for writing.  Returns 0 on
+// success, or -1 with errno set.
+int dsc_extract_layout_write(DSCExtractLayout *layout, int fd);
+void dsc_extract_layout_free(DSCExtractLayout *layout);
+
+// Extracts a single image to outputPath.  Returns 0 on success,
+// DSC_EXTRACT_INCOMPLETE if the layout has unmapped ranges, or -1 on failure.
+// errno is set if the output could not be written.
+int dsc_image_extract(DyldSharedCache *sharedCache, DyldSharedCacheImage *image, const char *outputPath);
+// Extracts every image in the cache into outputDir using at most workerCount
+// concurrent workers (0 selects one per online CPU).  Each image is written
+// to its install path under outputDir.  An image whose output file already
+// exists is skipped.  Returns the number of files written, including
+// incomplete ones.
+uint64_t dsc_extract_images(DyldSharedCache *sharedCache, const char *outputDir, unsigned workerCount);
+
+#endif /* DSC_EXTRACTOR_H */
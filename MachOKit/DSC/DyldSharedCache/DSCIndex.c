@@ -0,0 +1,474 @@
+//
+//  DSCIndex.c
+//  MachOKit
+//
+
+#include "DSCIndex.h"
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <limits.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/param.h>
+#include <sys/stat.h>
+#include <mach-o/loader.h>
+#include <mach-o/nlist.h>
+
+static int _dsc_index_path(DyldSharedCache *sharedCache, const char *indexDirectory, char *pathOut, size_t pathSize)
+{
+    uuid_string_t uuidString;
+    uuid_unparse_upper(sharedCache->files[0]->header.uuid, uuidString);
+    // The file count distinguishes caches opened with and without .symbols.
+    int length = snprintf(pathOut, pathSize, "%s/%s.%u.dscindex", indexDirectory, uuidString, sharedCache->fileCount);
+    return (length < 0 || (size_t)length >= pathSize) ? -1 : 0;
+}
+
+static bool _dsc_index_range_valid(const struct dsc_index_header *header, uint64_t offset, uint64_t count, uint64_t elementSize)
+{
+    if (elementSize && count > UINT64_MAX / elementSize) return false;
+    uint64_t size = count * elementSize;
+    return offset <= header->totalSize && size <= header->totalSize - offset;
+}
+
+DyldSharedCacheIndex *dsc_index_open(DyldSharedCache *sharedCache, const char *indexDirectory)
+{
+    char path[PATH_MAX];
+    if (!indexDirectory || sharedCache->fileCount == 0) return NULL;
+    if (_dsc_index_path(sharedCache, indexDirectory, path, sizeof(path)) != 0) return NULL;
+
+    int fd = open(path, O_RDONLY);
+    if (fd < 0) return NULL;
+
+    struct stat sb;
+    if (fstat(fd, &sb) != 0 || sb.st_size < (off_t)sizeof(struct dsc_index_header)) {
+        close(fd);
+        return NULL;
+    }
+
+    void *base = mmap(NULL, (size_t)sb.st_size, PROT_READ, MAP_FILE | MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (base == MAP_FAILED) return NULL;
+
+    const struct dsc_index_header *header = base;
+    if (memcmp(header->magic, DSC_INDEX_MAGIC, sizeof(header->magic)) != 0
+        || header->version != DSC_INDEX_VERSION
+        || header->totalSize != (uint64_t)sb.st_size
+        || header->fileCount != sharedCache->fileCount
+        || !_dsc_index_range_valid(header, header->uuidsOffset, header->fileCount, sizeof(uuid_t))
+        || !_dsc_index_range_valid(header, header->imagesOffset, header->imageCount, sizeof(struct dsc_index_image))
+        || !_dsc_index_range_valid(header, header->addressIndexOffset, header->imageCount, sizeof(uint32_t))
+        || !_dsc_index_range_valid(header, header->addressMaxEndOffset, header->imageCount, sizeof(uint64_t))
+        || !_dsc_index_range_valid(header, header->pathIndexOffset, header->imageCount, sizeof(uint32_t))
+        || !_dsc_index_range_valid(header, header->symbolsOffset, header->symbolCount, sizeof(struct dsc_index_symbol))
+        || !_dsc_index_range_valid(header, header->stringsOffset, header->stringsSize, 1)
+        || header->stringsSize == 0) {
+        goto fail;
+    }
+
+    // Every file making up the cache must be the one the index was built from.
+    const uuid_t *uuids = (const uuid_t *)((uintptr_t)base + header->uuidsOffset);
+    for (unsigned i = 0; i < sharedCache->fileCount; i++) {
+        if (memcmp(uuids[i], sharedCache->files[i]->header.uuid, sizeof(uuid_t)) != 0) goto fail;
+    }
+
+    DyldSharedCacheIndex *index = calloc(1, sizeof(DyldSharedCacheIndex));
+    if (!index) goto fail;
+    index->base = base;
+    index->size = (size_t)sb.st_size;
+    index->header = header;
+    index->images = (const void *)((uintptr_t)base + header->imagesOffset);
+    index->addressIndex = (const void *)((uintptr_t)base + header->addressIndexOffset);
+    index->addressMaxEnd = (const void *)((uintptr_t)base + header->addressMaxEndOffset);
+    index->pathIndex = (const void *)((uintptr_t)base + header->pathIndexOffset);
+    index->symbols = (const void *)((uintptr_t)base + header->symbolsOffset);
+    index->strings = (const char *)((uintptr_t)base + header->stringsOffset);
+
+    if (index->strings[header->stringsSize - 1] != '\0') goto fail_index;
+    for (uint64_t i = 0; i < header->imageCount; i++) {
+        const struct dsc_index_image *image = &index->images[i];
+        if (image->pathOffset >= header->stringsSize
+            || index->addressIndex[i] >= header->imageCount
+            || index->pathIndex[i] >= header->imageCount
+            || image->symbolsStartIndex > header->symbolCount
+            || image->symbolsCount > header->symbolCount - image->symbolsStartIndex) {
+            goto fail_index;
+        }
+    }
+
+    return index;
+
+fail_index:
+    free(index);
+fail:
+    munmap(base, (size_t)sb.st_size);
+    return NULL;
+}
+
+void dsc_index_close(DyldSharedCacheIndex *index)
+{
+    if (!index) return;
+    munmap(index->base, index->size);
+    free(index);
+}
+
+int dsc_index_load_images(DyldSharedCacheIndex *index, DyldSharedCache *sharedCache)
+{
+    uint64_t imageCount = index->header->imageCount;
+    DyldSharedCacheImage *images = calloc(imageCount ?: 1, sizeof(DyldSharedCacheImage));
+    if (!images) return -1;
+
+    for (uint64_t i = 0; i < imageCount; i++) {
+        const struct dsc_index_image *indexImage = &index->images[i];
+        DyldSharedCacheImage *image = &images[i];
+
+        image->address = indexImage->address;
+        image->size = indexImage->size;
+        image->endAddr = image->address + image->size;
+        image->index = i;
+        memcpy(&image->uuid, &indexImage->uuid, sizeof(uuid_t));
+        // Served from the mapping.  dsc_free() does not free these.
+        image->path = (char *)(index->strings + indexImage->pathOffset);
+        image->nlistStartIndex = indexImage->nlistStartIndex;
+        image->nlistCount = indexImage->nlistCount;
+    }
+
+    sharedCache->containedImageCount = imageCount;
+    sharedCache->containedImages = images;
+    return 0;
+}
+
+bool dsc_index_contains(DyldSharedCacheIndex *index, const void *ptr)
+{
+    if (!index) return false;
+    uintptr_t address = (uintptr_t)ptr;
+    return address >= (uintptr_t)index->base && address < (uintptr_t)index->base + index->size;
+}
+
+//----------------------------------------------------------------------------//
+#pragma mark -  Lookup
+//----------------------------------------------------------------------------//
+
+// Returns the number of addressIndex entries for images starting at or below
+// address.
+static uint64_t _dsc_index_address_upper_bound(DyldSharedCacheIndex *index, uint64_t address)
+{
+    uint64_t low = 0, high = index->header->imageCount;
+    while (low < high) {
+        uint64_t mid = low + (high - low) / 2;
+        if (index->images[index->addressIndex[mid]].address <= address) {
+            low = mid + 1;
+        } else {
+            high = mid;
+        }
+    }
+    return low;
+}
+
+DyldSharedCacheImage *dsc_index_lookup_image_by_address(DyldSharedCacheIndex *index, DyldSharedCache *sharedCache, uint64_t address)
+{
+    // Any image starting at or below address may cover it, not only those
+    // with the closest start.  Walk back until no earlier image reaches past
+    // address, keeping the covering image that comes last in the table.
+    uint64_t position = _dsc_index_address_upper_bound(index, address);
+    DyldSharedCacheImage *found = NULL;
+    while (position > 0 && index->addressMaxEnd[position - 1] > address) {
+        uint32_t imageIndex = index->addressIndex[--position];
+        DyldSharedCacheImage *image = &sharedCache->containedImages[imageIndex];
+        if (address < image->endAddr && (!found || image > found)) found = image;
+    }
+    return found;
+}
+
+DyldSharedCacheImage *dsc_index_lookup_image_by_vmaddr(DyldSharedCacheIndex *index, DyldSharedCache *sharedCache, uint64_t vmaddr)
+{
+    // Images with the same start are sorted by table index, so the last one
+    // is the one the unindexed lookup returns.
+    uint64_t position = _dsc_index_address_upper_bound(index, vmaddr);
+    if (position == 0) return NULL;
+    uint32_t imageIndex = index->addressIndex[position - 1];
+    return index->images[imageIndex].address == vmaddr ? &sharedCache->containedImages[imageIndex] : NULL;
+}
+
+DyldSharedCacheImage *dsc_index_lookup_image_by_path(DyldSharedCacheIndex *index, DyldSharedCache *sharedCache, const char *path)
+{
+    // Find the first entry not below path; equal paths are sorted by table
+    // index.
+    uint64_t low = 0, high = index->header->imageCount;
+    while (low < high) {
+        uint64_t mid = low + (high - low) / 2;
+        uint32_t imageIndex = index->pathIndex[mid];
+        if (strcmp(index->strings + index->images[imageIndex].pathOffset, path) < 0) {
+            low = mid + 1;
+        } else {
+            high = mid;
+        }
+    }
+    if (low == index->header->imageCount) return NULL;
+    uint32_t imageIndex = index->pathIndex[low];
+    return strcmp(index->strings + index->images[imageIndex].pathOffset, path) == 0 ? &sharedCache->containedImages[imageIndex] : NULL;
+}
+
+const struct dsc_index_symbol *dsc_index_image_symbols(DyldSharedCacheIndex *index, DyldSharedCacheImage *image, uint64_t *countOut)
+{
+    *countOut = 0;
+    if (!index || image->index >= index->header->imageCount) return NULL;
+
+    const struct dsc_index_image *indexImage = &index->images[image->index];
+    if (indexImage->symbolsCount == 0) return NULL;
+    *countOut = indexImage->symbolsCount;
+    return &index->symbols[indexImage->symbolsStartIndex];
+}
+
+const char *dsc_index_symbol_name(DyldSharedCache *sharedCache, const struct dsc_index_symbol *symbol)
+{
+    if (symbol->flags & DSC_INDEX_SYMBOL_LOCAL) {
+        if (!sharedCache->symbolFile.strings || symbol->nameRef >= sharedCache->symbolFile.stringsSize) return NULL;
+        return sharedCache->symbolFile.strings + symbol->nameRef;
+    }
+
+    DyldSharedCacheMapping *mapping = dsc_lookup_mapping(sharedCache, symbol->nameRef, 0);
+    if (!mapping || mapping->ptr == (void *)-1) return NULL;
+    return (const char *)((uintptr_t)mapping->ptr + (symbol->nameRef - mapping->vmaddr));
+}
+
+//----------------------------------------------------------------------------//
+#pragma mark -  Building
+//----------------------------------------------------------------------------//
+
+typedef struct DSCIndexBuffer {
+    uint8_t *bytes;
+    uint64_t length;
+    uint64_t capacity;
+} DSCIndexBuffer;
+
+static int _dsc_index_buffer_reserve(DSCIndexBuffer *buffer, uint64_t additional)
+{
+    if (buffer->length + additional <= buffer->capacity) return 0;
+
+    uint64_t capacity = buffer->capacity ? buffer->capacity : 4096;
+    while (capacity < buffer->length + additional) capacity *= 2;
+    uint8_t *bytes = realloc(buffer->bytes, capacity);
+    if (!bytes) return -1;
+    buffer->bytes = bytes;
+    buffer->capacity = capacity;
+    return 0;
+}
+
+static int _dsc_index_buffer_append(DSCIndexBuffer *buffer, const void *bytes, uint64_t length)
+{
+    if (_dsc_index_buffer_reserve(buffer, length) != 0) return -1;
+    memcpy(buffer->bytes + buffer->length, bytes, length);
+    buffer->length += length;
+    return 0;
+}
+
+static int _dsc_index_symbol_compare(const void *a, const void *b)
+{
+    const struct dsc_index_symbol *symbolA = a;
+    const struct dsc_index_symbol *symbolB = b;
+    if (symbolA->address < symbolB->address) return -1;
+    if (symbolA->address > symbolB->address) return 1;
+    return 0;
+}
+
+// Appends the defined external symbols from the image's own symbol table.
+static int _dsc_index_append_exports(DyldSharedCache *sharedCache, DyldSharedCacheImage *image, DSCIndexBuffer *symbols)
+{
+    struct mach_header_64 mh;
+    if (dsc_read_from_vmaddr(sharedCache, image->address, sizeof(mh), &mh) != 0 || mh.magic != MH_MAGIC_64) return 0;
+
+    uint8_t *commands = malloc(mh.sizeofcmds);
+    if (!commands) return -1;
+    if (dsc_read_from_vmaddr(sharedCache, image->address + sizeof(mh), mh.sizeofcmds, commands) != 0) {
+        free(commands);
+        return 0;
+    }
+
+    struct symtab_command *symtab = NULL;
+    struct segment_command_64 *linkEdit = NULL;
+    for (uint8_t *p = commands; p + sizeof(struct load_command) <= commands + mh.sizeofcmds; p += ((struct load_command *)p)->cmdsize) {
+        struct load_command *lc = (struct load_command *)p;
+        if (lc->cmdsize < sizeof(struct load_command) || p + lc->cmdsize > commands + mh.sizeofcmds) break;
+        if (lc->cmd == LC_SYMTAB) {
+            symtab = (struct symtab_command *)lc;
+        } else if (lc->cmd == LC_SEGMENT_64 && strncmp(((struct segment_command_64 *)lc)->segname, SEG_LINKEDIT, 16) == 0) {
+            linkEdit = (struct segment_command_64 *)lc;
+        }
+    }
+
+    int r = 0;
+    if (symtab && linkEdit && symtab->nsyms) {
+        uint64_t nlistAddr = linkEdit->vmaddr + (symtab->symoff - linkEdit->fileoff);
+        uint64_t stringsAddr = linkEdit->vmaddr + (symtab->stroff - linkEdit->fileoff);
+        DyldSharedCacheMapping *mapping = dsc_lookup_mapping(sharedCache, nlistAddr, (uint64_t)symtab->nsyms * sizeof(struct nlist_64));
+        if (mapping && mapping->ptr != (void *)-1) {
+            const struct nlist_64 *nlist = (const void *)((uintptr_t)mapping->ptr + (nlistAddr - mapping->vmaddr));
+            for (uint32_t i = 0; i < symtab->nsyms && r == 0; i++) {
+                if (!(nlist[i].n_type & N_EXT) || (nlist[i].n_type & N_TYPE) != N_SECT) continue;
+                if (nlist[i].n_un.n_strx >= symtab->strsize) continue;
+
+                struct dsc_index_symbol symbol = {
+                    .address = nlist[i].n_value,
+                    .nameRef = stringsAddr + nlist[i].n_un.n_strx,
+                    .type = nlist[i].n_type,
+                };
+                r = _dsc_index_buffer_append(symbols, &symbol, sizeof(symbol));
+            }
+        }
+    }
+
+    free(commands);
+    return r;
+}
+
+// Writes the zero bytes that align the next table.  Returns true on success.
+static bool _dsc_index_write_padding(FILE *file, uint64_t length)
+{
+    static const uint8_t padding[8] = {};
+    if (length == 0) return true;
+    if (length > sizeof(padding)) return false;
+    return fwrite(padding, (size_t)length, 1, file) == 1;
+}
+
+int dsc_index_write(DyldSharedCache *sharedCache, const char *indexDirectory, bool includeSymbols)
+{
+    char path[PATH_MAX], tmpPath[PATH_MAX];
+    if (!indexDirectory || sharedCache->fileCount == 0 || sharedCache->containedImageCount > UINT32_MAX) return -1;
+    if (_dsc_index_path(sharedCache, indexDirectory, path, sizeof(path)) != 0) return -1;
+    if (snprintf(tmpPath, sizeof(tmpPath), "%s.%d.tmp", path, getpid()) >= (int)sizeof(tmpPath)) return -1;
+
+    uint64_t imageCount = sharedCache->containedImageCount;
+    struct dsc_index_image *images = calloc(imageCount ?: 1, sizeof(struct dsc_index_image));
+    uint32_t *addressIndex = calloc(imageCount ?: 1, sizeof(uint32_t));
+    uint64_t *addressMaxEnd = calloc(imageCount ?: 1, sizeof(uint64_t));
+    uint32_t *pathIndex = calloc(imageCount ?: 1, sizeof(uint32_t));
+    DSCIndexBuffer strings = {}, symbols = {};
+    int r = -1;
+    FILE *file = NULL;
+
+    if (!images || !addressIndex || !addressMaxEnd || !pathIndex) goto out;
+    // Offset 0 is the empty string.
+    if (_dsc_index_buffer_append(&strings, "", 1) != 0) goto out;
+
+    for (uint64_t i = 0; i < imageCount; i++) {
+        DyldSharedCacheImage *image = &sharedCache->containedImages[i];
+        struct dsc_index_image *indexImage = &images[i];
+
+        indexImage->address = image->address;
+        indexImage->size = image->size;
+        memcpy(&indexImage->uuid, &image->uuid, sizeof(uuid_t));
+        indexImage->nlistStartIndex = image->nlistStartIndex;
+        indexImage->nlistCount = image->nlistCount;
+        if (image->path) {
+            indexImage->pathOffset = strings.length;
+            if (_dsc_index_buffer_append(&strings, image->path, strlen(image->path) + 1) != 0) goto out;
+        }
+        addressIndex[i] = pathIndex[i] = (uint32_t)i;
+
+        if (!includeSymbols) continue;
+
+        uint64_t start = symbols.length / sizeof(struct dsc_index_symbol);
+        DSCIndexBuffer *symbolsBuffer = &symbols;
+        __block int appendResult = 0;
+        if (image->nlistCount && sharedCache->symbolFile.strings) {
+            char *stringTable = sharedCache->symbolFile.strings;
+            dsc_image_enumerate_symbols(sharedCache, image, ^(const char *name, uint8_t type, uint64_t vmaddr, bool *stop) {
+                // Debugging entries carry no address worth indexing.
+                if (!name || (type & N_STAB) || (type & N_TYPE) != N_SECT) return;
+                struct dsc_index_symbol symbol = {
+                    .address = vmaddr,
+                    .nameRef = (uint64_t)(name - stringTable),
+                    .type = type,
+                    .flags = DSC_INDEX_SYMBOL_LOCAL,
+                };
+                if ((appendResult = _dsc_index_buffer_append(symbolsBuffer, &symbol, sizeof(symbol))) != 0) *stop = true;
+            });
+        }
+        if (appendResult != 0 || _dsc_index_append_exports(sharedCache, image, &symbols) != 0) goto out;
+
+        uint64_t count = symbols.length / sizeof(struct dsc_index_symbol) - start;
+        qsort(symbols.bytes + start * sizeof(struct dsc_index_symbol), count, sizeof(struct dsc_index_symbol), _dsc_index_symbol_compare);
+        indexImage->symbolsStartIndex = start;
+        indexImage->symbolsCount = count;
+    }
+
+    // Ties are broken by table index so that lookups agree with the
+    // unindexed ones when images overlap or share a path.
+    DyldSharedCacheImage *containedImages = sharedCache->containedImages;
+    qsort_b(addressIndex, imageCount, sizeof(uint32_t), ^int(const void *a, const void *b) {
+        uint32_t indexA = *(const uint32_t *)a, indexB = *(const uint32_t *)b;
+        uint64_t addressA = containedImages[indexA].address;
+        uint64_t addressB = containedImages[indexB].address;
+        if (addressA != addressB) return (addressA > addressB) - (addressA < addressB);
+        return (indexA > indexB) - (indexA < indexB);
+    });
+    qsort_b(pathIndex, imageCount, sizeof(uint32_t), ^int(const void *a, const void *b) {
+        uint32_t indexA = *(const uint32_t *)a, indexB = *(const uint32_t *)b;
+        int r = strcmp(containedImages[indexA].path ?: "", containedImages[indexB].path ?: "");
+        if (r != 0) return r;
+        return (indexA > indexB) - (indexA < indexB);
+    });
+    for (uint64_t i = 0, maxEnd = 0; i < imageCount; i++) {
+        maxEnd = MAX(maxEnd, containedImages[addressIndex[i]].endAddr);
+        addressMaxEnd[i] = maxEnd;
+    }
+
+    struct dsc_index_header header = {
+        .version = DSC_INDEX_VERSION,
+        .fileCount = sharedCache->fileCount,
+        .imageCount = imageCount,
+        .symbolCount = symbols.length / sizeof(struct dsc_index_symbol),
+        .stringsSize = strings.length,
+    };
+    memcpy(header.magic, DSC_INDEX_MAGIC, sizeof(header.magic));
+    header.uuidsOffset = sizeof(header);
+    header.imagesOffset = header.uuidsOffset + (((uint64_t)header.fileCount * sizeof(uuid_t) + 7) & ~7ULL);
+    header.addressIndexOffset = header.imagesOffset + imageCount * sizeof(struct dsc_index_image);
+    header.addressMaxEndOffset = (header.addressIndexOffset + imageCount * sizeof(uint32_t) + 7) & ~7ULL;
+    header.pathIndexOffset = header.addressMaxEndOffset + imageCount * sizeof(uint64_t);
+    header.symbolsOffset = (header.pathIndexOffset + imageCount * sizeof(uint32_t) + 7) & ~7ULL;
+    header.stringsOffset = header.symbolsOffset + symbols.length;
+    header.totalSize = header.stringsOffset + strings.length;
+
+    file = fopen(tmpPath, "wb");
+    if (!file) goto out;
+
+    bool ok = fwrite(&header, sizeof(header), 1, file) == 1;
+    for (unsigned i = 0; ok && i < sharedCache->fileCount; i++) {
+        ok = fwrite(sharedCache->files[i]->header.uuid, sizeof(uuid_t), 1, file) == 1;
+    }
+    ok = ok && _dsc_index_write_padding(file, header.imagesOffset - header.uuidsOffset - (uint64_t)header.fileCount * sizeof(uuid_t));
+    ok = ok && fwrite(images, sizeof(struct dsc_index_image), imageCount, file) == imageCount;
+    ok = ok && fwrite(addressIndex, sizeof(uint32_t), imageCount, file) == imageCount;
+    ok = ok && _dsc_index_write_padding(file, header.addressMaxEndOffset - header.addressIndexOffset - imageCount * sizeof(uint32_t));
+    ok = ok && fwrite(addressMaxEnd, sizeof(uint64_t), imageCount, file) == imageCount;
+    ok = ok && fwrite(pathIndex, sizeof(uint32_t), imageCount, file) == imageCount;
+    ok = ok && _dsc_index_write_padding(file, header.symbolsOffset - header.pathIndexOffset - imageCount * sizeof(uint32_t));
+    ok = ok && fwrite(symbols.bytes, 1, symbols.length, file) == symbols.length;
+    ok = ok && fwrite(strings.bytes, 1, strings.length, file) == strings.length;
+    ok = (fclose(file) == 0) && ok;
+    file = NULL;
+
+    // Publish atomically so a concurrent reader never maps a partial index.
+    if (ok && rename(tmpPath, path) == 0) {
+        r = 0;
+    } else {
+        unlink(tmpPath);
+    }
+
+out:
+    if (file) {
+        fclose(file);
+        unlink(tmpPath);
+    }
+    free(images);
+    free(addressIndex);
+    free(addressMaxEnd);
+    free(pathIndex);
+    free(strings.bytes);
+    free(symbols.bytes);
+    return r;
+}
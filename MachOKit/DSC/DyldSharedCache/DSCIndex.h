@@ -0,0 +1,99 @@
+//
+//  DSCIndex.h
+//  MachOKit
+//
+//  Persistent index of a shared cache's image table, keyed by the UUID of the
+//  main cache file and validated against the UUIDs of every subcache.  The
+//  index is mmap'd read-only so reopening a known cache skips rebuilding the
+//  image table, reading path strings and matching local symbol entries.
+//
+
+#ifndef DSC_INDEX_H
+#define DSC_INDEX_H
+
+#include "DyldSharedCache.h"
+
+#define DSC_INDEX_MAGIC "dscindex"
+#define DSC_INDEX_VERSION 2
+
+struct dsc_index_header {
+    char magic[8];
+    uint32_t version;
+    uint32_t fileCount;             // main cache, subcaches and .symbols file
+    uint64_t totalSize;
+    uint64_t uuidsOffset;           // uuid_t[fileCount]
+    uint64_t imageCount;
+    uint64_t imagesOffset;          // struct dsc_index_image[imageCount]
+    uint64_t addressIndexOffset;    // uint32_t[imageCount], sorted by address, then image index
+    uint64_t addressMaxEndOffset;   // uint64_t[imageCount], highest end address up to each addressIndex entry
+    uint64_t pathIndexOffset;       // uint32_t[imageCount], sorted by path, then image index
+    uint64_t symbolCount;
+    uint64_t symbolsOffset;         // struct dsc_index_symbol[symbolCount]
+    uint64_t stringsOffset;
+    uint64_t stringsSize;
+};
+
+struct dsc_index_image {
+    uint64_t address;
+    uint64_t size;
+    uuid_t uuid;
+    uint64_t pathOffset;            // into the index string pool
+    uint32_t nlistStartIndex;
+    uint32_t nlistCount;
+    uint64_t symbolsStartIndex;     // this image's symbols, sorted by address
+    uint64_t symbolsCount;
+};
+
+// The symbol came from the .symbols file; nameRef is an offset into its
+// string pool.  Otherwise the symbol is an export from the image's own
+// symbol table and nameRef is the vmaddr of its name.
+#define DSC_INDEX_SYMBOL_LOCAL 0x1
+
+struct dsc_index_symbol {
+    uint64_t address;
+    uint64_t nameRef;
+    uint8_t type;
+    uint8_t flags;
+    uint8_t reserved[6];
+};
+
+typedef struct DyldSharedCacheIndex {
+    void *base;
+    size_t size;
+    const struct dsc_index_header *header;
+    const struct dsc_index_image *images;
+    const uint32_t *addressIndex;
+    const uint64_t *addressMaxEnd;
+    const uint32_t *pathIndex;
+    const struct dsc_index_symbol *symbols;
+    const char *strings;
+} DyldSharedCacheIndex;
+
+// Maps the index for sharedCache from indexDirectory.  Returns NULL if there is
+// no index, or if it is stale, truncated or from another version.
+DyldSharedCacheIndex *dsc_index_open(DyldSharedCache *sharedCache, const char *indexDirectory);
+// Writes an index for sharedCache into indexDirectory.  Per-image symbol
+// indexes are included when includeSymbols is set.  Returns 0 on success.
+int dsc_index_write(DyldSharedCache *sharedCache, const char *indexDirectory, bool includeSymbols);
+void dsc_index_close(DyldSharedCacheIndex *index);
+
+// Fills the shared cache's image table from the index.  Image paths point into
+// the index mapping and are not owned by the image table.  Returns 0 on
+// success.
+int dsc_index_load_images(DyldSharedCacheIndex *index, DyldSharedCache *sharedCache);
+// Returns true if ptr points into the index mapping.
+bool dsc_index_contains(DyldSharedCacheIndex *index, const void *ptr);
+
+// These return the same image as the unindexed lookups in DyldSharedCache.m
+// when images overlap: the last covering image in table order for addresses,
+// and the first matching image for paths.
+DyldSharedCacheImage *dsc_index_lookup_image_by_address(DyldSharedCacheIndex *index, DyldSharedCache *sharedCache, uint64_t address);
+DyldSharedCacheImage *dsc_index_lookup_image_by_vmaddr(DyldSharedCacheIndex *index, DyldSharedCache *sharedCache, uint64_t vmaddr);
+DyldSharedCacheImage *dsc_index_lookup_image_by_path(DyldSharedCacheIndex *index, DyldSharedCache *sharedCache, const char *path);
+
+// Returns the symbols indexed for image, sorted by address, or NULL if the
+// index holds none.
+const struct dsc_index_symbol *dsc_index_image_symbols(DyldSharedCacheIndex *index, DyldSharedCacheImage *image, uint64_t *countOut);
+const char *dsc_index_symbol_name(DyldSharedCache *sharedCache, const struct dsc_index_symbol *symbol);
+
+#endif /* DSC_INDEX_H */
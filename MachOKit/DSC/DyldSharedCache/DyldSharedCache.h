@@ -11,6 +11,7 @@
 
 typedef struct MachO MachO;
 typedef struct Fat Fat;
+typedef struct DyldSharedCacheIndex DyldSharedCacheIndex;
 
 #define UUID_NULL (uuid_t){0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0}
 
@@ -66,6 +67,9 @@ typedef struct DyldSharedCache {
 
 	uint64_t containedImageCount;
 	DyldSharedCacheImage *containedImages;
+
+	// Persistent index the image table was loaded from, if any.
+	DyldSharedCacheIndex *index;
 } DyldSharedCache;
 
 /*
@@ -82,6 +86,9 @@ typedef struct DyldSharedCachePointer {
 
 DyldSharedCache *dsc_init_from_path_premapped(const char *path, uint32_t premapSlide, bool load_sym);
 DyldSharedCache *dsc_init_from_path(const char *path, bool load_sym);
+// Like dsc_init_from_path, but loads the image table from a persistent index in
+// indexDirectory, writing one there first if it is missing or stale.
+DyldSharedCache *dsc_init_from_path_indexed(const char *path, bool load_sym, const char *indexDirectory);
 void dsc_enumerate_files(DyldSharedCache *sharedCache, void (^enumeratorBlock)(const char *filepath, size_t filesize, struct dyld_cache_header *header));
 
 DyldSharedCacheMapping *dsc_lookup_mapping(DyldSharedCache *sharedCache, uint64_t vmaddr, uint64_t size);
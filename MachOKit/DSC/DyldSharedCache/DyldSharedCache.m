@@ -5,6 +5,7 @@
 #include <sys/stat.h>
 #include <mach-o/nlist.h>
 #include "Util.h"
+#include "DSCIndex.h"
 
 DyldSharedCacheMapping *dsc_lookup_mapping(DyldSharedCache *sharedCache, uint64_t vmaddr, uint64_t size)
 {
@@ -37,12 +38,11 @@ void *dsc_find_buffer(DyldSharedCache *sharedCache, uint64_t vmaddr, uint64_t si
             struct DyldSharedCacheFile *file = mapping->file;
             
             uint64_t offset = mapping->fileoff + content_offset;
-            int fd = file->fd;
-            if (lseek(fd, offset, SEEK_SET) == -1) {
+            // pread so that images can be read from several threads at once.
+            if (pread(file->fd, buffer, size, offset) != (ssize_t)size) {
+                free(buffer);
                 return NULL;
             }
-            
-            read(file->fd, buffer, size);
             *needFree = true;
             
             return buffer;
@@ -132,8 +132,7 @@ fail:
 
 int dsc_file_read_at_offset(DyldSharedCacheFile *dscFile, uint64_t offset, size_t size, void *outBuf)
 {
-    lseek(dscFile->fd, offset, SEEK_SET);
-    return !(read(dscFile->fd, outBuf, size) == size);
+    return !(pread(dscFile->fd, outBuf, size, offset) == (ssize_t)size);
 }
 
 int dsc_file_read_string_at_offset(DyldSharedCacheFile *dscFile, uint64_t offset, char **outBuf)
@@ -142,7 +141,7 @@ int dsc_file_read_string_at_offset(DyldSharedCacheFile *dscFile, uint64_t offset
     return read_string(dscFile->fd, outBuf);
 }
 
-DyldSharedCache *dsc_init_from_path_premapped(const char *path, uint32_t premapSlide, bool load_sym)
+static DyldSharedCache *_dsc_init_from_path(const char *path, uint32_t premapSlide, bool load_sym, const char *indexDirectory)
 {
     if (!path) return NULL;
 
@@ -307,8 +306,18 @@ DyldSharedCache *dsc_init_from_path_premapped(const char *path, uint32_t premapS
         }
     }
 
+    if (indexDirectory) {
+        sharedCache->index = dsc_index_open(sharedCache, indexDirectory);
+        if (sharedCache->index && dsc_index_load_images(sharedCache->index, sharedCache) != 0) {
+            dsc_index_close(sharedCache->index);
+            sharedCache->index = NULL;
+        }
+    }
+
     uint64_t n_imageText = mainHeader->imagesTextCount;
-    if (n_imageText) {
+    if (sharedCache->index) {
+        // Image table, sizes, paths and local symbol ranges came from the index.
+    } else if (n_imageText) {
         struct dyld_cache_image_text_info imageTexts[n_imageText];
         dsc_file_read_at_offset(mainFile, mainHeader->imagesTextOffset, sizeof(imageTexts), imageTexts);
         
@@ -405,7 +414,7 @@ DyldSharedCache *dsc_init_from_path_premapped(const char *path, uint32_t premapS
             struct dyld_cache_local_symbols_info symbolsInfo;
             dsc_file_read_at_offset(symbolCacheFile, sym_off, sizeof(symbolsInfo), &symbolsInfo);
 
-            for (uint64_t i = 0; i < symbolsInfo.entriesCount; i++) {
+            for (uint64_t i = 0; i < symbolsInfo.entriesCount && !sharedCache->index; i++) {
                 uint64_t dylibOffset = 0;
                 uint32_t nlistStartIndex = 0;
                 uint32_t nlistCount = 0;
@@ -456,14 +465,31 @@ DyldSharedCache *dsc_init_from_path_premapped(const char *path, uint32_t premapS
         }
     }
 
+    if (indexDirectory && !sharedCache->index) {
+        // Failing to write the index only costs the next open its speedup.
+        if (dsc_index_write(sharedCache, indexDirectory, load_sym) == 0) {
+            sharedCache->index = dsc_index_open(sharedCache, indexDirectory);
+        }
+    }
+
     return sharedCache;
 }
 
+DyldSharedCache *dsc_init_from_path_premapped(const char *path, uint32_t premapSlide, bool load_sym)
+{
+    return _dsc_init_from_path(path, premapSlide, load_sym, NULL);
+}
+
 DyldSharedCache *dsc_init_from_path(const char *path, bool load_sym)
 {
     return dsc_init_from_path_premapped(path, 0, load_sym);
 }
 
+DyldSharedCache *dsc_init_from_path_indexed(const char *path, bool load_sym, const char *indexDirectory)
+{
+    return _dsc_init_from_path(path, 0, load_sym, indexDirectory);
+}
+
 void dsc_enumerate_files(DyldSharedCache *sharedCache, void (^enumeratorBlock)(const char *filepath, size_t filesize, struct dyld_cache_header *header))
 {
     for (int i = 0; i < sharedCache->fileCount; i++) {
@@ -473,6 +499,9 @@ void dsc_enumerate_files(DyldSharedCache *sharedCache, void (^enumeratorBlock)(c
 
 DyldSharedCacheImage *dsc_lookup_image_by_path(DyldSharedCache *sharedCache, const char *path)
 {
+    if (sharedCache->index) {
+        return dsc_index_lookup_image_by_path(sharedCache->index, sharedCache, path);
+    }
     for (unsigned i = 0; i < sharedCache->containedImageCount; i++) {
         if (!strcmp(sharedCache->containedImages[i].path, path)) {
             return &sharedCache->containedImages[i];
@@ -525,6 +554,9 @@ DyldSharedCacheImage *dsc_lookup_image_by_path(DyldSharedCache *sharedCache, con
 
 DyldSharedCacheImage *dsc_lookup_image_by_address(DyldSharedCache *sharedCache, uint64_t address)
 {
+    if (sharedCache->index) {
+        return dsc_index_lookup_image_by_address(sharedCache->index, sharedCache, address);
+    }
     DyldSharedCacheImage *image = NULL;
     uint64_t count = sharedCache->containedImageCount;
     for (int64_t i = 0; i < count; i++) {
@@ -538,6 +570,9 @@ DyldSharedCacheImage *dsc_lookup_image_by_address(DyldSharedCache *sharedCache,
 
 DyldSharedCacheImage *dsc_lookup_image_by_vmaddr(DyldSharedCache *sharedCache, uint64_t vmaddr)
 {
+    if (sharedCache->index) {
+        return dsc_index_lookup_image_by_vmaddr(sharedCache->index, sharedCache, vmaddr);
+    }
     DyldSharedCacheImage *image = NULL;
     uint64_t count = sharedCache->containedImageCount;
     for (int64_t i = 0; i < count; i++) {
@@ -658,7 +693,8 @@ void dsc_free(DyldSharedCache *sharedCache)
     }
     if (sharedCache->containedImages) {
         for (unsigned i = 0; i < sharedCache->containedImageCount; i++) {
-            if (sharedCache->containedImages[i].path) {
+            // Paths loaded from the index point into its mapping.
+            if (sharedCache->containedImages[i].path && !dsc_index_contains(sharedCache->index, sharedCache->containedImages[i].path)) {
                 free(sharedCache->containedImages[i].path);
             }
             if (sharedCache->containedImages[i].fat) {
@@ -675,5 +711,6 @@ void dsc_free(DyldSharedCache *sharedCache)
     if (sharedCache->symbolFile.nlist) {
         free(sharedCache->symbolFile.nlist);
     }
+    dsc_index_close(sharedCache->index);
     free(sharedCache);
 }
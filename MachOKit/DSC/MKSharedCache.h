@@ -85,7 +85,12 @@ typedef NS_OPTIONS(NSUInteger, MKSharedCacheFlags) {
     MKDSCLocalSymbols *_localSymbols;
 }
 
-- (nullable instancetype)initWithFlags:(MKSharedCacheFlags)flags url:(NSURL *)url NS_DESIGNATED_INITIALIZER;
+//! Initializes the shared cache at \a url.  When \a indexURL names a
+//! directory, the image table is loaded from a persistent index there keyed
+//! by the cache UUID, and the index is written on first use.
+- (nullable instancetype)initWithFlags:(MKSharedCacheFlags)flags url:(NSURL *)url indexURL:(nullable NSURL *)indexURL NS_DESIGNATED_INITIALIZER;
+
+- (nullable instancetype)initWithFlags:(MKSharedCacheFlags)flags url:(NSURL *)url;
 
 //◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦//
 #pragma mark -  Getting Shared Cache Metadata
@@ -125,6 +130,19 @@ typedef NS_OPTIONS(NSUInteger, MKSharedCacheFlags) {
 
 - (MKDSCMapping *)findMapping:(uint64_t)vmaddr;
 - (NSArray <MKDSCImage *> *)sortedImages;
+
+//◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦//
+#pragma mark -  Extracting Images
+//! @name       Extracting Images
+//◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦//
+
+//! Writes every image in the shared cache to \a path as a standalone
+//! Mach-O, using at most \a workerCount concurrent workers.  Pass \c 0 to
+//! use one worker per online CPU.  Each image is written to its install
+//! path under \a path, and existing files are never overwritten.  Blocks
+//! until all images are written and returns the number of images extracted.
+- (NSUInteger)extractImagesToPath:(NSString *)path workerCount:(NSUInteger)workerCount;
+
 @end
 
 NS_ASSUME_NONNULL_END
@@ -38,6 +38,7 @@
 #include "dyld_cache_format.h"
 #include <objc/runtime.h>
 #import "DyldSharedCache.h"
+#import "DSCExtractor.h"
 
 #if __has_include(<mach/shared_region.h>)
 #include <mach/shared_region.h>
@@ -59,7 +60,12 @@
 //----------------------------------------------------------------------------//
 @implementation MKSharedCache
 
-- (instancetype)initWithFlags:(MKSharedCacheFlags)flags url:(NSURL *)url {
+//|++++++++++++++++++++++++++++++++++++|//
+- (instancetype)initWithFlags:(MKSharedCacheFlags)flags url:(NSURL *)url
+{ return [self initWithFlags:flags url:url indexURL:nil]; }
+
+//|++++++++++++++++++++++++++++++++++++|//
+- (instancetype)initWithFlags:(MKSharedCacheFlags)flags url:(NSURL *)url indexURL:(NSURL *)indexURL {
     NSError *tmp = nil;
     self = [super initWithParent:nil error:&tmp];
     if (self == nil) return nil;
@@ -68,7 +74,10 @@
     mk_vm_address_t sharedRegionBase;
     mk_vm_address_t contextAddress = 0;
     bool load_sym = true;
-    _dsc = dsc_init_from_path(url.path.UTF8String, load_sym);
+    if (indexURL)
+        _dsc = dsc_init_from_path_indexed(url.path.UTF8String, load_sym, indexURL.path.fileSystemRepresentation);
+    else
+        _dsc = dsc_init_from_path(url.path.UTF8String, load_sym);
     if (!_dsc) {
         return nil;
     }
@@ -399,13 +408,18 @@
         }
     }
     dispatch_async(dispatch_get_global_queue(0, 0), ^{
-        for (MKDSCImage *image in self.images) {
-            [image extractTo:path];
-        }
+        [self extractImagesToPath:path workerCount:0];
         self->_extracting = NO;
     });
 }
 
+//|++++++++++++++++++++++++++++++++++++|//
+- (NSUInteger)extractImagesToPath:(NSString *)path workerCount:(NSUInteger)workerCount
+{
+    if (_dsc == NULL) return 0;
+    return (NSUInteger)dsc_extract_images(_dsc, path.fileSystemRepresentation, (unsigned)MIN(workerCount, (NSUInteger)UINT_MAX));
+}
+
 - (BOOL)extractable {
     return YES;
 }
@@ -29,20 +29,63 @@
 #import <Foundation/Foundation.h>
 
 #import <MachOKit/MKLinkEditNode.h>
+#import <MachOKit/MKDataInCodeFieldType.h>
 
 @class MKDataInCodeEntry;
 
 NS_ASSUME_NONNULL_BEGIN
 
+//----------------------------------------------------------------------------//
+//! A data region, decoded from a \c data_in_code_entry.
+//
+typedef struct MKDataInCodeRange {
+    //! The offset from the mach_header to start of data range.
+    uint32_t offset;
+    //! The number of bytes in the data range.
+    uint16_t length;
+    MKDataInCodeEntryType kind;
+} MKDataInCodeRange;
+
+
+
 //----------------------------------------------------------------------------//
 @interface MKDataInCode : MKLinkEditNode {
 @package
     NSArray<MKDataInCodeEntry*> *_entries;
 }
 
-//! 
+//! The entry nodes.  Created the first time they are requested.
 @property (nonatomic, strong, readonly) NSArray<MKDataInCodeEntry*> *entries;
 
+//◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦//
+#pragma mark -  Ranges
+//! @name       Ranges
+//!
+//! The data regions are decoded into a table of \ref MKDataInCodeRange,
+//! sorted by offset, in a single pass over the \c LC_DATA_IN_CODE payload.
+//! An entry that overlaps a preceding entry is dropped from the table, with
+//! a warning.
+//! Lookups against the table run in O(log n) and do not instantiate any
+//! entry nodes.
+//◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦//
+
+@property (nonatomic, assign, readonly) NSUInteger rangeCount;
+@property (nonatomic, assign, readonly) const MKDataInCodeRange *ranges;
+
+//! Returns the range containing \a offset, which is relative to the
+//! mach_header, or \c NULL if \a offset is not within a data region.
+- (nullable const MKDataInCodeRange *)rangeContainingOffset:(uint32_t)offset;
+
+//! Returns the range containing the VM \a address, or \c NULL if \a address
+//! is not within a data region.
+- (nullable const MKDataInCodeRange *)rangeContainingAddress:(mk_vm_address_t)address;
+
+//! Stores the kind of the data region containing each of the \a count
+//! \a addresses into the corresponding element of \a kinds, or \c 0 if the
+//! address is not within a data region.  Ascending runs of addresses are
+//! resolved by narrowing the search from the previous match.
+- (void)classifyAddresses:(const mk_vm_address_t *)addresses count:(NSUInteger)count kinds:(MKDataInCodeEntryType *)kinds;
+
 @end
 
 NS_ASSUME_NONNULL_END
@@ -31,8 +31,51 @@
 #import "MKLCDataInCode.h"
 #import "MKDataInCodeEntry.h"
 
+#include <malloc/malloc.h>
+
+//|++++++++++++++++++++++++++++++++++++|//
+static int
+MKDataInCodeRangeCompare(const void *a, const void *b)
+{
+    uint32_t lhs = ((const MKDataInCodeRange*)a)->offset;
+    uint32_t rhs = ((const MKDataInCodeRange*)b)->offset;
+    return (lhs > rhs) - (lhs < rhs);
+}
+
+//|++++++++++++++++++++++++++++++++++++|//
+//! Returns the index of the range containing \a offset, searching from
+//! \a low, or \c NSNotFound.  \a *next receives the index of the first range
+//! starting after \a offset.
+static NSUInteger
+MKDataInCodeRangeSearch(const MKDataInCodeRange *ranges, NSUInteger count, uint32_t offset, NSUInteger low, NSUInteger *next)
+{
+    NSUInteger high = count;
+    
+    // Find the first range that starts after offset.
+    while (low < high) {
+        NSUInteger mid = low + (high - low) / 2;
+        if (ranges[mid].offset <= offset)
+            low = mid + 1;
+        else
+            high = mid;
+    }
+    
+    if (next) *next = low;
+    // Ranges do not overlap, so only the last range starting at or before
+    // offset can contain it.
+    if (low > 0 && (uint64_t)offset < (uint64_t)ranges[low - 1].offset + ranges[low - 1].length)
+        return low - 1;
+    
+    return NSNotFound;
+}
+
+
+
 //----------------------------------------------------------------------------//
-@implementation MKDataInCode
+@implementation MKDataInCode {
+    MKDataInCodeRange *_ranges;
+    NSUInteger _rangeCount;
+}
 
 //|++++++++++++++++++++++++++++++++++++|//
 - (instancetype)initWithSize:(mk_vm_size_t)size offset:(mk_vm_offset_t)offset inImage:(MKMachOImage*)image error:(NSError**)error
@@ -40,30 +83,61 @@
     self = [super initWithSize:size offset:offset inImage:image error:error];
     if (self == nil) return nil;
     
-    // Load entries
-    @autoreleasepool
+    // Decode the range table.
+    NSUInteger count = (NSUInteger)(self.nodeSize / sizeof(struct data_in_code_entry));
+    if (count > 0)
     {
-        NSMutableArray<MKDataInCodeEntry*> *entries = [[NSMutableArray alloc] init];
-        mk_vm_offset_t offset = 0;
+        _ranges = malloc(count * sizeof(MKDataInCodeRange));
+        if (_ranges == NULL) {
+            MK_ERROR_OUT = [NSError mk_errorWithDomain:MKErrorDomain code:MK_EINTERNAL_ERROR description:@"Could not allocate the data in code range table."];
+            return nil;
+        }
         
-        // Cast to mk_vm_size_t is safe; nodeSize can't be larger than UINT32_MAX.
-        while ((mk_vm_size_t)offset < self.nodeSize)
-        {
-            NSError *entryError = nil;
-            
-            MKDataInCodeEntry *entry = [[MKDataInCodeEntry alloc] initWithOffset:offset fromParent:self error:&entryError];
-            if (entry == nil) {
-                MK_PUSH_WARNING_WITH_ERROR(entries, MK_EINTERNAL_ERROR, entryError, @"Could not parse entry at offset [%" MK_VM_PRIuOFFSET "].", offset);
-                break;
+        MKDataModel *dataModel = self.dataModel;
+        __block NSError *rangesError = nil;
+        __block BOOL sorted = YES;
+        
+        [self.memoryMap remapBytesAtOffset:0 fromAddress:self.nodeContextAddress length:count * sizeof(struct data_in_code_entry) requireFull:YES withHandler:^(vm_address_t address, vm_size_t __unused length, NSError *e) {
+            if (address == 0) {
+                rangesError = e;
+                return;
             }
             
-            [entries addObject:entry];
+            const struct data_in_code_entry *entries = (const struct data_in_code_entry*)address;
             
-            // SAFE - All entry nodes must be within the size of this node.
-            offset += entry.nodeSize;
+            for (NSUInteger i = 0; i < count; i++) {
+                struct data_in_code_entry entry = entries[i];
+                MKDataInCodeRange *range = &self->_ranges[i];
+                range->offset = MKSwapLValue32(entry.offset, dataModel);
+                range->length = MKSwapLValue16(entry.length, dataModel);
+                range->kind = MKSwapLValue16(entry.kind, dataModel);
+                
+                if (i > 0 && range->offset < range[-1].offset)
+                    sorted = NO;
+            }
+        }];
+        
+        if (rangesError) {
+            MK_PUSH_WARNING_WITH_ERROR(ranges, MK_EINTERNAL_ERROR, rangesError, @"Could not map data in code entries.");
+            count = 0;
+        } else if (!sorted) {
+            // The static linker always emits sorted entries.
+            MK_PUSH_WARNING(ranges, MK_EINVALID_DATA, @"Data in code entries are not sorted by offset.");
+            qsort(_ranges, count, sizeof(MKDataInCodeRange), MKDataInCodeRangeCompare);
         }
         
-        _entries = entries;
+        // Lookups assume the ranges do not overlap.  The static linker never
+        // emits overlapping entries; keep the first of any that do.
+        NSUInteger kept = 0;
+        for (NSUInteger i = 0; i < count; i++) {
+            if (kept > 0 && _ranges[i].offset < (uint64_t)_ranges[kept - 1].offset + _ranges[kept - 1].length) {
+                MK_PUSH_WARNING(ranges, MK_EINVALID_DATA, @"Data in code entry at offset [0x%" PRIx32 "] overlaps the entry at offset [0x%" PRIx32 "].  Ignoring it.", _ranges[i].offset, _ranges[kept - 1].offset);
+                continue;
+            }
+            _ranges[kept++] = _ranges[i];
+        }
+        
+        _rangeCount = kept;
     }
     
     return self;
@@ -96,6 +170,112 @@
 - (instancetype)initWithParent:(MKNode*)parent error:(NSError**)error
 { return [self initWithImage:parent.macho error:error]; }
 
+//|++++++++++++++++++++++++++++++++++++|//
+- (void)dealloc
+{
+    free(_ranges);
+}
+
+//◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦//
+#pragma mark -  Estimating Memory Usage
+//◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦//
+
+//|++++++++++++++++++++++++++++++++++++|//
+- (NSUInteger)estimatedMemoryCost
+{
+    return super.estimatedMemoryCost + malloc_size(_ranges) + MKEstimatedMemoryCostOfNodes(_entries);
+}
+
+//◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦//
+#pragma mark -  Values
+//◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦//
+
+//|++++++++++++++++++++++++++++++++++++|//
+- (NSArray<MKDataInCodeEntry*> *)entries
+{
+    if (_entries == nil)
+    @autoreleasepool {
+        NSMutableArray<MKDataInCodeEntry*> *entries = [[NSMutableArray alloc] initWithCapacity:_rangeCount];
+        mk_vm_offset_t offset = 0;
+        
+        // Cast to mk_vm_size_t is safe; nodeSize can't be larger than UINT32_MAX.
+        while ((mk_vm_size_t)offset < self.nodeSize)
+        {
+            NSError *entryError = nil;
+            
+            MKDataInCodeEntry *entry = [[MKDataInCodeEntry alloc] initWithOffset:offset fromParent:self error:&entryError];
+            if (entry == nil) {
+                MK_PUSH_WARNING_WITH_ERROR(entries, MK_EINTERNAL_ERROR, entryError, @"Could not parse entry at offset [%" MK_VM_PRIuOFFSET "].", offset);
+                break;
+            }
+            
+            [entries addObject:entry];
+            
+            // SAFE - All entry nodes must be within the size of this node.
+            offset += entry.nodeSize;
+        }
+        
+        _entries = entries;
+    }
+    
+    return _entries;
+}
+
+//◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦//
+#pragma mark -  Ranges
+//◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦//
+
+@synthesize rangeCount = _rangeCount;
+@synthesize ranges = _ranges;
+
+//|++++++++++++++++++++++++++++++++++++|//
+- (const MKDataInCodeRange *)rangeContainingOffset:(uint32_t)offset
+{
+    NSUInteger index = MKDataInCodeRangeSearch(_ranges, _rangeCount, offset, 0, NULL);
+    return (index != NSNotFound) ? &_ranges[index] : NULL;
+}
+
+//|++++++++++++++++++++++++++++++++++++|//
+- (const MKDataInCodeRange *)rangeContainingAddress:(mk_vm_address_t)address
+{
+    mk_vm_address_t machoHeaderAddress = self.macho.nodeVMAddress;
+    // Entry offsets are 32-bit.
+    if (address < machoHeaderAddress || address - machoHeaderAddress > UINT32_MAX)
+        return NULL;
+    
+    return [self rangeContainingOffset:(uint32_t)(address - machoHeaderAddress)];
+}
+
+//|++++++++++++++++++++++++++++++++++++|//
+- (void)classifyAddresses:(const mk_vm_address_t *)addresses count:(NSUInteger)count kinds:(MKDataInCodeEntryType *)kinds
+{
+    NSParameterAssert(addresses != NULL || count == 0);
+    NSParameterAssert(kinds != NULL || count == 0);
+    
+    mk_vm_address_t machoHeaderAddress = self.macho.nodeVMAddress;
+    NSUInteger low = 0;
+    uint32_t previous = 0;
+    
+    for (NSUInteger i = 0; i < count; i++) {
+        mk_vm_address_t address = addresses[i];
+        kinds[i] = 0;
+        
+        if (address < machoHeaderAddress || address - machoHeaderAddress > UINT32_MAX)
+            continue;
+        
+        uint32_t offset = (uint32_t)(address - machoHeaderAddress);
+        if (offset < previous) low = 0;
+        previous = offset;
+        
+        NSUInteger index = MKDataInCodeRangeSearch(_ranges, _rangeCount, offset, low, &low);
+        // The range containing the next offset may start before it.
+        if (low > 0) low--;
+        
+        if (index != NSNotFound)
+            kinds[i] = _ranges[index].kind;
+    }
+}
+
 //◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦//
 #pragma mark -  MKPointer
 //◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦//
@@ -28,6 +28,7 @@
 #import "MKDataInCodeEntry.h"
 #import "MKInternal.h"
 #import "MKMachO.h"
+#import "MKNodeSerializer.h"
 
 //----------------------------------------------------------------------------//
 @implementation MKDataInCodeEntry
@@ -83,6 +84,10 @@
 - (mk_vm_size_t)nodeSize
 { return sizeof(struct data_in_code_entry); }
 
+//|++++++++++++++++++++++++++++++++++++|//
++ (BOOL)hasInvariantLayout
+{ return YES; }
+
 //|++++++++++++++++++++++++++++++++++++|//
 - (MKNodeDescription*)layout
 {
@@ -27,6 +27,7 @@
 
 #import "MKMachOImage+DataInCode.h"
 #import "MKInternal.h"
+#import "_MKMachOImage+NodeCache.h"
 
 #import "MKDataInCode.h"
 
@@ -40,20 +41,17 @@
 //|++++++++++++++++++++++++++++++++++++|//
 - (MKResult*)dataInCode
 {
-    if (_dataInCode == nil)
-    {
+    return [self _subtreeForKey:@"dataInCode" storage:&_dataInCode builder:^MKResult* {
         NSError *dataInCodeError = nil;
         
         MKDataInCode *dataInCode = [[MKDataInCode alloc] initWithParent:self error:&dataInCodeError];
         if (dataInCode)
-            _dataInCode = [[MKResult alloc] initWithValue:dataInCode];
+            return [[MKResult alloc] initWithValue:dataInCode];
         else if (dataInCodeError /* Only failed if we have an error */)
-            _dataInCode = [[MKResult alloc] initWithError:dataInCodeError];
+            return [[MKResult alloc] initWithError:dataInCodeError];
         else
-            _dataInCode = [MKResult new];
-    }
-    
-    return _dataInCode;
+            return [MKResult new];
+    }];
 }
 
 //◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦//
@@ -29,6 +29,7 @@
 #import "MKInternal.h"
 #import "MKLEB.h"
 #import "MKCString.h"
+#import "MKNodeSerializer.h"
 
 //----------------------------------------------------------------------------//
 @implementation MKExportTrieBranch
@@ -89,6 +90,10 @@
         + self.prefix.nodeSize;
 }
 
+//|++++++++++++++++++++++++++++++++++++|//
++ (BOOL)hasInvariantLayout
+{ return YES; }
+
 //|++++++++++++++++++++++++++++++++++++|//
 - (MKNodeDescription*)layout
 {
@@ -26,7 +26,7 @@
 //----------------------------------------------------------------------------//
 
 #import "MKExportsInfo.h"
-#import "NSError+MK.h"
+#import "MKInternal.h"
 #import "MKMachO.h"
 #import "MKLCDyldInfo.h"
 #import "MKExportTrieNode.h"
@@ -57,10 +57,18 @@
 		NSMutableArray<__kindof MKExportTrieNode*> *nodes = [[NSMutableArray alloc] initWithCapacity:(NSUInteger)self.nodeSize/64];
 		mk_vm_offset_t offset = 0;
 		
+		mk_budget_meter_t meter;
+		MKBudgetMeterInit(&meter, self);
+		
 		while (offset < self.nodeSize)
 		{
 			NSError *trieNodeError = nil;
 			
+			if (mk_budget_meter_charge(&meter, 0, 1, 0)) {
+				MK_PUSH_WARNING(nodes, MK_EBUDGET_EXCEEDED, @"Exceeded the work budget before the trie node at offset [%" MK_VM_PRIiOFFSET "].", offset);
+				break;
+			}
+			
 			MKExportTrieNode *node = [MKExportTrieNode nodeAtOffset:offset fromParent:self error:&trieNodeError];
 			if (node == nil) {
 				// TODO - If a malformed Mach-O added garbage data between nodes it would
@@ -91,6 +99,11 @@
 			NSMutableArray<MKExportTrieNode*> *path = [[NSMutableArray alloc] init];
 			NSMutableArray<__kindof MKNode*> *queue = [[NSMutableArray alloc] init];
 			
+			// A malformed trie may contain a cycle of branches, which would
+			// otherwise be followed forever.
+			mk_budget_meter_t meter;
+			MKBudgetMeterInit(&meter, self);
+			
 			// Seed the queue with the root node
 			[path addObject:_nodes.firstObject];
 			[queue addObject:_nodes.firstObject];
@@ -107,6 +120,11 @@
 					mk_vm_address_t targetAddress;
 					mk_error_t err;
 					
+					if (mk_budget_meter_charge(&meter, 0, 0, 1)) {
+						MK_PUSH_WARNING(exports, MK_EBUDGET_EXCEEDED, @"Exceeded the work budget at branch %@ of %@.", branch.compactDescription, branch.parent.compactDescription);
+						break;
+					}
+					
 					if ((err = mk_vm_address_apply_offset(self.nodeVMAddress, branch.offset, &targetAddress))) {
 						traversalError = MK_MAKE_VM_ADDRESS_APPLY_OFFSET_ARITHMETIC_ERROR(err, self.nodeVMAddress, branch.offset);
 						MK_PUSH_WARNING_WITH_ERROR(exports, MK_ENOT_FOUND, traversalError, @"Could not locate the trie node referenced by branch %@ of %@.", branch.compactDescription, branch.parent.compactDescription);
@@ -208,6 +226,14 @@
 	return [super childNodeOccupyingVMAddress:address targetClass:targetClass];
 }
 
+//◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦//
+#pragma mark -  Estimating Memory Usage
+//◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦//
+
+//|++++++++++++++++++++++++++++++++++++|//
+- (NSUInteger)estimatedMemoryCost
+{ return super.estimatedMemoryCost + MKEstimatedMemoryCostOfNodes(_nodes) + MKEstimatedMemoryCostOfNodes(_exports); }
+
 //◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦//
 #pragma mark -  MKNode
 //◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦//
@@ -27,6 +27,7 @@
 
 #import "MKMachO+Exports.h"
 #import "MKInternal.h"
+#import "_MKMachOImage+NodeCache.h"
 
 #import "MKExportsInfo.h"
 
@@ -40,20 +41,17 @@
 //|++++++++++++++++++++++++++++++++++++|//
 - (MKResult*)exportsInfo
 {
-    if (_exportsInfo == nil)
-    {
+    return [self _subtreeForKey:@"exportsInfo" storage:&_exportsInfo builder:^MKResult* {
         NSError *exportsInfoError = nil;
         
         MKExportsInfo *exportsInfo = [[MKExportsInfo alloc] initWithParent:self error:&exportsInfoError];
-		if (exportsInfo)
-			_exportsInfo = [[MKResult alloc] initWithValue:exportsInfo];
-		else if (exportsInfoError /* Only failed if we have an error */)
-			_exportsInfo = [[MKResult alloc] initWithError:exportsInfoError];
-		else
-			_exportsInfo = [MKResult new];
-    }
-    
-    return _exportsInfo;
+        if (exportsInfo)
+            return [[MKResult alloc] initWithValue:exportsInfo];
+        else if (exportsInfoError /* Only failed if we have an error */)
+            return [[MKResult alloc] initWithError:exportsInfoError];
+        else
+            return [MKResult new];
+    }];
 }
 
 //◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦//
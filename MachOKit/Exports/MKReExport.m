@@ -31,6 +31,7 @@
 #import "MKMachO+Libraries.h"
 #import "MKDependentLibrary.h"
 #import "MKExportTrieTerminalNode.h"
+#import "MKNodeSerializer.h"
 
 //----------------------------------------------------------------------------//
 @implementation MKReExport
@@ -85,6 +86,10 @@
 #pragma mark -  MKNode
 //◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦//
 
+//|++++++++++++++++++++++++++++++++++++|//
++ (BOOL)hasInvariantLayout
+{ return YES; }
+
 //|++++++++++++++++++++++++++++++++++++|//
 - (MKNodeDescription*)layout
 {
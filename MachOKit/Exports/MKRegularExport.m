@@ -28,6 +28,7 @@
 #import "MKRegularExport.h"
 #import "MKInternal.h"
 #import "MKExportTrieTerminalNode.h"
+#import "MKNodeSerializer.h"
 
 //----------------------------------------------------------------------------//
 @implementation MKRegularExport
@@ -65,6 +66,10 @@
 #pragma mark -  MKNode
 //◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦//
 
+//|++++++++++++++++++++++++++++++++++++|//
++ (BOOL)hasInvariantLayout
+{ return YES; }
+
 //|++++++++++++++++++++++++++++++++++++|//
 - (MKNodeDescription*)layout
 {
@@ -34,15 +34,18 @@ NS_ASSUME_NONNULL_BEGIN
 
 //----------------------------------------------------------------------------//
 //! An instance of \c MKFatArch parses the structure identifying a
-//! slice in a fat binary.
+//! slice in a fat binary.  Both \c fat_arch and \c fat_arch_64 structures
+//! are supported, determined by the magic of the parent \ref MKFatBinary.
 //
 @interface MKFatArch : MKOffsetNode {
 @package
+    BOOL _is64;
     cpu_type_t _cputype;
     cpu_subtype_t _cpusubtype;
-    uint32_t _offset;
-    uint32_t _size;
+    uint64_t _offset;
+    uint64_t _size;
     uint32_t _align;
+    uint32_t _reserved;
 }
 
 //! The architecture of the slice.
@@ -61,11 +64,13 @@ NS_ASSUME_NONNULL_BEGIN
 //! Machine specifier.
 @property (nonatomic, assign, readonly) cpu_subtype_t cpusubtype;
 //! Offset to the Mach-O identified by the slice.
-@property (nonatomic, assign, readonly) uint32_t offset;
+@property (nonatomic, assign, readonly) uint64_t offset;
 //! The size of the slice.
-@property (nonatomic, assign, readonly) uint32_t size;
+@property (nonatomic, assign, readonly) uint64_t size;
 //! The alignment of the slice.
 @property (nonatomic, assign, readonly) uint32_t align;
+//! Reserved.  Always \c 0 for a \c fat_arch structure.
+@property (nonatomic, assign, readonly) uint32_t reserved;
 
 @end
 
@@ -27,6 +27,7 @@
 
 #import "MKFatArch.h"
 #import "MKInternal.h"
+#import "MKFatBinary.h"
 #import "MKNodeFieldCPUType.h"
 #import "MKNodeFieldCPUSubType.h"
 
@@ -41,19 +42,46 @@
     self = [super initWithOffset:offset fromParent:parent error:error];
     if (self == nil) return nil;
     
-    struct fat_arch slice;
+    _is64 = [parent isKindOfClass:MKFatBinary.class] && [(MKFatBinary*)parent magic] == FAT_MAGIC_64;
+    
     NSError *memoryMapError = nil;
+    uint32_t align;
     
-    if ([self.memoryMap copyBytesAtOffset:0 fromAddress:self.nodeContextAddress into:&slice length:sizeof(slice) requireFull:YES error:&memoryMapError] < sizeof(slice)) {
-        MK_ERROR_OUT = [NSError mk_errorWithDomain:MKErrorDomain code:MK_EINTERNAL_ERROR underlyingError:memoryMapError description:@"Could not read fat_arch."];
-        return nil;
+    if (_is64) {
+        struct fat_arch_64 slice;
+        
+        if ([self.memoryMap copyBytesAtOffset:0 fromAddress:self.nodeContextAddress into:&slice length:sizeof(slice) requireFull:YES error:&memoryMapError] < sizeof(slice)) {
+            MK_ERROR_OUT = [NSError mk_errorWithDomain:MKErrorDomain code:MK_EINTERNAL_ERROR underlyingError:memoryMapError description:@"Could not read fat_arch_64."];
+            return nil;
+        }
+        
+        _cputype = MKSwapLValue32s(slice.cputype, self.dataModel);
+        _cpusubtype = MKSwapLValue32s(slice.cpusubtype, self.dataModel);
+        _offset = MKSwapLValue64(slice.offset, self.dataModel);
+        _size = MKSwapLValue64(slice.size, self.dataModel);
+        align = MKSwapLValue32(slice.align, self.dataModel);
+        _reserved = MKSwapLValue32(slice.reserved, self.dataModel);
+    } else {
+        struct fat_arch slice;
+        
+        if ([self.memoryMap copyBytesAtOffset:0 fromAddress:self.nodeContextAddress into:&slice length:sizeof(slice) requireFull:YES error:&memoryMapError] < sizeof(slice)) {
+            MK_ERROR_OUT = [NSError mk_errorWithDomain:MKErrorDomain code:MK_EINTERNAL_ERROR underlyingError:memoryMapError description:@"Could not read fat_arch."];
+            return nil;
+        }
+        
+        _cputype = MKSwapLValue32s(slice.cputype, self.dataModel);
+        _cpusubtype = MKSwapLValue32s(slice.cpusubtype, self.dataModel);
+        _offset = MKSwapLValue32(slice.offset, self.dataModel);
+        _size = MKSwapLValue32(slice.size, self.dataModel);
+        align = MKSwapLValue32(slice.align, self.dataModel);
     }
     
-    _cputype = MKSwapLValue32s(slice.cputype, self.dataModel);
-    _cpusubtype = MKSwapLValue32s(slice.cpusubtype, self.dataModel);
-    _offset = MKSwapLValue32(slice.offset, self.dataModel);
-    _size = MKSwapLValue32(slice.size, self.dataModel);
-    _align = 1 << MKSwapLValue32(slice.align, self.dataModel);
+    if (align >= 32) {
+        MK_PUSH_WARNING(align, MK_EINVALID_DATA, @"Alignment exponent [%" PRIu32 "] is out of range.", align);
+        _align = 0;
+    } else {
+        _align = (uint32_t)1 << align;
+    }
     
     return self;
 }
@@ -75,6 +103,7 @@
 @synthesize offset = _offset;
 @synthesize size = _size;
 @synthesize align = _align;
+@synthesize reserved = _reserved;
 
 //◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦//
 #pragma mark -  MKNode
@@ -82,7 +111,7 @@
 
 //|++++++++++++++++++++++++++++++++++++|//
 - (mk_vm_size_t)nodeSize
-{ return sizeof(struct fat_arch); }
+{ return _is64 ? sizeof(struct fat_arch_64) : sizeof(struct fat_arch); }
 
 //|++++++++++++++++++++++++++++++++++++|//
 - (MKNodeDescription*)layout
@@ -103,18 +132,21 @@
     cpuSubType.description = @"CPU SubType";
     cpuSubType.options = MKNodeFieldOptionDisplayAsDetail;
     
+    // The offset and size are 64-bit in a fat_arch_64.
+    id<MKNodeFieldType> wordType = _is64 ? (id<MKNodeFieldType>)MKNodeFieldTypeQuadWord.sharedInstance : MKNodeFieldTypeDoubleWord.sharedInstance;
+    
     MKNodeFieldBuilder *offset = [MKNodeFieldBuilder
         builderWithProperty:MK_PROPERTY(offset)
-        type:MKNodeFieldTypeDoubleWord.sharedInstance
-        offset:offsetof(struct fat_arch, offset)
+        type:wordType
+        offset:_is64 ? offsetof(struct fat_arch_64, offset) : offsetof(struct fat_arch, offset)
     ];
     offset.description = @"Offset";
     offset.options = MKNodeFieldOptionDisplayAsDetail;
     
     MKNodeFieldBuilder *size = [MKNodeFieldBuilder
         builderWithProperty:MK_PROPERTY(size)
-        type:MKNodeFieldTypeDoubleWord.sharedInstance
-        offset:offsetof(struct fat_arch, size)
+        type:wordType
+        offset:_is64 ? offsetof(struct fat_arch_64, size) : offsetof(struct fat_arch, size)
     ];
     size.description = @"Size";
     size.options = MKNodeFieldOptionDisplayAsDetail;
@@ -122,18 +154,32 @@
     MKNodeFieldBuilder *alignment = [MKNodeFieldBuilder
         builderWithProperty:MK_PROPERTY(align)
         type:MKNodeFieldTypeDoubleWord.sharedInstance
-        offset:offsetof(struct fat_arch, align)
+        offset:_is64 ? offsetof(struct fat_arch_64, align) : offsetof(struct fat_arch, align)
     ];
     alignment.description = @"Alignment";
     alignment.options = MKNodeFieldOptionDisplayAsDetail;
     
-    return [MKNodeDescription nodeDescriptionWithParentDescription:super.layout fields:@[
+    NSMutableArray *fields = [NSMutableArray arrayWithObjects:
         cpuType.build,
         cpuSubType.build,
         offset.build,
         size.build,
-        alignment.build
-    ]];
+        alignment.build,
+        nil
+    ];
+    
+    if (_is64) {
+        MKNodeFieldBuilder *reserved = [MKNodeFieldBuilder
+            builderWithProperty:MK_PROPERTY(reserved)
+            type:MKNodeFieldTypeDoubleWord.sharedInstance
+            offset:offsetof(struct fat_arch_64, reserved)
+        ];
+        reserved.description = @"Reserved";
+        reserved.options = MKNodeFieldOptionDisplayAsDetail;
+        [fields addObject:reserved.build];
+    }
+    
+    return [MKNodeDescription nodeDescriptionWithParentDescription:super.layout fields:fields];
 }
 
 //◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦//
@@ -30,9 +30,22 @@
 
 #import <MachOKit/MKBackedNode.h>
 @class MKFatArch;
+@class MKMachOImage;
 
 NS_ASSUME_NONNULL_BEGIN
 
+//----------------------------------------------------------------------------//
+//! @name       Image Options
+//! @relates    MKFatBinary
+//
+typedef NS_OPTIONS(NSUInteger, MKFatBinaryImageOptions) {
+    //! Parse the images concurrently.  The memory map of the fat binary must
+    //! support concurrent reads.
+    MKFatBinaryImageParseConcurrently           = 1UL << 0
+};
+
+
+
 //----------------------------------------------------------------------------//
 //! An instance of \c MKFatBinary parses the header of a 'FAT' binary, and
 //! provides interfaces to query the slices containined within.
@@ -41,19 +54,53 @@ NS_ASSUME_NONNULL_BEGIN
 @package
     MKMemoryMap *_memoryMap;
     NSArray<MKFatArch*> *_architectures;
+    NSMutableDictionary<NSNumber*, MKFatArch*> *_architecturesByIndex;
     /// fat_header ///
     uint32_t _magic;
     uint32_t _nfat_arch;
 }
 
 //! Initializes the receiver with the provided \a memoryMap.  The FAT header
-//! is expected to reside at address \c 0 in the provided memory map.
+//! is expected to reside at address \c 0 in the provided memory map.  Both
+//! \c FAT_MAGIC and \c FAT_MAGIC_64 headers are supported.
 - (nullable instancetype)initWithMemoryMap:(MKMemoryMap*)memoryMap error:(NSError**)error NS_DESIGNATED_INITIALIZER;
 
 //! An array of \ref MKFatArch instances, each represeting an architecture
-//! present in the fat binary.
+//! present in the fat binary.  Accessing this property instantiates a node
+//! for every architecture.
 @property (nonatomic, strong, readonly) NSArray<MKFatArch*> *architectures;
 
+//◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦//
+#pragma mark -  Selecting Architectures
+//! @name       Selecting Architectures
+//◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦//
+
+//! Returns the architecture at \a index, instantiating only its node.
+- (nullable MKFatArch*)architectureAtIndex:(uint32_t)index;
+
+//! Returns the architecture that best matches \a cputype and \a cpusubtype,
+//! following the rules of \c NXFindBestFatArch().  An architecture with
+//! a matching CPU type and subtype is preferred, followed by one with a
+//! matching CPU type and the \c _ALL subtype, followed by the first with a
+//! matching CPU type.  Only the node for the returned architecture is
+//! instantiated.
+- (nullable MKFatArch*)bestArchitectureForCPUType:(cpu_type_t)cputype cpuSubType:(cpu_subtype_t)cpusubtype;
+
+//! Returns the architecture that best matches \a architecture.
+- (nullable MKFatArch*)bestArchitectureFor:(mk_architecture_t)architecture;
+
+//◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦//
+#pragma mark -  Creating Images
+//! @name       Creating Images
+//◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦//
+
+//! Creates an image for the slice identified by \a architecture.
+- (nullable MKMachOImage*)imageForArchitecture:(MKFatArch*)architecture error:(NSError**)error;
+
+//! Creates an image for each slice identified by \a architectures.  The
+//! returned array matches the order of \a architectures.
+- (NSArray<MKResult<MKMachOImage*>*> *)imagesForArchitectures:(NSArray<MKFatArch*> *)architectures options:(MKFatBinaryImageOptions)options;
+
 //◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦//
 #pragma mark -  fat_header Values
 //! @name       fat_header Values
@@ -62,7 +109,7 @@ NS_ASSUME_NONNULL_BEGIN
 //!             structure without any modification or cleanup.
 //◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦//
 
-//! FAT_MAGIC
+//! FAT_MAGIC or FAT_MAGIC_64
 @property (nonatomic, assign, readonly) uint32_t magic;
 //! The number of architectures in the fat binary.
 @property (nonatomic, assign, readonly) uint32_t nfat_arch;
@@ -28,13 +28,27 @@
 #import "MKFatBinary.h"
 #import "MKInternal.h"
 #import "MKFatArch.h"
+#import "MKMachO.h"
 
 #include <mach-o/fat.h>
 
+//|++++++++++++++++++++++++++++++++++++|//
+static cpu_subtype_t
+MKFatCPUSubtypeAll(cpu_type_t cputype)
+{
+    switch (cputype) {
+        case CPU_TYPE_I386:
+        case CPU_TYPE_X86_64:
+            return CPU_SUBTYPE_X86_ALL;
+        default:
+            // CPU_SUBTYPE_ARM_ALL, CPU_SUBTYPE_ARM64_ALL, CPU_SUBTYPE_POWERPC_ALL, ...
+            return 0;
+    }
+}
+
 //----------------------------------------------------------------------------//
 @implementation MKFatBinary
 
-@synthesize architectures = _architectures;
 @synthesize magic = _magic;
 @synthesize nfat_arch = _nfat_arch;
 
@@ -60,42 +74,166 @@
     _nfat_arch = MKSwapLValue32(header.nfat_arch, self.dataModel);
     
     // Check for the proper magic value
-    if (_magic != FAT_MAGIC) {
+    if (_magic != FAT_MAGIC && _magic != FAT_MAGIC_64) {
         MK_ERROR_OUT = [NSError mk_errorWithDomain:MKErrorDomain code:MK_EINVAL description:@"Bad FAT magic [0x%" PRIx32 "].", _magic];
         return nil;
     }
     
-    // Load Architectures
-    {
-        NSMutableArray *architectures = [[NSMutableArray alloc] init];
-        mk_vm_offset_t offset = sizeof(header);
-        
-        // Cast to mk_vm_size_t is safe; nodeSize can't be larger than UINT32_MAX.
-        while ((mk_vm_size_t)offset < sizeof(struct fat_arch) * _nfat_arch)
+    // Architectures are loaded on demand.
+    _architecturesByIndex = [[NSMutableDictionary alloc] init];
+    
+    return self;
+}
+
+//|++++++++++++++++++++++++++++++++++++|//
+- (instancetype)initWithParent:(MKNode*)parent error:(NSError **)error
+{ return [self initWithMemoryMap:parent.memoryMap error:error]; }
+
+//|++++++++++++++++++++++++++++++++++++|//
+- (mk_vm_size_t)_archSize
+{ return (_magic == FAT_MAGIC_64) ? sizeof(struct fat_arch_64) : sizeof(struct fat_arch); }
+
+//◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦//
+#pragma mark -  Architectures
+//◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦//
+
+//|++++++++++++++++++++++++++++++++++++|//
+- (NSArray*)architectures
+{
+    @synchronized(self) {
+        if (_architectures == nil)
         {
-            NSError *architectureError = nil;
-            MKFatArch *arch = [[MKFatArch alloc] initWithOffset:offset fromParent:self error:&architectureError];
+            NSMutableArray *architectures = [[NSMutableArray alloc] initWithCapacity:MIN(_nfat_arch, 8u)];
             
-            if (arch == nil) {
-                MK_PUSH_WARNING_WITH_ERROR(architectures, MK_EINTERNAL_ERROR, architectureError, @"Could not parse architecture at offset [%" MK_VM_PRIuOFFSET "].", offset);
-                break;
+            for (uint32_t i = 0; i < _nfat_arch; i++)
+            {
+                NSError *architectureError = nil;
+                MKFatArch *arch = [self _architectureAtIndex:i error:&architectureError];
+                
+                if (arch == nil) {
+                    MK_PUSH_WARNING_WITH_ERROR(architectures, MK_EINTERNAL_ERROR, architectureError, @"Could not parse architecture at index [%" PRIu32 "].", i);
+                    break;
+                }
+                
+                [architectures addObject:arch];
             }
             
-            [architectures addObject:arch];
+            _architectures = architectures;
+        }
+    }
+    
+    return _architectures;
+}
+
+//|++++++++++++++++++++++++++++++++++++|//
+- (MKFatArch*)_architectureAtIndex:(uint32_t)index error:(NSError**)error
+{
+    if (index >= _nfat_arch) {
+        MK_ERROR_OUT = [NSError mk_errorWithDomain:MKErrorDomain code:MK_EOUT_OF_RANGE description:@"Architecture index [%" PRIu32 "] is out of range.", index];
+        return nil;
+    }
+    
+    // Architectures may be requested from several threads at once, e.g. by
+    // -imagesForArchitectures:options:.  Every caller must get the same node.
+    @synchronized(_architecturesByIndex) {
+        MKFatArch *arch = _architecturesByIndex[@(index)];
+        if (arch == nil) {
+            // SAFE - index < nfat_arch <= UINT32_MAX, and the entry size is small.
+            mk_vm_offset_t offset = sizeof(struct fat_header) + (mk_vm_offset_t)index * self._archSize;
             
-            // SAFE - Architecture node size is constant.
-            offset += arch.nodeSize;
+            arch = [[MKFatArch alloc] initWithOffset:offset fromParent:self error:error];
+            if (arch)
+                _architecturesByIndex[@(index)] = arch;
         }
         
-        _architectures = architectures;
+        return arch;
     }
+}
+
+//|++++++++++++++++++++++++++++++++++++|//
+- (MKFatArch*)architectureAtIndex:(uint32_t)index
+{ return [self _architectureAtIndex:index error:NULL]; }
+
+//|++++++++++++++++++++++++++++++++++++|//
+- (MKFatArch*)bestArchitectureForCPUType:(cpu_type_t)cputype cpuSubType:(cpu_subtype_t)cpusubtype
+{
+    cpu_subtype_t wantedSubtype = cpusubtype & (cpu_subtype_t)~CPU_SUBTYPE_MASK;
+    cpu_subtype_t allSubtype = MKFatCPUSubtypeAll(cputype);
+    int64_t exactMatch = -1, allMatch = -1, typeMatch = -1;
     
-    return self;
+    // Only the cputype and cpusubtype of each entry are read.  These are at
+    // the same offsets in fat_arch and fat_arch_64.
+    for (uint32_t i = 0; i < _nfat_arch; i++)
+    {
+        struct { cpu_type_t cputype; cpu_subtype_t cpusubtype; } entry;
+        mk_vm_offset_t offset = sizeof(struct fat_header) + (mk_vm_offset_t)i * self._archSize;
+        
+        if ([self.memoryMap copyBytesAtOffset:offset fromAddress:0 into:&entry length:sizeof(entry) requireFull:YES error:NULL] < sizeof(entry))
+            break;
+        
+        if (MKSwapLValue32s(entry.cputype, self.dataModel) != cputype)
+            continue;
+        
+        cpu_subtype_t subtype = MKSwapLValue32s(entry.cpusubtype, self.dataModel) & (cpu_subtype_t)~CPU_SUBTYPE_MASK;
+        if (subtype == wantedSubtype) {
+            exactMatch = i;
+            break;
+        }
+        if (allMatch < 0 && subtype == allSubtype)
+            allMatch = i;
+        if (typeMatch < 0)
+            typeMatch = i;
+    }
+    
+    int64_t best = (exactMatch >= 0) ? exactMatch : (allMatch >= 0) ? allMatch : typeMatch;
+    if (best < 0)
+        return nil;
+    
+    return [self architectureAtIndex:(uint32_t)best];
 }
 
 //|++++++++++++++++++++++++++++++++++++|//
-- (instancetype)initWithParent:(MKNode*)parent error:(NSError **)error
-{ return [self initWithMemoryMap:parent.memoryMap error:error]; }
+- (MKFatArch*)bestArchitectureFor:(mk_architecture_t)architecture
+{ return [self bestArchitectureForCPUType:mk_architecture_get_cpu_type(architecture) cpuSubType:mk_architecture_get_cpu_subtype(architecture)]; }
+
+//◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦//
+#pragma mark -  Creating Images
+//◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦//
+
+//|++++++++++++++++++++++++++++++++++++|//
+- (MKMachOImage*)imageForArchitecture:(MKFatArch*)architecture error:(NSError**)error
+{
+    NSParameterAssert(architecture.parent == self);
+    return [[MKMachOImage alloc] initWithName:NULL flags:0 atAddress:architecture.offset inMapping:self.memoryMap error:error];
+}
+
+//|++++++++++++++++++++++++++++++++++++|//
+- (NSArray*)imagesForArchitectures:(NSArray<MKFatArch*> *)architectures options:(MKFatBinaryImageOptions)options
+{
+    NSUInteger count = architectures.count;
+    __strong MKResult **results = (__strong MKResult **)calloc(count, sizeof(MKResult*));
+    if (results == NULL)
+        return @[];
+    
+    void (^parse)(size_t) = ^(size_t i) {
+        NSError *imageError = nil;
+        MKMachOImage *image = [self imageForArchitecture:architectures[i] error:&imageError];
+        results[i] = image ? [[MKResult alloc] initWithValue:image] : [[MKResult alloc] initWithError:imageError];
+    };
+    
+    if ((options & MKFatBinaryImageParseConcurrently) && count > 1)
+        dispatch_apply(count, dispatch_get_global_queue(QOS_CLASS_USER_INITIATED, 0), parse);
+    else
+        for (size_t i = 0; i < count; i++) parse(i);
+    
+    NSArray *images = [NSArray arrayWithObjects:results count:count];
+    
+    for (NSUInteger i = 0; i < count; i++)
+        results[i] = nil;
+    free(results);
+    
+    return images;
+}
 
 //◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦//
 #pragma mark -  MKNode
@@ -111,7 +249,7 @@
 
 //|++++++++++++++++++++++++++++++++++++|//
 - (mk_vm_size_t)nodeSize
-{ return sizeof(struct fat_header) + sizeof(struct fat_arch) * self.nfat_arch; }
+{ return sizeof(struct fat_header) + self._archSize * self.nfat_arch; }
 
 //|++++++++++++++++++++++++++++++++++++|//
 - (mk_vm_address_t)nodeAddress:(MKNodeAddressType)type
@@ -31,6 +31,7 @@
 #import "MKFunctionOffset.h"
 #import "MKMachO.h"
 #import "MKNode+MachO.h"
+#import "MKNodeSerializer.h"
 
 //----------------------------------------------------------------------------//
 @implementation MKFunction
@@ -86,6 +87,10 @@
 - (mk_vm_address_t)nodeAddress:(MKNodeAddressType)type
 { return [(MKBackedNode*)self.parent nodeAddress:type]; }
 
+//|++++++++++++++++++++++++++++++++++++|//
++ (BOOL)hasInvariantLayout
+{ return YES; }
+
 //|++++++++++++++++++++++++++++++++++++|//
 - (MKNodeDescription*)layout
 {
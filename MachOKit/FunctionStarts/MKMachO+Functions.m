@@ -27,6 +27,7 @@
 
 #import "MKMachO+Functions.h"
 #import "MKInternal.h"
+#import "_MKMachOImage+NodeCache.h"
 
 #import "MKFunctionStarts.h"
 
@@ -40,20 +41,17 @@
 //|++++++++++++++++++++++++++++++++++++|//
 - (MKResult*)functionStarts
 {
-    if (_functionStarts == nil)
-    {
+    return [self _subtreeForKey:@"functionStarts" storage:&_functionStarts builder:^MKResult* {
         NSError *functionStartsError = nil;
         
         MKFunctionStarts *functionStarts = [[MKFunctionStarts alloc] initWithParent:self error:&functionStartsError];
         if (functionStarts)
-            _functionStarts = [[MKResult alloc] initWithValue:functionStarts];
+            return [[MKResult alloc] initWithValue:functionStarts];
         else if (functionStartsError /* Only failed if we have an error */)
-            _functionStarts = [[MKResult alloc] initWithError:functionStartsError];
+            return [[MKResult alloc] initWithError:functionStartsError];
         else
-            _functionStarts = [MKResult new];
-    }
-    
-    return _functionStarts;
+            return [MKResult new];
+    }];
 }
 
 //◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦//
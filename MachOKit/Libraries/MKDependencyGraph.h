@@ -0,0 +1,142 @@
+//----------------------------------------------------------------------------//
+//|
+//|             MachOKit - A Lightweight Mach-O Parsing Library
+//! @file       MKDependencyGraph.h
+//!
+//! @author     D.V.
+//! @copyright  Copyright (c) 2014-2015 D.V. All rights reserved.
+//|
+//| Permission is hereby granted, free of charge, to any person obtaining a
+//| copy of this software and associated documentation files (the "Software"),
+//| to deal in the Software without restriction, including without limitation
+//| the rights to use, copy, modify, merge, publish, distribute, sublicense,
+//| and/or sell copies of the Software, and to permit persons to whom the
+//| Software is furnished to do so, subject to the following conditions:
+//|
+//| The above copyright notice and this permission notice shall be included
+//| in all copies or substantial portions of the Software.
+//|
+//| THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+//| OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+//| MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+//| IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+//| CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+//| TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+//| SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+//----------------------------------------------------------------------------//
+
+#include <MachOKit/macho.h>
+#import <Foundation/Foundation.h>
+
+@class MKMachOImage;
+@class MKDependentLibrary;
+@class MKSharedCache;
+@class MKDSCImage;
+@class MKDependencyGraphNode;
+
+NS_ASSUME_NONNULL_BEGIN
+
+//----------------------------------------------------------------------------//
+//! A dependency of an \ref MKDependencyGraphNode on another image.
+//
+@interface MKDependencyGraphEdge : NSObject
+
+//! The dependent library, from the load command of the loading image.
+@property (nonatomic, strong, readonly) MKDependentLibrary *library;
+//! The image that \ref library resolved to, or \c nil if it could not be
+//! found.  Nodes are retained by their graph, not by edges.
+@property (nonatomic, weak, readonly, nullable) MKDependencyGraphNode *node;
+
+@end
+
+
+
+//----------------------------------------------------------------------------//
+//! An image in an \ref MKDependencyGraph.  Each image is identified by its
+//! resolved path on disk, or by its install name in the shared cache.
+//
+@interface MKDependencyGraphNode : NSObject
+
+//! The resolved path of the image.  For an image in the shared cache, this
+//! is its install name.
+@property (nonatomic, strong, readonly) NSString *path;
+//! The shared cache image, if the image was found in the shared cache.
+@property (nonatomic, strong, readonly, nullable) MKDSCImage *sharedCacheImage;
+//! The parsed image, or \c nil if it could not be parsed.
+@property (nonatomic, strong, readonly, nullable) MKMachOImage *image;
+//! The error encountered parsing the image, if any.
+@property (nonatomic, strong, readonly, nullable) NSError *error;
+//! The run path search paths used to resolve \c @rpath dependencies of
+//! the image, in search order.
+@property (nonatomic, strong, readonly) NSArray<NSString*> *rpaths;
+//! The dependencies of the image, in load command order.
+@property (nonatomic, strong, readonly) NSArray<MKDependencyGraphEdge*> *dependencies;
+
+@end
+
+
+
+//----------------------------------------------------------------------------//
+//! The \c MKDependencyGraph class resolves the closure of dependent
+//! libraries of a set of root images.
+//!
+//! Install names are resolved the way dyld does: \c @executable_path
+//! against the directory of the root that the image was first reached
+//! from, \c @loader_path against the directory of the loading image, and
+//! \c @rpath against the \c LC_RPATH entries of the loading image followed
+//! by those inherited from the image that first loaded it.  Absolute
+//! install names are looked up in the shared cache, if one was provided,
+//! then on disk beneath \ref rootPath.
+//!
+//! The graph is built breadth-first.  The images at each depth are parsed
+//! concurrently, and every image is recorded in a table keyed by its
+//! resolved path.  An image reached from several roots or through several
+//! install names is parsed once, and the table is kept across calls to
+//! \ref -resolveClosureOfImagesAtURLs:.
+//!
+//! Because images are memoized, an image reached through different loaders
+//! resolves its \c @rpath dependencies using the run paths of the loader
+//! that reached it first.  Among loaders at the same depth, the first is
+//! the one that comes first in breadth-first order, and then the one whose
+//! dependency on the image comes first, so the result does not depend on
+//! the order the images are parsed in.
+//
+@interface MKDependencyGraph : NSObject
+
+//! Initializes the receiver with an optional shared cache, which is
+//! searched for absolute install names before the file system.
+- (instancetype)initWithSharedCache:(nullable MKSharedCache*)sharedCache NS_DESIGNATED_INITIALIZER;
+
+- (instancetype)init;
+
+//! A directory prepended to absolute install names when searching the
+//! file system, such as the root of an extracted device file system.
+//! Defaults to \c nil.
+@property (nonatomic, copy, nullable) NSString *rootPath;
+
+//! The architecture to select from fat binaries.  If \c 0, the
+//! architecture of the first root image is used.
+@property (nonatomic, assign) cpu_type_t cpuType;
+@property (nonatomic, assign) cpu_subtype_t cpuSubtype;
+
+//! Parses the images at \a urls and resolves their dependencies.  Returns
+//! a node for each URL, in the same order.
+- (NSArray<MKDependencyGraphNode*> *)resolveClosureOfImagesAtURLs:(NSArray<NSURL*> *)urls;
+
+//! Resolves the dependencies of an image that has already been parsed.
+//! \a path is used to expand \c @loader_path and \c @executable_path.
+- (MKDependencyGraphNode*)resolveClosureOfImage:(MKMachOImage*)image atPath:(NSString*)path;
+
+//! Returns the nodes reachable from \a node, including \a node, in
+//! breadth-first order.
+- (NSArray<MKDependencyGraphNode*> *)closureOfNode:(MKDependencyGraphNode*)node;
+
+//! Every node in the graph.
+@property (nonatomic, strong, readonly) NSArray<MKDependencyGraphNode*> *nodes;
+
+//! The number of images that have been parsed.
+@property (nonatomic, assign, readonly) NSUInteger parseCount;
+
+@end
+
+NS_ASSUME_NONNULL_END
@@ -0,0 +1,531 @@
+//----------------------------------------------------------------------------//
+//|
+//|             MachOKit - A Lightweight Mach-O Parsing Library
+//|             MKDependencyGraph.m
+//|
+//|             D.V.
+//|             Copyright (c) 2014-2015 D.V. All rights reserved.
+//|
+//| Permission is hereby granted, free of charge, to any person obtaining a
+//| copy of this software and associated documentation files (the "Software"),
+//| to deal in the Software without restriction, including without limitation
+//| the rights to use, copy, modify, merge, publish, distribute, sublicense,
+//| and/or sell copies of the Software, and to permit persons to whom the
+//| Software is furnished to do so, subject to the following conditions:
+//|
+//| The above copyright notice and this permission notice shall be included
+//| in all copies or substantial portions of the Software.
+//|
+//| THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+//| OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+//| MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+//| IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+//| CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+//| TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+//| SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+//----------------------------------------------------------------------------//
+
+
+#import "MKDependencyGraph.h"
+#import "MKInternal.h"
+#import "MKMachO.h"
+#import "MKMachO+Libraries.h"
+#import "MKMachHeader.h"
+#import "MKDependentLibrary.h"
+#import "MKLCRPath.h"
+#import "MKCString.h"
+#import "MKFatBinary.h"
+#import "MKFatArch.h"
+#import "MKSharedCache.h"
+#import "MKDSCImage.h"
+
+#include <libkern/OSByteOrder.h>
+#include <mach-o/fat.h>
+#include <sys/param.h>
+#include <stdlib.h>
+
+//----------------------------------------------------------------------------//
+@interface MKDependencyGraphEdge () {
+@package
+    MKDependentLibrary *_library;
+    __weak MKDependencyGraphNode *_node;
+}
+@end
+
+//----------------------------------------------------------------------------//
+@interface MKDependencyGraphNode () {
+@package
+    NSString *_path;
+    MKDSCImage *_sharedCacheImage;
+    MKMachOImage *_image;
+    NSError *_error;
+    NSArray<NSString*> *_rpaths;
+    NSArray<MKDependencyGraphEdge*> *_dependencies;
+    // Directory used to expand @executable_path.  Taken from the root that
+    // first reached this node.
+    NSString *_executableDirectory;
+    // Run paths from the loader that first reached this node.  Paths that
+    // were expanded from @loader_path or @executable_path name a file on
+    // disk and are not searched for beneath the root path.
+    NSArray<NSString*> *_inheritedRPaths;
+    NSArray<NSNumber*> *_inheritedRPathsOnDisk;
+    NSArray<NSNumber*> *_rpathsOnDisk;
+    // The depth at which this node was created, and the position of the
+    // edge that it inherits from: the index of the loader in its frontier
+    // in the high 32 bits, and of the dependency in the low 32 bits.
+    NSUInteger _generation;
+    uint64_t _loaderRank;
+}
+- (instancetype)_initWithPath:(NSString*)path;
+@end
+
+
+
+//----------------------------------------------------------------------------//
+@implementation MKDependencyGraphEdge
+
+@synthesize library = _library;
+@synthesize node = _node;
+
+//|++++++++++++++++++++++++++++++++++++|//
+- (NSString*)description
+{ return [NSString stringWithFormat:@"<%@ %p; %@ -> %@>", self.class, self, _library.name, _node.path]; }
+
+@end
+
+
+
+//----------------------------------------------------------------------------//
+@implementation MKDependencyGraphNode
+
+@synthesize path = _path;
+@synthesize sharedCacheImage = _sharedCacheImage;
+@synthesize image = _image;
+@synthesize error = _error;
+@synthesize rpaths = _rpaths;
+@synthesize dependencies = _dependencies;
+
+//|++++++++++++++++++++++++++++++++++++|//
+- (instancetype)_initWithPath:(NSString*)path
+{
+    self = [super init];
+    if (self == nil) return nil;
+    
+    _path = path;
+    _rpaths = @[];
+    _rpathsOnDisk = @[];
+    _inheritedRPaths = @[];
+    _inheritedRPathsOnDisk = @[];
+    _dependencies = @[];
+    
+    return self;
+}
+
+//|++++++++++++++++++++++++++++++++++++|//
+- (NSString*)description
+{ return [NSString stringWithFormat:@"<%@ %p; %@ (%lu dependencies)>", self.class, self, _path, (unsigned long)_dependencies.count]; }
+
+@end
+
+
+
+//----------------------------------------------------------------------------//
+@implementation MKDependencyGraph
+{
+    MKSharedCache *_sharedCache;
+    NSDictionary<NSString*, MKDSCImage*> *_sharedCacheImages;
+    // Guarded by @synchronized on itself.
+    NSMutableDictionary<NSString*, MKDependencyGraphNode*> *_nodesByPath;
+    NSMutableArray<MKDependencyGraphNode*> *_nodes;
+    NSUInteger _parseCount;
+    // Incremented for each frontier that is resolved.
+    NSUInteger _generation;
+}
+
+//|++++++++++++++++++++++++++++++++++++|//
+- (instancetype)initWithSharedCache:(MKSharedCache*)sharedCache
+{
+    self = [super init];
+    if (self == nil) return nil;
+    
+    _sharedCache = sharedCache;
+    _nodesByPath = [[NSMutableDictionary alloc] init];
+    _nodes = [[NSMutableArray alloc] init];
+    
+    return self;
+}
+
+//|++++++++++++++++++++++++++++++++++++|//
+- (instancetype)init
+{ return [self initWithSharedCache:nil]; }
+
+//◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦//
+#pragma mark -  Nodes
+//◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦//
+
+//|++++++++++++++++++++++++++++++++++++|//
+- (NSArray*)nodes
+{
+    @synchronized (_nodesByPath) {
+        return [_nodes copy];
+    }
+}
+
+//|++++++++++++++++++++++++++++++++++++|//
+- (NSUInteger)parseCount
+{ return __atomic_load_n(&_parseCount, __ATOMIC_RELAXED); }
+
+//|++++++++++++++++++++++++++++++++++++|//
+- (MKDependencyGraphNode*)_nodeWithPath:(NSString*)path created:(BOOL*)created
+{
+    @synchronized (_nodesByPath) {
+        MKDependencyGraphNode *node = _nodesByPath[path];
+        *created = (node == nil);
+        
+        if (node == nil) {
+            node = [[MKDependencyGraphNode alloc] _initWithPath:path];
+            _nodesByPath[path] = node;
+            [_nodes addObject:node];
+        }
+        
+        return node;
+    }
+}
+
+//|++++++++++++++++++++++++++++++++++++|//
+static NSString*
+MKDependencyGraphRealPath(NSString *path)
+{
+    char resolved[PATH_MAX];
+    if (realpath(path.fileSystemRepresentation, resolved) == NULL)
+        return nil;
+    return [[NSFileManager defaultManager] stringWithFileSystemRepresentation:resolved length:strlen(resolved)];
+}
+
+//|++++++++++++++++++++++++++++++++++++|//
+- (void)_prepareForResolution
+{
+    if (_sharedCache && _sharedCacheImages == nil) {
+        NSMutableDictionary *sharedCacheImages = [[NSMutableDictionary alloc] initWithCapacity:_sharedCache.images.count];
+        for (MKDSCImage *image in _sharedCache.images)
+            sharedCacheImages[image.name] = image;
+        _sharedCacheImages = sharedCacheImages;
+    }
+}
+
+//◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦//
+#pragma mark -  Loading Images
+//◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦//
+
+//|++++++++++++++++++++++++++++++++++++|//
+- (MKMachOImage*)_imageAtPath:(NSString*)path error:(NSError**)error
+{
+    MKMemoryMap *memoryMap = [MKMemoryMap memoryMapWithContentsOfFile:[NSURL fileURLWithPath:path] error:error];
+    if (memoryMap == nil)
+        return nil;
+    
+    uint32_t magic;
+    NSError *memoryMapError = nil;
+    
+    if ([memoryMap copyBytesAtOffset:0 fromAddress:0 into:&magic length:sizeof(magic) requireFull:YES error:&memoryMapError] < sizeof(magic)) {
+        MK_ERROR_OUT = [NSError mk_errorWithDomain:MKErrorDomain code:MK_EINVALID_DATA underlyingError:memoryMapError description:@"Could not read the magic of %@.", path];
+        return nil;
+    }
+    
+    // The fat header is always big endian.
+    magic = OSSwapBigToHostInt32(magic);
+    if (magic != FAT_MAGIC && magic != FAT_MAGIC_64)
+        return [[MKMachOImage alloc] initWithName:path.fileSystemRepresentation flags:0 atAddress:0 inMapping:memoryMap error:error];
+    
+    MKFatBinary *fatBinary = [[MKFatBinary alloc] initWithMemoryMap:memoryMap error:error];
+    if (fatBinary == nil)
+        return nil;
+    
+    MKFatArch *architecture;
+    if (self.cpuType != 0)
+        architecture = [fatBinary bestArchitectureForCPUType:self.cpuType cpuSubType:self.cpuSubtype];
+    else
+        architecture = fatBinary.architectures.firstObject;
+    
+    if (architecture == nil) {
+        MK_ERROR_OUT = [NSError mk_errorWithDomain:MKErrorDomain code:MK_ENOT_FOUND description:@"%@ does not contain a matching architecture.", path];
+        return nil;
+    }
+    
+    return [fatBinary imageForArchitecture:architecture error:error];
+}
+
+//|++++++++++++++++++++++++++++++++++++|//
+- (void)_loadNode:(MKDependencyGraphNode*)node
+{
+    if (node->_image || node->_error)
+        return;
+    
+    __atomic_fetch_add(&_parseCount, 1, __ATOMIC_RELAXED);
+    
+    NSError *error = nil;
+    
+    if (node->_sharedCacheImage) {
+        node->_image = node->_sharedCacheImage.macho;
+        if (node->_image == nil)
+            error = [NSError mk_errorWithDomain:MKErrorDomain code:MK_EINVALID_DATA description:@"Could not parse %@ in the shared cache.", node->_path];
+    } else {
+        node->_image = [self _imageAtPath:node->_path error:&error];
+    }
+    
+    node->_error = error;
+}
+
+//◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦//
+#pragma mark -  Resolving Install Names
+//◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦//
+
+//|++++++++++++++++++++++++++++++++++++|//
+//! Expands a leading \c @loader_path or \c @executable_path in \a path.
+//! Sets \a onDisk if the result names a file on disk rather than an
+//! install name.  Returns \c nil if \a path can not be expanded.
+- (NSString*)_expandPath:(NSString*)path forNode:(MKDependencyGraphNode*)node onDisk:(BOOL*)onDisk
+{
+    if ([path hasPrefix:@"@loader_path"]) {
+        *onDisk = (node->_sharedCacheImage == nil);
+        return [node->_path.stringByDeletingLastPathComponent stringByAppendingString:[path substringFromIndex:@"@loader_path".length]];
+    }
+    
+    if ([path hasPrefix:@"@executable_path"]) {
+        if (node->_executableDirectory == nil)
+            return nil;
+        *onDisk = YES;
+        return [node->_executableDirectory stringByAppendingString:[path substringFromIndex:@"@executable_path".length]];
+    }
+    
+    if ([path hasPrefix:@"@"])
+        return nil;
+    
+    *onDisk = NO;
+    return path;
+}
+
+//|++++++++++++++++++++++++++++++++++++|//
+//! Returns the node for \a path, creating it and adding it to \a frontier
+//! if this is the first time it has been reached.  Returns \c nil if no
+//! image exists at \a path.
+//!
+//! A node created while resolving the current frontier inherits from the
+//! edge with the lowest \a rank that reaches it, whichever worker gets
+//! there first.
+- (MKDependencyGraphNode*)_nodeForPath:(NSString*)path onDisk:(BOOL)onDisk loader:(MKDependencyGraphNode*)loader rank:(uint64_t)rank frontier:(NSMutableArray*)frontier
+{
+    MKDSCImage *sharedCacheImage = nil;
+    NSString *resolvedPath = nil;
+    
+    if (!onDisk && (sharedCacheImage = _sharedCacheImages[path]))
+        resolvedPath = path;
+    else if (!onDisk && self.rootPath)
+        resolvedPath = MKDependencyGraphRealPath([self.rootPath stringByAppendingPathComponent:path]);
+    else
+        resolvedPath = MKDependencyGraphRealPath(path);
+    
+    if (resolvedPath == nil)
+        return nil;
+    
+    @synchronized (_nodesByPath) {
+        BOOL created;
+        MKDependencyGraphNode *node = [self _nodeWithPath:resolvedPath created:&created];
+        
+        if (created) {
+            node->_sharedCacheImage = sharedCacheImage;
+            node->_generation = _generation;
+            
+            @synchronized (frontier) {
+                [frontier addObject:node];
+            }
+        } else if (node->_generation != _generation || rank >= node->_loaderRank)
+            return node;
+        
+        node->_loaderRank = rank;
+        node->_executableDirectory = loader->_executableDirectory;
+        node->_inheritedRPaths = loader->_rpaths;
+        node->_inheritedRPathsOnDisk = loader->_rpathsOnDisk;
+        
+        return node;
+    }
+}
+
+//|++++++++++++++++++++++++++++++++++++|//
+- (void)_resolveDependenciesOfNode:(MKDependencyGraphNode*)node index:(NSUInteger)index frontier:(NSMutableArray*)frontier
+{
+    MKMachOImage *image = node->_image;
+    if (image == nil)
+        return;
+    
+    // The run paths of this image are searched before those inherited from
+    // its loader.
+    NSMutableArray<NSString*> *rpaths = [[NSMutableArray alloc] init];
+    NSMutableArray<NSNumber*> *rpathsOnDisk = [[NSMutableArray alloc] init];
+    
+    for (MKLCRPath *loadCommand in [image loadCommandsOfType:LC_RPATH]) {
+        BOOL onDisk;
+        NSString *rpath = [self _expandPath:loadCommand.path.string forNode:node onDisk:&onDisk];
+        if (rpath == nil)
+            continue;
+        
+        [rpaths addObject:rpath];
+        [rpathsOnDisk addObject:@(onDisk)];
+    }
+    
+    [rpaths addObjectsFromArray:node->_inheritedRPaths];
+    [rpathsOnDisk addObjectsFromArray:node->_inheritedRPathsOnDisk];
+    
+    node->_rpaths = rpaths;
+    node->_rpathsOnDisk = rpathsOnDisk;
+    
+    NSMutableArray<MKDependencyGraphEdge*> *dependencies = [[NSMutableArray alloc] init];
+    uint64_t rank = (uint64_t)index << 32;
+    
+    for (MKResult<MKDependentLibrary*> *result in image.dependentLibraries) {
+        MKDependentLibrary *library = result.value;
+        NSString *name = library.name;
+        rank++;
+        if (name == nil)
+            continue;
+        
+        MKDependencyGraphNode *target = nil;
+        
+        if ([name hasPrefix:@"@rpath/"]) {
+            NSString *suffix = [name substringFromIndex:@"@rpath/".length];
+            for (NSUInteger i = 0; i < rpaths.count && target == nil; i++)
+                target = [self _nodeForPath:[rpaths[i] stringByAppendingPathComponent:suffix] onDisk:rpathsOnDisk[i].boolValue loader:node rank:rank frontier:frontier];
+        } else {
+            BOOL onDisk;
+            NSString *path = [self _expandPath:name forNode:node onDisk:&onDisk];
+            if (path)
+                target = [self _nodeForPath:path onDisk:onDisk loader:node rank:rank frontier:frontier];
+        }
+        
+        MKDependencyGraphEdge *edge = [[MKDependencyGraphEdge alloc] init];
+        edge->_library = library;
+        edge->_node = target;
+        [dependencies addObject:edge];
+    }
+    
+    node->_dependencies = dependencies;
+}
+
+//|++++++++++++++++++++++++++++++++++++|//
+- (void)_resolveFrontier:(NSArray<MKDependencyGraphNode*> *)frontier
+{
+    // Every image at one depth is parsed before moving on to the next.  A
+    // node is only ever added to a frontier by the worker that created it,
+    // so no image is parsed twice.
+    while (frontier.count) {
+        NSMutableArray<MKDependencyGraphNode*> *next = [[NSMutableArray alloc] init];
+        _generation++;
+        
+        dispatch_apply(frontier.count, dispatch_get_global_queue(QOS_CLASS_UTILITY, 0), ^(size_t i) {
+            @autoreleasepool {
+                MKDependencyGraphNode *node = frontier[i];
+                [self _loadNode:node];
+                [self _resolveDependenciesOfNode:node index:i frontier:next];
+            }
+        });
+        
+        // Order the next frontier by the edge each node inherits from, so
+        // that the ranks at the next depth are deterministic too.
+        [next sortUsingComparator:^NSComparisonResult(MKDependencyGraphNode *a, MKDependencyGraphNode *b) {
+            if (a->_loaderRank < b->_loaderRank) return NSOrderedAscending;
+            if (a->_loaderRank > b->_loaderRank) return NSOrderedDescending;
+            return NSOrderedSame;
+        }];
+        
+        frontier = next;
+    }
+}
+
+//◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦//
+#pragma mark -  Building the Graph
+//◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦//
+
+//|++++++++++++++++++++++++++++++++++++|//
+- (NSArray*)resolveClosureOfImagesAtURLs:(NSArray<NSURL*> *)urls
+{
+    [self _prepareForResolution];
+    
+    NSMutableArray<MKDependencyGraphNode*> *roots = [[NSMutableArray alloc] initWithCapacity:urls.count];
+    NSMutableArray<MKDependencyGraphNode*> *frontier = [[NSMutableArray alloc] init];
+    
+    for (NSURL *url in urls) {
+        NSString *path = MKDependencyGraphRealPath(url.path) ?: url.path;
+        
+        BOOL created;
+        MKDependencyGraphNode *node = [self _nodeWithPath:path created:&created];
+        if (created) {
+            node->_executableDirectory = path.stringByDeletingLastPathComponent;
+            [frontier addObject:node];
+        }
+        
+        [roots addObject:node];
+    }
+    
+    // The architecture of the first root selects slices from every fat
+    // binary that follows, so it is parsed before the rest.
+    if (self.cpuType == 0 && roots.count) {
+        [self _loadNode:roots.firstObject];
+        MKMachHeader *header = roots.firstObject.image.header;
+        if (header) {
+            self.cpuType = header.cputype;
+            self.cpuSubtype = header.cpusubtype;
+        }
+    }
+    
+    [self _resolveFrontier:frontier];
+    
+    return roots;
+}
+
+//|++++++++++++++++++++++++++++++++++++|//
+- (MKDependencyGraphNode*)resolveClosureOfImage:(MKMachOImage*)image atPath:(NSString*)path
+{
+    [self _prepareForResolution];
+    
+    path = MKDependencyGraphRealPath(path) ?: path;
+    
+    BOOL created;
+    MKDependencyGraphNode *node = [self _nodeWithPath:path created:&created];
+    if (!created)
+        return node;
+    
+    node->_image = image;
+    node->_executableDirectory = path.stringByDeletingLastPathComponent;
+    
+    if (self.cpuType == 0) {
+        self.cpuType = image.header.cputype;
+        self.cpuSubtype = image.header.cpusubtype;
+    }
+    
+    [self _resolveFrontier:@[node]];
+    
+    return node;
+}
+
+//|++++++++++++++++++++++++++++++++++++|//
+- (NSArray*)closureOfNode:(MKDependencyGraphNode*)node
+{
+    NSMutableArray<MKDependencyGraphNode*> *closure = [[NSMutableArray alloc] initWithObjects:node, nil];
+    NSHashTable<MKDependencyGraphNode*> *visited = [NSHashTable hashTableWithOptions:NSPointerFunctionsObjectPointerPersonality];
+    [visited addObject:node];
+    
+    for (NSUInteger i = 0; i < closure.count; i++) {
+        for (MKDependencyGraphEdge *edge in closure[i].dependencies) {
+            MKDependencyGraphNode *target = edge.node;
+            if (target == nil || [visited containsObject:target])
+                continue;
+            
+            [visited addObject:target];
+            [closure addObject:target];
+        }
+    }
+    
+    return closure;
+}
+
+@end
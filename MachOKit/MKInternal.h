@@ -77,6 +77,27 @@ static TYPE *s_ ## TYPE = nil; \
     return [TYPE sharedInstance]; \
 }
 
+//----------------------------------------------------------------------------//
+#pragma mark -  Memory Usage
+/// @name       Memory Usage
+//----------------------------------------------------------------------------//
+
+//! Returns the sum of the \c estimatedMemoryCost of each node in  nodes,
+//! plus a pointer per node for the storage of the collection.
+NSUInteger MKEstimatedMemoryCostOfNodes(id<NSFastEnumeration> nodes);
+
+//----------------------------------------------------------------------------//
+#pragma mark -  Work Budget
+/// @name       Work Budget
+//----------------------------------------------------------------------------//
+
+//! Initializes the \c mk_budget_meter_t \a METER to charge work against the
+//! budget of the image containing \a NODE.  The image may not have a budget.
+#define MKBudgetMeterInit(METER, NODE) do { \
+    mk_context_t *_mk_budget_ctx = (NODE).macho.context; \
+    mk_budget_meter_init((METER), _mk_budget_ctx ? _mk_budget_ctx->budget : NULL); \
+} while (0)
+
 
 
 #endif /* _MKInternal_h */
@@ -51,6 +51,11 @@
 @class MKStringTable;
 @class MKSymbolTable;
 @class MKIndirectSymbolTable;
+@class MKStubTable;
+@class MKObjCMetadata;
+@class MKCodeSignature;
+@class MKNodeCache;
+struct MKPtrPointeeCache;
 
 NS_ASSUME_NONNULL_BEGIN
 
@@ -104,6 +109,14 @@ typedef NS_OPTIONS(NSUInteger, MKMachOImageFlags) {
     MKResult<MKStringTable*> *_stringTable;
     MKResult<MKSymbolTable*> *_symbolTable;
     MKResult<MKIndirectSymbolTable*> *_indirectSymbolTable;
+    MKResult<MKStubTable*> *_stubTable;
+    // ObjC //
+    MKResult<MKObjCMetadata*> *_objcMetadata;
+    // Code Signature //
+    MKResult<MKCodeSignature*> *_codeSignature;
+    // Caching //
+    MKNodeCache *_nodeCache;
+    struct MKPtrPointeeCache *_pointeeCache;
 }
 
 - (nullable instancetype)initWithName:(nullable const char*)name flags:(MKMachOImageFlags)flags atAddress:(mk_vm_address_t)contextAddress inMapping:(MKMemoryMap*)memMap error:(NSError**)error NS_DESIGNATED_INITIALIZER;
@@ -168,6 +181,21 @@ typedef NS_OPTIONS(NSUInteger, MKMachOImageFlags) {
 //! commands is preserved.
 - (NSArray<__kindof MKLoadCommand*> *)loadCommandsOfType:(uint32_t)type;
 
+//◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦//
+#pragma mark -  Caching Parsed Subtrees
+//! @name       Caching Parsed Subtrees
+//◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦//
+
+//! The cache holding the lazily parsed subtrees of this image: the symbol,
+//! string, indirect symbol and stub tables, bindings, rebase, exports,
+//! function starts, data in code, split segment info and Objective-C metadata.
+//!
+//! If \c nil, the default, each subtree is retained by the image once parsed.
+//! Otherwise subtrees may be evicted when the cache exceeds its budget, and
+//! are parsed again on the next access.  Assign a shared cache to several
+//! images to bound their combined memory use.
+@property (nonatomic, strong, nullable) MKNodeCache *nodeCache;
+
 @end
 
 NS_ASSUME_NONNULL_END
@@ -42,6 +42,10 @@
 #import "MKMachO+Exports.h"
 #import "MKMachO+Symbols.h"
 #import "MKMachOImage+DataInCode.h"
+#import "MKMachOImage+CodeSignature.h"
+#import "MKNodeCache.h"
+#import "_MKMachOImage+NodeCache.h"
+#import "MKPtr.h"
 
 #include <objc/runtime.h>
 
@@ -65,6 +69,8 @@
     _context.logger = (mk_logger_c)method_getImplementation(class_getInstanceMethod(self.class, @selector(_logMessageAtLevel:inFile:line:function:message:)));
     
     _memMap = memMap;
+    _context.statistics = memMap.statistics;
+    _context.budget = memMap.budgetPointer;
     _contextAddress = contextAddress;
     _flags = flags;
     
@@ -143,11 +149,19 @@
         mach_vm_offset_t offset = _header.nodeSize;
         mach_vm_offset_t oldOffset;
         
+        mk_budget_meter_t meter;
+        mk_budget_meter_init(&meter, _context.budget);
+        
         while (loadCommandCount--)
         @autoreleasepool {
                 
             NSError *e = nil;
                 
+            if (mk_budget_meter_charge(&meter, 0, 1, 0)) {
+                MK_PUSH_WARNING(loadCommands, MK_EBUDGET_EXCEEDED, @"Exceeded the work budget before the load command at index %" PRIu32 ".", _header.ncmds - loadCommandCount - 1);
+                break;
+            }
+                
             // It is safe to pass the mach_vm_offset_t offset as the offset
             // parameter because the offset can not grow beyond the header size,
             // which is capped at UINT32_MAX.  Any uint32_t can be acurately
@@ -371,6 +385,13 @@
     return self;
 }
 
+//|++++++++++++++++++++++++++++++++++++|//
+- (void)dealloc
+{
+    [_nodeCache removeObjectsForOwner:self];
+    MKPtrPointeeCacheFree(_pointeeCache);
+}
+
 //◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦//
 #pragma mark -  Retrieving the Initialization Context
 //◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦//
@@ -427,6 +448,77 @@
 - (NSArray*)loadCommandsOfType:(uint32_t)type
 { return [self.loadCommands filteredArrayUsingPredicate:[NSPredicate predicateWithFormat:@"class.ID == %@", @(type)]]; }
 
+//◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦//
+#pragma mark -  Caching Parsed Subtrees
+//◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦//
+
+//|++++++++++++++++++++++++++++++++++++|//
+- (MKNodeCache*)nodeCache
+{
+    @synchronized(self) {
+        return _nodeCache;
+    }
+}
+
+//|++++++++++++++++++++++++++++++++++++|//
+- (void)setNodeCache:(MKNodeCache*)nodeCache
+{
+    @synchronized(self) {
+        if (nodeCache == _nodeCache)
+            return;
+        
+        [_nodeCache removeObjectsForOwner:self];
+        _nodeCache = nodeCache;
+        
+        // Subtrees parsed so far are dropped rather than moved, so that they
+        // are charged to the new cache when next parsed.
+        _functionStarts = nil;
+        _rebaseInfo = nil;
+        _dataInCode = nil;
+        _splitSegment = nil;
+        _bindingsInfo = nil;
+        _weakBindingsInfo = nil;
+        _lazyBindingsInfo = nil;
+        _exportsInfo = nil;
+        _stringTable = nil;
+        _symbolTable = nil;
+        _indirectSymbolTable = nil;
+        _stubTable = nil;
+        _objcMetadata = nil;
+        _codeSignature = nil;
+    }
+}
+
+//|++++++++++++++++++++++++++++++++++++|//
+- (MKResult*)_subtreeForKey:(NSString*)key storage:(MKResult * __strong *)storage builder:(MKResult* (^)(void))builder
+{
+    @synchronized(self) {
+        MKNodeCache *nodeCache = self.nodeCache;
+        if (nodeCache == nil)
+        {
+            if (*storage == nil)
+                *storage = builder();
+            return *storage;
+        }
+        
+        MKResult *result = [nodeCache objectForOwner:self key:key];
+        if (result == nil)
+        {
+            result = builder();
+            
+            NSUInteger cost;
+            if ([result.value isKindOfClass:MKNode.class])
+                cost = [(MKNode*)result.value estimatedMemoryCost];
+            else
+                cost = class_getInstanceSize(MKResult.class);
+            
+            [nodeCache setObject:result cost:cost owner:self key:key];
+        }
+        
+        return result;
+    }
+}
+
 //◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦//
 #pragma mark -  MKNode
 //◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦//
@@ -502,6 +594,7 @@
         [[self.class _stringTableFieldBuilder] build],
         [[self.class _symbolTableFieldBuilder] build],
         [[self.class _indirectSymbolTableFieldBuilder] build],
+        [[self.class _codeSignatureFieldBuilder] build],
     #pragma clang diagnostic pop
     ]];
 }
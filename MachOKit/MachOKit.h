@@ -40,9 +40,13 @@
 
 /* CORE */
 #import <MachOKit/MKMemoryMap.h>
+#import <MachOKit/MKBlockSource.h>
+#import <MachOKit/MKStreamBlockSource.h>
 #import <MachOKit/MKNodeDescription.h>
+#import <MachOKit/MKNodeSerializer.h>
 #import <MachOKit/MKDataModel.h>
 #import <MachOKit/MKNode.h>
+#import <MachOKit/MKNodeCache.h>
 #import <MachOKit/MKAddressedNode.h>
 #import <MachOKit/MKBackedNode.h>
 #import <MachOKit/MKOffsetNode.h>
@@ -137,6 +141,7 @@
     #import <MachOKit/MKLCDyldChainedFixups.h>
 #import <MachOKit/MKMachO+Libraries.h>
     #import <MachOKit/MKDependentLibrary.h>
+    #import <MachOKit/MKDependencyGraph.h>
 #import <MachOKit/MKMachO+Segments.h>
     #import <MachOKit/MKSegment.h>
     #import <MachOKit/MKSection.h>
@@ -169,6 +174,12 @@
 #import <MachOKit/MKMachOImage+DataInCode.h>
     #import <MachOKit/MKDataInCode.h>
     #import <MachOKit/MKDataInCodeEntry.h>
+#import <MachOKit/MKMachOImage+CodeSignature.h>
+    #import <MachOKit/MKCodeSignature.h>
+    #import <MachOKit/MKCodeSignatureBlob.h>
+    #import <MachOKit/MKCodeDirectory.h>
+    #import <MachOKit/MKCodeSignatureRequirements.h>
+    #import <MachOKit/MKCodeSignatureEntitlements.h>
 #import <MachOKit/MKMachO+SplitSegment.h>
     #import <MachOKit/MKSplitSegmentInfo.h>
     #import <MachOKit/MKSplitSegmentInfoV1.h>
@@ -182,6 +193,7 @@
     #import <MachOKit/MKBindingsInfo.h>
     #import <MachOKit/MKWeakBindingsInfo.h>
     #import <MachOKit/MKLazyBindingsInfo.h>
+    #import <MachOKit/MKBindTable.h>
     #import <MachOKit/MKBindAction.h>
     #import <MachOKit/MKBindActionBind.h>
     #import <MachOKit/MKBindActionThreadedBind.h>
@@ -214,6 +226,7 @@
 	#import <MachOKit/MKExportTrieTerminalNode.h>
 	#import <MachOKit/MKExportTrieBranch.h>
 #import <MachOKit/MKMachO+Symbols.h>
+    #import <MachOKit/MKSymbolicator.h>
     #import <MachOKit/MKStringTable.h>
     #import <MachOKit/MKSymbolTable.h>
     #import <MachOKit/MKSymbol.h>
@@ -235,6 +248,7 @@
     #import <MachOKit/MKSectionSymbol.h>
     #import <MachOKit/MKAliasSymbol.h>
     #import <MachOKit/MKIndirectSymbolTable.h>
+    #import <MachOKit/MKStubTable.h>
     #import <MachOKit/MKIndirectSymbol.h>
 
 #import <MachOKit/MKCFString.h>
@@ -267,6 +281,13 @@
     #import <MachOKit/MKObjCIVarSection.h>
     #import <MachOKit/MKObjCConstSection.h>
     #import <MachOKit/MKObjCDataSection.h>
+
+#import <MachOKit/MKMachO+ObjC.h>
+    #import <MachOKit/MKObjCMetadata.h>
+
+#import <MachOKit/MKParseResultCache.h>
+    #import <MachOKit/MKParseResults.h>
+
 #import <MachOKit/MKNodeFieldCPUSubTypePowerPC64.h>
 
 #endif /* _MachOKit_H */
@@ -0,0 +1,202 @@
+//----------------------------------------------------------------------------//
+//|
+//|             MachOKit - A Lightweight Mach-O Parsing Library
+//! @file       MKObjCMetadata.h
+//!
+//! @author     D.V.
+//! @copyright  Copyright (c) 2014-2015 D.V. All rights reserved.
+//|
+//| Permission is hereby granted, free of charge, to any person obtaining a
+//| copy of this software and associated documentation files (the "Software"),
+//| to deal in the Software without restriction, including without limitation
+//| the rights to use, copy, modify, merge, publish, distribute, sublicense,
+//| and/or sell copies of the Software, and to permit persons to whom the
+//| Software is furnished to do so, subject to the following conditions:
+//|
+//| The above copyright notice and this permission notice shall be included
+//| in all copies or substantial portions of the Software.
+//|
+//| THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+//| OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+//| MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+//| IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+//| CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+//| TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+//| SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+//----------------------------------------------------------------------------//
+
+#include <MachOKit/macho.h>
+#import <Foundation/Foundation.h>
+
+#import <MachOKit/MKNode.h>
+
+@class MKMachOImage;
+@class MKObjCClass;
+@class MKObjCCategory;
+@class MKObjCProtocol;
+
+NS_ASSUME_NONNULL_BEGIN
+
+//----------------------------------------------------------------------------//
+//! @name       Method List Flags
+//! @relates    MKObjCMethodListRecord
+//
+typedef NS_OPTIONS(uint32_t, MKObjCMethodListFlags) {
+    //! The list contains relative (small) methods.  Each entry holds three
+    //! 32-bit offsets, relative to the field, rather than three pointers.
+    MKObjCMethodListUsesRelativeOffsets         = 0x80000000,
+    //! The name offset of each relative method is relative to the selector
+    //! base of the shared cache, rather than to a selector reference.
+    MKObjCMethodListRelativeSelectorsAreDirect  = 0x40000000,
+    //! Mask of all flag bits in the \c entsizeAndFlags field of a method list.
+    MKObjCMethodListFlagsMask                   = 0xFFFF0003
+};
+
+
+
+//----------------------------------------------------------------------------//
+//! @name       Metadata Records
+//!
+//! Records are plain C structures allocated from an arena owned by the
+//! \ref MKObjCMetadata instance that produced them.  They remain valid for
+//! the lifetime of that instance.  Strings are copied into the arena, and
+//! are \c NULL if they could not be read.
+//
+
+//! An Objective-C method, decoded from either a pointer-based or a relative
+//! method list entry.
+typedef struct MKObjCMethodRecord {
+    //! The VM address of the method list entry.
+    mk_vm_address_t address;
+    const char * _Nullable name;
+    const char * _Nullable types;
+    mk_vm_address_t implementation;
+} MKObjCMethodRecord;
+
+//! An Objective-C method list.
+typedef struct MKObjCMethodListRecord {
+    //! The VM address of the method list, or \c 0 if there is no list.
+    mk_vm_address_t address;
+    MKObjCMethodListFlags flags;
+    uint32_t count;
+    MKObjCMethodRecord * _Nullable methods;
+} MKObjCMethodListRecord;
+
+//! An Objective-C instance variable.
+typedef struct MKObjCIVarRecord {
+    //! The VM address of the ivar list entry.
+    mk_vm_address_t address;
+    const char * _Nullable name;
+    const char * _Nullable type;
+    //! The VM address of the ivar offset variable.
+    mk_vm_address_t offsetAddress;
+    //! The value of the ivar offset variable.
+    uint64_t offset;
+    //! The alignment of the ivar, in bytes.
+    uint32_t alignment;
+    uint32_t size;
+} MKObjCIVarRecord;
+
+//! An Objective-C class, including the class methods of its metaclass.
+typedef struct MKObjCClassRecord {
+    //! The VM address of the class.
+    mk_vm_address_t address;
+    mk_vm_address_t metaClassAddress;
+    mk_vm_address_t superClassAddress;
+    //! The VM address of the class' read-only data.
+    mk_vm_address_t dataAddress;
+    const char * _Nullable name;
+    uint32_t flags;
+    uint32_t instanceStart;
+    uint32_t instanceSize;
+    bool isSwiftLegacy;
+    bool isSwiftStable;
+    MKObjCMethodListRecord instanceMethods;
+    MKObjCMethodListRecord classMethods;
+    uint32_t ivarCount;
+    MKObjCIVarRecord * _Nullable ivars;
+    uint32_t protocolCount;
+    //! The VM addresses of the protocols adopted by the class.
+    mk_vm_address_t * _Nullable protocols;
+} MKObjCClassRecord;
+
+//! An Objective-C category.
+typedef struct MKObjCCategoryRecord {
+    //! The VM address of the category.
+    mk_vm_address_t address;
+    const char * _Nullable name;
+    //! The VM address of the class the category extends, or \c 0 if the
+    //! class is bound from another image.
+    mk_vm_address_t classAddress;
+    MKObjCMethodListRecord instanceMethods;
+    MKObjCMethodListRecord classMethods;
+    uint32_t protocolCount;
+    mk_vm_address_t * _Nullable protocols;
+} MKObjCCategoryRecord;
+
+//! An Objective-C protocol.
+typedef struct MKObjCProtocolRecord {
+    //! The VM address of the protocol.
+    mk_vm_address_t address;
+    const char * _Nullable name;
+    MKObjCMethodListRecord instanceMethods;
+    MKObjCMethodListRecord classMethods;
+    MKObjCMethodListRecord optionalInstanceMethods;
+    MKObjCMethodListRecord optionalClassMethods;
+    uint32_t protocolCount;
+    mk_vm_address_t * _Nullable protocols;
+} MKObjCProtocolRecord;
+
+
+
+//----------------------------------------------------------------------------//
+//! An instance of \c MKObjCMetadata holds the Objective-C classes, categories
+//! and protocols of an image, decoded in a single pass over the
+//! \c __objc_classlist, \c __objc_catlist and \c __objc_protolist sections.
+//!
+//! Unlike the node tree rooted at \ref MKObjCClassListSection, no node is
+//! created for the individual lists, elements or pointers.  Nodes for a
+//! record are only instantiated when requested through one of the
+//! \c -...NodeForRecord: methods.
+//
+@interface MKObjCMetadata : MKNode
+
+- (nullable instancetype)initWithImage:(MKMachOImage*)image error:(NSError**)error;
+
+//! The image this metadata was decoded from.
+@property (nonatomic, weak, readonly) MKMachOImage *image;
+
+//◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦//
+#pragma mark -  Records
+//! @name       Records
+//◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦//
+
+@property (nonatomic, assign, readonly) NSUInteger classCount;
+//! The classes listed in \c __objc_classlist, in list order.
+@property (nonatomic, assign, readonly) const MKObjCClassRecord *classes;
+
+@property (nonatomic, assign, readonly) NSUInteger categoryCount;
+//! The categories listed in \c __objc_catlist, in list order.
+@property (nonatomic, assign, readonly) const MKObjCCategoryRecord *categories;
+
+@property (nonatomic, assign, readonly) NSUInteger protocolCount;
+//! The protocols listed in \c __objc_protolist, in list order.
+@property (nonatomic, assign, readonly) const MKObjCProtocolRecord *protocols;
+
+//! Returns the class record for the class at \a address, or \c NULL.
+- (nullable const MKObjCClassRecord *)classRecordAtAddress:(mk_vm_address_t)address;
+
+//◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦//
+#pragma mark -  Nodes
+//! @name       Nodes
+//◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦//
+
+//! Returns the node for the class described by \a record, creating the
+//! node tree down to it if necessary.
+- (MKResult<MKObjCClass*> *)classNodeForRecord:(const MKObjCClassRecord *)record;
+- (MKResult<MKObjCCategory*> *)categoryNodeForRecord:(const MKObjCCategoryRecord *)record;
+- (MKResult<MKObjCProtocol*> *)protocolNodeForRecord:(const MKObjCProtocolRecord *)record;
+
+@end
+
+NS_ASSUME_NONNULL_END
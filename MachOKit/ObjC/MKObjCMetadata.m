@@ -0,0 +1,1117 @@
+//----------------------------------------------------------------------------//
+//|
+//|             MachOKit - A Lightweight Mach-O Parsing Library
+//|             MKObjCMetadata.m
+//|
+//|             D.V.
+//|             Copyright (c) 2014-2015 D.V. All rights reserved.
+//|
+//| Permission is hereby granted, free of charge, to any person obtaining a
+//| copy of this software and associated documentation files (the "Software"),
+//| to deal in the Software without restriction, including without limitation
+//| the rights to use, copy, modify, merge, publish, distribute, sublicense,
+//| and/or sell copies of the Software, and to permit persons to whom the
+//| Software is furnished to do so, subject to the following conditions:
+//|
+//| The above copyright notice and this permission notice shall be included
+//| in all copies or substantial portions of the Software.
+//|
+//| THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+//| OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+//| MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+//| IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+//| CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+//| TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+//| SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+//----------------------------------------------------------------------------//
+
+#import "MKObjCMetadata.h"
+#import "MKInternal.h"
+#import "MKMachO.h"
+#import "MKLCSegment.h"
+#import "MKDataModel+ObjC.h"
+#import "MKObjCClass.h"
+#import "MKObjCCategory.h"
+#import "MKObjCProtocol.h"
+#import "DyldSharedCache.h"
+#import "MKLCDyldChainedFixups.h"
+#import "MKLinkEditNode.h"
+
+#include <mach-o/fixup-chains.h>
+
+// from https://opensource.apple.com/source/objc4/objc4-781/runtime/objc-runtime-new.h.auto.html
+#define FAST_IS_SWIFT_LEGACY    (1UL<<0)
+#define FAST_IS_SWIFT_STABLE    (1UL<<1)
+#define FAST_DATA_MASK_64       0x00007ffffffffff8UL
+#define FAST_DATA_MASK_32       0xfffffffcUL
+// class_rw_t::flags
+#define RW_REALIZED             (1U<<31)
+
+// dyld's ObjCOptimizationHeader, found at objcOptsOffset from the cache base.
+struct objc_opts_header {
+    uint32_t version;
+    uint32_t flags;
+    uint64_t headerInfoROCacheOffset;
+    uint64_t headerInfoRWCacheOffset;
+    uint64_t selectorHashTableCacheOffset;
+    uint64_t classHashTableCacheOffset;
+    uint64_t protocolHashTableCacheOffset;
+    uint64_t relativeMethodSelectorBaseAddressOffset;
+};
+
+//◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦//
+#pragma mark -  Arena
+//◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦//
+
+#define MK_OBJC_ARENA_BLOCK_SIZE    (64 * 1024)
+
+typedef struct _MKObjCArenaBlock {
+    struct _MKObjCArenaBlock *next;
+    size_t size;
+    size_t used;
+    uint8_t bytes[];
+} _MKObjCArenaBlock;
+
+//|++++++++++++++++++++++++++++++++++++|//
+static void*
+_MKObjCArenaAllocate(_MKObjCArenaBlock **arena, size_t size)
+{
+    // Every record is 8-byte aligned.
+    size = (size + 7) & ~(size_t)7;
+
+    _MKObjCArenaBlock *block = *arena;
+    if (block == NULL || block->size - block->used < size) {
+        size_t blockSize = MAX(size, (size_t)MK_OBJC_ARENA_BLOCK_SIZE);
+        _MKObjCArenaBlock *newBlock = calloc(1, sizeof(_MKObjCArenaBlock) + blockSize);
+        if (newBlock == NULL)
+            return NULL;
+
+        newBlock->size = blockSize;
+        newBlock->next = block;
+        *arena = block = newBlock;
+    }
+
+    void *result = block->bytes + block->used;
+    block->used += size;
+    return result;
+}
+
+//|++++++++++++++++++++++++++++++++++++|//
+static void
+_MKObjCArenaFree(_MKObjCArenaBlock *arena)
+{
+    while (arena) {
+        _MKObjCArenaBlock *next = arena->next;
+        free(arena);
+        arena = next;
+    }
+}
+
+//◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦//
+#pragma mark -  Reader
+//◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦//
+
+//! A segment of the image.  Its contents are read through the memory map.
+typedef struct _MKObjCRegion {
+    mk_vm_address_t address;
+    mk_vm_size_t size;
+    //! The address of the segment's first byte in the memory map.
+    mk_vm_address_t contextAddress;
+    //! The DYLD_CHAINED_PTR_* format of the pointers in the segment, or 0
+    //! if they are plain pointers.
+    uint16_t pointerFormat;
+} _MKObjCRegion;
+
+//! Interned strings, keyed by VM address.
+typedef struct _MKObjCString {
+    mk_vm_address_t address;
+    const char *string;
+} _MKObjCString;
+
+typedef struct _MKObjCReader {
+    const mk_byteorder_t *byteOrder;
+    size_t pointerSize;
+    size_t ivarOffsetSize;
+    __unsafe_unretained MKMemoryMap *memoryMap;
+    //! The unslid address of the image's mach header.  Chained fixups in
+    //! the offset formats are relative to it.
+    mk_vm_address_t imageAddress;
+    _MKObjCRegion *regions;
+    uint32_t regionCount;
+    _MKObjCArenaBlock **arena;
+    _MKObjCString *strings;
+    size_t stringsCapacity;
+    size_t stringsCount;
+    // Shared cache //
+    DyldSharedCache *dsc;
+    uint64_t dscBaseAddress;
+    uint32_t slideVersion;
+    uint64_t slideValueMask;
+    uint64_t slideValueAdd;
+    mk_vm_address_t selectorBase;
+} _MKObjCReader;
+
+//|++++++++++++++++++++++++++++++++++++|//
+static const _MKObjCRegion*
+_MKObjCReaderRegion(_MKObjCReader *reader, mk_vm_address_t address)
+{
+    for (uint32_t i = 0; i < reader->regionCount; i++) {
+        _MKObjCRegion *region = &reader->regions[i];
+        if (address >= region->address && address - region->address < region->size)
+            return region;
+    }
+    return NULL;
+}
+
+//|++++++++++++++++++++++++++++++++++++|//
+//! Returns the number of bytes readable from \a address in \a available.
+//! If \a address lies in the shared cache rather than in a segment of the
+//! image, \a bytes is set to point at the mapped cache.
+static bool
+_MKObjCReaderLocate(_MKObjCReader *reader, mk_vm_address_t address, const _MKObjCRegion **region, const uint8_t **bytes, mk_vm_size_t *available)
+{
+    *region = _MKObjCReaderRegion(reader, address);
+    *bytes = NULL;
+    if (*region) {
+        *available = (*region)->size - (address - (*region)->address);
+        return true;
+    }
+
+    // Shared cache images routinely point outside of themselves; selector
+    // strings, for example, are uniqued into libobjc.
+    if (reader->dsc) {
+        DyldSharedCacheMapping *mapping = dsc_lookup_mapping(reader->dsc, address, 0);
+        if (mapping && mapping->ptr != (void*)-1) {
+            *available = mapping->size - (address - mapping->vmaddr);
+            *bytes = (const uint8_t*)mapping->ptr + (address - mapping->vmaddr);
+            return true;
+        }
+    }
+
+    return false;
+}
+
+//|++++++++++++++++++++++++++++++++++++|//
+static bool
+_MKObjCReaderAvailable(_MKObjCReader *reader, mk_vm_address_t address, mk_vm_size_t length, mk_vm_size_t *available)
+{
+    const _MKObjCRegion *region;
+    const uint8_t *bytes;
+    if (!_MKObjCReaderLocate(reader, address, &region, &bytes, available))
+        return false;
+    return *available >= length;
+}
+
+//|++++++++++++++++++++++++++++++++++++|//
+static bool
+_MKObjCReaderRead(_MKObjCReader *reader, mk_vm_address_t address, void *buffer, mk_vm_size_t length, const _MKObjCRegion **regionOut)
+{
+    const _MKObjCRegion *region;
+    const uint8_t *bytes;
+    mk_vm_size_t available;
+    if (!_MKObjCReaderLocate(reader, address, &region, &bytes, &available) || available < length)
+        return false;
+
+    if (regionOut) *regionOut = region;
+    if (bytes) {
+        memcpy(buffer, bytes, (size_t)length);
+        return true;
+    }
+
+    return [reader->memoryMap copyBytesAtOffset:(address - region->address) fromAddress:region->contextAddress into:buffer length:length requireFull:YES error:NULL] == length;
+}
+
+//|++++++++++++++++++++++++++++++++++++|//
+static bool
+_MKObjCReadUInt32(_MKObjCReader *reader, mk_vm_address_t address, uint32_t *result)
+{
+    uint32_t value;
+    if (!_MKObjCReaderRead(reader, address, &value, sizeof(value), NULL))
+        return false;
+
+    *result = reader->byteOrder->swap32(value);
+    return true;
+}
+
+//|++++++++++++++++++++++++++++++++++++|//
+static bool
+_MKObjCReadWordFromRegion(_MKObjCReader *reader, mk_vm_address_t address, size_t size, uint64_t *result, const _MKObjCRegion **region)
+{
+    if (size == 8) {
+        uint64_t value;
+        if (!_MKObjCReaderRead(reader, address, &value, sizeof(value), region))
+            return false;
+        *result = reader->byteOrder->swap64(value);
+    } else {
+        uint32_t value;
+        if (!_MKObjCReaderRead(reader, address, &value, sizeof(value), region))
+            return false;
+        *result = reader->byteOrder->swap32(value);
+    }
+    return true;
+}
+
+//|++++++++++++++++++++++++++++++++++++|//
+static bool
+_MKObjCReadWord(_MKObjCReader *reader, mk_vm_address_t address, size_t size, uint64_t *result)
+{ return _MKObjCReadWordFromRegion(reader, address, size, result, NULL); }
+
+//|++++++++++++++++++++++++++++++++++++|//
+//! Decodes a pointer in a chain of fixups.  Binds resolve to another image,
+//! and are returned as 0.
+static uint64_t
+_MKObjCDecodeChainedPointer(_MKObjCReader *reader, uint16_t format, uint64_t value)
+{
+    uint64_t target, high8;
+
+    switch (format) {
+        case DYLD_CHAINED_PTR_64:
+        case DYLD_CHAINED_PTR_64_OFFSET:
+            // struct dyld_chained_ptr_64_rebase
+            if (value & (1ULL << 63))
+                return 0;
+            target = value & 0xFFFFFFFFFULL;
+            high8 = (value >> 36) & 0xFF;
+            if (format == DYLD_CHAINED_PTR_64_OFFSET)
+                target += reader->imageAddress;
+            return (high8 << 56) | target;
+        case DYLD_CHAINED_PTR_ARM64E:
+        case DYLD_CHAINED_PTR_ARM64E_USERLAND:
+        case DYLD_CHAINED_PTR_ARM64E_USERLAND24:
+            if (value & (1ULL << 62))
+                return 0;
+            // struct dyld_chained_ptr_arm64e_auth_rebase.  The target is
+            // always an offset from the image.
+            if (value & (1ULL << 63))
+                return reader->imageAddress + (value & 0xFFFFFFFFULL);
+            // struct dyld_chained_ptr_arm64e_rebase
+            target = value & 0x7FFFFFFFFFFULL;
+            high8 = (value >> 43) & 0xFF;
+            if (format != DYLD_CHAINED_PTR_ARM64E)
+                target += reader->imageAddress;
+            return (high8 << 56) | target;
+        case DYLD_CHAINED_PTR_32:
+            // struct dyld_chained_ptr_32_rebase
+            if (value & (1ULL << 31))
+                return 0;
+            return value & 0x3FFFFFFULL;
+        default:
+            return value;
+    }
+}
+
+//|++++++++++++++++++++++++++++++++++++|//
+//! Reads the pointer at \a address, decoding the chained fixup or slide
+//! info encoding of pointers that dyld has not yet fixed up.
+static bool
+_MKObjCReadPointer(_MKObjCReader *reader, mk_vm_address_t address, mk_vm_address_t *result)
+{
+    uint64_t value;
+    const _MKObjCRegion *region = NULL;
+    if (!_MKObjCReadWordFromRegion(reader, address, reader->pointerSize, &value, &region))
+        return false;
+
+    if (region && region->pointerFormat && value != 0) {
+        value = _MKObjCDecodeChainedPointer(reader, region->pointerFormat, value);
+    } else if (reader->dsc && value != 0) {
+        switch (reader->slideVersion) {
+            case 2:
+                value = (value & reader->slideValueMask) + reader->slideValueAdd;
+                break;
+            case 3:
+                if (value & (1ULL << 63))
+                    value = reader->dscBaseAddress + (value & 0xFFFFFFFFULL);
+                else
+                    value = ((value & 0x0007F80000000000ULL) << 13) | (value & 0x000007FFFFFFFFFFULL);
+                break;
+            case 5:
+                value = reader->slideValueAdd + (value & 0x3FFFFFFFFULL);
+                break;
+            default:
+                break;
+        }
+    }
+
+    *result = (mk_vm_address_t)value;
+    return true;
+}
+
+//|++++++++++++++++++++++++++++++++++++|//
+static const char*
+_MKObjCCopyString(_MKObjCReader *reader, mk_vm_address_t address)
+{
+    if (address == 0)
+        return NULL;
+
+    // Selectors and type encodings are heavily shared between methods, so
+    // each string is copied into the arena only once.
+    size_t mask = reader->stringsCapacity - 1;
+    size_t slot = (size_t)((address >> 2) * 0x9E3779B97F4A7C15ULL) & mask;
+    while (reader->strings[slot].address != 0) {
+        if (reader->strings[slot].address == address)
+            return reader->strings[slot].string;
+        slot = (slot + 1) & mask;
+    }
+
+    const _MKObjCRegion *region;
+    const uint8_t *bytes;
+    mk_vm_size_t available = 0;
+    if (!_MKObjCReaderLocate(reader, address, &region, &bytes, &available) || available == 0)
+        return NULL;
+
+    char *string;
+    if (bytes) {
+        size_t length = strnlen((const char*)bytes, (size_t)MIN(available, (mk_vm_size_t)SIZE_MAX));
+        if (length == available)
+            return NULL;
+        if ((string = _MKObjCArenaAllocate(reader->arena, length + 1)) == NULL)
+            return NULL;
+        memcpy(string, bytes, length);
+    } else {
+        // Read the string in chunks until its terminator turns up.
+        char chunk[256];
+        char *buffer = NULL;
+        size_t length = 0;
+        bool terminated = false;
+        while (!terminated && length < available) {
+            size_t chunkLength = (size_t)MIN((mk_vm_size_t)sizeof(chunk), available - length);
+            if ([reader->memoryMap copyBytesAtOffset:(address - region->address) + length fromAddress:region->contextAddress into:chunk length:chunkLength requireFull:YES error:NULL] != chunkLength)
+                break;
+            const char *terminator = memchr(chunk, '\0', chunkLength);
+            size_t used = terminator ? (size_t)(terminator - chunk) : chunkLength;
+            char *grown = realloc(buffer, length + used + 1);
+            if (grown == NULL)
+                break;
+            buffer = grown;
+            memcpy(buffer + length, chunk, used);
+            length += used;
+            terminated = (terminator != NULL);
+        }
+        
+        string = terminated ? _MKObjCArenaAllocate(reader->arena, length + 1) : NULL;
+        if (string)
+            memcpy(string, buffer, length);
+        free(buffer);
+        if (string == NULL)
+            return NULL;
+    }
+
+    reader->strings[slot].address = address;
+    reader->strings[slot].string = string;
+
+    // Keep the table at most half full.
+    if (++reader->stringsCount * 2 > reader->stringsCapacity) {
+        size_t newCapacity = reader->stringsCapacity * 2;
+        _MKObjCString *newStrings = calloc(newCapacity, sizeof(_MKObjCString));
+        if (newStrings) {
+            for (size_t i = 0; i < reader->stringsCapacity; i++) {
+                if (reader->strings[i].address == 0)
+                    continue;
+                size_t newSlot = (size_t)((reader->strings[i].address >> 2) * 0x9E3779B97F4A7C15ULL) & (newCapacity - 1);
+                while (newStrings[newSlot].address != 0)
+                    newSlot = (newSlot + 1) & (newCapacity - 1);
+                newStrings[newSlot] = reader->strings[i];
+            }
+            free(reader->strings);
+            reader->strings = newStrings;
+            reader->stringsCapacity = newCapacity;
+        }
+    }
+
+    return string;
+}
+
+//◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦//
+#pragma mark -  Decoding
+//◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦//
+
+//|++++++++++++++++++++++++++++++++++++|//
+//! Returns the number of entries of \a entsize bytes, following an eight byte
+//! list header at \a address, that can actually be read.
+static uint32_t
+_MKObjCReadableCount(_MKObjCReader *reader, mk_vm_address_t address, uint32_t count, uint32_t entsize)
+{
+    mk_vm_size_t available = 0;
+    if (entsize == 0 || !_MKObjCReaderAvailable(reader, address, 8, &available))
+        return 0;
+
+    mk_vm_size_t readable = (available - 8) / entsize;
+    return (uint32_t)MIN((mk_vm_size_t)count, readable);
+}
+
+//|++++++++++++++++++++++++++++++++++++|//
+static void
+_MKObjCDecodeMethodList(_MKObjCReader *reader, mk_vm_address_t address, MKObjCMethodListRecord *list)
+{
+    uint32_t entsizeAndFlags, count;
+
+    list->address = address;
+    if (address == 0 || !_MKObjCReadUInt32(reader, address, &entsizeAndFlags) || !_MKObjCReadUInt32(reader, address + 4, &count))
+        return;
+
+    uint32_t entsize = entsizeAndFlags & ~(uint32_t)MKObjCMethodListFlagsMask;
+    list->flags = entsizeAndFlags & MKObjCMethodListFlagsMask;
+    list->count = _MKObjCReadableCount(reader, address, count, entsize);
+    if (list->count == 0)
+        return;
+
+    list->methods = _MKObjCArenaAllocate(reader->arena, list->count * sizeof(MKObjCMethodRecord));
+    if (list->methods == NULL) {
+        list->count = 0;
+        return;
+    }
+
+    bool isSmall = !!(list->flags & MKObjCMethodListUsesRelativeOffsets);
+
+    for (uint32_t i = 0; i < list->count; i++)
+    {
+        MKObjCMethodRecord *method = &list->methods[i];
+        mk_vm_address_t entry = address + 8 + (mk_vm_address_t)i * entsize;
+        method->address = entry;
+
+        if (isSmall)
+        {
+            // struct method_t::small { int32_t name, types, imp; }, each
+            // relative to its own field.
+            uint32_t nameOffset, typesOffset, impOffset;
+            if (!_MKObjCReadUInt32(reader, entry, &nameOffset) ||
+                !_MKObjCReadUInt32(reader, entry + 4, &typesOffset) ||
+                !_MKObjCReadUInt32(reader, entry + 8, &impOffset))
+                continue;
+
+            mk_vm_address_t selector = 0;
+            if (list->flags & MKObjCMethodListRelativeSelectorsAreDirect) {
+                if (reader->selectorBase)
+                    selector = reader->selectorBase + (int64_t)(int32_t)nameOffset;
+            } else {
+                // The name is relative to a selector reference.
+                _MKObjCReadPointer(reader, entry + (int64_t)(int32_t)nameOffset, &selector);
+            }
+
+            method->name = _MKObjCCopyString(reader, selector);
+            method->types = _MKObjCCopyString(reader, entry + 4 + (int64_t)(int32_t)typesOffset);
+            method->implementation = impOffset ? entry + 8 + (int64_t)(int32_t)impOffset : 0;
+        }
+        else
+        {
+            mk_vm_address_t name = 0, types = 0, imp = 0;
+            size_t pointerSize = reader->pointerSize;
+            _MKObjCReadPointer(reader, entry, &name);
+            _MKObjCReadPointer(reader, entry + pointerSize, &types);
+            _MKObjCReadPointer(reader, entry + 2 * pointerSize, &imp);
+
+            method->name = _MKObjCCopyString(reader, name);
+            method->types = _MKObjCCopyString(reader, types);
+            method->implementation = imp;
+        }
+    }
+}
+
+//|++++++++++++++++++++++++++++++++++++|//
+static mk_vm_address_t*
+_MKObjCDecodeProtocolList(_MKObjCReader *reader, mk_vm_address_t address, uint32_t *count)
+{
+    size_t pointerSize = reader->pointerSize;
+    uint64_t listCount;
+
+    *count = 0;
+    if (address == 0 || !_MKObjCReadWord(reader, address, pointerSize, &listCount) || listCount == 0)
+        return NULL;
+
+    mk_vm_size_t available = 0;
+    if (!_MKObjCReaderAvailable(reader, address, pointerSize, &available))
+        return NULL;
+    listCount = MIN(listCount, (available - pointerSize) / pointerSize);
+    listCount = MIN(listCount, (uint64_t)UINT32_MAX);
+
+    mk_vm_address_t *protocols = _MKObjCArenaAllocate(reader->arena, (size_t)listCount * sizeof(mk_vm_address_t));
+    if (protocols == NULL)
+        return NULL;
+
+    for (uint64_t i = 0; i < listCount; i++)
+        _MKObjCReadPointer(reader, address + pointerSize * (i + 1), &protocols[i]);
+
+    *count = (uint32_t)listCount;
+    return protocols;
+}
+
+//|++++++++++++++++++++++++++++++++++++|//
+static MKObjCIVarRecord*
+_MKObjCDecodeIVarList(_MKObjCReader *reader, mk_vm_address_t address, uint32_t *count)
+{
+    size_t pointerSize = reader->pointerSize;
+    uint32_t entsize, listCount;
+
+    *count = 0;
+    if (address == 0 || !_MKObjCReadUInt32(reader, address, &entsize) || !_MKObjCReadUInt32(reader, address + 4, &listCount))
+        return NULL;
+
+    // struct ivar_list_t reserves the low bits of entsize for flags.
+    entsize &= ~(uint32_t)3;
+    if (entsize < 3 * pointerSize + 8)
+        return NULL;
+
+    listCount = _MKObjCReadableCount(reader, address, listCount, entsize);
+    if (listCount == 0)
+        return NULL;
+
+    MKObjCIVarRecord *ivars = _MKObjCArenaAllocate(reader->arena, listCount * sizeof(MKObjCIVarRecord));
+    if (ivars == NULL)
+        return NULL;
+
+    for (uint32_t i = 0; i < listCount; i++)
+    {
+        MKObjCIVarRecord *ivar = &ivars[i];
+        mk_vm_address_t entry = address + 8 + (mk_vm_address_t)i * entsize;
+        mk_vm_address_t name = 0, type = 0;
+        uint32_t alignment = 0, size = 0;
+
+        ivar->address = entry;
+        _MKObjCReadPointer(reader, entry, &ivar->offsetAddress);
+        _MKObjCReadPointer(reader, entry + pointerSize, &name);
+        _MKObjCReadPointer(reader, entry + 2 * pointerSize, &type);
+        _MKObjCReadUInt32(reader, entry + 3 * pointerSize, &alignment);
+        _MKObjCReadUInt32(reader, entry + 3 * pointerSize + 4, &size);
+
+        if (ivar->offsetAddress)
+            _MKObjCReadWord(reader, ivar->offsetAddress, reader->ivarOffsetSize, &ivar->offset);
+
+        ivar->name = _MKObjCCopyString(reader, name);
+        ivar->type = _MKObjCCopyString(reader, type);
+        // Convert the alignment to bytes.
+        ivar->alignment = (alignment == ~(uint32_t)0) ? (uint32_t)pointerSize : (uint32_t)(1U << (alignment & 31));
+        ivar->size = size;
+    }
+
+    *count = listCount;
+    return ivars;
+}
+
+//|++++++++++++++++++++++++++++++++++++|//
+//! Returns the address of the class_ro_t for the class at \a address.
+static mk_vm_address_t
+_MKObjCClassReadOnlyData(_MKObjCReader *reader, mk_vm_address_t address, uint64_t *taggedData)
+{
+    size_t pointerSize = reader->pointerSize;
+
+    // The low bits of the pointer are flags, which chained fixups and slide
+    // info preserve.
+    *taggedData = 0;
+    if (!_MKObjCReadPointer(reader, address + 4 * pointerSize, (mk_vm_address_t*)taggedData))
+        return 0;
+
+    mk_vm_address_t data = (mk_vm_address_t)(*taggedData & ((pointerSize == 8) ? FAST_DATA_MASK_64 : FAST_DATA_MASK_32));
+
+    // Classes in a live process may have been realized, in which case the
+    // data points at a class_rw_t, which in turn points at the class_ro_t
+    // (or at a class_rw_ext_t whose first field is the class_ro_t).
+    uint32_t flags;
+    if (data && _MKObjCReadUInt32(reader, data, &flags) && (flags & RW_REALIZED)) {
+        mk_vm_address_t roOrRWExt = 0;
+        if (!_MKObjCReadPointer(reader, data + 8, &roOrRWExt))
+            return 0;
+        if (roOrRWExt & 1) {
+            if (!_MKObjCReadPointer(reader, roOrRWExt & ~(mk_vm_address_t)1, &roOrRWExt))
+                return 0;
+        }
+        data = roOrRWExt;
+    }
+
+    return data;
+}
+
+//|++++++++++++++++++++++++++++++++++++|//
+static bool
+_MKObjCDecodeClass(_MKObjCReader *reader, mk_vm_address_t address, MKObjCClassRecord *cls)
+{
+    size_t pointerSize = reader->pointerSize;
+    uint64_t taggedData = 0;
+
+    cls->address = address;
+    if (!_MKObjCReadPointer(reader, address, &cls->metaClassAddress))
+        return false;
+    _MKObjCReadPointer(reader, address + pointerSize, &cls->superClassAddress);
+
+    cls->dataAddress = _MKObjCClassReadOnlyData(reader, address, &taggedData);
+    cls->isSwiftLegacy = !!(taggedData & FAST_IS_SWIFT_LEGACY);
+    cls->isSwiftStable = !!(taggedData & FAST_IS_SWIFT_STABLE);
+    if (cls->dataAddress == 0)
+        return false;
+
+    // struct class_ro_t.  The 64-bit layout has a reserved field before the
+    // first pointer.
+    mk_vm_address_t ro = cls->dataAddress;
+    mk_vm_address_t fields = ro + ((pointerSize == 8) ? 16 : 12);
+    mk_vm_address_t name = 0, methods = 0, protocols = 0, ivars = 0;
+
+    if (!_MKObjCReadUInt32(reader, ro, &cls->flags))
+        return false;
+    _MKObjCReadUInt32(reader, ro + 4, &cls->instanceStart);
+    _MKObjCReadUInt32(reader, ro + 8, &cls->instanceSize);
+    _MKObjCReadPointer(reader, fields + 1 * pointerSize, &name);
+    _MKObjCReadPointer(reader, fields + 2 * pointerSize, &methods);
+    _MKObjCReadPointer(reader, fields + 3 * pointerSize, &protocols);
+    _MKObjCReadPointer(reader, fields + 4 * pointerSize, &ivars);
+
+    cls->name = _MKObjCCopyString(reader, name);
+    _MKObjCDecodeMethodList(reader, methods, &cls->instanceMethods);
+    cls->protocols = _MKObjCDecodeProtocolList(reader, protocols, &cls->protocolCount);
+    cls->ivars = _MKObjCDecodeIVarList(reader, ivars, &cls->ivarCount);
+
+    // Class methods live in the metaclass' class_ro_t.
+    if (cls->metaClassAddress) {
+        uint64_t metaTaggedData;
+        mk_vm_address_t metaRO = _MKObjCClassReadOnlyData(reader, cls->metaClassAddress, &metaTaggedData);
+        mk_vm_address_t metaMethods = 0;
+        if (metaRO && _MKObjCReadPointer(reader, metaRO + ((pointerSize == 8) ? 16 : 12) + 2 * pointerSize, &metaMethods))
+            _MKObjCDecodeMethodList(reader, metaMethods, &cls->classMethods);
+    }
+
+    return true;
+}
+
+//|++++++++++++++++++++++++++++++++++++|//
+static bool
+_MKObjCDecodeCategory(_MKObjCReader *reader, mk_vm_address_t address, MKObjCCategoryRecord *cat)
+{
+    size_t pointerSize = reader->pointerSize;
+    mk_vm_address_t name = 0, instanceMethods = 0, classMethods = 0, protocols = 0;
+
+    // struct category_t
+    cat->address = address;
+    if (!_MKObjCReadPointer(reader, address, &name))
+        return false;
+    _MKObjCReadPointer(reader, address + 1 * pointerSize, &cat->classAddress);
+    _MKObjCReadPointer(reader, address + 2 * pointerSize, &instanceMethods);
+    _MKObjCReadPointer(reader, address + 3 * pointerSize, &classMethods);
+    _MKObjCReadPointer(reader, address + 4 * pointerSize, &protocols);
+
+    cat->name = _MKObjCCopyString(reader, name);
+    _MKObjCDecodeMethodList(reader, instanceMethods, &cat->instanceMethods);
+    _MKObjCDecodeMethodList(reader, classMethods, &cat->classMethods);
+    cat->protocols = _MKObjCDecodeProtocolList(reader, protocols, &cat->protocolCount);
+
+    return true;
+}
+
+//|++++++++++++++++++++++++++++++++++++|//
+static bool
+_MKObjCDecodeProtocol(_MKObjCReader *reader, mk_vm_address_t address, MKObjCProtocolRecord *proto)
+{
+    size_t pointerSize = reader->pointerSize;
+    mk_vm_address_t name = 0, protocols = 0;
+    mk_vm_address_t instanceMethods = 0, classMethods = 0, optionalInstanceMethods = 0, optionalClassMethods = 0;
+
+    // struct protocol_t
+    proto->address = address;
+    if (!_MKObjCReadPointer(reader, address + 1 * pointerSize, &name))
+        return false;
+    _MKObjCReadPointer(reader, address + 2 * pointerSize, &protocols);
+    _MKObjCReadPointer(reader, address + 3 * pointerSize, &instanceMethods);
+    _MKObjCReadPointer(reader, address + 4 * pointerSize, &classMethods);
+    _MKObjCReadPointer(reader, address + 5 * pointerSize, &optionalInstanceMethods);
+    _MKObjCReadPointer(reader, address + 6 * pointerSize, &optionalClassMethods);
+
+    proto->name = _MKObjCCopyString(reader, name);
+    proto->protocols = _MKObjCDecodeProtocolList(reader, protocols, &proto->protocolCount);
+    _MKObjCDecodeMethodList(reader, instanceMethods, &proto->instanceMethods);
+    _MKObjCDecodeMethodList(reader, classMethods, &proto->classMethods);
+    _MKObjCDecodeMethodList(reader, optionalInstanceMethods, &proto->optionalInstanceMethods);
+    _MKObjCDecodeMethodList(reader, optionalClassMethods, &proto->optionalClassMethods);
+
+    return true;
+}
+
+
+
+//----------------------------------------------------------------------------//
+@implementation MKObjCMetadata {
+    _MKObjCArenaBlock *_arena;
+    MKObjCClassRecord *_classes;
+    NSUInteger _classCount;
+    MKObjCCategoryRecord *_categories;
+    NSUInteger _categoryCount;
+    MKObjCProtocolRecord *_protocols;
+    NSUInteger _protocolCount;
+    // Indexes into _classes, sorted by class address.
+    uint32_t *_classesByAddress;
+}
+
+//|++++++++++++++++++++++++++++++++++++|//
+//! Returns the DYLD_CHAINED_PTR_* format of each segment of \a image, in
+//! load command order, or \c nil if the image does not use chained fixups.
+- (NSData*)_chainedPointerFormatsOfImage:(MKMachOImage*)image
+{
+    MKLCDyldChainedFixups *fixupsLC = [image loadCommandsOfType:LC_DYLD_CHAINED_FIXUPS].firstObject;
+    if (fixupsLC == nil || fixupsLC.datasize < sizeof(struct dyld_chained_fixups_header))
+        return nil;
+    
+    NSError *localError = nil;
+    MKLinkEditNode *fixups = [[MKLinkEditNode alloc] initWithSize:fixupsLC.datasize offset:fixupsLC.dataoff inImage:image error:&localError];
+    if (fixups == nil) {
+        MK_PUSH_WARNING_WITH_ERROR(classes, MK_EINTERNAL_ERROR, localError, @"Could not locate the chained fixups.");
+        return nil;
+    }
+    
+    const mk_byteorder_t *byteOrder = self.dataModel.byteOrder;
+    MKMemoryMap *memoryMap = fixups.memoryMap;
+    mk_vm_address_t contextAddress = fixups.nodeContextAddress;
+    uint32_t (^read32)(mk_vm_offset_t, bool*) = ^uint32_t(mk_vm_offset_t offset, bool *ok) {
+        uint32_t value = 0;
+        if (*ok && offset <= fixupsLC.datasize - sizeof(value))
+            *ok = [memoryMap copyBytesAtOffset:offset fromAddress:contextAddress into:&value length:sizeof(value) requireFull:YES error:NULL] == sizeof(value);
+        else
+            *ok = false;
+        return byteOrder->swap32(value);
+    };
+    
+    // struct dyld_chained_fixups_header, then struct dyld_chained_starts_in_image.
+    bool ok = true;
+    uint32_t startsOffset = read32(offsetof(struct dyld_chained_fixups_header, starts_offset), &ok);
+    uint32_t segmentCount = read32(startsOffset, &ok);
+    if (!ok || segmentCount > fixupsLC.datasize / sizeof(uint32_t)) {
+        MK_PUSH_WARNING(classes, MK_EINVALID_DATA, @"Could not read the chained fixups header.");
+        return nil;
+    }
+    
+    NSMutableData *formats = [NSMutableData dataWithLength:segmentCount * sizeof(uint16_t)];
+    uint16_t *format = formats.mutableBytes;
+    for (uint32_t i = 0; i < segmentCount && ok; i++) {
+        uint32_t segmentInfoOffset = read32((mk_vm_offset_t)startsOffset + sizeof(uint32_t) * (i + 1), &ok);
+        if (!ok || segmentInfoOffset == 0)
+            continue;
+        // struct dyld_chained_starts_in_segment { uint32_t size; uint16_t page_size; uint16_t pointer_format; ... }
+        uint32_t sizeAndPageSize = read32((mk_vm_offset_t)startsOffset + segmentInfoOffset + offsetof(struct dyld_chained_starts_in_segment, page_size), &ok);
+        format[i] = (uint16_t)(sizeAndPageSize >> 16);
+    }
+    
+    if (!ok) {
+        MK_PUSH_WARNING(classes, MK_EINVALID_DATA, @"Could not read the chained fixups segment starts.");
+        return nil;
+    }
+    
+    return formats;
+}
+
+//|++++++++++++++++++++++++++++++++++++|//
+- (instancetype)initWithImage:(MKMachOImage*)image error:(NSError**)error
+{
+    NSParameterAssert(image != nil);
+
+    self = [super initWithParent:image error:error];
+    if (self == nil) return nil;
+
+    MKDataModel *dataModel = self.dataModel;
+
+    _MKObjCReader reader = { 0 };
+    reader.byteOrder = dataModel.byteOrder;
+    reader.pointerSize = dataModel.pointerSize;
+    reader.ivarOffsetSize = dataModel.objcIVarOffsetSize;
+    reader.memoryMap = self.memoryMap;
+    reader.imageAddress = image.nodeVMAddress;
+    reader.arena = &_arena;
+    reader.stringsCapacity = 1024;
+    reader.strings = calloc(reader.stringsCapacity, sizeof(_MKObjCString));
+
+    if (reader.pointerSize != 8 && reader.pointerSize != 4) {
+        free(reader.strings);
+        NSString *reason = [NSString stringWithFormat:@"Unsupported pointer size [%zu].", reader.pointerSize];
+        @throw [NSException exceptionWithName:NSInvalidArgumentException reason:reason userInfo:nil];
+    }
+
+    if (image.isImageInSharedCache)
+    {
+        DyldSharedCache *dsc = image.dsc;
+        reader.dsc = dsc;
+        reader.dscBaseAddress = dsc_get_base_address(dsc);
+
+        for (unsigned i = 0; i < dsc->mappingCount; i++) {
+            DyldSharedCacheMapping *mapping = &dsc->mappings[i];
+            if (mapping->slideInfoPtr == NULL || mapping->slideInfoSize < sizeof(struct dyld_cache_slide_info2))
+                continue;
+
+            reader.slideVersion = *(uint32_t*)mapping->slideInfoPtr;
+            if (reader.slideVersion == 2) {
+                struct dyld_cache_slide_info2 *info = mapping->slideInfoPtr;
+                reader.slideValueMask = ~info->delta_mask;
+                reader.slideValueAdd = info->value_add;
+            } else if (reader.slideVersion == 5) {
+                reader.slideValueAdd = ((struct dyld_cache_slide_info5*)mapping->slideInfoPtr)->value_add;
+            }
+            break;
+        }
+
+        // Relative method lists in the shared cache name their selectors by
+        // an offset from a base selector.
+        struct dyld_cache_header *header = &dsc->files[0]->header;
+        if (header->mappingOffset >= offsetof(struct dyld_cache_header, objcOptsSize) + sizeof(header->objcOptsSize) && header->objcOptsOffset) {
+            struct objc_opts_header opts;
+            if (dsc_read_from_vmaddr(dsc, reader.dscBaseAddress + header->objcOptsOffset, sizeof(opts), &opts) == 0 && opts.relativeMethodSelectorBaseAddressOffset)
+                reader.selectorBase = reader.dscBaseAddress + opts.relativeMethodSelectorBaseAddressOffset;
+        }
+    }
+
+    // Pointers in images that dyld has not loaded may be encoded as chains
+    // of fixups.  Find the pointer format of each segment.
+    NSData *pointerFormats = image.isFromMemory ? nil : [self _chainedPointerFormatsOfImage:image];
+    
+    NSArray *segmentLoadCommands = [image loadCommandsOfType:(reader.pointerSize == 8) ? LC_SEGMENT_64 : LC_SEGMENT];
+    NSMutableArray<id<MKLCSection>> *classLists = [NSMutableArray array];
+    NSMutableArray<id<MKLCSection>> *categoryLists = [NSMutableArray array];
+    NSMutableArray<id<MKLCSection>> *protocolLists = [NSMutableArray array];
+
+    reader.regions = calloc(MAX(segmentLoadCommands.count, 1U), sizeof(_MKObjCRegion));
+
+    for (NSUInteger segmentIndex = 0; segmentIndex < segmentLoadCommands.count; segmentIndex++)
+    {
+        id<MKLCSegment> segmentLC = segmentLoadCommands[segmentIndex];
+        
+        for (id<MKLCSection> sectionLC in segmentLC.sections) {
+            if ([sectionLC.segname rangeOfString:@SEG_DATA].location != 0)
+                continue;
+
+            NSString *sectname = sectionLC.sectname;
+            if ([sectname isEqualToString:@"__objc_classlist"])
+                [classLists addObject:sectionLC];
+            else if ([sectname isEqualToString:@"__objc_catlist"])
+                [categoryLists addObject:sectionLC];
+            else if ([sectname isEqualToString:@"__objc_protolist"])
+                [protocolLists addObject:sectionLC];
+        }
+
+        // Shared cache images are read from the mapped cache instead.
+        if (reader.dsc || reader.regions == NULL)
+            continue;
+        if (segmentLC.initprot == VM_PROT_NONE || [segmentLC.segname isEqualToString:@SEG_LINKEDIT])
+            continue;
+
+        _MKObjCRegion *region = &reader.regions[reader.regionCount];
+        region->address = segmentLC.mk_vmaddr;
+        region->pointerFormat = (segmentIndex < pointerFormats.length / sizeof(uint16_t)) ? ((const uint16_t*)pointerFormats.bytes)[segmentIndex] : 0;
+
+        if (image.isFromMemory) {
+            region->size = segmentLC.mk_vmsize;
+            if (mk_vm_address_apply_slide(region->address, image.slide, &region->contextAddress))
+                continue;
+        } else {
+            region->size = segmentLC.mk_filesize;
+            if (mk_vm_address_add(image.nodeContextAddress, segmentLC.mk_fileoff, &region->contextAddress))
+                continue;
+        }
+
+        // Clamp the segment to what the memory map holds.
+        NSError *memoryMapError = nil;
+        region->size = [self.memoryMap mappingSizeAtOffset:0 fromAddress:region->contextAddress length:region->size error:&memoryMapError];
+        if (region->size == 0) {
+            MK_PUSH_WARNING_WITH_ERROR(classes, MK_EINTERNAL_ERROR, memoryMapError, @"Could not read segment %@.", segmentLC.segname);
+            continue;
+        }
+
+        reader.regionCount++;
+    }
+
+    // Records are sized from the lists up front.  An entry that can not be
+    // decoded is skipped rather than ending the list.
+    NSUInteger (^capacity)(NSArray<id<MKLCSection>>*) = ^(NSArray<id<MKLCSection>> *sections) {
+        mk_vm_size_t total = 0;
+        for (id<MKLCSection> section in sections)
+            total += section.mk_size / reader.pointerSize;
+        return (NSUInteger)MIN(total, (mk_vm_size_t)UINT32_MAX);
+    };
+
+    _classes = _MKObjCArenaAllocate(&_arena, capacity(classLists) * sizeof(MKObjCClassRecord));
+    _categories = _MKObjCArenaAllocate(&_arena, capacity(categoryLists) * sizeof(MKObjCCategoryRecord));
+    _protocols = _MKObjCArenaAllocate(&_arena, capacity(protocolLists) * sizeof(MKObjCProtocolRecord));
+
+    if (reader.strings == NULL || reader.regions == NULL || _classes == NULL || _categories == NULL || _protocols == NULL) {
+        free(reader.regions);
+        free(reader.strings);
+        MK_ERROR_OUT = [NSError mk_errorWithDomain:MKErrorDomain code:MK_EINTERNAL_ERROR description:@"Could not allocate Objective-C metadata records."];
+        return nil;
+    }
+
+    for (id<MKLCSection> section in classLists) {
+        for (mk_vm_size_t offset = 0; offset + reader.pointerSize <= section.mk_size; offset += reader.pointerSize) {
+            mk_vm_address_t address = 0;
+            if (!_MKObjCReadPointer(&reader, section.mk_addr + offset, &address) || address == 0)
+                continue;
+
+            if (_MKObjCDecodeClass(&reader, address, &_classes[_classCount]))
+                _classCount++;
+            else {
+                memset(&_classes[_classCount], 0, sizeof(MKObjCClassRecord));
+                MK_PUSH_WARNING(classes, MK_EINVALID_DATA, @"Could not decode class at address [0x%" MK_VM_PRIxADDR "].", address);
+            }
+        }
+    }
+
+    for (id<MKLCSection> section in categoryLists) {
+        for (mk_vm_size_t offset = 0; offset + reader.pointerSize <= section.mk_size; offset += reader.pointerSize) {
+            mk_vm_address_t address = 0;
+            if (!_MKObjCReadPointer(&reader, section.mk_addr + offset, &address) || address == 0)
+                continue;
+
+            if (_MKObjCDecodeCategory(&reader, address, &_categories[_categoryCount]))
+                _categoryCount++;
+            else {
+                memset(&_categories[_categoryCount], 0, sizeof(MKObjCCategoryRecord));
+                MK_PUSH_WARNING(categories, MK_EINVALID_DATA, @"Could not decode category at address [0x%" MK_VM_PRIxADDR "].", address);
+            }
+        }
+    }
+
+    for (id<MKLCSection> section in protocolLists) {
+        for (mk_vm_size_t offset = 0; offset + reader.pointerSize <= section.mk_size; offset += reader.pointerSize) {
+            mk_vm_address_t address = 0;
+            if (!_MKObjCReadPointer(&reader, section.mk_addr + offset, &address) || address == 0)
+                continue;
+
+            if (_MKObjCDecodeProtocol(&reader, address, &_protocols[_protocolCount]))
+                _protocolCount++;
+            else {
+                memset(&_protocols[_protocolCount], 0, sizeof(MKObjCProtocolRecord));
+                MK_PUSH_WARNING(protocols, MK_EINVALID_DATA, @"Could not decode protocol at address [0x%" MK_VM_PRIxADDR "].", address);
+            }
+        }
+    }
+
+    // Every string has been copied into the arena.
+    free(reader.regions);
+    free(reader.strings);
+
+    // Index the classes by address.
+    _classesByAddress = _MKObjCArenaAllocate(&_arena, MAX(_classCount, 1U) * sizeof(uint32_t));
+    if (_classesByAddress) {
+        for (uint32_t i = 0; i < _classCount; i++)
+            _classesByAddress[i] = i;
+
+        MKObjCClassRecord *classes = _classes;
+        qsort_b(_classesByAddress, _classCount, sizeof(uint32_t), ^int(const void *lhs, const void *rhs) {
+            mk_vm_address_t l = classes[*(const uint32_t*)lhs].address;
+            mk_vm_address_t r = classes[*(const uint32_t*)rhs].address;
+            return (l > r) - (l < r);
+        });
+    }
+
+    return self;
+}
+
+//|++++++++++++++++++++++++++++++++++++|//
+- (instancetype)initWithParent:(MKNode*)parent error:(NSError**)error
+{
+    NSParameterAssert([parent isKindOfClass:MKMachOImage.class]);
+    return [self initWithImage:(MKMachOImage*)parent error:error];
+}
+
+//|++++++++++++++++++++++++++++++++++++|//
+- (void)dealloc
+{
+    _MKObjCArenaFree(_arena);
+}
+
+//|++++++++++++++++++++++++++++++++++++|//
+- (NSUInteger)estimatedMemoryCost
+{
+    NSUInteger cost = super.estimatedMemoryCost;
+    for (_MKObjCArenaBlock *block = _arena; block; block = block->next)
+        cost += sizeof(_MKObjCArenaBlock) + block->size;
+    return cost;
+}
+
+//◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦//
+#pragma mark -  Records
+//◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦//
+
+@synthesize classCount = _classCount;
+@synthesize categoryCount = _categoryCount;
+@synthesize protocolCount = _protocolCount;
+
+//|++++++++++++++++++++++++++++++++++++|//
+- (const MKObjCClassRecord *)classes
+{ return _classes; }
+
+//|++++++++++++++++++++++++++++++++++++|//
+- (const MKObjCCategoryRecord *)categories
+{ return _categories; }
+
+//|++++++++++++++++++++++++++++++++++++|//
+- (const MKObjCProtocolRecord *)protocols
+{ return _protocols; }
+
+//|++++++++++++++++++++++++++++++++++++|//
+- (MKMachOImage*)image
+{ return (MKMachOImage*)self.parent; }
+
+//|++++++++++++++++++++++++++++++++++++|//
+- (const MKObjCClassRecord *)classRecordAtAddress:(mk_vm_address_t)address
+{
+    if (_classesByAddress == NULL)
+        return NULL;
+
+    NSUInteger lo = 0, hi = _classCount;
+    while (lo < hi) {
+        NSUInteger mid = lo + (hi - lo) / 2;
+        const MKObjCClassRecord *cls = &_classes[_classesByAddress[mid]];
+        if (cls->address == address)
+            return cls;
+        else if (cls->address < address)
+            lo = mid + 1;
+        else
+            hi = mid;
+    }
+
+    return NULL;
+}
+
+//◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦//
+#pragma mark -  Nodes
+//◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦//
+
+//|++++++++++++++++++++++++++++++++++++|//
+- (MKResult*)classNodeForRecord:(const MKObjCClassRecord *)record
+{ return [self.image childNodeAtVMAddress:record->address targetClass:MKObjCClass.class]; }
+
+//|++++++++++++++++++++++++++++++++++++|//
+- (MKResult*)categoryNodeForRecord:(const MKObjCCategoryRecord *)record
+{ return [self.image childNodeAtVMAddress:record->address targetClass:MKObjCCategory.class]; }
+
+//|++++++++++++++++++++++++++++++++++++|//
+- (MKResult*)protocolNodeForRecord:(const MKObjCProtocolRecord *)record
+{ return [self.image childNodeAtVMAddress:record->address targetClass:MKObjCProtocol.class]; }
+
+//◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦//
+#pragma mark -  MKNode
+//◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦//
+
+//|++++++++++++++++++++++++++++++++++++|//
+- (MKNodeDescription*)layout
+{
+    MKNodeFieldBuilder *classCount = [MKNodeFieldBuilder
+        builderWithProperty:MK_PROPERTY(classCount)
+        type:MKNodeFieldTypeUnsignedQuadWord.sharedInstance
+    ];
+    classCount.description = @"Classes";
+    classCount.options = MKNodeFieldOptionDisplayAsDetail;
+
+    MKNodeFieldBuilder *categoryCount = [MKNodeFieldBuilder
+        builderWithProperty:MK_PROPERTY(categoryCount)
+        type:MKNodeFieldTypeUnsignedQuadWord.sharedInstance
+    ];
+    categoryCount.description = @"Categories";
+    categoryCount.options = MKNodeFieldOptionDisplayAsDetail;
+
+    MKNodeFieldBuilder *protocolCount = [MKNodeFieldBuilder
+        builderWithProperty:MK_PROPERTY(protocolCount)
+        type:MKNodeFieldTypeUnsignedQuadWord.sharedInstance
+    ];
+    protocolCount.description = @"Protocols";
+    protocolCount.options = MKNodeFieldOptionDisplayAsDetail;
+
+    return [MKNodeDescription nodeDescriptionWithParentDescription:super.layout fields:@[
+        classCount.build,
+        categoryCount.build,
+        protocolCount.build
+    ]];
+}
+
+@end
@@ -31,6 +31,7 @@
 #import "MKRebaseCommand.h"
 #import "MKMachO+Segments.h"
 #import "MKSegment.h"
+#import "MKNodeSerializer.h"
 
 //----------------------------------------------------------------------------//
 @implementation MKFixup
@@ -115,6 +116,10 @@
 	return [(MKBackedNode*)self.parent nodeAddress:type] + _nodeOffset;
 }
 
+//|++++++++++++++++++++++++++++++++++++|//
++ (BOOL)hasInvariantLayout
+{ return YES; }
+
 //|++++++++++++++++++++++++++++++++++++|//
 - (MKNodeDescription*)layout
 {
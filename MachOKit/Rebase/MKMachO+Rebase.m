@@ -27,6 +27,7 @@
 
 #import "MKMachO+Rebase.h"
 #import "MKInternal.h"
+#import "_MKMachOImage+NodeCache.h"
 
 #import "MKRebaseInfo.h"
 
@@ -40,20 +41,17 @@
 //|++++++++++++++++++++++++++++++++++++|//
 - (MKResult*)rebaseInfo
 {
-    if (_rebaseInfo == nil)
-    {
+    return [self _subtreeForKey:@"rebaseInfo" storage:&_rebaseInfo builder:^MKResult* {
         NSError *rebaseInfoError = nil;
         
         MKRebaseInfo *rebaseInfo = [[MKRebaseInfo alloc] initWithParent:self error:&rebaseInfoError];
         if (rebaseInfo)
-            _rebaseInfo = [[MKResult alloc] initWithValue:rebaseInfo];
+            return [[MKResult alloc] initWithValue:rebaseInfo];
         else if (rebaseInfoError /* Only failed if we have an error */)
-            _rebaseInfo = [[MKResult alloc] initWithError:rebaseInfoError];
+            return [[MKResult alloc] initWithError:rebaseInfoError];
         else
-            _rebaseInfo = [MKResult new];
-    }
-    
-    return _rebaseInfo;
+            return [MKResult new];
+    }];
 }
 
 //◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦//
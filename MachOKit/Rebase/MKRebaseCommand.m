@@ -28,6 +28,7 @@
 #import "MKRebaseCommand.h"
 #import "MKInternal.h"
 #import "MKRebaseInfo.h"
+#import "MKNodeSerializer.h"
 
 static NSSet *_subclasses = NULL;
 //----------------------------------------------------------------------------//
@@ -150,6 +151,10 @@ static NSSet *_subclasses = NULL;
 #pragma mark - 	MKNode
 //◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦//
 
+//|++++++++++++++++++++++++++++++++++++|//
++ (BOOL)hasInvariantLayout
+{ return YES; }
+
 //|++++++++++++++++++++++++++++++++++++|//
 - (MKNodeDescription*)layout
 {
@@ -36,6 +36,8 @@ struct MKRebaseContext
 	uint8_t type;
 	unsigned segmentIndex;
 	mk_vm_offset_t offset;
+	// Set by the rebase handler to stop the current command.
+	bool stop;
 #if __has_feature(objc_arc)
 	void *command;
 	void *info;
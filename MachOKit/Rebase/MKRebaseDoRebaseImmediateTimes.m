@@ -55,7 +55,7 @@
 //|++++++++++++++++++++++++++++++++++++|//
 - (BOOL)rebase:(void (^)(void))rebase withContext:(struct MKRebaseContext*)rebaseContext error:(NSError**)error
 {
-	for (uint8_t i = 0; i < self.count; i++) {
+	for (uint8_t i = 0; i < self.count && !rebaseContext->stop; i++) {
 		rebase();
 		
 		mk_error_t err;
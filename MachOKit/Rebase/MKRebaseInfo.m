@@ -58,17 +58,28 @@
         return self;
     }
     
+    // The opcodes are read once, in order.
+    [self adviseAccess:MKMemoryAccessAdviceSequential];
+    
     // Load Rebase Commands
     @autoreleasepool
     {
         NSMutableArray<__kindof MKRebaseCommand*> *commands = [[NSMutableArray alloc] initWithCapacity:(NSUInteger)size/3];
         mk_vm_offset_t offset = 0;
         
+        mk_budget_meter_t meter;
+        MKBudgetMeterInit(&meter, self);
+        
         // Cast to mk_vm_size_t is safe; nodeSize can't be larger than UINT32_MAX.
         while (offset < self.nodeSize)
         {
             NSError *rebaseCommandError = nil;
             
+            if (mk_budget_meter_charge(&meter, 1, 0, 0)) {
+                MK_PUSH_WARNING(commands, MK_EBUDGET_EXCEEDED, @"Exceeded the work budget before the rebase command at offset [%" MK_VM_PRIuOFFSET "].", offset);
+                break;
+            }
+            
             MKRebaseCommand *command = [MKRebaseCommand commandAtOffset:offset fromParent:self error:&rebaseCommandError];
             if (command == nil) {
 				MK_PUSH_WARNING_WITH_ERROR(commands, MK_EINTERNAL_ERROR, rebaseCommandError, @"Could not parse rebase command at offset [%" MK_VM_PRIuOFFSET "].", offset);
@@ -98,14 +109,26 @@
         __block NSError *rebaseError = nil;
 		// Initialize the rebase context to zero in order to match dyld's behavior.
         __block struct MKRebaseContext context = { 0, .info = (__bridge void *)self };
+        // A single command can repeat a rebase an arbitrary number of times.
+        __block mk_budget_meter_t meter;
+        MKBudgetMeterInit(&meter, self);
 		
         void (^doRebase)(void) = ^{
+            if (mk_budget_meter_charge(&meter, 0, 1, 0)) {
+                MK_PUSH_WARNING(fixups, MK_EBUDGET_EXCEEDED, @"Exceeded the work budget after %lu fixups.", (unsigned long)fixups.count);
+                keepGoing = NO;
+                context.stop = true;
+                return;
+            }
+            
 			MKFixup *fixup = [[MKFixup alloc] initWithContext:&context error:&rebaseError];
             
-            if (fixup)
+            if (fixup) {
                 [fixups addObject:fixup];
-            else
+            } else {
                 keepGoing = NO;
+                context.stop = true;
+            }
             
         };
         
@@ -167,6 +190,14 @@
 - (instancetype)initWithParent:(MKNode*)parent error:(NSError**)error
 { return [self initWithImage:parent.macho error:error]; }
 
+//◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦//
+#pragma mark -  Estimating Memory Usage
+//◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦//
+
+//|++++++++++++++++++++++++++++++++++++|//
+- (NSUInteger)estimatedMemoryCost
+{ return super.estimatedMemoryCost + MKEstimatedMemoryCostOfNodes(_commands) + MKEstimatedMemoryCostOfNodes(_fixups); }
+
 //◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦//
 #pragma mark -  MKNode
 //◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦//
@@ -0,0 +1,90 @@
+//----------------------------------------------------------------------------//
+//|
+//|             MachOKit - A Lightweight Mach-O Parsing Library
+//! @file       MKParseResultCache.h
+//!
+//! @author     D.V.
+//! @copyright  Copyright (c) 2014-2015 D.V. All rights reserved.
+//|
+//| Permission is hereby granted, free of charge, to any person obtaining a
+//| copy of this software and associated documentation files (the "Software"),
+//| to deal in the Software without restriction, including without limitation
+//| the rights to use, copy, modify, merge, publish, distribute, sublicense,
+//| and/or sell copies of the Software, and to permit persons to whom the
+//| Software is furnished to do so, subject to the following conditions:
+//|
+//| The above copyright notice and this permission notice shall be included
+//| in all copies or substantial portions of the Software.
+//|
+//| THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+//| OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+//| MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+//| IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+//| CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+//| TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+//| SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+//----------------------------------------------------------------------------//
+
+#include <MachOKit/macho.h>
+#import <Foundation/Foundation.h>
+
+#import <MachOKit/MKParseResults.h>
+
+@class MKMachOImage;
+
+NS_ASSUME_NONNULL_BEGIN
+
+//----------------------------------------------------------------------------//
+//! @name       Parse Result Cache Options
+//! @relates    MKParseResultCache
+//
+typedef NS_OPTIONS(NSUInteger, MKParseResultCacheOptions) {
+    MKParseResultCacheOptionNone            = 0,
+    //! Fingerprint the bytes backing each subsystem, so that only the
+    //! subsystems whose \c __LINKEDIT data or segment contents changed are
+    //! parsed again.  Without this option, cached results are used only if
+    //! the Mach header and load commands of the image are unchanged.
+    MKParseResultCacheOptionContentHashes   = 1UL << 0,
+};
+
+
+
+//----------------------------------------------------------------------------//
+//! The \c MKParseResultCache class persists the results of parsing an image
+//! to a directory, so that analyzing an unchanged binary again does not
+//! require parsing it.
+//!
+//! Results are stored in one file per image, named after its \c LC_UUID.
+//! Each file records a hash of the Mach header and load commands, and a
+//! fingerprint for each subsystem.  When results are requested, subsystems
+//! whose fingerprint matches are read back from the file and the others
+//! are parsed from the image.  The file is then rewritten atomically.
+//!
+//! The cache is best effort.  A missing, stale or corrupt file is treated
+//! as empty.  Failing to write a file does not fail the request, and is
+//! reported in \ref MKParseResults.writeError instead.
+//
+@interface MKParseResultCache : NSObject
+
+- (instancetype)initWithDirectoryURL:(NSURL*)directoryURL options:(MKParseResultCacheOptions)options NS_DESIGNATED_INITIALIZER;
+
+- (instancetype)init NS_UNAVAILABLE;
+
+@property (nonatomic, strong, readonly) NSURL *directoryURL;
+@property (nonatomic, assign, readonly) MKParseResultCacheOptions options;
+
+//! Returns the results of parsing the given \a subsystems of \a image,
+//! reading them from the cache where possible.
+//!
+//! @return
+//! \c nil if the Mach header and load commands of \a image could not be
+//! read.  Subsystems that fail to parse are reported in the
+//! \ref MKParseResults.errors of the result.
+- (nullable MKParseResults*)resultsForImage:(MKMachOImage*)image subsystems:(MKParseResultSubsystems)subsystems error:(NSError**)error;
+
+//! Removes the cached results for \a image, if any.
+- (BOOL)removeResultsForImage:(MKMachOImage*)image error:(NSError**)error;
+
+@end
+
+NS_ASSUME_NONNULL_END
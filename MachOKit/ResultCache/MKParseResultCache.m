@@ -0,0 +1,779 @@
+//----------------------------------------------------------------------------//
+//|
+//|             MachOKit - A Lightweight Mach-O Parsing Library
+//|             MKParseResultCache.m
+//|
+//|             D.V.
+//|             Copyright (c) 2014-2015 D.V. All rights reserved.
+//|
+//| Permission is hereby granted, free of charge, to any person obtaining a
+//| copy of this software and associated documentation files (the "Software"),
+//| to deal in the Software without restriction, including without limitation
+//| the rights to use, copy, modify, merge, publish, distribute, sublicense,
+//| and/or sell copies of the Software, and to permit persons to whom the
+//| Software is furnished to do so, subject to the following conditions:
+//|
+//| The above copyright notice and this permission notice shall be included
+//| in all copies or substantial portions of the Software.
+//|
+//| THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+//| OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+//| MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+//| IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+//| CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+//| TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+//| SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+//----------------------------------------------------------------------------//
+
+
+#import "MKParseResultCache.h"
+#import "MKInternal.h"
+#import "_MKParseResultCache.h"
+#import "MKMachO.h"
+#import "MKMachHeader.h"
+#import "MKLinkEditNode.h"
+#import "MKLCUUID.h"
+#import "MKLCSymtab.h"
+#import "MKLCDyldInfo.h"
+#import "MKLCDyldExportsTrie.h"
+#import "MKMachO+Segments.h"
+#import "MKSegment.h"
+#import "MKMachO+Symbols.h"
+#import "MKSymbolTable.h"
+#import "MKSymbol.h"
+#import "MKCString.h"
+#import "MKMachO+Exports.h"
+#import "MKExportsInfo.h"
+#import "MKExport.h"
+#import "MKRegularExport.h"
+#import "MKReExport.h"
+#import "MKMachO+Rebase.h"
+#import "MKRebaseInfo.h"
+#import "MKFixup.h"
+#import "MKBindTable.h"
+#import "MKMachO+ObjC.h"
+#import "MKObjCMetadata.h"
+
+//◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦//
+#pragma mark -  Hashing
+//
+// XXH64.  Fingerprints only need to detect changes between builds, not
+// resist tampering, so a fast non-cryptographic hash is used.
+//◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦//
+
+#define MK_HASH_PRIME1  0x9E3779B185EBCA87ULL
+#define MK_HASH_PRIME2  0xC2B2AE3D27D4EB4FULL
+#define MK_HASH_PRIME3  0x165667B19E3779F9ULL
+#define MK_HASH_PRIME4  0x85EBCA77C2B2AE63ULL
+#define MK_HASH_PRIME5  0x27D4EB2F165667C5ULL
+
+//|++++++++++++++++++++++++++++++++++++|//
+static inline uint64_t
+MKHashRotate(uint64_t value, int count)
+{ return (value << count) | (value >> (64 - count)); }
+
+//|++++++++++++++++++++++++++++++++++++|//
+static inline uint64_t
+MKHashRead64(const uint8_t *p)
+{ uint64_t value; memcpy(&value, p, sizeof(value)); return OSSwapLittleToHostInt64(value); }
+
+//|++++++++++++++++++++++++++++++++++++|//
+static inline uint32_t
+MKHashRead32(const uint8_t *p)
+{ uint32_t value; memcpy(&value, p, sizeof(value)); return OSSwapLittleToHostInt32(value); }
+
+//|++++++++++++++++++++++++++++++++++++|//
+static inline uint64_t
+MKHashRound(uint64_t accumulator, uint64_t input)
+{ return MKHashRotate(accumulator + input * MK_HASH_PRIME2, 31) * MK_HASH_PRIME1; }
+
+//|++++++++++++++++++++++++++++++++++++|//
+static inline uint64_t
+MKHashMerge(uint64_t accumulator, uint64_t value)
+{ return (accumulator ^ MKHashRound(0, value)) * MK_HASH_PRIME1 + MK_HASH_PRIME4; }
+
+//|++++++++++++++++++++++++++++++++++++|//
+static uint64_t
+MKHash(const void *data, size_t length, uint64_t seed)
+{
+    const uint8_t *p = data;
+    const uint8_t *end = p + length;
+    uint64_t hash;
+    
+    if (length >= 32) {
+        uint64_t v1 = seed + MK_HASH_PRIME1 + MK_HASH_PRIME2;
+        uint64_t v2 = seed + MK_HASH_PRIME2;
+        uint64_t v3 = seed;
+        uint64_t v4 = seed - MK_HASH_PRIME1;
+        
+        do {
+            v1 = MKHashRound(v1, MKHashRead64(p));
+            v2 = MKHashRound(v2, MKHashRead64(p + 8));
+            v3 = MKHashRound(v3, MKHashRead64(p + 16));
+            v4 = MKHashRound(v4, MKHashRead64(p + 24));
+            p += 32;
+        } while (p + 32 <= end);
+        
+        hash = MKHashRotate(v1, 1) + MKHashRotate(v2, 7) + MKHashRotate(v3, 12) + MKHashRotate(v4, 18);
+        hash = MKHashMerge(hash, v1);
+        hash = MKHashMerge(hash, v2);
+        hash = MKHashMerge(hash, v3);
+        hash = MKHashMerge(hash, v4);
+    } else {
+        hash = seed + MK_HASH_PRIME5;
+    }
+    
+    hash += (uint64_t)length;
+    
+    for (; p + 8 <= end; p += 8)
+        hash = MKHashRotate(hash ^ MKHashRound(0, MKHashRead64(p)), 27) * MK_HASH_PRIME1 + MK_HASH_PRIME4;
+    if (p + 4 <= end) {
+        hash = MKHashRotate(hash ^ (MKHashRead32(p) * MK_HASH_PRIME1), 23) * MK_HASH_PRIME2 + MK_HASH_PRIME3;
+        p += 4;
+    }
+    for (; p < end; p++)
+        hash = MKHashRotate(hash ^ (*p * MK_HASH_PRIME5), 11) * MK_HASH_PRIME1;
+    
+    hash ^= hash >> 33;
+    hash *= MK_HASH_PRIME2;
+    hash ^= hash >> 29;
+    hash *= MK_HASH_PRIME3;
+    hash ^= hash >> 32;
+    return hash;
+}
+
+//|++++++++++++++++++++++++++++++++++++|//
+static inline uint64_t
+MKHashCombine(uint64_t hash, uint64_t value)
+{ return MKHash(&value, sizeof(value), hash); }
+
+
+
+//----------------------------------------------------------------------------//
+@implementation MKParseResultCache
+
+@synthesize directoryURL = _directoryURL;
+@synthesize options = _options;
+
+//|++++++++++++++++++++++++++++++++++++|//
+- (instancetype)initWithDirectoryURL:(NSURL*)directoryURL options:(MKParseResultCacheOptions)options
+{
+    NSParameterAssert(directoryURL.isFileURL);
+    
+    self = [super init];
+    if (self == nil) return nil;
+    
+    _directoryURL = directoryURL;
+    _options = options;
+    
+    return self;
+}
+
+//|++++++++++++++++++++++++++++++++++++|//
+- (instancetype)init
+{ @throw [NSException exceptionWithName:NSInvalidArgumentException reason:@"-init unavailable." userInfo:nil]; }
+
+//◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦//
+#pragma mark -  Fingerprints
+//◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦//
+
+//|++++++++++++++++++++++++++++++++++++|//
+//! Hashes the Mach header and load commands of \a image.
+- (BOOL)_loadCommandsHash:(uint64_t*)hash ofImage:(MKMachOImage*)image error:(NSError**)error
+{
+    MKMachHeader *header = image.header;
+    mk_vm_size_t length = header.nodeSize + header.sizeofcmds;
+    __block NSError *memoryMapError = nil;
+    
+    [image.memoryMap remapBytesAtOffset:0 fromAddress:image.nodeContextAddress length:length requireFull:YES withHandler:^(vm_address_t address, vm_size_t mappedLength, NSError *e) {
+        if (address == 0) { memoryMapError = e; return; }
+        *hash = MKHash((const void*)address, mappedLength, 0);
+    }];
+    
+    if (memoryMapError) {
+        MK_ERROR_OUT = [NSError mk_errorWithDomain:MKErrorDomain code:MK_EINTERNAL_ERROR underlyingError:memoryMapError description:@"Could not read the load commands of %@.", image];
+        return NO;
+    }
+    
+    return YES;
+}
+
+//|++++++++++++++++++++++++++++++++++++|//
+//! Folds the \c __LINKEDIT data at \a offset into \a hash.
+- (BOOL)_hashLinkEditDataOfImage:(MKMachOImage*)image offset:(uint64_t)offset size:(uint64_t)size into:(uint64_t*)hash error:(NSError**)error
+{
+    *hash = MKHashCombine(MKHashCombine(*hash, offset), size);
+    if (size == 0)
+        return YES;
+    
+    MKLinkEditNode *data = [[MKLinkEditNode alloc] initWithSize:size offset:offset inImage:image error:error];
+    if (data == nil)
+        return NO;
+    
+    __block NSError *memoryMapError = nil;
+    
+    [data.memoryMap remapBytesAtOffset:0 fromAddress:data.nodeContextAddress length:size requireFull:YES withHandler:^(vm_address_t address, vm_size_t length, NSError *e) {
+        if (address == 0) { memoryMapError = e; return; }
+        *hash = MKHash((const void*)address, length, *hash);
+    }];
+    
+    if (memoryMapError) {
+        MK_ERROR_OUT = memoryMapError;
+        return NO;
+    }
+    
+    return YES;
+}
+
+//|++++++++++++++++++++++++++++++++++++|//
+//! Folds the layout of each segment into \a hash.  If \a contents is
+//! \c YES, the file contents of every segment except \c __LINKEDIT are
+//! folded in as well.
+- (BOOL)_hashSegmentsOfImage:(MKMachOImage*)image contents:(BOOL)contents into:(uint64_t*)hash error:(NSError**)error
+{
+    for (MKResult<MKSegment*> *result in image.segments) {
+        MKSegment *segment = result.value;
+        if (segment == nil)
+            continue;
+        
+        const char *name = segment.name.UTF8String ?: "";
+        *hash = MKHash(name, strlen(name), *hash);
+        *hash = MKHashCombine(*hash, segment.vmAddress);
+        *hash = MKHashCombine(*hash, segment.vmSize);
+        *hash = MKHashCombine(*hash, segment.fileOffset);
+        *hash = MKHashCombine(*hash, segment.fileSize);
+        
+        if (!contents || segment.fileSize == 0 || [segment.name isEqualToString:@SEG_LINKEDIT])
+            continue;
+        
+        __block NSError *memoryMapError = nil;
+        
+        [segment.memoryMap remapBytesAtOffset:0 fromAddress:segment.nodeContextAddress length:segment.fileSize requireFull:YES withHandler:^(vm_address_t address, vm_size_t length, NSError *e) {
+            if (address == 0) { memoryMapError = e; return; }
+            *hash = MKHash((const void*)address, length, *hash);
+        }];
+        
+        if (memoryMapError) {
+            MK_ERROR_OUT = [NSError mk_errorWithDomain:MKErrorDomain code:MK_EINTERNAL_ERROR underlyingError:memoryMapError description:@"Could not read the contents of %@.", segment];
+            return NO;
+        }
+    }
+    
+    return YES;
+}
+
+//|++++++++++++++++++++++++++++++++++++|//
+- (MKLCDyldInfo*)_dyldInfoOfImage:(MKMachOImage*)image
+{ return [image loadCommandsOfType:LC_DYLD_INFO_ONLY].firstObject ?: [image loadCommandsOfType:LC_DYLD_INFO].firstObject; }
+
+//|++++++++++++++++++++++++++++++++++++|//
+//! Computes the fingerprint that cached results of \a subsystem must match.
+//! Without content hashes, this is the hash of the load commands.
+//! Otherwise it covers the bytes that \a subsystem is parsed from.
+- (BOOL)_fingerprint:(uint64_t*)fingerprint ofSubsystem:(MKParseResultSubsystems)subsystem inImage:(MKMachOImage*)image loadCommandsHash:(uint64_t)loadCommandsHash error:(NSError**)error
+{
+    if ((_options & MKParseResultCacheOptionContentHashes) == 0) {
+        *fingerprint = loadCommandsHash;
+        return YES;
+    }
+    
+    uint64_t hash = MKHashCombine(0, subsystem);
+    MKLCDyldInfo *dyldInfo = [self _dyldInfoOfImage:image];
+    
+    switch (subsystem) {
+        case MKParseResultSubsystemSymbols:
+        {
+            MKLCSymtab *symtab = [image loadCommandsOfType:LC_SYMTAB].firstObject;
+            uint32_t magic = image.header.magic;
+            uint64_t entrySize = (magic == MH_MAGIC_64 || magic == MH_CIGAM_64) ? sizeof(struct nlist_64) : sizeof(struct nlist);
+            
+            if (symtab && (![self _hashLinkEditDataOfImage:image offset:symtab.symoff size:symtab.nsyms * entrySize into:&hash error:error] ||
+                           ![self _hashLinkEditDataOfImage:image offset:symtab.stroff size:symtab.strsize into:&hash error:error]))
+                return NO;
+            break;
+        }
+        case MKParseResultSubsystemExports:
+        {
+            MKLCDyldExportsTrie *exportsTrie = [image loadCommandsOfType:LC_DYLD_EXPORTS_TRIE].firstObject;
+            
+            if (![self _hashSegmentsOfImage:image contents:NO into:&hash error:error])
+                return NO;
+            if (dyldInfo && ![self _hashLinkEditDataOfImage:image offset:dyldInfo.export_off size:dyldInfo.export_size into:&hash error:error])
+                return NO;
+            if (exportsTrie && ![self _hashLinkEditDataOfImage:image offset:exportsTrie.dataoff size:exportsTrie.datasize into:&hash error:error])
+                return NO;
+            break;
+        }
+        case MKParseResultSubsystemFixups:
+        {
+            if (![self _hashSegmentsOfImage:image contents:NO into:&hash error:error])
+                return NO;
+            if (dyldInfo && (![self _hashLinkEditDataOfImage:image offset:dyldInfo.rebase_off size:dyldInfo.rebase_size into:&hash error:error] ||
+                             ![self _hashLinkEditDataOfImage:image offset:dyldInfo.bind_off size:dyldInfo.bind_size into:&hash error:error] ||
+                             ![self _hashLinkEditDataOfImage:image offset:dyldInfo.weak_bind_off size:dyldInfo.weak_bind_size into:&hash error:error] ||
+                             ![self _hashLinkEditDataOfImage:image offset:dyldInfo.lazy_bind_off size:dyldInfo.lazy_bind_size into:&hash error:error]))
+                return NO;
+            break;
+        }
+        case MKParseResultSubsystemObjC:
+        {
+            // Superclasses are resolved through binds.
+            if (![self _hashSegmentsOfImage:image contents:YES into:&hash error:error])
+                return NO;
+            if (dyldInfo && ![self _hashLinkEditDataOfImage:image offset:dyldInfo.bind_off size:dyldInfo.bind_size into:&hash error:error])
+                return NO;
+            break;
+        }
+        default:
+            break;
+    }
+    
+    *fingerprint = hash;
+    return YES;
+}
+
+//◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦//
+#pragma mark -  Parsing
+//◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦//
+
+//|++++++++++++++++++++++++++++++++++++|//
+static uint64_t
+MKParseResultAppendString(NSMutableData *strings, const char *string)
+{
+    if (string == NULL)
+        return MK_PARSE_RESULT_NO_STRING;
+    
+    uint64_t offset = strings.length;
+    [strings appendBytes:string length:strlen(string) + 1];
+    return offset;
+}
+
+//|++++++++++++++++++++++++++++++++++++|//
+- (BOOL)_encodeSymbolsOfImage:(MKMachOImage*)image records:(NSMutableData*)records strings:(NSMutableData*)strings error:(NSError**)error
+{
+    MKResult<MKSymbolTable*> *symbolTable = image.symbolTable;
+    if (symbolTable.error) {
+        MK_ERROR_OUT = symbolTable.error;
+        return NO;
+    }
+    
+    for (MKSymbol *symbol in symbolTable.value.symbols) {
+        struct mk_parse_result_symbol record = {
+            .name = MKParseResultAppendString(strings, symbol->_name.value.string.UTF8String),
+            .value = symbol.value,
+            .type = symbol.type,
+            .sect = symbol.sect,
+            .desc = symbol.desc
+        };
+        [records appendBytes:&record length:sizeof(record)];
+    }
+    
+    return YES;
+}
+
+//|++++++++++++++++++++++++++++++++++++|//
+- (BOOL)_encodeExportsOfImage:(MKMachOImage*)image records:(NSMutableData*)records strings:(NSMutableData*)strings error:(NSError**)error
+{
+    MKResult<MKExportsInfo*> *exportsInfo = image.exportsInfo;
+    if (exportsInfo.error) {
+        MK_ERROR_OUT = exportsInfo.error;
+        return NO;
+    }
+    
+    for (MKExport *export in exportsInfo.value.exports) {
+        struct mk_parse_result_export record = {
+            .name = MKParseResultAppendString(strings, export.name.UTF8String),
+            .importedName = MK_PARSE_RESULT_NO_STRING,
+            .options = export.options,
+            .kind = export.kind
+        };
+        
+        if ([export isKindOfClass:MKRegularExport.class]) {
+            record.address = [(MKRegularExport*)export address];
+        } else if ([export isKindOfClass:MKReExport.class]) {
+            MKReExport *reexport = (MKReExport*)export;
+            record.sourceLibraryOrdinal = reexport.sourceLibraryOrdinal;
+            record.importedName = MKParseResultAppendString(strings, reexport.importedName.UTF8String);
+        }
+        
+        [records appendBytes:&record length:sizeof(record)];
+    }
+    
+    return YES;
+}
+
+//|++++++++++++++++++++++++++++++++++++|//
+- (BOOL)_encodeFixupsOfImage:(MKMachOImage*)image records:(NSMutableData*)records strings:(NSMutableData*)strings error:(NSError**)error
+{
+    MKResult<MKRebaseInfo*> *rebaseInfo = image.rebaseInfo;
+    if (rebaseInfo.error) {
+        MK_ERROR_OUT = rebaseInfo.error;
+        return NO;
+    }
+    
+    for (MKFixup *fixup in rebaseInfo.value.fixups) {
+        struct mk_parse_result_fixup record = {
+            .address = fixup.address,
+            .symbolName = MK_PARSE_RESULT_NO_STRING,
+            .kind = MKParseResultFixupKindRebase,
+            .type = fixup.type
+        };
+        [records appendBytes:&record length:sizeof(record)];
+    }
+    
+    static const struct { MKBindTableKind table; MKParseResultFixupKind fixup; } kinds[] = {
+        { MKBindTableKindBind, MKParseResultFixupKindBind },
+        { MKBindTableKindWeakBind, MKParseResultFixupKindWeakBind },
+        { MKBindTableKindLazyBind, MKParseResultFixupKindLazyBind },
+    };
+    
+    for (size_t i = 0; i < sizeof(kinds)/sizeof(kinds[0]); i++) {
+        MKBindTable *bindTable = [[MKBindTable alloc] initWithImage:image kind:kinds[i].table error:error];
+        if (bindTable == nil)
+            return NO;
+        
+        // Consecutive binds usually share a symbol, and the symbol name
+        // points into the opcode stream, so only store it when it changes.
+        __block const char *lastSymbolName = NULL;
+        __block uint64_t lastSymbolNameOffset = MK_PARSE_RESULT_NO_STRING;
+        MKParseResultFixupKind kind = kinds[i].fixup;
+        
+        BOOL success = [bindTable enumerateBindsWithError:error usingBlock:^(const MKBindTableEntry *entry, __unused BOOL *stop) {
+            if (entry->symbolName != lastSymbolName) {
+                lastSymbolName = entry->symbolName;
+                lastSymbolNameOffset = MKParseResultAppendString(strings, entry->symbolName);
+            }
+            
+            struct mk_parse_result_fixup record = {
+                .address = entry->address,
+                .symbolName = lastSymbolNameOffset,
+                .libraryOrdinal = entry->libraryOrdinal,
+                .addend = entry->addend,
+                .kind = kind,
+                .type = entry->type,
+                .symbolFlags = entry->symbolFlags
+            };
+            [records appendBytes:&record length:sizeof(record)];
+        }];
+        
+        if (!success)
+            return NO;
+    }
+    
+    return YES;
+}
+
+//|++++++++++++++++++++++++++++++++++++|//
+- (BOOL)_encodeObjCOfImage:(MKMachOImage*)image records:(NSMutableData*)records strings:(NSMutableData*)strings error:(NSError**)error
+{
+    MKResult<MKObjCMetadata*> *objcMetadata = image.objcMetadata;
+    if (objcMetadata.error) {
+        MK_ERROR_OUT = objcMetadata.error;
+        return NO;
+    }
+    
+    MKObjCMetadata *metadata = objcMetadata.value;
+    
+    for (NSUInteger i = 0; i < metadata.classCount; i++) {
+        const MKObjCClassRecord *cls = &metadata.classes[i];
+        struct mk_parse_result_objc_record record = {
+            .address = cls->address,
+            .name = MKParseResultAppendString(strings, cls->name),
+            .relatedAddress = cls->superClassAddress,
+            .instanceMethodCount = cls->instanceMethods.count,
+            .classMethodCount = cls->classMethods.count,
+            .protocolCount = cls->protocolCount,
+            .kind = MKParseResultObjCKindClass
+        };
+        [records appendBytes:&record length:sizeof(record)];
+    }
+    
+    for (NSUInteger i = 0; i < metadata.categoryCount; i++) {
+        const MKObjCCategoryRecord *category = &metadata.categories[i];
+        struct mk_parse_result_objc_record record = {
+            .address = category->address,
+            .name = MKParseResultAppendString(strings, category->name),
+            .relatedAddress = category->classAddress,
+            .instanceMethodCount = category->instanceMethods.count,
+            .classMethodCount = category->classMethods.count,
+            .protocolCount = category->protocolCount,
+            .kind = MKParseResultObjCKindCategory
+        };
+        [records appendBytes:&record length:sizeof(record)];
+    }
+    
+    for (NSUInteger i = 0; i < metadata.protocolCount; i++) {
+        const MKObjCProtocolRecord *protocol = &metadata.protocols[i];
+        struct mk_parse_result_objc_record record = {
+            .address = protocol->address,
+            .name = MKParseResultAppendString(strings, protocol->name),
+            .instanceMethodCount = protocol->instanceMethods.count,
+            .classMethodCount = protocol->classMethods.count,
+            .protocolCount = protocol->protocolCount,
+            .kind = MKParseResultObjCKindProtocol
+        };
+        [records appendBytes:&record length:sizeof(record)];
+    }
+    
+    return YES;
+}
+
+//|++++++++++++++++++++++++++++++++++++|//
+- (BOOL)_encodeSubsystem:(MKParseResultSubsystems)subsystem ofImage:(MKMachOImage*)image records:(NSMutableData*)records strings:(NSMutableData*)strings error:(NSError**)error
+{
+    switch (subsystem) {
+        case MKParseResultSubsystemSymbols:
+            return [self _encodeSymbolsOfImage:image records:records strings:strings error:error];
+        case MKParseResultSubsystemExports:
+            return [self _encodeExportsOfImage:image records:records strings:strings error:error];
+        case MKParseResultSubsystemFixups:
+            return [self _encodeFixupsOfImage:image records:records strings:strings error:error];
+        case MKParseResultSubsystemObjC:
+            return [self _encodeObjCOfImage:image records:records strings:strings error:error];
+        default:
+            MK_ERROR_OUT = [NSError mk_errorWithDomain:MKErrorDomain code:MK_EINVAL description:@"Unknown subsystem [%lu].", (unsigned long)subsystem];
+            return NO;
+    }
+}
+
+//◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦//
+#pragma mark -  Cache Files
+//◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦//
+
+//|++++++++++++++++++++++++++++++++++++|//
+- (NSUUID*)_uuidOfImage:(MKMachOImage*)image
+{ return [(MKLCUUID*)[image loadCommandsOfType:LC_UUID].firstObject uuid]; }
+
+//|++++++++++++++++++++++++++++++++++++|//
+//! Images without an \c LC_UUID are named after the hash of their load
+//! commands instead.
+- (NSURL*)_fileURLForUUID:(NSUUID*)uuid loadCommandsHash:(uint64_t)loadCommandsHash
+{
+    NSString *name = uuid ? uuid.UUIDString : [NSString stringWithFormat:@"%016llx", loadCommandsHash];
+    return [_directoryURL URLByAppendingPathComponent:[name stringByAppendingPathExtension:@"mkresults"]];
+}
+
+//|++++++++++++++++++++++++++++++++++++|//
+static inline bool
+MKParseResultRangeValid(uint64_t totalSize, uint64_t offset, uint64_t count, uint64_t elementSize)
+{
+    if (elementSize && count > UINT64_MAX / elementSize) return false;
+    uint64_t size = count * elementSize;
+    return offset <= totalSize && size <= totalSize - offset;
+}
+
+//|++++++++++++++++++++++++++++++++++++|//
+//! Maps the cache file at \a url.  Returns \c nil if it does not exist, is
+//! from another version, or does not belong to the image with \a uuid.
+- (NSData*)_readFileAtURL:(NSURL*)url uuid:(NSUUID*)uuid
+{
+    NSData *file = [NSData dataWithContentsOfURL:url options:NSDataReadingMappedIfSafe error:NULL];
+    if (file.length < sizeof(struct mk_parse_result_cache_header))
+        return nil;
+    
+    const struct mk_parse_result_cache_header *header = file.bytes;
+    uuid_t expectedUUID = {0};
+    [uuid getUUIDBytes:expectedUUID];
+    
+    if (memcmp(header->magic, MK_PARSE_RESULT_CACHE_MAGIC, sizeof(header->magic)) != 0
+        || header->version != MK_PARSE_RESULT_CACHE_VERSION
+        || header->totalSize != file.length
+        || header->subsystemCount > MK_PARSE_RESULT_SUBSYSTEM_COUNT
+        || uuid_compare(header->uuid, expectedUUID) != 0)
+        return nil;
+    
+    const struct mk_parse_result_cache_subsystem *entries = (const void*)(header + 1);
+    if (!MKParseResultRangeValid(file.length, sizeof(*header), header->subsystemCount, sizeof(*entries)))
+        return nil;
+    
+    for (uint32_t i = 0; i < header->subsystemCount; i++) {
+        const struct mk_parse_result_cache_subsystem *entry = &entries[i];
+        size_t recordSize = MKParseResultRecordSize((MKParseResultSubsystems)entry->subsystem);
+        
+        if (recordSize == 0
+            || (entry->subsystem & (entry->subsystem - 1)) != 0
+            || !MKParseResultRangeValid(file.length, entry->recordsOffset, entry->recordCount, recordSize)
+            || !MKParseResultRangeValid(file.length, entry->stringsOffset, entry->stringsSize, 1))
+            return nil;
+    }
+    
+    return file;
+}
+
+//|++++++++++++++++++++++++++++++++++++|//
+- (const struct mk_parse_result_cache_subsystem*)_entryForSubsystem:(MKParseResultSubsystems)subsystem inFile:(NSData*)file
+{
+    if (file == nil)
+        return NULL;
+    
+    const struct mk_parse_result_cache_header *header = file.bytes;
+    const struct mk_parse_result_cache_subsystem *entries = (const void*)(header + 1);
+    
+    for (uint32_t i = 0; i < header->subsystemCount; i++) {
+        if (entries[i].subsystem == subsystem)
+            return &entries[i];
+    }
+    
+    return NULL;
+}
+
+//|++++++++++++++++++++++++++++++++++++|//
+static void
+MKParseResultAlign(NSMutableData *data)
+{
+    NSUInteger padding = (8 - (data.length & 7)) & 7;
+    [data increaseLengthBy:padding];
+}
+
+//|++++++++++++++++++++++++++++++++++++|//
+//! Writes the subsystems of \a results, and any other subsystems in
+//! \a previousFile, to \a url.
+- (BOOL)_writeResults:(MKParseResults*)results loadCommandsHash:(uint64_t)loadCommandsHash previousFile:(NSData*)previousFile toURL:(NSURL*)url error:(NSError**)error
+{
+    struct mk_parse_result_cache_subsystem entries[MK_PARSE_RESULT_SUBSYSTEM_COUNT] = {0};
+    NSMutableArray<NSData*> *records = [[NSMutableArray alloc] initWithCapacity:MK_PARSE_RESULT_SUBSYSTEM_COUNT];
+    NSMutableArray<NSData*> *strings = [[NSMutableArray alloc] initWithCapacity:MK_PARSE_RESULT_SUBSYSTEM_COUNT];
+    uint32_t sectionCount = 0;
+    
+    for (NSUInteger i = 0; i < MK_PARSE_RESULT_SUBSYSTEM_COUNT; i++) {
+        MKParseResultSubsystems subsystem = 1UL << i;
+        
+        if (results->_subsystems & subsystem) {
+            entries[sectionCount].subsystem = subsystem;
+            entries[sectionCount].fingerprint = results->_fingerprints[i];
+            entries[sectionCount].recordCount = results->_counts[i];
+            [records addObject:results->_encodedRecords[i]];
+            [strings addObject:results->_encodedStrings[i]];
+            sectionCount++;
+            continue;
+        }
+        
+        // Other results are kept.  They are checked against their
+        // fingerprint when they are next read.
+        const struct mk_parse_result_cache_subsystem *entry = [self _entryForSubsystem:subsystem inFile:previousFile];
+        if (entry == NULL)
+            continue;
+        
+        entries[sectionCount] = *entry;
+        [records addObject:[previousFile subdataWithRange:NSMakeRange((NSUInteger)entry->recordsOffset, (NSUInteger)(entry->recordCount * MKParseResultRecordSize(subsystem)))]];
+        [strings addObject:[previousFile subdataWithRange:NSMakeRange((NSUInteger)entry->stringsOffset, (NSUInteger)entry->stringsSize)]];
+        sectionCount++;
+    }
+    
+    NSMutableData *file = [[NSMutableData alloc] initWithLength:sizeof(struct mk_parse_result_cache_header) + sectionCount * sizeof(struct mk_parse_result_cache_subsystem)];
+    
+    for (uint32_t i = 0; i < sectionCount; i++) {
+        MKParseResultAlign(file);
+        entries[i].recordsOffset = file.length;
+        [file appendData:records[i]];
+        
+        entries[i].stringsOffset = file.length;
+        entries[i].stringsSize = strings[i].length;
+        [file appendData:strings[i]];
+    }
+    
+    struct mk_parse_result_cache_header *header = file.mutableBytes;
+    memcpy(header->magic, MK_PARSE_RESULT_CACHE_MAGIC, sizeof(header->magic));
+    header->version = MK_PARSE_RESULT_CACHE_VERSION;
+    header->subsystemCount = sectionCount;
+    [results.uuid getUUIDBytes:header->uuid];
+    header->loadCommandsHash = loadCommandsHash;
+    header->totalSize = file.length;
+    memcpy(header + 1, entries, sectionCount * sizeof(entries[0]));
+    
+    NSError *fileError = nil;
+    
+    if (![[NSFileManager defaultManager] createDirectoryAtURL:_directoryURL withIntermediateDirectories:YES attributes:nil error:&fileError]) {
+        MK_ERROR_OUT = [NSError mk_errorWithDomain:MKErrorDomain code:MK_EINTERNAL_ERROR underlyingError:fileError description:@"Could not create the cache directory %@.", _directoryURL.path];
+        return NO;
+    }
+    
+    if (![file writeToURL:url options:NSDataWritingAtomic error:&fileError]) {
+        MK_ERROR_OUT = [NSError mk_errorWithDomain:MKErrorDomain code:MK_EINTERNAL_ERROR underlyingError:fileError description:@"Could not write the cache file %@.", url.path];
+        return NO;
+    }
+    
+    return YES;
+}
+
+//◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦//
+#pragma mark -  Results
+//◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦//
+
+//|++++++++++++++++++++++++++++++++++++|//
+- (MKParseResults*)resultsForImage:(MKMachOImage*)image subsystems:(MKParseResultSubsystems)subsystems error:(NSError**)error
+{
+    uint64_t loadCommandsHash;
+    if (![self _loadCommandsHash:&loadCommandsHash ofImage:image error:error])
+        return nil;
+    
+    NSUUID *uuid = [self _uuidOfImage:image];
+    NSURL *url = [self _fileURLForUUID:uuid loadCommandsHash:loadCommandsHash];
+    NSData *file = [self _readFileAtURL:url uuid:uuid];
+    
+    MKParseResults *results = [[MKParseResults alloc] _initWithUUID:uuid];
+    BOOL parsed = NO;
+    
+    for (NSUInteger i = 0; i < MK_PARSE_RESULT_SUBSYSTEM_COUNT; i++) {
+        MKParseResultSubsystems subsystem = 1UL << i;
+        if ((subsystems & subsystem) == 0)
+            continue;
+        
+        NSError *subsystemError = nil;
+        uint64_t fingerprint;
+        
+        if (![self _fingerprint:&fingerprint ofSubsystem:subsystem inImage:image loadCommandsHash:loadCommandsHash error:&subsystemError]) {
+            [results _setError:subsystemError forSubsystem:subsystem];
+            continue;
+        }
+        
+        const struct mk_parse_result_cache_subsystem *entry = [self _entryForSubsystem:subsystem inFile:file];
+        if (entry && entry->fingerprint == fingerprint) {
+            NSData *records = [file subdataWithRange:NSMakeRange((NSUInteger)entry->recordsOffset, (NSUInteger)(entry->recordCount * MKParseResultRecordSize(subsystem)))];
+            NSData *strings = [file subdataWithRange:NSMakeRange((NSUInteger)entry->stringsOffset, (NSUInteger)entry->stringsSize)];
+            
+            if ([results _setEncodedRecords:records count:(NSUInteger)entry->recordCount strings:strings fingerprint:fingerprint forSubsystem:subsystem rehydrated:YES])
+                continue;
+        }
+        
+        NSMutableData *records = [[NSMutableData alloc] init];
+        NSMutableData *strings = [[NSMutableData alloc] init];
+        
+        if (![self _encodeSubsystem:subsystem ofImage:image records:records strings:strings error:&subsystemError]) {
+            [results _setError:subsystemError forSubsystem:subsystem];
+            continue;
+        }
+        
+        [results _setEncodedRecords:records count:records.length / MKParseResultRecordSize(subsystem) strings:strings fingerprint:fingerprint forSubsystem:subsystem rehydrated:NO];
+        parsed = YES;
+    }
+    
+    if (parsed) {
+        NSError *writeError = nil;
+        if (![self _writeResults:results loadCommandsHash:loadCommandsHash previousFile:file toURL:url error:&writeError])
+            results->_writeError = writeError;
+    }
+    
+    return results;
+}
+
+//|++++++++++++++++++++++++++++++++++++|//
+- (BOOL)removeResultsForImage:(MKMachOImage*)image error:(NSError**)error
+{
+    uint64_t loadCommandsHash;
+    if (![self _loadCommandsHash:&loadCommandsHash ofImage:image error:error])
+        return NO;
+    
+    NSURL *url = [self _fileURLForUUID:[self _uuidOfImage:image] loadCommandsHash:loadCommandsHash];
+    NSError *removeError = nil;
+    
+    if ([[NSFileManager defaultManager] removeItemAtURL:url error:&removeError])
+        return YES;
+    if ([removeError.domain isEqualToString:NSCocoaErrorDomain] && removeError.code == NSFileNoSuchFileError)
+        return YES;
+    
+    MK_ERROR_OUT = removeError;
+    return NO;
+}
+
+@end
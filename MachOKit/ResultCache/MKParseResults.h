@@ -0,0 +1,173 @@
+//----------------------------------------------------------------------------//
+//|
+//|             MachOKit - A Lightweight Mach-O Parsing Library
+//! @file       MKParseResults.h
+//!
+//! @author     D.V.
+//! @copyright  Copyright (c) 2014-2015 D.V. All rights reserved.
+//|
+//| Permission is hereby granted, free of charge, to any person obtaining a
+//| copy of this software and associated documentation files (the "Software"),
+//| to deal in the Software without restriction, including without limitation
+//| the rights to use, copy, modify, merge, publish, distribute, sublicense,
+//| and/or sell copies of the Software, and to permit persons to whom the
+//| Software is furnished to do so, subject to the following conditions:
+//|
+//| The above copyright notice and this permission notice shall be included
+//| in all copies or substantial portions of the Software.
+//|
+//| THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+//| OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+//| MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+//| IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+//| CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+//| TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+//| SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+//----------------------------------------------------------------------------//
+
+#include <MachOKit/macho.h>
+#import <Foundation/Foundation.h>
+
+#import <MachOKit/MKNodeFieldExportKindType.h>
+#import <MachOKit/MKNodeFieldExportOptionsType.h>
+
+NS_ASSUME_NONNULL_BEGIN
+
+//----------------------------------------------------------------------------//
+//! @name       Parse Result Subsystems
+//! @relates    MKParseResults
+//
+typedef NS_OPTIONS(NSUInteger, MKParseResultSubsystems) {
+    MKParseResultSubsystemNone          = 0,
+    //! The entries of the \c LC_SYMTAB symbol table.
+    MKParseResultSubsystemSymbols       = 1UL << 0,
+    //! The exports trie.
+    MKParseResultSubsystemExports       = 1UL << 1,
+    //! The rebase, bind, weak bind and lazy bind opcodes.
+    MKParseResultSubsystemFixups        = 1UL << 2,
+    //! The Objective-C classes, categories and protocols.
+    MKParseResultSubsystemObjC          = 1UL << 3,
+    MKParseResultSubsystemAll           = 0xF
+};
+
+
+
+//----------------------------------------------------------------------------//
+//! @name       Parse Result Records
+//! @relates    MKParseResults
+//!
+//! Records are owned by the \ref MKParseResults instance that produced them
+//! and remain valid for its lifetime.  Strings are \c NULL if they could
+//! not be read.
+//
+
+//! An entry in the symbol table.
+typedef struct MKParseResultSymbol {
+    const char * _Nullable name;
+    uint64_t value;
+    uint8_t type;
+    uint8_t sect;
+    uint16_t desc;
+} MKParseResultSymbol;
+
+//! An exported symbol.
+typedef struct MKParseResultExport {
+    const char * _Nullable name;
+    //! For a re-export, the name of the symbol in the source library, or
+    //! \c NULL if it has the same name.
+    const char * _Nullable importedName;
+    //! For a regular export, its VM address.
+    mk_vm_address_t address;
+    //! For a re-export, the ordinal of the source library.
+    int64_t sourceLibraryOrdinal;
+    MKExportOptions options;
+    MKExportKind kind;
+} MKParseResultExport;
+
+typedef NS_ENUM(uint8_t, MKParseResultFixupKind) {
+    MKParseResultFixupKindRebase = 0,
+    MKParseResultFixupKindBind,
+    MKParseResultFixupKindWeakBind,
+    MKParseResultFixupKindLazyBind
+};
+
+//! A rebased or bound location.
+typedef struct MKParseResultFixup {
+    //! The VM address of the location.
+    mk_vm_address_t address;
+    //! The bound symbol, or \c NULL for a rebase.
+    const char * _Nullable symbolName;
+    int64_t libraryOrdinal;
+    int64_t addend;
+    MKParseResultFixupKind kind;
+    //! The \c REBASE_TYPE_* or \c BIND_TYPE_* of the location.
+    uint8_t type;
+    uint8_t symbolFlags;
+} MKParseResultFixup;
+
+typedef NS_ENUM(uint8_t, MKParseResultObjCKind) {
+    MKParseResultObjCKindClass = 0,
+    MKParseResultObjCKindCategory,
+    MKParseResultObjCKindProtocol
+};
+
+//! An Objective-C class, category or protocol.
+typedef struct MKParseResultObjCRecord {
+    mk_vm_address_t address;
+    const char * _Nullable name;
+    //! The VM address of the superclass of a class, or of the class extended
+    //! by a category.  \c 0 if it is bound from another image.
+    mk_vm_address_t relatedAddress;
+    uint32_t instanceMethodCount;
+    uint32_t classMethodCount;
+    uint32_t protocolCount;
+    MKParseResultObjCKind kind;
+} MKParseResultObjCRecord;
+
+
+
+//----------------------------------------------------------------------------//
+//! An instance of \c MKParseResults holds compact results of parsing the
+//! symbol table, exports, fixups and Objective-C metadata of an image.
+//! Results are produced by an \ref MKParseResultCache, either by parsing the
+//! image or by reading them back from the cache.
+//
+@interface MKParseResults : NSObject
+
+- (instancetype)init NS_UNAVAILABLE;
+
+//! The \c LC_UUID of the image, if it has one.
+@property (nonatomic, strong, readonly, nullable) NSUUID *uuid;
+
+//! The subsystems for which results are available.
+@property (nonatomic, assign, readonly) MKParseResultSubsystems subsystems;
+//! The subsystems whose results were read from the cache rather than
+//! parsed from the image.
+@property (nonatomic, assign, readonly) MKParseResultSubsystems rehydratedSubsystems;
+//! Errors encountered parsing a subsystem, keyed by subsystem.  Results for
+//! these subsystems are not available and are not cached.
+@property (nonatomic, strong, readonly) NSDictionary<NSNumber*, NSError*> *errors;
+//! The error that prevented these results from being written to the cache,
+//! or \c nil if they were written or did not need to be.
+@property (nonatomic, strong, readonly, nullable) NSError *writeError;
+
+@property (nonatomic, assign, readonly) NSUInteger symbolCount;
+//! The symbol table entries, in symbol table order.
+@property (nonatomic, assign, readonly, nullable) const MKParseResultSymbol *symbols;
+
+@property (nonatomic, assign, readonly) NSUInteger exportCount;
+//! The exports, in trie order.
+@property (nonatomic, assign, readonly, nullable) const MKParseResultExport *exports;
+
+@property (nonatomic, assign, readonly) NSUInteger fixupCount;
+//! The rebases in opcode order, followed by the binds, weak binds and lazy
+//! binds.
+@property (nonatomic, assign, readonly, nullable) const MKParseResultFixup *fixups;
+
+@property (nonatomic, assign, readonly) NSUInteger objcRecordCount;
+//! The classes, followed by the categories and the protocols.
+@property (nonatomic, assign, readonly, nullable) const MKParseResultObjCRecord *objcRecords;
+
+@end
+
+NS_ASSUME_NONNULL_END
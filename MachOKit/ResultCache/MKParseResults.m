@@ -0,0 +1,229 @@
+//----------------------------------------------------------------------------//
+//|
+//|             MachOKit - A Lightweight Mach-O Parsing Library
+//|             MKParseResults.m
+//|
+//|             D.V.
+//|             Copyright (c) 2014-2015 D.V. All rights reserved.
+//|
+//| Permission is hereby granted, free of charge, to any person obtaining a
+//| copy of this software and associated documentation files (the "Software"),
+//| to deal in the Software without restriction, including without limitation
+//| the rights to use, copy, modify, merge, publish, distribute, sublicense,
+//| and/or sell copies of the Software, and to permit persons to whom the
+//| Software is furnished to do so, subject to the following conditions:
+//|
+//| The above copyright notice and this permission notice shall be included
+//| in all copies or substantial portions of the Software.
+//|
+//| THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+//| OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+//| MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+//| IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+//| CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+//| TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+//| SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+//----------------------------------------------------------------------------//
+
+
+#import "MKParseResults.h"
+#import "_MKParseResultCache.h"
+
+//----------------------------------------------------------------------------//
+@implementation MKParseResults
+
+@synthesize uuid = _uuid;
+@synthesize subsystems = _subsystems;
+@synthesize rehydratedSubsystems = _rehydratedSubsystems;
+@synthesize writeError = _writeError;
+
+//|++++++++++++++++++++++++++++++++++++|//
+- (instancetype)init
+{ @throw [NSException exceptionWithName:NSInvalidArgumentException reason:@"-init unavailable." userInfo:nil]; }
+
+//|++++++++++++++++++++++++++++++++++++|//
+- (instancetype)_initWithUUID:(NSUUID*)uuid
+{
+    self = [super init];
+    if (self == nil) return nil;
+    
+    _uuid = uuid;
+    _errors = [[NSMutableDictionary alloc] init];
+    
+    return self;
+}
+
+//|++++++++++++++++++++++++++++++++++++|//
+- (void)dealloc
+{
+    for (NSUInteger i = 0; i < MK_PARSE_RESULT_SUBSYSTEM_COUNT; i++)
+        free(_records[i]);
+}
+
+//◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦//
+#pragma mark -  Decoding
+//◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦//
+
+//|++++++++++++++++++++++++++++++++++++|//
+//! Resolves the string at \a offset into \a strings.  The pool is NUL
+//! terminated, so any offset within it is a valid C string.
+static inline bool
+MKParseResultString(NSData *strings, uint64_t offset, const char **string)
+{
+    if (offset == MK_PARSE_RESULT_NO_STRING) {
+        *string = NULL;
+        return true;
+    }
+    if (offset >= strings.length)
+        return false;
+    *string = (const char*)strings.bytes + offset;
+    return true;
+}
+
+//|++++++++++++++++++++++++++++++++++++|//
+- (BOOL)_setEncodedRecords:(NSData*)records count:(NSUInteger)count strings:(NSData*)strings fingerprint:(uint64_t)fingerprint forSubsystem:(MKParseResultSubsystems)subsystem rehydrated:(BOOL)rehydrated
+{
+    NSUInteger index = MKParseResultSubsystemIndex(subsystem);
+    size_t recordSize = MKParseResultRecordSize(subsystem);
+    
+    if (count > records.length / recordSize || records.length != count * recordSize)
+        return NO;
+    if (strings.length && ((const char*)strings.bytes)[strings.length - 1] != '\0')
+        return NO;
+    
+    void *decoded = NULL;
+    bool valid = true;
+    
+    switch (subsystem) {
+        case MKParseResultSubsystemSymbols:
+        {
+            const struct mk_parse_result_symbol *in = records.bytes;
+            MKParseResultSymbol *out = decoded = calloc(count ?: 1, sizeof(*out));
+            for (NSUInteger i = 0; valid && i < count; i++) {
+                valid = MKParseResultString(strings, in[i].name, &out[i].name);
+                out[i].value = in[i].value;
+                out[i].type = in[i].type;
+                out[i].sect = in[i].sect;
+                out[i].desc = in[i].desc;
+            }
+            break;
+        }
+        case MKParseResultSubsystemExports:
+        {
+            const struct mk_parse_result_export *in = records.bytes;
+            MKParseResultExport *out = decoded = calloc(count ?: 1, sizeof(*out));
+            for (NSUInteger i = 0; valid && i < count; i++) {
+                valid = MKParseResultString(strings, in[i].name, &out[i].name)
+                     && MKParseResultString(strings, in[i].importedName, &out[i].importedName);
+                out[i].address = in[i].address;
+                out[i].sourceLibraryOrdinal = in[i].sourceLibraryOrdinal;
+                out[i].options = in[i].options;
+                out[i].kind = in[i].kind;
+            }
+            break;
+        }
+        case MKParseResultSubsystemFixups:
+        {
+            const struct mk_parse_result_fixup *in = records.bytes;
+            MKParseResultFixup *out = decoded = calloc(count ?: 1, sizeof(*out));
+            for (NSUInteger i = 0; valid && i < count; i++) {
+                valid = MKParseResultString(strings, in[i].symbolName, &out[i].symbolName);
+                out[i].address = in[i].address;
+                out[i].libraryOrdinal = in[i].libraryOrdinal;
+                out[i].addend = in[i].addend;
+                out[i].kind = in[i].kind;
+                out[i].type = in[i].type;
+                out[i].symbolFlags = in[i].symbolFlags;
+            }
+            break;
+        }
+        case MKParseResultSubsystemObjC:
+        {
+            const struct mk_parse_result_objc_record *in = records.bytes;
+            MKParseResultObjCRecord *out = decoded = calloc(count ?: 1, sizeof(*out));
+            for (NSUInteger i = 0; valid && i < count; i++) {
+                valid = MKParseResultString(strings, in[i].name, &out[i].name);
+                out[i].address = in[i].address;
+                out[i].relatedAddress = in[i].relatedAddress;
+                out[i].instanceMethodCount = in[i].instanceMethodCount;
+                out[i].classMethodCount = in[i].classMethodCount;
+                out[i].protocolCount = in[i].protocolCount;
+                out[i].kind = in[i].kind;
+            }
+            break;
+        }
+        default:
+            return NO;
+    }
+    
+    if (decoded == NULL || !valid) {
+        free(decoded);
+        return NO;
+    }
+    
+    free(_records[index]);
+    _records[index] = decoded;
+    _counts[index] = count;
+    _encodedRecords[index] = records;
+    _encodedStrings[index] = strings;
+    _fingerprints[index] = fingerprint;
+    
+    _subsystems |= subsystem;
+    if (rehydrated)
+        _rehydratedSubsystems |= subsystem;
+    else
+        _rehydratedSubsystems &= ~subsystem;
+    [_errors removeObjectForKey:@(subsystem)];
+    
+    return YES;
+}
+
+//|++++++++++++++++++++++++++++++++++++|//
+- (void)_setError:(NSError*)error forSubsystem:(MKParseResultSubsystems)subsystem
+{ _errors[@(subsystem)] = error; }
+
+//◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦//
+#pragma mark -  Results
+//◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦//
+
+//|++++++++++++++++++++++++++++++++++++|//
+- (NSDictionary*)errors
+{ return [_errors copy]; }
+
+//|++++++++++++++++++++++++++++++++++++|//
+- (NSUInteger)symbolCount
+{ return _counts[MKParseResultSubsystemIndex(MKParseResultSubsystemSymbols)]; }
+
+//|++++++++++++++++++++++++++++++++++++|//
+- (const MKParseResultSymbol*)symbols
+{ return _records[MKParseResultSubsystemIndex(MKParseResultSubsystemSymbols)]; }
+
+//|++++++++++++++++++++++++++++++++++++|//
+- (NSUInteger)exportCount
+{ return _counts[MKParseResultSubsystemIndex(MKParseResultSubsystemExports)]; }
+
+//|++++++++++++++++++++++++++++++++++++|//
+- (const MKParseResultExport*)exports
+{ return _records[MKParseResultSubsystemIndex(MKParseResultSubsystemExports)]; }
+
+//|++++++++++++++++++++++++++++++++++++|//
+- (NSUInteger)fixupCount
+{ return _counts[MKParseResultSubsystemIndex(MKParseResultSubsystemFixups)]; }
+
+//|++++++++++++++++++++++++++++++++++++|//
+- (const MKParseResultFixup*)fixups
+{ return _records[MKParseResultSubsystemIndex(MKParseResultSubsystemFixups)]; }
+
+//|++++++++++++++++++++++++++++++++++++|//
+- (NSUInteger)objcRecordCount
+{ return _counts[MKParseResultSubsystemIndex(MKParseResultSubsystemObjC)]; }
+
+//|++++++++++++++++++++++++++++++++++++|//
+- (const MKParseResultObjCRecord*)objcRecords
+{ return _records[MKParseResultSubsystemIndex(MKParseResultSubsystemObjC)]; }
+
+//|++++++++++++++++++++++++++++++++++++|//
+- (NSString*)description
+{ return [NSString stringWithFormat:@"<%@ %p; %@; %lu symbols, %lu exports, %lu fixups, %lu Objective-C records>", self.class, self, _uuid.UUIDString, (unsigned long)self.symbolCount, (unsigned long)self.exportCount, (unsigned long)self.fixupCount, (unsigned long)self.objcRecordCount]; }
+
+@end
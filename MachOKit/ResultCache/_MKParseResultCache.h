@@ -0,0 +1,161 @@
+//----------------------------------------------------------------------------//
+//|
+//|             MachOKit - A Lightweight Mach-O Parsing Library
+//! @file       _MKParseResultCache.h
+//!
+//! @author     D.V.
+//! @copyright  Copyright (c) 2014-2015 D.V. All rights reserved.
+//|
+//| Permission is hereby granted, free of charge, to any person obtaining a
+//| copy of this software and associated documentation files (the "Software"),
+//| to deal in the Software without restriction, including without limitation
+//| the rights to use, copy, modify, merge, publish, distribute, sublicense,
+//| and/or sell copies of the Software, and to permit persons to whom the
+//| Software is furnished to do so, subject to the following conditions:
+//|
+//| The above copyright notice and this permission notice shall be included
+//| in all copies or substantial portions of the Software.
+//|
+//| THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+//| OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+//| MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+//| IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+//| CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+//| TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+//| SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+//----------------------------------------------------------------------------//
+
+#import "MKParseResults.h"
+
+#include <uuid/uuid.h>
+
+NS_ASSUME_NONNULL_BEGIN
+
+//----------------------------------------------------------------------------//
+#pragma mark -  Cache File Format
+//
+// A cache file is a header, followed by a table of subsystems, followed by
+// the records and string pool of each subsystem.  All offsets are from the
+// start of the file.  Strings are referenced by their offset into the pool
+// of their subsystem, or MK_PARSE_RESULT_NO_STRING.
+//----------------------------------------------------------------------------//
+
+#define MK_PARSE_RESULT_CACHE_MAGIC         "MKPRCACH"
+#define MK_PARSE_RESULT_CACHE_VERSION       1
+#define MK_PARSE_RESULT_SUBSYSTEM_COUNT     4
+#define MK_PARSE_RESULT_NO_STRING           UINT64_MAX
+
+struct mk_parse_result_cache_header {
+    char magic[8];
+    uint32_t version;
+    uint32_t subsystemCount;
+    uuid_t uuid;
+    // Hash of the Mach header and load commands.
+    uint64_t loadCommandsHash;
+    uint64_t totalSize;
+};
+
+struct mk_parse_result_cache_subsystem {
+    uint64_t subsystem;
+    uint64_t fingerprint;
+    uint64_t recordCount;
+    uint64_t recordsOffset;
+    uint64_t stringsOffset;
+    uint64_t stringsSize;
+};
+
+struct mk_parse_result_symbol {
+    uint64_t name;
+    uint64_t value;
+    uint8_t type;
+    uint8_t sect;
+    uint16_t desc;
+    uint32_t reserved;
+};
+
+struct mk_parse_result_export {
+    uint64_t name;
+    uint64_t importedName;
+    uint64_t address;
+    int64_t sourceLibraryOrdinal;
+    uint64_t options;
+    uint8_t kind;
+    uint8_t reserved[7];
+};
+
+struct mk_parse_result_fixup {
+    uint64_t address;
+    uint64_t symbolName;
+    int64_t libraryOrdinal;
+    int64_t addend;
+    uint8_t kind;
+    uint8_t type;
+    uint8_t symbolFlags;
+    uint8_t reserved[5];
+};
+
+struct mk_parse_result_objc_record {
+    uint64_t address;
+    uint64_t name;
+    uint64_t relatedAddress;
+    uint32_t instanceMethodCount;
+    uint32_t classMethodCount;
+    uint32_t protocolCount;
+    uint8_t kind;
+    uint8_t reserved[3];
+};
+
+//! Returns the index of \a subsystem, which must be a single subsystem.
+static inline NSUInteger
+MKParseResultSubsystemIndex(MKParseResultSubsystems subsystem)
+{ return (NSUInteger)__builtin_ctzl(subsystem); }
+
+//! Returns the size of an encoded record of \a subsystem.
+static inline size_t
+MKParseResultRecordSize(MKParseResultSubsystems subsystem)
+{
+    switch (subsystem) {
+        case MKParseResultSubsystemSymbols:
+            return sizeof(struct mk_parse_result_symbol);
+        case MKParseResultSubsystemExports:
+            return sizeof(struct mk_parse_result_export);
+        case MKParseResultSubsystemFixups:
+            return sizeof(struct mk_parse_result_fixup);
+        case MKParseResultSubsystemObjC:
+            return sizeof(struct mk_parse_result_objc_record);
+        default:
+            return 0;
+    }
+}
+
+
+
+//----------------------------------------------------------------------------//
+@interface MKParseResults () {
+@package
+    NSUUID *_uuid;
+    MKParseResultSubsystems _subsystems;
+    MKParseResultSubsystems _rehydratedSubsystems;
+    NSMutableDictionary<NSNumber*, NSError*> *_errors;
+    NSError *_writeError;
+    // The encoded records and string pool of each subsystem, as they are
+    // stored in the cache.  The decoded records point into the string pools.
+    NSData *_encodedRecords[MK_PARSE_RESULT_SUBSYSTEM_COUNT];
+    NSData *_encodedStrings[MK_PARSE_RESULT_SUBSYSTEM_COUNT];
+    NSUInteger _counts[MK_PARSE_RESULT_SUBSYSTEM_COUNT];
+    uint64_t _fingerprints[MK_PARSE_RESULT_SUBSYSTEM_COUNT];
+    void *_records[MK_PARSE_RESULT_SUBSYSTEM_COUNT];
+}
+
+- (instancetype)_initWithUUID:(nullable NSUUID*)uuid;
+
+//! Decodes \a count encoded \a records of \a subsystem, whose strings are
+//! in \a strings.  Returns \c NO if the records reference strings outside
+//! of the pool.
+- (BOOL)_setEncodedRecords:(NSData*)records count:(NSUInteger)count strings:(NSData*)strings fingerprint:(uint64_t)fingerprint forSubsystem:(MKParseResultSubsystems)subsystem rehydrated:(BOOL)rehydrated;
+
+- (void)_setError:(NSError*)error forSubsystem:(MKParseResultSubsystems)subsystem;
+
+@end
+
+NS_ASSUME_NONNULL_END
@@ -51,8 +51,12 @@ NS_ASSUME_NONNULL_BEGIN
 
 - (MKResult<__kindof MKSegment*> *)segmentForLoadCommand:(id<MKLCSegment>)segmentLoadCommand;
 
+//! Returns the segments named \a name, in load command order.
 - (NSArray<MKResult<__kindof MKSegment*>*> *)segmentsWithName:(NSString*)name;
 
+//! Returns the segment whose VM range contains \a address.
+- (MKResult<__kindof MKSegment*> *)segmentContainingVMAddress:(mk_vm_address_t)address;
+
 //◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦//
 #pragma mark -  Sections
 //! @name       Sections
@@ -61,7 +65,16 @@ NS_ASSUME_NONNULL_BEGIN
 @property (nonatomic, strong, readonly) NSDictionary<NSNumber*, MKSection*> *sections;
 
 - (NSArray<__kindof MKSection*> *)sectionsWithName:(NSString*)sectName inSegment:(nullable MKSegment*)segment;
+//! Returns the sections whose section command names \a segName and
+//! \a sectName, in load command order.
 - (NSArray<__kindof MKSection*> *)sectionsWithName:(NSString*)sectName inSegmentWithName:(NSString*)segName;
+//! Returns the first section whose section command names \a segName and
+//! \a sectName.
+- (nullable __kindof MKSection*)sectionWithName:(NSString*)sectName inSegmentWithName:(NSString*)segName;
+
+//! Returns the section whose VM range contains \a address.  Sections with
+//! a size of zero never match.
+- (nullable __kindof MKSection*)sectionContainingVMAddress:(mk_vm_address_t)address;
 
 + (MKNodeFieldBuilder*)_sectionsFieldBuilder;
 @end
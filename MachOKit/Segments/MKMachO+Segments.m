@@ -39,6 +39,27 @@ _mk_internal NSString * const MKSortedSegments = @"MKSortedSegments";
 _mk_internal NSString * const MKSegmentsByLoadCommand = @"MKSegmentsByLoadCommand";
 _mk_internal NSString * const MKAllSections = @"MKAllSections";
 _mk_internal NSString * const MKIndexedSections = @"MKIndexedSections";
+_mk_internal NSString * const MKSegmentsByName = @"MKSegmentsByName";
+_mk_internal NSString * const MKSectionsByName = @"MKSectionsByName";
+_mk_internal NSString * const MKSectionsBySegmentAndSectionName = @"MKSectionsBySegmentAndSectionName";
+_mk_internal NSString * const MKSortedSections = @"MKSortedSections";
+
+//|++++++++++++++++++++++++++++++++++++|//
+static NSString*
+MKSectionNameKey(NSString *segName, NSString *sectName)
+{ return [NSString stringWithFormat:@"%@,%@", segName ?: @"", sectName ?: @""]; }
+
+//|++++++++++++++++++++++++++++++++++++|//
+static void
+MKAppendToIndex(NSMutableDictionary<NSString*, NSMutableArray*> *index, NSString *key, id value)
+{
+    NSMutableArray *values = index[key];
+    if (values == nil) {
+        values = [[NSMutableArray alloc] initWithCapacity:1];
+        index[key] = values;
+    }
+    [values addObject:value];
+}
 
 //----------------------------------------------------------------------------//
 @implementation MKMachOImage (Segments)
@@ -57,6 +78,9 @@ _mk_internal NSString * const MKIndexedSections = @"MKIndexedSections";
         
         NSMutableArray<MKSection*> *sections = [[NSMutableArray alloc] init];
         NSMutableDictionary<NSNumber*, MKSection*> *sectionsByIndex = [[NSMutableDictionary alloc] init];
+        NSMutableDictionary<NSString*, NSMutableArray*> *segmentsByName = [[NSMutableDictionary alloc] init];
+        NSMutableDictionary<NSString*, NSMutableArray*> *sectionsByName = [[NSMutableDictionary alloc] init];
+        NSMutableDictionary<NSString*, NSMutableArray*> *sectionsBySegmentAndSectionName = [[NSMutableDictionary alloc] init];
         // Use a uint64_t to avoid overflow issues if we have bad data.
         uint64_t sectionBaseIndex = 0;
         
@@ -72,6 +96,8 @@ _mk_internal NSString * const MKIndexedSections = @"MKIndexedSections";
                 MKResult *segmentOpt = [[MKResult alloc] initWithValue:segment];
                 [segments addObject:segmentOpt];
                 [segmentsByLoadCommand setObject:segmentOpt forKey:lc];
+                if (segment.name)
+                    MKAppendToIndex(segmentsByName, segment.name, segmentOpt);
             } else {
                 NSError *error = [NSError mk_errorWithDomain:MKErrorDomain code:MK_EINTERNAL_ERROR underlyingError:segmentError description:@"Could not create segment for load command: %@", lc];
                 
@@ -102,6 +128,15 @@ _mk_internal NSString * const MKIndexedSections = @"MKIndexedSections";
                     
                     [sections addObject:section];
                     sectionsByIndex[@(sectionBaseIndex + i)] = section;
+                    
+                    // Index by the segment name recorded in the section
+                    // command, which is not necessarily the name of the
+                    // parent segment in an object file.
+                    NSString *sectName = [section name];
+                    if (sectName) {
+                        MKAppendToIndex(sectionsByName, sectName, section);
+                        MKAppendToIndex(sectionsBySegmentAndSectionName, MKSectionNameKey([section loadCommand].segname, sectName), section);
+                    }
                 }
                 
                 sectionBaseIndex += segment.loadCommand.nsects;
@@ -110,13 +145,29 @@ _mk_internal NSString * const MKIndexedSections = @"MKIndexedSections";
         
         NSArray *finalSegments = segments;
         NSArray *sortedSegments = [MKBackedNode sortNodeArray:(NSArray *)segments];
+        // Empty sections can never contain an address.  Leaving them out
+        // keeps the ranges in the sorted array disjoint for the binary search.
+        NSIndexSet *nonEmptySections = [sections indexesOfObjectsPassingTest:^BOOL(MKSection *section, __unused NSUInteger idx, __unused BOOL *stop) {
+            return section.nodeSize != 0;
+        }];
+        NSArray *sortedSections = [[sections objectsAtIndexes:nonEmptySections] sortedArrayWithOptions:NSSortStable usingComparator:^NSComparisonResult(MKSection *left, MKSection *right) {
+            mk_vm_address_t leftAddr = left.nodeVMAddress;
+            mk_vm_address_t rightAddr = right.nodeVMAddress;
+            if (leftAddr == rightAddr) return NSOrderedSame;
+            else if (leftAddr < rightAddr) return NSOrderedAscending;
+            else return NSOrderedDescending;
+        }];
         
         _segments = @{
             MKAllSegments: finalSegments,
             MKSortedSegments: sortedSegments,
             MKSegmentsByLoadCommand: segmentsByLoadCommand,
             MKAllSections: sections,
-            MKIndexedSections: [NSDictionary dictionaryWithDictionary:sectionsByIndex]
+            MKIndexedSections: [NSDictionary dictionaryWithDictionary:sectionsByIndex],
+            MKSegmentsByName: segmentsByName,
+            MKSectionsByName: sectionsByName,
+            MKSectionsBySegmentAndSectionName: sectionsBySegmentAndSectionName,
+            MKSortedSections: sortedSections
         };
     }
     
@@ -150,9 +201,13 @@ _mk_internal NSString * const MKIndexedSections = @"MKIndexedSections";
 - (NSArray*)segmentsWithName:(NSString*)name
 {
     // TODO - Check what DYLD would do with duplicate segments.
-    return [self._segments[MKAllSegments] filteredArrayUsingPredicate:[NSPredicate predicateWithFormat:@"value.name MATCHES %@", name]];
+    return [self._segments[MKSegmentsByName][name] copy] ?: @[];
 }
 
+//|++++++++++++++++++++++++++++++++++++|//
+- (MKResult*)segmentContainingVMAddress:(mk_vm_address_t)address
+{ return [MKBackedNode childNodeOccupyingVMAddress:address targetClass:MKSegment.class inSortedArray:self._segments[MKSortedSegments]]; }
+
 //◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦//
 #pragma mark -  Sections
 //◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦//
@@ -165,10 +220,15 @@ _mk_internal NSString * const MKIndexedSections = @"MKIndexedSections";
 - (NSArray*)sectionsWithName:(NSString*)sectName inSegment:(MKSegment*)segment
 {
     // TODO - Check what DYLD would do with duplicate sections.
-    NSMutableArray *sections = [NSMutableArray arrayWithCapacity:1];
+    NSArray<MKSection*> *candidates = self._segments[MKSectionsByName][sectName];
+    if (candidates == nil)
+        return @[];
+    if (segment == nil)
+        return [candidates copy];
     
-    for (MKSection *section in self._segments[MKAllSections]) {
-        if ((segment == nil || section.parent == segment) && [section.name isEqualToString:sectName])
+    NSMutableArray *sections = [NSMutableArray arrayWithCapacity:1];
+    for (MKSection *section in candidates) {
+        if (section.parent == segment)
             [sections addObject:section];
     }
     
@@ -177,7 +237,15 @@ _mk_internal NSString * const MKIndexedSections = @"MKIndexedSections";
 
 //|++++++++++++++++++++++++++++++++++++|//
 - (NSArray*)sectionsWithName:(NSString*)sectName inSegmentWithName:(NSString*)segName
-{ return [self sectionsWithName:sectName inSegment:[self segmentsWithName:segName].firstObject.value]; }
+{ return [self._segments[MKSectionsBySegmentAndSectionName][MKSectionNameKey(segName, sectName)] copy] ?: @[]; }
+
+//|++++++++++++++++++++++++++++++++++++|//
+- (MKSection*)sectionWithName:(NSString*)sectName inSegmentWithName:(NSString*)segName
+{ return [self._segments[MKSectionsBySegmentAndSectionName][MKSectionNameKey(segName, sectName)] firstObject]; }
+
+//|++++++++++++++++++++++++++++++++++++|//
+- (MKSection*)sectionContainingVMAddress:(mk_vm_address_t)address
+{ return [MKBackedNode childNodeOccupyingVMAddress:address targetClass:MKSection.class inSortedArray:self._segments[MKSortedSections]].value; }
 
 //◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦//
 #pragma mark -  MKPointer
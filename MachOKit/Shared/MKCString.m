@@ -27,6 +27,7 @@
 
 #import "MKCString.h"
 #import "MKInternal.h"
+#import "MKNodeSerializer.h"
 
 //----------------------------------------------------------------------------//
 @implementation MKCString
@@ -116,6 +117,10 @@
 - (mk_vm_size_t)nodeSize
 { return _nodeSize; }
 
+//|++++++++++++++++++++++++++++++++++++|//
++ (BOOL)hasInvariantLayout
+{ return YES; }
+
 //|++++++++++++++++++++++++++++++++++++|//
 - (MKNodeDescription*)layout
 {
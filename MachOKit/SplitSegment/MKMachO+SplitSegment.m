@@ -27,6 +27,7 @@
 
 #import "MKMachO+SplitSegment.h"
 #import "MKInternal.h"
+#import "_MKMachOImage+NodeCache.h"
 
 #import "MKSplitSegmentInfo.h"
 
@@ -40,20 +41,17 @@
 //|++++++++++++++++++++++++++++++++++++|//
 - (MKResult*)splitSegmentInfo
 {
-    if (_splitSegment == nil)
-    {
+    return [self _subtreeForKey:@"splitSegmentInfo" storage:&_splitSegment builder:^MKResult* {
         NSError *splitSegmentInfoError = nil;
         
         MKSplitSegmentInfo *splitSegmentInfo = [[MKSplitSegmentInfo alloc] initWithParent:self error:&splitSegmentInfoError];
         if (splitSegmentInfo)
-            _splitSegment = [[MKResult alloc] initWithValue:splitSegmentInfo];
+            return [[MKResult alloc] initWithValue:splitSegmentInfo];
         else if (splitSegmentInfoError /* Only failed if we have an error */)
-            _splitSegment = [[MKResult alloc] initWithError:splitSegmentInfoError];
+            return [[MKResult alloc] initWithError:splitSegmentInfoError];
         else
-            _splitSegment = [MKResult new];
-    }
-    
-    return _splitSegment;
+            return [MKResult new];
+    }];
 }
 
 //◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦//
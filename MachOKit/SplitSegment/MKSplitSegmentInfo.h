@@ -33,18 +33,73 @@
 @class MKMachOImage;
 @class MKSplitSegmentInfoV1;
 
+// <https://opensource.apple.com/source/ld64/ld64-409.12/src/abstraction/MachOFileAbstraction.hpp.auto.html>
+#ifndef DYLD_CACHE_ADJ_V2_FORMAT
+    #define DYLD_CACHE_ADJ_V2_FORMAT 0x7F
+#endif
+
 NS_ASSUME_NONNULL_BEGIN
 
+//----------------------------------------------------------------------------//
+//! @name       Split Segment Info Formats
+//! @relates    MKSplitSegmentInfo
+//
+typedef NS_ENUM(uint8_t, MKSplitSegmentInfoFormat) {
+    //! A list of kinds, each followed by the offsets of the locations to
+    //! adjust.
+    MKSplitSegmentInfoFormatV1                  = 1,
+    //! Introduced by \c DYLD_CACHE_ADJ_V2_FORMAT.  A list of (from section,
+    //! to section, kind, offset) tuples.
+    MKSplitSegmentInfoFormatV2                  = 2
+};
+
+//! The section index of a reference whose target is not recorded by the
+//! format.
+static const uint32_t MKSplitSegmentSectionIndexUnknown = UINT32_MAX;
+
+
+
+//----------------------------------------------------------------------------//
+//! A location that must be adjusted when the image's segments are moved
+//! relative to each other.
+//!
+//! Section indexes count the sections of the image in load command order,
+//! starting at \c 1.  Index \c 0 refers to the Mach-O header, i.e, the start
+//! of the image.  V1 references only record the location being adjusted, as
+//! an offset from the start of the image.
+//
+typedef struct MKSplitSegmentReference {
+    uint64_t fromSectionOffset;
+    uint64_t toSectionOffset;
+    uint32_t fromSectionIndex;
+    uint32_t toSectionIndex;
+    //! A \c DYLD_CACHE_ADJ_V1_* or \c DYLD_CACHE_ADJ_V2_* kind, depending on
+    //! the format.
+    uint8_t kind;
+} MKSplitSegmentReference;
+
+
+
 //----------------------------------------------------------------------------//
 @interface MKSplitSegmentInfo : MKLinkEditNode {
 @package
     id _impl;
+    mk_vm_offset_t _dataOffset;
+    MKSplitSegmentInfoFormat _format;
+    NSUInteger _referenceCount;
+    MKSplitSegmentReference *_references;
 }
 
 //! Initializes the receiver with the provided Mach-O.
 - (nullable instancetype)initWithImage:(MKMachOImage*)image error:(NSError**)error;
 
-//! 
+@property (nonatomic, assign, readonly) MKSplitSegmentInfoFormat format;
+
+@property (nonatomic, assign, readonly) NSUInteger referenceCount;
+//! The decoded references of either format, in the order they are encoded.
+@property (nonatomic, assign, readonly, nullable) const MKSplitSegmentReference *references;
+
+//! The node tree of V1 split segment info.  Created on first access.
 @property (nonatomic, strong, readonly, nullable) MKSplitSegmentInfoV1 *v1;
 
 @end
@@ -31,28 +31,197 @@
 #import "MKLCSegmentSplitInfo.h"
 #import "MKSplitSegmentInfoV1.h"
 
+#include "_mach_trie.h"
+#include <malloc/malloc.h>
+
+//|++++++++++++++++++++++++++++++++++++|//
+static mk_error_t
+MKSplitSegmentInfoDecodeV1(const uint8_t *p, const uint8_t *end, MKSplitSegmentReference *references, size_t *count)
+{
+    mk_error_t err;
+    size_t n = 0;
+    
+    while (p < end)
+    {
+        uint8_t kind = *p++;
+        // A second terminator after the end of an entry ends the list.
+        if (kind == 0)
+            break;
+        
+        uint64_t address = 0;
+        while (1) {
+            uint64_t delta;
+            size_t ulebSize;
+            
+            if ((err = _mk_mach_trie_copy_uleb128(p, end, &delta, &ulebSize))) {
+                *count = n;
+                return err;
+            }
+            p += ulebSize;
+            
+            if (delta == 0)
+                break;
+            
+            address += delta;
+            if (references)
+                references[n] = (MKSplitSegmentReference){
+                    .fromSectionOffset = address,
+                    .toSectionOffset = 0,
+                    .fromSectionIndex = 0,
+                    .toSectionIndex = MKSplitSegmentSectionIndexUnknown,
+                    .kind = kind
+                };
+            n++;
+        }
+    }
+    
+    *count = n;
+    return MK_ESUCCESS;
+}
+
+//|++++++++++++++++++++++++++++++++++++|//
+static mk_error_t
+MKSplitSegmentInfoDecodeV2(const uint8_t *p, const uint8_t *end, MKSplitSegmentReference *references, size_t *count)
+{
+    mk_error_t err;
+    size_t n = 0;
+    
+#define READ_ULEB(VALUE) do { \
+    size_t ulebSize; \
+    if ((err = _mk_mach_trie_copy_uleb128(p, end, &VALUE, &ulebSize))) { \
+        *count = n; \
+        return err; \
+    } \
+    p += ulebSize; \
+} while (0)
+    
+    // Skip the DYLD_CACHE_ADJ_V2_FORMAT marker.
+    p++;
+    
+    uint64_t sectionCount;
+    READ_ULEB(sectionCount);
+    
+    for (uint64_t i = 0; i < sectionCount; i++)
+    {
+        uint64_t fromSectionIndex, toSectionIndex, toOffsetCount;
+        READ_ULEB(fromSectionIndex);
+        READ_ULEB(toSectionIndex);
+        READ_ULEB(toOffsetCount);
+        
+        if (fromSectionIndex >= MKSplitSegmentSectionIndexUnknown || toSectionIndex >= MKSplitSegmentSectionIndexUnknown) {
+            *count = n;
+            return MK_EOUT_OF_RANGE;
+        }
+        
+        uint64_t toSectionOffset = 0;
+        for (uint64_t j = 0; j < toOffsetCount; j++)
+        {
+            uint64_t toSectionDelta, fromOffsetCount;
+            READ_ULEB(toSectionDelta);
+            READ_ULEB(fromOffsetCount);
+            toSectionOffset += toSectionDelta;
+            
+            for (uint64_t k = 0; k < fromOffsetCount; k++)
+            {
+                uint64_t kind, fromSectionDeltaCount;
+                READ_ULEB(kind);
+                READ_ULEB(fromSectionDeltaCount);
+                
+                if (kind > UINT8_MAX) {
+                    *count = n;
+                    return MK_EINVALID_DATA;
+                }
+                
+                uint64_t fromSectionOffset = 0;
+                for (uint64_t l = 0; l < fromSectionDeltaCount; l++)
+                {
+                    uint64_t fromSectionDelta;
+                    READ_ULEB(fromSectionDelta);
+                    fromSectionOffset += fromSectionDelta;
+                    
+                    if (references)
+                        references[n] = (MKSplitSegmentReference){
+                            .fromSectionOffset = fromSectionOffset,
+                            .toSectionOffset = toSectionOffset,
+                            .fromSectionIndex = (uint32_t)fromSectionIndex,
+                            .toSectionIndex = (uint32_t)toSectionIndex,
+                            .kind = (uint8_t)kind
+                        };
+                    n++;
+                }
+            }
+        }
+    }
+    
+#undef READ_ULEB
+    
+    *count = n;
+    return MK_ESUCCESS;
+}
+
+
+
 //----------------------------------------------------------------------------//
 @implementation MKSplitSegmentInfo
 
+@synthesize format = _format;
+@synthesize referenceCount = _referenceCount;
+
 //|++++++++++++++++++++++++++++++++++++|//
 - (instancetype)initWithSize:(mk_vm_size_t)size offset:(mk_vm_offset_t)offset inImage:(MKMachOImage*)image error:(NSError**)error
 {
     self = [super initWithSize:size offset:offset inImage:image error:error];
     if (self == nil) return nil;
     
-    NSError *splitSegmentInfoError = nil;
+    _dataOffset = offset;
+    _format = MKSplitSegmentInfoFormatV1;
     
-    // Try initializing split segment v1
-    {
-        MKSplitSegmentInfoV1 *v1 = [[MKSplitSegmentInfoV1 alloc] initWithSize:size offset:offset inImage:image error:&splitSegmentInfoError];
-        if (v1) {
-            _impl = v1;
-            return self;
+    if (self.nodeSize == 0)
+        return self;
+    
+    // Decode the references straight from the mapped data.  The first pass
+    // counts the references so that the second can fill an array of the
+    // exact size.
+    __block NSError *localError = nil;
+    
+    [self.memoryMap remapBytesAtOffset:0 fromAddress:self.nodeContextAddress length:self.nodeSize requireFull:YES withHandler:^(vm_address_t address, vm_size_t length, NSError *e) {
+        if (address == 0 || length == 0) {
+            localError = e;
+            return;
         }
+        
+        const uint8_t *start = (const uint8_t*)address;
+        const uint8_t *end = start + length;
+        
+        if (*start == DYLD_CACHE_ADJ_V2_FORMAT)
+            _format = MKSplitSegmentInfoFormatV2;
+        
+        mk_error_t (*decode)(const uint8_t*, const uint8_t*, MKSplitSegmentReference*, size_t*) = (_format == MKSplitSegmentInfoFormatV2) ? MKSplitSegmentInfoDecodeV2 : MKSplitSegmentInfoDecodeV1;
+        
+        size_t count = 0;
+        mk_error_t err = decode(start, end, NULL, &count);
+        if (err != MK_ESUCCESS)
+            MK_PUSH_WARNING(references, err, @"Could not decode split segment info V%u (err = %s).  Decoded %zu references.", _format, mk_error_string(err), count);
+        
+        if (count == 0)
+            return;
+        
+        _references = malloc(count * sizeof(MKSplitSegmentReference));
+        if (_references == NULL) {
+            localError = [NSError mk_errorWithDomain:MKErrorDomain code:MK_EINTERNAL_ERROR description:@"Could not allocate %zu references.", count];
+            return;
+        }
+        
+        decode(start, end, _references, &count);
+        _referenceCount = count;
+    }];
+    
+    if (localError) {
+        MK_ERROR_OUT = [NSError mk_errorWithDomain:MKErrorDomain code:MK_EINTERNAL_ERROR underlyingError:localError description:@"Could not read split segment info."];
+        return nil;
     }
     
-    MK_ERROR_OUT = splitSegmentInfoError;
-    return nil;
+    return self;
 }
 
 //|++++++++++++++++++++++++++++++++++++|//
@@ -83,17 +252,58 @@
 - (instancetype)initWithParent:(MKNode*)parent error:(NSError**)error
 { return [self initWithImage:parent.macho error:error]; }
 
+//|++++++++++++++++++++++++++++++++++++|//
+- (void)dealloc
+{
+    free(_references);
+}
+
+//◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦//
+#pragma mark -  Estimating Memory Usage
+//◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦//
+
+//|++++++++++++++++++++++++++++++++++++|//
+- (NSUInteger)estimatedMemoryCost
+{
+    NSUInteger cost = super.estimatedMemoryCost + malloc_size(_references);
+    @synchronized(self) {
+        if ([_impl isKindOfClass:MKNode.class])
+            cost += [(MKNode*)_impl estimatedMemoryCost];
+    }
+    return cost;
+}
+
 //◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦//
 #pragma mark -  Values
 //◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦//
 
+//|++++++++++++++++++++++++++++++++++++|//
+- (const MKSplitSegmentReference *)references
+{ return _references; }
+
 //|++++++++++++++++++++++++++++++++++++|//
 - (MKSplitSegmentInfoV1*)v1
 {
-    if ([_impl isKindOfClass:MKSplitSegmentInfoV1.class])
-        return _impl;
-    else
+    if (_format != MKSplitSegmentInfoFormatV1)
         return nil;
+    
+    // The node tree is only needed for display, build it on demand.
+    @synchronized(self) {
+        if (_impl == nil) {
+            NSError *v1Error = nil;
+            
+            _impl = [[MKSplitSegmentInfoV1 alloc] initWithSize:self.nodeSize offset:_dataOffset inImage:self.macho error:&v1Error];
+            if (_impl == nil) {
+                MK_PUSH_WARNING_WITH_ERROR(v1, MK_EINTERNAL_ERROR, v1Error, @"Could not parse split segment info V1.");
+                _impl = NSNull.null;
+            }
+        }
+        
+        if ([_impl isKindOfClass:MKSplitSegmentInfoV1.class])
+            return _impl;
+        else
+            return nil;
+    }
 }
 
 //◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦//
@@ -110,7 +320,23 @@
     v1.description = @"V1";
     v1.options = MKNodeFieldOptionDisplayAsChild;
     
+    MKNodeFieldBuilder *format = [MKNodeFieldBuilder
+        builderWithProperty:MK_PROPERTY(format)
+        type:MKNodeFieldTypeUnsignedByte.sharedInstance
+    ];
+    format.description = @"Format";
+    format.options = MKNodeFieldOptionDisplayAsDetail;
+    
+    MKNodeFieldBuilder *referenceCount = [MKNodeFieldBuilder
+        builderWithProperty:MK_PROPERTY(referenceCount)
+        type:MKNodeFieldTypeUnsignedQuadWord.sharedInstance
+    ];
+    referenceCount.description = @"References";
+    referenceCount.options = MKNodeFieldOptionDisplayAsDetail;
+    
     return [MKNodeDescription nodeDescriptionWithParentDescription:super.layout fields:@[
+        format.build,
+        referenceCount.build,
         v1.build
     ]];
 }
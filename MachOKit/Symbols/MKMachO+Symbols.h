@@ -33,6 +33,7 @@
 @class MKStringTable;
 @class MKSymbolTable;
 @class MKIndirectSymbolTable;
+@class MKStubTable;
 
 NS_ASSUME_NONNULL_BEGIN
 
@@ -56,6 +57,10 @@ NS_ASSUME_NONNULL_BEGIN
 //! value and a \c nil error if the image has no indirect symbol table.
 @property (nonatomic, strong, readonly) MKResult<MKIndirectSymbolTable*> *indirectSymbolTable;
 
+//! A flat table mapping each stub, lazy pointer and non-lazy pointer to the
+//! symbol it resolves to.  Built on first access.
+@property (nonatomic, strong, readonly) MKResult<MKStubTable*> *stubTable;
+
 + (MKNodeFieldBuilder*)_stringTableFieldBuilder;
 + (MKNodeFieldBuilder*)_symbolTableFieldBuilder;
 + (MKNodeFieldBuilder*)_indirectSymbolTableFieldBuilder;
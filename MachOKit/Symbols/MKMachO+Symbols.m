@@ -27,10 +27,12 @@
 
 #import "MKMachO+Symbols.h"
 #import "MKInternal.h"
+#import "_MKMachOImage+NodeCache.h"
 
 #import "MKStringTable.h"
 #import "MKSymbolTable.h"
 #import "MKIndirectSymbolTable.h"
+#import "MKStubTable.h"
 
 //----------------------------------------------------------------------------//
 @implementation MKMachOImage (Symbols)
@@ -42,46 +44,49 @@
 //|++++++++++++++++++++++++++++++++++++|//
 - (MKResult*)stringTable
 {
-    if (_stringTable == nil)
-    {
+    return [self _subtreeForKey:@"stringTable" storage:&_stringTable builder:^MKResult* {
         MKResult<MKStringTable*> *stringTable = [MKResult newResultWith:^(NSError **error) {
             return [[MKStringTable alloc] initWithParent:self error:error];
         }];
         
-        _stringTable = stringTable;
-    }
-    
-    return _stringTable;
+        return stringTable;
+    }];
 }
 
 //|++++++++++++++++++++++++++++++++++++|//
 - (MKResult*)symbolTable
 {
-    if (_symbolTable == nil)
-    {
+    return [self _subtreeForKey:@"symbolTable" storage:&_symbolTable builder:^MKResult* {
         MKResult<MKSymbolTable*> *symbolTable = [MKResult newResultWith:^(NSError **error) {
             return [[MKSymbolTable alloc] initWithParent:self error:error];
         }];
         
-        _symbolTable = symbolTable;
-    }
-    
-    return _symbolTable;
+        return symbolTable;
+    }];
 }
 
 //|++++++++++++++++++++++++++++++++++++|//
 - (MKResult*)indirectSymbolTable
 {
-    if (_indirectSymbolTable == nil)
-    {
+    return [self _subtreeForKey:@"indirectSymbolTable" storage:&_indirectSymbolTable builder:^MKResult* {
         MKResult<MKIndirectSymbolTable*> *indirectSymbolTable = [MKResult newResultWith:^(NSError **error) {
             return [[MKIndirectSymbolTable alloc] initWithParent:self error:error];
         }];
         
-        _indirectSymbolTable = indirectSymbolTable;
-    }
-    
-    return _indirectSymbolTable;
+        return indirectSymbolTable;
+    }];
+}
+
+//|++++++++++++++++++++++++++++++++++++|//
+- (MKResult*)stubTable
+{
+    return [self _subtreeForKey:@"stubTable" storage:&_stubTable builder:^MKResult* {
+        MKResult<MKStubTable*> *stubTable = [MKResult newResultWith:^(NSError **error) {
+            return [[MKStubTable alloc] initWithImage:self error:error];
+        }];
+        
+        return stubTable;
+    }];
 }
 
 //◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦//
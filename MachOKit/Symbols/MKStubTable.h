@@ -0,0 +1,106 @@
+//----------------------------------------------------------------------------//
+//|
+//|             MachOKit - A Lightweight Mach-O Parsing Library
+//! @file       MKStubTable.h
+//!
+//! @author     D.V.
+//! @copyright  Copyright (c) 2014-2015 D.V. All rights reserved.
+//|
+//| Permission is hereby granted, free of charge, to any person obtaining a
+//| copy of this software and associated documentation files (the "Software"),
+//| to deal in the Software without restriction, including without limitation
+//| the rights to use, copy, modify, merge, publish, distribute, sublicense,
+//| and/or sell copies of the Software, and to permit persons to whom the
+//| Software is furnished to do so, subject to the following conditions:
+//|
+//| The above copyright notice and this permission notice shall be included
+//| in all copies or substantial portions of the Software.
+//|
+//| THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+//| OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+//| MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+//| IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+//| CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+//| TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+//| SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+//----------------------------------------------------------------------------//
+
+#include <MachOKit/macho.h>
+#import <Foundation/Foundation.h>
+
+#import <MachOKit/MKNode.h>
+#import <MachOKit/MKNodeFieldSymbolLibraryOrdinalType.h>
+
+@class MKMachOImage;
+
+NS_ASSUME_NONNULL_BEGIN
+
+//----------------------------------------------------------------------------//
+//! @name       Stub Table Entry Kinds
+//! @relates    MKStubTable
+//
+typedef NS_ENUM(uint8_t, MKStubTableEntryKind) {
+    //! An entry in a \c S_SYMBOL_STUBS section.
+    MKStubTableEntryKindStub = 0,
+    //! An entry in a \c S_LAZY_SYMBOL_POINTERS or
+    //! \c S_LAZY_DYLIB_SYMBOL_POINTERS section.
+    MKStubTableEntryKindLazyPointer,
+    //! An entry in a \c S_NON_LAZY_SYMBOL_POINTERS section.
+    MKStubTableEntryKindNonLazyPointer
+};
+
+
+
+//----------------------------------------------------------------------------//
+//! A stub or indirect pointer, and the symbol it resolves to.  Entries are
+//! owned by the \ref MKStubTable instance that produced them and remain
+//! valid for its lifetime.
+//
+typedef struct MKStubTableEntry {
+    //! The VM address of the stub or pointer, with the image's slide
+    //! applied.
+    mk_vm_address_t address;
+    //! The name of the symbol, or \c NULL if the indirect symbol table entry
+    //! is \c INDIRECT_SYMBOL_LOCAL or \c INDIRECT_SYMBOL_ABS.
+    const char * _Nullable symbolName;
+    //! The raw indirect symbol table entry.  This is an index into the
+    //! symbol table unless one of \c INDIRECT_SYMBOL_LOCAL or
+    //! \c INDIRECT_SYMBOL_ABS is set.
+    uint32_t symbolIndex;
+    //! The library ordinal of an undefined symbol, or
+    //! \ref MKSourceLibraryOrdinalSelf.
+    MKSymbolLibraryOrdinal libraryOrdinal;
+    MKStubTableEntryKind kind;
+} MKStubTableEntry;
+
+
+
+//----------------------------------------------------------------------------//
+//! An instance of \c MKStubTable maps every stub, lazy pointer and non-lazy
+//! pointer of an image to the symbol it resolves to.
+//!
+//! The table is built from the \c reserved1 and \c reserved2 fields of the
+//! section load commands, the raw indirect symbol table, and a single pass
+//! over the symbol table, without instantiating the section or symbol
+//! nodes.  Because the entries of a section are evenly sized, looking up
+//! an address costs a binary search over the (few) stub and pointer
+//! sections followed by direct indexing into the section's entries.
+//
+@interface MKStubTable : MKNode
+
+- (nullable instancetype)initWithImage:(MKMachOImage*)image error:(NSError**)error;
+
+//! The image this table was built from.
+@property (nonatomic, weak, readonly) MKMachOImage *image;
+
+@property (nonatomic, assign, readonly) NSUInteger entryCount;
+//! The entries, sorted by address.
+@property (nonatomic, assign, readonly, nullable) const MKStubTableEntry *entries;
+
+//! Returns the entry for the stub or pointer containing \a address, or
+//! \c NULL.  \a address is a slid VM address.
+- (nullable const MKStubTableEntry *)entryForAddress:(mk_vm_address_t)address;
+
+@end
+
+NS_ASSUME_NONNULL_END
@@ -0,0 +1,408 @@
+//----------------------------------------------------------------------------//
+//|
+//|             MachOKit - A Lightweight Mach-O Parsing Library
+//|             MKStubTable.m
+//|
+//|             D.V.
+//|             Copyright (c) 2014-2015 D.V. All rights reserved.
+//|
+//| Permission is hereby granted, free of charge, to any person obtaining a
+//| copy of this software and associated documentation files (the "Software"),
+//| to deal in the Software without restriction, including without limitation
+//| the rights to use, copy, modify, merge, publish, distribute, sublicense,
+//| and/or sell copies of the Software, and to permit persons to whom the
+//| Software is furnished to do so, subject to the following conditions:
+//|
+//| The above copyright notice and this permission notice shall be included
+//| in all copies or substantial portions of the Software.
+//|
+//| THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+//| OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+//| MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+//| IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+//| CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+//| TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+//| SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+//----------------------------------------------------------------------------//
+
+
+#import "MKStubTable.h"
+#import "MKInternal.h"
+#import "MKMachO.h"
+#import "MKLCSegment.h"
+#import "MKLCDysymtab.h"
+#import "MKLinkEditNode.h"
+#import "_MKSymbolTableReader.h"
+
+#include <mach-o/nlist.h>
+#include <malloc/malloc.h>
+
+//! A stub or pointer section.  Entries of the section are contiguous in
+//! the table, and evenly sized.
+struct MKStubTableSection {
+    mk_vm_address_t address;
+    mk_vm_size_t size;
+    uint32_t entrySize;
+    uint32_t firstEntry;
+    uint32_t entryCount;
+    MKStubTableEntryKind kind;
+};
+
+//! Marks a symbol whose name has not been copied yet.
+#define MKStubTableNameWanted       (SIZE_MAX - 1)
+//! Marks a symbol that no entry references, or whose name is unreadable.
+#define MKStubTableNameNone         SIZE_MAX
+
+//|++++++++++++++++++++++++++++++++++++|//
+static int
+MKStubTableSectionCompare(const void *a, const void *b)
+{
+    mk_vm_address_t lhs = ((const struct MKStubTableSection*)a)->address;
+    mk_vm_address_t rhs = ((const struct MKStubTableSection*)b)->address;
+    return (lhs > rhs) - (lhs < rhs);
+}
+
+
+
+//----------------------------------------------------------------------------//
+@implementation MKStubTable {
+    NSUInteger _entryCount;
+    MKStubTableEntry *_entries;
+    NSUInteger _sectionCount;
+    struct MKStubTableSection *_sections;
+    char *_strings;
+}
+
+//|++++++++++++++++++++++++++++++++++++|//
+- (instancetype)initWithImage:(MKMachOImage*)image error:(NSError**)error
+{
+    NSParameterAssert(image != nil);
+    
+    self = [super initWithParent:image error:error];
+    if (self == nil) return nil;
+    
+    // An image without an indirect symbol table has no stubs or indirect
+    // pointers.
+    MKLCDysymtab *dysymtabLoadCommand = [image loadCommandsOfType:LC_DYSYMTAB].firstObject;
+    uint32_t indirectSymbolCount = dysymtabLoadCommand.nindirectsyms;
+    if (indirectSymbolCount == 0)
+        return self;
+    
+    size_t pointerSize = self.dataModel.pointerSize;
+    
+    // Collect the stub and pointer sections.
+    NSMutableArray<id<MKLCSection>> *sectionLoadCommands = [NSMutableArray array];
+    {
+        NSArray *segmentLoadCommands = [image loadCommandsOfType:(pointerSize == 8) ? LC_SEGMENT_64 : LC_SEGMENT];
+        for (id<MKLCSegment> segmentLC in segmentLoadCommands)
+        for (id<MKLCSection> sectionLC in segmentLC.sections) {
+            switch (sectionLC.flags & SECTION_TYPE) {
+                case S_SYMBOL_STUBS:
+                case S_LAZY_SYMBOL_POINTERS:
+                case S_LAZY_DYLIB_SYMBOL_POINTERS:
+                case S_NON_LAZY_SYMBOL_POINTERS:
+                    [sectionLoadCommands addObject:sectionLC];
+                    break;
+                default:
+                    break;
+            }
+        }
+    }
+    
+    if (sectionLoadCommands.count == 0)
+        return self;
+    
+    // Read the indirect symbol table.
+    uint32_t *indirectSymbols = NULL;
+    {
+        NSError *localError = nil;
+        mk_vm_size_t length = (mk_vm_size_t)indirectSymbolCount * sizeof(uint32_t);
+        MKLinkEditNode *indirectSymbolTable = [[MKLinkEditNode alloc] initWithSize:length offset:dysymtabLoadCommand.indirectsymoff inImage:image error:&localError];
+        if (indirectSymbolTable == nil) {
+            MK_ERROR_OUT = [NSError mk_errorWithDomain:MKErrorDomain code:MK_EINTERNAL_ERROR underlyingError:localError description:@"Could not locate the indirect symbol table."];
+            return nil;
+        }
+        
+        indirectSymbols = malloc((size_t)length);
+        if (indirectSymbols == NULL) {
+            MK_ERROR_OUT = [NSError mk_errorWithDomain:MKErrorDomain code:MK_EINTERNAL_ERROR description:@"Could not allocate the indirect symbol table."];
+            return nil;
+        }
+        
+        if ([indirectSymbolTable.memoryMap copyBytesAtOffset:0 fromAddress:indirectSymbolTable.nodeContextAddress into:indirectSymbols length:length requireFull:YES error:&localError] < length) {
+            free(indirectSymbols);
+            MK_ERROR_OUT = [NSError mk_errorWithDomain:MKErrorDomain code:MK_EINTERNAL_ERROR underlyingError:localError description:@"Could not read the indirect symbol table."];
+            return nil;
+        }
+        
+        for (uint32_t i = 0; i < indirectSymbolCount; i++)
+            MKSwapLValue32(indirectSymbols[i], self.dataModel);
+    }
+    
+    _sections = calloc(sectionLoadCommands.count, sizeof(*_sections));
+    if (_sections == NULL) {
+        free(indirectSymbols);
+        MK_ERROR_OUT = [NSError mk_errorWithDomain:MKErrorDomain code:MK_EINTERNAL_ERROR description:@"Could not allocate the stub sections."];
+        return nil;
+    }
+    
+    size_t capacity = 0;
+    for (id<MKLCSection> sectionLC in sectionLoadCommands)
+    {
+        struct MKStubTableSection *section = &_sections[_sectionCount];
+        uint32_t type = sectionLC.flags & SECTION_TYPE;
+        
+        section->size = sectionLC.mk_size;
+        section->entrySize = (type == S_SYMBOL_STUBS) ? sectionLC.reserved2 : (uint32_t)pointerSize;
+        
+        switch (type) {
+            case S_SYMBOL_STUBS:
+                section->kind = MKStubTableEntryKindStub;
+                break;
+            case S_NON_LAZY_SYMBOL_POINTERS:
+                section->kind = MKStubTableEntryKindNonLazyPointer;
+                break;
+            default:
+                section->kind = MKStubTableEntryKindLazyPointer;
+                break;
+        }
+        
+        if (mk_vm_address_apply_slide(sectionLC.mk_addr, image.slide, &section->address)) {
+            MK_PUSH_WARNING(entries, MK_EOUT_OF_RANGE, @"Could not apply the image slide to section %@.", sectionLC.sectname);
+            continue;
+        }
+        
+        if (section->entrySize == 0) {
+            MK_PUSH_WARNING(entries, MK_EINVALID_DATA, @"No stub size specified for section %@.", sectionLC.sectname);
+            continue;
+        }
+        
+        // Clamp the section to the end of the indirect symbol table.
+        uint64_t entryCount = section->size / section->entrySize;
+        uint32_t firstIndex = sectionLC.reserved1;
+        if (firstIndex > indirectSymbolCount || entryCount > indirectSymbolCount - firstIndex) {
+            MK_PUSH_WARNING(entries, MK_EOUT_OF_RANGE, @"Section %@ extends past the end of the indirect symbol table.", sectionLC.sectname);
+            entryCount = (firstIndex > indirectSymbolCount) ? 0 : indirectSymbolCount - firstIndex;
+        }
+        
+        section->entryCount = (uint32_t)entryCount;
+        // Stash the first index into the indirect symbol table until the
+        // sections are sorted.
+        section->firstEntry = firstIndex;
+        capacity += (size_t)entryCount;
+        _sectionCount++;
+    }
+    
+    qsort(_sections, _sectionCount, sizeof(*_sections), MKStubTableSectionCompare);
+    
+    // The symbol table is optional.  Without it, entries have no names.
+    NSError *symbolTableError = nil;
+    _MKSymbolTableReader *symbolTable = [[_MKSymbolTableReader alloc] initWithImage:image error:&symbolTableError];
+    uint32_t symbolCount = symbolTable.symbolCount;
+    if (symbolTable == nil)
+        MK_PUSH_WARNING_WITH_ERROR(entries, MK_EINTERNAL_ERROR, symbolTableError, @"Could not load the symbol table.");
+    
+    _entries = calloc(MAX(capacity, 1U), sizeof(MKStubTableEntry));
+    // Per symbol: the offset of its name in _strings, and its library
+    // ordinal.
+    size_t *nameOffsets = malloc(MAX(symbolCount, 1U) * sizeof(size_t));
+    MKSymbolLibraryOrdinal *libraryOrdinals = malloc(MAX(symbolCount, 1U) * sizeof(MKSymbolLibraryOrdinal));
+    
+    if (_entries == NULL || nameOffsets == NULL || libraryOrdinals == NULL) {
+        free(libraryOrdinals);
+        free(nameOffsets);
+        free(indirectSymbols);
+        MK_ERROR_OUT = [NSError mk_errorWithDomain:MKErrorDomain code:MK_EINTERNAL_ERROR description:@"Could not allocate the stub table."];
+        return nil;
+    }
+    
+    for (uint32_t i = 0; i < symbolCount; i++) {
+        nameOffsets[i] = MKStubTableNameNone;
+        libraryOrdinals[i] = MKSourceLibraryOrdinalSelf;
+    }
+    
+    // Create the entries, and mark the symbols they reference.
+    for (NSUInteger s = 0; s < _sectionCount; s++)
+    {
+        struct MKStubTableSection *section = &_sections[s];
+        uint32_t firstIndex = section->firstEntry;
+        section->firstEntry = (uint32_t)_entryCount;
+        
+        // Lookups rely on the sections not overlapping.
+        if (s > 0 && section->address < _sections[s-1].address + _sections[s-1].size) {
+            MK_PUSH_WARNING(entries, MK_EINVALID_DATA, @"Stub section at address [0x%" MK_VM_PRIxADDR "] overlaps the preceding section.", section->address);
+            section->entryCount = 0;
+            continue;
+        }
+        
+        for (uint32_t i = 0; i < section->entryCount; i++)
+        {
+            MKStubTableEntry *entry = &_entries[_entryCount++];
+            uint32_t value = indirectSymbols[firstIndex + i];
+            
+            entry->address = section->address + (mk_vm_address_t)i * section->entrySize;
+            entry->symbolIndex = value;
+            entry->kind = section->kind;
+            entry->libraryOrdinal = MKSourceLibraryOrdinalSelf;
+            entry->symbolName = NULL;
+            
+            if (value & (INDIRECT_SYMBOL_LOCAL | INDIRECT_SYMBOL_ABS))
+                continue;
+            if (value >= symbolCount) {
+                MK_PUSH_WARNING(entries, MK_EOUT_OF_RANGE, @"Indirect symbol at address [0x%" MK_VM_PRIxADDR "] references symbol [%u], which is not in the symbol table.", entry->address, value);
+                continue;
+            }
+            
+            nameOffsets[value] = MKStubTableNameWanted;
+        }
+    }
+    
+    free(indirectSymbols);
+    
+    // Copy the names of the referenced symbols in a single pass over the
+    // symbol table.
+    __block size_t stringsLength = 0, stringsCapacity = 4096;
+    __block BOOL outOfMemory = NO;
+    _strings = malloc(stringsCapacity);
+    
+    if (_strings == NULL) {
+        outOfMemory = YES;
+    } else if (symbolTable) {
+        char * __block strings = _strings;
+        NSError *enumerationError = nil;
+        BOOL success = [symbolTable enumerateSymbolsWithError:&enumerationError usingBlock:^(uint32_t index, const struct nlist_64 *symbol, const char *name, BOOL *stop) {
+            if (nameOffsets[index] != MKStubTableNameWanted)
+                return;
+            
+            nameOffsets[index] = MKStubTableNameNone;
+            if ((symbol->n_type & N_TYPE) == N_UNDF && (symbol->n_type & N_EXT))
+                libraryOrdinals[index] = (MKSymbolLibraryOrdinal)GET_LIBRARY_ORDINAL(symbol->n_desc);
+            
+            size_t nameLength = strlen(name ?: "") + 1;
+            if (stringsLength + nameLength > stringsCapacity) {
+                size_t newCapacity = stringsCapacity;
+                while (stringsLength + nameLength > newCapacity)
+                    newCapacity *= 2;
+                
+                char *newStrings = realloc(strings, newCapacity);
+                if (newStrings == NULL) {
+                    outOfMemory = YES;
+                    *stop = YES;
+                    return;
+                }
+                strings = newStrings;
+                stringsCapacity = newCapacity;
+            }
+            
+            memcpy(strings + stringsLength, name ?: "", nameLength);
+            nameOffsets[index] = stringsLength;
+            stringsLength += nameLength;
+        }];
+        _strings = strings;
+        
+        if (!success)
+            MK_PUSH_WARNING_WITH_ERROR(entries, MK_EINTERNAL_ERROR, enumerationError, @"Could not read the symbol table.");
+    }
+    
+    if (outOfMemory)
+        MK_PUSH_WARNING(entries, MK_EINTERNAL_ERROR, @"Ran out of memory copying symbol names.");
+    
+    // The string buffer is no longer growing.  Resolve the names.
+    for (NSUInteger i = 0; i < _entryCount; i++) {
+        MKStubTableEntry *entry = &_entries[i];
+        uint32_t value = entry->symbolIndex;
+        if ((value & (INDIRECT_SYMBOL_LOCAL | INDIRECT_SYMBOL_ABS)) || value >= symbolCount)
+            continue;
+        
+        entry->libraryOrdinal = libraryOrdinals[value];
+        if (nameOffsets[value] < MKStubTableNameWanted)
+            entry->symbolName = _strings + nameOffsets[value];
+    }
+    
+    free(libraryOrdinals);
+    free(nameOffsets);
+    
+    return self;
+}
+
+//|++++++++++++++++++++++++++++++++++++|//
+- (instancetype)initWithParent:(MKNode*)parent error:(NSError**)error
+{ return [self initWithImage:(MKMachOImage*)parent error:error]; }
+
+//|++++++++++++++++++++++++++++++++++++|//
+- (void)dealloc
+{
+    free(_entries);
+    free(_sections);
+    free(_strings);
+}
+
+//◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦//
+#pragma mark -  Estimating Memory Usage
+//◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦//
+
+//|++++++++++++++++++++++++++++++++++++|//
+- (NSUInteger)estimatedMemoryCost
+{
+    return super.estimatedMemoryCost + malloc_size(_entries) + malloc_size(_sections) + malloc_size(_strings);
+}
+
+//◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦//
+#pragma mark -  Entries
+//◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦//
+
+@synthesize entryCount = _entryCount;
+
+//|++++++++++++++++++++++++++++++++++++|//
+- (const MKStubTableEntry *)entries
+{ return _entries; }
+
+//|++++++++++++++++++++++++++++++++++++|//
+- (MKMachOImage*)image
+{ return (MKMachOImage*)self.parent; }
+
+//|++++++++++++++++++++++++++++++++++++|//
+- (const MKStubTableEntry *)entryForAddress:(mk_vm_address_t)address
+{
+    // Find the last section starting at or below address.
+    NSUInteger low = 0, high = _sectionCount;
+    while (low < high) {
+        NSUInteger mid = low + (high - low) / 2;
+        if (_sections[mid].address <= address)
+            low = mid + 1;
+        else
+            high = mid;
+    }
+    if (low == 0)
+        return NULL;
+    
+    const struct MKStubTableSection *section = &_sections[low - 1];
+    mk_vm_offset_t offset = address - section->address;
+    uint64_t index = offset / section->entrySize;
+    
+    if (index >= section->entryCount)
+        return NULL;
+    
+    return &_entries[section->firstEntry + index];
+}
+
+//◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦//
+#pragma mark -  MKNode
+//◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦//
+
+//|++++++++++++++++++++++++++++++++++++|//
+- (MKNodeDescription*)layout
+{
+    MKNodeFieldBuilder *entryCount = [MKNodeFieldBuilder
+        builderWithProperty:MK_PROPERTY(entryCount)
+        type:MKNodeFieldTypeUnsignedQuadWord.sharedInstance
+    ];
+    entryCount.description = @"Entries";
+    entryCount.options = MKNodeFieldOptionDisplayAsDetail;
+    
+    return [MKNodeDescription nodeDescriptionWithParentDescription:super.layout fields:@[
+        entryCount.build
+    ]];
+}
+
+@end
@@ -0,0 +1,115 @@
+//----------------------------------------------------------------------------//
+//|
+//|             MachOKit - A Lightweight Mach-O Parsing Library
+//! @file       MKSymbolicator.h
+//!
+//! @author     D.V.
+//! @copyright  Copyright (c) 2014-2015 D.V. All rights reserved.
+//|
+//| Permission is hereby granted, free of charge, to any person obtaining a
+//| copy of this software and associated documentation files (the "Software"),
+//| to deal in the Software without restriction, including without limitation
+//| the rights to use, copy, modify, merge, publish, distribute, sublicense,
+//| and/or sell copies of the Software, and to permit persons to whom the
+//| Software is furnished to do so, subject to the following conditions:
+//|
+//| The above copyright notice and this permission notice shall be included
+//| in all copies or substantial portions of the Software.
+//|
+//| THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+//| OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+//| MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+//| IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+//| CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+//| TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+//| SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+//----------------------------------------------------------------------------//
+
+#include <MachOKit/macho.h>
+#import <Foundation/Foundation.h>
+
+@class MKMachOImage;
+@class MKSharedCache;
+
+NS_ASSUME_NONNULL_BEGIN
+
+//----------------------------------------------------------------------------//
+//! @name       Symbolication Sources
+//! @relates    MKSymbolication
+//
+typedef NS_ENUM(NSUInteger, MKSymbolicationSource) {
+    //! The address could not be attributed to any symbol.
+    MKSymbolicationSourceNone                   = 0,
+    //! The address starts a function listed in \c LC_FUNCTION_STARTS, but no
+    //! symbol names it.
+    MKSymbolicationSourceFunctionStarts,
+    //! The symbol came from the image's export trie.
+    MKSymbolicationSourceExports,
+    //! The symbol came from the image's symbol table.
+    MKSymbolicationSourceSymbolTable,
+    //! The symbol came from the shared cache's local symbols.
+    MKSymbolicationSourceSharedCacheLocalSymbols,
+};
+
+
+
+//----------------------------------------------------------------------------//
+//! The result of symbolicating one address.
+//
+@interface MKSymbolication : NSObject
+
+//! The address that was symbolicated.
+@property (nonatomic, assign, readonly) mk_vm_address_t address;
+//! The image containing \ref address, or \c nil if no image contains it.
+@property (nonatomic, strong, readonly, nullable) MKMachOImage *image;
+//! The name of the closest symbol at or below \ref address.
+@property (nonatomic, strong, readonly, nullable) NSString *symbolName;
+//! The address of the closest symbol or function start at or below
+//! \ref address.
+@property (nonatomic, assign, readonly) mk_vm_address_t symbolAddress;
+//! Where \ref symbolName and \ref symbolAddress came from.
+@property (nonatomic, assign, readonly) MKSymbolicationSource source;
+
+@end
+
+
+
+//----------------------------------------------------------------------------//
+//! The \c MKSymbolicator class resolves batches of addresses to symbols.
+//!
+//! Addresses are sorted and resolved in a single merged sweep against a
+//! sorted table per image, built from the image's symbol table, exports and
+//! function starts, as well as the shared cache's local symbols for images in
+//! a shared cache.  Symbols of images in an indexed shared cache are read from
+//! the index.  Tables are kept in a least-recently-used cache so that
+//! subsequent batches touching the same images do not rebuild them.
+//!
+//! Addresses are interpreted in the unslid VM address space of the images.
+//
+@interface MKSymbolicator : NSObject
+
+//! Initializes the receiver with a list of images to consider and an
+//! optional shared cache.  Addresses not covered by any of \a images are
+//! looked up in \a sharedCache.
+- (instancetype)initWithImages:(NSArray<MKMachOImage*> *)images sharedCache:(nullable MKSharedCache*)sharedCache NS_DESIGNATED_INITIALIZER;
+
+- (instancetype)init NS_UNAVAILABLE;
+
+//! The maximum number of per-image tables kept in the cache.  Defaults to
+//! \c 64.
+@property (nonatomic, assign) NSUInteger cacheLimit;
+
+//! Symbolicates \a addresses.  The returned array matches the order of
+//! \a addresses.
+- (NSArray<MKSymbolication*> *)symbolicateAddresses:(NSArray<NSNumber*> *)addresses;
+
+//! Symbolicates \a count addresses, invoking \a handler once per address
+//! in the order of \a addresses.
+- (void)symbolicateAddresses:(const mk_vm_address_t *)addresses count:(NSUInteger)count handler:(void (^)(NSUInteger index, MKSymbolication *result))handler;
+
+//! Discards all cached per-image tables.
+- (void)purgeCache;
+
+@end
+
+NS_ASSUME_NONNULL_END
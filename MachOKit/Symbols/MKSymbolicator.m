@@ -0,0 +1,523 @@
+//----------------------------------------------------------------------------//
+//|
+//|             MachOKit - A Lightweight Mach-O Parsing Library
+//|             MKSymbolicator.m
+//|
+//|             D.V.
+//|             Copyright (c) 2014-2015 D.V. All rights reserved.
+//|
+//| Permission is hereby granted, free of charge, to any person obtaining a
+//| copy of this software and associated documentation files (the "Software"),
+//| to deal in the Software without restriction, including without limitation
+//| the rights to use, copy, modify, merge, publish, distribute, sublicense,
+//| and/or sell copies of the Software, and to permit persons to whom the
+//| Software is furnished to do so, subject to the following conditions:
+//|
+//| The above copyright notice and this permission notice shall be included
+//| in all copies or substantial portions of the Software.
+//|
+//| THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+//| OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+//| MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+//| IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+//| CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+//| TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+//| SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+//----------------------------------------------------------------------------//
+
+#import "MKSymbolicator.h"
+#import "MKInternal.h"
+#import "MKMachO.h"
+#import "MKMachO+Segments.h"
+#import "MKMachO+Exports.h"
+#import "MKMachO+Functions.h"
+#import "MKSegment.h"
+#import "MKExportsInfo.h"
+#import "MKRegularExport.h"
+#import "MKFunctionStarts.h"
+#import "MKFunction.h"
+#import "MKSharedCache.h"
+#import "MKDSCImage.h"
+#import "DyldSharedCache.h"
+#import "DSCIndex.h"
+#import "_MKSymbolTableReader.h"
+
+#include <mach-o/nlist.h>
+
+//----------------------------------------------------------------------------//
+@interface MKSymbolication () {
+@package
+    mk_vm_address_t _address;
+    MKMachOImage *_image;
+    NSString *_symbolName;
+    mk_vm_address_t _symbolAddress;
+    MKSymbolicationSource _source;
+}
+- (instancetype)initWithAddress:(mk_vm_address_t)address;
+@end
+
+//----------------------------------------------------------------------------//
+@implementation MKSymbolication
+
+@synthesize address = _address;
+@synthesize image = _image;
+@synthesize symbolName = _symbolName;
+@synthesize symbolAddress = _symbolAddress;
+@synthesize source = _source;
+
+//|++++++++++++++++++++++++++++++++++++|//
+- (instancetype)initWithAddress:(mk_vm_address_t)address
+{
+    self = [super init];
+    if (self == nil) return nil;
+
+    _address = address;
+
+    return self;
+}
+
+//|++++++++++++++++++++++++++++++++++++|//
+- (NSString*)description
+{
+    if (_symbolName)
+        return [NSString stringWithFormat:@"0x%.16" PRIX64 " %@ + %" PRIu64, _address, _symbolName, _address - _symbolAddress];
+    else if (_image)
+        return [NSString stringWithFormat:@"0x%.16" PRIX64 " %@", _address, _image.name.lastPathComponent];
+    else
+        return [NSString stringWithFormat:@"0x%.16" PRIX64, _address];
+}
+
+@end
+
+
+
+//----------------------------------------------------------------------------//
+struct _MKSymbolicationEntry {
+    mk_vm_address_t address;
+    uint32_t nameIndex;
+    uint8_t source;
+};
+
+#define MK_SYMBOLICATION_NO_NAME UINT32_MAX
+
+//----------------------------------------------------------------------------//
+//! Sorted symbol table for one image.
+@interface _MKSymbolicationTable : NSObject {
+@package
+    NSNumber *_key;
+    struct _MKSymbolicationEntry *_entries;
+    NSUInteger _count;
+    NSArray<NSString*> *_names;
+    // Recency list, most recently used first.  The tables are retained by
+    // the symbolicator's dictionary.
+    __unsafe_unretained _MKSymbolicationTable *_previous;
+    __unsafe_unretained _MKSymbolicationTable *_next;
+}
+- (instancetype)initWithImage:(MKMachOImage*)image sharedCache:(MKSharedCache*)sharedCache;
+@end
+
+//----------------------------------------------------------------------------//
+@implementation _MKSymbolicationTable
+
+//|++++++++++++++++++++++++++++++++++++|//
+static int _MKSymbolicationEntryCompare(const void *a, const void *b)
+{
+    const struct _MKSymbolicationEntry *entryA = a;
+    const struct _MKSymbolicationEntry *entryB = b;
+    if (entryA->address != entryB->address)
+        return (entryA->address < entryB->address) ? -1 : 1;
+    // Prefer the most descriptive source for entries at the same address.
+    return (int)entryB->source - (int)entryA->source;
+}
+
+//|++++++++++++++++++++++++++++++++++++|//
+- (instancetype)initWithImage:(MKMachOImage*)image sharedCache:(MKSharedCache*)sharedCache
+{
+    self = [super init];
+    if (self == nil) return nil;
+
+    NSMutableData *entries = [NSMutableData data];
+    NSMutableArray<NSString*> *names = [NSMutableArray array];
+
+    void (^addEntry)(mk_vm_address_t, NSString*, MKSymbolicationSource) = ^(mk_vm_address_t address, NSString *name, MKSymbolicationSource source) {
+        struct _MKSymbolicationEntry entry = { address, MK_SYMBOLICATION_NO_NAME, (uint8_t)source };
+        if (name.length) {
+            entry.nameIndex = (uint32_t)names.count;
+            [names addObject:name];
+        }
+        [entries appendBytes:&entry length:sizeof(entry)];
+    };
+
+    mk_vm_address_t imageAddress = image.nodeVMAddress;
+    DyldSharedCache *dsc = image.dsc ?: sharedCache.dsc;
+    DyldSharedCacheImage *dscImage = NULL;
+    if (dsc && image.isImageInSharedCache)
+        dscImage = dsc_lookup_image_by_vmaddr(dsc, imageAddress);
+
+    // An indexed shared cache already holds the image's defined external
+    // symbols and its local symbols, sorted by address.
+    uint64_t indexedCount = 0;
+    const struct dsc_index_symbol *indexedSymbols = dscImage ? dsc_index_image_symbols(dsc->index, dscImage, &indexedCount) : NULL;
+    for (uint64_t i = 0; i < indexedCount; i++) {
+        const char *name = dsc_index_symbol_name(dsc, &indexedSymbols[i]);
+        MKSymbolicationSource source = (indexedSymbols[i].flags & DSC_INDEX_SYMBOL_LOCAL) ? MKSymbolicationSourceSharedCacheLocalSymbols : MKSymbolicationSourceSymbolTable;
+        addEntry(indexedSymbols[i].address, name ? @(name) : nil, source);
+    }
+
+    // Otherwise read the symbol table's entries directly, without
+    // instantiating a node per symbol.
+    __block BOOL hasExternalSymbols = (indexedSymbols != NULL);
+    if (indexedSymbols == NULL) {
+        _MKSymbolTableReader *reader = [[_MKSymbolTableReader alloc] initWithImage:image error:NULL];
+        [reader enumerateSymbolsWithError:NULL usingBlock:^(__unused uint32_t index, const struct nlist_64 *symbol, const char *name, __unused BOOL *stop) {
+            if ((symbol->n_type & N_STAB) || (symbol->n_type & N_TYPE) != N_SECT)
+                return;
+            if (symbol->n_type & N_EXT)
+                hasExternalSymbols = YES;
+            addEntry(symbol->n_value, name ? @(name) : nil, MKSymbolicationSourceSymbolTable);
+        }];
+    }
+
+    // The export trie names the same addresses as the external symbols, so
+    // it is only parsed for images whose symbol table was stripped of them.
+    if (!hasExternalSymbols) {
+        for (MKExport *export in image.exportsInfo.value.exports) {
+            if (![export isKindOfClass:MKRegularExport.class])
+                continue;
+            addEntry(imageAddress + [(MKRegularExport*)export address], export.name, MKSymbolicationSourceExports);
+        }
+    }
+
+    for (MKFunction *function in image.functionStarts.value.functions)
+        addEntry(function.address, nil, MKSymbolicationSourceFunctionStarts);
+
+    // Images in the shared cache have their local symbols stripped into the
+    // cache's .symbols file.
+    if (dscImage && indexedSymbols == NULL) {
+        dsc_image_enumerate_symbols(dsc, dscImage, ^(const char *name, uint8_t type, uint64_t vmaddr, bool *stop) {
+#pragma unused(stop)
+            if (name == NULL || (type & N_STAB) || (type & N_TYPE) != N_SECT)
+                return;
+            addEntry(vmaddr, @(name), MKSymbolicationSourceSharedCacheLocalSymbols);
+        });
+    }
+
+    NSUInteger count = entries.length / sizeof(struct _MKSymbolicationEntry);
+    struct _MKSymbolicationEntry *sorted = malloc(MAX(entries.length, (NSUInteger)1));
+    if (sorted == NULL) return nil;
+    memcpy(sorted, entries.bytes, entries.length);
+    qsort(sorted, count, sizeof(struct _MKSymbolicationEntry), _MKSymbolicationEntryCompare);
+
+    // Keep one entry per address; the comparator placed the preferred one
+    // first.
+    NSUInteger unique = 0;
+    for (NSUInteger i = 0; i < count; i++) {
+        if (unique > 0 && sorted[unique - 1].address == sorted[i].address)
+            continue;
+        sorted[unique++] = sorted[i];
+    }
+
+    _entries = sorted;
+    _count = unique;
+    _names = names;
+
+    return self;
+}
+
+//|++++++++++++++++++++++++++++++++++++|//
+- (void)dealloc
+{
+    free(_entries);
+}
+
+//|++++++++++++++++++++++++++++++++++++|//
+//! Returns the index of the last entry at or below \a address, or NSNotFound.
+- (NSUInteger)indexOfEntryForAddress:(mk_vm_address_t)address
+{
+    NSUInteger low = 0, high = _count;
+    while (low < high) {
+        NSUInteger mid = low + (high - low) / 2;
+        if (_entries[mid].address <= address)
+            low = mid + 1;
+        else
+            high = mid;
+    }
+    return low > 0 ? low - 1 : NSNotFound;
+}
+
+@end
+
+
+
+//----------------------------------------------------------------------------//
+struct _MKSymbolicationImageRange {
+    mk_vm_address_t start;
+    mk_vm_address_t end;
+    NSUInteger imageIndex;
+};
+
+//----------------------------------------------------------------------------//
+@implementation MKSymbolicator {
+    NSArray<MKMachOImage*> *_images;
+    MKSharedCache *_sharedCache;
+    struct _MKSymbolicationImageRange *_ranges;
+    NSUInteger _rangeCount;
+    // Keyed by the position of the image in _images, or by the count of
+    // _images plus the index of the image in the shared cache.
+    NSMutableDictionary<NSNumber*, _MKSymbolicationTable*> *_tables;
+    _MKSymbolicationTable *_head;
+    _MKSymbolicationTable *_tail;
+}
+
+@synthesize cacheLimit = _cacheLimit;
+
+//|++++++++++++++++++++++++++++++++++++|//
+static int _MKSymbolicationRangeCompare(const void *a, const void *b)
+{
+    const struct _MKSymbolicationImageRange *rangeA = a;
+    const struct _MKSymbolicationImageRange *rangeB = b;
+    if (rangeA->start == rangeB->start) return 0;
+    return (rangeA->start < rangeB->start) ? -1 : 1;
+}
+
+//|++++++++++++++++++++++++++++++++++++|//
+- (instancetype)initWithImages:(NSArray<MKMachOImage*> *)images sharedCache:(MKSharedCache*)sharedCache
+{
+    self = [super init];
+    if (self == nil) return nil;
+
+    _images = [images copy];
+    _sharedCache = sharedCache;
+    _cacheLimit = 64;
+    _tables = [[NSMutableDictionary alloc] init];
+
+    _ranges = calloc(MAX(_images.count, (NSUInteger)1), sizeof(struct _MKSymbolicationImageRange));
+    if (_ranges == NULL) return nil;
+
+    [_images enumerateObjectsUsingBlock:^(MKMachOImage *image, NSUInteger idx, __unused BOOL *stop) {
+        mk_vm_address_t start = MK_VM_ADDRESS_MAX, end = 0;
+        for (MKResult<MKSegment*> *result in image.segments) {
+            MKSegment *segment = result.value;
+            // __PAGEZERO does not map anything.
+            if (segment == nil || (segment.fileSize == 0 && segment.initialProtection == VM_PROT_NONE))
+                continue;
+            start = MIN(start, segment.vmAddress);
+            end = MAX(end, segment.vmAddress + segment.vmSize);
+        }
+        if (start < end)
+            self->_ranges[self->_rangeCount++] = (struct _MKSymbolicationImageRange){ start, end, idx };
+    }];
+    qsort(_ranges, _rangeCount, sizeof(struct _MKSymbolicationImageRange), _MKSymbolicationRangeCompare);
+
+    return self;
+}
+
+//|++++++++++++++++++++++++++++++++++++|//
+- (instancetype)init
+{ @throw [NSException exceptionWithName:NSInternalInconsistencyException reason:@"Unavailable" userInfo:nil]; }
+
+//|++++++++++++++++++++++++++++++++++++|//
+- (void)dealloc
+{
+    free(_ranges);
+}
+
+//◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦//
+#pragma mark -  Table Cache
+//◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦//
+
+//|++++++++++++++++++++++++++++++++++++|//
+- (void)_unlinkTable:(_MKSymbolicationTable*)table
+{
+    if (table->_previous) table->_previous->_next = table->_next;
+    else _head = table->_next;
+    if (table->_next) table->_next->_previous = table->_previous;
+    else _tail = table->_previous;
+    table->_previous = table->_next = nil;
+}
+
+//|++++++++++++++++++++++++++++++++++++|//
+- (void)_linkTableAtHead:(_MKSymbolicationTable*)table
+{
+    table->_next = _head;
+    if (_head) _head->_previous = table;
+    _head = table;
+    if (_tail == nil) _tail = table;
+}
+
+//|++++++++++++++++++++++++++++++++++++|//
+- (_MKSymbolicationTable*)_tableForImage:(MKMachOImage*)image identity:(NSUInteger)identity
+{
+    NSNumber *key = @(identity);
+    _MKSymbolicationTable *table = _tables[key];
+    if (table) {
+        if (table != _head) {
+            [self _unlinkTable:table];
+            [self _linkTableAtHead:table];
+        }
+        return table;
+    }
+
+    table = [[_MKSymbolicationTable alloc] initWithImage:image sharedCache:_sharedCache];
+    if (table == nil)
+        return nil;
+
+    table->_key = key;
+    _tables[key] = table;
+    [self _linkTableAtHead:table];
+
+    while (_tables.count > MAX(_cacheLimit, (NSUInteger)1)) {
+        _MKSymbolicationTable *evicted = _tail;
+        [self _unlinkTable:evicted];
+        [_tables removeObjectForKey:evicted->_key];
+    }
+
+    return table;
+}
+
+//|++++++++++++++++++++++++++++++++++++|//
+- (void)purgeCache
+{
+    @synchronized(self) {
+        _head = _tail = nil;
+        [_tables removeAllObjects];
+    }
+}
+
+//◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦//
+#pragma mark -  Symbolicating
+//◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦//
+
+//|++++++++++++++++++++++++++++++++++++|//
+- (MKMachOImage*)_sharedCacheImageForAddress:(mk_vm_address_t)address start:(mk_vm_address_t*)start end:(mk_vm_address_t*)end identity:(NSUInteger*)identity
+{
+    DyldSharedCache *dsc = _sharedCache.dsc;
+    if (dsc == NULL)
+        return nil;
+
+    DyldSharedCacheImage *dscImage = dsc_lookup_image_by_address(dsc, address);
+    if (dscImage == NULL || dscImage->index >= _sharedCache.images.count)
+        return nil;
+
+    *start = dscImage->address;
+    *end = dscImage->endAddr;
+    *identity = _images.count + (NSUInteger)dscImage->index;
+    return _sharedCache.images[(NSUInteger)dscImage->index].macho;
+}
+
+//|++++++++++++++++++++++++++++++++++++|//
+- (void)symbolicateAddresses:(const mk_vm_address_t *)addresses count:(NSUInteger)count handler:(void (^)(NSUInteger index, MKSymbolication *result))handler
+{
+    if (count == 0)
+        return;
+
+    NSUInteger *order = malloc(count * sizeof(NSUInteger));
+    if (order == NULL)
+        return;
+    for (NSUInteger i = 0; i < count; i++)
+        order[i] = i;
+
+    // Sort a permutation so results can be reported in input order.
+    qsort_b(order, count, sizeof(NSUInteger), ^int(const void *a, const void *b) {
+        mk_vm_address_t addressA = addresses[*(const NSUInteger*)a];
+        mk_vm_address_t addressB = addresses[*(const NSUInteger*)b];
+        return (addressA > addressB) - (addressA < addressB);
+    });
+
+    NSMutableArray<MKSymbolication*> *results = [[NSMutableArray alloc] initWithCapacity:count];
+    for (NSUInteger i = 0; i < count; i++)
+        [results addObject:(id)[NSNull null]];
+
+    @synchronized(self) {
+        NSUInteger rangeIndex = 0;
+        MKMachOImage *currentImage = nil;
+        NSUInteger currentIdentity = NSNotFound;
+        mk_vm_address_t currentStart = 0, currentEnd = 0;
+        _MKSymbolicationTable *currentTable = nil;
+        NSUInteger cursor = NSNotFound;
+
+        for (NSUInteger i = 0; i < count; i++) {
+            mk_vm_address_t address = addresses[order[i]];
+            MKSymbolication *result = [[MKSymbolication alloc] initWithAddress:address];
+            results[order[i]] = result;
+
+            // Find the containing image.  Both lists are sorted, so the
+            // explicit image ranges are walked in step with the addresses.
+            if (currentImage == nil || address < currentStart || address >= currentEnd) {
+                while (rangeIndex < _rangeCount && _ranges[rangeIndex].end <= address)
+                    rangeIndex++;
+
+                MKMachOImage *image = nil;
+                NSUInteger identity = NSNotFound;
+                if (rangeIndex < _rangeCount && _ranges[rangeIndex].start <= address) {
+                    identity = _ranges[rangeIndex].imageIndex;
+                    image = _images[identity];
+                    currentStart = _ranges[rangeIndex].start;
+                    currentEnd = _ranges[rangeIndex].end;
+                } else {
+                    image = [self _sharedCacheImageForAddress:address start:&currentStart end:&currentEnd identity:&identity];
+                }
+
+                if (image == nil)
+                    identity = NSNotFound;
+                if (identity != currentIdentity) {
+                    currentImage = image;
+                    currentIdentity = identity;
+                    currentTable = image ? [self _tableForImage:image identity:identity] : nil;
+                    cursor = NSNotFound;
+                }
+            }
+
+            if (currentImage == nil)
+                continue;
+            result->_image = currentImage;
+            if (currentTable == nil || currentTable->_count == 0)
+                continue;
+
+            // Advance through the image's table in step with the addresses.
+            if (cursor == NSNotFound) {
+                cursor = [currentTable indexOfEntryForAddress:address];
+                if (cursor == NSNotFound)
+                    continue;
+            }
+            while (cursor + 1 < currentTable->_count && currentTable->_entries[cursor + 1].address <= address)
+                cursor++;
+
+            struct _MKSymbolicationEntry *entry = &currentTable->_entries[cursor];
+            if (entry->address > address)
+                continue;
+
+            result->_symbolAddress = entry->address;
+            result->_source = entry->source;
+            if (entry->nameIndex != MK_SYMBOLICATION_NO_NAME)
+                result->_symbolName = currentTable->_names[entry->nameIndex];
+        }
+    }
+
+    free(order);
+
+    for (NSUInteger i = 0; i < count; i++)
+        handler(i, results[i]);
+}
+
+//|++++++++++++++++++++++++++++++++++++|//
+- (NSArray<MKSymbolication*> *)symbolicateAddresses:(NSArray<NSNumber*> *)addresses
+{
+    NSUInteger count = addresses.count;
+    mk_vm_address_t *values = malloc(MAX(count, (NSUInteger)1) * sizeof(mk_vm_address_t));
+    if (values == NULL)
+        return @[];
+
+    for (NSUInteger i = 0; i < count; i++)
+        values[i] = addresses[i].unsignedLongLongValue;
+
+    NSMutableArray<MKSymbolication*> *results = [[NSMutableArray alloc] initWithCapacity:count];
+    [self symbolicateAddresses:values count:count handler:^(__unused NSUInteger index, MKSymbolication *result) {
+        [results addObject:result];
+    }];
+
+    free(values);
+    return results;
+}
+
+@end
@@ -0,0 +1,61 @@
+//----------------------------------------------------------------------------//
+//|
+//|             MachOKit - A Lightweight Mach-O Parsing Library
+//! @file       _MKSymbolTableReader.h
+//!
+//! @author     D.V.
+//! @copyright  Copyright (c) 2014-2015 D.V. All rights reserved.
+//|
+//| Permission is hereby granted, free of charge, to any person obtaining a
+//| copy of this software and associated documentation files (the "Software"),
+//| to deal in the Software without restriction, including without limitation
+//| the rights to use, copy, modify, merge, publish, distribute, sublicense,
+//| and/or sell copies of the Software, and to permit persons to whom the
+//| Software is furnished to do so, subject to the following conditions:
+//|
+//| The above copyright notice and this permission notice shall be included
+//| in all copies or substantial portions of the Software.
+//|
+//| THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+//| OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+//| MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+//| IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+//| CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+//| TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+//| SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+//----------------------------------------------------------------------------//
+
+#include <MachOKit/macho.h>
+#import <Foundation/Foundation.h>
+
+#include <mach-o/nlist.h>
+
+@class MKMachOImage;
+
+NS_ASSUME_NONNULL_BEGIN
+
+//----------------------------------------------------------------------------//
+//! Reads the entries of an image's symbol table, and their names, directly
+//! from the image's memory map without instantiating \ref MKSymbol nodes.
+//! Each table is mapped once per enumeration.
+//
+@interface _MKSymbolTableReader : NSObject
+
+//! Returns \c nil if \a image has no \c LC_SYMTAB, or if the symbol or string
+//! table lies outside the image.
+- (nullable instancetype)initWithImage:(MKMachOImage*)image error:(NSError**)error;
+
+- (instancetype)init NS_UNAVAILABLE;
+
+//! The number of entries in the symbol table.
+@property (nonatomic, readonly) uint32_t symbolCount;
+
+//! Invokes \a block for each entry in the symbol table, in order.  Entries
+//! are byte swapped and widened to \c nlist_64.  \a name is \c NULL if the
+//! entry's string index does not name a terminated string within the string
+//! table.  Neither pointer remains valid after \a block returns.
+- (BOOL)enumerateSymbolsWithError:(NSError**)error usingBlock:(void (^)(uint32_t index, const struct nlist_64 *symbol, const char * _Nullable name, BOOL *stop))block;
+
+@end
+
+NS_ASSUME_NONNULL_END
@@ -0,0 +1,152 @@
+//----------------------------------------------------------------------------//
+//|
+//|             MachOKit - A Lightweight Mach-O Parsing Library
+//|             _MKSymbolTableReader.m
+//|
+//|             D.V.
+//|             Copyright (c) 2014-2015 D.V. All rights reserved.
+//|
+//| Permission is hereby granted, free of charge, to any person obtaining a
+//| copy of this software and associated documentation files (the "Software"),
+//| to deal in the Software without restriction, including without limitation
+//| the rights to use, copy, modify, merge, publish, distribute, sublicense,
+//| and/or sell copies of the Software, and to permit persons to whom the
+//| Software is furnished to do so, subject to the following conditions:
+//|
+//| The above copyright notice and this permission notice shall be included
+//| in all copies or substantial portions of the Software.
+//|
+//| THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+//| OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+//| MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+//| IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+//| CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+//| TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+//| SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+//----------------------------------------------------------------------------//
+
+#import "_MKSymbolTableReader.h"
+#import "MKInternal.h"
+#import "MKMachO.h"
+#import "MKLCSymtab.h"
+#import "MKLinkEditNode.h"
+
+//----------------------------------------------------------------------------//
+@implementation _MKSymbolTableReader {
+    MKDataModel *_dataModel;
+    size_t _nlistSize;
+    MKLinkEditNode *_symbols;
+    MKLinkEditNode *_strings;
+}
+
+@synthesize symbolCount = _symbolCount;
+
+//|++++++++++++++++++++++++++++++++++++|//
+- (instancetype)initWithImage:(MKMachOImage*)image error:(NSError**)error
+{
+    NSParameterAssert(image.dataModel != nil);
+    
+    self = [super init];
+    if (self == nil) return nil;
+    
+    MKLCSymtab *symtabLoadCommand = [image loadCommandsOfType:LC_SYMTAB].firstObject;
+    if (symtabLoadCommand == nil) {
+        MK_ERROR_OUT = [NSError mk_errorWithDomain:MKErrorDomain code:MK_ENOT_FOUND description:@"Image does not contain a LC_SYMTAB load command."];
+        return nil;
+    }
+    
+    _dataModel = image.dataModel;
+    _nlistSize = (_dataModel.pointerSize == 8) ? sizeof(struct nlist_64) : sizeof(struct nlist);
+    _symbolCount = symtabLoadCommand.nsyms;
+    
+    NSError *localError = nil;
+    
+    _symbols = [[MKLinkEditNode alloc] initWithSize:(mk_vm_size_t)_symbolCount * _nlistSize offset:symtabLoadCommand.symoff inImage:image error:&localError];
+    if (_symbols == nil) {
+        MK_ERROR_OUT = [NSError mk_errorWithDomain:MKErrorDomain code:MK_EINTERNAL_ERROR underlyingError:localError description:@"Could not locate the symbol table."];
+        return nil;
+    }
+    
+    _strings = [[MKLinkEditNode alloc] initWithSize:symtabLoadCommand.strsize offset:symtabLoadCommand.stroff inImage:image error:&localError];
+    if (_strings == nil) {
+        MK_ERROR_OUT = [NSError mk_errorWithDomain:MKErrorDomain code:MK_EINTERNAL_ERROR underlyingError:localError description:@"Could not locate the string table."];
+        return nil;
+    }
+    
+    return self;
+}
+
+//|++++++++++++++++++++++++++++++++++++|//
+- (instancetype)init
+{ @throw [NSException exceptionWithName:NSInternalInconsistencyException reason:@"Unavailable" userInfo:nil]; }
+
+//|++++++++++++++++++++++++++++++++++++|//
+- (BOOL)enumerateSymbolsWithError:(NSError**)error usingBlock:(void (^)(uint32_t index, const struct nlist_64 *symbol, const char *name, BOOL *stop))block
+{
+    if (_symbolCount == 0)
+        return YES;
+    
+    __block NSError *mapError = nil;
+    MKDataModel *dataModel = _dataModel;
+    size_t nlistSize = _nlistSize;
+    uint32_t symbolCount = _symbolCount;
+    MKLinkEditNode *strings = _strings;
+    
+    [_symbols.memoryMap remapBytesAtOffset:0 fromAddress:_symbols.nodeContextAddress length:_symbols.nodeSize requireFull:YES withHandler:^(vm_address_t symbolsAddress, vm_size_t __unused symbolsLength, NSError *symbolsError) {
+        if (symbolsError) { mapError = symbolsError; return; }
+        
+        // An empty string table leaves every name NULL.
+        void (^enumerate)(const char*, size_t) = ^(const char *stringTable, size_t stringTableSize) {
+            BOOL stop = NO;
+            for (uint32_t i = 0; i < symbolCount && !stop; i++)
+            {
+                const uint8_t *entry = (const uint8_t*)symbolsAddress + (size_t)i * nlistSize;
+                struct nlist_64 symbol;
+                
+                if (nlistSize == sizeof(struct nlist_64)) {
+                    struct nlist_64 raw;
+                    memcpy(&raw, entry, sizeof(raw));
+                    symbol.n_un.n_strx = MKSwapLValue32(raw.n_un.n_strx, dataModel);
+                    symbol.n_type = raw.n_type;
+                    symbol.n_sect = raw.n_sect;
+                    symbol.n_desc = MKSwapLValue16(raw.n_desc, dataModel);
+                    symbol.n_value = MKSwapLValue64(raw.n_value, dataModel);
+                } else {
+                    struct nlist raw;
+                    memcpy(&raw, entry, sizeof(raw));
+                    symbol.n_un.n_strx = MKSwapLValue32(raw.n_un.n_strx, dataModel);
+                    symbol.n_type = raw.n_type;
+                    symbol.n_sect = raw.n_sect;
+                    symbol.n_desc = (uint16_t)MKSwapLValue16s(raw.n_desc, dataModel);
+                    symbol.n_value = (uint64_t)MKSwapLValue32(raw.n_value, dataModel);
+                }
+                
+                const char *name = NULL;
+                uint32_t strx = symbol.n_un.n_strx;
+                if (strx < stringTableSize && memchr(stringTable + strx, '\0', stringTableSize - strx) != NULL)
+                    name = stringTable + strx;
+                
+                block(i, &symbol, name, &stop);
+            }
+        };
+        
+        if (strings.nodeSize == 0) {
+            enumerate(NULL, 0);
+            return;
+        }
+        
+        [strings.memoryMap remapBytesAtOffset:0 fromAddress:strings.nodeContextAddress length:strings.nodeSize requireFull:YES withHandler:^(vm_address_t stringsAddress, vm_size_t __unused stringsLength, NSError *stringsError) {
+            if (stringsError) { mapError = stringsError; return; }
+            enumerate((const char*)stringsAddress, (size_t)strings.nodeSize);
+        }];
+    }];
+    
+    if (mapError) {
+        MK_ERROR_OUT = [NSError mk_errorWithDomain:MKErrorDomain code:MK_EINTERNAL_ERROR underlyingError:mapError description:@"Could not map the symbol table."];
+        return NO;
+    }
+    
+    return YES;
+}
+
+@end
@@ -0,0 +1,169 @@
+//----------------------------------------------------------------------------//
+//|
+//|             MachOKit - A Lightweight Mach-O Parsing Library
+//|             MKBenchmarkSpec.m
+//|
+//|             D.V.
+//|             Copyright (c) 2014-2015 D.V. All rights reserved.
+//|
+//| Permission is hereby granted, free of charge, to any person obtaining a
+//| copy of this software and associated documentation files (the "Software"),
+//| to deal in the Software without restriction, including without limitation
+//| the rights to use, copy, modify, merge, publish, distribute, sublicense,
+//| and/or sell copies of the Software, and to permit persons to whom the
+//| Software is furnished to do so, subject to the following conditions:
+//|
+//| The above copyright notice and this permission notice shall be included
+//| in all copies or substantial portions of the Software.
+//|
+//| THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+//| OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+//| MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+//| IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+//| CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+//| TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+//| SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+//----------------------------------------------------------------------------//
+
+#include <mach/mach.h>
+#include <mach/mach_time.h>
+#include <sys/resource.h>
+
+//|++++++++++++++++++++++++++++++++++++|//
+static double
+BenchmarkMilliseconds(uint64_t start, uint64_t end)
+{
+    static mach_timebase_info_data_t timebase;
+    if (timebase.denom == 0)
+        mach_timebase_info(&timebase);
+    return (double)(end - start) * timebase.numer / timebase.denom / 1e6;
+}
+
+//|++++++++++++++++++++++++++++++++++++|//
+static uint64_t
+BenchmarkFootprint(void)
+{
+    task_vm_info_data_t info;
+    mach_msg_type_number_t count = TASK_VM_INFO_COUNT;
+    if (task_info(mach_task_self(), TASK_VM_INFO, (task_info_t)&info, &count) != KERN_SUCCESS)
+        return 0;
+    return info.phys_footprint;
+}
+
+//|++++++++++++++++++++++++++++++++++++|//
+static uint64_t
+BenchmarkPeakRSS(void)
+{
+    struct rusage usage;
+    getrusage(RUSAGE_SELF, &usage);
+    return (uint64_t)usage.ru_maxrss; // Bytes on Darwin.
+}
+
+SpecBegin(MKBenchmark)
+{
+    // The synthetic images are always checked at scale 1.  Set
+    // MK_BENCHMARK_MAX_SCALE to benchmark larger images; the scale doubles
+    // until it exceeds the maximum.
+    NSUInteger maxScale = 1;
+    const char *maxScaleEnv = getenv("MK_BENCHMARK_MAX_SCALE");
+    if (maxScaleEnv)
+        maxScale = MAX((NSUInteger)strtoul(maxScaleEnv, NULL, 10), (NSUInteger)1);
+    
+    SyntheticMachOFixture *fixture = [SyntheticMachOFixture fixtureWithName:@"MKBenchmark"];
+    
+    for (NSUInteger scale = 1; scale <= maxScale; scale *= 2)
+    describe([NSString stringWithFormat:@"Synthetic image at scale %lu", (unsigned long)scale], ^{
+        SyntheticMachOConfiguration *configuration = [SyntheticMachOConfiguration configurationWithScale:scale];
+        NSString *imageName = [NSString stringWithFormat:@"libSynthetic-%lu.dylib", (unsigned long)scale];
+        
+        it(@"should parse completely", ^{
+            NSError *error = nil;
+            expect([SyntheticMachO writeMachOWithConfiguration:configuration toURL:[fixture URLForFileWithName:imageName] error:&error]).to.beTruthy();
+            
+            uint64_t footprint = BenchmarkFootprint();
+            uint64_t start = mach_absolute_time();
+            
+            @autoreleasepool {
+                MKMachOImage *macho = [fixture imageWithName:imageName error:&error];
+                expect(macho).toNot.beNil();
+                
+                // Touch every lazily parsed subtree.
+                (void)macho.loadCommands;
+                (void)macho.symbolTable.value.symbols;
+                (void)macho.exportsInfo.value.exports;
+                (void)macho.rebaseInfo.value.fixups;
+                (void)macho.bindingsInfo.value.actions;
+                (void)macho.functionStarts.value.functions;
+                (void)macho.objcMetadata.value.classCount;
+                
+                uint64_t end = mach_absolute_time();
+                uint64_t growth = BenchmarkFootprint();
+                growth = growth > footprint ? growth - footprint : 0;
+                
+                mk_context_statistics_t statistics = [macho.memoryMap statisticsSnapshot];
+                NSLog(@"[MKBenchmark] %@: %.2f ms, +%llu bytes footprint, %llu bytes peak RSS, %llu remaps, %llu bytes copied",
+                      configuration, BenchmarkMilliseconds(start, end), growth, BenchmarkPeakRSS(),
+                      statistics.remap, statistics.bytes_copied);
+            }
+        });
+        
+        it(@"should rehydrate cached parse results", ^{
+            NSError *error = nil;
+            expect([fixture imageWithConfiguration:configuration name:imageName error:&error]).toNot.beNil();
+            
+            NSURL *cacheURL = [fixture URLForFileWithName:[NSString stringWithFormat:@"ParseResults-%lu", (unsigned long)scale]];
+            MKParseResultCache *cache = [[MKParseResultCache alloc] initWithDirectoryURL:cacheURL options:MKParseResultCacheOptionNone];
+            
+            for (NSUInteger pass = 0; pass < 2; pass++) {
+                MKMachOImage *macho = [fixture imageWithName:imageName error:&error];
+                expect(macho).toNot.beNil();
+                
+                uint64_t start = mach_absolute_time();
+                MKParseResults *results = [cache resultsForImage:macho subsystems:MKParseResultSubsystemAll error:&error];
+                uint64_t end = mach_absolute_time();
+                expect(results).toNot.beNil();
+                
+                NSLog(@"[MKBenchmark] %@: %s parse results in %.2f ms", configuration, pass ? "rehydrated" : "parsed", BenchmarkMilliseconds(start, end));
+            }
+        });
+        
+        it(@"should serialize", ^{
+            NSError *error = nil;
+            MKMachOImage *macho = [fixture imageWithConfiguration:configuration name:imageName error:&error];
+            expect(macho).toNot.beNil();
+            
+            NSMutableData *json = [NSMutableData data];
+            uint64_t start = mach_absolute_time();
+            MKNodeSerializer *serializer = [[MKNodeSerializer alloc] initWithMutableData:json format:MKNodeSerializationFormatJSON options:MKNodeSerializationOptionWarnings];
+            expect([serializer serializeNode:macho error:&error]).to.beTruthy();
+            uint64_t end = mach_absolute_time();
+            
+            NSLog(@"[MKBenchmark] %@: serialized %lu bytes of JSON in %.2f ms",
+                  configuration, (unsigned long)json.length, BenchmarkMilliseconds(start, end));
+        });
+    });
+    
+    describe(@"Synthetic shared cache", ^{
+        it(@"should list every image", ^{
+            SyntheticMachOConfiguration *configuration = [SyntheticMachOConfiguration configurationWithScale:1];
+            NSUInteger imageCount = 16 * maxScale;
+            NSURL *cacheURL = [fixture URLForFileWithName:@"dyld_shared_cache_arm64"];
+            
+            NSError *error = nil;
+            expect([SyntheticMachO writeSharedCacheWithConfiguration:configuration imageCount:imageCount subCacheCount:4 toURL:cacheURL error:&error]).to.beTruthy();
+            expect(error).to.beNil();
+            
+            uint64_t start = mach_absolute_time();
+            
+            @autoreleasepool {
+                MKSharedCache *sharedCache = [[MKSharedCache alloc] initWithFlags:0 url:cacheURL];
+                expect(sharedCache).toNot.beNil();
+                expect(sharedCache.images.count).to.equal(imageCount);
+                
+                NSLog(@"[MKBenchmark] Shared cache with %lu images: %.2f ms, %llu bytes peak RSS",
+                      (unsigned long)imageCount, BenchmarkMilliseconds(start, mach_absolute_time()), BenchmarkPeakRSS());
+            }
+        });
+    });
+}
+SpecEnd
@@ -0,0 +1,118 @@
+//----------------------------------------------------------------------------//
+//|
+//|             MachOKit - A Lightweight Mach-O Parsing Library
+//|             MKBindTableSpec.m
+//|
+//|             D.V.
+//|             Copyright (c) 2014-2015 D.V. All rights reserved.
+//|
+//| Permission is hereby granted, free of charge, to any person obtaining a
+//| copy of this software and associated documentation files (the "Software"),
+//| to deal in the Software without restriction, including without limitation
+//| the rights to use, copy, modify, merge, publish, distribute, sublicense,
+//| and/or sell copies of the Software, and to permit persons to whom the
+//| Software is furnished to do so, subject to the following conditions:
+//|
+//| The above copyright notice and this permission notice shall be included
+//| in all copies or substantial portions of the Software.
+//|
+//| THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+//| OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+//| MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+//| IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+//| CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+//| TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+//| SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+//----------------------------------------------------------------------------//
+
+SpecBegin(MKBindTable)
+
+describe(@"a synthetic image", ^{
+    SyntheticMachOFixture *fixture = [SyntheticMachOFixture fixtureWithName:@"MKBindTable"];
+    
+    __block SyntheticMachOConfiguration *configuration;
+    __block MKMachOImage *macho;
+    __block MKSegment *dataSegment;
+    
+    beforeAll(^{
+        configuration = [SyntheticMachOConfiguration configurationWithScale:1];
+        configuration.weakBindCount = 32;
+        configuration.lazyBindCount = 48;
+        macho = [fixture imageWithConfiguration:configuration name:@"libBinds.dylib" error:NULL];
+        expect(macho).toNot.beNil();
+        dataSegment = [macho segmentsWithName:@SEG_DATA].firstObject.value;
+        expect(dataSegment).toNot.beNil();
+    });
+    
+    it(@"should collect the weak binds", ^{
+        NSError *error = nil;
+        MKBindTable *table = [[MKBindTable alloc] initWithImage:macho kind:MKBindTableKindWeakBind error:&error];
+        expect(table).toNot.beNil();
+        expect(table.locationCount).to.equal(configuration.weakBindCount);
+        expect(table.symbolCount).to.equal(configuration.weakBindCount);
+        expect(table.warnings).to.equal(@[]);
+        
+        for (NSUInteger i = 0; i < table.locationCount; i++) {
+            const MKBindTableLocation *location = &table.locations[i];
+            expect(location->type).to.equal(BIND_TYPE_POINTER);
+            expect(location->segmentIndex).to.equal(1);
+            expect(@(table.symbols[location->symbolIndex].name)).to.equal([NSString stringWithFormat:@"_weak%08lu", (unsigned long)i]);
+        }
+    });
+    
+    it(@"should collect every lazy bind, across the DONE opcodes", ^{
+        NSError *error = nil;
+        MKBindTable *table = [[MKBindTable alloc] initWithImage:macho kind:MKBindTableKindLazyBind error:&error];
+        expect(table).toNot.beNil();
+        expect(table.locationCount).to.equal(configuration.lazyBindCount);
+        expect(table.warnings).to.equal(@[]);
+        
+        __block NSUInteger count = 0;
+        BOOL success = [table enumerateBindsWithError:&error usingBlock:^(const MKBindTableEntry *entry, BOOL __unused *stop) {
+            expect(entry->libraryOrdinal).to.equal(1);
+            expect(entry->address).to.equal(dataSegment.vmAddress + 8 * count);
+            expect(@(entry->symbolName)).to.equal([NSString stringWithFormat:@"_ext%08lu", (unsigned long)count]);
+            count++;
+        }];
+        expect(success).to.beTruthy();
+        expect(error).to.beNil();
+        expect(count).to.equal(configuration.lazyBindCount);
+    });
+    
+    it(@"should follow threaded bind chains", ^{
+        SyntheticMachOConfiguration *threadedConfiguration = [configuration copy];
+        threadedConfiguration.threadedBinds = YES;
+        MKMachOImage *threaded = [fixture imageWithConfiguration:threadedConfiguration name:@"libThreadedBinds.dylib" error:NULL];
+        expect(threaded).toNot.beNil();
+        
+        NSError *error = nil;
+        MKBindTable *table = [[MKBindTable alloc] initWithImage:threaded kind:MKBindTableKindBind error:&error];
+        expect(table).toNot.beNil();
+        expect(table.warnings).to.equal(@[]);
+        expect(table.locationCount).to.equal(threadedConfiguration.bindCount);
+        expect(table.symbolCount).to.equal(threadedConfiguration.bindCount);
+        
+        for (NSUInteger i = 0; i < table.locationCount; i++) {
+            const MKBindTableLocation *location = &table.locations[i];
+            expect(location->type).to.equal(BIND_TYPE_THREADED_BIND);
+            expect(location->segmentOffset).to.equal(8 * i);
+            expect(@(table.symbols[location->symbolIndex].name)).to.equal([NSString stringWithFormat:@"_ext%08lu", (unsigned long)i]);
+        }
+    });
+    
+    it(@"should build the table once when accessed concurrently", ^{
+        MKBindTable *table = [[MKBindTable alloc] initWithImage:macho kind:MKBindTableKindBind error:NULL];
+        const MKBindTableLocation **locations = calloc(16, sizeof(*locations));
+        
+        dispatch_apply(16, dispatch_get_global_queue(QOS_CLASS_USER_INITIATED, 0), ^(size_t i) {
+            locations[i] = table.locations;
+        });
+        
+        for (size_t i = 0; i < 16; i++)
+            expect(locations[i] == table.locations).to.beTruthy();
+        expect(table.locationCount).to.equal(configuration.bindCount);
+        free(locations);
+    });
+});
+
+SpecEnd
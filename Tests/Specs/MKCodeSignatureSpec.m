@@ -0,0 +1,155 @@
+//----------------------------------------------------------------------------//
+//|
+//|             MachOKit - A Lightweight Mach-O Parsing Library
+//|             MKCodeSignatureSpec.m
+//|
+//|             D.V.
+//|             Copyright (c) 2014-2015 D.V. All rights reserved.
+//|
+//| Permission is hereby granted, free of charge, to any person obtaining a
+//| copy of this software and associated documentation files (the "Software"),
+//| to deal in the Software without restriction, including without limitation
+//| the rights to use, copy, modify, merge, publish, distribute, sublicense,
+//| and/or sell copies of the Software, and to permit persons to whom the
+//| Software is furnished to do so, subject to the following conditions:
+//|
+//| The above copyright notice and this permission notice shall be included
+//| in all copies or substantial portions of the Software.
+//|
+//| THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+//| OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+//| MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+//| IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+//| CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+//| TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+//| SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+//----------------------------------------------------------------------------//
+
+#include <MachOKit/_MKCodeSignature.h>
+
+SpecBegin(MKCodeSignature)
+
+describe(@"the page hash digests", ^{
+    // Known answers from FIPS 180-4 and its examples.
+    NSString* (^hex)(const uint8_t*, size_t) = ^NSString* (const uint8_t *digest, size_t length) {
+        NSMutableString *string = [NSMutableString stringWithCapacity:length * 2];
+        for (size_t i = 0; i < length; i++)
+            [string appendFormat:@"%02x", digest[i]];
+        return string;
+    };
+    
+    NSMutableData *millionAs = [NSMutableData dataWithLength:1000000];
+    memset(millionAs.mutableBytes, 'a', millionAs.length);
+    
+    NSArray<NSData*> *messages = @[
+        [NSData data],
+        [@"abc" dataUsingEncoding:NSASCIIStringEncoding],
+        [@"abcdbcdecdefdefgefghfghighijhijkijkljklmklmnlmnomnopnopq" dataUsingEncoding:NSASCIIStringEncoding],
+        // A whole block, so the padding needs a block of its own.
+        [[@"" stringByPaddingToLength:64 withString:@"a" startingAtIndex:0] dataUsingEncoding:NSASCIIStringEncoding],
+        millionAs
+    ];
+    
+    it(@"should compute SHA-1", ^{
+        NSArray<NSString*> *expected = @[
+            @"da39a3ee5e6b4b0d3255bfef95601890afd80709",
+            @"a9993e364706816aba3e25717850c26c9cd0d89d",
+            @"84983e441c3bd26ebaae4aa1f95129e5e54670f1",
+            @"0098ba824b5c16427bd7a1122a5a442a25ec644d",
+            @"34aa973cd4c4daa4f61eeb2bdbad27316534016f"
+        ];
+        
+        for (NSUInteger i = 0; i < messages.count; i++) {
+            uint8_t digest[MK_CS_SHA1_DIGEST_LENGTH];
+            MKCodeSignatureSHA1(messages[i].bytes, messages[i].length, digest);
+            expect(hex(digest, sizeof(digest))).to.equal(expected[i]);
+        }
+    });
+    
+    it(@"should compute SHA-256", ^{
+        NSArray<NSString*> *expected = @[
+            @"e3b0c44298fc1c149afbf4c8996fb92427ae41e4649b934ca495991b7852b855",
+            @"ba7816bf8f01cfea414140de5dae2223b00361a396177a9cb410ff61f20015ad",
+            @"248d6a61d20638b8e5c026930c3e6039a33ce45964ff2167f6ecedd419db06c1",
+            @"ffe054fe7ae0cb6dc65c3af9b61d5209f439851db43d0ba5997337df154668eb",
+            @"cdc76e5c9914fb9281a1c7e284d73e67f1809a48a497200e046d39ccc7112cd0"
+        ];
+        
+        for (NSUInteger i = 0; i < messages.count; i++) {
+            uint8_t digest[MK_CS_SHA256_DIGEST_LENGTH];
+            MKCodeSignatureSHA256(messages[i].bytes, messages[i].length, digest);
+            expect(hex(digest, sizeof(digest))).to.equal(expected[i]);
+        }
+    });
+});
+
+
+describe(@"a signed image with a modified page", ^{
+    NSURL *sourceURL = [NSURL fileURLWithPath:@"/bin/ls"];
+    SyntheticMachOFixture *fixture = [SyntheticMachOFixture fixtureWithName:@"MKCodeSignature"];
+    NSURL *imageURL = [fixture URLForFileWithName:sourceURL.lastPathComponent];
+    
+    // Returns the first signed image in the file at url, and the offset of
+    // its slice.
+    MKMachOImage* (^loadImage)(NSURL*, uint64_t*) = ^MKMachOImage* (NSURL *url, uint64_t *sliceOffset) {
+        NSError *error = nil;
+        MKMemoryMap *map = [MKMemoryMap memoryMapWithContentsOfFile:url error:&error];
+        expect(map).toNot.beNil();
+        
+        NSMutableArray<NSNumber*> *offsets = [NSMutableArray arrayWithObject:@(0)];
+        MKFatBinary *fat = [[MKFatBinary alloc] initWithMemoryMap:map error:NULL];
+        if (fat) {
+            [offsets removeAllObjects];
+            for (MKFatArch *architecture in fat.architectures)
+                [offsets addObject:@(architecture.offset)];
+        }
+        
+        for (NSNumber *offset in offsets) {
+            MKMachOImage *macho = [[MKMachOImage alloc] initWithName:url.lastPathComponent.UTF8String flags:0 atAddress:offset.unsignedLongLongValue inMapping:map error:NULL];
+            if (macho.codeSignature.value.codeDirectory) {
+                *sliceOffset = offset.unsignedLongLongValue;
+                return macho;
+            }
+        }
+        
+        return nil;
+    };
+    
+    __block uint32_t nCodeSlots = 0;
+    
+    beforeAll(^{
+        uint64_t sliceOffset = 0;
+        MKMachOImage *original = loadImage(sourceURL, &sliceOffset);
+        expect(original).toNot.beNil();
+        
+        MKCodeDirectory *codeDirectory = original.codeSignature.value.codeDirectory;
+        uint64_t bytesPerPage = codeDirectory.bytesPerPage;
+        nCodeSlots = codeDirectory.nCodeSlots;
+        expect(nCodeSlots).to.beGreaterThan(2);
+        
+        // Flip one byte in the second page, well clear of the header and
+        // the signature itself.
+        NSMutableData *contents = [NSMutableData dataWithContentsOfURL:sourceURL];
+        ((uint8_t*)contents.mutableBytes)[sliceOffset + bytesPerPage + 16] ^= 0xFF;
+        expect([contents writeToURL:imageURL atomically:YES]).to.beTruthy();
+    });
+    
+    it(@"should report only the modified page", ^{
+        uint64_t sliceOffset = 0;
+        MKMachOImage *macho = loadImage(imageURL, &sliceOffset);
+        expect(macho).toNot.beNil();
+        MKCodeDirectory *codeDirectory = macho.codeSignature.value.codeDirectory;
+        
+        NSError *error = nil;
+        NSIndexSet *mismatched = [codeDirectory mismatchedPagesInRange:NSMakeRange(0, nCodeSlots) error:&error];
+        expect(error).to.beNil();
+        expect(mismatched).to.equal([NSIndexSet indexSetWithIndex:1]);
+        
+        // Ranges that exclude the page still verify.
+        expect([codeDirectory mismatchedPagesInRange:NSMakeRange(2, nCodeSlots - 2) error:&error].count).to.equal(0);
+        expect([macho.codeSignature.value verifyWithError:&error]).to.beFalsy();
+        expect(error).toNot.beNil();
+    });
+});
+
+SpecEnd
@@ -0,0 +1,146 @@
+//----------------------------------------------------------------------------//
+//|
+//|             MachOKit - A Lightweight Mach-O Parsing Library
+//|             MKDataInCodeSpec.m
+//|
+//|             D.V.
+//|             Copyright (c) 2014-2015 D.V. All rights reserved.
+//|
+//| Permission is hereby granted, free of charge, to any person obtaining a
+//| copy of this software and associated documentation files (the "Software"),
+//| to deal in the Software without restriction, including without limitation
+//| the rights to use, copy, modify, merge, publish, distribute, sublicense,
+//| and/or sell copies of the Software, and to permit persons to whom the
+//| Software is furnished to do so, subject to the following conditions:
+//|
+//| The above copyright notice and this permission notice shall be included
+//| in all copies or substantial portions of the Software.
+//|
+//| THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+//| OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+//| MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+//| IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+//| CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+//| TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+//| SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+//----------------------------------------------------------------------------//
+
+SpecBegin(MKDataInCode)
+
+describe(@"a synthetic image", ^{
+    SyntheticMachOFixture *fixture = [SyntheticMachOFixture fixtureWithName:@"MKDataInCode"];
+    
+    // Writes the image to disk after letting patch modify its data in code
+    // entries.
+    MKMachOImage* (^loadImage)(SyntheticMachOConfiguration*, NSString*, void (^)(struct data_in_code_entry*, uint32_t)) = ^MKMachOImage* (SyntheticMachOConfiguration *configuration, NSString *name, void (^patch)(struct data_in_code_entry*, uint32_t)) {
+        NSMutableData *contents = [[SyntheticMachO machOWithConfiguration:configuration baseAddress:0 fileOffset:0] mutableCopy];
+        
+        if (patch) {
+            const struct mach_header_64 *header = contents.mutableBytes;
+            uint8_t *lc = (uint8_t*)(header + 1);
+            for (uint32_t i = 0; i < header->ncmds; i++, lc += ((struct load_command*)lc)->cmdsize) {
+                if (((struct load_command*)lc)->cmd != LC_DATA_IN_CODE)
+                    continue;
+                
+                struct linkedit_data_command *command = (struct linkedit_data_command*)lc;
+                patch((struct data_in_code_entry*)((uint8_t*)contents.mutableBytes + command->dataoff), command->datasize / sizeof(struct data_in_code_entry));
+            }
+        }
+        
+        MKMachOImage *image = [fixture imageWithContents:contents name:name error:NULL];
+        expect(image).toNot.beNil();
+        return image;
+    };
+    
+    __block SyntheticMachOConfiguration *configuration;
+    
+    beforeAll(^{
+        configuration = [SyntheticMachOConfiguration configurationWithScale:1];
+        configuration.dataInCodeCount = 64;
+    });
+    
+    it(@"should decode and look up the ranges", ^{
+        MKMachOImage *macho = loadImage(configuration, @"libDataInCode.dylib", nil);
+        MKDataInCode *dataInCode = macho.dataInCode.value;
+        expect(dataInCode).toNot.beNil();
+        expect(dataInCode.warnings).to.equal(@[]);
+        expect(dataInCode.rangeCount).to.equal(configuration.dataInCodeCount);
+        
+        MKSection *text = [macho sectionWithName:@SECT_TEXT inSegmentWithName:@SEG_TEXT];
+        for (NSUInteger i = 0; i < dataInCode.rangeCount; i++) {
+            const MKDataInCodeRange *range = &dataInCode.ranges[i];
+            expect(range->offset).to.equal(text.fileOffset + 32 * i);
+            expect(range->length).to.equal(8);
+            expect(range->kind).to.equal(1 + i % 4);
+            
+            expect([dataInCode rangeContainingOffset:range->offset] == range).to.beTruthy();
+            expect([dataInCode rangeContainingOffset:range->offset + 7] == range).to.beTruthy();
+            expect([dataInCode rangeContainingOffset:range->offset + 8] == NULL).to.beTruthy();
+        }
+        
+        // Classify every instruction of __text, then the same addresses in
+        // descending order.
+        NSUInteger count = (NSUInteger)(text.size / 4);
+        mk_vm_address_t *addresses = calloc(count, sizeof(*addresses));
+        MKDataInCodeEntryType *kinds = calloc(count, sizeof(*kinds));
+        for (NSUInteger i = 0; i < count; i++)
+            addresses[i] = text.vmAddress + 4 * i;
+        
+        [dataInCode classifyAddresses:addresses count:count kinds:kinds];
+        for (NSUInteger i = 0; i < count; i++) {
+            NSUInteger entry = i / 8;
+            BOOL inside = (i % 8) < 2 && entry < configuration.dataInCodeCount;
+            expect(kinds[i]).to.equal(inside ? 1 + entry % 4 : 0);
+        }
+        
+        for (NSUInteger i = 0; i < count / 2; i++) {
+            mk_vm_address_t address = addresses[i];
+            addresses[i] = addresses[count - 1 - i];
+            addresses[count - 1 - i] = address;
+        }
+        [dataInCode classifyAddresses:addresses count:count kinds:kinds];
+        for (NSUInteger i = 0; i < count; i++) {
+            const MKDataInCodeRange *range = [dataInCode rangeContainingAddress:addresses[i]];
+            expect(kinds[i]).to.equal(range ? range->kind : 0);
+        }
+        
+        free(kinds);
+        free(addresses);
+    });
+    
+    it(@"should drop overlapping entries with a warning", ^{
+        MKMachOImage *macho = loadImage(configuration, @"libOverlappingDataInCode.dylib", ^(struct data_in_code_entry *entries, uint32_t count) {
+            expect(count).to.beGreaterThan(12);
+            // Entry 5 starts inside entry 4.
+            entries[5].offset = entries[4].offset + 4;
+            // Entries 10 and 11 are out of order, but do not overlap.
+            struct data_in_code_entry entry = entries[10];
+            entries[10] = entries[11];
+            entries[11] = entry;
+        });
+        
+        MKDataInCode *dataInCode = macho.dataInCode.value;
+        expect(dataInCode).toNot.beNil();
+        expect(dataInCode.rangeCount).to.equal(configuration.dataInCodeCount - 1);
+        
+        NSUInteger overlapWarnings = 0;
+        for (NSError *warning in dataInCode.warnings)
+            if (warning.code == MK_EINVALID_DATA && [warning.localizedDescription containsString:@"overlaps"])
+                overlapWarnings++;
+        expect(overlapWarnings).to.equal(1);
+        
+        // The table is sorted and free of overlaps.
+        for (NSUInteger i = 1; i < dataInCode.rangeCount; i++)
+            expect(dataInCode.ranges[i].offset).to.beGreaterThanOrEqualTo((uint64_t)dataInCode.ranges[i - 1].offset + dataInCode.ranges[i - 1].length);
+        
+        // The first of the overlapping entries wins.
+        MKSection *text = [macho sectionWithName:@SECT_TEXT inSegmentWithName:@SEG_TEXT];
+        const MKDataInCodeRange *range = [dataInCode rangeContainingOffset:(uint32_t)(text.fileOffset + 32 * 4 + 6)];
+        expect(range != NULL).to.beTruthy();
+        if (range) expect(range->kind).to.equal(1 + 4 % 4);
+        expect([dataInCode rangeContainingOffset:(uint32_t)(text.fileOffset + 32 * 4 + 10)] == NULL).to.beTruthy();
+        expect([dataInCode rangeContainingOffset:(uint32_t)(text.fileOffset + 32 * 10)]->kind).to.equal(1 + 10 % 4);
+    });
+});
+
+SpecEnd
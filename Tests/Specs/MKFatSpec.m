@@ -27,6 +27,77 @@
 
 SpecBegin(MKFat)
 {
+    describe(@"a synthetic FAT_MAGIC_64 binary", ^{
+        SyntheticMachOFixture *fixture = [SyntheticMachOFixture fixtureWithName:@"MKFat"];
+        NSURL *url = [fixture URLForFileWithName:@"libFat.dylib"];
+        NSArray<NSArray<NSNumber*>*> *slices = @[
+            @[ @(CPU_TYPE_X86_64), @(CPU_SUBTYPE_X86_64_ALL) ],
+            @[ @(CPU_TYPE_ARM64), @(CPU_SUBTYPE_ARM64_ALL) ],
+            @[ @(CPU_TYPE_ARM64), @(CPU_SUBTYPE_ARM64E) ]
+        ];
+        __block MKFatBinary *binary = nil;
+        
+        beforeAll(^{
+            NSError *error = nil;
+            SyntheticMachOConfiguration *configuration = [SyntheticMachOConfiguration configurationWithScale:1];
+            expect([SyntheticMachO writeFatBinaryWithConfiguration:configuration architectures:slices fat64:YES toURL:url error:&error]).to.beTruthy();
+            
+            MKMemoryMap *map = [MKMemoryMap memoryMapWithContentsOfFile:url error:&error];
+            expect(map).toNot.beNil();
+            binary = [[MKFatBinary alloc] initWithMemoryMap:map error:&error];
+            expect(binary).toNot.beNil();
+            expect(error).to.beNil();
+        });
+        
+        it(@"should read the 64-bit architecture table", ^{
+            expect(binary.magic).to.equal(FAT_MAGIC_64);
+            expect(binary.nfat_arch).to.equal(slices.count);
+            expect(binary.architectures.count).to.equal(slices.count);
+            
+            for (NSUInteger i = 0; i < binary.architectures.count; i++) {
+                MKFatArch *architecture = binary.architectures[i];
+                expect(architecture.cputype).to.equal(slices[i][0].intValue);
+                expect(architecture.cpusubtype).to.equal(slices[i][1].intValue);
+                expect(architecture.offset % (1U << 14)).to.equal(0);
+            }
+            
+            expect([binary bestArchitectureForCPUType:CPU_TYPE_ARM64 cpuSubType:CPU_SUBTYPE_ARM64E]).to.beIdenticalTo(binary.architectures[2]);
+            expect([binary bestArchitectureForCPUType:CPU_TYPE_ARM64 cpuSubType:CPU_SUBTYPE_ARM64_V8]).to.beIdenticalTo(binary.architectures[1]);
+        });
+        
+        it(@"should return the same architecture to concurrent callers", ^{
+            // A fresh binary, so that no architecture has been created yet.
+            MKFatBinary *fresh = [[MKFatBinary alloc] initWithMemoryMap:binary.memoryMap error:NULL];
+            const size_t iterations = 64;
+            __strong MKFatArch **found = (__strong MKFatArch **)calloc(iterations, sizeof(MKFatArch*));
+            
+            dispatch_apply(iterations, dispatch_get_global_queue(QOS_CLASS_USER_INITIATED, 0), ^(size_t i) {
+                found[i] = [fresh architectureAtIndex:(uint32_t)(i % slices.count)];
+            });
+            
+            for (size_t i = 0; i < iterations; i++) {
+                expect(found[i]).toNot.beNil();
+                expect(found[i]).to.beIdenticalTo(found[i % slices.count]);
+                found[i] = nil;
+            }
+            free(found);
+        });
+        
+        it(@"should parse every slice concurrently", ^{
+            MKFatBinary *fresh = [[MKFatBinary alloc] initWithMemoryMap:binary.memoryMap error:NULL];
+            NSArray<MKResult<MKMachOImage*>*> *images = [fresh imagesForArchitectures:fresh.architectures options:MKFatBinaryImageParseConcurrently];
+            expect(images.count).to.equal(slices.count);
+            
+            for (NSUInteger i = 0; i < images.count; i++) {
+                MKMachOImage *image = images[i].value;
+                expect(image).toNot.beNil();
+                expect(image.header.cputype).to.equal(slices[i][0].intValue);
+                expect(image.header.cpusubtype).to.equal(slices[i][1].intValue);
+                expect(image.loadCommands.count).to.equal(image.header.ncmds);
+            }
+        });
+    });
+    
     NSArray *frameworks = [NSFileManager allExecutableURLs:MKFrameworkTypeAll];
     
     for (NSURL *frameworkURL in frameworks)
@@ -104,6 +175,11 @@ SpecBegin(MKFat)
             it(@"Should have the correct alignment", ^{
                 expect(architecture.align).to.equal([otoolArchitecture[@"align"] integerValue]);
             });
+            
+            it(@"Should be the best architecture for its CPU type and subtype", ^{
+                MKFatArch *best = [binary bestArchitectureForCPUType:architecture.cputype cpuSubType:architecture.cpusubtype];
+                expect(best.offset).to.equal(architecture.offset);
+            });
         });
     });
 }
@@ -160,6 +160,41 @@ SpecBegin(MKMachOImage)
                 });
             });
             
+            //----------------------------------------------------------------//
+            describe(@"sections", ^{
+                it(@"should be found by name and by address", ^{
+                    for (MKSection *section in macho.sections.allValues) {
+                        NSString *segName = section.loadCommand.segname;
+                        expect([macho sectionsWithName:section.name inSegmentWithName:segName]).to.contain(section);
+                        
+                        if (section.size == 0) continue;
+                        MKSection *found = [macho sectionContainingVMAddress:section.nodeVMAddress + section.size - 1];
+                        expect(found.nodeVMAddress).to.equal(section.nodeVMAddress);
+                    }
+                });
+            });
+            
+            //----------------------------------------------------------------//
+            describe(@"code signature", ^{
+                if ([macho loadCommandsOfType:LC_CODE_SIGNATURE].count == 0)
+                    return;
+                
+                it(@"should verify", ^{
+                    MKCodeSignature *codeSignature = macho.codeSignature.value;
+                    expect(codeSignature).toNot.beNil();
+                    expect(codeSignature.codeDirectory).toNot.beNil();
+                    
+                    NSError *verifyError = nil;
+                    expect([codeSignature verifyWithError:&verifyError]).to.beTruthy();
+                    expect(verifyError).to.beNil();
+                    
+                    for (MKResult<MKSegment*> *segment in macho.segments) {
+                        if (segment.value.fileSize == 0) continue;
+                        expect([codeSignature verifySegment:segment.value error:&verifyError]).to.beTruthy();
+                    }
+                });
+            });
+            
             //----------------------------------------------------------------//
             describe(@"dylibs", ^{
                 NSArray<NSDictionary*> *dyldDependentLibraries = otoolArchitecture.dependentLibraries;
@@ -326,6 +361,24 @@ SpecBegin(MKMachOImage)
                         expect([binding.sourceLibrary.name rangeOfString:dyldInfoBindings[i][@"dylib"]].location).toNot.equal(NSNotFound);
                     }
                 });
+                
+                it(@"should match the compact bind table", ^{
+                    NSError *bindTableError = nil;
+                    MKBindTable *bindTable = [[MKBindTable alloc] initWithImage:macho kind:MKBindTableKindBind error:&bindTableError];
+                    expect(bindTable).toNot.beNil();
+                    expect(bindTable.warnings).to.equal(@[]);
+                    expect(bindTable.locationCount).to.equal(machoBindings.count);
+                    
+                    for (NSUInteger i=0; i<MIN(bindTable.locationCount, machoBindings.count); i++) {
+                        MKBindActionBind *binding = machoBindings[i];
+                        const MKBindTableLocation *location = &bindTable.locations[i];
+                        const MKBindTableSymbol *symbol = &bindTable.symbols[location->symbolIndex];
+                        
+                        expect(location->segmentOffset).to.equal(binding.offset);
+                        expect(location->addend).to.equal(binding.addend);
+                        expect(@(symbol->name)).to.equal(binding.symbolName);
+                    }
+                });
             });
             
             //----------------------------------------------------------------//
@@ -498,6 +551,53 @@ SpecBegin(MKMachOImage)
                 });
             });
             
+            //----------------------------------------------------------------//
+            describe(@"symbolicator", ^{
+                NSArray<MKFunction*> *machoFunctions = macho.functionStarts.value.functions;
+                if (machoFunctions.count == 0)
+                    return;
+                
+                MKSymbolicator *symbolicator = [[MKSymbolicator alloc] initWithImages:@[macho] sharedCache:nil];
+                
+                it(@"should resolve function starts in input order", ^{
+                    NSMutableArray<NSNumber*> *addresses = [NSMutableArray array];
+                    for (MKFunction *function in machoFunctions.reverseObjectEnumerator)
+                        [addresses addObject:@(function.address)];
+                    
+                    NSArray<MKSymbolication*> *results = [symbolicator symbolicateAddresses:addresses];
+                    expect(results.count).to.equal(addresses.count);
+                    
+                    for (NSUInteger i=0; i<results.count; i++) {
+                        expect(results[i].address).to.equal(addresses[i].unsignedLongLongValue);
+                        expect(results[i].image).to.equal(macho);
+                        expect(results[i].symbolAddress).to.equal(addresses[i].unsignedLongLongValue);
+                    }
+                });
+                
+                it(@"should name the symbol table's section symbols", ^{
+                    NSMutableArray<NSNumber*> *addresses = [NSMutableArray array];
+                    NSMutableSet<NSString*> *names = [NSMutableSet set];
+                    for (MKSymbol *symbol in macho.symbolTable.value.symbols) {
+                        if (![symbol isKindOfClass:MKSectionSymbol.class] || symbol.name.value.string.length == 0)
+                            continue;
+                        [addresses addObject:@([(MKSectionSymbol*)symbol address])];
+                        [names addObject:symbol.name.value.string];
+                    }
+                    
+                    for (MKSymbolication *result in [symbolicator symbolicateAddresses:addresses]) {
+                        expect(result.source).to.equal(MKSymbolicationSourceSymbolTable);
+                        // Several symbols may share an address.
+                        expect([names containsObject:result.symbolName]).to.beTruthy();
+                    }
+                });
+                
+                it(@"should not resolve addresses outside of the image", ^{
+                    MKSymbolication *result = [symbolicator symbolicateAddresses:@[@(0)]].firstObject;
+                    expect(result.image).to.beNil();
+                    expect(result.source).to.equal(MKSymbolicationSourceNone);
+                });
+            });
+            
             //----------------------------------------------------------------//
             describe(@"data in code", ^{
                 NSArray<NSDictionary*> *dyldDataInCodeEntries = otoolArchitecture.dataInCodeEntries;
@@ -526,6 +626,24 @@ SpecBegin(MKMachOImage)
                     }
                 });
                 
+                it(@"should match the range table", ^{
+                    expect(machoDataInCode.rangeCount).to.equal(machoDataInCodeEntries.count);
+                    
+                    for (MKDataInCodeEntry *entry in machoDataInCodeEntries) {
+                        if (entry.length == 0) continue;
+                        
+                        const MKDataInCodeRange *range = [machoDataInCode rangeContainingAddress:entry.address + entry.length - 1];
+                        expect(range != NULL).to.beTruthy();
+                        if (range == NULL) continue;
+                        expect(range->offset).to.equal(entry.offset);
+                        
+                        MKDataInCodeEntryType kind = 0;
+                        mk_vm_address_t address = entry.address;
+                        [machoDataInCode classifyAddresses:&address count:1 kinds:&kind];
+                        expect(kind).to.equal(entry.kind);
+                    }
+                });
+                
                 // -childNodeOccupyingVMAddress:targetClass:inSortedArray: relies
                 // on entires being sorted.
                 it(@"should sort the entires by address", ^{
@@ -653,6 +771,22 @@ SpecBegin(MKMachOImage)
                         lastAddress = entryVMAddress;
                     }
                 });
+                
+                it(@"should resolve every stub table entry by address", ^{
+                    MKStubTable *stubTable = macho.stubTable.value;
+                    expect(stubTable).toNot.beNil();
+                    expect(stubTable.warnings).to.equal(@[]);
+                    expect(stubTable.entryCount).to.beLessThanOrEqualTo(machoIndirectSymbols.count);
+                    
+                    mk_vm_address_t lastAddress = 0;
+                    for (NSUInteger i=0; i<stubTable.entryCount; i++) {
+                        const MKStubTableEntry *entry = &stubTable.entries[i];
+                        expect(entry->address).to.beGreaterThanOrEqualTo(lastAddress);
+                        expect([stubTable entryForAddress:entry->address] == entry).to.beTruthy();
+                        expect(entry->symbolName == NULL).to.equal((entry->symbolIndex & (INDIRECT_SYMBOL_LOCAL | INDIRECT_SYMBOL_ABS)) != 0);
+                        lastAddress = entry->address;
+                    }
+                });
             });
             
             //----------------------------------------------------------------//
@@ -716,6 +850,25 @@ SpecBegin(MKMachOImage)
                         expect(section.elements.count).to.equal(otoolClassList.count);
                     });
                     
+                    it(@"should match the bulk metadata records", ^{
+                        MKObjCMetadata *metadata = macho.objcMetadata.value;
+                        expect(metadata).toNot.beNil();
+                        expect(metadata.classCount).to.equal(section.elements.count);
+                        
+                        for (MKPointerNode *ptr in section.elements) {
+                            MKObjCClass *cls = ptr.pointee.value;
+                            MKObjCClassData *clsData = cls.classData.pointee.value;
+                            const MKObjCClassRecord *record = [metadata classRecordAtAddress:cls.nodeVMAddress];
+                            
+                            expect(record != NULL).to.beTruthy();
+                            if (record == NULL || clsData == nil) continue;
+                            
+                            expect(record->name ? @(record->name) : nil).to.equal([clsData.name.pointee.value string]);
+                            expect(record->instanceSize).to.equal(clsData.instanceSize);
+                            expect([[metadata classNodeForRecord:record].value nodeVMAddress]).to.equal(cls.nodeVMAddress);
+                        }
+                    });
+                    
                     for (MKPointerNode *ptr in section.elements)
                     {
                         describe([NSString stringWithFormat:@"%.16" MK_VM_PRIxADDR "", ptr.nodeVMAddress], ^{
@@ -975,5 +1128,159 @@ SpecBegin(MKMachOImage)
         
         
     });
+    
+    describe(@"dependency graph", ^{
+        it(@"should parse each image once", ^{
+            MKDependencyGraph *graph = [[MKDependencyGraph alloc] init];
+            NSArray<MKDependencyGraphNode*> *roots = [graph resolveClosureOfImagesAtURLs:frameworks];
+            expect(roots.count).to.equal(frameworks.count);
+            
+            for (MKDependencyGraphNode *root in roots) {
+                if (root.image == nil) continue;
+                expect(root.dependencies.count).to.equal(root.image.dependentLibraries.count);
+                expect([graph closureOfNode:root].firstObject).to.beIdenticalTo(root);
+            }
+            
+            NSUInteger parseCount = graph.parseCount;
+            expect(parseCount).to.equal(graph.nodes.count);
+            
+            [graph resolveClosureOfImagesAtURLs:frameworks];
+            expect(graph.parseCount).to.equal(parseCount);
+        });
+    });
+    
+    describe(@"work budget", ^{
+        SyntheticMachOFixture *fixture = [SyntheticMachOFixture fixtureWithName:@"MKMachOWorkBudget"];
+        
+        BOOL (^hasBudgetWarning)(MKNode*) = ^BOOL(MKNode *node) {
+            return [node.warnings indexOfObjectPassingTest:^BOOL(NSError *warning, __unused NSUInteger idx, __unused BOOL *stop) {
+                return warning.code == MK_EBUDGET_EXCEEDED;
+            }] != NSNotFound;
+        };
+        
+        // Writes a synthetic image with the opcodes of one of its dyld info
+        // streams replaced, and loads it with the given budget.
+        MKMachOImage* (^loadHostileImage)(NSData*, BOOL, mk_context_budget_t) = ^MKMachOImage*(NSData *opcodes, BOOL bind, mk_context_budget_t budget) {
+            SyntheticMachOConfiguration *configuration = [SyntheticMachOConfiguration configurationWithScale:1];
+            NSMutableData *contents = [[SyntheticMachO machOWithConfiguration:configuration baseAddress:0 fileOffset:0] mutableCopy];
+            
+            struct mach_header_64 *header = contents.mutableBytes;
+            struct load_command *lc = (struct load_command*)(header + 1);
+            struct dyld_info_command *dyldInfo = NULL;
+            for (uint32_t i = 0; i < header->ncmds; i++, lc = (struct load_command*)((uint8_t*)lc + lc->cmdsize)) {
+                if (lc->cmd == LC_DYLD_INFO_ONLY)
+                    dyldInfo = (struct dyld_info_command*)lc;
+            }
+            expect(dyldInfo != NULL).to.beTruthy();
+            if (dyldInfo == NULL) return nil;
+            
+            // The opcodes after DONE are never parsed.
+            uint32_t offset = bind ? dyldInfo->bind_off : dyldInfo->rebase_off;
+            uint32_t size = bind ? dyldInfo->bind_size : dyldInfo->rebase_size;
+            expect(size).to.beGreaterThanOrEqualTo(opcodes.length);
+            [contents replaceBytesInRange:NSMakeRange(offset, opcodes.length) withBytes:opcodes.bytes];
+            expect([contents writeToURL:[fixture URLForFileWithName:@"libHostile.dylib"] options:NSDataWritingAtomic error:NULL]).to.beTruthy();
+            
+            return [fixture imageWithName:@"libHostile.dylib" budget:budget error:NULL];
+        };
+        
+        it(@"should stop a repeating rebase command", ^{
+            // Rebases the start of __DATA 2^40 times.
+            const uint8_t opcodes[] = {
+                REBASE_OPCODE_SET_TYPE_IMM | REBASE_TYPE_POINTER,
+                REBASE_OPCODE_SET_SEGMENT_AND_OFFSET_ULEB | 1, 0x00,
+                REBASE_OPCODE_DO_REBASE_ULEB_TIMES, 0x80, 0x80, 0x80, 0x80, 0x80, 0x20,
+                REBASE_OPCODE_DONE
+            };
+            
+            MKMachOImage *macho = loadHostileImage([NSData dataWithBytes:opcodes length:sizeof(opcodes)], NO, (mk_context_budget_t){ .max_nodes = 16 });
+            expect(macho).toNot.beNil();
+            
+            MKRebaseInfo *rebaseInfo = macho.rebaseInfo.value;
+            expect(rebaseInfo).toNot.beNil();
+            expect(rebaseInfo.commands.count).to.equal(4);
+            expect(rebaseInfo.fixups.count).to.equal(16);
+            expect(hasBudgetWarning(rebaseInfo)).to.beTruthy();
+        });
+        
+        it(@"should stop a repeating bind command", ^{
+            // Binds the start of __DATA 2^40 times.
+            const uint8_t opcodes[] = {
+                BIND_OPCODE_SET_DYLIB_ORDINAL_IMM | 1,
+                BIND_OPCODE_SET_TYPE_IMM | BIND_TYPE_POINTER,
+                BIND_OPCODE_SET_SYMBOL_TRAILING_FLAGS_IMM, '_', 'x', '\0',
+                BIND_OPCODE_SET_SEGMENT_AND_OFFSET_ULEB | 1, 0x00,
+                BIND_OPCODE_DO_BIND_ULEB_TIMES_SKIPPING_ULEB, 0x80, 0x80, 0x80, 0x80, 0x80, 0x20, 0x00,
+                BIND_OPCODE_DONE
+            };
+            
+            MKMachOImage *macho = loadHostileImage([NSData dataWithBytes:opcodes length:sizeof(opcodes)], YES, (mk_context_budget_t){ .max_nodes = 16 });
+            expect(macho).toNot.beNil();
+            
+            MKBindingsInfo *bindingsInfo = macho.bindingsInfo.value;
+            expect(bindingsInfo).toNot.beNil();
+            expect(bindingsInfo.actions.count).to.equal(16);
+            expect(hasBudgetWarning(bindingsInfo)).to.beTruthy();
+        });
+        
+        it(@"should stop parsing once the deadline has passed", ^{
+            const uint8_t opcodes[] = { REBASE_OPCODE_DONE };
+            NSData *done = [NSData dataWithBytes:opcodes length:sizeof(opcodes)];
+            
+            // A deadline on the first nanosecond of the monotonic clock passed
+            // long ago.
+            MKMachOImage *macho = loadHostileImage(done, NO, (mk_context_budget_t){ .deadline = 1 });
+            expect(macho).toNot.beNil();
+            expect(macho.loadCommands.count).to.equal(0);
+            expect(hasBudgetWarning(macho)).to.beTruthy();
+            
+            macho = loadHostileImage(done, NO, (mk_context_budget_t){ .deadline = mk_context_budget_deadline_after(60 * NSEC_PER_SEC) });
+            expect(macho).toNot.beNil();
+            expect(macho.loadCommands.count).to.equal(macho.header.ncmds);
+            expect(hasBudgetWarning(macho)).to.beFalsy();
+        });
+        
+        it(@"should stop parsing load commands with a warning", ^{
+            for (NSURL *frameworkURL in frameworks) {
+                Binary *otool = [Binary binaryAtURL:frameworkURL];
+                if (otool == nil) continue;
+                
+                MKMemoryMap *map = [MKMemoryMap memoryMapWithContentsOfFile:frameworkURL error:NULL];
+                if (map == nil) continue;
+                map.budget = (mk_context_budget_t){ .max_nodes = 1 };
+                
+                for (Architecture *otoolArchitecture in otool.architectures) {
+                    MKMachOImage *macho = [[MKMachOImage alloc] initWithName:NULL flags:0 atAddress:otoolArchitecture.offset inMapping:map error:NULL];
+                    if (macho == nil || macho.header.ncmds < 2) continue;
+                    
+                    expect(macho.loadCommands.count).to.equal(1);
+                    expect([macho.warnings indexOfObjectPassingTest:^BOOL(NSError *warning, __unused NSUInteger idx, __unused BOOL *stop) {
+                        return warning.code == MK_EBUDGET_EXCEEDED;
+                    }]).toNot.equal(NSNotFound);
+                }
+            }
+        });
+    });
+    
+    describe(@"synthetic image", ^{
+        SyntheticMachOFixture *fixture = [SyntheticMachOFixture fixtureWithName:@"MKMachOSynthetic"];
+        
+        it(@"should parse every subsystem completely", ^{
+            SyntheticMachOConfiguration *configuration = [SyntheticMachOConfiguration configurationWithScale:1];
+            
+            NSError *error = nil;
+            MKMachOImage *macho = [fixture imageWithConfiguration:configuration name:@"libSynthetic.dylib" error:&error];
+            expect(macho).toNot.beNil();
+            expect(error).to.beNil();
+            
+            expect(macho.loadCommands.count).to.equal(10 + configuration.loadCommandCount);
+            expect(macho.symbolTable.value.symbols.count).to.equal(configuration.symbolCount + configuration.bindCount);
+            expect(macho.exportsInfo.value.exports.count).to.equal(configuration.symbolCount);
+            expect(macho.rebaseInfo.value.fixups.count).to.equal(configuration.rebaseCount + 8 * configuration.objcClassCount);
+            expect(macho.bindingsInfo.value.actions.count).to.equal(configuration.bindCount);
+            expect(macho.functionStarts.value.functions.count).to.equal(configuration.functionStartCount);
+            expect(macho.objcMetadata.value.classCount).to.equal(configuration.objcClassCount);
+        });
+    });
 }
 SpecEnd
@@ -27,6 +27,62 @@
 
 #include <malloc/malloc.h>
 
+//----------------------------------------------------------------------------//
+//! A block source over \c NSData that counts the reads of each block.
+//
+@interface MKCountingBlockSource : NSObject <MKBlockSource>
+- (instancetype)initWithData:(NSData*)data blockSize:(mk_vm_size_t)blockSize;
+- (NSUInteger)readCountOfBlockAtIndex:(uint64_t)index;
+@end
+
+@implementation MKCountingBlockSource
+{
+    NSData *_data;
+    mk_vm_size_t _blockSize;
+    NSCountedSet<NSNumber*> *_reads;
+}
+
+//|++++++++++++++++++++++++++++++++++++|//
+- (instancetype)initWithData:(NSData*)data blockSize:(mk_vm_size_t)blockSize
+{
+    self = [super init];
+    if (self == nil) return nil;
+    
+    _data = data;
+    _blockSize = blockSize;
+    _reads = [NSCountedSet new];
+    
+    return self;
+}
+
+//|++++++++++++++++++++++++++++++++++++|//
+- (mk_vm_size_t)blockSize
+{ return _blockSize; }
+
+//|++++++++++++++++++++++++++++++++++++|//
+- (BOOL)readBlockAtIndex:(uint64_t)index into:(void*)buffer length:(mk_vm_size_t*)length error:(__unused NSError**)error
+{
+    uint64_t offset = index * _blockSize;
+    *length = (offset < _data.length) ? MIN(_blockSize, _data.length - offset) : 0;
+    if (*length)
+        memcpy(buffer, (const uint8_t*)_data.bytes + offset, (size_t)*length);
+    
+    @synchronized(_reads) {
+        [_reads addObject:@(index)];
+    }
+    return YES;
+}
+
+//|++++++++++++++++++++++++++++++++++++|//
+- (NSUInteger)readCountOfBlockAtIndex:(uint64_t)index
+{
+    @synchronized(_reads) {
+        return [_reads countForObject:@(index)];
+    }
+}
+
+@end
+
 SpecBegin(MKMemoryMap)
 
 describe(@"a file memory map", ^{
@@ -71,6 +127,195 @@ describe(@"a file memory map", ^{
     it(@"should report that it has valid mappings", ^{
         expect([map hasMappingAtOffset:4096 fromAddress:0 length:5484640]).to.beTruthy();
     });
+    
+    it(@"should return the same bytes after access advice", ^{
+        uint8_t before[64], after[64];
+        expect([map copyBytesAtOffset:4096 fromAddress:0 into:before length:sizeof(before) requireFull:YES error:NULL]).to.equal(sizeof(before));
+        
+        [map adviseAccess:MKMemoryAccessAdviceWillNeed atOffset:0 fromAddress:0 length:fileData.length];
+        [map adviseAccess:MKMemoryAccessAdviceDontNeed atOffset:0 fromAddress:0 length:fileData.length];
+        // Out of range advice is ignored.
+        [map adviseAccess:MKMemoryAccessAdviceRandom atOffset:0 fromAddress:fileData.length length:vm_page_size];
+        
+        expect([map copyBytesAtOffset:4096 fromAddress:0 into:after length:sizeof(after) requireFull:YES error:NULL]).to.equal(sizeof(after));
+        expect(memcmp(before, after, sizeof(before))).to.equal(0);
+    });
+});
+
+
+describe(@"a chunked memory map", ^{
+    __block NSData *fileData;
+    __block MKMemoryMap *map;
+    
+    beforeAll(^{
+        NSError *error = nil;
+        fileData = [NSData dataWithContentsOfFile:@"/System/Library/Frameworks/Foundation.framework/Foundation" options:NSDataReadingMappedIfSafe error:&error];
+        expect(fileData).toNot.beNil();
+        
+        // Each rewind opens a fresh stream over the file contents.
+        MKStreamBlockSource *source = [[MKStreamBlockSource alloc] initWithStreamProvider:^NSInputStream* {
+            return [NSInputStream inputStreamWithData:fileData];
+        } blockSize:4096];
+        map = [MKMemoryMap memoryMapWithBlockSource:source maximumCachedBlocks:4 error:&error];
+        expect(map).toNot.beNil();
+        expect(error).to.beNil();
+    });
+    
+    it(@"should remap ranges within and across blocks", ^{
+        // The second range spans more blocks than the cache holds, so the
+        // ranges after it are read again from a rewound stream.
+        mk_vm_offset_t offsets[] = { 16, 4000, 8192, 100 };
+        mk_vm_size_t lengths[] = { 64, 5 * 4096, 4096, 32 };
+        
+        for (size_t i = 0; i < sizeof(offsets)/sizeof(offsets[0]); i++) {
+            mk_vm_offset_t offset = offsets[i];
+            mk_vm_size_t expectedLength = lengths[i];
+            __block NSError *error = nil;
+            [map remapBytesAtOffset:offset fromAddress:0 length:expectedLength requireFull:YES withHandler:^(vm_address_t address, vm_size_t length, NSError *e) {
+                error = e;
+                expect(length).to.equal(expectedLength);
+                expect(memcmp((void*)address, (const uint8_t*)fileData.bytes + offset, (size_t)expectedLength)).to.equal(0);
+            }];
+            expect(error).to.beNil();
+        }
+    });
+    
+    it(@"should fail when asked to remap past the end of the contents", ^{
+        __block NSError *error = nil;
+        [map remapBytesAtOffset:0 fromAddress:fileData.length - 8 length:16 requireFull:YES withHandler:^(vm_address_t __unused address, vm_size_t __unused length, NSError *e) {
+            error = e;
+        }];
+        expect(error).toNot.beNil();
+        
+        expect([map mappingSizeAtOffset:0 fromAddress:fileData.length - 8 length:16]).to.equal(8);
+    });
+    
+    it(@"should truncate a range longer than the maximum span", ^{
+        NSData *contents = [NSMutableData dataWithLength:72 << 20];
+        MKCountingBlockSource *source = [[MKCountingBlockSource alloc] initWithData:contents blockSize:1 << 20];
+        MKMemoryMap *largeMap = [MKMemoryMap memoryMapWithBlockSource:source maximumCachedBlocks:4 error:NULL];
+        expect(largeMap).toNot.beNil();
+        
+        __block NSError *error = nil;
+        [largeMap remapBytesAtOffset:16 fromAddress:0 length:contents.length - 16 requireFull:YES withHandler:^(vm_address_t __unused address, vm_size_t __unused length, NSError *e) {
+            error = e;
+        }];
+        expect(error).toNot.beNil();
+        
+        __block vm_size_t remappedLength = 0;
+        [largeMap remapBytesAtOffset:16 fromAddress:0 length:contents.length - 16 requireFull:NO withHandler:^(vm_address_t __unused address, vm_size_t length, NSError *e) {
+            error = e;
+            remappedLength = length;
+        }];
+        expect(error).to.beNil();
+        expect(remappedLength).to.equal(64 << 20);
+    });
+    
+    it(@"should read ahead after consecutive misses", ^{
+        MKCountingBlockSource *source = [[MKCountingBlockSource alloc] initWithData:fileData blockSize:4096];
+        MKMemoryMap *countingMap = [MKMemoryMap memoryMapWithBlockSource:source maximumCachedBlocks:8 error:NULL];
+        uint8_t byte;
+        
+        // A single miss does not read ahead.
+        expect([countingMap copyBytesAtOffset:0 fromAddress:0 into:&byte length:1 requireFull:YES error:NULL]).to.equal(1);
+        expect([source readCountOfBlockAtIndex:1]).to.equal(0);
+        
+        expect([countingMap copyBytesAtOffset:4096 fromAddress:0 into:&byte length:1 requireFull:YES error:NULL]).to.equal(1);
+        expect([source readCountOfBlockAtIndex:2]).will.equal(1);
+        
+        // The block that was read ahead is not read again.
+        expect([countingMap copyBytesAtOffset:2 * 4096 fromAddress:0 into:&byte length:1 requireFull:YES error:NULL]).to.equal(1);
+        expect([source readCountOfBlockAtIndex:2]).to.equal(1);
+    });
+    
+    it(@"should read ahead of every miss after sequential advice", ^{
+        MKCountingBlockSource *source = [[MKCountingBlockSource alloc] initWithData:fileData blockSize:4096];
+        MKMemoryMap *countingMap = [MKMemoryMap memoryMapWithBlockSource:source maximumCachedBlocks:8 error:NULL];
+        uint8_t byte;
+        
+        // Half the cache is read ahead.
+        [countingMap adviseAccess:MKMemoryAccessAdviceSequential atOffset:0 fromAddress:0 length:fileData.length];
+        expect([countingMap copyBytesAtOffset:16 * 4096 fromAddress:0 into:&byte length:1 requireFull:YES error:NULL]).to.equal(1);
+        expect([source readCountOfBlockAtIndex:20]).will.equal(1);
+        expect([source readCountOfBlockAtIndex:21]).to.equal(0);
+    });
+    
+    it(@"should not read ahead after random advice", ^{
+        MKCountingBlockSource *source = [[MKCountingBlockSource alloc] initWithData:fileData blockSize:4096];
+        MKMemoryMap *countingMap = [MKMemoryMap memoryMapWithBlockSource:source maximumCachedBlocks:8 error:NULL];
+        uint8_t byte;
+        
+        [countingMap adviseAccess:MKMemoryAccessAdviceRandom atOffset:0 fromAddress:0 length:fileData.length];
+        expect([countingMap copyBytesAtOffset:0 fromAddress:0 into:&byte length:1 requireFull:YES error:NULL]).to.equal(1);
+        expect([countingMap copyBytesAtOffset:4096 fromAddress:0 into:&byte length:1 requireFull:YES error:NULL]).to.equal(1);
+        
+        [NSThread sleepForTimeInterval:0.1];
+        expect([source readCountOfBlockAtIndex:2]).to.equal(0);
+    });
+    
+    it(@"should read ahead a range that will be needed", ^{
+        MKCountingBlockSource *source = [[MKCountingBlockSource alloc] initWithData:fileData blockSize:4096];
+        MKMemoryMap *countingMap = [MKMemoryMap memoryMapWithBlockSource:source maximumCachedBlocks:8 error:NULL];
+        
+        [countingMap adviseAccess:MKMemoryAccessAdviceWillNeed atOffset:48 * 4096 fromAddress:0 length:2 * 4096];
+        expect([source readCountOfBlockAtIndex:49]).will.equal(1);
+        expect([source readCountOfBlockAtIndex:48]).to.equal(1);
+        expect([source readCountOfBlockAtIndex:50]).to.equal(0);
+    });
+    
+    it(@"should drop the blocks of a range that is not needed", ^{
+        MKCountingBlockSource *source = [[MKCountingBlockSource alloc] initWithData:fileData blockSize:4096];
+        MKMemoryMap *countingMap = [MKMemoryMap memoryMapWithBlockSource:source maximumCachedBlocks:8 error:NULL];
+        [countingMap adviseAccess:MKMemoryAccessAdviceRandom atOffset:0 fromAddress:0 length:fileData.length];
+        uint8_t before[64], after[64], byte;
+        
+        expect([countingMap copyBytesAtOffset:4096 fromAddress:0 into:before length:sizeof(before) requireFull:YES error:NULL]).to.equal(sizeof(before));
+        expect([countingMap copyBytesAtOffset:3 * 4096 fromAddress:0 into:&byte length:1 requireFull:YES error:NULL]).to.equal(1);
+        
+        [countingMap adviseAccess:MKMemoryAccessAdviceDontNeed atOffset:4096 fromAddress:0 length:4096];
+        
+        // The dropped block is read again, and the block outside the range
+        // is still cached.
+        expect([countingMap copyBytesAtOffset:4096 fromAddress:0 into:after length:sizeof(after) requireFull:YES error:NULL]).to.equal(sizeof(after));
+        expect([countingMap copyBytesAtOffset:3 * 4096 fromAddress:0 into:&byte length:1 requireFull:YES error:NULL]).to.equal(1);
+        expect([source readCountOfBlockAtIndex:1]).to.equal(2);
+        expect([source readCountOfBlockAtIndex:3]).to.equal(1);
+        expect(memcmp(before, after, sizeof(before))).to.equal(0);
+    });
+    
+    SyntheticMachOFixture *fixture = [SyntheticMachOFixture fixtureWithName:@"MKMemoryMap"];
+    
+    it(@"should parse a Mach-O image", ^{
+        SyntheticMachOConfiguration *configuration = [SyntheticMachOConfiguration configurationWithScale:1];
+        NSData *contents = [SyntheticMachO machOWithConfiguration:configuration baseAddress:0 fileOffset:0];
+        
+        // Fewer blocks are cached than the image has, so some are read again.
+        MKCountingBlockSource *source = [[MKCountingBlockSource alloc] initWithData:contents blockSize:4096];
+        MKMemoryMap *chunkedMap = [MKMemoryMap memoryMapWithBlockSource:source maximumCachedBlocks:4 error:NULL];
+        expect(chunkedMap).toNot.beNil();
+        
+        NSError *error = nil;
+        MKMachOImage *chunked = [[MKMachOImage alloc] initWithName:"libChunked.dylib" flags:0 atAddress:0 inMapping:chunkedMap error:&error];
+        expect(chunked).toNot.beNil();
+        expect(error).to.beNil();
+        MKMachOImage *mapped = [fixture imageWithContents:contents name:@"libChunked.dylib" error:&error];
+        expect(mapped).toNot.beNil();
+        
+        expect(chunked.loadCommands.count).to.equal(mapped.loadCommands.count);
+        expect(chunked.symbolTable.value.symbols.count).to.equal(configuration.symbolCount + configuration.bindCount);
+        expect(chunked.exportsInfo.value.exports.count).to.equal(configuration.symbolCount);
+        expect(chunked.rebaseInfo.value.fixups.count).to.equal(configuration.rebaseCount + 8 * configuration.objcClassCount);
+        expect(chunked.bindingsInfo.value.actions.count).to.equal(configuration.bindCount);
+        expect(chunked.functionStarts.value.functions.count).to.equal(configuration.functionStartCount);
+        expect(chunked.objcMetadata.value.classCount).to.equal(configuration.objcClassCount);
+        
+        NSArray<MKSymbol*> *chunkedSymbols = chunked.symbolTable.value.symbols;
+        NSArray<MKSymbol*> *mappedSymbols = mapped.symbolTable.value.symbols;
+        for (NSUInteger i = 0; i < chunkedSymbols.count && i < mappedSymbols.count; i++) {
+            expect(chunkedSymbols[i].name.value.string).to.equal(mappedSymbols[i].name.value.string);
+            expect(chunkedSymbols[i].value).to.equal(mappedSymbols[i].value);
+        }
+    });
 });
 
 
@@ -0,0 +1,129 @@
+//----------------------------------------------------------------------------//
+//|
+//|             MachOKit - A Lightweight Mach-O Parsing Library
+//|             MKNodeCacheSpec.m
+//|
+//|             D.V.
+//|             Copyright (c) 2014-2015 D.V. All rights reserved.
+//|
+//| Permission is hereby granted, free of charge, to any person obtaining a
+//| copy of this software and associated documentation files (the "Software"),
+//| to deal in the Software without restriction, including without limitation
+//| the rights to use, copy, modify, merge, publish, distribute, sublicense,
+//| and/or sell copies of the Software, and to permit persons to whom the
+//| Software is furnished to do so, subject to the following conditions:
+//|
+//| The above copyright notice and this permission notice shall be included
+//| in all copies or substantial portions of the Software.
+//|
+//| THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+//| OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+//| MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+//| IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+//| CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+//| TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+//| SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+//----------------------------------------------------------------------------//
+
+#include <objc/runtime.h>
+
+SpecBegin(MKNodeCache)
+
+describe(@"a synthetic image", ^{
+    SyntheticMachOFixture *fixture = [SyntheticMachOFixture fixtureWithName:@"MKNodeCache"];
+    
+    __block SyntheticMachOConfiguration *configuration;
+    
+    MKMachOImage* (^loadImage)(void) = ^MKMachOImage* {
+        MKMachOImage *macho = [fixture imageWithName:@"libNodeCache.dylib" error:NULL];
+        expect(macho).toNot.beNil();
+        return macho;
+    };
+    
+    beforeAll(^{
+        configuration = [SyntheticMachOConfiguration configurationWithScale:1];
+        expect([fixture imageWithConfiguration:configuration name:@"libNodeCache.dylib" error:NULL]).toNot.beNil();
+    });
+    
+    it(@"should re-parse subtrees evicted from its node cache", ^{
+        MKMachOImage *macho = loadImage();
+        
+        // A budget of one byte keeps only the most recently parsed subtree.
+        MKNodeCache *nodeCache = [[MKNodeCache alloc] initWithMemoryBudget:1];
+        macho.nodeCache = nodeCache;
+        
+        expect(macho.exportsInfo.value.exports.count).to.equal(configuration.symbolCount);
+        expect(macho.functionStarts.value.functions.count).to.equal(configuration.functionStartCount);
+        expect(nodeCache.count).to.equal(1);
+        expect(nodeCache.evictionCount).to.equal(1);
+        
+        expect(macho.exportsInfo.value.exports.count).to.equal(configuration.symbolCount);
+        expect(nodeCache.evictionCount).to.equal(2);
+        expect(nodeCache.reparseCount).to.equal(1);
+    });
+    
+    it(@"should count the children of a subtree in its cost", ^{
+        MKMachOImage *macho = loadImage();
+        MKNodeCache *nodeCache = [[MKNodeCache alloc] initWithMemoryBudget:0];
+        macho.nodeCache = nodeCache;
+        
+        MKExportsInfo *exportsInfo = macho.exportsInfo.value;
+        expect(nodeCache.totalCost).to.beGreaterThan(exportsInfo.exports.count * class_getInstanceSize(MKExport.class));
+        
+        NSUInteger exportsCost = nodeCache.totalCost;
+        MKRebaseInfo *rebaseInfo = macho.rebaseInfo.value;
+        expect(nodeCache.totalCost - exportsCost).to.beGreaterThan(rebaseInfo.fixups.count * class_getInstanceSize(MKFixup.class));
+    });
+    
+    it(@"should evict the least recently used subtree at a realistic budget", ^{
+        // Measure the cost of each subtree without a budget.
+        MKMachOImage *macho = loadImage();
+        MKNodeCache *nodeCache = [[MKNodeCache alloc] initWithMemoryBudget:0];
+        macho.nodeCache = nodeCache;
+        
+        (void)macho.exportsInfo;
+        NSUInteger exportsCost = nodeCache.totalCost;
+        (void)macho.functionStarts;
+        NSUInteger functionsCost = nodeCache.totalCost - exportsCost;
+        (void)macho.rebaseInfo;
+        NSUInteger rebaseCost = nodeCache.totalCost - exportsCost - functionsCost;
+        
+        // A budget just short of all three subtrees holds any two of them.
+        macho = loadImage();
+        nodeCache = [[MKNodeCache alloc] initWithMemoryBudget:exportsCost + functionsCost + rebaseCost - 1];
+        macho.nodeCache = nodeCache;
+        
+        expect(macho.exportsInfo.value.exports.count).to.equal(configuration.symbolCount);
+        expect(macho.functionStarts.value.functions.count).to.equal(configuration.functionStartCount);
+        expect(nodeCache.evictionCount).to.equal(0);
+        
+        expect(macho.rebaseInfo.value).toNot.beNil();
+        expect(nodeCache.count).to.equal(2);
+        expect(nodeCache.evictionCount).to.equal(1);
+        expect(nodeCache.totalCost).to.equal(functionsCost + rebaseCost);
+        
+        // Using the function starts makes the rebase info the least recently
+        // used subtree.
+        expect(macho.functionStarts.value.functions.count).to.equal(configuration.functionStartCount);
+        expect(nodeCache.reparseCount).to.equal(0);
+        
+        expect(macho.exportsInfo.value.exports.count).to.equal(configuration.symbolCount);
+        expect(nodeCache.reparseCount).to.equal(1);
+        expect(nodeCache.evictionCount).to.equal(2);
+        expect(nodeCache.totalCost).to.equal(exportsCost + functionsCost);
+        expect(nodeCache.totalCost).to.beLessThanOrEqualTo(nodeCache.memoryBudget);
+    });
+    
+    it(@"should keep every subtree without a budget", ^{
+        MKMachOImage *macho = loadImage();
+        MKNodeCache *nodeCache = [[MKNodeCache alloc] initWithMemoryBudget:0];
+        macho.nodeCache = nodeCache;
+        
+        expect(macho.exportsInfo.value).to.beIdenticalTo(macho.exportsInfo.value);
+        expect(macho.functionStarts.value).to.beIdenticalTo(macho.functionStarts.value);
+        expect(nodeCache.evictionCount).to.equal(0);
+        expect(nodeCache.reparseCount).to.equal(0);
+    });
+});
+
+SpecEnd
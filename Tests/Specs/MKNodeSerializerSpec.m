@@ -0,0 +1,114 @@
+//----------------------------------------------------------------------------//
+//|
+//|             MachOKit - A Lightweight Mach-O Parsing Library
+//|             MKNodeSerializerSpec.m
+//|
+//|             D.V.
+//|             Copyright (c) 2014-2015 D.V. All rights reserved.
+//|
+//| Permission is hereby granted, free of charge, to any person obtaining a
+//| copy of this software and associated documentation files (the "Software"),
+//| to deal in the Software without restriction, including without limitation
+//| the rights to use, copy, modify, merge, publish, distribute, sublicense,
+//| and/or sell copies of the Software, and to permit persons to whom the
+//| Software is furnished to do so, subject to the following conditions:
+//|
+//| The above copyright notice and this permission notice shall be included
+//| in all copies or substantial portions of the Software.
+//|
+//| THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+//| OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+//| MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+//| IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+//| CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+//| TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+//| SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+//----------------------------------------------------------------------------//
+
+#include <fcntl.h>
+
+SpecBegin(MKNodeSerializer)
+
+describe(@"a synthetic image", ^{
+    SyntheticMachOFixture *fixture = [SyntheticMachOFixture fixtureWithName:@"MKNodeSerializer"];
+    
+    __block MKMachOImage *macho;
+    
+    beforeAll(^{
+        SyntheticMachOConfiguration *configuration = [SyntheticMachOConfiguration configurationWithScale:1];
+        configuration.reExportCount = 4;
+        macho = [fixture imageWithConfiguration:configuration name:@"libSerializer.dylib" error:NULL];
+        expect(macho).toNot.beNil();
+    });
+    
+    it(@"should serialize to JSON and CBOR", ^{
+        NSError *error = nil;
+        NSURL *jsonURL = [fixture URLForFileWithName:@"libSerializer.json"];
+        int fd = open(jsonURL.fileSystemRepresentation, O_WRONLY | O_CREAT | O_TRUNC, 0644);
+        expect(fd).to.beGreaterThanOrEqualTo(0);
+        
+        MKNodeSerializer *serializer = [[MKNodeSerializer alloc] initWithFileDescriptor:fd format:MKNodeSerializationFormatJSON options:MKNodeSerializationOptionWarnings];
+        expect([serializer serializeNode:macho error:&error]).to.beTruthy();
+        expect(error).to.beNil();
+        close(fd);
+        
+        NSData *json = [NSData dataWithContentsOfURL:jsonURL];
+        NSDictionary *root = [NSJSONSerialization JSONObjectWithData:json options:0 error:&error];
+        expect(root[@"$class"]).to.equal(NSStringFromClass(macho.class));
+        expect([root[@"loadCommands"] count]).to.equal(macho.loadCommands.count);
+        
+        NSMutableData *cbor = [NSMutableData data];
+        serializer = [[MKNodeSerializer alloc] initWithMutableData:cbor format:MKNodeSerializationFormatCBOR options:MKNodeSerializationOptionNone];
+        expect([serializer serializeNode:macho error:&error]).to.beTruthy();
+        expect(cbor.length).to.beGreaterThan(0);
+        expect(cbor.length).to.beLessThan(json.length);
+    });
+    
+    it(@"should serialize a re-export next to a regular export", ^{
+        // The layout of a terminal node depends on its flags.  The first
+        // exports are re-exports, so a plan compiled for the first terminal
+        // node must not be reused for the rest.
+        NSError *error = nil;
+        NSMutableData *json = [NSMutableData data];
+        MKNodeSerializer *serializer = [[MKNodeSerializer alloc] initWithMutableData:json format:MKNodeSerializationFormatJSON options:MKNodeSerializationOptionNone];
+        expect([serializer serializeNode:macho.exportsInfo.value error:&error]).to.beTruthy();
+        
+        NSDictionary *root = [NSJSONSerialization JSONObjectWithData:json options:0 error:&error];
+        expect(root).toNot.beNil();
+        
+        NSUInteger reExportNodes = 0, regularNodes = 0;
+        for (NSDictionary *node in root[@"nodes"]) {
+            if ([node[@"$class"] isEqual:NSStringFromClass(MKExportTrieTerminalNode.class)] == NO) continue;
+            
+            if ([node[@"flags"] unsignedLongLongValue] & EXPORT_SYMBOL_FLAGS_REEXPORT) {
+                expect(node[@"ordinal"]).to.equal(@1);
+                expect(node[@"importedName"]).toNot.beNil();
+                expect(node[@"offset"]).to.beNil();
+                reExportNodes++;
+            } else {
+                expect(node[@"offset"]).toNot.beNil();
+                expect(node[@"ordinal"]).to.beNil();
+                regularNodes++;
+            }
+        }
+        expect(reExportNodes).to.equal(4);
+        expect(regularNodes).to.beGreaterThan(0);
+        
+        NSUInteger reExports = 0, regularExports = 0;
+        for (NSDictionary *export in root[@"exports"]) {
+            if ([export[@"$class"] isEqual:NSStringFromClass(MKReExport.class)]) {
+                expect(export[@"sourceLibraryOrdinal"]).to.equal(@1);
+                expect(export[@"address"]).to.beNil();
+                reExports++;
+            } else {
+                expect(export[@"address"]).toNot.beNil();
+                expect(export[@"sourceLibraryOrdinal"]).to.beNil();
+                regularExports++;
+            }
+        }
+        expect(reExports).to.equal(4);
+        expect(regularExports).to.beGreaterThan(0);
+    });
+});
+
+SpecEnd
@@ -0,0 +1,79 @@
+//----------------------------------------------------------------------------//
+//|
+//|             MachOKit - A Lightweight Mach-O Parsing Library
+//|             MKObjCMetadataSpec.m
+//|
+//|             D.V.
+//|             Copyright (c) 2014-2015 D.V. All rights reserved.
+//|
+//| Permission is hereby granted, free of charge, to any person obtaining a
+//| copy of this software and associated documentation files (the "Software"),
+//| to deal in the Software without restriction, including without limitation
+//| the rights to use, copy, modify, merge, publish, distribute, sublicense,
+//| and/or sell copies of the Software, and to permit persons to whom the
+//| Software is furnished to do so, subject to the following conditions:
+//|
+//| The above copyright notice and this permission notice shall be included
+//| in all copies or substantial portions of the Software.
+//|
+//| THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+//| OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+//| MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+//| IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+//| CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+//| TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+//| SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+//----------------------------------------------------------------------------//
+
+#include <mach-o/fixup-chains.h>
+
+SpecBegin(MKObjCMetadata)
+
+describe(@"an image with chained fixups", ^{
+    SyntheticMachOFixture *fixture = [SyntheticMachOFixture fixtureWithName:@"MKObjCMetadata"];
+    
+    MKMachOImage* (^loadImage)(SyntheticMachOConfiguration*, NSString*) = ^MKMachOImage* (SyntheticMachOConfiguration *configuration, NSString *name) {
+        NSError *error = nil;
+        MKMachOImage *image = [fixture imageWithConfiguration:configuration name:name error:&error];
+        expect(image).toNot.beNil();
+        expect(error).to.beNil();
+        return image;
+    };
+    
+    NSDictionary<NSString*, NSNumber*> *formats = @{
+        @"DYLD_CHAINED_PTR_64": @(DYLD_CHAINED_PTR_64),
+        @"DYLD_CHAINED_PTR_64_OFFSET": @(DYLD_CHAINED_PTR_64_OFFSET),
+        @"DYLD_CHAINED_PTR_ARM64E": @(DYLD_CHAINED_PTR_ARM64E),
+        @"DYLD_CHAINED_PTR_ARM64E_USERLAND": @(DYLD_CHAINED_PTR_ARM64E_USERLAND)
+    };
+    
+    for (NSString *formatName in formats)
+    it([NSString stringWithFormat:@"should decode %@ pointers like the rebased image", formatName], ^{
+        SyntheticMachOConfiguration *configuration = [SyntheticMachOConfiguration configurationWithScale:1];
+        configuration.objcClassCount = 600; // More than one page of __objc_data.
+        MKMachOImage *expected = loadImage(configuration, @"libRebased.dylib");
+        
+        configuration.chainedPointerFormat = formats[formatName].unsignedShortValue;
+        MKMachOImage *chained = loadImage(configuration, [NSString stringWithFormat:@"libChained-%@.dylib", formatName]);
+        
+        MKObjCMetadata *expectedMetadata = expected.objcMetadata.value;
+        MKObjCMetadata *metadata = chained.objcMetadata.value;
+        expect(metadata).toNot.beNil();
+        expect(metadata.classCount).to.equal(configuration.objcClassCount);
+        expect(metadata.classCount).to.equal(expectedMetadata.classCount);
+        
+        for (NSUInteger i = 0; i < metadata.classCount && i < expectedMetadata.classCount; i++) {
+            const MKObjCClassRecord *record = &metadata.classes[i];
+            const MKObjCClassRecord *expectedRecord = &expectedMetadata.classes[i];
+            
+            expect(record->address).to.equal(expectedRecord->address);
+            expect(record->metaClassAddress).to.equal(expectedRecord->metaClassAddress);
+            expect(record->superClassAddress).to.equal(expectedRecord->superClassAddress);
+            expect(record->dataAddress).to.equal(expectedRecord->dataAddress);
+            expect(record->name ? @(record->name) : nil).to.equal(expectedRecord->name ? @(expectedRecord->name) : nil);
+            expect(record->instanceSize).to.equal(expectedRecord->instanceSize);
+        }
+    });
+});
+
+SpecEnd
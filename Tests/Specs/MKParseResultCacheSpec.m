@@ -0,0 +1,219 @@
+//----------------------------------------------------------------------------//
+//|
+//|             MachOKit - A Lightweight Mach-O Parsing Library
+//|             MKParseResultCacheSpec.m
+//|
+//|             D.V.
+//|             Copyright (c) 2014-2015 D.V. All rights reserved.
+//|
+//| Permission is hereby granted, free of charge, to any person obtaining a
+//| copy of this software and associated documentation files (the "Software"),
+//| to deal in the Software without restriction, including without limitation
+//| the rights to use, copy, modify, merge, publish, distribute, sublicense,
+//| and/or sell copies of the Software, and to permit persons to whom the
+//| Software is furnished to do so, subject to the following conditions:
+//|
+//| The above copyright notice and this permission notice shall be included
+//| in all copies or substantial portions of the Software.
+//|
+//| THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+//| OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+//| MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+//| IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+//| CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+//| TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+//| SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+//----------------------------------------------------------------------------//
+
+#import <MachOKit/_MKParseResultCache.h>
+#include <libkern/OSByteOrder.h>
+
+SpecBegin(MKParseResultCache)
+
+describe(@"a synthetic image", ^{
+    SyntheticMachOFixture *fixture = [SyntheticMachOFixture fixtureWithName:@"MKParseResultCache"];
+    NSURL *imageURL = [fixture URLForFileWithName:@"libParseResults.dylib"];
+    
+    __block SyntheticMachOConfiguration *configuration;
+    
+    MKMachOImage* (^loadImage)(void) = ^MKMachOImage* {
+        MKMachOImage *macho = [fixture imageWithName:imageURL.lastPathComponent error:NULL];
+        expect(macho).toNot.beNil();
+        return macho;
+    };
+    
+    beforeAll(^{
+        configuration = [SyntheticMachOConfiguration configurationWithScale:1];
+        expect([fixture imageWithConfiguration:configuration name:imageURL.lastPathComponent error:NULL]).toNot.beNil();
+    });
+    
+    // Returns the cache file in cacheURL.
+    NSURL* (^cacheFileIn)(NSURL*) = ^NSURL* (NSURL *cacheURL) {
+        NSArray<NSURL*> *files = [[NSFileManager defaultManager] contentsOfDirectoryAtURL:cacheURL includingPropertiesForKeys:nil options:0 error:NULL];
+        files = [files filteredArrayUsingPredicate:[NSPredicate predicateWithFormat:@"pathExtension == 'mkresults'"]];
+        expect(files.count).to.equal(1);
+        return files.firstObject;
+    };
+    
+    BOOL (^sameString)(const char*, const char*) = ^BOOL (const char *a, const char *b) {
+        return (a == NULL || b == NULL) ? a == b : strcmp(a, b) == 0;
+    };
+    
+    it(@"should rehydrate cached parse results", ^{
+        for (NSNumber *options in @[@(MKParseResultCacheOptionNone), @(MKParseResultCacheOptionContentHashes)]) {
+            NSURL *cacheURL = [fixture URLForFileWithName:[NSString stringWithFormat:@"ParseResults-%@", options]];
+            MKParseResultCache *cache = [[MKParseResultCache alloc] initWithDirectoryURL:cacheURL options:options.unsignedIntegerValue];
+            
+            for (NSUInteger pass = 0; pass < 2; pass++) {
+                NSError *error = nil;
+                MKParseResults *results = [cache resultsForImage:loadImage() subsystems:MKParseResultSubsystemAll error:&error];
+                
+                expect(results).toNot.beNil();
+                expect(results.errors.count).to.equal(0);
+                expect(results.subsystems).to.equal(MKParseResultSubsystemAll);
+                expect(results.rehydratedSubsystems).to.equal(pass ? MKParseResultSubsystemAll : MKParseResultSubsystemNone);
+                
+                expect(results.symbolCount).to.equal(configuration.symbolCount + configuration.bindCount);
+                expect(results.exportCount).to.equal(configuration.symbolCount);
+                expect(results.fixupCount).to.beGreaterThanOrEqualTo(configuration.rebaseCount + configuration.bindCount);
+                expect(results.objcRecordCount).to.beGreaterThanOrEqualTo(configuration.objcClassCount);
+            }
+        }
+    });
+    
+    it(@"should rehydrate the records it parsed", ^{
+        NSURL *cacheURL = [fixture URLForFileWithName:@"ParseResults-Equal"];
+        MKParseResultCache *cache = [[MKParseResultCache alloc] initWithDirectoryURL:cacheURL options:MKParseResultCacheOptionNone];
+        
+        MKParseResults *parsed = [cache resultsForImage:loadImage() subsystems:MKParseResultSubsystemAll error:NULL];
+        MKParseResults *rehydrated = [cache resultsForImage:loadImage() subsystems:MKParseResultSubsystemAll error:NULL];
+        expect(parsed.rehydratedSubsystems).to.equal(MKParseResultSubsystemNone);
+        expect(rehydrated.rehydratedSubsystems).to.equal(MKParseResultSubsystemAll);
+        
+        expect(rehydrated.symbolCount).to.equal(parsed.symbolCount);
+        for (NSUInteger i = 0; i < parsed.symbolCount; i++) {
+            const MKParseResultSymbol *a = &parsed.symbols[i], *b = &rehydrated.symbols[i];
+            expect(sameString(a->name, b->name)).to.beTruthy();
+            expect(b->value).to.equal(a->value);
+            expect(b->type).to.equal(a->type);
+            expect(b->sect).to.equal(a->sect);
+            expect(b->desc).to.equal(a->desc);
+        }
+        
+        expect(rehydrated.exportCount).to.equal(parsed.exportCount);
+        for (NSUInteger i = 0; i < parsed.exportCount; i++) {
+            const MKParseResultExport *a = &parsed.exports[i], *b = &rehydrated.exports[i];
+            expect(sameString(a->name, b->name)).to.beTruthy();
+            expect(sameString(a->importedName, b->importedName)).to.beTruthy();
+            expect(b->address).to.equal(a->address);
+            expect(b->sourceLibraryOrdinal).to.equal(a->sourceLibraryOrdinal);
+            expect(b->options).to.equal(a->options);
+            expect(b->kind).to.equal(a->kind);
+        }
+        
+        expect(rehydrated.fixupCount).to.equal(parsed.fixupCount);
+        for (NSUInteger i = 0; i < parsed.fixupCount; i++) {
+            const MKParseResultFixup *a = &parsed.fixups[i], *b = &rehydrated.fixups[i];
+            expect(b->address).to.equal(a->address);
+            expect(sameString(a->symbolName, b->symbolName)).to.beTruthy();
+            expect(b->libraryOrdinal).to.equal(a->libraryOrdinal);
+            expect(b->addend).to.equal(a->addend);
+            expect(b->kind).to.equal(a->kind);
+            expect(b->type).to.equal(a->type);
+            expect(b->symbolFlags).to.equal(a->symbolFlags);
+        }
+        
+        expect(rehydrated.objcRecordCount).to.equal(parsed.objcRecordCount);
+        for (NSUInteger i = 0; i < parsed.objcRecordCount; i++) {
+            const MKParseResultObjCRecord *a = &parsed.objcRecords[i], *b = &rehydrated.objcRecords[i];
+            expect(b->address).to.equal(a->address);
+            expect(sameString(a->name, b->name)).to.beTruthy();
+            expect(b->relatedAddress).to.equal(a->relatedAddress);
+            expect(b->instanceMethodCount).to.equal(a->instanceMethodCount);
+            expect(b->classMethodCount).to.equal(a->classMethodCount);
+            expect(b->protocolCount).to.equal(a->protocolCount);
+            expect(b->kind).to.equal(a->kind);
+        }
+    });
+    
+    it(@"should only parse the subsystems whose bytes changed", ^{
+        NSURL *cacheURL = [fixture URLForFileWithName:@"ParseResults-Changed"];
+        MKParseResultCache *cache = [[MKParseResultCache alloc] initWithDirectoryURL:cacheURL options:MKParseResultCacheOptionContentHashes];
+        
+        MKMachOImage *macho = loadImage();
+        expect([cache resultsForImage:macho subsystems:MKParseResultSubsystemAll error:NULL].rehydratedSubsystems).to.equal(MKParseResultSubsystemNone);
+        
+        // Rename the first symbol in the string table.  Only the symbol
+        // table reads the string table.
+        MKLCSymtab *symtab = [macho loadCommandsOfType:LC_SYMTAB].firstObject;
+        NSData *original = [NSData dataWithContentsOfURL:imageURL];
+        NSMutableData *modified = [original mutableCopy];
+        uint32_t strx = OSReadLittleInt32(modified.bytes, symtab.symoff);
+        ((char*)modified.mutableBytes)[symtab.stroff + strx + 1] = 't';
+        expect([modified writeToURL:imageURL atomically:YES]).to.beTruthy();
+        
+        MKParseResults *results = [cache resultsForImage:loadImage() subsystems:MKParseResultSubsystemAll error:NULL];
+        expect(results.errors.count).to.equal(0);
+        expect(results.rehydratedSubsystems).to.equal(MKParseResultSubsystemAll & ~MKParseResultSubsystemSymbols);
+        expect(results.symbols[0].name[1]).to.equal('t');
+        
+        expect([original writeToURL:imageURL atomically:YES]).to.beTruthy();
+    });
+    
+    it(@"should parse again when the cache file is truncated", ^{
+        NSURL *cacheURL = [fixture URLForFileWithName:@"ParseResults-Truncated"];
+        MKParseResultCache *cache = [[MKParseResultCache alloc] initWithDirectoryURL:cacheURL options:MKParseResultCacheOptionNone];
+        [cache resultsForImage:loadImage() subsystems:MKParseResultSubsystemAll error:NULL];
+        
+        NSURL *fileURL = cacheFileIn(cacheURL);
+        NSData *file = [NSData dataWithContentsOfURL:fileURL];
+        expect([[file subdataWithRange:NSMakeRange(0, file.length / 2)] writeToURL:fileURL atomically:YES]).to.beTruthy();
+        
+        MKParseResults *results = [cache resultsForImage:loadImage() subsystems:MKParseResultSubsystemAll error:NULL];
+        expect(results.errors.count).to.equal(0);
+        expect(results.rehydratedSubsystems).to.equal(MKParseResultSubsystemNone);
+        expect(results.symbolCount).to.equal(configuration.symbolCount + configuration.bindCount);
+        
+        // The file was rewritten.
+        expect([cache resultsForImage:loadImage() subsystems:MKParseResultSubsystemAll error:NULL].rehydratedSubsystems).to.equal(MKParseResultSubsystemAll);
+    });
+    
+    it(@"should parse again a subsystem whose records are corrupt", ^{
+        NSURL *cacheURL = [fixture URLForFileWithName:@"ParseResults-Corrupt"];
+        MKParseResultCache *cache = [[MKParseResultCache alloc] initWithDirectoryURL:cacheURL options:MKParseResultCacheOptionNone];
+        [cache resultsForImage:loadImage() subsystems:MKParseResultSubsystemAll error:NULL];
+        
+        // Point the name of the first symbol outside of the string pool.
+        NSURL *fileURL = cacheFileIn(cacheURL);
+        NSMutableData *file = [NSMutableData dataWithContentsOfURL:fileURL];
+        const struct mk_parse_result_cache_header *header = file.bytes;
+        const struct mk_parse_result_cache_subsystem *entries = (const void*)(header + 1);
+        for (uint32_t i = 0; i < header->subsystemCount; i++) {
+            if (entries[i].subsystem != MKParseResultSubsystemSymbols) continue;
+            struct mk_parse_result_symbol *symbol = (void*)((uint8_t*)file.mutableBytes + entries[i].recordsOffset);
+            symbol->name = entries[i].stringsSize + 1;
+        }
+        expect([file writeToURL:fileURL atomically:YES]).to.beTruthy();
+        
+        MKParseResults *results = [cache resultsForImage:loadImage() subsystems:MKParseResultSubsystemAll error:NULL];
+        expect(results.errors.count).to.equal(0);
+        expect(results.rehydratedSubsystems).to.equal(MKParseResultSubsystemAll & ~MKParseResultSubsystemSymbols);
+        expect(results.symbols[0].name).toNot.beNil();
+    });
+    
+    it(@"should report a cache that can not be written", ^{
+        // A file where the cache directory should be.
+        NSURL *cacheURL = [fixture URLForFileWithName:@"ParseResults-Unwritable"];
+        expect([[NSData data] writeToURL:cacheURL atomically:YES]).to.beTruthy();
+        MKParseResultCache *cache = [[MKParseResultCache alloc] initWithDirectoryURL:cacheURL options:MKParseResultCacheOptionNone];
+        
+        NSError *error = nil;
+        MKParseResults *results = [cache resultsForImage:loadImage() subsystems:MKParseResultSubsystemAll error:&error];
+        expect(results).toNot.beNil();
+        expect(error).to.beNil();
+        expect(results.subsystems).to.equal(MKParseResultSubsystemAll);
+        expect(results.writeError).toNot.beNil();
+    });
+});
+
+SpecEnd
@@ -0,0 +1,187 @@
+//----------------------------------------------------------------------------//
+//|
+//|             MachOKit - A Lightweight Mach-O Parsing Library
+//|             MKPtrSpec.m
+//|
+//|             D.V.
+//|             Copyright (c) 2014-2015 D.V. All rights reserved.
+//|
+//| Permission is hereby granted, free of charge, to any person obtaining a
+//| copy of this software and associated documentation files (the "Software"),
+//| to deal in the Software without restriction, including without limitation
+//| the rights to use, copy, modify, merge, publish, distribute, sublicense,
+//| and/or sell copies of the Software, and to permit persons to whom the
+//| Software is furnished to do so, subject to the following conditions:
+//|
+//| The above copyright notice and this permission notice shall be included
+//| in all copies or substantial portions of the Software.
+//|
+//| THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+//| OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+//| MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+//| IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+//| CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+//| TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+//| SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+//----------------------------------------------------------------------------//
+
+//----------------------------------------------------------------------------//
+//! A pointer that resolves its pointee as soon as it is initialized, as the
+//! nodes of some metadata structures do.
+//
+@interface MKEagerPointerNode : MKPointerNode
+@property (nonatomic, strong, readonly) MKResult *resolvedPointee;
+@end
+
+@implementation MKEagerPointerNode
+
+- (instancetype)initWithOffset:(mk_vm_offset_t)offset fromParent:(MKBackedNode*)parent error:(NSError**)error
+{
+    self = [super initWithOffset:offset fromParent:parent targetClass:MKEagerPointerNode.class error:error];
+    if (self == nil) return nil;
+    
+    _resolvedPointee = self.pointee;
+    
+    return self;
+}
+
+@end
+
+SpecBegin(MKPtr)
+
+describe(@"the pointee cache", ^{
+    SyntheticMachOFixture *fixture = [SyntheticMachOFixture fixtureWithName:@"MKPtr"];
+    
+    MKMachOImage* (^loadImage)(void) = ^MKMachOImage* {
+        MKMachOImage *macho = [fixture imageWithName:@"libPointers.dylib" error:NULL];
+        expect(macho).toNot.beNil();
+        return macho;
+    };
+    
+    // The class and metaclass data of each synthetic class point at the same
+    // name in __TEXT.  Both name pointers are resolved from the image, so
+    // they share a cache entry.
+    NSArray<MKObjCClassData*>* (^classDatas)(MKMachOImage*) = ^NSArray<MKObjCClassData*>* (MKMachOImage *macho) {
+        NSMutableArray<MKObjCClassData*> *datas = [NSMutableArray array];
+        for (MKSection *section in macho.sections.allValues) {
+            if ([section isKindOfClass:MKObjCClassListSection.class] == NO) continue;
+            
+            for (MKPointerNode *ptr in section.elements) {
+                MKObjCClass *cls = ptr.pointee.value;
+                MKObjCClass *metaClass = cls.metaClass.pointee.value;
+                expect(cls.classData.pointee.value).toNot.beNil();
+                expect(metaClass.classData.pointee.value).toNot.beNil();
+                if (cls.classData.pointee.value == nil || metaClass.classData.pointee.value == nil) continue;
+                
+                [datas addObject:cls.classData.pointee.value];
+                [datas addObject:metaClass.classData.pointee.value];
+            }
+        }
+        return datas;
+    };
+    
+    beforeAll(^{
+        SyntheticMachOConfiguration *configuration = [SyntheticMachOConfiguration configurationWithScale:1];
+        expect([fixture imageWithConfiguration:configuration name:@"libPointers.dylib" error:NULL]).toNot.beNil();
+    });
+    
+    it(@"should return the cached pointee for another pointer to the same address", ^{
+        MKMachOImage *macho = loadImage();
+        NSArray<MKObjCClassData*> *datas = classDatas(macho);
+        expect(datas.count).to.beGreaterThan(0);
+        
+        for (NSUInteger i = 0; i + 1 < datas.count; i += 2) {
+            MKPointer *name = datas[i].name;
+            MKPointer *metaClassName = datas[i + 1].name;
+            expect(name).toNot.beIdenticalTo(metaClassName);
+            expect(name.address).to.equal(metaClassName.address);
+            
+            MKCString *string = name.pointee.value;
+            expect(string).toNot.beNil();
+            expect(metaClassName.pointee.value).to.beIdenticalTo(string);
+        }
+    });
+    
+    it(@"should resolve one pointee when pointers to it are resolved concurrently", ^{
+        MKMachOImage *macho = loadImage();
+        NSArray<MKObjCClassData*> *datas = classDatas(macho);
+        NSUInteger count = datas.count;
+        expect(count).to.beGreaterThan(0);
+        
+        __unsafe_unretained MKCString **strings = (__unsafe_unretained MKCString**)calloc(count, sizeof(MKCString*));
+        
+        // Resolve the class and metaclass names in an interleaved order from
+        // several threads, so that both pointers of a pair race each other.
+        dispatch_apply(count, dispatch_get_global_queue(QOS_CLASS_USER_INITIATED, 0), ^(size_t i) {
+            size_t index = (i % 2) ? count - i : i;
+            strings[index] = datas[index].name.pointee.value;
+        });
+        
+        for (NSUInteger i = 0; i + 1 < count; i += 2) {
+            expect(strings[i]).toNot.beNil();
+            expect(strings[i + 1]).to.beIdenticalTo(strings[i]);
+        }
+        
+        free(strings);
+    });
+    
+    it(@"should release cached pointees when the image is deallocated", ^{
+        __weak MKCString *weakString = nil;
+        __weak MKMachOImage *weakImage = nil;
+        
+        @autoreleasepool {
+            MKMachOImage *macho = loadImage();
+            weakImage = macho;
+            
+            NSArray<MKObjCClassData*> *datas = classDatas(macho);
+            expect(datas.count).to.beGreaterThan(0);
+            weakString = datas.firstObject.name.pointee.value;
+            expect(weakString).toNot.beNil();
+        }
+        
+        expect(weakImage).to.beNil();
+        expect(weakString).to.beNil();
+    });
+});
+
+describe(@"a self-referential pointer", ^{
+    SyntheticMachOFixture *fixture = [SyntheticMachOFixture fixtureWithName:@"MKPtrSelfReference"];
+    
+    it(@"should stop resolving nested pointees once the budget is exceeded", ^{
+        NSError *error = nil;
+        SyntheticMachOConfiguration *configuration = [SyntheticMachOConfiguration configurationWithScale:1];
+        NSMutableData *contents = [[SyntheticMachO machOWithConfiguration:configuration baseAddress:0 fileOffset:0] mutableCopy];
+        MKMachOImage *macho = [fixture imageWithContents:contents name:@"libSelfReference.dylib" error:&error];
+        MKSection *data = [macho sectionWithName:@SECT_DATA inSegmentWithName:@SEG_DATA];
+        expect(data).to.beKindOf(MKDataSection.class);
+        if (data == nil) return;
+        
+        // Point the first pointer in __data at itself.  The image is linked
+        // at address 0, so its file offsets are its VM addresses.
+        uint64_t address = data.vmAddress;
+        [contents replaceBytesInRange:NSMakeRange((NSUInteger)data.fileOffset, sizeof(address)) withBytes:&address];
+        expect([contents writeToURL:[fixture URLForFileWithName:@"libSelfReference.dylib"] options:NSDataWritingAtomic error:&error]).to.beTruthy();
+        
+        macho = [fixture imageWithName:@"libSelfReference.dylib" budget:(mk_context_budget_t){ .max_nodes = 16 } error:&error];
+        expect(macho).toNot.beNil();
+        
+        data = [macho sectionWithName:@SECT_DATA inSegmentWithName:@SEG_DATA];
+        
+        // Every pointee is a new node whose pointer is resolved while it is
+        // initialized, until the resolutions exceed the budget.
+        MKEagerPointerNode *node = [data childNodeAtVMAddress:address targetClass:MKEagerPointerNode.class].value;
+        expect(node).toNot.beNil();
+        
+        NSUInteger depth = 0;
+        while (node.resolvedPointee.value) {
+            expect(node.address).to.equal(address);
+            node = node.resolvedPointee.value;
+            depth++;
+        }
+        
+        expect(depth).to.equal(16);
+        expect(node.resolvedPointee.error.code).to.equal(MK_EBUDGET_EXCEEDED);
+    });
+});
+
+SpecEnd
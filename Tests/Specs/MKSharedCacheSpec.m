@@ -27,6 +27,172 @@
 
 SpecBegin(MKSharedCache)
 {
+    describe(@"a synthetic shared cache", ^{
+        SyntheticMachOFixture *fixture = [SyntheticMachOFixture fixtureWithName:@"MKSharedCache"];
+        NSURL *cacheURL = [fixture URLForFileWithName:@"dyld_shared_cache_arm64"];
+        NSUInteger imageCount = 8;
+        
+        beforeAll(^{
+            NSError *error = nil;
+            SyntheticMachOConfiguration *configuration = [SyntheticMachOConfiguration configurationWithScale:1];
+            expect([SyntheticMachO writeSharedCacheWithConfiguration:configuration imageCount:imageCount subCacheCount:2 toURL:cacheURL error:&error]).to.beTruthy();
+            expect(error).to.beNil();
+        });
+        
+        it(@"should extract the same images in parallel as serially", ^{
+            MKSharedCache *sharedCache = [[MKSharedCache alloc] initWithFlags:0 url:cacheURL];
+            expect(sharedCache).toNot.beNil();
+            
+            NSFileManager *fileManager = [NSFileManager defaultManager];
+            NSURL *serialURL = [fixture URLForFileWithName:@"serial"];
+            NSURL *parallelURL = [fixture URLForFileWithName:@"parallel"];
+            [fileManager createDirectoryAtURL:serialURL withIntermediateDirectories:YES attributes:nil error:NULL];
+            [fileManager createDirectoryAtURL:parallelURL withIntermediateDirectories:YES attributes:nil error:NULL];
+            
+            expect([sharedCache extractImagesToPath:serialURL.path workerCount:1]).to.equal(imageCount);
+            expect([sharedCache extractImagesToPath:parallelURL.path workerCount:4]).to.equal(imageCount);
+            
+            // Images that share a file name are written to their own install
+            // paths.
+            NSMutableArray<NSString*> *names = [NSMutableArray array];
+            for (NSString *name in [fileManager subpathsOfDirectoryAtPath:serialURL.path error:NULL]) {
+                if ([name.pathExtension isEqualToString:@"dylib"])
+                    [names addObject:name];
+            }
+            expect(names.count).to.equal(imageCount);
+            expect(names).to.contain(@"usr/lib/synthetic/libSynthetic00000.dylib");
+            expect(names).to.contain(@"System/iOSSupport/usr/lib/synthetic/libSynthetic00000.dylib");
+            
+            for (NSString *name in names) {
+                NSData *serial = [NSData dataWithContentsOfURL:[serialURL URLByAppendingPathComponent:name]];
+                NSData *parallel = [NSData dataWithContentsOfURL:[parallelURL URLByAppendingPathComponent:name]];
+                expect(serial.length).to.beGreaterThan(0);
+                expect([serial isEqualToData:parallel]).to.beTruthy();
+                
+                // The extracted image must stand on its own.
+                NSError *error = nil;
+                MKMachOImage *macho = [fixture imageWithName:[@"serial" stringByAppendingPathComponent:name] error:&error];
+                expect(macho).toNot.beNil();
+                expect(macho.symbolTable.value.symbols.count).to.beGreaterThan(0);
+            }
+            
+            // Extracting again over the same files writes nothing.
+            expect([sharedCache extractImagesToPath:serialURL.path workerCount:4]).to.equal(0);
+        });
+        
+        it(@"should symbolicate the same after evicting per-image tables", ^{
+            MKSharedCache *sharedCache = [[MKSharedCache alloc] initWithFlags:0 url:cacheURL];
+            NSMutableArray<NSNumber*> *addresses = [NSMutableArray array];
+            for (uint64_t i = 0; i < sharedCache.dsc->containedImageCount; i++) {
+                DyldSharedCacheImage *image = &sharedCache.dsc->containedImages[i];
+                for (uint64_t offset = 0; offset < image->size; offset += 256)
+                    [addresses addObject:@(image->address + offset)];
+            }
+            
+            MKSymbolicator *unbounded = [[MKSymbolicator alloc] initWithImages:@[] sharedCache:sharedCache];
+            MKSymbolicator *bounded = [[MKSymbolicator alloc] initWithImages:@[] sharedCache:sharedCache];
+            bounded.cacheLimit = 2;
+            NSArray<MKSymbolication*> *expected = [unbounded symbolicateAddresses:addresses];
+            
+            // Each batch touches every image, so all but the last two tables
+            // are rebuilt for the second batch.
+            for (NSUInteger batch = 0; batch < 2; batch++) {
+                NSArray<MKSymbolication*> *found = [bounded symbolicateAddresses:addresses];
+                for (NSUInteger i = 0; i < addresses.count; i++) {
+                    expect(found[i].image).to.equal(expected[i].image);
+                    expect(found[i].symbolAddress).to.equal(expected[i].symbolAddress);
+                    expect(found[i].symbolName).to.equal(expected[i].symbolName);
+                    expect(found[i].source).to.equal(expected[i].source);
+                }
+            }
+            expect([expected filteredArrayUsingPredicate:[NSPredicate predicateWithFormat:@"symbolName != nil"]].count).to.beGreaterThan(0);
+        });
+        
+        describe(@"with an index", ^{
+            NSURL *indexURL = [fixture URLForFileWithName:@"index"];
+            __block NSURL *indexFileURL;
+            __block NSData *indexData;
+            
+            // Opens the cache with an index and checks that every lookup
+            // matches the unindexed cache.
+            void (^checkIndexedLookups)(void) = ^{
+                MKSharedCache *plain = [[MKSharedCache alloc] initWithFlags:0 url:cacheURL];
+                MKSharedCache *indexed = [[MKSharedCache alloc] initWithFlags:0 url:cacheURL indexURL:indexURL];
+                expect(plain).toNot.beNil();
+                expect(indexed).toNot.beNil();
+                expect(plain.dsc->index == NULL).to.beTruthy();
+                expect(indexed.dsc->index != NULL).to.beTruthy();
+                expect(indexed.dsc->containedImageCount).to.equal(plain.dsc->containedImageCount);
+                
+                for (uint64_t i = 0; i < plain.dsc->containedImageCount; i++) {
+                    DyldSharedCacheImage *image = &plain.dsc->containedImages[i];
+                    expect(strcmp(indexed.dsc->containedImages[i].path, image->path)).to.equal(0);
+                    
+                    uint64_t addresses[] = { image->address - 1, image->address, image->address + image->size / 2, image->endAddr - 1, image->endAddr };
+                    for (size_t j = 0; j < sizeof(addresses)/sizeof(addresses[0]); j++) {
+                        DyldSharedCacheImage *expected = dsc_lookup_image_by_address(plain.dsc, addresses[j]);
+                        DyldSharedCacheImage *found = dsc_lookup_image_by_address(indexed.dsc, addresses[j]);
+                        expect(found ? (int64_t)found->index : -1).to.equal(expected ? (int64_t)expected->index : -1);
+                    }
+                    
+                    expect(dsc_lookup_image_by_vmaddr(indexed.dsc, image->address)->index).to.equal(i);
+                    expect(dsc_lookup_image_by_vmaddr(indexed.dsc, image->address + 1) == NULL).to.beTruthy();
+                    expect(dsc_lookup_image_by_path(indexed.dsc, image->path)->index).to.equal(i);
+                }
+                expect(dsc_lookup_image_by_path(indexed.dsc, "/usr/lib/synthetic/missing.dylib") == NULL).to.beTruthy();
+                
+                // Symbolicating against either cache gives the same answers.
+                NSMutableArray<NSNumber*> *addresses = [NSMutableArray array];
+                for (uint64_t i = 0; i < plain.dsc->containedImageCount; i++) {
+                    DyldSharedCacheImage *image = &plain.dsc->containedImages[i];
+                    for (uint64_t offset = 0; offset < image->size; offset += 64)
+                        [addresses addObject:@(image->address + offset)];
+                }
+                NSArray<MKSymbolication*> *expected = [[[MKSymbolicator alloc] initWithImages:@[] sharedCache:plain] symbolicateAddresses:addresses];
+                NSArray<MKSymbolication*> *found = [[[MKSymbolicator alloc] initWithImages:@[] sharedCache:indexed] symbolicateAddresses:addresses];
+                for (NSUInteger i = 0; i < addresses.count; i++) {
+                    expect(found[i].symbolAddress).to.equal(expected[i].symbolAddress);
+                    expect(found[i].symbolName).to.equal(expected[i].symbolName);
+                }
+            };
+            
+            it(@"should write an index and look images up through it", ^{
+                [[NSFileManager defaultManager] removeItemAtURL:indexURL error:NULL];
+                [[NSFileManager defaultManager] createDirectoryAtURL:indexURL withIntermediateDirectories:YES attributes:nil error:NULL];
+                
+                // The first open writes the index, the second loads it.
+                expect([[MKSharedCache alloc] initWithFlags:0 url:cacheURL indexURL:indexURL]).toNot.beNil();
+                NSArray<NSURL*> *contents = [[NSFileManager defaultManager] contentsOfDirectoryAtURL:indexURL includingPropertiesForKeys:nil options:0 error:NULL];
+                expect(contents.count).to.equal(1);
+                indexFileURL = contents.firstObject;
+                expect(indexFileURL.pathExtension).to.equal(@"dscindex");
+                indexData = [NSData dataWithContentsOfURL:indexFileURL];
+                expect(indexData.length).to.beGreaterThan(0);
+                
+                checkIndexedLookups();
+            });
+            
+            it(@"should rewrite a truncated index", ^{
+                [[indexData subdataWithRange:NSMakeRange(0, indexData.length / 2)] writeToURL:indexFileURL atomically:YES];
+                checkIndexedLookups();
+                expect([[NSData dataWithContentsOfURL:indexFileURL] isEqualToData:indexData]).to.beTruthy();
+            });
+            
+            it(@"should rewrite an index built from other cache files", ^{
+                // Change the first recorded file UUID, as if a subcache had
+                // been replaced since the index was written.
+                NSMutableData *stale = [indexData mutableCopy];
+                uint64_t uuidsOffset;
+                [stale getBytes:&uuidsOffset range:NSMakeRange(24, sizeof(uuidsOffset))];
+                ((uint8_t*)stale.mutableBytes)[uuidsOffset] ^= 0xFF;
+                [stale writeToURL:indexFileURL atomically:YES];
+                
+                checkIndexedLookups();
+                expect([[NSData dataWithContentsOfURL:indexFileURL] isEqualToData:indexData]).to.beTruthy();
+            });
+        });
+    });
+    
     const char* path = getenv("MK_SC_TEST_PATH");
     if (path == NULL)
         return;
@@ -0,0 +1,129 @@
+//----------------------------------------------------------------------------//
+//|
+//|             MachOKit - A Lightweight Mach-O Parsing Library
+//|             MKSplitSegmentInfoSpec.m
+//|
+//|             D.V.
+//|             Copyright (c) 2014-2015 D.V. All rights reserved.
+//|
+//| Permission is hereby granted, free of charge, to any person obtaining a
+//| copy of this software and associated documentation files (the "Software"),
+//| to deal in the Software without restriction, including without limitation
+//| the rights to use, copy, modify, merge, publish, distribute, sublicense,
+//| and/or sell copies of the Software, and to permit persons to whom the
+//| Software is furnished to do so, subject to the following conditions:
+//|
+//| The above copyright notice and this permission notice shall be included
+//| in all copies or substantial portions of the Software.
+//|
+//| THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+//| OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+//| MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+//| IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+//| CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+//| TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+//| SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+//----------------------------------------------------------------------------//
+
+SpecBegin(MKSplitSegmentInfo)
+
+describe(@"a synthetic image", ^{
+    SyntheticMachOFixture *fixture = [SyntheticMachOFixture fixtureWithName:@"MKSplitSegmentInfo"];
+    
+    MKMachOImage* (^loadImage)(SyntheticMachOConfiguration*, NSString*, NSData**) = ^MKMachOImage* (SyntheticMachOConfiguration *configuration, NSString *name, NSData **contents) {
+        *contents = [SyntheticMachO machOWithConfiguration:configuration baseAddress:0 fileOffset:0];
+        MKMachOImage *image = [fixture imageWithContents:*contents name:name error:NULL];
+        expect(image).toNot.beNil();
+        return image;
+    };
+    
+    __block SyntheticMachOConfiguration *configuration;
+    
+    beforeAll(^{
+        configuration = [SyntheticMachOConfiguration configurationWithScale:1];
+        configuration.rebaseCount = 300;
+    });
+    
+    it(@"should decode V2 references to their sections and offsets", ^{
+        SyntheticMachOConfiguration *v2Configuration = [configuration copy];
+        v2Configuration.splitSegmentInfoFormat = MKSplitSegmentInfoFormatV2;
+        NSData *contents = nil;
+        MKMachOImage *macho = loadImage(v2Configuration, @"libSplitV2.dylib", &contents);
+        
+        MKSplitSegmentInfo *info = macho.splitSegmentInfo.value;
+        expect(info).toNot.beNil();
+        expect(info.warnings).to.equal(@[]);
+        expect(info.format).to.equal(MKSplitSegmentInfoFormatV2);
+        expect(info.referenceCount).to.equal(v2Configuration.rebaseCount);
+        expect(info.v1).to.beNil();
+        
+        MKSection *textSection = [macho sectionWithName:@SECT_TEXT inSegmentWithName:@SEG_TEXT];
+        MKSection *dataSection = [macho sectionWithName:@SECT_DATA inSegmentWithName:@SEG_DATA];
+        
+        // Every pointer in __data is referenced exactly once, and holds the
+        // address of the referenced __text offset.
+        NSMutableIndexSet *pointers = [NSMutableIndexSet indexSet];
+        for (NSUInteger i = 0; i < info.referenceCount; i++) {
+            const MKSplitSegmentReference *reference = &info.references[i];
+            expect(reference->kind).to.equal(2);
+            // Index 0 is the Mach-O header.
+            expect(macho.sections[@(reference->fromSectionIndex - 1)]).to.equal(dataSection);
+            expect(macho.sections[@(reference->toSectionIndex - 1)]).to.equal(textSection);
+            expect(reference->fromSectionOffset % 8).to.equal(0);
+            expect(reference->fromSectionOffset).to.beLessThan(dataSection.size);
+            expect(reference->toSectionOffset).to.beLessThan(textSection.size);
+            
+            uint64_t pointer;
+            [contents getBytes:&pointer range:NSMakeRange((NSUInteger)(dataSection.fileOffset + reference->fromSectionOffset), sizeof(pointer))];
+            expect(pointer).to.equal(textSection.vmAddress + reference->toSectionOffset);
+            
+            [pointers addIndex:(NSUInteger)(reference->fromSectionOffset / 8)];
+        }
+        expect(pointers.count).to.equal(v2Configuration.rebaseCount);
+    });
+    
+    it(@"should decode V1 references and build the V1 node tree on demand", ^{
+        SyntheticMachOConfiguration *v1Configuration = [configuration copy];
+        v1Configuration.splitSegmentInfoFormat = MKSplitSegmentInfoFormatV1;
+        NSData *contents = nil;
+        MKMachOImage *macho = loadImage(v1Configuration, @"libSplitV1.dylib", &contents);
+        
+        MKSplitSegmentInfo *info = macho.splitSegmentInfo.value;
+        expect(info).toNot.beNil();
+        expect(info.warnings).to.equal(@[]);
+        expect(info.format).to.equal(MKSplitSegmentInfoFormatV1);
+        expect(info.referenceCount).to.equal(v1Configuration.rebaseCount);
+        
+        // V1 references are offsets from the start of the image.
+        MKSection *dataSection = [macho sectionWithName:@SECT_DATA inSegmentWithName:@SEG_DATA];
+        for (NSUInteger i = 0; i < info.referenceCount; i++) {
+            const MKSplitSegmentReference *reference = &info.references[i];
+            expect(reference->kind).to.equal(DYLD_CACHE_ADJ_V1_POINTER_64);
+            expect(reference->fromSectionIndex).to.equal(0);
+            expect(reference->toSectionIndex).to.equal(MKSplitSegmentSectionIndexUnknown);
+            expect(reference->fromSectionOffset).to.equal(dataSection.vmAddress + 8 * i);
+        }
+        
+        // The node tree agrees with the decoded references, and is only
+        // built once.
+        MKSplitSegmentInfoV1 *v1 = info.v1;
+        expect(v1).toNot.beNil();
+        expect(info.v1).to.beIdenticalTo(v1);
+        expect(v1.warnings).to.equal(@[]);
+        expect(v1.fixups.count).to.equal(info.referenceCount);
+        for (NSUInteger i = 0; i < v1.fixups.count; i++) {
+            expect(v1.fixups[i].address).to.equal(info.references[i].fromSectionOffset);
+            expect(v1.fixups[i].kind).to.equal(info.references[i].kind);
+        }
+        expect(info.warnings).to.equal(@[]);
+    });
+    
+    it(@"should not have split segment info unless requested", ^{
+        NSData *contents = nil;
+        MKMachOImage *macho = loadImage(configuration, @"libNoSplit.dylib", &contents);
+        expect(macho.splitSegmentInfo.value).to.beNil();
+        expect(macho.splitSegmentInfo.error).to.beNil();
+    });
+});
+
+SpecEnd
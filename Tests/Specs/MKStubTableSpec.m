@@ -0,0 +1,74 @@
+//----------------------------------------------------------------------------//
+//|
+//|             MachOKit - A Lightweight Mach-O Parsing Library
+//|             MKStubTableSpec.m
+//|
+//|             D.V.
+//|             Copyright (c) 2014-2015 D.V. All rights reserved.
+//|
+//| Permission is hereby granted, free of charge, to any person obtaining a
+//| copy of this software and associated documentation files (the "Software"),
+//| to deal in the Software without restriction, including without limitation
+//| the rights to use, copy, modify, merge, publish, distribute, sublicense,
+//| and/or sell copies of the Software, and to permit persons to whom the
+//| Software is furnished to do so, subject to the following conditions:
+//|
+//| The above copyright notice and this permission notice shall be included
+//| in all copies or substantial portions of the Software.
+//|
+//| THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+//| OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+//| MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+//| IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+//| CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+//| TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+//| SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+//----------------------------------------------------------------------------//
+
+SpecBegin(MKStubTable)
+
+describe(@"a synthetic image", ^{
+    SyntheticMachOFixture *fixture = [SyntheticMachOFixture fixtureWithName:@"MKStubTable"];
+    
+    __block SyntheticMachOConfiguration *configuration;
+    __block MKMachOImage *macho;
+    
+    beforeAll(^{
+        configuration = [SyntheticMachOConfiguration configurationWithScale:1];
+        macho = [fixture imageWithConfiguration:configuration name:@"libStubs.dylib" error:NULL];
+        expect(macho).toNot.beNil();
+    });
+    
+    it(@"should resolve every non-lazy pointer to its symbol", ^{
+        NSError *error = nil;
+        MKStubTable *table = [[MKStubTable alloc] initWithImage:macho error:&error];
+        expect(table).toNot.beNil();
+        expect(error).to.beNil();
+        expect(table.warnings).to.equal(@[]);
+        expect(table.entryCount).to.equal(configuration.bindCount);
+        
+        MKSection *got = [macho sectionWithName:@"__got" inSegmentWithName:@SEG_DATA];
+        expect(got).toNot.beNil();
+        
+        mk_vm_address_t gotAddress;
+        expect(mk_vm_address_apply_slide(got.vmAddress, macho.slide, &gotAddress)).to.equal(MK_ESUCCESS);
+        
+        for (NSUInteger i = 0; i < table.entryCount; i++) {
+            const MKStubTableEntry *entry = &table.entries[i];
+            expect(entry->kind).to.equal(MKStubTableEntryKindNonLazyPointer);
+            expect(entry->address).to.equal(gotAddress + 8 * i);
+            expect(entry->symbolIndex).to.equal(configuration.symbolCount + i);
+            expect(entry->libraryOrdinal).to.equal(1);
+            expect(@(entry->symbolName)).to.equal([NSString stringWithFormat:@"_ext%08lu", (unsigned long)i]);
+            
+            // Any address within the pointer resolves to it.
+            expect([table entryForAddress:entry->address] == entry).to.beTruthy();
+            expect([table entryForAddress:entry->address + 7] == entry).to.beTruthy();
+        }
+        
+        expect([table entryForAddress:gotAddress - 1] == NULL).to.beTruthy();
+        expect([table entryForAddress:gotAddress + 8 * table.entryCount] == NULL).to.beTruthy();
+    });
+});
+
+SpecEnd
@@ -0,0 +1,221 @@
+//----------------------------------------------------------------------------//
+//|
+//|             MachOKit - A Lightweight Mach-O Parsing Library
+//|             context_spec.m
+//|
+//|             D.V.
+//|             Copyright (c) 2014-2015 D.V. All rights reserved.
+//|
+//| Permission is hereby granted, free of charge, to any person obtaining a
+//| copy of this software and associated documentation files (the "Software"),
+//| to deal in the Software without restriction, including without limitation
+//| the rights to use, copy, modify, merge, publish, distribute, sublicense,
+//| and/or sell copies of the Software, and to permit persons to whom the
+//| Software is furnished to do so, subject to the following conditions:
+//|
+//| The above copyright notice and this permission notice shall be included
+//| in all copies or substantial portions of the Software.
+//|
+//| THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+//| OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+//| MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+//| IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+//| CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+//| TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+//| SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+//----------------------------------------------------------------------------//
+
+SpecBegin(context)
+{
+    mk_context_statistics_t *statistics = calloc(1, sizeof(*statistics));
+    mk_context_t *context = calloc(1, sizeof(*context));
+    context->statistics = statistics;
+    
+    mk_memory_map_self_t *memory_map = malloc(sizeof(*memory_map));
+    mk_error_t err = mk_memory_map_self_init(context, memory_map);
+    it(@"should have a map", ^{
+        expect(err).to.equal(MK_ESUCCESS);
+    });
+    if (err != MK_ESUCCESS) return;
+    
+    // A synthetic image, copied into a page aligned buffer which covers the
+    // VM size of every segment.  The image is linked at address 0, so the
+    // address of the buffer is its slide.
+    SyntheticMachOConfiguration *configuration = [SyntheticMachOConfiguration configurationWithScale:1];
+    NSData *contents = [SyntheticMachO machOWithConfiguration:configuration baseAddress:0 fileOffset:0];
+    
+    size_t bufferSize = (contents.length + 0x3FFF) & ~(size_t)0x3FFF;
+    uint8_t *buffer = valloc(bufferSize);
+    memset(buffer, 0, bufferSize);
+    memcpy(buffer, contents.bytes, contents.length);
+    
+    mk_macho_t *image = malloc(sizeof(*image));
+    err = mk_macho_init_with_slide(context, "libStatistics.dylib", (mk_vm_slide_t)buffer, (mk_vm_address_t)buffer, memory_map, image);
+    it(@"should initialize the image", ^{
+        expect(err).to.equal(MK_ESUCCESS);
+    });
+    if (err != MK_ESUCCESS) return;
+    
+    //------------------------------------------------------------------------//
+    describe(@"statistics", ^{
+        beforeEach(^{
+            mk_context_statistics_reset(context);
+        });
+        
+        it(@"should count the load commands visited", ^{
+            uint32_t count = 0;
+            struct load_command *previous = NULL;
+            while ((previous = mk_macho_next_command(image, previous, NULL)))
+                count++;
+            
+            mk_context_statistics_t snapshot;
+            mk_context_statistics_snapshot(context, &snapshot);
+            expect(count).to.equal(mk_macho_get_ncmds(image));
+            expect(snapshot.load_commands_visited).to.beGreaterThanOrEqualTo(count);
+        });
+        
+        it(@"should count memory objects, remaps and copied bytes", ^{
+            mk_memory_object_t memory_object;
+            expect(mk_memory_map_init_object(memory_map, 0, (mk_vm_address_t)buffer, 4096, true, &memory_object)).to.equal(MK_ESUCCESS);
+            expect(mk_memory_object_remap_address(&memory_object, 0, (mk_vm_address_t)buffer + 16, 32, NULL)).toNot.equal(UINTPTR_MAX);
+            expect(mk_memory_object_remap_address(&memory_object, 16, (mk_vm_address_t)buffer, 32, NULL)).toNot.equal(UINTPTR_MAX);
+            mk_memory_map_free_object(memory_map, &memory_object);
+            
+            uint8_t bytes[100];
+            expect(mk_memory_map_copy_bytes(memory_map, 0, (mk_vm_address_t)buffer, bytes, sizeof(bytes), true, NULL)).to.equal(sizeof(bytes));
+            
+            mk_context_statistics_t snapshot;
+            mk_context_statistics_snapshot(context, &snapshot);
+            expect(snapshot.init_object).to.beGreaterThanOrEqualTo(1);
+            expect(snapshot.free_object).to.beGreaterThanOrEqualTo(1);
+            expect(snapshot.remap).to.beGreaterThanOrEqualTo(2);
+            expect(snapshot.bytes_copied).to.equal(sizeof(bytes));
+        });
+        
+        it(@"should count string table lookups and trie steps", ^{
+            mk_segment_t linkedit;
+            struct load_command *mach_load_command = NULL;
+            while ((mach_load_command = mk_macho_next_command_type(image, mach_load_command, LC_SEGMENT_64, NULL))) {
+                if (!strncmp(((struct segment_command_64*)mach_load_command)->segname, SEG_LINKEDIT, 16))
+                    expect(mk_segment_init_with_mach_load_command(image, mach_load_command, &linkedit)).to.equal(MK_ESUCCESS);
+            }
+            
+            // The first string after the leading " " is the name of the first
+            // exported symbol.
+            mk_string_table_t string_table;
+            expect(mk_string_table_init_with_segment(&linkedit, &string_table)).to.equal(MK_ESUCCESS);
+            const char *name = mk_string_table_get_string_at_offset(&string_table, 2, NULL);
+            expect(name != NULL).to.beTruthy();
+            if (name == NULL) return;
+            
+            mk_exports_trie_t exports_trie;
+            expect(mk_exports_trie_init_with_segment(&linkedit, &exports_trie)).to.equal(MK_ESUCCESS);
+            expect(mk_exports_trie_get_terminal_node_for_symbol(&exports_trie, name, NULL, NULL)).to.equal(MK_ESUCCESS);
+            
+            mk_context_statistics_t snapshot;
+            mk_context_statistics_snapshot(context, &snapshot);
+            expect(snapshot.string_table_lookups).to.equal(1);
+            // One step per level of the name, plus the root.
+            expect(snapshot.trie_steps).to.beGreaterThanOrEqualTo(configuration.exportsTrieDepth);
+            expect(snapshot.load_commands_visited).to.beGreaterThan(0);
+            
+            mk_exports_trie_free(&exports_trie);
+            mk_string_table_free(&string_table);
+            mk_segment_free(&linkedit);
+        });
+        
+        it(@"should clear every counter on reset", ^{
+            struct load_command *previous = NULL;
+            while ((previous = mk_macho_next_command(image, previous, NULL)));
+            uint8_t bytes[16];
+            mk_memory_map_copy_bytes(memory_map, 0, (mk_vm_address_t)buffer, bytes, sizeof(bytes), true, NULL);
+            
+            mk_context_statistics_t snapshot;
+            mk_context_statistics_snapshot(context, &snapshot);
+            expect(snapshot.load_commands_visited).to.beGreaterThan(0);
+            expect(snapshot.bytes_copied).to.beGreaterThan(0);
+            
+            mk_context_statistics_reset(context);
+            mk_context_statistics_snapshot(context, &snapshot);
+            mk_context_statistics_t zero = { 0 };
+            expect(memcmp(&snapshot, &zero, sizeof(zero))).to.equal(0);
+        });
+        
+        it(@"should snapshot zeroes for a context without statistics", ^{
+            mk_context_t bare = { 0 };
+            mk_context_statistics_t snapshot;
+            memset(&snapshot, 0xFF, sizeof(snapshot));
+            mk_context_statistics_snapshot(&bare, &snapshot);
+            mk_context_statistics_t zero = { 0 };
+            expect(memcmp(&snapshot, &zero, sizeof(zero))).to.equal(0);
+            
+            // Resetting is a no-op.
+            mk_context_statistics_reset(&bare);
+            mk_context_statistics_reset(NULL);
+        });
+    });
+    
+    //------------------------------------------------------------------------//
+    describe(@"budget", ^{
+        mk_context_budget_t *budget = calloc(1, sizeof(*budget));
+        __block mk_segment_t linkedit;
+        __block mk_exports_trie_t exports_trie;
+        
+        beforeEach(^{
+            memset(budget, 0, sizeof(*budget));
+            context->budget = budget;
+            
+            struct load_command *mach_load_command = NULL;
+            while ((mach_load_command = mk_macho_next_command_type(image, mach_load_command, LC_SEGMENT_64, NULL))) {
+                if (!strncmp(((struct segment_command_64*)mach_load_command)->segname, SEG_LINKEDIT, 16))
+                    expect(mk_segment_init_with_mach_load_command(image, mach_load_command, &linkedit)).to.equal(MK_ESUCCESS);
+            }
+            expect(mk_exports_trie_init_with_segment(&linkedit, &exports_trie)).to.equal(MK_ESUCCESS);
+        });
+        
+        afterEach(^{
+            mk_exports_trie_free(&exports_trie);
+            mk_segment_free(&linkedit);
+            context->budget = NULL;
+        });
+        
+        it(@"should stop walking a cyclic exports trie", ^{
+            // Replace the root with a non-terminal node that has a single
+            // child, reached through an empty label, at offset 0.
+            uint8_t *root = (uint8_t*)mk_vm_range_start(mk_exports_trie_get_target_range(&exports_trie));
+            uint8_t cycle[] = { 0x00, 0x01, '\0', 0x00 };
+            uint8_t original[sizeof(cycle)];
+            memcpy(original, root, sizeof(cycle));
+            memcpy(root, cycle, sizeof(cycle));
+            
+            budget->max_trie_visits = 64;
+            mk_context_statistics_reset(context);
+            expect(mk_exports_trie_get_terminal_node_for_symbol(&exports_trie, "_s", NULL, NULL)).to.equal(MK_EBUDGET_EXCEEDED);
+            
+            mk_context_statistics_t snapshot;
+            mk_context_statistics_snapshot(context, &snapshot);
+            expect(snapshot.trie_steps).to.equal(budget->max_trie_visits + 1);
+            
+            memcpy(root, original, sizeof(cycle));
+        });
+        
+        it(@"should stop once the deadline has passed", ^{
+            mk_string_table_t string_table;
+            expect(mk_string_table_init_with_segment(&linkedit, &string_table)).to.equal(MK_ESUCCESS);
+            const char *name = mk_string_table_get_string_at_offset(&string_table, 2, NULL);
+            expect(name != NULL).to.beTruthy();
+            if (name == NULL) return;
+            
+            // A deadline on the first nanosecond of the monotonic clock passed
+            // long ago.
+            budget->deadline = 1;
+            expect(mk_exports_trie_get_terminal_node_for_symbol(&exports_trie, name, NULL, NULL)).to.equal(MK_EBUDGET_EXCEEDED);
+            
+            budget->deadline = mk_context_budget_deadline_after(60 * NSEC_PER_SEC);
+            expect(mk_exports_trie_get_terminal_node_for_symbol(&exports_trie, name, NULL, NULL)).to.equal(MK_ESUCCESS);
+            
+            mk_string_table_free(&string_table);
+        });
+    });
+}
+SpecEnd
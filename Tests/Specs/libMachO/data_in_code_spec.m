@@ -0,0 +1,195 @@
+//----------------------------------------------------------------------------//
+//|
+//|             MachOKit - A Lightweight Mach-O Parsing Library
+//|             data_in_code_spec.m
+//|
+//|             D.V.
+//|             Copyright (c) 2014-2015 D.V. All rights reserved.
+//|
+//| Permission is hereby granted, free of charge, to any person obtaining a
+//| copy of this software and associated documentation files (the "Software"),
+//| to deal in the Software without restriction, including without limitation
+//| the rights to use, copy, modify, merge, publish, distribute, sublicense,
+//| and/or sell copies of the Software, and to permit persons to whom the
+//| Software is furnished to do so, subject to the following conditions:
+//|
+//| The above copyright notice and this permission notice shall be included
+//| in all copies or substantial portions of the Software.
+//|
+//| THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+//| OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+//| MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+//| IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+//| CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+//| TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+//| SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+//----------------------------------------------------------------------------//
+
+SpecBegin(data_in_code)
+{
+    mk_memory_map_self_t *memory_map = malloc(sizeof(*memory_map));
+    mk_error_t err = mk_memory_map_self_init(NULL, memory_map);
+    it(@"should have a map", ^{
+        expect(err).to.equal(MK_ESUCCESS);
+    });
+    if (err != MK_ESUCCESS) return;
+    
+    // A synthetic image, copied into a page aligned buffer which covers the
+    // VM size of every segment.  The image is linked at address 0, so the
+    // address of the buffer is its slide.
+    SyntheticMachOConfiguration *configuration = [SyntheticMachOConfiguration configurationWithScale:1];
+    configuration.dataInCodeCount = 64;
+    NSData *contents = [SyntheticMachO machOWithConfiguration:configuration baseAddress:0 fileOffset:0];
+    
+    size_t bufferSize = (contents.length + 0x3FFF) & ~(size_t)0x3FFF;
+    uint8_t *buffer = valloc(bufferSize);
+    memset(buffer, 0, bufferSize);
+    memcpy(buffer, contents.bytes, contents.length);
+    
+    // Returns the data in code entries of the buffer, to patch them.
+    struct data_in_code_entry* (^entries)(uint32_t*) = ^struct data_in_code_entry* (uint32_t *count) {
+        const struct mach_header_64 *header = (const struct mach_header_64*)buffer;
+        const uint8_t *lc = (const uint8_t*)(header + 1);
+        for (uint32_t i = 0; i < header->ncmds; i++, lc += ((const struct load_command*)lc)->cmdsize) {
+            if (((const struct load_command*)lc)->cmd == LC_DATA_IN_CODE) {
+                const struct linkedit_data_command *command = (const struct linkedit_data_command*)lc;
+                *count = command->datasize / sizeof(struct data_in_code_entry);
+                return (struct data_in_code_entry*)(buffer + command->dataoff);
+            }
+        }
+        return NULL;
+    };
+    
+    mk_macho_t *image = malloc(sizeof(*image));
+    err = mk_macho_init_with_slide(NULL, "libDataInCode.dylib", (mk_vm_slide_t)buffer, (mk_vm_address_t)buffer, memory_map, image);
+    it(@"should initialize the image", ^{
+        expect(err).to.equal(MK_ESUCCESS);
+    });
+    if (err != MK_ESUCCESS) return;
+    
+    mk_segment_t *linkedit = malloc(sizeof(*linkedit));
+    {
+        struct load_command *mach_load_command = NULL;
+        while ((mach_load_command = mk_macho_next_command_type(image, mach_load_command, LC_SEGMENT_64, NULL))) {
+            if (!strncmp(((struct segment_command_64*)mach_load_command)->segname, SEG_LINKEDIT, 16)) {
+                err = mk_segment_init_with_mach_load_command(image, mach_load_command, linkedit);
+                if (err != MK_ESUCCESS) return;
+            }
+        }
+    }
+    
+    uint32_t text_offset = ((struct section_64*)((struct segment_command_64*)((struct mach_header_64*)buffer + 1) + 1))->offset;
+    
+    //------------------------------------------------------------------------//
+    describe(@"mk_data_in_code_init", ^{
+        it(@"should map every entry", ^{
+            mk_data_in_code_t data_in_code;
+            expect(mk_data_in_code_init_with_segment(linkedit, &data_in_code)).to.equal(MK_ESUCCESS);
+            expect(mk_data_in_code_get_entry_count(&data_in_code)).to.equal(configuration.dataInCodeCount);
+            expect(mk_data_in_code_get_segment(&data_in_code).segment == linkedit).to.beTruthy();
+            
+            for (uint32_t i = 0; i < configuration.dataInCodeCount; i++) {
+                struct data_in_code_entry entry;
+                expect(mk_data_in_code_copy_entry_at_index(&data_in_code, i, &entry)).to.equal(MK_ESUCCESS);
+                expect(entry.offset).to.equal(text_offset + 32 * i);
+                expect(entry.length).to.equal(8);
+                expect(entry.kind).to.equal(1 + i % 4);
+            }
+            
+            struct data_in_code_entry entry;
+            expect(mk_data_in_code_copy_entry_at_index(&data_in_code, (uint32_t)configuration.dataInCodeCount, &entry)).to.equal(MK_EOUT_OF_RANGE);
+            mk_data_in_code_free(&data_in_code);
+        });
+        
+        it(@"should reject a load command of another type", ^{
+            struct load_command *symtab = mk_macho_next_command_type(image, NULL, LC_SYMTAB, NULL);
+            mk_data_in_code_t data_in_code;
+            expect(mk_data_in_code_init_with_mach_load_command(linkedit, (struct linkedit_data_command*)symtab, &data_in_code)).to.equal(MK_EINVAL);
+        });
+    });
+    
+    //------------------------------------------------------------------------//
+    describe(@"mk_data_in_code_find_entry_containing_offset", ^{
+        it(@"should find the entry containing each offset", ^{
+            mk_data_in_code_t data_in_code;
+            expect(mk_data_in_code_init_with_segment(linkedit, &data_in_code)).to.equal(MK_ESUCCESS);
+            
+            for (uint32_t i = 0; i < configuration.dataInCodeCount; i++) {
+                uint32_t start = text_offset + 32 * i;
+                uint32_t index = UINT32_MAX;
+                struct data_in_code_entry entry;
+                
+                expect(mk_data_in_code_find_entry_containing_offset(&data_in_code, start, &index, &entry)).to.equal(MK_ESUCCESS);
+                expect(index).to.equal(i);
+                expect(entry.offset).to.equal(start);
+                expect(mk_data_in_code_find_entry_containing_offset(&data_in_code, start + 7, &index, NULL)).to.equal(MK_ESUCCESS);
+                expect(index).to.equal(i);
+                expect(mk_data_in_code_find_entry_containing_offset(&data_in_code, start + 8, NULL, NULL)).to.equal(MK_ENOT_FOUND);
+            }
+            
+            expect(mk_data_in_code_find_entry_containing_offset(&data_in_code, 0, NULL, NULL)).to.equal(MK_ENOT_FOUND);
+            mk_data_in_code_free(&data_in_code);
+        });
+        
+        it(@"should fall back to a linear scan when the entries are not sorted", ^{
+            uint32_t count = 0;
+            struct data_in_code_entry *mapped = entries(&count);
+            struct data_in_code_entry first = mapped[0];
+            mapped[0] = mapped[count - 1];
+            mapped[count - 1] = first;
+            
+            mk_data_in_code_t data_in_code;
+            expect(mk_data_in_code_init_with_segment(linkedit, &data_in_code)).to.equal(MK_ESUCCESS);
+            
+            uint32_t index = UINT32_MAX;
+            expect(mk_data_in_code_find_entry_containing_offset(&data_in_code, text_offset + 4, &index, NULL)).to.equal(MK_ESUCCESS);
+            expect(index).to.equal(count - 1);
+            expect(mk_data_in_code_find_entry_containing_offset(&data_in_code, text_offset + 32 * (count - 1), &index, NULL)).to.equal(MK_ESUCCESS);
+            expect(index).to.equal(0);
+            expect(mk_data_in_code_find_entry_containing_offset(&data_in_code, text_offset + 32 * 3 + 2, &index, NULL)).to.equal(MK_ESUCCESS);
+            expect(index).to.equal(3);
+            mk_data_in_code_free(&data_in_code);
+            
+            mapped[count - 1] = mapped[0];
+            mapped[0] = first;
+        });
+    });
+    
+    //------------------------------------------------------------------------//
+    describe(@"mk_data_in_code_classify_offsets", ^{
+        it(@"should classify ascending and descending offsets", ^{
+            mk_data_in_code_t data_in_code;
+            expect(mk_data_in_code_init_with_segment(linkedit, &data_in_code)).to.equal(MK_ESUCCESS);
+            
+            // Every 4 bytes from just before the first entry to past the
+            // last, forwards then backwards.
+            size_t half = (size_t)configuration.dataInCodeCount * 8 + 2;
+            size_t count = 2 * half;
+            uint32_t *offsets = calloc(count, sizeof(*offsets));
+            uint16_t *kinds = calloc(count, sizeof(*kinds));
+            for (size_t i = 0; i < half; i++) {
+                offsets[i] = text_offset - 4 + 4 * (uint32_t)i;
+                offsets[count - 1 - i] = offsets[i];
+            }
+            
+            mk_data_in_code_classify_offsets(&data_in_code, offsets, count, kinds);
+            
+            for (size_t i = 0; i < count; i++) {
+                struct data_in_code_entry entry;
+                uint16_t expected = 0;
+                if (mk_data_in_code_find_entry_containing_offset(&data_in_code, offsets[i], NULL, &entry) == MK_ESUCCESS)
+                    expected = entry.kind;
+                expect(kinds[i]).to.equal(expected);
+            }
+            // Spot check against the layout.
+            expect(kinds[1]).to.equal(1);
+            expect(kinds[3]).to.equal(0);
+            expect(kinds[1 + 8 * 5]).to.equal(1 + 5 % 4);
+            
+            free(kinds);
+            free(offsets);
+            mk_data_in_code_free(&data_in_code);
+        });
+    });
+}
+SpecEnd
@@ -394,6 +394,126 @@ SpecBegin(macho_image)
                     expect(count).to.equal(mk_symbol_table_get_symbol_count(symbol_table));
                 });
                 
+                it(@"should find symbols by address", ^{
+                    size_t size = mk_symbol_address_index_get_required_size(symbol_table);
+                    void *buffer = malloc(MAX(size, 1));
+                    mk_symbol_address_index_t symbol_address_index;
+                    mk_error_t err = mk_symbol_address_index_init(symbol_table, buffer, size, &symbol_address_index);
+                    expect(err).to.equal(MK_ESUCCESS);
+                    if (err != MK_ESUCCESS) { free(buffer); return; }
+                    
+                    // Every defined symbol from the symbol table, by address.  The
+                    // value records whether any symbol at the address is external.
+                    NSMutableDictionary<NSNumber*, NSNumber*> *expected = [NSMutableDictionary dictionary];
+                    mk_vm_slide_t slide = mk_macho_get_slide(image);
+                    mk_symbol_table_enumerate_mach_symbols(symbol_table, 0, ^(const mk_macho_nlist_ptr symbol, __unused uint32_t index, __unused mk_vm_address_t target_address) {
+                        if ((symbol.nlist->n_type & N_STAB) || (symbol.nlist->n_type & N_TYPE) != N_SECT)
+                            return;
+                        
+                        mk_vm_address_t address = mk_macho_is_64_bit(image) ? symbol.nlist_64->n_value : symbol.nlist->n_value;
+                        if (mk_vm_address_apply_slide(address, slide, &address))
+                            return;
+                        
+                        BOOL external = (symbol.nlist->n_type & N_EXT) != 0;
+                        expected[@(address)] = @(external || expected[@(address)].boolValue);
+                    });
+                    
+                    uint32_t count = mk_symbol_address_index_get_count(&symbol_address_index);
+                    expect(count).to.equal(expected.count);
+                    
+                    for (uint32_t i = 0; i < count; i++) {
+                        const mk_symbol_address_index_entry_t *entry = mk_symbol_address_index_get_entry(&symbol_address_index, i);
+                        mk_vm_address_t next_target_address;
+                        
+                        expect(mk_symbol_address_index_find_entry(&symbol_address_index, entry->target_address, &next_target_address)).to.equal(entry);
+                        if (i + 1 < count)
+                            expect(next_target_address).to.equal(mk_symbol_address_index_get_entry(&symbol_address_index, i + 1)->target_address);
+                        
+                        // The entry describes the symbol at its index in the
+                        // symbol table.
+                        mk_macho_nlist_ptr symbol = mk_symbol_table_get_mach_symbol_at_index(symbol_table, entry->symbol_index, NULL);
+                        expect(symbol.any != NULL).to.beTruthy();
+                        if (symbol.any == NULL) continue;
+                        
+                        mk_vm_address_t address = mk_macho_is_64_bit(image) ? symbol.nlist_64->n_value : symbol.nlist->n_value;
+                        expect(mk_vm_address_apply_slide(address, slide, &address)).to.equal(MK_ESUCCESS);
+                        expect(address).to.equal(entry->target_address);
+                        expect(symbol.nlist->n_un.n_strx).to.equal(entry->strx);
+                        expect(symbol.nlist->n_type).to.equal(entry->type);
+                        
+                        // External symbols are preferred over local symbols at
+                        // the same address.
+                        expect(expected[@(entry->target_address)]).toNot.beNil();
+                        expect((entry->type & N_EXT) != 0).to.equal(expected[@(entry->target_address)].boolValue);
+                    }
+                    
+                    mk_symbol_address_index_free(&symbol_address_index);
+                    free(buffer);
+                });
+                
+                it(@"should find external symbols by name", ^{
+                    mk_string_table_t string_table;
+                    expect(mk_string_table_init_with_segment(linkedit, &string_table)).to.equal(MK_ESUCCESS);
+                    
+                    size_t size = mk_symbol_name_index_get_required_size(symbol_table);
+                    void *buffer = malloc(MAX(size, 1));
+                    mk_symbol_name_index_t symbol_name_index;
+                    expect(mk_symbol_name_index_init(symbol_table, &string_table, buffer, size, &symbol_name_index)).to.equal(MK_ESUCCESS);
+                    
+                    mk_symbol_table_enumerate_mach_symbols(symbol_table, 0, ^(const mk_macho_nlist_ptr symbol, uint32_t index, __unused mk_vm_address_t target_address) {
+                        if ((symbol.nlist->n_type & N_STAB) || !(symbol.nlist->n_type & N_EXT))
+                            return;
+                        
+                        const char *name = mk_string_table_get_string_at_offset(&string_table, symbol.nlist->n_un.n_strx, NULL);
+                        uint32_t found = UINT32_MAX;
+                        expect(mk_symbol_table_find_symbol_named(symbol_table, &string_table, name, &found, NULL).any).toNot.beNil();
+                        expect(strcmp(name, mk_string_table_get_string_at_offset(&string_table, mk_symbol_table_get_mach_symbol_at_index(symbol_table, found, NULL).nlist->n_un.n_strx, NULL))).to.equal(0);
+                        
+                        found = UINT32_MAX;
+                        expect(mk_symbol_name_index_find_symbol(&symbol_name_index, name, &found, NULL).any).toNot.beNil();
+                        expect(found).to.beLessThanOrEqualTo(index);
+                    });
+                    
+                    expect(mk_symbol_table_find_symbol_named(symbol_table, &string_table, "_MachOKit.does.not.exist", NULL, NULL).any).to.beNil();
+                    expect(mk_symbol_name_index_find_symbol(&symbol_name_index, "_MachOKit.does.not.exist", NULL, NULL).any).to.beNil();
+                    
+                    mk_symbol_name_index_free(&symbol_name_index);
+                    free(buffer);
+                    mk_string_table_free(&string_table);
+                });
+                
+                it(@"should enumerate only the symbols matching a filter", ^{
+                    mk_symbol_filter_t filters[] = {
+                        { .n_type_mask = N_STAB | N_TYPE | N_EXT, .n_type = N_SECT | N_EXT },
+                        { .n_type_any_mask = N_STAB },
+                        { .n_type_mask = N_STAB | N_TYPE, .n_type = N_SECT, .n_sect = 1 }
+                    };
+                    
+                    for (size_t i = 0; i < sizeof(filters)/sizeof(*filters); i++) {
+                        mk_symbol_filter_t filter = filters[i];
+                        NSMutableIndexSet *expected = [NSMutableIndexSet indexSet];
+                        NSMutableIndexSet *matched = [NSMutableIndexSet indexSet];
+                        
+                        mk_symbol_table_enumerate_mach_symbols(symbol_table, 0, ^(const mk_macho_nlist_ptr symbol, uint32_t index, __unused mk_vm_address_t target_address) {
+                            uint8_t n_type = symbol.nlist->n_type;
+                            if ((n_type & filter.n_type_mask) == filter.n_type &&
+                                (filter.n_type_any_mask == 0 || (n_type & filter.n_type_any_mask)) &&
+                                (filter.n_sect == NO_SECT || symbol.nlist->n_sect == filter.n_sect))
+                                [expected addIndex:index];
+                        });
+                        mk_symbol_table_enumerate_mach_symbols_matching(symbol_table, &filter, 0, ^(__unused const mk_macho_nlist_ptr symbol, uint32_t index, __unused mk_vm_address_t target_address) {
+                            [matched addIndex:index];
+                        });
+                        expect(matched).to.equal(expected);
+                        
+                        uint32_t count = 0;
+                        mk_macho_nlist_ptr previous = (mk_macho_nlist_ptr)NULL;
+                        while ((previous = mk_symbol_table_next_mach_symbol_matching(symbol_table, &filter, previous, NULL, NULL)).any)
+                            count++;
+                        expect(count).to.equal(expected.count);
+                    }
+                });
+                
                 describe(@"symbols", ^{
                     uint32_t count = 0;
                     mk_macho_nlist_ptr mach_symbol = (mk_macho_nlist_ptr)NULL;
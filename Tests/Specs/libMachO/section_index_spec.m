@@ -0,0 +1,198 @@
+//----------------------------------------------------------------------------//
+//|
+//|             MachOKit - A Lightweight Mach-O Parsing Library
+//|             section_index_spec.m
+//|
+//|             D.V.
+//|             Copyright (c) 2014-2015 D.V. All rights reserved.
+//|
+//| Permission is hereby granted, free of charge, to any person obtaining a
+//| copy of this software and associated documentation files (the "Software"),
+//| to deal in the Software without restriction, including without limitation
+//| the rights to use, copy, modify, merge, publish, distribute, sublicense,
+//| and/or sell copies of the Software, and to permit persons to whom the
+//| Software is furnished to do so, subject to the following conditions:
+//|
+//| The above copyright notice and this permission notice shall be included
+//| in all copies or substantial portions of the Software.
+//|
+//| THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+//| OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+//| MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+//| IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+//| CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+//| TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+//| SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+//----------------------------------------------------------------------------//
+
+SpecBegin(section_index)
+{
+    mk_memory_map_self_t *memory_map = malloc(sizeof(*memory_map));
+    mk_error_t err = mk_memory_map_self_init(NULL, memory_map);
+    it(@"should have a map", ^{
+        expect(err).to.equal(MK_ESUCCESS);
+    });
+    if (err != MK_ESUCCESS) return;
+    
+    // A synthetic image, copied into a page aligned buffer which covers the
+    // VM size of every segment.  The image is linked at address 0, so the
+    // address of the buffer is its slide.
+    SyntheticMachOConfiguration *configuration = [SyntheticMachOConfiguration configurationWithScale:1];
+    NSData *contents = [SyntheticMachO machOWithConfiguration:configuration baseAddress:0 fileOffset:0];
+    
+    size_t bufferSize = (contents.length + 0x3FFF) & ~(size_t)0x3FFF;
+    uint8_t *buffer = valloc(bufferSize);
+    memset(buffer, 0, bufferSize);
+    memcpy(buffer, contents.bytes, contents.length);
+    
+    mk_macho_t *image = malloc(sizeof(*image));
+    err = mk_macho_init_with_slide(NULL, "libSectionIndex.dylib", (mk_vm_slide_t)buffer, (mk_vm_address_t)buffer, memory_map, image);
+    it(@"should initialize the image", ^{
+        expect(err).to.equal(MK_ESUCCESS);
+    });
+    if (err != MK_ESUCCESS) return;
+    
+    // The segment and section commands of the buffer, in load command order.
+    NSMutableArray<NSValue*> *segments = [NSMutableArray array];
+    NSMutableArray<NSValue*> *sections = [NSMutableArray array];
+    {
+        const struct mach_header_64 *header = (const struct mach_header_64*)buffer;
+        const uint8_t *lc = (const uint8_t*)(header + 1);
+        for (uint32_t i = 0; i < header->ncmds; i++, lc += ((const struct load_command*)lc)->cmdsize) {
+            if (((const struct load_command*)lc)->cmd != LC_SEGMENT_64)
+                continue;
+            const struct segment_command_64 *segment = (const struct segment_command_64*)lc;
+            [segments addObject:[NSValue valueWithPointer:segment]];
+            for (uint32_t j = 0; j < segment->nsects; j++)
+                [sections addObject:[NSValue valueWithPointer:(const struct section_64*)(segment + 1) + j]];
+        }
+    }
+    
+    size_t required_size = mk_section_index_get_required_size(image);
+    void *storage = malloc(required_size);
+    
+    mk_section_index_t *section_index = malloc(sizeof(*section_index));
+    err = mk_section_index_init(image, storage, required_size, section_index);
+    it(@"should initialize the section index", ^{
+        expect(err).to.equal(MK_ESUCCESS);
+    });
+    if (err != MK_ESUCCESS) return;
+    
+    //------------------------------------------------------------------------//
+    describe(@"mk_section_index_init", ^{
+        it(@"should reject a buffer smaller than the required size", ^{
+            mk_section_index_t other;
+            expect(required_size).to.beGreaterThan(0);
+            expect(mk_section_index_init(image, storage, required_size - 1, &other)).to.equal(MK_ESIZE);
+            expect(mk_section_index_init(image, NULL, 0, &other)).to.equal(MK_ESIZE);
+        });
+        
+        it(@"should index every segment and section", ^{
+            expect(mk_section_index_get_macho(section_index).macho == image).to.beTruthy();
+            expect(mk_section_index_get_segment_count(section_index)).to.equal(segments.count);
+            expect(mk_section_index_get_section_count(section_index)).to.equal(sections.count);
+            expect(sections.count).to.beGreaterThan(2);
+        });
+    });
+    
+    //------------------------------------------------------------------------//
+    describe(@"mk_section_index_find_segment", ^{
+        it(@"should find each segment by name", ^{
+            for (NSValue *value in segments) {
+                const struct segment_command_64 *segment = value.pointerValue;
+                char name[17] = { 0 };
+                strncpy(name, segment->segname, 16);
+                
+                mk_vm_range_t range;
+                mk_macho_segment_load_command_ptr command = mk_section_index_find_segment(section_index, name, &range);
+                expect(command.segment_64 == segment).to.beTruthy();
+                expect(range.location).to.equal((mk_vm_address_t)buffer + segment->vmaddr);
+                expect(range.length).to.equal(segment->vmsize);
+            }
+        });
+        
+        it(@"should not find a segment that does not exist", ^{
+            expect(mk_section_index_find_segment(section_index, "__NOPE", NULL).any == NULL).to.beTruthy();
+            expect(mk_section_index_find_segment(section_index, "__TEX", NULL).any == NULL).to.beTruthy();
+        });
+    });
+    
+    //------------------------------------------------------------------------//
+    describe(@"mk_section_index_find_segment_containing_address", ^{
+        it(@"should find the segment containing each address", ^{
+            for (NSValue *value in segments) {
+                const struct segment_command_64 *segment = value.pointerValue;
+                if (segment->vmsize == 0)
+                    continue;
+                
+                mk_vm_address_t start = (mk_vm_address_t)buffer + segment->vmaddr;
+                expect(mk_section_index_find_segment_containing_address(section_index, start, NULL).segment_64 == segment).to.beTruthy();
+                expect(mk_section_index_find_segment_containing_address(section_index, start + segment->vmsize - 1, NULL).segment_64 == segment).to.beTruthy();
+            }
+        });
+        
+        it(@"should not find an address outside the image", ^{
+            expect(mk_section_index_find_segment_containing_address(section_index, (mk_vm_address_t)buffer - 1, NULL).any == NULL).to.beTruthy();
+        });
+    });
+    
+    //------------------------------------------------------------------------//
+    describe(@"mk_section_index_find_section", ^{
+        it(@"should find each section by segment and section name", ^{
+            for (NSValue *value in sections) {
+                const struct section_64 *section = value.pointerValue;
+                char segname[17] = { 0 }, sectname[17] = { 0 };
+                strncpy(segname, section->segname, 16);
+                strncpy(sectname, section->sectname, 16);
+                
+                mk_vm_range_t range;
+                mk_macho_section_command_ptr command = mk_section_index_find_section(section_index, segname, sectname, &range);
+                expect(command.section_64 == section).to.beTruthy();
+                expect(range.location).to.equal((mk_vm_address_t)buffer + section->addr);
+                expect(range.length).to.equal(section->size);
+            }
+        });
+        
+        it(@"should not find a section in another segment", ^{
+            expect(mk_section_index_find_section(section_index, SEG_DATA, SECT_TEXT, NULL).any == NULL).to.beTruthy();
+            expect(mk_section_index_find_section(section_index, SEG_TEXT, "__nope", NULL).any == NULL).to.beTruthy();
+        });
+    });
+    
+    //------------------------------------------------------------------------//
+    describe(@"mk_section_index_find_section_containing_address", ^{
+        it(@"should find the section containing each address", ^{
+            for (NSValue *value in sections) {
+                const struct section_64 *section = value.pointerValue;
+                if (section->size == 0)
+                    continue;
+                
+                mk_vm_address_t start = (mk_vm_address_t)buffer + section->addr;
+                expect(mk_section_index_find_section_containing_address(section_index, start, NULL).section_64 == section).to.beTruthy();
+                expect(mk_section_index_find_section_containing_address(section_index, start + section->size - 1, NULL).section_64 == section).to.beTruthy();
+            }
+        });
+        
+        it(@"should not find an address outside every section", ^{
+            // The load commands follow the header and precede the first
+            // section.
+            expect(mk_section_index_find_section_containing_address(section_index, (mk_vm_address_t)buffer, NULL).any == NULL).to.beTruthy();
+        });
+    });
+    
+    //------------------------------------------------------------------------//
+    describe(@"mk_section_index_get_section_at_ordinal", ^{
+        it(@"should return sections in load command order", ^{
+            for (NSUInteger i = 0; i < sections.count; i++) {
+                mk_macho_section_command_ptr command = mk_section_index_get_section_at_ordinal(section_index, (uint8_t)(i + 1), NULL);
+                expect(command.section_64 == sections[i].pointerValue).to.beTruthy();
+            }
+        });
+        
+        it(@"should not return a section for NO_SECT or a missing ordinal", ^{
+            expect(mk_section_index_get_section_at_ordinal(section_index, NO_SECT, NULL).any == NULL).to.beTruthy();
+            expect(mk_section_index_get_section_at_ordinal(section_index, (uint8_t)(sections.count + 1), NULL).any == NULL).to.beTruthy();
+        });
+    });
+}
+SpecEnd
@@ -0,0 +1,139 @@
+//----------------------------------------------------------------------------//
+//|
+//|             MachOKit - A Lightweight Mach-O Parsing Library
+//|             symbol_table_spec.m
+//|
+//|             D.V.
+//|             Copyright (c) 2014-2015 D.V. All rights reserved.
+//|
+//| Permission is hereby granted, free of charge, to any person obtaining a
+//| copy of this software and associated documentation files (the "Software"),
+//| to deal in the Software without restriction, including without limitation
+//| the rights to use, copy, modify, merge, publish, distribute, sublicense,
+//| and/or sell copies of the Software, and to permit persons to whom the
+//| Software is furnished to do so, subject to the following conditions:
+//|
+//| The above copyright notice and this permission notice shall be included
+//| in all copies or substantial portions of the Software.
+//|
+//| THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+//| OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+//| MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+//| IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+//| CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+//| TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+//| SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+//----------------------------------------------------------------------------//
+
+SpecBegin(symbol_table)
+{
+    mk_memory_map_self_t *memory_map = malloc(sizeof(*memory_map));
+    mk_error_t err = mk_memory_map_self_init(NULL, memory_map);
+    it(@"should have a map", ^{
+        expect(err).to.equal(MK_ESUCCESS);
+    });
+    if (err != MK_ESUCCESS) return;
+    
+    // A synthetic image, copied into a page aligned buffer which covers the
+    // VM size of every segment.  The image is linked at address 0, so the
+    // address of the buffer is its slide.
+    SyntheticMachOConfiguration *configuration = [SyntheticMachOConfiguration configurationWithScale:1];
+    NSData *contents = [SyntheticMachO machOWithConfiguration:configuration baseAddress:0 fileOffset:0];
+    
+    size_t bufferSize = (contents.length + 0x3FFF) & ~(size_t)0x3FFF;
+    uint8_t *buffer = valloc(bufferSize);
+    memset(buffer, 0, bufferSize);
+    memcpy(buffer, contents.bytes, contents.length);
+    
+    struct symtab_command *symtab = NULL;
+    {
+        const struct mach_header_64 *header = (const struct mach_header_64*)buffer;
+        uint8_t *lc = (uint8_t*)(header + 1);
+        for (uint32_t i = 0; i < header->ncmds; i++, lc += ((struct load_command*)lc)->cmdsize) {
+            if (((struct load_command*)lc)->cmd == LC_SYMTAB)
+                symtab = (struct symtab_command*)lc;
+        }
+    }
+    struct nlist_64 *nlists = (struct nlist_64*)(buffer + symtab->symoff);
+    
+    mk_macho_t *image = malloc(sizeof(*image));
+    err = mk_macho_init_with_slide(NULL, "libSymbolTable.dylib", (mk_vm_slide_t)buffer, (mk_vm_address_t)buffer, memory_map, image);
+    it(@"should initialize the image", ^{
+        expect(err).to.equal(MK_ESUCCESS);
+    });
+    if (err != MK_ESUCCESS) return;
+    
+    mk_segment_t *linkedit = malloc(sizeof(*linkedit));
+    {
+        struct load_command *mach_load_command = NULL;
+        while ((mach_load_command = mk_macho_next_command_type(image, mach_load_command, LC_SEGMENT_64, NULL))) {
+            if (!strncmp(((struct segment_command_64*)mach_load_command)->segname, SEG_LINKEDIT, 16)) {
+                err = mk_segment_init_with_mach_load_command(image, mach_load_command, linkedit);
+                if (err != MK_ESUCCESS) return;
+            }
+        }
+    }
+    
+    // Looks up the name of every symbol, and checks that it is found at its
+    // own index.
+    void (^findEverySymbol)(void) = ^{
+        mk_symbol_table_t symbol_table;
+        mk_string_table_t string_table;
+        expect(mk_symbol_table_init_with_segment(linkedit, &symbol_table)).to.equal(MK_ESUCCESS);
+        expect(mk_string_table_init_with_segment(linkedit, &string_table)).to.equal(MK_ESUCCESS);
+        
+        for (uint32_t i = 0; i < symtab->nsyms; i++) {
+            const char *name = (const char*)(buffer + symtab->stroff + nlists[i].n_un.n_strx);
+            uint32_t index = UINT32_MAX;
+            expect(mk_symbol_table_find_symbol_named(&symbol_table, &string_table, name, &index, NULL).any).to.equal((void*)&nlists[i]);
+            expect(index).to.equal(i);
+        }
+        
+        expect(mk_symbol_table_find_symbol_named(&symbol_table, &string_table, "_MachOKit.does.not.exist", NULL, NULL).any).to.beNil();
+    };
+    
+    //------------------------------------------------------------------------//
+    describe(@"mk_symbol_table_find_symbol_named", ^{
+        it(@"should find every external symbol", ^{
+            expect(symtab->nsyms).to.equal(configuration.symbolCount + configuration.bindCount);
+            findEverySymbol();
+        });
+        
+        it(@"should fall back to a linear scan when the external symbols are not sorted", ^{
+            // Swap the names of the first and last external definitions.  A
+            // binary search would miss both.
+            uint32_t last = (uint32_t)configuration.symbolCount - 1;
+            uint32_t strx = nlists[0].n_un.n_strx;
+            nlists[0].n_un.n_strx = nlists[last].n_un.n_strx;
+            nlists[last].n_un.n_strx = strx;
+            
+            findEverySymbol();
+            
+            nlists[last].n_un.n_strx = nlists[0].n_un.n_strx;
+            nlists[0].n_un.n_strx = strx;
+        });
+        
+        it(@"should not match a name that is cut off by the end of the string table", ^{
+            // Point the last external definition at an unterminated name in
+            // the last byte of the string table.
+            uint32_t last = (uint32_t)configuration.symbolCount - 1;
+            uint32_t strx = nlists[last].n_un.n_strx;
+            char *end = (char*)(buffer + symtab->stroff + symtab->strsize - 1);
+            char byte = *end;
+            nlists[last].n_un.n_strx = symtab->strsize - 1;
+            *end = 'Z';
+            
+            mk_symbol_table_t symbol_table;
+            mk_string_table_t string_table;
+            expect(mk_symbol_table_init_with_segment(linkedit, &symbol_table)).to.equal(MK_ESUCCESS);
+            expect(mk_string_table_init_with_segment(linkedit, &string_table)).to.equal(MK_ESUCCESS);
+            
+            expect(mk_symbol_table_find_symbol_named(&symbol_table, &string_table, "Zebra", NULL, NULL).any).to.beNil();
+            expect(mk_symbol_table_find_symbol_named(&symbol_table, &string_table, "Z", NULL, NULL).any).to.equal((void*)&nlists[last]);
+            
+            *end = byte;
+            nlists[last].n_un.n_strx = strx;
+        });
+    });
+}
+SpecEnd
@@ -0,0 +1,148 @@
+//----------------------------------------------------------------------------//
+//|
+//|             MachOKit - A Lightweight Mach-O Parsing Library
+//|             SyntheticMachO.h
+//|
+//|             D.V.
+//|             Copyright (c) 2014-2015 D.V. All rights reserved.
+//|
+//| Permission is hereby granted, free of charge, to any person obtaining a
+//| copy of this software and associated documentation files (the "Software"),
+//| to deal in the Software without restriction, including without limitation
+//| the rights to use, copy, modify, merge, publish, distribute, sublicense,
+//| and/or sell copies of the Software, and to permit persons to whom the
+//| Software is furnished to do so, subject to the following conditions:
+//|
+//| The above copyright notice and this permission notice shall be included
+//| in all copies or substantial portions of the Software.
+//|
+//| THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+//| OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+//| MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+//| IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+//| CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+//| TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+//| SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+//----------------------------------------------------------------------------//
+
+#import <Foundation/Foundation.h>
+#import <MachOKit/MachOKit.h>
+
+//----------------------------------------------------------------------------//
+//! Describes the contents of a synthetic Mach-O image.  Every count scales
+//! a different part of the parser so that benchmarks can isolate it.
+//
+@interface SyntheticMachOConfiguration : NSObject <NSCopying>
+
+//! Returns a configuration where every count is proportional to \a scale.
++ (instancetype)configurationWithScale:(NSUInteger)scale;
+
+//! Number of LC_RPATH commands added after the required load commands.
+@property (nonatomic, assign) NSUInteger loadCommandCount;
+//! Number of defined, exported symbols.
+@property (nonatomic, assign) NSUInteger symbolCount;
+//! Number of levels the exported symbol names are split into.  Controls
+//! the depth of the exports trie.
+@property (nonatomic, assign) NSUInteger exportsTrieDepth;
+//! Number of exported symbols, starting with the first, that are exported
+//! as re-exports from the first dependent library rather than defined.
+@property (nonatomic, assign) NSUInteger reExportCount;
+//! Number of pointers in __DATA,__data that require a rebase.  Rebases for
+//! Objective-C metadata are added on top of this.
+@property (nonatomic, assign) NSUInteger rebaseCount;
+//! Number of undefined symbols, each bound once from __DATA,__got.
+@property (nonatomic, assign) NSUInteger bindCount;
+//! Number of weak binds, each to a pointer in __DATA,__data.  At most
+//! \c rebaseCount.
+@property (nonatomic, assign) NSUInteger weakBindCount;
+//! Number of lazy binds, each to a pointer in __DATA,__got.  At most
+//! \c bindCount.
+@property (nonatomic, assign) NSUInteger lazyBindCount;
+//! Encode the binds from __DATA,__got as a threaded bind chain rather than
+//! one bind opcode per pointer.
+@property (nonatomic, assign) BOOL threadedBinds;
+@property (nonatomic, assign) NSUInteger objcClassCount;
+@property (nonatomic, assign) NSUInteger functionStartCount;
+//! The \c DYLD_CHAINED_PTR_* format used to encode rebases and binds as
+//! chained fixups, or 0 to emit rebase and bind opcodes.  Only
+//! \c DYLD_CHAINED_PTR_64, \c DYLD_CHAINED_PTR_64_OFFSET,
+//! \c DYLD_CHAINED_PTR_ARM64E and \c DYLD_CHAINED_PTR_ARM64E_USERLAND are
+//! supported.
+@property (nonatomic, assign) uint16_t chainedPointerFormat;
+//! The split segment info format describing the references from
+//! __DATA,__data to __TEXT,__text, as an \c MKSplitSegmentInfoFormat, or 0
+//! to omit LC_SEGMENT_SPLIT_INFO.
+@property (nonatomic, assign) uint8_t splitSegmentInfoFormat;
+//! Number of LC_DATA_IN_CODE entries.  Entry \c i covers 8 bytes at offset
+//! \c 32*i of __TEXT,__text and has the kind \c 1+i%4.  Limited by the size
+//! of __text.
+@property (nonatomic, assign) NSUInteger dataInCodeCount;
+
+@end
+
+
+
+//----------------------------------------------------------------------------//
+//! Generates synthetic arm64 dylibs and shared caches for benchmarking.
+//! The output is deterministic for a given configuration.
+//
+@interface SyntheticMachO : NSObject
+
+//! Returns a Mach-O image whose segments start at \a baseAddress and whose
+//! file offsets are relative to \a fileOffset.
++ (NSData*)machOWithConfiguration:(SyntheticMachOConfiguration*)configuration baseAddress:(uint64_t)baseAddress fileOffset:(uint64_t)fileOffset;
+
++ (BOOL)writeMachOWithConfiguration:(SyntheticMachOConfiguration*)configuration toURL:(NSURL*)url error:(NSError**)error;
+
+//! Writes a universal binary to \a url with one slice per entry of
+//! \a architectures, each an \c NSArray holding a cputype and a cpusubtype.
+//! The header uses \c FAT_MAGIC_64 if \a fat64 is \c YES.
++ (BOOL)writeFatBinaryWithConfiguration:(SyntheticMachOConfiguration*)configuration architectures:(NSArray<NSArray<NSNumber*>*> *)architectures fat64:(BOOL)fat64 toURL:(NSURL*)url error:(NSError**)error;
+
+//! Writes a shared cache to \a url, and its sub-caches alongside it with the
+//! suffixes \c .01, \c .02, etc.  The \a imageCount images are distributed
+//! across the sub-caches round-robin.  Each odd-numbered image is installed
+//! under \c /System/iOSSupport with the same file name as the image before
+//! it.
++ (BOOL)writeSharedCacheWithConfiguration:(SyntheticMachOConfiguration*)configuration imageCount:(NSUInteger)imageCount subCacheCount:(NSUInteger)subCacheCount toURL:(NSURL*)url error:(NSError**)error;
+
+@end
+
+
+
+//----------------------------------------------------------------------------//
+//! A temporary directory holding the synthetic files of one describe block.
+//! The directory is created on first use and removed after the examples of
+//! the enclosing describe block have run.
+//
+@interface SyntheticMachOFixture : NSObject
+
+//! Returns a fixture whose directory is named after \a name and the current
+//! process.  Must be called while a describe block is being defined, as it
+//! registers an \c afterAll block.
++ (instancetype)fixtureWithName:(NSString*)name;
+
+//! The directory holding the files of the fixture.
+@property (nonatomic, readonly) NSURL *directoryURL;
+
+//! Returns the URL of the file named \a name in the fixture directory,
+//! creating the directory if needed.
+- (NSURL*)URLForFileWithName:(NSString*)name;
+
+//! Writes a synthetic image generated from \a configuration to the file
+//! named \a name, and returns it loaded from a file memory map.
+- (MKMachOImage*)imageWithConfiguration:(SyntheticMachOConfiguration*)configuration name:(NSString*)name error:(NSError**)error;
+
+//! Writes \a contents to the file named \a name, and returns it loaded from
+//! a file memory map.
+- (MKMachOImage*)imageWithContents:(NSData*)contents name:(NSString*)name error:(NSError**)error;
+
+//! Returns the image previously written to the file named \a name, loaded
+//! from a new file memory map.
+- (MKMachOImage*)imageWithName:(NSString*)name error:(NSError**)error;
+
+//! Returns the image previously written to the file named \a name, loaded
+//! from a new file memory map with the work budget \a budget.
+- (MKMachOImage*)imageWithName:(NSString*)name budget:(mk_context_budget_t)budget error:(NSError**)error;
+
+@end
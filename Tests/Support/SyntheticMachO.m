@@ -0,0 +1,1172 @@
+//----------------------------------------------------------------------------//
+//|
+//|             MachOKit - A Lightweight Mach-O Parsing Library
+//|             SyntheticMachO.m
+//|
+//|             D.V.
+//|             Copyright (c) 2014-2015 D.V. All rights reserved.
+//|
+//| Permission is hereby granted, free of charge, to any person obtaining a
+//| copy of this software and associated documentation files (the "Software"),
+//| to deal in the Software without restriction, including without limitation
+//| the rights to use, copy, modify, merge, publish, distribute, sublicense,
+//| and/or sell copies of the Software, and to permit persons to whom the
+//| Software is furnished to do so, subject to the following conditions:
+//|
+//| The above copyright notice and this permission notice shall be included
+//| in all copies or substantial portions of the Software.
+//|
+//| THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+//| OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+//| MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+//| IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+//| CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+//| TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+//| SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+//----------------------------------------------------------------------------//
+
+#import "SyntheticMachO.h"
+
+#include <mach-o/loader.h>
+#include <mach-o/fat.h>
+#include <mach-o/nlist.h>
+#include <mach-o/fixup-chains.h>
+#include <MachOKit/dyld_cache_format.h>
+
+#define SYNTHETIC_PAGE_SIZE         0x4000
+#define SYNTHETIC_SHARED_REGION     0x180000000ULL
+#define SYNTHETIC_INSTALL_NAME      "/usr/lib/libSynthetic.dylib"
+
+//|++++++++++++++++++++++++++++++++++++|//
+static uint64_t
+SyntheticAlign(uint64_t value, uint64_t alignment)
+{ return (value + alignment - 1) & ~(alignment - 1); }
+
+//|++++++++++++++++++++++++++++++++++++|//
+static size_t
+SyntheticULEBSize(uint64_t value)
+{
+    size_t size = 1;
+    while (value >= 0x80) { value >>= 7; size++; }
+    return size;
+}
+
+//|++++++++++++++++++++++++++++++++++++|//
+static void
+SyntheticAppendULEB(NSMutableData *data, uint64_t value)
+{
+    do {
+        uint8_t byte = value & 0x7F;
+        value >>= 7;
+        if (value) byte |= 0x80;
+        [data appendBytes:&byte length:1];
+    } while (value);
+}
+
+//|++++++++++++++++++++++++++++++++++++|//
+static void
+SyntheticAppendByte(NSMutableData *data, uint8_t byte)
+{ [data appendBytes:&byte length:1]; }
+
+//◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦//
+#pragma mark -  Exports Trie
+//◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦//
+
+typedef struct SyntheticTrieNode SyntheticTrieNode;
+
+typedef struct SyntheticTrieEdge {
+    const char *label;
+    size_t length;
+    SyntheticTrieNode *node;
+} SyntheticTrieEdge;
+
+struct SyntheticTrieNode {
+    bool terminal;
+    //! Re-exported from the first dependent library, under the same name.
+    bool reexport;
+    uint64_t address;
+    uint32_t childCount;
+    SyntheticTrieEdge *children;
+    uint64_t offset;
+};
+
+//|++++++++++++++++++++++++++++++++++++|//
+//! Builds the trie for the sorted, unique \a names in [\a lo, \a hi) which
+//! share their first \a depth characters.  The first \a reExportCount
+//! names are re-exports.  Nodes are appended to \a nodes in pre-order,
+//! which is the order they are serialized in.
+static SyntheticTrieNode*
+SyntheticTrieBuild(const char **names, const uint64_t *addresses, NSUInteger reExportCount, NSUInteger lo, NSUInteger hi, size_t depth, NSMutableData *nodes)
+{
+    SyntheticTrieNode *node = calloc(1, sizeof(*node));
+    [nodes appendBytes:&node length:sizeof(node)];
+    
+    if (lo < hi && names[lo][depth] == '\0') {
+        node->terminal = true;
+        node->reexport = lo < reExportCount;
+        node->address = addresses[lo];
+        lo++;
+    }
+    
+    for (NSUInteger i = lo; i < hi; ) {
+        NSUInteger j = i + 1;
+        while (j < hi && names[j][depth] == names[i][depth]) j++;
+        node->childCount++;
+        i = j;
+    }
+    
+    node->children = calloc(node->childCount, sizeof(SyntheticTrieEdge));
+    
+    uint32_t child = 0;
+    for (NSUInteger i = lo; i < hi; ) {
+        NSUInteger j = i + 1;
+        while (j < hi && names[j][depth] == names[i][depth]) j++;
+        
+        // The names are sorted, so the common prefix of the group is the
+        // common prefix of its first and last names.
+        size_t length = 1;
+        while (names[i][depth + length] != '\0' && names[i][depth + length] == names[j - 1][depth + length])
+            length++;
+        
+        node->children[child].label = &names[i][depth];
+        node->children[child].length = length;
+        node->children[child].node = SyntheticTrieBuild(names, addresses, reExportCount, i, j, depth + length, nodes);
+        child++;
+        i = j;
+    }
+    
+    return node;
+}
+
+//|++++++++++++++++++++++++++++++++++++|//
+static uint64_t
+SyntheticTrieNodeSize(SyntheticTrieNode *node)
+{
+    uint64_t size;
+    if (node->terminal) {
+        // A re-export has a library ordinal of 1 and an empty import name.
+        uint64_t infoSize = node->reexport ? 3 : 1 /* flags */ + SyntheticULEBSize(node->address);
+        size = SyntheticULEBSize(infoSize) + infoSize;
+    } else
+        size = 1;
+    
+    size += 1; // child count
+    for (uint32_t i = 0; i < node->childCount; i++)
+        size += node->children[i].length + 1 + SyntheticULEBSize(node->children[i].node->offset);
+    
+    return size;
+}
+
+//|++++++++++++++++++++++++++++++++++++|//
+static NSData*
+SyntheticExportsTrie(const char **names, const uint64_t *addresses, NSUInteger reExportCount, NSUInteger count)
+{
+    if (count == 0)
+        return [NSData data];
+    
+    NSMutableData *nodeList = [NSMutableData data];
+    SyntheticTrieBuild(names, addresses, reExportCount, 0, count, 0, nodeList);
+    
+    SyntheticTrieNode **nodes = (SyntheticTrieNode**)nodeList.mutableBytes;
+    NSUInteger nodeCount = nodeList.length / sizeof(SyntheticTrieNode*);
+    
+    // Child offsets are ULEB encoded, so node sizes depend on the offsets of
+    // later nodes.  Iterate until the layout is stable.
+    bool changed = true;
+    while (changed) {
+        changed = false;
+        uint64_t offset = 0;
+        for (NSUInteger i = 0; i < nodeCount; i++) {
+            if (nodes[i]->offset != offset) {
+                nodes[i]->offset = offset;
+                changed = true;
+            }
+            offset += SyntheticTrieNodeSize(nodes[i]);
+        }
+    }
+    
+    NSMutableData *trie = [NSMutableData data];
+    for (NSUInteger i = 0; i < nodeCount; i++) {
+        SyntheticTrieNode *node = nodes[i];
+        
+        if (node->terminal && node->reexport) {
+            SyntheticAppendULEB(trie, 3);
+            SyntheticAppendULEB(trie, EXPORT_SYMBOL_FLAGS_REEXPORT);
+            SyntheticAppendULEB(trie, 1);
+            SyntheticAppendByte(trie, 0);
+        } else if (node->terminal) {
+            SyntheticAppendULEB(trie, 1 + SyntheticULEBSize(node->address));
+            SyntheticAppendULEB(trie, 0 /* EXPORT_SYMBOL_FLAGS_KIND_REGULAR */);
+            SyntheticAppendULEB(trie, node->address);
+        } else
+            SyntheticAppendByte(trie, 0);
+        
+        SyntheticAppendByte(trie, (uint8_t)node->childCount);
+        for (uint32_t c = 0; c < node->childCount; c++) {
+            [trie appendBytes:node->children[c].label length:node->children[c].length];
+            SyntheticAppendByte(trie, 0);
+            SyntheticAppendULEB(trie, node->children[c].node->offset);
+        }
+        
+        free(node->children);
+        free(node);
+    }
+    
+    return trie;
+}
+
+
+
+//|++++++++++++++++++++++++++++++++++++|//
+//! Encodes one chained fixup.  \a next is in units of the format's stride.
+static uint64_t
+SyntheticChainedPointer(uint16_t format, bool bind, uint64_t target, uint32_t ordinal, uint64_t next, uint64_t baseAddress)
+{
+    switch (format) {
+        case DYLD_CHAINED_PTR_64:
+        case DYLD_CHAINED_PTR_64_OFFSET:
+            if (bind)
+                return (uint64_t)(ordinal & 0xFFFFFF) | (next << 51) | (1ULL << 63);
+            if (format == DYLD_CHAINED_PTR_64_OFFSET)
+                target -= baseAddress;
+            return (target & 0xFFFFFFFFFULL) | (next << 51);
+        case DYLD_CHAINED_PTR_ARM64E:
+        case DYLD_CHAINED_PTR_ARM64E_USERLAND:
+            if (bind)
+                return (uint64_t)(ordinal & 0xFFFF) | (next << 51) | (1ULL << 62);
+            if (format == DYLD_CHAINED_PTR_ARM64E_USERLAND)
+                target -= baseAddress;
+            return (target & 0x7FFFFFFFFFFULL) | (next << 51);
+        default:
+            return 0;
+    }
+}
+
+//|++++++++++++++++++++++++++++++++++++|//
+//! Rewrites the plain pointers at \a locations (sorted offsets from the start
+//! of \a segment) as fixup chains.  Locations whose ordinal is not
+//! \c UINT32_MAX become binds to that import.
+static void
+SyntheticChainPointers(uint16_t format, uint8_t *segment, const uint64_t *locations, const uint32_t *ordinals, NSUInteger count, uint64_t baseAddress)
+{
+    uint64_t stride = (format == DYLD_CHAINED_PTR_64 || format == DYLD_CHAINED_PTR_64_OFFSET) ? 4 : 8;
+    
+    for (NSUInteger i = 0; i < count; i++) {
+        uint64_t location = locations[i];
+        uint64_t next = 0;
+        if (i + 1 < count && locations[i + 1] / SYNTHETIC_PAGE_SIZE == location / SYNTHETIC_PAGE_SIZE)
+            next = (locations[i + 1] - location) / stride;
+        
+        uint64_t *pointer = (uint64_t*)(segment + location);
+        *pointer = SyntheticChainedPointer(format, ordinals[i] != UINT32_MAX, *pointer, ordinals[i], next, baseAddress);
+    }
+}
+
+//|++++++++++++++++++++++++++++++++++++|//
+//! Returns the LC_DYLD_CHAINED_FIXUPS payload for fixup chains at
+//! \a locations (sorted offsets from the start of the segment at
+//! \a segmentIndex) that bind to \a importNames.
+static NSData*
+SyntheticChainedFixups(uint16_t format, uint64_t segmentOffset, uint64_t segmentSize, uint32_t segmentIndex, uint32_t segmentCount,
+                       const uint64_t *locations, NSUInteger count, char * const *importNames, uint32_t importCount)
+{
+    uint16_t pageCount = (uint16_t)((segmentSize + SYNTHETIC_PAGE_SIZE - 1) / SYNTHETIC_PAGE_SIZE);
+    uint16_t *pageStarts = malloc(MAX(pageCount, (uint16_t)1) * sizeof(uint16_t));
+    for (uint16_t i = 0; i < pageCount; i++)
+        pageStarts[i] = DYLD_CHAINED_PTR_START_NONE;
+    for (NSUInteger i = 0; i < count; i++) {
+        uint64_t page = locations[i] / SYNTHETIC_PAGE_SIZE;
+        if (pageStarts[page] == DYLD_CHAINED_PTR_START_NONE)
+            pageStarts[page] = (uint16_t)(locations[i] % SYNTHETIC_PAGE_SIZE);
+    }
+    
+    NSMutableData *fixups = [NSMutableData dataWithLength:sizeof(struct dyld_chained_fixups_header)];
+    
+    // struct dyld_chained_starts_in_image
+    [fixups setLength:(NSUInteger)SyntheticAlign(fixups.length, 8)];
+    uint32_t startsOffset = (uint32_t)fixups.length;
+    uint32_t segmentInfoOffset = (uint32_t)SyntheticAlign(sizeof(uint32_t) * (1 + segmentCount), 8);
+    [fixups increaseLengthBy:segmentInfoOffset];
+    ((uint32_t*)((uint8_t*)fixups.mutableBytes + startsOffset))[0] = segmentCount;
+    ((uint32_t*)((uint8_t*)fixups.mutableBytes + startsOffset))[1 + segmentIndex] = segmentInfoOffset;
+    
+    // struct dyld_chained_starts_in_segment
+    size_t segmentInfoSize = offsetof(struct dyld_chained_starts_in_segment, page_start) + pageCount * sizeof(uint16_t);
+    struct dyld_chained_starts_in_segment *segmentInfo = calloc(1, segmentInfoSize);
+    segmentInfo->size = (uint32_t)segmentInfoSize;
+    segmentInfo->page_size = SYNTHETIC_PAGE_SIZE;
+    segmentInfo->pointer_format = format;
+    segmentInfo->segment_offset = segmentOffset;
+    segmentInfo->page_count = pageCount;
+    memcpy(segmentInfo->page_start, pageStarts, pageCount * sizeof(uint16_t));
+    [fixups appendBytes:segmentInfo length:segmentInfoSize];
+    free(segmentInfo);
+    free(pageStarts);
+    
+    // Imports, then their names.
+    [fixups setLength:(NSUInteger)SyntheticAlign(fixups.length, 4)];
+    uint32_t importsOffset = (uint32_t)fixups.length;
+    NSMutableData *symbols = [NSMutableData dataWithLength:1];
+    for (uint32_t i = 0; i < importCount; i++) {
+        uint32_t import = 1 | ((uint32_t)symbols.length << 9); // lib_ordinal, weak_import, name_offset
+        [fixups appendBytes:&import length:sizeof(import)];
+        [symbols appendBytes:importNames[i] length:strlen(importNames[i]) + 1];
+    }
+    uint32_t symbolsOffset = (uint32_t)fixups.length;
+    [fixups appendData:symbols];
+    [fixups setLength:(NSUInteger)SyntheticAlign(fixups.length, 8)];
+    
+    struct dyld_chained_fixups_header *header = fixups.mutableBytes;
+    header->fixups_version = 0;
+    header->starts_offset = startsOffset;
+    header->imports_offset = importsOffset;
+    header->symbols_offset = symbolsOffset;
+    header->imports_count = importCount;
+    header->imports_format = DYLD_CHAINED_IMPORT;
+    header->symbols_format = 0;
+    
+    return fixups;
+}
+
+
+
+//----------------------------------------------------------------------------//
+@implementation SyntheticMachOConfiguration
+
+//|++++++++++++++++++++++++++++++++++++|//
++ (instancetype)configurationWithScale:(NSUInteger)scale
+{
+    SyntheticMachOConfiguration *configuration = [self new];
+    configuration.loadCommandCount = 4 * scale;
+    configuration.symbolCount = 256 * scale;
+    configuration.exportsTrieDepth = 4;
+    configuration.rebaseCount = 256 * scale;
+    configuration.bindCount = 128 * scale;
+    configuration.objcClassCount = 32 * scale;
+    configuration.functionStartCount = 256 * scale;
+    return configuration;
+}
+
+//|++++++++++++++++++++++++++++++++++++|//
+- (id)copyWithZone:(NSZone*)zone
+{
+    SyntheticMachOConfiguration *copy = [[self.class allocWithZone:zone] init];
+    copy.loadCommandCount = self.loadCommandCount;
+    copy.symbolCount = self.symbolCount;
+    copy.exportsTrieDepth = self.exportsTrieDepth;
+    copy.reExportCount = self.reExportCount;
+    copy.rebaseCount = self.rebaseCount;
+    copy.bindCount = self.bindCount;
+    copy.objcClassCount = self.objcClassCount;
+    copy.functionStartCount = self.functionStartCount;
+    copy.weakBindCount = self.weakBindCount;
+    copy.lazyBindCount = self.lazyBindCount;
+    copy.threadedBinds = self.threadedBinds;
+    copy.chainedPointerFormat = self.chainedPointerFormat;
+    copy.splitSegmentInfoFormat = self.splitSegmentInfoFormat;
+    copy.dataInCodeCount = self.dataInCodeCount;
+    return copy;
+}
+
+//|++++++++++++++++++++++++++++++++++++|//
+- (NSString*)description
+{
+    return [NSString stringWithFormat:@"<%@ lc=%lu sym=%lu depth=%lu rebase=%lu bind=%lu weak=%lu lazy=%lu threaded=%d objc=%lu fstarts=%lu chained=%u split=%u dice=%lu>", self.class,
+            (unsigned long)self.loadCommandCount, (unsigned long)self.symbolCount, (unsigned long)self.exportsTrieDepth,
+            (unsigned long)self.rebaseCount, (unsigned long)self.bindCount, (unsigned long)self.weakBindCount,
+            (unsigned long)self.lazyBindCount, (int)self.threadedBinds, (unsigned long)self.objcClassCount,
+            (unsigned long)self.functionStartCount, (unsigned)self.chainedPointerFormat,
+            (unsigned)self.splitSegmentInfoFormat, (unsigned long)self.dataInCodeCount];
+}
+
+@end
+
+
+
+//----------------------------------------------------------------------------//
+@implementation SyntheticMachO
+
+//|++++++++++++++++++++++++++++++++++++|//
++ (NSData*)machOWithConfiguration:(SyntheticMachOConfiguration*)configuration baseAddress:(uint64_t)baseAddress fileOffset:(uint64_t)fileOffset uuid:(uint8_t *)uuidOut
+{
+    const uint64_t N = configuration.symbolCount;
+    const uint64_t U = configuration.bindCount;
+    const uint64_t R = configuration.rebaseCount;
+    const uint64_t C = configuration.objcClassCount;
+    const uint64_t F = configuration.functionStartCount;
+    const uint64_t L = configuration.loadCommandCount;
+    const uint64_t depth = MAX(configuration.exportsTrieDepth, (NSUInteger)1);
+    const uint16_t chainedFormat = configuration.chainedPointerFormat;
+    const uint64_t W = MIN((uint64_t)configuration.weakBindCount, R);
+    const uint64_t Z = MIN((uint64_t)configuration.lazyBindCount, U);
+    const bool threaded = configuration.threadedBinds && !chainedFormat;
+    const uint8_t splitFormat = configuration.splitSegmentInfoFormat;
+    
+    // Names.  Each level of an exported name is a zero padded digit so that
+    // the names sort in index order and share prefixes level by level.
+    uint64_t radix = MAX((uint64_t)ceil(pow((double)MAX(N, (uint64_t)1), 1.0 / (double)depth)), (uint64_t)2);
+    int width = snprintf(NULL, 0, "%llu", radix - 1);
+    
+    NSMutableArray<NSString*> *classNames = [NSMutableArray arrayWithCapacity:C];
+    for (uint64_t i = 0; i < C; i++)
+        [classNames addObject:[NSString stringWithFormat:@"SyntheticClass%08llu", i]];
+    
+    char **symbolNames = calloc(N + U, sizeof(char*));
+    for (uint64_t i = 0; i < N; i++) {
+        NSMutableString *name = [NSMutableString stringWithString:@"_s"];
+        uint64_t divisor = 1;
+        for (uint64_t level = 1; level < depth; level++) divisor *= radix;
+        for (uint64_t level = 0; level < depth; level++, divisor /= radix)
+            [name appendFormat:@"%0*llu_", width, (i / divisor) % radix];
+        symbolNames[i] = strdup(name.UTF8String);
+    }
+    for (uint64_t i = 0; i < U; i++)
+        asprintf(&symbolNames[N + i], "_ext%08llu", i);
+    char **weakNames = calloc(MAX(W, (uint64_t)1), sizeof(char*));
+    for (uint64_t i = 0; i < W; i++)
+        asprintf(&weakNames[i], "_weak%08llu", i);
+    
+    // Load commands.
+    const char *rpathFormat = "@loader_path/synthetic/%08llu";
+    uint32_t textSectionCount = 1 + (C > 0);
+    uint32_t dataSectionCount = (U > 0) + (R > 0) + (C > 0 ? 3 : 0);
+    uint32_t idDylibSize = (uint32_t)SyntheticAlign(sizeof(struct dylib_command) + sizeof(SYNTHETIC_INSTALL_NAME), 8);
+    uint32_t loadDylibSize = (uint32_t)SyntheticAlign(sizeof(struct dylib_command) + sizeof("/usr/lib/libSystem.B.dylib"), 8);
+    uint32_t rpathSize = (uint32_t)SyntheticAlign(sizeof(struct rpath_command) + (size_t)snprintf(NULL, 0, rpathFormat, 0ULL) + 1, 8);
+    
+    // Chained fixups replace LC_DYLD_INFO_ONLY with LC_DYLD_CHAINED_FIXUPS
+    // and LC_DYLD_EXPORTS_TRIE.
+    uint32_t ncmds = 10 + (uint32_t)L + (chainedFormat ? 1 : 0) + (splitFormat ? 1 : 0) + (configuration.dataInCodeCount ? 1 : 0);
+    uint64_t sizeofcmds = 3 * sizeof(struct segment_command_64) + (textSectionCount + dataSectionCount) * sizeof(struct section_64)
+        + idDylibSize + loadDylibSize + (chainedFormat ? 2 * sizeof(struct linkedit_data_command) : sizeof(struct dyld_info_command)) + sizeof(struct symtab_command)
+        + sizeof(struct dysymtab_command) + sizeof(struct uuid_command) + sizeof(struct linkedit_data_command)
+        + (splitFormat ? sizeof(struct linkedit_data_command) : 0) + (configuration.dataInCodeCount ? sizeof(struct linkedit_data_command) : 0)
+        + L * rpathSize;
+    
+    // __TEXT
+    uint64_t textOff = SyntheticAlign(sizeof(struct mach_header_64) + sizeofcmds, 16);
+    uint64_t textSize = SyntheticAlign(MAX(MAX(16 * F, 4 * N), (uint64_t)16), 16);
+    const uint64_t D = MIN((uint64_t)configuration.dataInCodeCount, textSize / 32);
+    uint64_t classNameOff = textOff + textSize;
+    uint64_t classNameSize = 0;
+    for (NSString *name in classNames) classNameSize += strlen(name.UTF8String) + 1;
+    uint64_t textSegmentSize = SyntheticAlign(classNameOff + classNameSize, SYNTHETIC_PAGE_SIZE);
+    
+    // __DATA
+    uint64_t dataSegmentOff = textSegmentSize;
+    uint64_t gotOff = dataSegmentOff;
+    uint64_t dataOff = gotOff + 8 * U;
+    uint64_t classListOff = dataOff + 8 * R;
+    uint64_t objcDataOff = classListOff + 8 * C;
+    uint64_t objcConstOff = objcDataOff + 80 * C;
+    uint64_t dataEnd = objcConstOff + 144 * C;
+    uint64_t dataSegmentSize = MAX(SyntheticAlign(dataEnd - dataSegmentOff, SYNTHETIC_PAGE_SIZE), (uint64_t)SYNTHETIC_PAGE_SIZE);
+    
+    // Rebase locations, as offsets from the start of __DATA, and the
+    // pointer values written there.
+    NSMutableData *rebaseLocations = [NSMutableData data];
+    #define REBASE(OFF) do { uint64_t _off = (OFF) - dataSegmentOff; [rebaseLocations appendBytes:&_off length:sizeof(_off)]; } while (0)
+    for (uint64_t i = 0; i < R; i++) REBASE(dataOff + 8 * i);
+    for (uint64_t i = 0; i < C; i++) REBASE(classListOff + 8 * i);
+    for (uint64_t i = 0; i < C; i++) {
+        uint64_t cls = objcDataOff + 80 * i;
+        REBASE(cls + 0); REBASE(cls + 32);
+        REBASE(cls + 40); REBASE(cls + 48); REBASE(cls + 72);
+    }
+    for (uint64_t i = 0; i < C; i++) {
+        uint64_t ro = objcConstOff + 144 * i;
+        REBASE(ro + 24); REBASE(ro + 72 + 24);
+    }
+    #undef REBASE
+    
+    // Fixup chain locations, sorted, and the import each one binds to.
+    NSUInteger fixupCount = rebaseLocations.length / sizeof(uint64_t) + U;
+    uint64_t *fixupLocations = calloc(MAX(fixupCount, (NSUInteger)1), sizeof(uint64_t));
+    uint32_t *fixupOrdinals = calloc(MAX(fixupCount, (NSUInteger)1), sizeof(uint32_t));
+    {
+        NSUInteger i = 0;
+        for (uint64_t j = 0; j < U; j++, i++) {
+            fixupLocations[i] = gotOff - dataSegmentOff + 8 * j;
+            fixupOrdinals[i] = (uint32_t)j;
+        }
+        const uint64_t *locations = rebaseLocations.bytes;
+        for (NSUInteger j = 0; j < rebaseLocations.length / sizeof(uint64_t); j++, i++) {
+            fixupLocations[i] = locations[j];
+            fixupOrdinals[i] = UINT32_MAX;
+        }
+        // Insertion sort; the rebase locations are nearly sorted already.
+        for (i = 1; i < fixupCount; i++) {
+            uint64_t location = fixupLocations[i];
+            uint32_t ordinal = fixupOrdinals[i];
+            NSUInteger k = i;
+            for (; k > 0 && fixupLocations[k - 1] > location; k--) {
+                fixupLocations[k] = fixupLocations[k - 1];
+                fixupOrdinals[k] = fixupOrdinals[k - 1];
+            }
+            fixupLocations[k] = location;
+            fixupOrdinals[k] = ordinal;
+        }
+    }
+    
+    // __LINKEDIT
+    NSData *chainedFixups = chainedFormat
+        ? SyntheticChainedFixups(chainedFormat, dataSegmentOff, dataSegmentSize, 1, 3, fixupLocations, fixupCount, symbolNames + N, (uint32_t)U)
+        : [NSData data];
+    
+    NSMutableData *rebase = [NSMutableData data];
+    if (!chainedFormat) {
+        const uint64_t *locations = rebaseLocations.bytes;
+        NSUInteger count = rebaseLocations.length / sizeof(uint64_t);
+        SyntheticAppendByte(rebase, REBASE_OPCODE_SET_TYPE_IMM | REBASE_TYPE_POINTER);
+        for (NSUInteger i = 0; i < count; i++) {
+            SyntheticAppendByte(rebase, REBASE_OPCODE_SET_SEGMENT_AND_OFFSET_ULEB | 1);
+            SyntheticAppendULEB(rebase, locations[i]);
+            SyntheticAppendByte(rebase, REBASE_OPCODE_DO_REBASE_IMM_TIMES | 1);
+        }
+        SyntheticAppendByte(rebase, REBASE_OPCODE_DONE);
+    }
+    
+    NSMutableData *bind = [NSMutableData data];
+    if (!chainedFormat && threaded && U > 0) {
+        // The ordinal table, then a single chain through __got.
+        SyntheticAppendByte(bind, BIND_OPCODE_THREADED | BIND_SUBOPCODE_THREADED_SET_BIND_ORDINAL_TABLE_SIZE_ULEB);
+        SyntheticAppendULEB(bind, U);
+        SyntheticAppendByte(bind, BIND_OPCODE_SET_DYLIB_ORDINAL_IMM | 1);
+        for (uint64_t i = 0; i < U; i++) {
+            SyntheticAppendByte(bind, BIND_OPCODE_SET_SYMBOL_TRAILING_FLAGS_IMM);
+            [bind appendBytes:symbolNames[N + i] length:strlen(symbolNames[N + i]) + 1];
+            SyntheticAppendByte(bind, BIND_OPCODE_DO_BIND);
+        }
+        SyntheticAppendByte(bind, BIND_OPCODE_SET_SEGMENT_AND_OFFSET_ULEB | 1);
+        SyntheticAppendULEB(bind, gotOff - dataSegmentOff);
+        SyntheticAppendByte(bind, BIND_OPCODE_THREADED | BIND_SUBOPCODE_THREADED_APPLY);
+        SyntheticAppendByte(bind, BIND_OPCODE_DONE);
+    } else if (!chainedFormat && U > 0) {
+        SyntheticAppendByte(bind, BIND_OPCODE_SET_DYLIB_ORDINAL_IMM | 1);
+        SyntheticAppendByte(bind, BIND_OPCODE_SET_TYPE_IMM | BIND_TYPE_POINTER);
+        for (uint64_t i = 0; i < U; i++) {
+            SyntheticAppendByte(bind, BIND_OPCODE_SET_SYMBOL_TRAILING_FLAGS_IMM);
+            [bind appendBytes:symbolNames[N + i] length:strlen(symbolNames[N + i]) + 1];
+            SyntheticAppendByte(bind, BIND_OPCODE_SET_SEGMENT_AND_OFFSET_ULEB | 1);
+            SyntheticAppendULEB(bind, gotOff - dataSegmentOff + 8 * i);
+            SyntheticAppendByte(bind, BIND_OPCODE_DO_BIND);
+        }
+        SyntheticAppendByte(bind, BIND_OPCODE_DONE);
+    }
+    
+    NSMutableData *weakBind = [NSMutableData data];
+    if (!chainedFormat && W > 0) {
+        SyntheticAppendByte(weakBind, BIND_OPCODE_SET_TYPE_IMM | BIND_TYPE_POINTER);
+        for (uint64_t i = 0; i < W; i++) {
+            SyntheticAppendByte(weakBind, BIND_OPCODE_SET_SYMBOL_TRAILING_FLAGS_IMM);
+            [weakBind appendBytes:weakNames[i] length:strlen(weakNames[i]) + 1];
+            SyntheticAppendByte(weakBind, BIND_OPCODE_SET_SEGMENT_AND_OFFSET_ULEB | 1);
+            SyntheticAppendULEB(weakBind, dataOff - dataSegmentOff + 8 * i);
+            SyntheticAppendByte(weakBind, BIND_OPCODE_DO_BIND);
+        }
+        SyntheticAppendByte(weakBind, BIND_OPCODE_DONE);
+    }
+    
+    // Each lazy bind is a separate stream terminated by DONE.
+    NSMutableData *lazyBind = [NSMutableData data];
+    if (!chainedFormat) {
+        for (uint64_t i = 0; i < Z; i++) {
+            SyntheticAppendByte(lazyBind, BIND_OPCODE_SET_SEGMENT_AND_OFFSET_ULEB | 1);
+            SyntheticAppendULEB(lazyBind, gotOff - dataSegmentOff + 8 * i);
+            SyntheticAppendByte(lazyBind, BIND_OPCODE_SET_DYLIB_ORDINAL_IMM | 1);
+            SyntheticAppendByte(lazyBind, BIND_OPCODE_SET_SYMBOL_TRAILING_FLAGS_IMM);
+            [lazyBind appendBytes:symbolNames[N + i] length:strlen(symbolNames[N + i]) + 1];
+            SyntheticAppendByte(lazyBind, BIND_OPCODE_DO_BIND);
+            SyntheticAppendByte(lazyBind, BIND_OPCODE_DONE);
+        }
+    }
+    
+    uint64_t *symbolOffsets = calloc(MAX(N, (uint64_t)1), sizeof(uint64_t));
+    for (uint64_t i = 0; i < N; i++)
+        symbolOffsets[i] = textOff + (4 * i) % textSize;
+    NSData *exports = SyntheticExportsTrie((const char**)symbolNames, symbolOffsets, MIN((uint64_t)configuration.reExportCount, N), N);
+    
+    NSMutableData *functionStarts = [NSMutableData data];
+    if (F > 0) {
+        SyntheticAppendULEB(functionStarts, textOff);
+        for (uint64_t i = 1; i < F; i++)
+            SyntheticAppendULEB(functionStarts, 16);
+        SyntheticAppendByte(functionStarts, 0);
+    }
+    
+    // Split segment info for the pointers in __data, which target __text.
+    // V1 records the locations as offsets from the start of the image.  V2
+    // groups them by target offset; sections are numbered from 1 in load
+    // command order.
+    NSMutableData *splitSegmentInfo = [NSMutableData data];
+    if (splitFormat == 1 && R > 0) {
+        SyntheticAppendByte(splitSegmentInfo, 2); // DYLD_CACHE_ADJ_V1_POINTER_64
+        SyntheticAppendULEB(splitSegmentInfo, dataOff);
+        for (uint64_t i = 1; i < R; i++)
+            SyntheticAppendULEB(splitSegmentInfo, 8);
+        SyntheticAppendByte(splitSegmentInfo, 0);
+        SyntheticAppendByte(splitSegmentInfo, 0);
+    } else if (splitFormat == 2 && R > 0) {
+        // The pointer at index i targets offset (16 * i) % textSize.
+        uint64_t targetCount = MIN(R, textSize / 16);
+        SyntheticAppendByte(splitSegmentInfo, 0x7F); // DYLD_CACHE_ADJ_V2_FORMAT
+        SyntheticAppendULEB(splitSegmentInfo, 1);
+        SyntheticAppendULEB(splitSegmentInfo, 1 + textSectionCount + (U > 0));
+        SyntheticAppendULEB(splitSegmentInfo, 1);
+        SyntheticAppendULEB(splitSegmentInfo, targetCount);
+        for (uint64_t t = 0; t < targetCount; t++) {
+            SyntheticAppendULEB(splitSegmentInfo, t ? 16 : 0);
+            SyntheticAppendULEB(splitSegmentInfo, 1);
+            SyntheticAppendULEB(splitSegmentInfo, 2); // DYLD_CACHE_ADJ_V2_POINTER_64
+            SyntheticAppendULEB(splitSegmentInfo, (R - t + targetCount - 1) / targetCount);
+            for (uint64_t i = t; i < R; i += targetCount)
+                SyntheticAppendULEB(splitSegmentInfo, (i == t) ? 8 * i : 8 * targetCount);
+        }
+        SyntheticAppendByte(splitSegmentInfo, 0);
+    }
+    
+    NSMutableData *dataInCode = [NSMutableData data];
+    for (uint64_t i = 0; i < D; i++) {
+        struct data_in_code_entry entry = { .offset = (uint32_t)(textOff + 32 * i), .length = 8, .kind = (uint16_t)(1 + i % 4) };
+        [dataInCode appendBytes:&entry length:sizeof(entry)];
+    }
+    
+    NSMutableData *strings = [NSMutableData dataWithBytes:" " length:2];
+    uint32_t *stringOffsets = calloc(N + U + 1, sizeof(uint32_t));
+    for (uint64_t i = 0; i < N + U; i++) {
+        stringOffsets[i] = (uint32_t)strings.length;
+        [strings appendBytes:symbolNames[i] length:strlen(symbolNames[i]) + 1];
+    }
+    
+    uint64_t linkeditOff = dataSegmentOff + dataSegmentSize;
+    uint64_t chainedFixupsOff = linkeditOff;
+    uint64_t rebaseOff = SyntheticAlign(chainedFixupsOff + chainedFixups.length, 8);
+    uint64_t bindOff = SyntheticAlign(rebaseOff + rebase.length, 8);
+    uint64_t weakBindOff = SyntheticAlign(bindOff + bind.length, 8);
+    uint64_t lazyBindOff = SyntheticAlign(weakBindOff + weakBind.length, 8);
+    uint64_t exportOff = SyntheticAlign(lazyBindOff + lazyBind.length, 8);
+    uint64_t functionStartsOff = SyntheticAlign(exportOff + exports.length, 8);
+    uint64_t splitSegmentInfoOff = SyntheticAlign(functionStartsOff + functionStarts.length, 8);
+    uint64_t dataInCodeOff = SyntheticAlign(splitSegmentInfoOff + splitSegmentInfo.length, 8);
+    uint64_t symOff = SyntheticAlign(dataInCodeOff + dataInCode.length, 8);
+    uint64_t indirectSymOff = symOff + (N + U) * sizeof(struct nlist_64);
+    uint64_t strOff = SyntheticAlign(indirectSymOff + U * sizeof(uint32_t), 8);
+    uint64_t fileSize = SyntheticAlign(strOff + strings.length, 8);
+    uint64_t linkeditSize = fileSize - linkeditOff;
+    
+    NSMutableData *image = [NSMutableData dataWithLength:(NSUInteger)fileSize];
+    uint8_t *bytes = image.mutableBytes;
+    
+    // UUID, derived from the configuration and placement.
+    uint8_t uuid[16];
+    {
+        uint64_t hash = 0xcbf29ce484222325ULL;
+        uint64_t values[] = { N, U, R, C, F, L, depth, W, Z, threaded, chainedFormat, splitFormat, D, baseAddress, fileOffset };
+        for (size_t i = 0; i < sizeof(values) / sizeof(values[0]); i++) {
+            hash ^= values[i];
+            hash *= 0x100000001b3ULL;
+        }
+        memcpy(&uuid[0], &hash, 8);
+        hash *= 0x100000001b3ULL;
+        memcpy(&uuid[8], &hash, 8);
+        if (uuidOut) memcpy(uuidOut, uuid, 16);
+    }
+    
+    // Header and load commands.
+    struct mach_header_64 *header = (struct mach_header_64*)bytes;
+    header->magic = MH_MAGIC_64;
+    header->cputype = CPU_TYPE_ARM64;
+    header->cpusubtype = (chainedFormat == DYLD_CHAINED_PTR_ARM64E || chainedFormat == DYLD_CHAINED_PTR_ARM64E_USERLAND) ? CPU_SUBTYPE_ARM64E : CPU_SUBTYPE_ARM64_ALL;
+    header->filetype = MH_DYLIB;
+    header->ncmds = ncmds;
+    header->sizeofcmds = (uint32_t)sizeofcmds;
+    header->flags = MH_DYLDLINK | MH_TWOLEVEL | MH_NO_REEXPORTED_DYLIBS;
+    
+    uint8_t *lc = bytes + sizeof(*header);
+    
+    #define SECTION(SEG, SECT, SEGNAME, SECTNAME, OFF, SIZE, ALIGN, FLAGS) do { \
+            struct section_64 *_s = (SECT)++; \
+            strncpy(_s->segname, SEGNAME, sizeof(_s->segname)); \
+            strncpy(_s->sectname, SECTNAME, sizeof(_s->sectname)); \
+            _s->addr = baseAddress + (OFF); \
+            _s->size = (SIZE); \
+            _s->offset = (uint32_t)(fileOffset + (OFF)); \
+            _s->align = (ALIGN); \
+            _s->flags = (FLAGS); \
+            (SEG)->nsects++; \
+        } while (0)
+    
+    struct segment_command_64 *text = (struct segment_command_64*)lc;
+    text->cmd = LC_SEGMENT_64;
+    text->cmdsize = (uint32_t)(sizeof(*text) + textSectionCount * sizeof(struct section_64));
+    strncpy(text->segname, SEG_TEXT, sizeof(text->segname));
+    text->vmaddr = baseAddress;
+    text->vmsize = textSegmentSize;
+    text->fileoff = fileOffset;
+    text->filesize = textSegmentSize;
+    text->maxprot = text->initprot = VM_PROT_READ | VM_PROT_EXECUTE;
+    {
+        struct section_64 *sect = (struct section_64*)(text + 1);
+        SECTION(text, sect, SEG_TEXT, SECT_TEXT, textOff, textSize, 4, S_REGULAR | S_ATTR_PURE_INSTRUCTIONS | S_ATTR_SOME_INSTRUCTIONS);
+        if (C > 0) SECTION(text, sect, SEG_TEXT, "__objc_classname", classNameOff, classNameSize, 0, S_CSTRING_LITERALS);
+    }
+    lc += text->cmdsize;
+    
+    struct segment_command_64 *data = (struct segment_command_64*)lc;
+    data->cmd = LC_SEGMENT_64;
+    data->cmdsize = (uint32_t)(sizeof(*data) + dataSectionCount * sizeof(struct section_64));
+    strncpy(data->segname, SEG_DATA, sizeof(data->segname));
+    data->vmaddr = baseAddress + dataSegmentOff;
+    data->vmsize = dataSegmentSize;
+    data->fileoff = fileOffset + dataSegmentOff;
+    data->filesize = dataSegmentSize;
+    data->maxprot = data->initprot = VM_PROT_READ | VM_PROT_WRITE;
+    {
+        struct section_64 *sect = (struct section_64*)(data + 1);
+        if (U > 0) SECTION(data, sect, SEG_DATA, "__got", gotOff, 8 * U, 3, S_NON_LAZY_SYMBOL_POINTERS);
+        if (R > 0) SECTION(data, sect, SEG_DATA, SECT_DATA, dataOff, 8 * R, 3, S_REGULAR);
+        if (C > 0) {
+            SECTION(data, sect, SEG_DATA, "__objc_classlist", classListOff, 8 * C, 3, S_REGULAR | S_ATTR_NO_DEAD_STRIP);
+            SECTION(data, sect, SEG_DATA, "__objc_data", objcDataOff, 80 * C, 3, S_REGULAR);
+            SECTION(data, sect, SEG_DATA, "__objc_const", objcConstOff, 144 * C, 3, S_REGULAR);
+        }
+    }
+    lc += data->cmdsize;
+    #undef SECTION
+    
+    struct segment_command_64 *linkedit = (struct segment_command_64*)lc;
+    linkedit->cmd = LC_SEGMENT_64;
+    linkedit->cmdsize = sizeof(*linkedit);
+    strncpy(linkedit->segname, SEG_LINKEDIT, sizeof(linkedit->segname));
+    linkedit->vmaddr = baseAddress + linkeditOff;
+    linkedit->vmsize = SyntheticAlign(linkeditSize, SYNTHETIC_PAGE_SIZE);
+    linkedit->fileoff = fileOffset + linkeditOff;
+    linkedit->filesize = linkeditSize;
+    linkedit->maxprot = linkedit->initprot = VM_PROT_READ;
+    lc += linkedit->cmdsize;
+    
+    struct dylib_command *idDylib = (struct dylib_command*)lc;
+    idDylib->cmd = LC_ID_DYLIB;
+    idDylib->cmdsize = idDylibSize;
+    idDylib->dylib.name.offset = sizeof(*idDylib);
+    idDylib->dylib.current_version = 0x10000;
+    idDylib->dylib.compatibility_version = 0x10000;
+    memcpy(lc + sizeof(*idDylib), SYNTHETIC_INSTALL_NAME, sizeof(SYNTHETIC_INSTALL_NAME));
+    lc += idDylibSize;
+    
+    if (chainedFormat) {
+        struct linkedit_data_command *fixupsCommand = (struct linkedit_data_command*)lc;
+        fixupsCommand->cmd = LC_DYLD_CHAINED_FIXUPS;
+        fixupsCommand->cmdsize = sizeof(*fixupsCommand);
+        fixupsCommand->dataoff = (uint32_t)(fileOffset + chainedFixupsOff);
+        fixupsCommand->datasize = (uint32_t)chainedFixups.length;
+        lc += fixupsCommand->cmdsize;
+        
+        struct linkedit_data_command *exportsCommand = (struct linkedit_data_command*)lc;
+        exportsCommand->cmd = LC_DYLD_EXPORTS_TRIE;
+        exportsCommand->cmdsize = sizeof(*exportsCommand);
+        exportsCommand->dataoff = exports.length ? (uint32_t)(fileOffset + exportOff) : 0;
+        exportsCommand->datasize = (uint32_t)exports.length;
+        lc += exportsCommand->cmdsize;
+    } else {
+        struct dyld_info_command *dyldInfo = (struct dyld_info_command*)lc;
+        dyldInfo->cmd = LC_DYLD_INFO_ONLY;
+        dyldInfo->cmdsize = sizeof(*dyldInfo);
+        dyldInfo->rebase_off = (uint32_t)(fileOffset + rebaseOff);
+        dyldInfo->rebase_size = (uint32_t)rebase.length;
+        dyldInfo->bind_off = bind.length ? (uint32_t)(fileOffset + bindOff) : 0;
+        dyldInfo->bind_size = (uint32_t)bind.length;
+        dyldInfo->weak_bind_off = weakBind.length ? (uint32_t)(fileOffset + weakBindOff) : 0;
+        dyldInfo->weak_bind_size = (uint32_t)weakBind.length;
+        dyldInfo->lazy_bind_off = lazyBind.length ? (uint32_t)(fileOffset + lazyBindOff) : 0;
+        dyldInfo->lazy_bind_size = (uint32_t)lazyBind.length;
+        dyldInfo->export_off = exports.length ? (uint32_t)(fileOffset + exportOff) : 0;
+        dyldInfo->export_size = (uint32_t)exports.length;
+        lc += dyldInfo->cmdsize;
+    }
+    
+    struct symtab_command *symtab = (struct symtab_command*)lc;
+    symtab->cmd = LC_SYMTAB;
+    symtab->cmdsize = sizeof(*symtab);
+    symtab->symoff = (uint32_t)(fileOffset + symOff);
+    symtab->nsyms = (uint32_t)(N + U);
+    symtab->stroff = (uint32_t)(fileOffset + strOff);
+    symtab->strsize = (uint32_t)(fileSize - strOff);
+    lc += symtab->cmdsize;
+    
+    struct dysymtab_command *dysymtab = (struct dysymtab_command*)lc;
+    dysymtab->cmd = LC_DYSYMTAB;
+    dysymtab->cmdsize = sizeof(*dysymtab);
+    dysymtab->iextdefsym = 0;
+    dysymtab->nextdefsym = (uint32_t)N;
+    dysymtab->iundefsym = (uint32_t)N;
+    dysymtab->nundefsym = (uint32_t)U;
+    dysymtab->indirectsymoff = U ? (uint32_t)(fileOffset + indirectSymOff) : 0;
+    dysymtab->nindirectsyms = (uint32_t)U;
+    lc += dysymtab->cmdsize;
+    
+    struct uuid_command *uuidCommand = (struct uuid_command*)lc;
+    uuidCommand->cmd = LC_UUID;
+    uuidCommand->cmdsize = sizeof(*uuidCommand);
+    memcpy(uuidCommand->uuid, uuid, sizeof(uuid));
+    lc += uuidCommand->cmdsize;
+    
+    struct dylib_command *loadDylib = (struct dylib_command*)lc;
+    loadDylib->cmd = LC_LOAD_DYLIB;
+    loadDylib->cmdsize = loadDylibSize;
+    loadDylib->dylib.name.offset = sizeof(*loadDylib);
+    loadDylib->dylib.current_version = 0x10000;
+    loadDylib->dylib.compatibility_version = 0x10000;
+    memcpy(lc + sizeof(*loadDylib), "/usr/lib/libSystem.B.dylib", sizeof("/usr/lib/libSystem.B.dylib"));
+    lc += loadDylibSize;
+    
+    struct linkedit_data_command *functionStartsCommand = (struct linkedit_data_command*)lc;
+    functionStartsCommand->cmd = LC_FUNCTION_STARTS;
+    functionStartsCommand->cmdsize = sizeof(*functionStartsCommand);
+    functionStartsCommand->dataoff = (uint32_t)(fileOffset + functionStartsOff);
+    functionStartsCommand->datasize = (uint32_t)functionStarts.length;
+    lc += functionStartsCommand->cmdsize;
+    
+    if (splitFormat) {
+        struct linkedit_data_command *splitSegmentInfoCommand = (struct linkedit_data_command*)lc;
+        splitSegmentInfoCommand->cmd = LC_SEGMENT_SPLIT_INFO;
+        splitSegmentInfoCommand->cmdsize = sizeof(*splitSegmentInfoCommand);
+        splitSegmentInfoCommand->dataoff = (uint32_t)(fileOffset + splitSegmentInfoOff);
+        splitSegmentInfoCommand->datasize = (uint32_t)splitSegmentInfo.length;
+        lc += splitSegmentInfoCommand->cmdsize;
+    }
+    
+    if (configuration.dataInCodeCount) {
+        struct linkedit_data_command *dataInCodeCommand = (struct linkedit_data_command*)lc;
+        dataInCodeCommand->cmd = LC_DATA_IN_CODE;
+        dataInCodeCommand->cmdsize = sizeof(*dataInCodeCommand);
+        dataInCodeCommand->dataoff = (uint32_t)(fileOffset + dataInCodeOff);
+        dataInCodeCommand->datasize = (uint32_t)dataInCode.length;
+        lc += dataInCodeCommand->cmdsize;
+    }
+    
+    for (uint64_t i = 0; i < L; i++) {
+        struct rpath_command *rpath = (struct rpath_command*)lc;
+        rpath->cmd = LC_RPATH;
+        rpath->cmdsize = rpathSize;
+        rpath->path.offset = sizeof(*rpath);
+        snprintf((char*)lc + sizeof(*rpath), rpathSize - sizeof(*rpath), rpathFormat, i);
+        lc += rpathSize;
+    }
+    
+    NSAssert(lc == bytes + sizeof(*header) + sizeofcmds, @"Load command size mismatch.");
+    
+    // __TEXT contents.
+    for (uint64_t off = textOff; off < textOff + textSize; off += 4)
+        *(uint32_t*)(bytes + off) = 0xd65f03c0; // ret
+    {
+        uint64_t off = classNameOff;
+        for (NSString *name in classNames) {
+            size_t length = strlen(name.UTF8String) + 1;
+            memcpy(bytes + off, name.UTF8String, length);
+            off += length;
+        }
+    }
+    
+    // __DATA contents.
+    #define PTR(OFF) (*(uint64_t*)(bytes + (OFF)))
+    for (uint64_t i = 0; i < R; i++)
+        PTR(dataOff + 8 * i) = baseAddress + textOff + (16 * i) % textSize;
+    {
+        uint64_t nameOff = classNameOff;
+        for (uint64_t i = 0; i < C; i++) {
+            uint64_t cls = objcDataOff + 80 * i;
+            uint64_t meta = cls + 40;
+            uint64_t ro = objcConstOff + 144 * i;
+            uint64_t metaRo = ro + 72;
+            
+            PTR(classListOff + 8 * i) = baseAddress + cls;
+            
+            PTR(cls + 0) = baseAddress + meta;      // isa
+            PTR(cls + 32) = baseAddress + ro;       // data
+            PTR(meta + 0) = baseAddress + meta;     // isa
+            PTR(meta + 8) = baseAddress + cls;      // superclass
+            PTR(meta + 32) = baseAddress + metaRo;  // data
+            
+            *(uint32_t*)(bytes + ro + 0) = 0x2;     // RO_ROOT
+            *(uint32_t*)(bytes + ro + 4) = 8;
+            *(uint32_t*)(bytes + ro + 8) = 8;
+            PTR(ro + 24) = baseAddress + nameOff;
+            *(uint32_t*)(bytes + metaRo + 0) = 0x3; // RO_META | RO_ROOT
+            *(uint32_t*)(bytes + metaRo + 4) = 40;
+            *(uint32_t*)(bytes + metaRo + 8) = 40;
+            PTR(metaRo + 24) = baseAddress + nameOff;
+            
+            nameOff += strlen(classNames[i].UTF8String) + 1;
+        }
+    }
+    // Threaded binds: bit 62 marks a bind, bits [0..15] hold the ordinal and
+    // bits [51..61] the distance to the next pointer, in pointers.
+    if (threaded)
+        for (uint64_t i = 0; i < U; i++)
+            PTR(gotOff + 8 * i) = (1ULL << 62) | (i & 0xFFFF) | ((uint64_t)(i + 1 < U) << 51);
+    #undef PTR
+    
+    if (chainedFormat)
+        SyntheticChainPointers(chainedFormat, bytes + dataSegmentOff, fixupLocations, fixupOrdinals, fixupCount, baseAddress);
+    
+    // __LINKEDIT contents.
+    memcpy(bytes + chainedFixupsOff, chainedFixups.bytes, chainedFixups.length);
+    memcpy(bytes + rebaseOff, rebase.bytes, rebase.length);
+    memcpy(bytes + bindOff, bind.bytes, bind.length);
+    memcpy(bytes + weakBindOff, weakBind.bytes, weakBind.length);
+    memcpy(bytes + lazyBindOff, lazyBind.bytes, lazyBind.length);
+    memcpy(bytes + exportOff, exports.bytes, exports.length);
+    memcpy(bytes + functionStartsOff, functionStarts.bytes, functionStarts.length);
+    memcpy(bytes + splitSegmentInfoOff, splitSegmentInfo.bytes, splitSegmentInfo.length);
+    memcpy(bytes + dataInCodeOff, dataInCode.bytes, dataInCode.length);
+    {
+        struct nlist_64 *symbols = (struct nlist_64*)(bytes + symOff);
+        for (uint64_t i = 0; i < N; i++) {
+            symbols[i].n_un.n_strx = stringOffsets[i];
+            symbols[i].n_type = N_SECT | N_EXT;
+            symbols[i].n_sect = 1;
+            symbols[i].n_value = baseAddress + symbolOffsets[i];
+        }
+        for (uint64_t i = 0; i < U; i++) {
+            symbols[N + i].n_un.n_strx = stringOffsets[N + i];
+            symbols[N + i].n_type = N_UNDF | N_EXT;
+            SET_LIBRARY_ORDINAL(symbols[N + i].n_desc, 1);
+        }
+        
+        uint32_t *indirectSymbols = (uint32_t*)(bytes + indirectSymOff);
+        for (uint64_t i = 0; i < U; i++)
+            indirectSymbols[i] = (uint32_t)(N + i);
+    }
+    memcpy(bytes + strOff, strings.bytes, strings.length);
+    
+    for (uint64_t i = 0; i < N + U; i++)
+        free(symbolNames[i]);
+    free(symbolNames);
+    for (uint64_t i = 0; i < W; i++)
+        free(weakNames[i]);
+    free(weakNames);
+    free(symbolOffsets);
+    free(stringOffsets);
+    free(fixupLocations);
+    free(fixupOrdinals);
+    
+    return image;
+}
+
+//|++++++++++++++++++++++++++++++++++++|//
++ (NSData*)machOWithConfiguration:(SyntheticMachOConfiguration*)configuration baseAddress:(uint64_t)baseAddress fileOffset:(uint64_t)fileOffset
+{ return [self machOWithConfiguration:configuration baseAddress:baseAddress fileOffset:fileOffset uuid:NULL]; }
+
+//|++++++++++++++++++++++++++++++++++++|//
++ (BOOL)writeMachOWithConfiguration:(SyntheticMachOConfiguration*)configuration toURL:(NSURL*)url error:(NSError**)error
+{
+    NSData *image = [self machOWithConfiguration:configuration baseAddress:0 fileOffset:0];
+    return [image writeToURL:url options:NSDataWritingAtomic error:error];
+}
+
+//|++++++++++++++++++++++++++++++++++++|//
++ (BOOL)writeFatBinaryWithConfiguration:(SyntheticMachOConfiguration*)configuration architectures:(NSArray<NSArray<NSNumber*>*> *)architectures fat64:(BOOL)fat64 toURL:(NSURL*)url error:(NSError**)error
+{
+    // Slices are page aligned.  Their file offsets are relative to the
+    // start of the slice.
+    const uint32_t align = 14;
+    size_t headerSize = sizeof(struct fat_header) + architectures.count * (fat64 ? sizeof(struct fat_arch_64) : sizeof(struct fat_arch));
+    NSMutableData *binary = [NSMutableData dataWithLength:(NSUInteger)SyntheticAlign(headerSize, 1ULL << align)];
+    
+    struct fat_header *header = binary.mutableBytes;
+    header->magic = OSSwapHostToBigInt32(fat64 ? FAT_MAGIC_64 : FAT_MAGIC);
+    header->nfat_arch = OSSwapHostToBigInt32((uint32_t)architectures.count);
+    
+    for (NSUInteger i = 0; i < architectures.count; i++) {
+        NSMutableData *slice = [[self machOWithConfiguration:configuration baseAddress:0 fileOffset:0] mutableCopy];
+        struct mach_header_64 *sliceHeader = slice.mutableBytes;
+        sliceHeader->cputype = architectures[i][0].intValue;
+        sliceHeader->cpusubtype = architectures[i][1].intValue;
+        
+        uint64_t offset = binary.length;
+        [binary appendData:slice];
+        [binary setLength:(NSUInteger)SyntheticAlign(binary.length, 1ULL << align)];
+        
+        uint8_t *entry = (uint8_t*)binary.mutableBytes + sizeof(struct fat_header);
+        if (fat64) {
+            struct fat_arch_64 *arch = (struct fat_arch_64*)entry + i;
+            arch->cputype = (cpu_type_t)OSSwapHostToBigInt32((uint32_t)sliceHeader->cputype);
+            arch->cpusubtype = (cpu_subtype_t)OSSwapHostToBigInt32((uint32_t)sliceHeader->cpusubtype);
+            arch->offset = OSSwapHostToBigInt64(offset);
+            arch->size = OSSwapHostToBigInt64(slice.length);
+            arch->align = OSSwapHostToBigInt32(align);
+        } else {
+            struct fat_arch *arch = (struct fat_arch*)entry + i;
+            arch->cputype = (cpu_type_t)OSSwapHostToBigInt32((uint32_t)sliceHeader->cputype);
+            arch->cpusubtype = (cpu_subtype_t)OSSwapHostToBigInt32((uint32_t)sliceHeader->cpusubtype);
+            arch->offset = OSSwapHostToBigInt32((uint32_t)offset);
+            arch->size = OSSwapHostToBigInt32((uint32_t)slice.length);
+            arch->align = OSSwapHostToBigInt32(align);
+        }
+    }
+    
+    return [binary writeToURL:url options:NSDataWritingAtomic error:error];
+}
+
+//|++++++++++++++++++++++++++++++++++++|//
++ (BOOL)writeSharedCacheWithConfiguration:(SyntheticMachOConfiguration*)configuration imageCount:(NSUInteger)imageCount subCacheCount:(NSUInteger)subCacheCount toURL:(NSURL*)url error:(NSError**)error
+{
+    subCacheCount = MAX(subCacheCount, (NSUInteger)1);
+    
+    // Main cache layout: header, mapping, sub-cache entries, image infos and
+    // image paths.
+    uint64_t mappingOff = sizeof(struct dyld_cache_header);
+    uint64_t subCacheOff = mappingOff + sizeof(struct dyld_cache_mapping_info);
+    uint64_t imagesTextOff = subCacheOff + subCacheCount * sizeof(struct dyld_subcache_entry);
+    uint64_t pathsOff = imagesTextOff + imageCount * sizeof(struct dyld_cache_image_text_info);
+    
+    NSMutableData *paths = [NSMutableData data];
+    uint32_t *pathOffsets = calloc(MAX(imageCount, (NSUInteger)1), sizeof(uint32_t));
+    for (NSUInteger i = 0; i < imageCount; i++) {
+        pathOffsets[i] = (uint32_t)(pathsOff + paths.length);
+        // Pairs of images share a file name, like the iOSSupport copies of
+        // the system frameworks.
+        const char *path = [NSString stringWithFormat:@"%@/usr/lib/synthetic/libSynthetic%05lu.dylib", (i % 2) ? @"/System/iOSSupport" : @"", (unsigned long)(i & ~(NSUInteger)1)].UTF8String;
+        [paths appendBytes:path length:strlen(path) + 1];
+    }
+    
+    uint64_t mainSize = SyntheticAlign(pathsOff + paths.length, SYNTHETIC_PAGE_SIZE);
+    NSMutableData *main = [NSMutableData dataWithLength:(NSUInteger)mainSize];
+    struct dyld_cache_header *mainHeader = main.mutableBytes;
+    struct dyld_subcache_entry *subCacheEntries = (struct dyld_subcache_entry*)((uint8_t*)main.mutableBytes + subCacheOff);
+    struct dyld_cache_image_text_info *imageTexts = (struct dyld_cache_image_text_info*)((uint8_t*)main.mutableBytes + imagesTextOff);
+    memcpy((uint8_t*)main.mutableBytes + pathsOff, paths.bytes, paths.length);
+    
+    uint64_t cacheVMOffset = mainSize;
+    
+    for (NSUInteger k = 0; k < subCacheCount; k++)
+    {
+        NSMutableData *subCache = [NSMutableData dataWithLength:SYNTHETIC_PAGE_SIZE];
+        
+        for (NSUInteger i = k; i < imageCount; i += subCacheCount) {
+            uint64_t imageOff = subCache.length;
+            uint64_t imageAddress = SYNTHETIC_SHARED_REGION + cacheVMOffset + imageOff;
+            
+            uint8_t uuid[16];
+            NSData *image = [self machOWithConfiguration:configuration baseAddress:imageAddress fileOffset:imageOff uuid:uuid];
+            [subCache appendData:image];
+            [subCache setLength:(NSUInteger)SyntheticAlign(subCache.length, SYNTHETIC_PAGE_SIZE)];
+            
+            memcpy(imageTexts[i].uuid, uuid, sizeof(uuid));
+            imageTexts[i].loadAddress = imageAddress;
+            imageTexts[i].textSegmentSize = (uint32_t)image.length;
+            imageTexts[i].pathOffset = pathOffsets[i];
+        }
+        
+        struct dyld_cache_header *header = subCache.mutableBytes;
+        strncpy(header->magic, "dyld_v1   arm64", sizeof(header->magic));
+        header->mappingOffset = (uint32_t)mappingOff;
+        header->mappingCount = 1;
+        header->uuid[0] = 0x5C;
+        header->uuid[1] = (uint8_t)(k + 1);
+        header->uuid[2] = (uint8_t)((k + 1) >> 8);
+        
+        struct dyld_cache_mapping_info *mapping = (struct dyld_cache_mapping_info*)((uint8_t*)subCache.mutableBytes + mappingOff);
+        mapping->address = SYNTHETIC_SHARED_REGION + cacheVMOffset;
+        mapping->size = subCache.length;
+        mapping->fileOffset = 0;
+        mapping->maxProt = mapping->initProt = VM_PROT_READ | VM_PROT_EXECUTE;
+        
+        memcpy(subCacheEntries[k].uuid, header->uuid, sizeof(subCacheEntries[k].uuid));
+        subCacheEntries[k].cacheVMOffset = cacheVMOffset;
+        snprintf(subCacheEntries[k].fileSuffix, sizeof(subCacheEntries[k].fileSuffix), ".%02lu", (unsigned long)(k + 1));
+        
+        NSURL *subCacheURL = [NSURL fileURLWithPath:[url.path stringByAppendingString:@(subCacheEntries[k].fileSuffix)]];
+        if (![subCache writeToURL:subCacheURL options:NSDataWritingAtomic error:error]) {
+            free(pathOffsets);
+            return NO;
+        }
+        
+        cacheVMOffset += subCache.length;
+    }
+    
+    free(pathOffsets);
+    
+    strncpy(mainHeader->magic, "dyld_v1   arm64", sizeof(mainHeader->magic));
+    mainHeader->mappingOffset = (uint32_t)mappingOff;
+    mainHeader->mappingCount = 1;
+    mainHeader->uuid[0] = 0x5C;
+    mainHeader->imagesTextOffset = imagesTextOff;
+    mainHeader->imagesTextCount = imageCount;
+    mainHeader->subCacheArrayOffset = (uint32_t)subCacheOff;
+    mainHeader->subCacheArrayCount = (uint32_t)subCacheCount;
+    mainHeader->sharedRegionStart = SYNTHETIC_SHARED_REGION;
+    mainHeader->sharedRegionSize = cacheVMOffset;
+    
+    struct dyld_cache_mapping_info *mapping = (struct dyld_cache_mapping_info*)((uint8_t*)main.mutableBytes + mappingOff);
+    mapping->address = SYNTHETIC_SHARED_REGION;
+    mapping->size = mainSize;
+    mapping->fileOffset = 0;
+    mapping->maxProt = mapping->initProt = VM_PROT_READ;
+    
+    return [main writeToURL:url options:NSDataWritingAtomic error:error];
+}
+
+@end
+
+
+
+//----------------------------------------------------------------------------//
+@implementation SyntheticMachOFixture
+
+//|++++++++++++++++++++++++++++++++++++|//
++ (instancetype)fixtureWithName:(NSString*)name
+{
+    SyntheticMachOFixture *fixture = [self new];
+    fixture->_directoryURL = [NSURL fileURLWithPath:[NSTemporaryDirectory() stringByAppendingPathComponent:[NSString stringWithFormat:@"%@-%d", name, getpid()]] isDirectory:YES];
+    
+    NSURL *directoryURL = fixture.directoryURL;
+    afterAll(^{
+        [[NSFileManager defaultManager] removeItemAtURL:directoryURL error:NULL];
+    });
+    
+    return fixture;
+}
+
+//|++++++++++++++++++++++++++++++++++++|//
+- (NSURL*)URLForFileWithName:(NSString*)name
+{
+    [[NSFileManager defaultManager] createDirectoryAtURL:_directoryURL withIntermediateDirectories:YES attributes:nil error:NULL];
+    return [_directoryURL URLByAppendingPathComponent:name];
+}
+
+//|++++++++++++++++++++++++++++++++++++|//
+- (MKMachOImage*)imageWithConfiguration:(SyntheticMachOConfiguration*)configuration name:(NSString*)name error:(NSError**)error
+{
+    NSData *contents = [SyntheticMachO machOWithConfiguration:configuration baseAddress:0 fileOffset:0];
+    return [self imageWithContents:contents name:name error:error];
+}
+
+//|++++++++++++++++++++++++++++++++++++|//
+- (MKMachOImage*)imageWithContents:(NSData*)contents name:(NSString*)name error:(NSError**)error
+{
+    if (![contents writeToURL:[self URLForFileWithName:name] options:NSDataWritingAtomic error:error])
+        return nil;
+    
+    return [self imageWithName:name error:error];
+}
+
+//|++++++++++++++++++++++++++++++++++++|//
+- (MKMachOImage*)imageWithName:(NSString*)name error:(NSError**)error
+{ return [self imageWithName:name budget:(mk_context_budget_t){ 0 } error:error]; }
+
+//|++++++++++++++++++++++++++++++++++++|//
+- (MKMachOImage*)imageWithName:(NSString*)name budget:(mk_context_budget_t)budget error:(NSError**)error
+{
+    MKMemoryMap *map = [MKMemoryMap memoryMapWithContentsOfFile:[self URLForFileWithName:name] error:error];
+    if (map == nil)
+        return nil;
+    
+    // The budget must be set before the image is created.
+    map.budget = budget;
+    return [[MKMachOImage alloc] initWithName:name.UTF8String flags:0 atAddress:0 inMapping:map error:error];
+}
+
+@end
+
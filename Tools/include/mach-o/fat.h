@@ -0,0 +1,65 @@
+//----------------------------------------------------------------------------//
+//|
+//|             MachOKit - A Lightweight Mach-O Parsing Library
+//! @file       fat.h
+//!
+//! @author     D.V.
+//! @copyright  Copyright (c) 2014-2015 D.V. All rights reserved.
+//!
+//! @brief
+//! Universal (fat) binary definitions for hosts without the
+//! Darwin SDK.  Only used by the standalone build on non-Darwin hosts.
+//|
+//| Permission is hereby granted, free of charge, to any person obtaining a
+//| copy of this software and associated documentation files (the "Software"),
+//| to deal in the Software without restriction, including without limitation
+//| the rights to use, copy, modify, merge, publish, distribute, sublicense,
+//| and/or sell copies of the Software, and to permit persons to whom the
+//| Software is furnished to do so, subject to the following conditions:
+//|
+//| The above copyright notice and this permission notice shall be included
+//| in all copies or substantial portions of the Software.
+//|
+//| THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+//| OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+//| MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+//| IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+//| CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+//| TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+//| SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+//----------------------------------------------------------------------------//
+
+#ifndef _mach_o_fat_h
+#define _mach_o_fat_h
+
+#include <stdint.h>
+#include <mach/machine.h>
+
+#define FAT_MAGIC                   0xcafebabe
+#define FAT_CIGAM                   0xbebafeca
+#define FAT_MAGIC_64                0xcafebabf
+#define FAT_CIGAM_64                0xbfbafeca
+
+struct fat_header {
+    uint32_t        magic;
+    uint32_t        nfat_arch;
+};
+
+struct fat_arch {
+    cpu_type_t      cputype;
+    cpu_subtype_t   cpusubtype;
+    uint32_t        offset;
+    uint32_t        size;
+    uint32_t        align;
+};
+
+struct fat_arch_64 {
+    cpu_type_t      cputype;
+    cpu_subtype_t   cpusubtype;
+    uint64_t        offset;
+    uint64_t        size;
+    uint32_t        align;
+    uint32_t        reserved;
+};
+
+#endif /* _mach_o_fat_h */
@@ -0,0 +1,467 @@
+//----------------------------------------------------------------------------//
+//|
+//|             MachOKit - A Lightweight Mach-O Parsing Library
+//! @file       loader.h
+//!
+//! @author     D.V.
+//! @copyright  Copyright (c) 2014-2015 D.V. All rights reserved.
+//!
+//! @brief
+//! Mach-O header and load command definitions for hosts without the
+//! Darwin SDK.  Only used by the standalone build on non-Darwin hosts.
+//|
+//| Permission is hereby granted, free of charge, to any person obtaining a
+//| copy of this software and associated documentation files (the "Software"),
+//| to deal in the Software without restriction, including without limitation
+//| the rights to use, copy, modify, merge, publish, distribute, sublicense,
+//| and/or sell copies of the Software, and to permit persons to whom the
+//| Software is furnished to do so, subject to the following conditions:
+//|
+//| The above copyright notice and this permission notice shall be included
+//| in all copies or substantial portions of the Software.
+//|
+//| THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+//| OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+//| MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+//| IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+//| CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+//| TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+//| SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+//----------------------------------------------------------------------------//
+
+#ifndef _mach_o_loader_h
+#define _mach_o_loader_h
+
+#include <stdint.h>
+#include <mach/machine.h>
+#include <mach/vm_prot.h>
+
+//----------------------------------------------------------------------------//
+#pragma mark -  Mach Header
+//----------------------------------------------------------------------------//
+
+struct mach_header {
+    uint32_t        magic;
+    cpu_type_t      cputype;
+    cpu_subtype_t   cpusubtype;
+    uint32_t        filetype;
+    uint32_t        ncmds;
+    uint32_t        sizeofcmds;
+    uint32_t        flags;
+};
+
+struct mach_header_64 {
+    uint32_t        magic;
+    cpu_type_t      cputype;
+    cpu_subtype_t   cpusubtype;
+    uint32_t        filetype;
+    uint32_t        ncmds;
+    uint32_t        sizeofcmds;
+    uint32_t        flags;
+    uint32_t        reserved;
+};
+
+#define MH_MAGIC                    0xfeedface
+#define MH_CIGAM                    0xcefaedfe
+#define MH_MAGIC_64                 0xfeedfacf
+#define MH_CIGAM_64                 0xcffaedfe
+
+#define MH_OBJECT                   0x1
+#define MH_EXECUTE                  0x2
+#define MH_FVMLIB                   0x3
+#define MH_CORE                     0x4
+#define MH_PRELOAD                  0x5
+#define MH_DYLIB                    0x6
+#define MH_DYLINKER                 0x7
+#define MH_BUNDLE                   0x8
+#define MH_DYLIB_STUB               0x9
+#define MH_DSYM                     0xa
+#define MH_KEXT_BUNDLE              0xb
+#define MH_FILESET                  0xc
+
+#define MH_DYLIB_IN_CACHE           0x80000000
+
+//----------------------------------------------------------------------------//
+#pragma mark -  Load Commands
+//----------------------------------------------------------------------------//
+
+struct load_command {
+    uint32_t        cmd;
+    uint32_t        cmdsize;
+};
+
+#define LC_REQ_DYLD                 0x80000000
+
+#define LC_SEGMENT                  0x1
+#define LC_SYMTAB                   0x2
+#define LC_SYMSEG                   0x3
+#define LC_THREAD                   0x4
+#define LC_UNIXTHREAD               0x5
+#define LC_LOADFVMLIB               0x6
+#define LC_IDFVMLIB                 0x7
+#define LC_IDENT                    0x8
+#define LC_FVMFILE                  0x9
+#define LC_PREPAGE                  0xa
+#define LC_DYSYMTAB                 0xb
+#define LC_LOAD_DYLIB               0xc
+#define LC_ID_DYLIB                 0xd
+#define LC_LOAD_DYLINKER            0xe
+#define LC_ID_DYLINKER              0xf
+#define LC_PREBOUND_DYLIB           0x10
+#define LC_ROUTINES                 0x11
+#define LC_SUB_FRAMEWORK            0x12
+#define LC_SUB_UMBRELLA             0x13
+#define LC_SUB_CLIENT               0x14
+#define LC_SUB_LIBRARY              0x15
+#define LC_TWOLEVEL_HINTS           0x16
+#define LC_PREBIND_CKSUM            0x17
+#define LC_LOAD_WEAK_DYLIB          (0x18 | LC_REQ_DYLD)
+#define LC_SEGMENT_64               0x19
+#define LC_ROUTINES_64              0x1a
+#define LC_UUID                     0x1b
+#define LC_RPATH                    (0x1c | LC_REQ_DYLD)
+#define LC_CODE_SIGNATURE           0x1d
+#define LC_SEGMENT_SPLIT_INFO       0x1e
+#define LC_REEXPORT_DYLIB           (0x1f | LC_REQ_DYLD)
+#define LC_LAZY_LOAD_DYLIB          0x20
+#define LC_ENCRYPTION_INFO          0x21
+#define LC_DYLD_INFO                0x22
+#define LC_DYLD_INFO_ONLY           (0x22 | LC_REQ_DYLD)
+#define LC_LOAD_UPWARD_DYLIB        (0x23 | LC_REQ_DYLD)
+#define LC_VERSION_MIN_MACOSX       0x24
+#define LC_VERSION_MIN_IPHONEOS     0x25
+#define LC_FUNCTION_STARTS          0x26
+#define LC_DYLD_ENVIRONMENT         0x27
+#define LC_MAIN                     (0x28 | LC_REQ_DYLD)
+#define LC_DATA_IN_CODE             0x29
+#define LC_SOURCE_VERSION           0x2a
+#define LC_DYLIB_CODE_SIGN_DRS      0x2b
+#define LC_ENCRYPTION_INFO_64       0x2c
+#define LC_LINKER_OPTION            0x2d
+#define LC_LINKER_OPTIMIZATION_HINT 0x2e
+#define LC_VERSION_MIN_TVOS         0x2f
+#define LC_VERSION_MIN_WATCHOS      0x30
+#define LC_NOTE                     0x31
+#define LC_BUILD_VERSION            0x32
+#define LC_DYLD_EXPORTS_TRIE        (0x33 | LC_REQ_DYLD)
+#define LC_DYLD_CHAINED_FIXUPS      (0x34 | LC_REQ_DYLD)
+
+union lc_str {
+    uint32_t        offset;
+};
+
+//----------------------------------------------------------------------------//
+#pragma mark -  Segments and Sections
+//----------------------------------------------------------------------------//
+
+struct segment_command {
+    uint32_t        cmd;
+    uint32_t        cmdsize;
+    char            segname[16];
+    uint32_t        vmaddr;
+    uint32_t        vmsize;
+    uint32_t        fileoff;
+    uint32_t        filesize;
+    vm_prot_t       maxprot;
+    vm_prot_t       initprot;
+    uint32_t        nsects;
+    uint32_t        flags;
+};
+
+struct segment_command_64 {
+    uint32_t        cmd;
+    uint32_t        cmdsize;
+    char            segname[16];
+    uint64_t        vmaddr;
+    uint64_t        vmsize;
+    uint64_t        fileoff;
+    uint64_t        filesize;
+    vm_prot_t       maxprot;
+    vm_prot_t       initprot;
+    uint32_t        nsects;
+    uint32_t        flags;
+};
+
+struct section {
+    char            sectname[16];
+    char            segname[16];
+    uint32_t        addr;
+    uint32_t        size;
+    uint32_t        offset;
+    uint32_t        align;
+    uint32_t        reloff;
+    uint32_t        nreloc;
+    uint32_t        flags;
+    uint32_t        reserved1;
+    uint32_t        reserved2;
+};
+
+struct section_64 {
+    char            sectname[16];
+    char            segname[16];
+    uint64_t        addr;
+    uint64_t        size;
+    uint32_t        offset;
+    uint32_t        align;
+    uint32_t        reloff;
+    uint32_t        nreloc;
+    uint32_t        flags;
+    uint32_t        reserved1;
+    uint32_t        reserved2;
+    uint32_t        reserved3;
+};
+
+#define SECTION_TYPE                0x000000ff
+#define SECTION_ATTRIBUTES          0xffffff00
+
+#define SEG_PAGEZERO                "__PAGEZERO"
+#define SEG_TEXT                    "__TEXT"
+#define SEG_DATA                    "__DATA"
+#define SEG_LINKEDIT                "__LINKEDIT"
+
+//----------------------------------------------------------------------------//
+#pragma mark -  Dylibs and Dynamic Linking
+//----------------------------------------------------------------------------//
+
+struct dylib {
+    union lc_str    name;
+    uint32_t        timestamp;
+    uint32_t        current_version;
+    uint32_t        compatibility_version;
+};
+
+struct dylib_command {
+    uint32_t        cmd;
+    uint32_t        cmdsize;
+    struct dylib    dylib;
+};
+
+struct sub_framework_command {
+    uint32_t        cmd;
+    uint32_t        cmdsize;
+    union lc_str    umbrella;
+};
+
+struct sub_client_command {
+    uint32_t        cmd;
+    uint32_t        cmdsize;
+    union lc_str    client;
+};
+
+struct sub_umbrella_command {
+    uint32_t        cmd;
+    uint32_t        cmdsize;
+    union lc_str    sub_umbrella;
+};
+
+struct sub_library_command {
+    uint32_t        cmd;
+    uint32_t        cmdsize;
+    union lc_str    sub_library;
+};
+
+struct dylinker_command {
+    uint32_t        cmd;
+    uint32_t        cmdsize;
+    union lc_str    name;
+};
+
+struct routines_command {
+    uint32_t        cmd;
+    uint32_t        cmdsize;
+    uint32_t        init_address;
+    uint32_t        init_module;
+    uint32_t        reserved1;
+    uint32_t        reserved2;
+    uint32_t        reserved3;
+    uint32_t        reserved4;
+    uint32_t        reserved5;
+    uint32_t        reserved6;
+};
+
+struct routines_command_64 {
+    uint32_t        cmd;
+    uint32_t        cmdsize;
+    uint64_t        init_address;
+    uint64_t        init_module;
+    uint64_t        reserved1;
+    uint64_t        reserved2;
+    uint64_t        reserved3;
+    uint64_t        reserved4;
+    uint64_t        reserved5;
+    uint64_t        reserved6;
+};
+
+struct rpath_command {
+    uint32_t        cmd;
+    uint32_t        cmdsize;
+    union lc_str    path;
+};
+
+struct dyld_info_command {
+    uint32_t        cmd;
+    uint32_t        cmdsize;
+    uint32_t        rebase_off;
+    uint32_t        rebase_size;
+    uint32_t        bind_off;
+    uint32_t        bind_size;
+    uint32_t        weak_bind_off;
+    uint32_t        weak_bind_size;
+    uint32_t        lazy_bind_off;
+    uint32_t        lazy_bind_size;
+    uint32_t        export_off;
+    uint32_t        export_size;
+};
+
+#define EXPORT_SYMBOL_FLAGS_KIND_MASK           0x03
+#define EXPORT_SYMBOL_FLAGS_KIND_REGULAR        0x00
+#define EXPORT_SYMBOL_FLAGS_KIND_THREAD_LOCAL   0x01
+#define EXPORT_SYMBOL_FLAGS_KIND_ABSOLUTE       0x02
+#define EXPORT_SYMBOL_FLAGS_WEAK_DEFINITION     0x04
+#define EXPORT_SYMBOL_FLAGS_REEXPORT            0x08
+#define EXPORT_SYMBOL_FLAGS_STUB_AND_RESOLVER   0x10
+
+//----------------------------------------------------------------------------//
+#pragma mark -  Symbol Tables
+//----------------------------------------------------------------------------//
+
+struct symtab_command {
+    uint32_t        cmd;
+    uint32_t        cmdsize;
+    uint32_t        symoff;
+    uint32_t        nsyms;
+    uint32_t        stroff;
+    uint32_t        strsize;
+};
+
+struct dysymtab_command {
+    uint32_t        cmd;
+    uint32_t        cmdsize;
+    uint32_t        ilocalsym;
+    uint32_t        nlocalsym;
+    uint32_t        iextdefsym;
+    uint32_t        nextdefsym;
+    uint32_t        iundefsym;
+    uint32_t        nundefsym;
+    uint32_t        tocoff;
+    uint32_t        ntoc;
+    uint32_t        modtaboff;
+    uint32_t        nmodtab;
+    uint32_t        extrefsymoff;
+    uint32_t        nextrefsyms;
+    uint32_t        indirectsymoff;
+    uint32_t        nindirectsyms;
+    uint32_t        extreloff;
+    uint32_t        nextrel;
+    uint32_t        locreloff;
+    uint32_t        nlocrel;
+};
+
+struct twolevel_hints_command {
+    uint32_t        cmd;
+    uint32_t        cmdsize;
+    uint32_t        offset;
+    uint32_t        nhints;
+};
+
+struct prebind_cksum_command {
+    uint32_t        cmd;
+    uint32_t        cmdsize;
+    uint32_t        cksum;
+};
+
+//----------------------------------------------------------------------------//
+#pragma mark -  Miscellaneous Commands
+//----------------------------------------------------------------------------//
+
+struct uuid_command {
+    uint32_t        cmd;
+    uint32_t        cmdsize;
+    uint8_t         uuid[16];
+};
+
+struct linkedit_data_command {
+    uint32_t        cmd;
+    uint32_t        cmdsize;
+    uint32_t        dataoff;
+    uint32_t        datasize;
+};
+
+struct encryption_info_command {
+    uint32_t        cmd;
+    uint32_t        cmdsize;
+    uint32_t        cryptoff;
+    uint32_t        cryptsize;
+    uint32_t        cryptid;
+};
+
+struct encryption_info_command_64 {
+    uint32_t        cmd;
+    uint32_t        cmdsize;
+    uint32_t        cryptoff;
+    uint32_t        cryptsize;
+    uint32_t        cryptid;
+    uint32_t        pad;
+};
+
+struct version_min_command {
+    uint32_t        cmd;
+    uint32_t        cmdsize;
+    uint32_t        version;
+    uint32_t        sdk;
+};
+
+struct build_version_command {
+    uint32_t        cmd;
+    uint32_t        cmdsize;
+    uint32_t        platform;
+    uint32_t        minos;
+    uint32_t        sdk;
+    uint32_t        ntools;
+};
+
+struct build_tool_version {
+    uint32_t        tool;
+    uint32_t        version;
+};
+
+struct linker_option_command {
+    uint32_t        cmd;
+    uint32_t        cmdsize;
+    uint32_t        count;
+};
+
+struct entry_point_command {
+    uint32_t        cmd;
+    uint32_t        cmdsize;
+    uint64_t        entryoff;
+    uint64_t        stacksize;
+};
+
+struct source_version_command {
+    uint32_t        cmd;
+    uint32_t        cmdsize;
+    uint64_t        version;
+};
+
+struct note_command {
+    uint32_t        cmd;
+    uint32_t        cmdsize;
+    char            data_owner[16];
+    uint64_t        offset;
+    uint64_t        size;
+};
+
+struct data_in_code_entry {
+    uint32_t        offset;
+    uint16_t        length;
+    uint16_t        kind;
+};
+
+#define DICE_KIND_DATA              0x0001
+#define DICE_KIND_JUMP_TABLE8       0x0002
+#define DICE_KIND_JUMP_TABLE16      0x0003
+#define DICE_KIND_JUMP_TABLE32      0x0004
+#define DICE_KIND_ABS_JUMP_TABLE32  0x0005
+
+#endif /* _mach_o_loader_h */
@@ -0,0 +1,71 @@
+//----------------------------------------------------------------------------//
+//|
+//|             MachOKit - A Lightweight Mach-O Parsing Library
+//! @file       nlist.h
+//!
+//! @author     D.V.
+//! @copyright  Copyright (c) 2014-2015 D.V. All rights reserved.
+//!
+//! @brief
+//! Symbol table entry definitions for hosts without the Darwin
+//! SDK.  Only used by the standalone build on non-Darwin hosts.
+//|
+//| Permission is hereby granted, free of charge, to any person obtaining a
+//| copy of this software and associated documentation files (the "Software"),
+//| to deal in the Software without restriction, including without limitation
+//| the rights to use, copy, modify, merge, publish, distribute, sublicense,
+//| and/or sell copies of the Software, and to permit persons to whom the
+//| Software is furnished to do so, subject to the following conditions:
+//|
+//| The above copyright notice and this permission notice shall be included
+//| in all copies or substantial portions of the Software.
+//|
+//| THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+//| OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+//| MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+//| IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+//| CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+//| TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+//| SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+//----------------------------------------------------------------------------//
+
+#ifndef _mach_o_nlist_h
+#define _mach_o_nlist_h
+
+#include <stdint.h>
+
+struct nlist {
+    union {
+        uint32_t    n_strx;
+    } n_un;
+    uint8_t         n_type;
+    uint8_t         n_sect;
+    int16_t         n_desc;
+    uint32_t        n_value;
+};
+
+struct nlist_64 {
+    union {
+        uint32_t    n_strx;
+    } n_un;
+    uint8_t         n_type;
+    uint8_t         n_sect;
+    uint16_t        n_desc;
+    uint64_t        n_value;
+};
+
+#define N_STAB                      0xe0
+#define N_PEXT                      0x10
+#define N_TYPE                      0x0e
+#define N_EXT                       0x01
+
+#define N_UNDF                      0x0
+#define N_ABS                       0x2
+#define N_SECT                      0xe
+#define N_PBUD                      0xc
+#define N_INDR                      0xa
+
+#define NO_SECT                     0
+#define MAX_SECT                    255
+
+#endif /* _mach_o_nlist_h */
@@ -0,0 +1,118 @@
+//----------------------------------------------------------------------------//
+//|
+//|             MachOKit - A Lightweight Mach-O Parsing Library
+//! @file       machine.h
+//!
+//! @author     D.V.
+//! @copyright  Copyright (c) 2014-2015 D.V. All rights reserved.
+//!
+//! @brief
+//! Mach-O CPU type and subtype definitions for hosts without the
+//! Darwin SDK.  Only used by the standalone build on non-Darwin hosts.
+//|
+//| Permission is hereby granted, free of charge, to any person obtaining a
+//| copy of this software and associated documentation files (the "Software"),
+//| to deal in the Software without restriction, including without limitation
+//| the rights to use, copy, modify, merge, publish, distribute, sublicense,
+//| and/or sell copies of the Software, and to permit persons to whom the
+//| Software is furnished to do so, subject to the following conditions:
+//|
+//| The above copyright notice and this permission notice shall be included
+//| in all copies or substantial portions of the Software.
+//|
+//| THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+//| OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+//| MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+//| IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+//| CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+//| TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+//| SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+//----------------------------------------------------------------------------//
+
+#ifndef _mach_machine_h
+#define _mach_machine_h
+
+typedef int                 integer_t;
+typedef integer_t           cpu_type_t;
+typedef integer_t           cpu_subtype_t;
+
+#define CPU_ARCH_MASK               0xff000000
+#define CPU_ARCH_ABI64              0x01000000
+#define CPU_ARCH_ABI64_32           0x02000000
+
+#define CPU_TYPE_ANY                ((cpu_type_t) -1)
+#define CPU_TYPE_VAX                ((cpu_type_t) 1)
+#define CPU_TYPE_MC680x0            ((cpu_type_t) 6)
+#define CPU_TYPE_X86                ((cpu_type_t) 7)
+#define CPU_TYPE_I386               CPU_TYPE_X86
+#define CPU_TYPE_X86_64             (CPU_TYPE_X86 | CPU_ARCH_ABI64)
+#define CPU_TYPE_MC98000            ((cpu_type_t) 10)
+#define CPU_TYPE_HPPA               ((cpu_type_t) 11)
+#define CPU_TYPE_ARM                ((cpu_type_t) 12)
+#define CPU_TYPE_ARM64              (CPU_TYPE_ARM | CPU_ARCH_ABI64)
+#define CPU_TYPE_ARM64_32           (CPU_TYPE_ARM | CPU_ARCH_ABI64_32)
+#define CPU_TYPE_MC88000            ((cpu_type_t) 13)
+#define CPU_TYPE_SPARC              ((cpu_type_t) 14)
+#define CPU_TYPE_I860               ((cpu_type_t) 15)
+#define CPU_TYPE_POWERPC            ((cpu_type_t) 18)
+#define CPU_TYPE_POWERPC64          (CPU_TYPE_POWERPC | CPU_ARCH_ABI64)
+
+#define CPU_SUBTYPE_MASK            0xff000000
+#define CPU_SUBTYPE_LIB64           0x80000000
+
+#define CPU_SUBTYPE_MULTIPLE        ((cpu_subtype_t) -1)
+#define CPU_SUBTYPE_LITTLE_ENDIAN   ((cpu_subtype_t) 0)
+#define CPU_SUBTYPE_BIG_ENDIAN      ((cpu_subtype_t) 1)
+
+#define CPU_SUBTYPE_MC680x0_ALL     ((cpu_subtype_t) 1)
+#define CPU_SUBTYPE_MC68040         ((cpu_subtype_t) 2)
+#define CPU_SUBTYPE_MC68030_ONLY    ((cpu_subtype_t) 3)
+
+#define CPU_SUBTYPE_INTEL(f, m)     ((cpu_subtype_t) (f) + ((m) << 4))
+#define CPU_SUBTYPE_I386_ALL        CPU_SUBTYPE_INTEL(3, 0)
+#define CPU_SUBTYPE_486             CPU_SUBTYPE_INTEL(4, 0)
+#define CPU_SUBTYPE_486SX           CPU_SUBTYPE_INTEL(4, 8)
+#define CPU_SUBTYPE_PENT            CPU_SUBTYPE_INTEL(5, 0)
+#define CPU_SUBTYPE_PENTPRO         CPU_SUBTYPE_INTEL(6, 1)
+#define CPU_SUBTYPE_PENTII_M3       CPU_SUBTYPE_INTEL(6, 3)
+#define CPU_SUBTYPE_PENTII_M5       CPU_SUBTYPE_INTEL(6, 5)
+
+#define CPU_SUBTYPE_X86_64_ALL      ((cpu_subtype_t) 3)
+#define CPU_SUBTYPE_X86_64_H        ((cpu_subtype_t) 8)
+
+#define CPU_SUBTYPE_ARM_ALL         ((cpu_subtype_t) 0)
+#define CPU_SUBTYPE_ARM_V4T         ((cpu_subtype_t) 5)
+#define CPU_SUBTYPE_ARM_V6          ((cpu_subtype_t) 6)
+#define CPU_SUBTYPE_ARM_V5TEJ       ((cpu_subtype_t) 7)
+#define CPU_SUBTYPE_ARM_XSCALE      ((cpu_subtype_t) 8)
+#define CPU_SUBTYPE_ARM_V7          ((cpu_subtype_t) 9)
+#define CPU_SUBTYPE_ARM_V7F         ((cpu_subtype_t) 10)
+#define CPU_SUBTYPE_ARM_V7S         ((cpu_subtype_t) 11)
+#define CPU_SUBTYPE_ARM_V7K         ((cpu_subtype_t) 12)
+#define CPU_SUBTYPE_ARM_V8          ((cpu_subtype_t) 13)
+#define CPU_SUBTYPE_ARM_V6M         ((cpu_subtype_t) 14)
+#define CPU_SUBTYPE_ARM_V7M         ((cpu_subtype_t) 15)
+#define CPU_SUBTYPE_ARM_V7EM        ((cpu_subtype_t) 16)
+
+#define CPU_SUBTYPE_ARM64_ALL       ((cpu_subtype_t) 0)
+#define CPU_SUBTYPE_ARM64_V8        ((cpu_subtype_t) 1)
+#define CPU_SUBTYPE_ARM64E          ((cpu_subtype_t) 2)
+
+#define CPU_SUBTYPE_ARM64_32_ALL    ((cpu_subtype_t) 0)
+#define CPU_SUBTYPE_ARM64_32_V8     ((cpu_subtype_t) 1)
+
+#define CPU_SUBTYPE_POWERPC_ALL     ((cpu_subtype_t) 0)
+#define CPU_SUBTYPE_POWERPC_601     ((cpu_subtype_t) 1)
+#define CPU_SUBTYPE_POWERPC_602     ((cpu_subtype_t) 2)
+#define CPU_SUBTYPE_POWERPC_603     ((cpu_subtype_t) 3)
+#define CPU_SUBTYPE_POWERPC_603e    ((cpu_subtype_t) 4)
+#define CPU_SUBTYPE_POWERPC_603ev   ((cpu_subtype_t) 5)
+#define CPU_SUBTYPE_POWERPC_604     ((cpu_subtype_t) 6)
+#define CPU_SUBTYPE_POWERPC_604e    ((cpu_subtype_t) 7)
+#define CPU_SUBTYPE_POWERPC_620     ((cpu_subtype_t) 8)
+#define CPU_SUBTYPE_POWERPC_750     ((cpu_subtype_t) 9)
+#define CPU_SUBTYPE_POWERPC_7400    ((cpu_subtype_t) 10)
+#define CPU_SUBTYPE_POWERPC_7450    ((cpu_subtype_t) 11)
+#define CPU_SUBTYPE_POWERPC_970     ((cpu_subtype_t) 100)
+
+#endif /* _mach_machine_h */
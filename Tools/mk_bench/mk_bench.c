@@ -0,0 +1,345 @@
+//----------------------------------------------------------------------------//
+//|
+//|             MachOKit - A Lightweight Mach-O Parsing Library
+//|             mk_bench.c
+//|
+//|             D.V.
+//|             Copyright (c) 2014-2015 D.V. All rights reserved.
+//|
+//| Permission is hereby granted, free of charge, to any person obtaining a
+//| copy of this software and associated documentation files (the "Software"),
+//| to deal in the Software without restriction, including without limitation
+//| the rights to use, copy, modify, merge, publish, distribute, sublicense,
+//| and/or sell copies of the Software, and to permit persons to whom the
+//| Software is furnished to do so, subject to the following conditions:
+//|
+//| The above copyright notice and this permission notice shall be included
+//| in all copies or substantial portions of the Software.
+//|
+//| THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+//| OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+//| MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+//| IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+//| CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+//| TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+//| SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+//----------------------------------------------------------------------------//
+
+//----------------------------------------------------------------------------//
+//  mk_bench parses every Mach-O image in a directory tree with libMachO and
+//  reports the throughput of each stage.  It only depends on libMachO and
+//  POSIX, so it builds wherever libMachO does.
+//
+//  usage: mk_bench [-n iterations] [-v] <directory>
+//----------------------------------------------------------------------------//
+
+#if !defined(__APPLE__) && !defined(_GNU_SOURCE)
+#define _GNU_SOURCE // nftw(3)
+#endif
+
+#include "macho.h"
+
+#include <errno.h>
+#include <fcntl.h>
+#include <ftw.h>
+#include <inttypes.h>
+#include <stdarg.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <mach-o/fat.h>
+
+static unsigned g_iterations = 1;
+static bool g_verbose = false;
+
+static struct {
+    uint64_t images;
+    uint64_t bytes;
+    uint64_t load_commands;
+    uint64_t symbols;
+    uint64_t lookups;
+    double seconds;
+} g_totals;
+
+//|++++++++++++++++++++++++++++++++++++|//
+static double
+bench_now(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec + (double)ts.tv_nsec / 1e9;
+}
+
+//|++++++++++++++++++++++++++++++++++++|//
+static void
+bench_logger(void* context, void* reserved, mk_logging_level_t level, const char *file, int line, const char *function, const char* msg, ...)
+{
+    (void)context; (void)reserved; (void)file; (void)line; (void)function;
+    
+    if (!g_verbose)
+        return;
+    
+    va_list ap;
+    va_start(ap, msg);
+    fprintf(stderr, "[%s] ", mk_string_for_logging_level(level));
+    vfprintf(stderr, msg, ap);
+    fprintf(stderr, "\n");
+    va_end(ap);
+}
+
+//◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦//
+typedef struct bench_result {
+    uint32_t load_commands;
+    uint32_t symbols;
+    uint32_t lookups;
+    uint32_t found;
+    double init_seconds;
+    double load_command_seconds;
+    double symbol_seconds;
+    double lookup_seconds;
+} bench_result_t;
+
+//|++++++++++++++++++++++++++++++++++++|//
+static mk_error_t
+bench_find_linkedit(mk_macho_t *macho, mk_segment_t *segment)
+{
+    uint32_t segment_cmd = mk_macho_is_64_bit(macho) ? LC_SEGMENT_64 : LC_SEGMENT;
+    struct load_command *lc = NULL;
+    
+    while ((lc = mk_macho_next_command_type(macho, lc, segment_cmd, NULL))) {
+        if (mk_segment_init_with_mach_load_command(macho, lc, segment))
+            continue;
+        
+        char name[17] = { 0 };
+        mk_segment_copy_name(segment, name);
+        if (strcmp(name, SEG_LINKEDIT) == 0)
+            return MK_ESUCCESS;
+        
+        mk_segment_free(segment);
+    }
+    
+    return MK_ENOT_FOUND;
+}
+
+//|++++++++++++++++++++++++++++++++++++|//
+static mk_error_t
+bench_image(const char *path, int fd, uint64_t offset, bench_result_t *result)
+{
+    mk_error_t err;
+    mk_context_statistics_t statistics = { 0 };
+    mk_context_t ctx = { .user_data = NULL, .logger = &bench_logger, .statistics = &statistics };
+    
+    memset(result, 0, sizeof(*result));
+    
+    double start = bench_now();
+    
+    mk_memory_map_file_t map;
+    if ((err = mk_memory_map_file_init(fd, offset, &ctx, &map)))
+        return err;
+    
+    mk_macho_t macho;
+    if ((err = mk_macho_init(&ctx, path, mk_memory_map_file_get_image_address(&map), &map, &macho))) {
+        mk_memory_map_file_free(&map);
+        return err;
+    }
+    
+    double t1 = bench_now();
+    result->init_seconds = t1 - start;
+    
+    // Load commands
+    struct load_command *lc = NULL;
+    while ((lc = mk_macho_next_command(&macho, lc, NULL)))
+        result->load_commands++;
+    
+    double t2 = bench_now();
+    result->load_command_seconds = t2 - t1;
+    
+    mk_segment_t link_edit;
+    if (bench_find_linkedit(&macho, &link_edit) == MK_ESUCCESS)
+    {
+        const mk_byteorder_t *byte_order = mk_macho_get_byte_order(&macho);
+        bool is64 = mk_macho_is_64_bit(&macho);
+        
+        mk_symbol_table_t symbol_table;
+        mk_string_table_t string_table;
+        const char **exported = NULL;
+        
+        // Symbol table, resolving the name of each symbol and remembering
+        // the defined external symbols for the exports trie lookups.
+        if (mk_symbol_table_init_with_segment(&link_edit, &symbol_table) == MK_ESUCCESS &&
+            mk_string_table_init_with_segment(&link_edit, &string_table) == MK_ESUCCESS)
+        {
+            uint32_t count = mk_symbol_table_get_symbol_count(&symbol_table);
+            exported = calloc(count ? count : 1, sizeof(char*));
+            
+            mk_macho_nlist_ptr nlist = { .any = NULL };
+            while ((nlist = mk_symbol_table_next_mach_symbol(&symbol_table, nlist, NULL, NULL)).any) {
+                uint32_t strx = byte_order->swap32(is64 ? nlist.nlist_64->n_un.n_strx : (uint32_t)nlist.nlist->n_un.n_strx);
+                uint8_t type = is64 ? nlist.nlist_64->n_type : nlist.nlist->n_type;
+                
+                const char *name = mk_string_table_get_string_at_offset(&string_table, strx, NULL);
+                result->symbols++;
+                
+                if (name && exported && (type & N_STAB) == 0 && (type & N_TYPE) == N_SECT && (type & N_EXT))
+                    exported[result->lookups++] = name;
+            }
+            
+            double t3 = bench_now();
+            result->symbol_seconds = t3 - t2;
+            
+            // Exports trie
+            mk_exports_trie_t exports_trie;
+            if (mk_exports_trie_init_with_segment(&link_edit, &exports_trie) == MK_ESUCCESS) {
+                for (uint32_t i = 0; i < result->lookups; i++) {
+                    mk_macho_export_node_ptr node;
+                    if (mk_exports_trie_get_terminal_node_for_symbol(&exports_trie, exported[i], NULL, &node) == MK_ESUCCESS)
+                        result->found++;
+                }
+                mk_exports_trie_free(&exports_trie);
+            } else
+                result->lookups = 0;
+            
+            result->lookup_seconds = bench_now() - t3;
+            
+            mk_string_table_free(&string_table);
+            mk_symbol_table_free(&symbol_table);
+        }
+        
+        free(exported);
+        mk_segment_free(&link_edit);
+    }
+    
+    mk_macho_free(&macho);
+    mk_memory_map_file_free(&map);
+    
+    if (g_verbose)
+        fprintf(stderr, "  %s: %" PRIu64 " remaps, %" PRIu64 " bytes copied, %" PRIu64 " string lookups, %" PRIu64 " trie steps\n",
+                path, statistics.remap, statistics.bytes_copied, statistics.string_table_lookups, statistics.trie_steps);
+    
+    return MK_ESUCCESS;
+}
+
+//|++++++++++++++++++++++++++++++++++++|//
+static void
+bench_report(const char *path, uint64_t offset, uint64_t size, int fd)
+{
+    bench_result_t best = { 0 };
+    double best_seconds = 0;
+    
+    for (unsigned i = 0; i < g_iterations; i++) {
+        bench_result_t result;
+        if (bench_image(path, fd, offset, &result))
+            return;
+        
+        double seconds = result.init_seconds + result.load_command_seconds + result.symbol_seconds + result.lookup_seconds;
+        if (i == 0 || seconds < best_seconds) {
+            best = result;
+            best_seconds = seconds;
+        }
+    }
+    
+    double mb = (double)size / (1024.0 * 1024.0);
+    printf("%-60s %10" PRIu64 " %8.3f ms %9.1f MB/s  lc %5u  sym %8u  lookup %8u/%-8u %10.0f lookups/s\n",
+           path, offset, best_seconds * 1e3, best_seconds > 0 ? mb / best_seconds : 0,
+           best.load_commands, best.symbols, best.found, best.lookups,
+           best.lookup_seconds > 0 ? best.lookups / best.lookup_seconds : 0);
+    
+    g_totals.images++;
+    g_totals.bytes += size;
+    g_totals.load_commands += best.load_commands;
+    g_totals.symbols += best.symbols;
+    g_totals.lookups += best.lookups;
+    g_totals.seconds += best_seconds;
+}
+
+//|++++++++++++++++++++++++++++++++++++|//
+static int
+bench_visit(const char *path, const struct stat *st, int type, struct FTW *ftw)
+{
+    (void)ftw;
+    
+    if (type != FTW_F || st->st_size < (off_t)sizeof(uint32_t))
+        return 0;
+    
+    int fd = open(path, O_RDONLY);
+    if (fd < 0)
+        return 0;
+    
+    uint8_t header[8];
+    if (pread(fd, header, sizeof(header), 0) != (ssize_t)sizeof(header)) {
+        close(fd);
+        return 0;
+    }
+    
+    // FAT headers are always big-endian.
+    uint32_t magic = ((uint32_t)header[0] << 24) | ((uint32_t)header[1] << 16) | ((uint32_t)header[2] << 8) | header[3];
+    uint32_t nfat_arch = ((uint32_t)header[4] << 24) | ((uint32_t)header[5] << 16) | ((uint32_t)header[6] << 8) | header[7];
+    
+    if (magic == FAT_MAGIC || magic == FAT_MAGIC_64)
+    {
+        size_t arch_size = magic == FAT_MAGIC_64 ? sizeof(struct fat_arch_64) : sizeof(struct fat_arch);
+        
+        for (uint32_t i = 0; i < nfat_arch && i < 64; i++) {
+            uint8_t arch[sizeof(struct fat_arch_64)];
+            if (pread(fd, arch, arch_size, (off_t)(sizeof(struct fat_header) + i * arch_size)) != (ssize_t)arch_size)
+                break;
+            
+            uint64_t slice_offset, slice_size;
+            if (magic == FAT_MAGIC_64) {
+                slice_offset = 0; slice_size = 0;
+                for (int b = 0; b < 8; b++) slice_offset = (slice_offset << 8) | arch[8 + b];
+                for (int b = 0; b < 8; b++) slice_size = (slice_size << 8) | arch[16 + b];
+            } else {
+                slice_offset = ((uint32_t)arch[8] << 24) | ((uint32_t)arch[9] << 16) | ((uint32_t)arch[10] << 8) | arch[11];
+                slice_size = ((uint32_t)arch[12] << 24) | ((uint32_t)arch[13] << 16) | ((uint32_t)arch[14] << 8) | arch[15];
+            }
+            
+            bench_report(path, slice_offset, slice_size, fd);
+        }
+    }
+    else
+    {
+        uint32_t native;
+        memcpy(&native, header, sizeof(native));
+        if (native == MH_MAGIC || native == MH_CIGAM || native == MH_MAGIC_64 || native == MH_CIGAM_64)
+            bench_report(path, 0, (uint64_t)st->st_size, fd);
+    }
+    
+    close(fd);
+    return 0;
+}
+
+//|++++++++++++++++++++++++++++++++++++|//
+int
+main(int argc, char *argv[])
+{
+    int i = 1;
+    for (; i < argc && argv[i][0] == '-'; i++) {
+        if (strcmp(argv[i], "-n") == 0 && i + 1 < argc)
+            g_iterations = (unsigned)strtoul(argv[++i], NULL, 10);
+        else if (strcmp(argv[i], "-v") == 0)
+            g_verbose = true;
+        else
+            break;
+    }
+    
+    if (i != argc - 1 || g_iterations == 0) {
+        fprintf(stderr, "usage: %s [-n iterations] [-v] <directory>\n", argv[0]);
+        return EXIT_FAILURE;
+    }
+    
+    if (!g_verbose)
+        mk_logging_level = MK_LOGGING_LEVEL_ERROR;
+    
+    if (nftw(argv[i], &bench_visit, 32, FTW_PHYS)) {
+        fprintf(stderr, "Failed to walk %s: %s\n", argv[i], strerror(errno));
+        return EXIT_FAILURE;
+    }
+    
+    double mb = (double)g_totals.bytes / (1024.0 * 1024.0);
+    printf("\n%" PRIu64 " images, %.1f MB, %" PRIu64 " load commands, %" PRIu64 " symbols, %" PRIu64 " lookups in %.3f s (%.1f MB/s)\n",
+           g_totals.images, mb, g_totals.load_commands, g_totals.symbols, g_totals.lookups,
+           g_totals.seconds, g_totals.seconds > 0 ? mb / g_totals.seconds : 0);
+    
+    return EXIT_SUCCESS;
+}
@@ -92,6 +92,7 @@ __mk_memory_map_copy_bytes(mk_memory_map_ref self, mk_vm_offset_t offset, mk_vm_
     memcpy(buffer, (void*)mk_memory_object_address(&memory_object), MIN(length, (mk_vm_size_t)mappingLength));
     
     mk_memory_map_free_object(self, &memory_object);
+    _mk_statistics_add(mk_type_get_context(self.memory_map), bytes_copied, MIN(length, (mk_vm_size_t)mappingLength));
     return (size_t)MIN(length, (mk_vm_size_t)mappingLength);
 }
 
@@ -191,11 +192,17 @@ mk_memory_map_ref mk_memory_map_for_object(mk_memory_object_ref mobj)
 
 //|++++++++++++++++++++++++++++++++++++|//
 mk_error_t mk_memory_map_init_object(mk_memory_map_ref map, mk_vm_offset_t offset, mk_vm_address_t address, mk_vm_size_t length, bool require_full, mk_memory_object_t* memory_object)
-{ MK_TYPE_INVOKE(map, memory_map, init_object)(map, offset, address, length, require_full, memory_object); }
+{
+    _mk_statistics_add(mk_type_get_context(map.memory_map), init_object, 1);
+    MK_TYPE_INVOKE(map, memory_map, init_object)(map, offset, address, length, require_full, memory_object);
+}
 
 //|++++++++++++++++++++++++++++++++++++|//
 void mk_memory_map_free_object(mk_memory_map_ref map, mk_memory_object_t* memory_object)
-{ MK_TYPE_INVOKE(map, memory_map, free_object)(map, memory_object); }
+{
+    _mk_statistics_add(mk_type_get_context(map.memory_map), free_object, 1);
+    MK_TYPE_INVOKE(map, memory_map, free_object)(map, memory_object);
+}
 
 //|++++++++++++++++++++++++++++++++++++|//
 bool mk_memory_map_has_mapping(mk_memory_map_ref map, mk_vm_offset_t offset, mk_vm_address_t address, mk_vm_size_t length, mk_error_t* error)
@@ -0,0 +1,341 @@
+//----------------------------------------------------------------------------//
+//|
+//|             MachOKit - A Lightweight Mach-O Parsing Library
+//|             memory_map_file.c
+//|
+//|             D.V.
+//|             Copyright (c) 2014-2015 D.V. All rights reserved.
+//|
+//| Permission is hereby granted, free of charge, to any person obtaining a
+//| copy of this software and associated documentation files (the "Software"),
+//| to deal in the Software without restriction, including without limitation
+//| the rights to use, copy, modify, merge, publish, distribute, sublicense,
+//| and/or sell copies of the Software, and to permit persons to whom the
+//| Software is furnished to do so, subject to the following conditions:
+//|
+//| The above copyright notice and this permission notice shall be included
+//| in all copies or substantial portions of the Software.
+//|
+//| THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+//| OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+//| MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+//| IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+//| CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+//| TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+//| SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+//----------------------------------------------------------------------------//
+
+#include "core_internal.h"
+
+#include <errno.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <mach-o/loader.h>
+
+//----------------------------------------------------------------------------//
+#pragma mark -  Classes
+//----------------------------------------------------------------------------//
+
+//|++++++++++++++++++++++++++++++++++++|//
+static mk_error_t
+__mk_memory_map_file_init_object(mk_memory_map_ref self, mk_vm_offset_t offset, mk_vm_address_t address, mk_vm_size_t length, bool require_full, mk_memory_object_t* memory_object)
+{
+    mk_memory_map_file_t *file_map = self.memory_map_file;
+    mk_context_t *ctx = mk_type_get_context(self.memory_map);
+    
+    // Verify that adding the offset value will not overflow.
+    if (MK_VM_ADDRESS_MAX - offset < address) {
+        _mkl_debug(ctx, "Adding input offset [%" MK_VM_PRIuOFFSET "] to input address [0x%" MK_VM_PRIxADDR "] would overflow.", offset, address);
+        return MK_EOVERFLOW;
+    }
+    
+    // Compute the offset address
+    mk_vm_address_t context_address = address + offset;
+    
+    // Translate the address to a position in the file.  vm_available is the
+    // number of addressable bytes at the address, file_available is the
+    // number of those bytes which are backed by the file.  The remainder is
+    // zero-fill.
+    uint64_t file_position;
+    mk_vm_size_t vm_available;
+    mk_vm_size_t file_available;
+    
+    if (file_map->segment_count == 0)
+    {
+        if (UINT64_MAX - file_map->image_offset < context_address || file_map->image_offset + context_address >= file_map->size) {
+            _mkl_debug(ctx, "Input range (offset address = 0x%" MK_VM_PRIxADDR ", length = %" MK_VM_PRIuSIZE ") is not within the file.", context_address, length);
+            return MK_EBAD_ACCESS;
+        }
+        
+        file_position = file_map->image_offset + context_address;
+        vm_available = file_available = file_map->size - file_position;
+    }
+    else
+    {
+        const mk_memory_map_file_segment_t *segment = NULL;
+        for (uint32_t i = 0; i < file_map->segment_count; i++) {
+            if (context_address >= file_map->segments[i].vmaddr && context_address - file_map->segments[i].vmaddr < file_map->segments[i].vmsize) {
+                segment = &file_map->segments[i];
+                break;
+            }
+        }
+        
+        if (segment == NULL) {
+            _mkl_debug(ctx, "Input range (offset address = 0x%" MK_VM_PRIxADDR ", length = %" MK_VM_PRIuSIZE ") is not within a segment of the image.", context_address, length);
+            return MK_EBAD_ACCESS;
+        }
+        
+        mk_vm_offset_t segment_offset = context_address - segment->vmaddr;
+        vm_available = segment->vmsize - segment_offset;
+        
+        // The segment file range was clamped to the file size when the map
+        // was initialized.
+        file_position = file_map->image_offset + segment->fileoff + segment_offset;
+        file_available = segment_offset < segment->filesize ? segment->filesize - segment_offset : 0;
+    }
+    
+    if (length > vm_available) {
+        if (require_full) {
+            _mkl_debug(ctx, "Input range (offset address = 0x%" MK_VM_PRIxADDR ", length = %" MK_VM_PRIuSIZE ") is not valid.", context_address, length);
+            return MK_EBAD_ACCESS;
+        }
+        length = vm_available;
+    }
+    
+    memory_object->vtable = &_mk_memory_object_class;
+    memory_object->mapping = self.memory_map;
+    memory_object->target_address = context_address;
+    memory_object->length = (vm_size_t)length;
+    
+    if (length <= file_available)
+    {
+        // Entirely backed by the file.
+        memory_object->address = (vm_address_t)(file_map->bytes + file_position);
+        memory_object->reserved1 = 0;
+        memory_object->reserved2 = 0;
+    }
+    else
+    {
+        // Part of the range is zero-fill.  Assemble it in an anonymous
+        // mapping, which reads as zeros.
+        void *mapping = mmap(NULL, (size_t)length, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANON, -1, 0);
+        if (mapping == MAP_FAILED) {
+            _mkl_error(ctx, "Failed to allocate space for zero-fill memory.  mmap() returned error [%i].", errno);
+            return MK_EINTERNAL_ERROR;
+        }
+        
+        if (file_available)
+            memcpy(mapping, file_map->bytes + file_position, (size_t)file_available);
+        
+        memory_object->address = (vm_address_t)mapping;
+        memory_object->reserved1 = (uint64_t)(uintptr_t)mapping;
+        memory_object->reserved2 = length;
+    }
+    
+    return MK_ESUCCESS;
+}
+
+//|++++++++++++++++++++++++++++++++++++|//
+static void
+__mk_memory_map_file_free_object(mk_memory_map_ref self, mk_memory_object_t* memory_object)
+{
+    if (memory_object->reserved2 == 0)
+        return;
+    
+    if (munmap((void*)(uintptr_t)memory_object->reserved1, (size_t)memory_object->reserved2)) {
+        _mkl_inform(mk_type_get_context(self.memory_map), "Failed to cleanup zero-fill memory.  munmap() returned error [%i].  #Memory #Leak", errno);
+    }
+}
+
+const struct _mk_memory_map_vtable _mk_memory_map_file_class = {
+    .base.super                 = &_mk_memory_map_class,
+    .base.name                  = "memory_map_file",
+    .init_object                = &__mk_memory_map_file_init_object,
+    .free_object                = &__mk_memory_map_file_free_object
+};
+
+intptr_t mk_memory_map_file_type = (intptr_t)&_mk_memory_map_file_class;
+
+//----------------------------------------------------------------------------//
+#pragma mark -  Creating A File Memory Map
+//----------------------------------------------------------------------------//
+
+//|++++++++++++++++++++++++++++++++++++|//
+//! Records the segments of the image so that addresses can be translated to
+//! file offsets.
+static mk_error_t
+__mk_memory_map_file_load_segments(mk_memory_map_file_t *file_map, mk_context_t *ctx)
+{
+    const uint8_t *image = file_map->bytes + file_map->image_offset;
+    uint64_t image_size = file_map->size - file_map->image_offset;
+    
+    if (image_size < sizeof(struct mach_header)) {
+        _mkl_debug(ctx, "File is too small to contain a Mach-O header at offset [%" PRIu64 "].", file_map->image_offset);
+        return MK_EINVALID_DATA;
+    }
+    
+    const mk_byteorder_t *byte_order;
+    bool is64;
+    
+    uint32_t magic;
+    memcpy(&magic, image, sizeof(magic));
+    switch (magic) {
+        case MH_MAGIC:      byte_order = &mk_byteorder_direct;  is64 = false;  break;
+        case MH_CIGAM:      byte_order = &mk_byteorder_swapped; is64 = false;  break;
+        case MH_MAGIC_64:   byte_order = &mk_byteorder_direct;  is64 = true;   break;
+        case MH_CIGAM_64:   byte_order = &mk_byteorder_swapped; is64 = true;   break;
+        default:
+            _mkl_debug(ctx, "Unknown Mach-O magic [0x%" PRIx32 "] at offset [%" PRIu64 "].", magic, file_map->image_offset);
+            return MK_EINVALID_DATA;
+    }
+    
+    struct mach_header header;
+    memcpy(&header, image, sizeof(header));
+    
+    uint64_t commands_offset = is64 ? sizeof(struct mach_header_64) : sizeof(struct mach_header);
+    uint64_t commands_end = commands_offset + byte_order->swap32(header.sizeofcmds);
+    uint32_t ncmds = byte_order->swap32(header.ncmds);
+    
+    if (commands_end > image_size) {
+        _mkl_debug(ctx, "Load commands (sizeofcmds = %" PRIu32 ") extend beyond the end of the file.", byte_order->swap32(header.sizeofcmds));
+        commands_end = image_size;
+    }
+    
+    mk_memory_map_file_segment_t segments[MK_MEMORY_MAP_FILE_MAX_SEGMENTS];
+    uint32_t segment_count = 0;
+    bool has_image_address = false;
+    
+    for (uint64_t position = commands_offset; ncmds-- && position + sizeof(struct load_command) <= commands_end; )
+    {
+        struct load_command lc;
+        memcpy(&lc, image + position, sizeof(lc));
+        
+        uint32_t cmd = byte_order->swap32(lc.cmd);
+        uint32_t cmdsize = byte_order->swap32(lc.cmdsize);
+        if (cmdsize < sizeof(struct load_command) || position + cmdsize > commands_end)
+            break;
+        
+        mk_memory_map_file_segment_t segment;
+        uint32_t initprot;
+        
+        if (cmd == LC_SEGMENT_64 && cmdsize >= sizeof(struct segment_command_64)) {
+            struct segment_command_64 sc;
+            memcpy(&sc, image + position, sizeof(sc));
+            segment.vmaddr = byte_order->swap64(sc.vmaddr);
+            segment.vmsize = byte_order->swap64(sc.vmsize);
+            segment.fileoff = byte_order->swap64(sc.fileoff);
+            segment.filesize = byte_order->swap64(sc.filesize);
+            initprot = byte_order->swap32((uint32_t)sc.initprot);
+        } else if (cmd == LC_SEGMENT && cmdsize >= sizeof(struct segment_command)) {
+            struct segment_command sc;
+            memcpy(&sc, image + position, sizeof(sc));
+            segment.vmaddr = byte_order->swap32(sc.vmaddr);
+            segment.vmsize = byte_order->swap32(sc.vmsize);
+            segment.fileoff = byte_order->swap32(sc.fileoff);
+            segment.filesize = byte_order->swap32(sc.filesize);
+            initprot = byte_order->swap32((uint32_t)sc.initprot);
+        } else {
+            position += cmdsize;
+            continue;
+        }
+        
+        position += cmdsize;
+        
+        // Inaccessible segments, such as __PAGEZERO, are never mapped.
+        if (initprot == 0 || segment.vmsize == 0)
+            continue;
+        
+        // The image address is the vmaddr of the last segment with a zero
+        // fileoff and non-zero filesize.
+        if (segment.fileoff == 0 && segment.filesize != 0) {
+            file_map->image_address = segment.vmaddr;
+            has_image_address = true;
+        }
+        
+        // Clamp the file range to the file, and the addressable range to the
+        // address space.
+        if (segment.fileoff > image_size)
+            segment.fileoff = segment.filesize = 0;
+        else if (segment.filesize > image_size - segment.fileoff)
+            segment.filesize = image_size - segment.fileoff;
+        if (segment.vmsize > MK_VM_ADDRESS_MAX - segment.vmaddr)
+            segment.vmsize = MK_VM_ADDRESS_MAX - segment.vmaddr;
+        if (segment.filesize > segment.vmsize)
+            segment.filesize = segment.vmsize;
+        
+        if (segment_count == MK_MEMORY_MAP_FILE_MAX_SEGMENTS) {
+            _mkl_inform(ctx, "Image has more than %i segments.  Addresses in the remaining segments will not be accessible.", MK_MEMORY_MAP_FILE_MAX_SEGMENTS);
+            continue;
+        }
+        
+        segments[segment_count++] = segment;
+    }
+    
+    if (has_image_address) {
+        memcpy(file_map->segments, segments, segment_count * sizeof(mk_memory_map_file_segment_t));
+        file_map->segment_count = segment_count;
+    } else {
+        file_map->image_address = 0;
+        file_map->segment_count = 0;
+    }
+    
+    return MK_ESUCCESS;
+}
+
+//|++++++++++++++++++++++++++++++++++++|//
+mk_error_t
+mk_memory_map_file_init(int fd, uint64_t image_offset, mk_context_t *ctx, mk_memory_map_file_t *file_map)
+{
+    if (file_map == NULL) return MK_EINVAL;
+    
+    struct stat st;
+    if (fstat(fd, &st)) {
+        _mkl_error(ctx, "Failed to determine the size of the file.  fstat() returned error [%i].", errno);
+        return MK_EINTERNAL_ERROR;
+    }
+    
+    if (st.st_size <= 0 || (uint64_t)st.st_size <= image_offset || (uint64_t)st.st_size > SIZE_MAX) {
+        _mkl_debug(ctx, "Image offset [%" PRIu64 "] is not within the file (size = %lld).", image_offset, (long long)st.st_size);
+        return MK_EINVAL;
+    }
+    
+    void *bytes = mmap(NULL, (size_t)st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    if (bytes == MAP_FAILED) {
+        _mkl_error(ctx, "Failed to map the file.  mmap() returned error [%i].", errno);
+        return MK_EINTERNAL_ERROR;
+    }
+    
+    file_map->base.vtable = &_mk_memory_map_file_class;
+    file_map->base.context = ctx;
+    file_map->bytes = bytes;
+    file_map->size = (uint64_t)st.st_size;
+    file_map->image_offset = image_offset;
+    file_map->image_address = 0;
+    file_map->segment_count = 0;
+    
+    mk_error_t err = __mk_memory_map_file_load_segments(file_map, ctx);
+    if (err) {
+        munmap(bytes, (size_t)st.st_size);
+        file_map->base.vtable = NULL;
+        return err;
+    }
+    
+    return MK_ESUCCESS;
+}
+
+//|++++++++++++++++++++++++++++++++++++|//
+mk_error_t
+mk_memory_map_file_free(mk_memory_map_file_t *file_map)
+{
+    if (munmap((void*)(uintptr_t)file_map->bytes, (size_t)file_map->size)) {
+        _mkl_inform(mk_type_get_context(file_map), "Failed to unmap the file.  munmap() returned error [%i].  #Memory #Leak", errno);
+    }
+    file_map->base.vtable = NULL;
+    
+    return MK_ESUCCESS;
+}
+
+//|++++++++++++++++++++++++++++++++++++|//
+mk_vm_address_t
+mk_memory_map_file_get_image_address(mk_memory_map_file_t *file_map)
+{ return file_map->image_address; }
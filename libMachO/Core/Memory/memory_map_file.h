@@ -0,0 +1,114 @@
+//----------------------------------------------------------------------------//
+//|
+//|             MachOKit - A Lightweight Mach-O Parsing Library
+//! @file       memory_map_file.h
+//!
+//! @author     D.V.
+//! @copyright  Copyright (c) 2014-2015 D.V. All rights reserved.
+//|
+//| Permission is hereby granted, free of charge, to any person obtaining a
+//| copy of this software and associated documentation files (the "Software"),
+//| to deal in the Software without restriction, including without limitation
+//| the rights to use, copy, modify, merge, publish, distribute, sublicense,
+//| and/or sell copies of the Software, and to permit persons to whom the
+//| Software is furnished to do so, subject to the following conditions:
+//|
+//| The above copyright notice and this permission notice shall be included
+//| in all copies or substantial portions of the Software.
+//|
+//| THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+//| OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+//| MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+//| IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+//| CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+//| TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+//| SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+//----------------------------------------------------------------------------//
+
+//----------------------------------------------------------------------------//
+//! @defgroup MEMORY_MAP_FILE File Memory Map
+//! @ingroup MEMORY_MAP
+//!
+//! A file memory map mediates access to a Mach-O image stored in a file.  It
+//! only uses POSIX APIs and is available on all platforms.
+//!
+//! The image is addressed as if it had been loaded at its preferred address.
+//! Addresses are translated to file offsets using the segment load commands
+//! of the image, and the zero-fill portion of a segment reads as zeros.
+//! Images without a segment that begins at file offset zero are addressed by
+//! their offset from the start of the image instead.
+//----------------------------------------------------------------------------//
+
+#ifndef _memory_map_file_h
+#define _memory_map_file_h
+
+//! @addtogroup MEMORY_MAP_FILE
+//! @{
+//!
+
+//----------------------------------------------------------------------------//
+#pragma mark -  Types
+//! @name       Types
+//----------------------------------------------------------------------------//
+
+//! The maximum number of segments a file memory map can translate.
+#define MK_MEMORY_MAP_FILE_MAX_SEGMENTS 32
+
+//◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦//
+//! @internal
+//
+typedef struct mk_memory_map_file_segment_s {
+    mk_vm_address_t vmaddr;
+    mk_vm_size_t vmsize;
+    // Relative to the start of the image.
+    uint64_t fileoff;
+    uint64_t filesize;
+} mk_memory_map_file_segment_t;
+
+//◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦//
+//! @internal
+//
+typedef struct mk_memory_map_file_s {
+    struct mk_memory_map_s base;
+    //! The contents of the file, mapped read-only.
+    const uint8_t *bytes;
+    //! The size of the file.
+    uint64_t size;
+    //! The offset of the image within the file.
+    uint64_t image_offset;
+    //! The preferred load address of the image.
+    mk_vm_address_t image_address;
+    //! The segments of the image, or zero if the image is addressed by
+    //! offset.
+    uint32_t segment_count;
+    mk_memory_map_file_segment_t segments[MK_MEMORY_MAP_FILE_MAX_SEGMENTS];
+} mk_memory_map_file_t;
+
+//! The identifier for the Memory Map File type.
+_mk_export intptr_t mk_memory_map_file_type;
+
+
+//----------------------------------------------------------------------------//
+#pragma mark -  Creating A File Memory Map
+//! @name       Creating A File Memory Map
+//----------------------------------------------------------------------------//
+
+//! Initializes a memory map for the Mach-O image at \a image_offset in the
+//! file open for reading as \a fd.  For a FAT binary, \a image_offset is the
+//! file offset of the slice.  The file descriptor may be closed once this
+//! function returns.
+_mk_export mk_error_t
+mk_memory_map_file_init(int fd, uint64_t image_offset, mk_context_t *ctx, mk_memory_map_file_t *file_map);
+
+_mk_export mk_error_t
+mk_memory_map_file_free(mk_memory_map_file_t *file_map);
+
+//! Returns the address at which the image should be parsed.  Pass this
+//! address to \ref mk_macho_init.
+_mk_export mk_vm_address_t
+mk_memory_map_file_get_image_address(mk_memory_map_file_t *file_map);
+
+
+//! @} MEMORY_MAP_FILE !//
+
+#endif /* _memory_map_file_h */
@@ -27,6 +27,8 @@
 
 #include "core_internal.h"
 
+#ifdef __APPLE__
+
 //----------------------------------------------------------------------------//
 #pragma mark -  Classes
 //----------------------------------------------------------------------------//
@@ -160,3 +162,5 @@ mk_memory_map_self_init(mk_context_t *ctx, mk_memory_map_self_t *self_map)
     
     return MK_ESUCCESS;
 }
+
+#endif
@@ -27,6 +27,8 @@
 
 #include "core_internal.h"
 
+#ifdef __APPLE__
+
 //----------------------------------------------------------------------------//
 #pragma mark -  Classes
 //----------------------------------------------------------------------------//
@@ -247,3 +249,5 @@ mk_memory_map_task_free(mk_memory_map_task_t *task_map)
     
     return MK_ESUCCESS;
 }
+
+#endif
@@ -137,6 +137,7 @@ vm_address_t
 mk_memory_object_remap_address(mk_memory_object_ref mobj, mk_vm_offset_t offset, mk_vm_address_t address, mk_vm_size_t length, mk_error_t* error)
 {
     mk_context_t *ctx = mk_type_get_context(mobj.memory_object);
+    _mk_statistics_add(ctx, remap, 1);
     
     // Adjust the address using the verified offset
     if (MK_VM_ADDRESS_MAX - offset < address) {
@@ -26,3 +26,106 @@
 //----------------------------------------------------------------------------//
 
 #include "core_internal.h"
+
+#include <time.h>
+
+//! The number of charges between samples of the deadline.  Reading the clock
+//! is cheap, but not as cheap as the work being charged.
+#define MK_BUDGET_DEADLINE_INTERVAL 256
+
+//----------------------------------------------------------------------------//
+#pragma mark -  Statistics
+//----------------------------------------------------------------------------//
+
+//|++++++++++++++++++++++++++++++++++++|//
+void
+mk_context_statistics_snapshot(mk_context_t *context, mk_context_statistics_t *snapshot)
+{
+    if (snapshot == NULL) return;
+    
+    mk_context_statistics_t *statistics = context ? context->statistics : NULL;
+    if (statistics == NULL) {
+        *snapshot = (mk_context_statistics_t){ 0 };
+        return;
+    }
+    
+    snapshot->init_object = __atomic_load_n(&statistics->init_object, __ATOMIC_RELAXED);
+    snapshot->free_object = __atomic_load_n(&statistics->free_object, __ATOMIC_RELAXED);
+    snapshot->bytes_copied = __atomic_load_n(&statistics->bytes_copied, __ATOMIC_RELAXED);
+    snapshot->remap = __atomic_load_n(&statistics->remap, __ATOMIC_RELAXED);
+    snapshot->string_table_lookups = __atomic_load_n(&statistics->string_table_lookups, __ATOMIC_RELAXED);
+    snapshot->trie_steps = __atomic_load_n(&statistics->trie_steps, __ATOMIC_RELAXED);
+    snapshot->load_commands_visited = __atomic_load_n(&statistics->load_commands_visited, __ATOMIC_RELAXED);
+}
+
+//|++++++++++++++++++++++++++++++++++++|//
+void
+mk_context_statistics_reset(mk_context_t *context)
+{
+    mk_context_statistics_t *statistics = context ? context->statistics : NULL;
+    if (statistics == NULL) return;
+    
+    __atomic_store_n(&statistics->init_object, 0, __ATOMIC_RELAXED);
+    __atomic_store_n(&statistics->free_object, 0, __ATOMIC_RELAXED);
+    __atomic_store_n(&statistics->bytes_copied, 0, __ATOMIC_RELAXED);
+    __atomic_store_n(&statistics->remap, 0, __ATOMIC_RELAXED);
+    __atomic_store_n(&statistics->string_table_lookups, 0, __ATOMIC_RELAXED);
+    __atomic_store_n(&statistics->trie_steps, 0, __ATOMIC_RELAXED);
+    __atomic_store_n(&statistics->load_commands_visited, 0, __ATOMIC_RELAXED);
+}
+
+//----------------------------------------------------------------------------//
+#pragma mark -  Budgets
+//----------------------------------------------------------------------------//
+
+//|++++++++++++++++++++++++++++++++++++|//
+static uint64_t
+mk_budget_now(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ULL + (uint64_t)ts.tv_nsec;
+}
+
+//|++++++++++++++++++++++++++++++++++++|//
+uint64_t
+mk_context_budget_deadline_after(uint64_t nanoseconds)
+{
+    uint64_t now = mk_budget_now();
+    return (UINT64_MAX - now < nanoseconds) ? UINT64_MAX : now + nanoseconds;
+}
+
+//|++++++++++++++++++++++++++++++++++++|//
+void
+mk_budget_meter_init(mk_budget_meter_t *meter, const mk_context_budget_t *budget)
+{
+    *meter = (mk_budget_meter_t){ .budget = budget };
+}
+
+//|++++++++++++++++++++++++++++++++++++|//
+mk_error_t
+mk_budget_meter_charge(mk_budget_meter_t *meter, uint64_t opcodes, uint64_t nodes, uint64_t trie_visits)
+{
+    const mk_context_budget_t *budget = meter->budget;
+    if (budget == NULL) return MK_ESUCCESS;
+    
+    meter->opcodes += opcodes;
+    meter->nodes += nodes;
+    meter->trie_visits += trie_visits;
+    
+    if (budget->max_opcodes && meter->opcodes > budget->max_opcodes)
+        return MK_EBUDGET_EXCEEDED;
+    if (budget->max_nodes && meter->nodes > budget->max_nodes)
+        return MK_EBUDGET_EXCEEDED;
+    if (budget->max_trie_visits && meter->trie_visits > budget->max_trie_visits)
+        return MK_EBUDGET_EXCEEDED;
+    
+    // Always sample the deadline on the first charge so that a parse started
+    // after the deadline does no work.
+    if (budget->deadline && meter->charges++ % MK_BUDGET_DEADLINE_INTERVAL == 0) {
+        if (mk_budget_now() > budget->deadline)
+            return MK_EBUDGET_EXCEEDED;
+    }
+    
+    return MK_ESUCCESS;
+}
@@ -40,6 +40,60 @@
 //! @{
 //!
 
+//◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦//
+//! Counters describing the work performed by libMachO on behalf of a
+//! context.  Counters are updated atomically and may be read while a parse
+//! is in progress using \ref mk_context_statistics_snapshot.
+//
+typedef struct mk_context_statistics_s {
+    //! Calls to \ref mk_memory_map_init_object.
+    uint64_t init_object;
+    //! Calls to \ref mk_memory_map_free_object.
+    uint64_t free_object;
+    //! Bytes copied by \ref mk_memory_map_copy_bytes.
+    uint64_t bytes_copied;
+    //! Calls to \ref mk_memory_object_remap_address.
+    uint64_t remap;
+    //! Strings looked up in a string table.
+    uint64_t string_table_lookups;
+    //! Nodes visited while walking an exports trie.
+    uint64_t trie_steps;
+    //! Load commands visited by \ref mk_macho_next_command.
+    uint64_t load_commands_visited;
+} mk_context_statistics_t;
+
+
+//◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦//
+//! Limits on the work performed by a single parse of a subsystem, such as
+//! one walk of an exports trie or one pass over a stream of bind opcodes.
+//! Each limit is ignored if it is zero.
+//
+typedef struct mk_context_budget_s {
+    //! The maximum number of opcodes executed by a single parse.
+    uint64_t max_opcodes;
+    //! The maximum number of nodes created by a single parse.
+    uint64_t max_nodes;
+    //! The maximum number of trie nodes visited by a single parse.
+    uint64_t max_trie_visits;
+    //! A point on the monotonic clock, in nanoseconds, after which all
+    //! parsing fails.  See \ref mk_context_budget_deadline_after.
+    uint64_t deadline;
+} mk_context_budget_t;
+
+//◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦//
+//! The work charged against an \ref mk_context_budget_t by one parse.
+//! Meters are not shared between threads.
+//
+typedef struct mk_budget_meter_s {
+    const mk_context_budget_t *budget;
+    uint64_t opcodes;
+    uint64_t nodes;
+    uint64_t trie_visits;
+    //! Charges since the deadline was last sampled.
+    uint32_t charges;
+} mk_budget_meter_t;
+
+
 //◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦//
 //! A table of callbacks and other information supplied by clients of libMachO.
 //
@@ -48,9 +102,53 @@ typedef struct mk_context_s {
     void *user_data;
     //! Logging
     mk_logger_c logger;
+    //! Statistics.  Optional; counters are only maintained if this is
+    //! non-\c NULL.
+    mk_context_statistics_t *statistics;
+    //! Work budget.  Optional; parsing is unbounded if this is \c NULL.
+    const mk_context_budget_t *budget;
 } mk_context_t;
 
 
+//----------------------------------------------------------------------------//
+#pragma mark -  Statistics
+//! @name       Statistics
+//----------------------------------------------------------------------------//
+
+//! Copies the current value of each counter in the statistics block of
+//! \a context into \a snapshot.  Copies zeroes if \a context has no
+//! statistics block.
+_mk_export void
+mk_context_statistics_snapshot(mk_context_t *context, mk_context_statistics_t *snapshot);
+
+//! Resets each counter in the statistics block of \a context to zero.
+_mk_export void
+mk_context_statistics_reset(mk_context_t *context);
+
+
+//----------------------------------------------------------------------------//
+#pragma mark -  Budgets
+//! @name       Budgets
+//----------------------------------------------------------------------------//
+
+//! Returns the point on the monotonic clock that is \a nanoseconds from now,
+//! suitable for use as the \c deadline of an \ref mk_context_budget_t.
+_mk_export uint64_t
+mk_context_budget_deadline_after(uint64_t nanoseconds);
+
+//! Initializes \a meter to charge work against \a budget, which is usually
+//! the budget of a context.  The meter never runs out if \a budget is
+//! \c NULL.
+_mk_export void
+mk_budget_meter_init(mk_budget_meter_t *meter, const mk_context_budget_t *budget);
+
+//! Charges work against \a meter.  Returns \ref MK_EBUDGET_EXCEEDED once
+//! any limit of the budget has been exceeded or its deadline has passed.
+//! The deadline is only sampled every few charges.
+_mk_export mk_error_t
+mk_budget_meter_charge(mk_budget_meter_t *meter, uint64_t opcodes, uint64_t nodes, uint64_t trie_visits);
+
+
 //! @} CONTEXT !//
 
 #endif /* _context_h */
@@ -64,6 +64,8 @@ mk_error_string(mk_error_t error)
             return "Arithmetic underflow";
         case MK_EBAD_ACCESS:
             return "Invalid memory access";
+        case MK_EBUDGET_EXCEEDED:
+            return "Work budget exceeded";
         default:
             return "";
     }
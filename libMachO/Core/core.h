@@ -37,7 +37,21 @@
 
 #include "base.h"
 
-#include <mach/mach.h>
+#ifdef __APPLE__
+    #include <mach/mach.h>
+#else
+    #include <sys/types.h>
+    #include <mach/machine.h>
+    #include <mach/vm_prot.h>
+    // The VM types libMachO uses outside of the Mach memory maps.  The
+    // definitions match those of a 64-bit Darwin host.
+    typedef uintptr_t vm_address_t;
+    typedef uintptr_t vm_size_t;
+    typedef uintptr_t vm_offset_t;
+    typedef uint64_t mach_vm_address_t;
+    typedef uint64_t mach_vm_size_t;
+    typedef uint64_t mach_vm_offset_t;
+#endif
 
 //! @addtogroup CORE
 //! @{
@@ -138,7 +152,9 @@ typedef enum {
     //! Adding the provided inputs would result in an underflow.
     MK_EUNDERFLOW,
     //! Memory at the input address can not be accessed.
-    MK_EBAD_ACCESS
+    MK_EBAD_ACCESS,
+    //! The operation exceeded the work budget of its context.
+    MK_EBUDGET_EXCEEDED
 } mk_error_t;
 
 //! A mask applied to the returned error code if the error occurred while
@@ -366,8 +382,11 @@ mk_type_copy_description(mk_type_ref mk, char* output, size_t output_len);
 #include "context.h"
 #include "data_model.h"
 #include "memory_map.h"
+#include "memory_map_file.h"
+#ifdef __APPLE__
 #include "memory_map_self.h"
 #include "memory_map_task.h"
+#endif
 
 
 //! @} CORE !//
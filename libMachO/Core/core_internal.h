@@ -105,7 +105,7 @@ typedef struct _mk_runtime_base_s {
 //! @name       Runtime
 //----------------------------------------------------------------------------//
 
-#if __LP64__
+#if __MACHOKIT__ && __LP64__
 // TODO - Find a better way to handle the bridging or remove it altogether.
 _mk_weak_import const uintptr_t objc_debug_isa_class_mask;
 #endif
@@ -142,6 +142,20 @@ _mk_internal_extern mk_context_t*
 mk_type_get_context(mk_type_ref mk);
 
 
+//----------------------------------------------------------------------------//
+#pragma mark -  Statistics
+//! @name       Statistics
+//----------------------------------------------------------------------------//
+
+//! Adds \a N to the \a COUNTER of the statistics block of the context
+//! \a CTX, if it has one.
+#define _mk_statistics_add(CTX, COUNTER, N) do { \
+        mk_context_t *_mk_stats_ctx = (CTX); \
+        if (_mk_stats_ctx && _mk_stats_ctx->statistics) \
+            __atomic_fetch_add(&_mk_stats_ctx->statistics->COUNTER, (uint64_t)(N), __ATOMIC_RELAXED); \
+    } while (0)
+
+
 //----------------------------------------------------------------------------//
 #pragma mark -  Includes
 //----------------------------------------------------------------------------//
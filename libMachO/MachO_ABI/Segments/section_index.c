@@ -0,0 +1,545 @@
+//----------------------------------------------------------------------------//
+//|
+//|             MachOKit - A Lightweight Mach-O Parsing Library
+//|             section_index.c
+//|
+//|             D.V.
+//|             Copyright (c) 2014-2015 D.V. All rights reserved.
+//|
+//| Permission is hereby granted, free of charge, to any person obtaining a
+//| copy of this software and associated documentation files (the "Software"),
+//| to deal in the Software without restriction, including without limitation
+//| the rights to use, copy, modify, merge, publish, distribute, sublicense,
+//| and/or sell copies of the Software, and to permit persons to whom the
+//| Software is furnished to do so, subject to the following conditions:
+//|
+//| The above copyright notice and this permission notice shall be included
+//| in all copies or substantial portions of the Software.
+//|
+//| THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+//| OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+//| MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+//| IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+//| CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+//| TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+//| SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+//----------------------------------------------------------------------------//
+
+#include "macho_abi_internal.h"
+
+//----------------------------------------------------------------------------//
+#pragma mark -  Classes
+//----------------------------------------------------------------------------//
+
+//|++++++++++++++++++++++++++++++++++++|//
+static mk_context_t*
+__mk_section_index_get_context(mk_section_index_ref self)
+{ return mk_type_get_context( self.section_index->image.type ); }
+
+const struct _mk_section_index_vtable _mk_section_index_class = {
+    .base.super                 = &_mk_type_class,
+    .base.name                  = "section index",
+    .base.get_context           = &__mk_section_index_get_context
+};
+
+intptr_t mk_section_index_type = (intptr_t)&_mk_section_index_class;
+
+//----------------------------------------------------------------------------//
+#pragma mark -  Helpers
+//----------------------------------------------------------------------------//
+
+//|++++++++++++++++++++++++++++++++++++|//
+static void
+_mk_section_index_copy_name(const char *name, char output[16])
+{
+    memset(output, 0, 16);
+    if (name) strncpy(output, name, 16);
+}
+
+//|++++++++++++++++++++++++++++++++++++|//
+static void
+_mk_section_index_normalize_name(char name[16])
+{
+    // Names are compared as 16 bytes.  Clear anything following the
+    // terminator.
+    size_t len = strnlen(name, 16);
+    memset(name + len, 0, 16 - len);
+}
+
+//|++++++++++++++++++++++++++++++++++++|//
+static uint32_t
+_mk_section_index_hash(const char segname[16], const char *sectname)
+{
+    // FNV-1a over the zero padded name(s).
+    uint32_t hash = 2166136261u;
+    for (size_t i = 0; i < 16; i++)
+        hash = (hash ^ (uint8_t)segname[i]) * 16777619u;
+    if (sectname) {
+        for (size_t i = 0; i < 16; i++)
+            hash = (hash ^ (uint8_t)sectname[i]) * 16777619u;
+    }
+    return hash;
+}
+
+//|++++++++++++++++++++++++++++++++++++|//
+// Returns the number of hash table slots for count entries: the smallest
+// power of two that is at least twice count.
+static uint32_t
+_mk_section_index_slot_count(uint32_t count)
+{
+    uint64_t slots = 1;
+    while (slots < (uint64_t)count * 2)
+        slots <<= 1;
+    return (uint32_t)MIN(slots, (uint64_t)1 << 31);
+}
+
+//|++++++++++++++++++++++++++++++++++++|//
+// Returns the size of the tables for the specified number of segments and
+// sections, with the segment entries first so that every table is aligned.
+static size_t
+_mk_section_index_get_size(uint32_t segment_count, uint32_t section_count)
+{
+    return segment_count * sizeof(mk_section_index_segment_t)
+         + section_count * sizeof(mk_section_index_section_t)
+         + (segment_count + section_count) * sizeof(uint32_t)
+         + (_mk_section_index_slot_count(segment_count) + _mk_section_index_slot_count(section_count)) * sizeof(uint32_t);
+}
+
+//|++++++++++++++++++++++++++++++++++++|//
+// Counts the segments and sections of image.
+static mk_error_t
+_mk_section_index_count(mk_macho_ref image, uint32_t *segment_count, uint32_t *section_count)
+{
+    mk_error_t err;
+    mk_context_t *ctx = mk_type_get_context(image.type);
+    
+    *segment_count = 0;
+    *section_count = 0;
+    
+    struct load_command *lc = NULL;
+    while ((lc = mk_macho_next_command(image, lc, NULL))) {
+        mk_load_command_t load_command;
+        if ((err = mk_load_command_init(image, lc, &load_command))) {
+            _mkl_debug(ctx, "Failed to initialize load command at host address %p.  Error [%s].", lc, mk_error_string(err));
+            return err;
+        }
+        
+        bool is64 = (mk_load_command_id(&load_command) == mk_load_command_segment_64_id());
+        if (!is64 && mk_load_command_id(&load_command) != mk_load_command_segment_id())
+            continue;
+        
+        (*segment_count)++;
+        
+        void *sect = NULL;
+        while ((sect = is64 ? (void*)mk_load_command_segment_64_next_section(&load_command, sect, NULL)
+                            : (void*)mk_load_command_segment_next_section(&load_command, sect, NULL)))
+            (*section_count)++;
+    }
+    
+    return MK_ESUCCESS;
+}
+
+//|++++++++++++++++++++++++++++++++++++|//
+static inline mk_vm_address_t
+_mk_section_index_location(const void *base, size_t stride, uint32_t position)
+{ return ((const mk_vm_range_t*)((const uint8_t*)base + position * stride))->location; }
+
+//|++++++++++++++++++++++++++++++++++++|//
+static inline bool
+_mk_section_index_position_less(const void *base, size_t stride, uint32_t a, uint32_t b)
+{
+    mk_vm_address_t location_a = _mk_section_index_location(base, stride, a);
+    mk_vm_address_t location_b = _mk_section_index_location(base, stride, b);
+    if (location_a != location_b)
+        return location_a < location_b;
+    return a < b;
+}
+
+//|++++++++++++++++++++++++++++++++++++|//
+// Returns the position of the last range in order whose location is at or
+// below address, or -1.
+static int64_t
+_mk_section_index_search(const uint32_t *order, uint32_t count, const void *base, size_t stride, mk_vm_address_t address)
+{
+    int64_t lo = 0, hi = (int64_t)count - 1, found = -1;
+    while (lo <= hi) {
+        int64_t mid = lo + (hi - lo) / 2;
+        if (_mk_section_index_location(base, stride, order[mid]) <= address) {
+            found = mid;
+            lo = mid + 1;
+        } else {
+            hi = mid - 1;
+        }
+    }
+    return found;
+}
+
+//|++++++++++++++++++++++++++++++++++++|//
+static void
+_mk_section_index_sift_down(uint32_t *order, uint32_t root, uint32_t count, const void *base, size_t stride)
+{
+    for (;;) {
+        uint32_t child = 2 * root + 1;
+        if (child >= count)
+            break;
+        if (child + 1 < count && _mk_section_index_position_less(base, stride, order[child], order[child + 1]))
+            child++;
+        if (!_mk_section_index_position_less(base, stride, order[root], order[child]))
+            break;
+        
+        uint32_t tmp = order[root];
+        order[root] = order[child];
+        order[child] = tmp;
+        root = child;
+    }
+}
+
+//|++++++++++++++++++++++++++++++++++++|//
+// Heap sort.  Unlike qsort(3), it never allocates memory.
+static void
+_mk_section_index_sort_by_address(uint32_t *order, uint32_t count, const void *base, size_t stride)
+{
+    // Segments and sections are almost always in address order already, in
+    // which case there is nothing to do.
+    bool sorted = true;
+    for (uint32_t i = 1; i < count && sorted; i++)
+        sorted = _mk_section_index_position_less(base, stride, order[i - 1], order[i]);
+    if (sorted)
+        return;
+    
+    for (uint32_t i = count / 2; i > 0; i--)
+        _mk_section_index_sift_down(order, i - 1, count, base, stride);
+    
+    for (uint32_t end = count - 1; end > 0; end--) {
+        uint32_t tmp = order[0];
+        order[0] = order[end];
+        order[end] = tmp;
+        _mk_section_index_sift_down(order, 0, end, base, stride);
+    }
+}
+
+//----------------------------------------------------------------------------//
+#pragma mark -  Working With Section Indexes
+//----------------------------------------------------------------------------//
+
+//|++++++++++++++++++++++++++++++++++++|//
+size_t
+mk_section_index_get_required_size(mk_macho_ref image)
+{
+    if (image.macho == NULL) return 0;
+    
+    uint32_t segment_count, section_count;
+    if (_mk_section_index_count(image, &segment_count, &section_count))
+        return 0;
+    
+    return _mk_section_index_get_size(segment_count, section_count);
+}
+
+//|++++++++++++++++++++++++++++++++++++|//
+mk_error_t
+mk_section_index_init(mk_macho_ref image, void *buffer, size_t buffer_size, mk_section_index_t *section_index)
+{
+    if (section_index == NULL) return MK_EINVAL;
+    if (image.macho == NULL) return MK_EINVAL;
+    if (buffer == NULL && buffer_size != 0) return MK_EINVAL;
+    
+    mk_error_t err;
+    mk_context_t *ctx = mk_type_get_context(image.type);
+    mk_vm_slide_t slide = mk_macho_get_slide(image);
+    
+    uint32_t segment_capacity, section_capacity;
+    if ((err = _mk_section_index_count(image, &segment_capacity, &section_capacity)))
+        return err;
+    
+    size_t required_size = _mk_section_index_get_size(segment_capacity, section_capacity);
+    if (buffer_size < required_size) {
+        _mkl_debug(ctx, "Buffer of size [%zu] is smaller than the [%zu] bytes needed to index the image.", buffer_size, required_size);
+        return MK_ESIZE;
+    }
+    
+    memset(section_index, 0, sizeof(*section_index));
+    section_index->image = image;
+    section_index->segment_slot_count = _mk_section_index_slot_count(segment_capacity);
+    section_index->section_slot_count = _mk_section_index_slot_count(section_capacity);
+    
+    uint8_t *cursor = buffer;
+    section_index->segments = (mk_section_index_segment_t*)cursor;
+    cursor += segment_capacity * sizeof(mk_section_index_segment_t);
+    section_index->sections = (mk_section_index_section_t*)cursor;
+    cursor += section_capacity * sizeof(mk_section_index_section_t);
+    section_index->sorted_segments = (uint32_t*)cursor;
+    cursor += segment_capacity * sizeof(uint32_t);
+    section_index->sorted_sections = (uint32_t*)cursor;
+    cursor += section_capacity * sizeof(uint32_t);
+    section_index->segments_by_name = (uint32_t*)cursor;
+    cursor += section_index->segment_slot_count * sizeof(uint32_t);
+    section_index->sections_by_name = (uint32_t*)cursor;
+    
+    memset(section_index->segments_by_name, 0, section_index->segment_slot_count * sizeof(uint32_t));
+    memset(section_index->sections_by_name, 0, section_index->section_slot_count * sizeof(uint32_t));
+    
+    struct load_command *lc = NULL;
+    while ((lc = mk_macho_next_command(image, lc, NULL))) {
+        mk_load_command_t load_command;
+        if ((err = mk_load_command_init(image, lc, &load_command))) {
+            _mkl_debug(ctx, "Failed to initialize load command at host address %p.  Error [%s].", lc, mk_error_string(err));
+            return err;
+        }
+        
+        bool is64 = (mk_load_command_id(&load_command) == mk_load_command_segment_64_id());
+        if (!is64 && mk_load_command_id(&load_command) != mk_load_command_segment_id())
+            continue;
+        
+        // The load commands are not expected to change between the count
+        // and this walk, but the tables must never be overrun if they do.
+        if (section_index->segment_count >= segment_capacity) {
+            _mkl_debug(ctx, "Image has more than the %" PRIu32 " segments counted.", segment_capacity);
+            return MK_ESIZE;
+        }
+        
+        uint32_t segment_position = section_index->segment_count;
+        mk_section_index_segment_t *segment = &section_index->segments[segment_position];
+        mk_vm_address_t vmaddr;
+        mk_vm_size_t vmsize;
+        
+        segment->command.any = lc;
+        if (is64) {
+            vmaddr = mk_load_command_segment_64_get_vmaddr(&load_command);
+            vmsize = mk_load_command_segment_64_get_vmsize(&load_command);
+            mk_load_command_segment_64_copy_name(&load_command, segment->name);
+        } else {
+            vmaddr = mk_load_command_segment_get_vmaddr(&load_command);
+            vmsize = mk_load_command_segment_get_vmsize(&load_command);
+            mk_load_command_segment_copy_name(&load_command, segment->name);
+        }
+        _mk_section_index_normalize_name(segment->name);
+        
+        if ((err = mk_vm_address_apply_slide(vmaddr, slide, &vmaddr))) {
+            _mkl_debug(ctx, "Arithmetic error [%s] applying slide [%" MK_VM_PRIiSLIDE "] to segment VM address [0x%" MK_VM_PRIxADDR "].", mk_error_string(err), slide, vmaddr);
+            return err;
+        }
+        segment->target_range = mk_vm_range_make(vmaddr, vmsize);
+        
+        section_index->sorted_segments[segment_position] = segment_position;
+        section_index->segment_count++;
+        
+        // Only the first segment with a given name is reachable by name.
+        for (uint32_t slot = _mk_section_index_hash(segment->name, NULL);; slot++) {
+            uint32_t *entry = &section_index->segments_by_name[slot & (section_index->segment_slot_count - 1)];
+            if (*entry == 0) { *entry = segment_position + 1; break; }
+            if (memcmp(section_index->segments[*entry - 1].name, segment->name, 16) == 0) break;
+        }
+        
+        // Sections
+        void *sect = NULL;
+        while ((sect = is64 ? (void*)mk_load_command_segment_64_next_section(&load_command, sect, NULL)
+                            : (void*)mk_load_command_segment_next_section(&load_command, sect, NULL)))
+        {
+            if (section_index->section_count >= section_capacity) {
+                _mkl_debug(ctx, "Image has more than the %" PRIu32 " sections counted.", section_capacity);
+                return MK_ESIZE;
+            }
+            
+            uint32_t section_position = section_index->section_count;
+            mk_section_index_section_t *section = &section_index->sections[section_position];
+            mk_vm_address_t addr;
+            mk_vm_size_t size;
+            
+            if (is64) {
+                mk_load_command_section_64_t section_command;
+                if ((err = mk_load_command_segment_64_section_init(&load_command, sect, &section_command)))
+                    return err;
+                addr = mk_load_command_segment_64_section_get_addr(&section_command);
+                size = mk_load_command_segment_64_section_get_size(&section_command);
+                mk_load_command_segment_64_section_copy_name(&section_command, section->name);
+                mk_load_command_segment_64_section_copy_segment_name(&section_command, section->segment_name);
+            } else {
+                mk_load_command_section_t section_command;
+                if ((err = mk_load_command_segment_section_init(&load_command, sect, &section_command)))
+                    return err;
+                addr = mk_load_command_segment_section_get_addr(&section_command);
+                size = mk_load_command_segment_section_get_size(&section_command);
+                mk_load_command_segment_section_copy_name(&section_command, section->name);
+                mk_load_command_segment_section_copy_segment_name(&section_command, section->segment_name);
+            }
+            _mk_section_index_normalize_name(section->name);
+            _mk_section_index_normalize_name(section->segment_name);
+            
+            if ((err = mk_vm_address_apply_slide(addr, slide, &addr))) {
+                _mkl_debug(ctx, "Arithmetic error [%s] applying slide [%" MK_VM_PRIiSLIDE "] to section VM address [0x%" MK_VM_PRIxADDR "].", mk_error_string(err), slide, addr);
+                return err;
+            }
+            
+            section->command.any = sect;
+            section->target_range = mk_vm_range_make(addr, size);
+            section->segment = segment_position;
+            
+            section_index->sorted_sections[section_position] = section_position;
+            section_index->section_count++;
+            
+            for (uint32_t slot = _mk_section_index_hash(section->segment_name, section->name);; slot++) {
+                uint32_t *entry = &section_index->sections_by_name[slot & (section_index->section_slot_count - 1)];
+                if (*entry == 0) { *entry = section_position + 1; break; }
+                mk_section_index_section_t *existing = &section_index->sections[*entry - 1];
+                if (memcmp(existing->segment_name, section->segment_name, 16) == 0 && memcmp(existing->name, section->name, 16) == 0) break;
+            }
+        }
+    }
+    
+    _mk_section_index_sort_by_address(section_index->sorted_segments, section_index->segment_count, (uint8_t*)section_index->segments + offsetof(mk_section_index_segment_t, target_range), sizeof(mk_section_index_segment_t));
+    _mk_section_index_sort_by_address(section_index->sorted_sections, section_index->section_count, (uint8_t*)section_index->sections + offsetof(mk_section_index_section_t, target_range), sizeof(mk_section_index_section_t));
+    
+    section_index->vtable = &_mk_section_index_class;
+    return MK_ESUCCESS;
+}
+
+//|++++++++++++++++++++++++++++++++++++|//
+void
+mk_section_index_free(mk_section_index_ref section_index)
+{
+    section_index.section_index->segment_count = 0;
+    section_index.section_index->section_count = 0;
+    section_index.section_index->segments = NULL;
+    section_index.section_index->sections = NULL;
+    section_index.section_index->vtable = NULL;
+}
+
+//|++++++++++++++++++++++++++++++++++++|//
+mk_macho_ref mk_section_index_get_macho(mk_section_index_ref section_index)
+{ return section_index.section_index->image; }
+
+//|++++++++++++++++++++++++++++++++++++|//
+uint32_t mk_section_index_get_segment_count(mk_section_index_ref section_index)
+{ return section_index.section_index->segment_count; }
+
+//|++++++++++++++++++++++++++++++++++++|//
+uint32_t mk_section_index_get_section_count(mk_section_index_ref section_index)
+{ return section_index.section_index->section_count; }
+
+//----------------------------------------------------------------------------//
+#pragma mark -  Looking Up Segments
+//----------------------------------------------------------------------------//
+
+//|++++++++++++++++++++++++++++++++++++|//
+mk_macho_segment_load_command_ptr
+mk_section_index_find_segment(mk_section_index_ref section_index, const char *segname, mk_vm_range_t *target_range)
+{
+    mk_section_index_t *self = section_index.section_index;
+    mk_macho_segment_load_command_ptr result; result.any = NULL;
+    
+    char name[16];
+    _mk_section_index_copy_name(segname, name);
+    
+    for (uint32_t slot = _mk_section_index_hash(name, NULL);; slot++) {
+        uint32_t entry = self->segments_by_name[slot & (self->segment_slot_count - 1)];
+        if (entry == 0)
+            break;
+        
+        mk_section_index_segment_t *segment = &self->segments[entry - 1];
+        if (memcmp(segment->name, name, 16) == 0) {
+            if (target_range) *target_range = segment->target_range;
+            result = segment->command;
+            break;
+        }
+    }
+    
+    return result;
+}
+
+//|++++++++++++++++++++++++++++++++++++|//
+mk_macho_segment_load_command_ptr
+mk_section_index_find_segment_containing_address(mk_section_index_ref section_index, mk_vm_address_t target_address, mk_vm_range_t *target_range)
+{
+    mk_section_index_t *self = section_index.section_index;
+    mk_macho_segment_load_command_ptr result; result.any = NULL;
+    
+    int64_t i = _mk_section_index_search(self->sorted_segments, self->segment_count, (uint8_t*)self->segments + offsetof(mk_section_index_segment_t, target_range), sizeof(mk_section_index_segment_t), target_address);
+    
+    // Walk back over any empty segments that share a start address with the
+    // segment occupying target_address.
+    for (; i >= 0; i--) {
+        mk_section_index_segment_t *segment = &self->segments[self->sorted_segments[i]];
+        if (mk_vm_range_contains_address(segment->target_range, 0, target_address) == MK_ESUCCESS) {
+            if (target_range) *target_range = segment->target_range;
+            result = segment->command;
+            break;
+        }
+        if (segment->target_range.length != 0)
+            break;
+    }
+    
+    return result;
+}
+
+//----------------------------------------------------------------------------//
+#pragma mark -  Looking Up Sections
+//----------------------------------------------------------------------------//
+
+//|++++++++++++++++++++++++++++++++++++|//
+mk_macho_section_command_ptr
+mk_section_index_find_section(mk_section_index_ref section_index, const char *segname, const char *sectname, mk_vm_range_t *target_range)
+{
+    mk_section_index_t *self = section_index.section_index;
+    mk_macho_section_command_ptr result; result.any = NULL;
+    
+    char seg[16], sect[16];
+    _mk_section_index_copy_name(segname, seg);
+    _mk_section_index_copy_name(sectname, sect);
+    
+    for (uint32_t slot = _mk_section_index_hash(seg, sect);; slot++) {
+        uint32_t entry = self->sections_by_name[slot & (self->section_slot_count - 1)];
+        if (entry == 0)
+            break;
+        
+        mk_section_index_section_t *section = &self->sections[entry - 1];
+        if (memcmp(section->segment_name, seg, 16) == 0 && memcmp(section->name, sect, 16) == 0) {
+            if (target_range) *target_range = section->target_range;
+            result = section->command;
+            break;
+        }
+    }
+    
+    return result;
+}
+
+//|++++++++++++++++++++++++++++++++++++|//
+mk_macho_section_command_ptr
+mk_section_index_find_section_containing_address(mk_section_index_ref section_index, mk_vm_address_t target_address, mk_vm_range_t *target_range)
+{
+    mk_section_index_t *self = section_index.section_index;
+    mk_macho_section_command_ptr result; result.any = NULL;
+    
+    int64_t i = _mk_section_index_search(self->sorted_sections, self->section_count, (uint8_t*)self->sections + offsetof(mk_section_index_section_t, target_range), sizeof(mk_section_index_section_t), target_address);
+    
+    // Walk back over any empty sections that share a start address with the
+    // section occupying target_address.
+    for (; i >= 0; i--) {
+        mk_section_index_section_t *section = &self->sections[self->sorted_sections[i]];
+        if (mk_vm_range_contains_address(section->target_range, 0, target_address) == MK_ESUCCESS) {
+            if (target_range) *target_range = section->target_range;
+            result = section->command;
+            break;
+        }
+        if (section->target_range.length != 0)
+            break;
+    }
+    
+    return result;
+}
+
+//|++++++++++++++++++++++++++++++++++++|//
+mk_macho_section_command_ptr
+mk_section_index_get_section_at_ordinal(mk_section_index_ref section_index, uint8_t ordinal, mk_vm_range_t *target_range)
+{
+    mk_section_index_t *self = section_index.section_index;
+    mk_macho_section_command_ptr result; result.any = NULL;
+    
+    if (ordinal == NO_SECT || ordinal > self->section_count)
+        return result;
+    
+    mk_section_index_section_t *section = &self->sections[ordinal - 1];
+    if (target_range) *target_range = section->target_range;
+    result = section->command;
+    
+    return result;
+}
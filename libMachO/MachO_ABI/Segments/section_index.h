@@ -0,0 +1,206 @@
+//----------------------------------------------------------------------------//
+//|
+//|             MachOKit - A Lightweight Mach-O Parsing Library
+//! @file       section_index.h
+//!
+//! @author     D.V.
+//! @copyright  Copyright (c) 2014-2015 D.V. All rights reserved.
+//|
+//| Permission is hereby granted, free of charge, to any person obtaining a
+//| copy of this software and associated documentation files (the "Software"),
+//| to deal in the Software without restriction, including without limitation
+//| the rights to use, copy, modify, merge, publish, distribute, sublicense,
+//| and/or sell copies of the Software, and to permit persons to whom the
+//| Software is furnished to do so, subject to the following conditions:
+//|
+//| The above copyright notice and this permission notice shall be included
+//| in all copies or substantial portions of the Software.
+//|
+//| THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+//| OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+//| MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+//| IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+//| CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+//| TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+//| SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+//----------------------------------------------------------------------------//
+
+#ifndef _section_index_h
+#define _section_index_h
+
+//! @addtogroup SEGMENTS
+//! @{
+//!
+
+//----------------------------------------------------------------------------//
+#pragma mark -  Types
+//! @name       Types
+//----------------------------------------------------------------------------//
+
+//◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦//
+//! @internal
+//
+typedef struct mk_section_index_segment_s {
+    // The segment load command, in the current process.
+    mk_macho_segment_load_command_ptr command;
+    // The range of memory (in the target address space) that the segment
+    // occupies.
+    mk_vm_range_t target_range;
+    char name[16];
+} mk_section_index_segment_t;
+
+//◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦//
+//! @internal
+//
+typedef struct mk_section_index_section_s {
+    // The section command, in the current process.
+    mk_macho_section_command_ptr command;
+    // The range of memory (in the target address space) that the section
+    // occupies.
+    mk_vm_range_t target_range;
+    // Position of the parent segment in the segments array.
+    uint32_t segment;
+    char segment_name[16];
+    char name[16];
+} mk_section_index_section_t;
+
+//◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦//
+//! @internal
+//
+typedef struct mk_section_index_s {
+    __MK_RUNTIME_BASE
+    // The Mach-O image that was indexed.
+    mk_macho_ref image;
+    uint32_t segment_count;
+    uint32_t section_count;
+    uint32_t segment_slot_count;
+    uint32_t section_slot_count;
+    // Segments and sections, in load command order, in caller provided
+    // memory.
+    mk_section_index_segment_t *segments;
+    mk_section_index_section_t *sections;
+    // Positions in the arrays above, sorted by target address.
+    uint32_t *sorted_segments;
+    uint32_t *sorted_sections;
+    // Open addressed hash tables keyed by name, with a power of two number
+    // of slots that is at least twice the number of entries.  Slots hold a
+    // position in the arrays above plus one, or zero if empty.
+    uint32_t *segments_by_name;
+    uint32_t *sections_by_name;
+} mk_section_index_t;
+
+//◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦//
+//! The Section Index polymorphic type.
+//
+typedef union {
+    mk_type_ref type;
+    struct mk_section_index_s *section_index;
+} mk_section_index_ref _mk_transparent_union;
+
+//! The identifier for the Section Index type.
+_mk_export intptr_t mk_section_index_type;
+
+
+//----------------------------------------------------------------------------//
+#pragma mark -  Working With Section Indexes
+//! @name       Working With Section Indexes
+//----------------------------------------------------------------------------//
+
+//! Returns the size of the buffer needed to index the segments and
+//! sections of \a image, or \c 0 if the load commands of \a image could not
+//! be walked.
+_mk_export size_t
+mk_section_index_get_required_size(mk_macho_ref image);
+
+//! Initializes a Section Index object by walking the segment load commands
+//! of \a image once.  Subsequent lookups by name are constant time, and
+//! lookups by address are logarithmic in the number of segments or sections.
+//!
+//! This function does not call malloc(3).  Every table is placed in
+//! \a buffer, so the index has no fixed limit on the number of segments or
+//! sections.
+//!
+//! @param  image
+//!         The Mach-O image to index.  Must remain valid for the lifetime of
+//!         the section index object.
+//! @param  buffer
+//!         Memory to hold the index tables.  Must be aligned for
+//!         \ref mk_section_index_segment_t and remain valid for the
+//!         lifetime of the section index object.
+//! @param  buffer_size
+//!         The size of \a buffer, which must be at least the size returned
+//!         by \ref mk_section_index_get_required_size.
+//! @param  section_index
+//!         A valid \ref mk_section_index_t structure.
+//! @return
+//! \ref MK_ESIZE if \a buffer is too small.
+_mk_export mk_error_t
+mk_section_index_init(mk_macho_ref image, void *buffer, size_t buffer_size, mk_section_index_t *section_index);
+
+//! Cleans up any resources held by \a section_index.  It is no longer safe
+//! to use \a section_index after calling this function.  The buffer
+//! provided at initialization is not freed.
+_mk_export void
+mk_section_index_free(mk_section_index_ref section_index);
+
+//! Returns the Mach-O image that the specified section index was built from.
+_mk_export mk_macho_ref
+mk_section_index_get_macho(mk_section_index_ref section_index);
+
+//! Returns the number of segments in the specified section index.
+_mk_export uint32_t
+mk_section_index_get_segment_count(mk_section_index_ref section_index);
+
+//! Returns the number of sections in the specified section index.
+_mk_export uint32_t
+mk_section_index_get_section_count(mk_section_index_ref section_index);
+
+
+//----------------------------------------------------------------------------//
+#pragma mark -  Looking Up Segments
+//! @name       Looking Up Segments
+//!
+//! These functions return a process-relative pointer to the segment load
+//! command, or \c NULL if no segment matched.  If \a target_range is not
+//! \c NULL, it is populated with the range of memory (in the target address
+//! space) that the segment occupies.
+//----------------------------------------------------------------------------//
+
+//! Finds the first segment named \a segname.
+_mk_export mk_macho_segment_load_command_ptr
+mk_section_index_find_segment(mk_section_index_ref section_index, const char *segname, mk_vm_range_t *target_range);
+
+//! Finds the segment occupying \a target_address.
+_mk_export mk_macho_segment_load_command_ptr
+mk_section_index_find_segment_containing_address(mk_section_index_ref section_index, mk_vm_address_t target_address, mk_vm_range_t *target_range);
+
+
+//----------------------------------------------------------------------------//
+#pragma mark -  Looking Up Sections
+//! @name       Looking Up Sections
+//!
+//! These functions return a process-relative pointer to the section command,
+//! or \c NULL if no section matched.  If \a target_range is not \c NULL, it
+//! is populated with the range of memory (in the target address space) that
+//! the section occupies.
+//----------------------------------------------------------------------------//
+
+//! Finds the first section named \a sectname whose section command names
+//! \a segname as its segment.
+_mk_export mk_macho_section_command_ptr
+mk_section_index_find_section(mk_section_index_ref section_index, const char *segname, const char *sectname, mk_vm_range_t *target_range);
+
+//! Finds the section occupying \a target_address.  Sections with a size of
+//! zero never match.
+_mk_export mk_macho_section_command_ptr
+mk_section_index_find_section_containing_address(mk_section_index_ref section_index, mk_vm_address_t target_address, mk_vm_range_t *target_range);
+
+//! Returns the section with the one-based \a ordinal, as used by the
+//! \c n_sect field of a symbol table entry.
+_mk_export mk_macho_section_command_ptr
+mk_section_index_get_section_at_ordinal(mk_section_index_ref section_index, uint8_t ordinal, mk_vm_range_t *target_range);
+
+
+//! @} SEGMENTS !//
+
+#endif /* _section_index_h */
@@ -0,0 +1,293 @@
+//----------------------------------------------------------------------------//
+//|
+//|             MachOKit - A Lightweight Mach-O Parsing Library
+//|             data_in_code.c
+//|
+//|             D.V.
+//|             Copyright (c) 2014-2015 D.V. All rights reserved.
+//|
+//| Permission is hereby granted, free of charge, to any person obtaining a
+//| copy of this software and associated documentation files (the "Software"),
+//| to deal in the Software without restriction, including without limitation
+//| the rights to use, copy, modify, merge, publish, distribute, sublicense,
+//| and/or sell copies of the Software, and to permit persons to whom the
+//| Software is furnished to do so, subject to the following conditions:
+//|
+//| The above copyright notice and this permission notice shall be included
+//| in all copies or substantial portions of the Software.
+//|
+//| THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+//| OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+//| MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+//| IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+//| CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+//| TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+//| SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+//----------------------------------------------------------------------------//
+
+#include "macho_abi_internal.h"
+
+//----------------------------------------------------------------------------//
+#pragma mark -  Classes
+//----------------------------------------------------------------------------//
+
+//|++++++++++++++++++++++++++++++++++++|//
+static mk_context_t*
+__mk_data_in_code_get_context(mk_data_in_code_ref self)
+{ return mk_type_get_context( self.data_in_code->link_edit.type ); }
+
+const struct _mk_data_in_code_vtable _mk_data_in_code_class = {
+    .base.super                 = &_mk_type_class,
+    .base.name                  = "data in code",
+    .base.get_context           = &__mk_data_in_code_get_context
+};
+
+intptr_t mk_data_in_code_type = (intptr_t)&_mk_data_in_code_class;
+
+//----------------------------------------------------------------------------//
+#pragma mark -  Working With Data In Code Entries
+//----------------------------------------------------------------------------//
+
+//|++++++++++++++++++++++++++++++++++++|//
+mk_error_t
+mk_data_in_code_init(mk_segment_ref segment, mk_load_command_ref load_command, mk_data_in_code_t *data_in_code)
+{
+    if (data_in_code == NULL) return MK_EINVAL;
+    if (segment.segment == NULL) return MK_EINVAL;
+    if (load_command.load_command == NULL) return MK_EINVAL;
+    
+    if (mk_load_command_id(load_command) != mk_load_command_data_in_code_id()) {
+        _mkl_debug(mk_type_get_context(segment.type), "Unsupported load command type [%s].", mk_type_name(load_command.type));
+        return MK_EINVAL;
+    }
+    
+    if (!mk_type_equal(mk_load_command_get_macho(load_command).type, mk_segment_get_macho(segment).type)) {
+        return MK_EINVAL;
+    }
+    
+    uint32_t lc_dataoff = mk_load_command_data_in_code_get_dataoff(load_command);
+    uint32_t lc_datasize = mk_load_command_data_in_code_get_datasize(load_command);
+    
+    mk_vm_address_t vm_address = mk_segment_get_target_range(segment).location;
+    // Any trailing partial entry is ignored.
+    uint32_t entry_count = lc_datasize / sizeof(struct data_in_code_entry);
+    mk_vm_size_t vm_size = (mk_vm_size_t)entry_count * sizeof(struct data_in_code_entry);
+    
+    mk_error_t err;
+    
+    // Apply the offset.
+    if ((err = mk_vm_address_add(vm_address, lc_dataoff, &vm_address))) {
+        _mkl_debug(mk_type_get_context(segment.type), "Arithmetic error [%s] applying data in code offset [%" PRIu32 "] to LINKEDIT segment target address [0x%" MK_VM_PRIxADDR "].", mk_error_string(err), lc_dataoff, vm_address);
+        return err;
+    }
+    
+    if ((err = mk_vm_address_subtract(vm_address, mk_segment_get_fileoff(segment), &vm_address))) {
+        _mkl_debug(mk_type_get_context(segment.type), "Arithmetic error [%s] subtracting LINKEDIT segment file offset [0x%" MK_VM_PRIxADDR "] from data in code target address [0x%" MK_VM_PRIxADDR "].", mk_error_string(err), mk_segment_get_fileoff(segment), vm_address);
+        return err;
+    }
+    
+    data_in_code->link_edit = segment;
+    data_in_code->target_range = mk_vm_range_make(vm_address, vm_size);
+    data_in_code->entry_count = entry_count;
+    data_in_code->entries = NULL;
+    data_in_code->sorted = true;
+    
+    // Make sure the entries are completely within the link_edit segment
+    if ((err = mk_vm_range_contains_range(mk_segment_get_target_range(segment), data_in_code->target_range, false))) {
+        char buffer[512] = { 0 };
+        mk_type_copy_description(segment.type, buffer, sizeof(buffer));
+        _mkl_debug(mk_type_get_context(segment.type), "Part of data in code entries (target_address = 0x%" MK_VM_PRIxADDR ", size = 0x%" MK_VM_PRIxSIZE ") is not within LINKEDIT segment %s.", data_in_code->target_range.location, data_in_code->target_range.length, buffer);
+        return err;
+    }
+    
+    if (entry_count > 0) {
+        uintptr_t entries = mk_memory_object_remap_address(mk_segment_get_mapping(segment), 0, vm_address, vm_size, NULL);
+        if (entries == UINTPTR_MAX) {
+            _mkl_debug(mk_type_get_context(segment.type), "Failed to map data in code entries (target_address = 0x%" MK_VM_PRIxADDR ", size = 0x%" MK_VM_PRIxSIZE ").", vm_address, vm_size);
+            return MK_EUNAVAILABLE;
+        }
+        data_in_code->entries = (const struct data_in_code_entry*)entries;
+    }
+    
+    // The static linker emits the entries sorted by offset.  Verify this in a
+    // single pass so that lookups can binary search; fall back to a linear
+    // scan for images where it does not hold.
+    const mk_byteorder_t *byte_order = mk_macho_get_byte_order(mk_segment_get_macho(segment));
+    uint64_t previous_end = 0;
+    for (uint32_t i = 0; i < entry_count; i++) {
+        uint32_t offset = byte_order->swap32(data_in_code->entries[i].offset);
+        uint16_t length = byte_order->swap16(data_in_code->entries[i].length);
+        if (offset < previous_end) {
+            _mkl_debug(mk_type_get_context(segment.type), "Data in code entry %" PRIu32 " (offset = 0x%" PRIx32 ") is out of order.", i, offset);
+            data_in_code->sorted = false;
+            break;
+        }
+        previous_end = (uint64_t)offset + length;
+    }
+    
+    data_in_code->vtable = &_mk_data_in_code_class;
+    return MK_ESUCCESS;
+}
+
+//|++++++++++++++++++++++++++++++++++++|//
+mk_error_t
+mk_data_in_code_init_with_mach_load_command(mk_segment_ref segment, struct linkedit_data_command *lc, mk_data_in_code_t *data_in_code)
+{
+    if (segment.segment == NULL) return MK_EINVAL;
+    if (lc == NULL) return MK_EINVAL;
+    
+    mk_error_t err;
+    mk_load_command_t load_command;
+    
+    if ((err = mk_load_command_init(mk_segment_get_macho(segment), (struct load_command*)lc, &load_command)))
+        return err;
+    
+    return mk_data_in_code_init(segment, &load_command, data_in_code);
+}
+
+//|++++++++++++++++++++++++++++++++++++|//
+mk_error_t
+mk_data_in_code_init_with_segment(mk_segment_ref segment, mk_data_in_code_t *data_in_code)
+{
+    if (segment.segment == NULL) return MK_EINVAL;
+    
+    mk_macho_ref image = mk_segment_get_macho(segment);
+    struct load_command *lc = mk_macho_last_command_type(image, LC_DATA_IN_CODE, NULL);
+    
+    if (lc == NULL) {
+        char buffer[512] = { 0 };
+        mk_type_copy_description(image.type, buffer, sizeof(buffer));
+        _mkl_debug(mk_type_get_context(segment.type), "LC_DATA_IN_CODE load command not found in Mach-O image %s.", buffer);
+        return MK_ENOT_FOUND;
+    }
+    
+    return mk_data_in_code_init_with_mach_load_command(segment, (struct linkedit_data_command*)lc, data_in_code);
+}
+
+//|++++++++++++++++++++++++++++++++++++|//
+void
+mk_data_in_code_free(mk_data_in_code_ref data_in_code)
+{
+    data_in_code.data_in_code->entries = NULL;
+    data_in_code.data_in_code->vtable = NULL;
+}
+
+//|++++++++++++++++++++++++++++++++++++|//
+mk_macho_ref mk_data_in_code_get_macho(mk_data_in_code_ref data_in_code)
+{ return mk_segment_get_macho(data_in_code.data_in_code->link_edit); }
+
+//|++++++++++++++++++++++++++++++++++++|//
+mk_segment_ref mk_data_in_code_get_segment(mk_data_in_code_ref data_in_code)
+{ return data_in_code.data_in_code->link_edit; }
+
+//|++++++++++++++++++++++++++++++++++++|//
+mk_vm_range_t mk_data_in_code_get_target_range(mk_data_in_code_ref data_in_code)
+{ return data_in_code.data_in_code->target_range; }
+
+//----------------------------------------------------------------------------//
+#pragma mark -  Looking Up Entries
+//----------------------------------------------------------------------------//
+
+//|++++++++++++++++++++++++++++++++++++|//
+uint32_t mk_data_in_code_get_entry_count(mk_data_in_code_ref data_in_code)
+{ return data_in_code.data_in_code->entry_count; }
+
+//|++++++++++++++++++++++++++++++++++++|//
+mk_error_t
+mk_data_in_code_copy_entry_at_index(mk_data_in_code_ref data_in_code, uint32_t index, struct data_in_code_entry *result)
+{
+    if (result == NULL) return MK_EINVAL;
+    if (index >= data_in_code.data_in_code->entry_count) return MK_EOUT_OF_RANGE;
+    
+    const mk_byteorder_t *byte_order = mk_macho_get_byte_order(mk_data_in_code_get_macho(data_in_code));
+    const struct data_in_code_entry *entry = &data_in_code.data_in_code->entries[index];
+    
+    result->offset = byte_order->swap32(entry->offset);
+    result->length = byte_order->swap16(entry->length);
+    result->kind = byte_order->swap16(entry->kind);
+    return MK_ESUCCESS;
+}
+
+//|++++++++++++++++++++++++++++++++++++|//
+//! Returns the index of the entry containing \a offset, searching the
+//! half-open index range [\a low, \a high).  Returns \c UINT32_MAX if no entry
+//! contains \a offset.  \a *next receives the index of the first entry whose
+//! offset is greater than \a offset, for use as the lower bound of a
+//! subsequent ascending search.
+static uint32_t
+__mk_data_in_code_search(const mk_data_in_code_t *self, const mk_byteorder_t *byte_order, uint32_t offset, uint32_t low, uint32_t high, uint32_t *next)
+{
+    const struct data_in_code_entry *entries = self->entries;
+    
+    if (!self->sorted) {
+        for (uint32_t i = 0; i < self->entry_count; i++) {
+            uint32_t start = byte_order->swap32(entries[i].offset);
+            if (offset >= start && (uint64_t)offset < (uint64_t)start + byte_order->swap16(entries[i].length))
+                return i;
+        }
+        return UINT32_MAX;
+    }
+    
+    // Find the first entry that starts after offset.
+    while (low < high) {
+        uint32_t mid = low + (high - low) / 2;
+        if (byte_order->swap32(entries[mid].offset) <= offset)
+            low = mid + 1;
+        else
+            high = mid;
+    }
+    
+    if (next) *next = low;
+    if (low == 0)
+        return UINT32_MAX;
+    
+    // The candidate is the last entry starting at or before offset.
+    uint32_t start = byte_order->swap32(entries[low - 1].offset);
+    if ((uint64_t)offset < (uint64_t)start + byte_order->swap16(entries[low - 1].length))
+        return low - 1;
+    
+    return UINT32_MAX;
+}
+
+//|++++++++++++++++++++++++++++++++++++|//
+mk_error_t
+mk_data_in_code_find_entry_containing_offset(mk_data_in_code_ref data_in_code, uint32_t offset, uint32_t *index, struct data_in_code_entry *result)
+{
+    const mk_data_in_code_t *self = data_in_code.data_in_code;
+    const mk_byteorder_t *byte_order = mk_macho_get_byte_order(mk_data_in_code_get_macho(data_in_code));
+    
+    uint32_t found = __mk_data_in_code_search(self, byte_order, offset, 0, self->entry_count, NULL);
+    if (found == UINT32_MAX)
+        return MK_ENOT_FOUND;
+    
+    if (index) *index = found;
+    if (result) return mk_data_in_code_copy_entry_at_index(data_in_code, found, result);
+    return MK_ESUCCESS;
+}
+
+//|++++++++++++++++++++++++++++++++++++|//
+void
+mk_data_in_code_classify_offsets(mk_data_in_code_ref data_in_code, const uint32_t *offsets, size_t count, uint16_t *kinds)
+{
+    if (offsets == NULL || kinds == NULL) return;
+    
+    const mk_data_in_code_t *self = data_in_code.data_in_code;
+    const mk_byteorder_t *byte_order = mk_macho_get_byte_order(mk_data_in_code_get_macho(data_in_code));
+    
+    uint32_t low = 0;
+    uint32_t previous = 0;
+    
+    for (size_t i = 0; i < count; i++) {
+        uint32_t offset = offsets[i];
+        // Narrow the search when the offsets are ascending, which is the
+        // common case for a disassembler walking a section.
+        if (offset < previous) low = 0;
+        previous = offset;
+        
+        uint32_t found = __mk_data_in_code_search(self, byte_order, offset, low, self->entry_count, &low);
+        // The entry containing offset may start before the lower bound.
+        if (low > 0) low--;
+        
+        kinds[i] = (found == UINT32_MAX) ? 0 : byte_order->swap16(self->entries[found].kind);
+    }
+}
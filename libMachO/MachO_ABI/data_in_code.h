@@ -0,0 +1,157 @@
+//----------------------------------------------------------------------------//
+//|
+//|             MachOKit - A Lightweight Mach-O Parsing Library
+//! @file       data_in_code.h
+//!
+//! @author     D.V.
+//! @copyright  Copyright (c) 2014-2015 D.V. All rights reserved.
+//|
+//| Permission is hereby granted, free of charge, to any person obtaining a
+//| copy of this software and associated documentation files (the "Software"),
+//| to deal in the Software without restriction, including without limitation
+//| the rights to use, copy, modify, merge, publish, distribute, sublicense,
+//| and/or sell copies of the Software, and to permit persons to whom the
+//| Software is furnished to do so, subject to the following conditions:
+//|
+//| The above copyright notice and this permission notice shall be included
+//| in all copies or substantial portions of the Software.
+//|
+//| THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+//| OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+//| MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+//| IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+//| CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+//| TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+//| SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+//----------------------------------------------------------------------------//
+
+
+#ifndef _data_in_code_h
+#define _data_in_code_h
+
+//! @addtogroup MACH
+//! @{
+//!
+
+//----------------------------------------------------------------------------//
+#pragma mark -  Types
+//! @name       Types
+//----------------------------------------------------------------------------//
+
+//◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦//
+//! @internal
+//
+typedef struct mk_data_in_code_s {
+    __MK_RUNTIME_BASE
+    //! Link edit segment
+    mk_segment_ref link_edit;
+    //! The range of the data in code entries in the target.
+    mk_vm_range_t target_range;
+    //! The data in code entries, in the current process.
+    const struct data_in_code_entry *entries;
+    uint32_t entry_count;
+    //! Whether the entries are sorted by offset and do not overlap.  The
+    //! static linker always emits them this way.
+    bool sorted;
+} mk_data_in_code_t;
+
+
+//◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦//
+//! The Data In Code type.
+//
+typedef union {
+    mk_type_ref type;
+    struct mk_data_in_code_s *data_in_code;
+} mk_data_in_code_ref _mk_transparent_union;
+
+//! The identifier for the Data In Code type.
+_mk_export intptr_t mk_data_in_code_type;
+
+
+//----------------------------------------------------------------------------//
+#pragma mark -  Working With Data In Code Entries
+//! @name       Working With Data In Code Entries
+//----------------------------------------------------------------------------//
+
+//! Initializes a Data In Code object.
+//!
+//! @param  segment
+//!         The LINKEDIT segment.  Must remain valid for the lifetime of the
+//!         data in code object.
+//! @param  load_command
+//!         The LC_DATA_IN_CODE load command that defines the entries.
+//! @param  data_in_code
+//!         A valid \ref mk_data_in_code_t structure.
+_mk_export mk_error_t
+mk_data_in_code_init(mk_segment_ref segment, mk_load_command_ref load_command, mk_data_in_code_t *data_in_code);
+
+//! Initializes a Data In Code object with the specified Mach-O
+//! LC_DATA_IN_CODE load command.
+_mk_export mk_error_t
+mk_data_in_code_init_with_mach_load_command(mk_segment_ref segment, struct linkedit_data_command *lc, mk_data_in_code_t *data_in_code);
+
+//! Initializes a Data In Code object.
+_mk_export mk_error_t
+mk_data_in_code_init_with_segment(mk_segment_ref segment, mk_data_in_code_t *data_in_code);
+
+//! Cleans up any resources held by \a data_in_code.  It is no longer safe to
+//! use \a data_in_code after calling this function.
+_mk_export void
+mk_data_in_code_free(mk_data_in_code_ref data_in_code);
+
+//! Returns the Mach-O image that the specified data in code entries reside
+//! within.
+_mk_export mk_macho_ref
+mk_data_in_code_get_macho(mk_data_in_code_ref data_in_code);
+
+//! Returns the LINKEDIT segment that the specified data in code entries
+//! reside within.
+_mk_export mk_segment_ref
+mk_data_in_code_get_segment(mk_data_in_code_ref data_in_code);
+
+//! Returns range of memory (in the target address space) that the specified
+//! data in code entries occupy.
+_mk_export mk_vm_range_t
+mk_data_in_code_get_target_range(mk_data_in_code_ref data_in_code);
+
+
+//----------------------------------------------------------------------------//
+#pragma mark -  Looking Up Entries
+//! @name       Looking Up Entries
+//!
+//! Offsets are relative to the start of the Mach-O header, matching the
+//! \c offset field of \c struct \c data_in_code_entry.
+//----------------------------------------------------------------------------//
+
+//! Returns the number of entries.
+_mk_export uint32_t
+mk_data_in_code_get_entry_count(mk_data_in_code_ref data_in_code);
+
+//! Copies the entry at \a index, in host byte order, into \a result.
+_mk_export mk_error_t
+mk_data_in_code_copy_entry_at_index(mk_data_in_code_ref data_in_code, uint32_t index, struct data_in_code_entry *result);
+
+//! Finds the entry whose range contains \a offset.  Runs in O(log n) when
+//! the entries are sorted, which the static linker guarantees.
+//!
+//! @param  index
+//!         On success, receives the index of the entry.  May be \c NULL.
+//! @param  result
+//!         On success, receives the entry in host byte order.  May be
+//!         \c NULL.
+//! @return
+//! \ref MK_ENOT_FOUND if \a offset is not within any entry.
+_mk_export mk_error_t
+mk_data_in_code_find_entry_containing_offset(mk_data_in_code_ref data_in_code, uint32_t offset, uint32_t *index, struct data_in_code_entry *result);
+
+//! Classifies each of \a count \a offsets, storing the \c DICE_KIND_* of the
+//! containing entry into the corresponding element of \a kinds, or \c 0 if
+//! the offset is not within any entry.  Ascending runs of \a offsets are
+//! resolved by narrowing the search from the previous match.
+_mk_export void
+mk_data_in_code_classify_offsets(mk_data_in_code_ref data_in_code, const uint32_t *offsets, size_t count, uint16_t *kinds);
+
+
+//! @} MACH !//
+
+#endif /* _data_in_code_h */
@@ -191,9 +191,21 @@ mk_exports_trie_get_terminal_node_for_symbol(mk_exports_trie_ref exports_trie, c
     mk_vm_range_t target_range = exports_trie.exports_trie->target_range;
     mk_vm_offset_t current_offset = 0;
     
+    // A malformed trie may contain a cycle of edges with empty labels.
+    mk_context_t *context = mk_type_get_context(exports_trie.type);
+    mk_budget_meter_t meter;
+    mk_budget_meter_init(&meter, context ? context->budget : NULL);
+    
     while (current_offset < mk_vm_range_length(target_range)) {
         mk_error_t err;
         
+        _mk_statistics_add(context, trie_steps, 1);
+        
+        if ((err = mk_budget_meter_charge(&meter, 0, 0, 1))) {
+            _mkl_debug(context, "Exceeded the trie visit budget while looking up symbol in exports trie.  Stopping at offset [0x%" MK_VM_PRIxOFFSET "].", current_offset);
+            return err;
+        }
+        
         mk_vm_address_t target_addr = mk_vm_range_start(target_range);
         mk_vm_size_t target_size = mk_vm_range_length(target_range);
         
@@ -42,9 +42,13 @@
 
 #include "load_command.h"
 #include "segment.h"
+#include "section_index.h"
 #include "string_table.h"
 #include "exports_trie.h"
 #include "symbol_table.h"
+#include "symbol_address_index.h"
+#include "symbol_name_index.h"
 #include "indirect_symbol_table.h"
+#include "data_in_code.h"
 
 #endif /* _macho_abi_h */
@@ -38,11 +38,15 @@
 #include "load_command_internal.h"
 #include "segment_internal.h"
 #include "section_internal.h"
+#include "section_index_internal.h"
 #include "export_internal.h"
 #include "symbol_internal.h"
 #include "string_table_internal.h"
 #include "exports_trie_internal.h"
 #include "symbol_table_internal.h"
+#include "symbol_address_index_internal.h"
+#include "symbol_name_index_internal.h"
 #include "indirect_symbol_table_internal.h"
+#include "data_in_code_internal.h"
 
 #endif /* _macho_abi_internal_h */
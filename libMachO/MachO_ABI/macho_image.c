@@ -332,8 +332,16 @@ mk_macho_next_command(mk_macho_ref image, struct load_command* previous, mk_vm_a
             return NULL;
         }
         
+        // A load command that is smaller than its header would never advance
+        // the iteration.
+        uint32_t cmdsize = mk_macho_get_byte_order(image)->swap32(lc->cmdsize);
+        if (cmdsize < sizeof(struct load_command)) {
+            _mkl_debug(mk_type_get_context(image.type), "Load command at [%p] has a cmdsize [%" PRIu32 "] that is less than sizeof(struct load_command).", lc, cmdsize);
+            return NULL;
+        }
+        
         // Advance to the next command
-        lc = (typeof(lc))( (uintptr_t)previous + mk_macho_get_byte_order(image)->swap32(lc->cmdsize) );
+        lc = (typeof(lc))( (uintptr_t)previous + cmdsize );
     }
     
     // Avoid walking off the end of the load commands
@@ -364,6 +372,7 @@ mk_macho_next_command(mk_macho_ref image, struct load_command* previous, mk_vm_a
             return NULL;
     }
     
+    _mk_statistics_add(mk_type_get_context(image.type), load_commands_visited, 1);
     return lc;
 }
 
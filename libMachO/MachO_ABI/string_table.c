@@ -172,6 +172,8 @@ mk_string_table_get_string_at_offset(mk_string_table_ref string_table, uint32_t
     mk_vm_address_t addr;
     mk_vm_size_t len;
     
+    _mk_statistics_add(mk_type_get_context(string_table.type), string_table_lookups, 1);
+    
     if (mk_vm_address_apply_offset(string_table.string_table->target_range.location, offset, &addr) != MK_ESUCCESS)
         return NULL;
     
@@ -199,6 +201,8 @@ mk_string_table_copy_string_at_offset(mk_string_table_ref string_table, uint32_t
     mk_vm_address_t addr;
     mk_vm_size_t len;
     
+    _mk_statistics_add(mk_type_get_context(string_table.type), string_table_lookups, 1);
+    
     if (mk_vm_address_apply_offset(string_table.string_table->target_range.location, offset, &addr) != MK_ESUCCESS)
         return 0;
     
@@ -0,0 +1,317 @@
+//----------------------------------------------------------------------------//
+//|
+//|             MachOKit - A Lightweight Mach-O Parsing Library
+//|             symbol_address_index.c
+//|
+//|             D.V.
+//|             Copyright (c) 2014-2015 D.V. All rights reserved.
+//|
+//| Permission is hereby granted, free of charge, to any person obtaining a
+//| copy of this software and associated documentation files (the "Software"),
+//| to deal in the Software without restriction, including without limitation
+//| the rights to use, copy, modify, merge, publish, distribute, sublicense,
+//| and/or sell copies of the Software, and to permit persons to whom the
+//| Software is furnished to do so, subject to the following conditions:
+//|
+//| The above copyright notice and this permission notice shall be included
+//| in all copies or substantial portions of the Software.
+//|
+//| THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+//| OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+//| MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+//| IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+//| CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+//| TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+//| SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+//----------------------------------------------------------------------------//
+
+#include "macho_abi_internal.h"
+
+//----------------------------------------------------------------------------//
+#pragma mark -  Classes
+//----------------------------------------------------------------------------//
+
+//|++++++++++++++++++++++++++++++++++++|//
+static mk_context_t*
+__mk_symbol_address_index_get_context(mk_symbol_address_index_ref self)
+{ return mk_type_get_context( self.symbol_address_index->symbol_table.type ); }
+
+const struct _mk_symbol_address_index_vtable _mk_symbol_address_index_class = {
+    .base.super                 = &_mk_type_class,
+    .base.name                  = "symbol address index",
+    .base.get_context           = &__mk_symbol_address_index_get_context
+};
+
+intptr_t mk_symbol_address_index_type = (intptr_t)&_mk_symbol_address_index_class;
+
+//----------------------------------------------------------------------------//
+#pragma mark -  Helpers
+//----------------------------------------------------------------------------//
+
+//|++++++++++++++++++++++++++++++++++++|//
+// Populates ranges with the [first, first + count) symbol ranges to index,
+// and returns the number of ranges.
+static uint32_t
+_mk_symbol_address_index_get_ranges(mk_symbol_table_ref symbol_table, uint32_t ranges[2][2])
+{
+    uint32_t nsyms = mk_symbol_table_get_symbol_count(symbol_table);
+    if (nsyms == UINT32_MAX)
+        return 0;
+    
+    mk_load_command_ref dysymtab = mk_symbol_table_get_dysymtab_load_command(symbol_table);
+    if (dysymtab.load_command->vtable == NULL) {
+        ranges[0][0] = 0;
+        ranges[0][1] = nsyms;
+        return 1;
+    }
+    
+    uint32_t first[2] = { mk_load_command_dysymtab_get_ilocalsym(dysymtab), mk_load_command_dysymtab_get_iextdefsym(dysymtab) };
+    uint32_t count[2] = { mk_load_command_dysymtab_get_nlocalsym(dysymtab), mk_load_command_dysymtab_get_nextdefsym(dysymtab) };
+    
+    // Clamp the ranges to the symbol table.
+    for (int i = 0; i < 2; i++) {
+        ranges[i][0] = MIN(first[i], nsyms);
+        ranges[i][1] = MIN(count[i], nsyms - ranges[i][0]);
+    }
+    return 2;
+}
+
+//|++++++++++++++++++++++++++++++++++++|//
+static inline bool
+_mk_symbol_address_index_entry_less(const mk_symbol_address_index_entry_t *a, const mk_symbol_address_index_entry_t *b)
+{
+    if (a->target_address != b->target_address)
+        return a->target_address < b->target_address;
+    return a->symbol_index < b->symbol_index;
+}
+
+//|++++++++++++++++++++++++++++++++++++|//
+static void
+_mk_symbol_address_index_sift_down(mk_symbol_address_index_entry_t *entries, uint32_t root, uint32_t count)
+{
+    for (;;) {
+        uint32_t child = 2 * root + 1;
+        if (child >= count)
+            break;
+        if (child + 1 < count && _mk_symbol_address_index_entry_less(&entries[child], &entries[child + 1]))
+            child++;
+        if (!_mk_symbol_address_index_entry_less(&entries[root], &entries[child]))
+            break;
+        
+        mk_symbol_address_index_entry_t tmp = entries[root];
+        entries[root] = entries[child];
+        entries[child] = tmp;
+        root = child;
+    }
+}
+
+//|++++++++++++++++++++++++++++++++++++|//
+// Heap sort.  Unlike qsort(3), it never allocates memory.
+static void
+_mk_symbol_address_index_sort(mk_symbol_address_index_entry_t *entries, uint32_t count)
+{
+    // The locals and external definitions are each usually sorted already,
+    // in which case there is nothing to do.
+    bool sorted = true;
+    for (uint32_t i = 1; i < count && sorted; i++)
+        sorted = _mk_symbol_address_index_entry_less(&entries[i - 1], &entries[i]);
+    if (sorted)
+        return;
+    
+    for (uint32_t i = count / 2; i > 0; i--)
+        _mk_symbol_address_index_sift_down(entries, i - 1, count);
+    
+    for (uint32_t end = count - 1; end > 0; end--) {
+        mk_symbol_address_index_entry_t tmp = entries[0];
+        entries[0] = entries[end];
+        entries[end] = tmp;
+        _mk_symbol_address_index_sift_down(entries, 0, end);
+    }
+}
+
+//----------------------------------------------------------------------------//
+#pragma mark -  Working With Symbol Address Indexes
+//----------------------------------------------------------------------------//
+
+//|++++++++++++++++++++++++++++++++++++|//
+size_t
+mk_symbol_address_index_get_required_size(mk_symbol_table_ref symbol_table)
+{
+    if (symbol_table.symbol_table == NULL) return 0;
+    
+    uint32_t ranges[2][2];
+    uint32_t range_count = _mk_symbol_address_index_get_ranges(symbol_table, ranges);
+    
+    size_t count = 0;
+    for (uint32_t i = 0; i < range_count; i++)
+        count += ranges[i][1];
+    
+    return count * sizeof(mk_symbol_address_index_entry_t);
+}
+
+//|++++++++++++++++++++++++++++++++++++|//
+mk_error_t
+mk_symbol_address_index_init(mk_symbol_table_ref symbol_table, void *buffer, size_t buffer_size, mk_symbol_address_index_t *symbol_address_index)
+{
+    if (symbol_address_index == NULL) return MK_EINVAL;
+    if (symbol_table.symbol_table == NULL) return MK_EINVAL;
+    if (buffer == NULL && buffer_size != 0) return MK_EINVAL;
+    
+    mk_context_t *ctx = mk_type_get_context(symbol_table.type);
+    mk_macho_ref image = mk_symbol_table_get_macho(symbol_table);
+    const mk_byteorder_t *byte_order = mk_macho_get_byte_order(image);
+    mk_memory_object_ref mapping = mk_segment_get_mapping(mk_symbol_table_get_segment(symbol_table));
+    mk_vm_slide_t slide = mk_macho_get_slide(image);
+    bool is64 = mk_macho_is_64_bit(image);
+    size_t nlist_size = is64 ? sizeof(struct nlist_64) : sizeof(struct nlist);
+    
+    uint32_t ranges[2][2];
+    uint32_t range_count = _mk_symbol_address_index_get_ranges(symbol_table, ranges);
+    
+    size_t required_size = mk_symbol_address_index_get_required_size(symbol_table);
+    if (buffer_size < required_size) {
+        _mkl_debug(ctx, "Buffer of size [%zu] is smaller than the [%zu] bytes needed to index the symbol table.", buffer_size, required_size);
+        return MK_ESIZE;
+    }
+    
+    mk_symbol_address_index_entry_t *entries = buffer;
+    uint32_t count = 0;
+    
+    for (uint32_t r = 0; r < range_count; r++)
+    {
+        uint32_t first = ranges[r][0];
+        uint32_t length = ranges[r][1];
+        if (length == 0)
+            continue;
+        
+        mk_error_t err;
+        mk_vm_address_t target_address;
+        if ((err = mk_vm_address_apply_offset(mk_symbol_table_get_target_range(symbol_table).location, (mk_vm_offset_t)first * nlist_size, &target_address)))
+            return err;
+        
+        // Map the whole range once rather than each symbol.
+        uintptr_t nlists = mk_memory_object_remap_address(mapping, 0, target_address, (mk_vm_size_t)length * nlist_size, &err);
+        if (nlists == UINTPTR_MAX) {
+            _mkl_debug(ctx, "Failed to map symbols [%" PRIu32 ", %" PRIu32 ") of the symbol table.  Error [%s].", first, first + length, mk_error_string(err));
+            return err;
+        }
+        
+        for (uint32_t i = 0; i < length; i++)
+        {
+            uint8_t n_type;
+            uint32_t n_strx;
+            mk_vm_address_t n_value;
+            
+            if (is64) {
+                const struct nlist_64 *nlist = (const struct nlist_64*)(nlists + i * nlist_size);
+                n_type = nlist->n_type;
+                n_strx = byte_order->swap32(nlist->n_un.n_strx);
+                n_value = byte_order->swap64(nlist->n_value);
+            } else {
+                const struct nlist *nlist = (const struct nlist*)(nlists + i * nlist_size);
+                n_type = nlist->n_type;
+                n_strx = byte_order->swap32(nlist->n_un.n_strx);
+                n_value = byte_order->swap32(nlist->n_value);
+            }
+            
+            // Only symbols defined in a section have an address.
+            if ((n_type & N_STAB) || (n_type & N_TYPE) != N_SECT)
+                continue;
+            
+            if (mk_vm_address_apply_slide(n_value, slide, &n_value))
+                continue;
+            
+            entries[count++] = (mk_symbol_address_index_entry_t){
+                .target_address = n_value,
+                .symbol_index = first + i,
+                .strx = n_strx,
+                .type = n_type
+            };
+        }
+    }
+    
+    _mk_symbol_address_index_sort(entries, count);
+    
+    // Collapse runs of symbols sharing an address, keeping the first
+    // external symbol of the run, or its first symbol if none are external.
+    uint32_t unique = 0;
+    for (uint32_t i = 0; i < count;)
+    {
+        uint32_t end = i + 1;
+        while (end < count && entries[end].target_address == entries[i].target_address)
+            end++;
+        
+        uint32_t keep = i;
+        for (uint32_t j = i; end - i > 1 && j < end; j++) {
+            if (entries[j].type & N_EXT) {
+                keep = j;
+                break;
+            }
+        }
+        
+        entries[unique++] = entries[keep];
+        i = end;
+    }
+    
+    symbol_address_index->vtable = &_mk_symbol_address_index_class;
+    symbol_address_index->symbol_table = symbol_table;
+    symbol_address_index->entries = entries;
+    symbol_address_index->count = unique;
+    
+    return MK_ESUCCESS;
+}
+
+//|++++++++++++++++++++++++++++++++++++|//
+void
+mk_symbol_address_index_free(mk_symbol_address_index_ref symbol_address_index)
+{
+    symbol_address_index.symbol_address_index->entries = NULL;
+    symbol_address_index.symbol_address_index->count = 0;
+    symbol_address_index.symbol_address_index->vtable = NULL;
+}
+
+//|++++++++++++++++++++++++++++++++++++|//
+mk_symbol_table_ref
+mk_symbol_address_index_get_symbol_table(mk_symbol_address_index_ref symbol_address_index)
+{ return symbol_address_index.symbol_address_index->symbol_table; }
+
+//|++++++++++++++++++++++++++++++++++++|//
+uint32_t
+mk_symbol_address_index_get_count(mk_symbol_address_index_ref symbol_address_index)
+{ return symbol_address_index.symbol_address_index->count; }
+
+//----------------------------------------------------------------------------//
+#pragma mark -  Looking Up Symbols
+//----------------------------------------------------------------------------//
+
+//|++++++++++++++++++++++++++++++++++++|//
+const mk_symbol_address_index_entry_t*
+mk_symbol_address_index_get_entry(mk_symbol_address_index_ref symbol_address_index, uint32_t position)
+{
+    if (position >= symbol_address_index.symbol_address_index->count)
+        return NULL;
+    return &symbol_address_index.symbol_address_index->entries[position];
+}
+
+//|++++++++++++++++++++++++++++++++++++|//
+const mk_symbol_address_index_entry_t*
+mk_symbol_address_index_find_entry(mk_symbol_address_index_ref symbol_address_index, mk_vm_address_t target_address, mk_vm_address_t *next_target_address)
+{
+    const mk_symbol_address_index_entry_t *entries = symbol_address_index.symbol_address_index->entries;
+    uint32_t count = symbol_address_index.symbol_address_index->count;
+    
+    // Find the first entry above target_address.
+    uint32_t lo = 0, hi = count;
+    while (lo < hi) {
+        uint32_t mid = lo + (hi - lo) / 2;
+        if (entries[mid].target_address <= target_address)
+            lo = mid + 1;
+        else
+            hi = mid;
+    }
+    
+    if (next_target_address)
+        *next_target_address = (lo < count) ? entries[lo].target_address : MK_VM_ADDRESS_INVALID;
+    
+    return (lo > 0) ? &entries[lo - 1] : NULL;
+}
@@ -0,0 +1,161 @@
+//----------------------------------------------------------------------------//
+//|
+//|             MachOKit - A Lightweight Mach-O Parsing Library
+//! @file       symbol_address_index.h
+//!
+//! @author     D.V.
+//! @copyright  Copyright (c) 2014-2015 D.V. All rights reserved.
+//|
+//| Permission is hereby granted, free of charge, to any person obtaining a
+//| copy of this software and associated documentation files (the "Software"),
+//| to deal in the Software without restriction, including without limitation
+//| the rights to use, copy, modify, merge, publish, distribute, sublicense,
+//| and/or sell copies of the Software, and to permit persons to whom the
+//| Software is furnished to do so, subject to the following conditions:
+//|
+//| The above copyright notice and this permission notice shall be included
+//| in all copies or substantial portions of the Software.
+//|
+//| THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+//| OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+//| MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+//| IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+//| CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+//| TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+//| SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+//----------------------------------------------------------------------------//
+
+#ifndef _symbol_address_index_h
+#define _symbol_address_index_h
+
+//! @addtogroup MACH
+//! @{
+//!
+
+//----------------------------------------------------------------------------//
+#pragma mark -  Types
+//! @name       Types
+//----------------------------------------------------------------------------//
+
+//◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦//
+//! A defined symbol, as recorded in a Symbol Address Index.
+//
+typedef struct mk_symbol_address_index_entry_s {
+    //! The address of the symbol (in the target address space).
+    mk_vm_address_t target_address;
+    //! The index of the symbol in the symbol table.
+    uint32_t symbol_index;
+    //! The offset of the symbol's name in the string table.
+    uint32_t strx;
+    //! The type (\c n_type) of the symbol.
+    uint8_t type;
+} mk_symbol_address_index_entry_t;
+
+//◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦//
+//! @internal
+//
+typedef struct mk_symbol_address_index_s {
+    __MK_RUNTIME_BASE
+    // The symbol table that was indexed.
+    mk_symbol_table_ref symbol_table;
+    // Entries sorted by target address, in caller provided memory.
+    mk_symbol_address_index_entry_t *entries;
+    uint32_t count;
+} mk_symbol_address_index_t;
+
+//◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦//
+//! The Symbol Address Index polymorphic type.
+//
+typedef union {
+    mk_type_ref type;
+    struct mk_symbol_address_index_s *symbol_address_index;
+} mk_symbol_address_index_ref _mk_transparent_union;
+
+//! The identifier for the Symbol Address Index type.
+_mk_export intptr_t mk_symbol_address_index_type;
+
+
+//----------------------------------------------------------------------------//
+#pragma mark -  Working With Symbol Address Indexes
+//! @name       Working With Symbol Address Indexes
+//----------------------------------------------------------------------------//
+
+//! Returns the size of the buffer needed to index \a symbol_table.  This is
+//! an upper bound; symbols that are not indexed still count towards it.
+//!
+//! If the symbol table has an associated LC_DYSYMTAB, only the local and
+//! external defined symbol ranges are considered.  Otherwise every symbol
+//! is considered.
+_mk_export size_t
+mk_symbol_address_index_get_required_size(mk_symbol_table_ref symbol_table);
+
+//! Initializes a Symbol Address Index object, sorting the defined symbols of
+//! \a symbol_table by address into \a buffer.  Debugging symbols and symbols
+//! not defined in a section are omitted.  If several symbols share an
+//! address, only one is kept, preferring external symbols.
+//!
+//! This function does not call malloc(3), but it remaps each indexed range
+//! of the symbol table through the memory map of \a symbol_table, which may
+//! allocate or map memory.  It is intended to run ahead of time, for example
+//! when an image is loaded, so that lookups can later be performed from a
+//! signal handler.
+//!
+//! @param  symbol_table
+//!         The symbol table to index.  Must remain valid for the lifetime of
+//!         the symbol address index object.
+//! @param  buffer
+//!         Memory to hold the index entries.  Must be aligned for
+//!         \ref mk_symbol_address_index_entry_t and remain valid for the
+//!         lifetime of the symbol address index object.
+//! @param  buffer_size
+//!         The size of \a buffer, which must be at least the size returned
+//!         by \ref mk_symbol_address_index_get_required_size.
+//! @param  symbol_address_index
+//!         A valid \ref mk_symbol_address_index_t structure.
+//! @return
+//! \ref MK_ESIZE if \a buffer is too small.
+_mk_export mk_error_t
+mk_symbol_address_index_init(mk_symbol_table_ref symbol_table, void *buffer, size_t buffer_size, mk_symbol_address_index_t *symbol_address_index);
+
+//! Cleans up any resources held by \a symbol_address_index.  It is no longer
+//! safe to use \a symbol_address_index after calling this function.  The
+//! buffer provided at initialization is not freed.
+_mk_export void
+mk_symbol_address_index_free(mk_symbol_address_index_ref symbol_address_index);
+
+//! Returns the symbol table that the specified symbol address index was
+//! built from.
+_mk_export mk_symbol_table_ref
+mk_symbol_address_index_get_symbol_table(mk_symbol_address_index_ref symbol_address_index);
+
+//! Returns the number of symbols in the specified symbol address index.
+_mk_export uint32_t
+mk_symbol_address_index_get_count(mk_symbol_address_index_ref symbol_address_index);
+
+
+//----------------------------------------------------------------------------//
+#pragma mark -  Looking Up Symbols
+//! @name       Looking Up Symbols
+//!
+//! These functions are async-signal-safe.  They do not allocate memory, take
+//! locks, log, or access the symbol table.
+//----------------------------------------------------------------------------//
+
+//! Returns the entry at \a position in address order, or \c NULL.
+_mk_export const mk_symbol_address_index_entry_t*
+mk_symbol_address_index_get_entry(mk_symbol_address_index_ref symbol_address_index, uint32_t position);
+
+//! Finds the symbol with the highest address at or below \a target_address,
+//! or returns \c NULL if \a target_address precedes every symbol.
+//!
+//! @param  next_target_address
+//!         If not \c NULL, populated with the address of the following
+//!         symbol, or \ref MK_VM_ADDRESS_INVALID if the returned symbol is the
+//!         last.  Useful for rejecting addresses past the end of a function.
+_mk_export const mk_symbol_address_index_entry_t*
+mk_symbol_address_index_find_entry(mk_symbol_address_index_ref symbol_address_index, mk_vm_address_t target_address, mk_vm_address_t *next_target_address);
+
+
+//! @} MACH !//
+
+#endif /* _symbol_address_index_h */
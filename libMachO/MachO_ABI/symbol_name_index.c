@@ -0,0 +1,261 @@
+//----------------------------------------------------------------------------//
+//|
+//|             MachOKit - A Lightweight Mach-O Parsing Library
+//|             symbol_name_index.c
+//|
+//|             D.V.
+//|             Copyright (c) 2014-2015 D.V. All rights reserved.
+//|
+//| Permission is hereby granted, free of charge, to any person obtaining a
+//| copy of this software and associated documentation files (the "Software"),
+//| to deal in the Software without restriction, including without limitation
+//| the rights to use, copy, modify, merge, publish, distribute, sublicense,
+//| and/or sell copies of the Software, and to permit persons to whom the
+//| Software is furnished to do so, subject to the following conditions:
+//|
+//| The above copyright notice and this permission notice shall be included
+//| in all copies or substantial portions of the Software.
+//|
+//| THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+//| OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+//| MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+//| IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+//| CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+//| TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+//| SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+//----------------------------------------------------------------------------//
+
+
+#include "macho_abi_internal.h"
+
+//----------------------------------------------------------------------------//
+#pragma mark -  Classes
+//----------------------------------------------------------------------------//
+
+//|++++++++++++++++++++++++++++++++++++|//
+static mk_context_t*
+__mk_symbol_name_index_get_context(mk_symbol_name_index_ref self)
+{ return mk_type_get_context( self.symbol_name_index->symbol_table.type ); }
+
+const struct _mk_symbol_name_index_vtable _mk_symbol_name_index_class = {
+    .base.super                 = &_mk_type_class,
+    .base.name                  = "symbol name index",
+    .base.get_context           = &__mk_symbol_name_index_get_context
+};
+
+intptr_t mk_symbol_name_index_type = (intptr_t)&_mk_symbol_name_index_class;
+
+//----------------------------------------------------------------------------//
+#pragma mark -  Helpers
+//----------------------------------------------------------------------------//
+
+#define _MK_SYMBOL_NAME_INDEX_EMPTY         UINT32_MAX
+
+//|++++++++++++++++++++++++++++++++++++|//
+// Populates first and count with the range of symbols to index.
+static void
+_mk_symbol_name_index_get_range(mk_symbol_table_ref symbol_table, uint32_t *first, uint32_t *count)
+{
+    uint32_t nsyms = mk_symbol_table_get_symbol_count(symbol_table);
+    
+    mk_load_command_ref dysymtab = mk_symbol_table_get_dysymtab_load_command(symbol_table);
+    if (dysymtab.load_command->vtable == NULL) {
+        *first = 0;
+        *count = nsyms;
+        return;
+    }
+    
+    // The external defined and undefined symbols are adjacent.
+    uint32_t iextdefsym = mk_load_command_dysymtab_get_iextdefsym(dysymtab);
+    uint32_t iundefsym = mk_load_command_dysymtab_get_iundefsym(dysymtab);
+    uint64_t end = MAX((uint64_t)iextdefsym + mk_load_command_dysymtab_get_nextdefsym(dysymtab),
+                       (uint64_t)iundefsym + mk_load_command_dysymtab_get_nundefsym(dysymtab));
+    
+    *first = MIN(MIN(iextdefsym, iundefsym), nsyms);
+    *count = (uint32_t)(MIN(end, (uint64_t)nsyms) - *first);
+}
+
+//|++++++++++++++++++++++++++++++++++++|//
+static uint32_t
+_mk_symbol_name_index_get_capacity(uint32_t count)
+{
+    // Keep the load factor at or below one half.
+    uint64_t capacity = 1;
+    while (capacity < 2 * (uint64_t)count)
+        capacity <<= 1;
+    return (count == 0 || capacity > UINT32_MAX) ? 0 : (uint32_t)capacity;
+}
+
+//|++++++++++++++++++++++++++++++++++++|//
+// FNV-1a, over at most max_len bytes of string.
+static uint32_t
+_mk_symbol_name_index_hash(const char *string, size_t max_len)
+{
+    uint32_t hash = 2166136261u;
+    for (size_t i = 0; i < max_len && string[i] != '\0'; i++) {
+        hash ^= (uint8_t)string[i];
+        hash *= 16777619u;
+    }
+    return hash;
+}
+
+//|++++++++++++++++++++++++++++++++++++|//
+// Returns the name of the external symbol at index, or NULL if the symbol
+// is not external or can not be read.
+static const char*
+_mk_symbol_name_index_get_name(mk_symbol_table_ref symbol_table, mk_string_table_ref string_table, uint32_t index, size_t *max_len)
+{
+    mk_macho_nlist_ptr symbol = mk_symbol_table_get_mach_symbol_at_index(symbol_table, index, NULL);
+    if (symbol.any == NULL)
+        return NULL;
+    
+    // n_type and n_strx are at the same offsets in both nlist variants.
+    if ((symbol.nlist->n_type & N_STAB) || !(symbol.nlist->n_type & N_EXT))
+        return NULL;
+    
+    uint32_t strx = mk_macho_get_byte_order(mk_symbol_table_get_macho(symbol_table))->swap32(symbol.nlist->n_un.n_strx);
+    
+    const char *name = mk_string_table_get_string_at_offset(string_table, strx, NULL);
+    if (name == NULL)
+        return NULL;
+    
+    *max_len = (size_t)(mk_string_table_get_target_range(string_table).length - strx);
+    return name;
+}
+
+//|++++++++++++++++++++++++++++++++++++|//
+// Returns the slot holding the symbol named name, or the empty slot where it
+// would be inserted.
+static mk_symbol_name_index_entry_t*
+_mk_symbol_name_index_probe(mk_symbol_name_index_t *symbol_name_index, const char *name, size_t name_max_len, uint32_t hash)
+{
+    uint32_t mask = symbol_name_index->capacity - 1;
+    
+    for (uint32_t i = hash & mask;; i = (i + 1) & mask)
+    {
+        mk_symbol_name_index_entry_t *entry = &symbol_name_index->entries[i];
+        if (entry->symbol_index == _MK_SYMBOL_NAME_INDEX_EMPTY)
+            return entry;
+        if (entry->hash != hash)
+            continue;
+        
+        size_t max_len;
+        const char *entry_name = _mk_symbol_name_index_get_name(symbol_name_index->symbol_table, symbol_name_index->string_table, entry->symbol_index, &max_len);
+        if (entry_name && strncmp(entry_name, name, MIN(max_len, name_max_len)) == 0)
+            return entry;
+    }
+}
+
+//----------------------------------------------------------------------------//
+#pragma mark -  Working With Symbol Name Indexes
+//----------------------------------------------------------------------------//
+
+//|++++++++++++++++++++++++++++++++++++|//
+size_t
+mk_symbol_name_index_get_required_size(mk_symbol_table_ref symbol_table)
+{
+    if (symbol_table.symbol_table == NULL) return 0;
+    
+    uint32_t first, count;
+    _mk_symbol_name_index_get_range(symbol_table, &first, &count);
+    
+    return (size_t)_mk_symbol_name_index_get_capacity(count) * sizeof(mk_symbol_name_index_entry_t);
+}
+
+//|++++++++++++++++++++++++++++++++++++|//
+mk_error_t
+mk_symbol_name_index_init(mk_symbol_table_ref symbol_table, mk_string_table_ref string_table, void *buffer, size_t buffer_size, mk_symbol_name_index_t *symbol_name_index)
+{
+    if (symbol_name_index == NULL) return MK_EINVAL;
+    if (symbol_table.symbol_table == NULL) return MK_EINVAL;
+    if (string_table.string_table == NULL) return MK_EINVAL;
+    if (buffer == NULL && buffer_size != 0) return MK_EINVAL;
+    
+    mk_context_t *ctx = mk_type_get_context(symbol_table.type);
+    
+    uint32_t first, count;
+    _mk_symbol_name_index_get_range(symbol_table, &first, &count);
+    
+    uint32_t capacity = _mk_symbol_name_index_get_capacity(count);
+    if (capacity == 0 && count != 0) {
+        _mkl_debug(ctx, "Symbol table with [%" PRIu32 "] symbols is too large to index.", count);
+        return MK_EOVERFLOW;
+    }
+    
+    size_t required_size = (size_t)capacity * sizeof(mk_symbol_name_index_entry_t);
+    if (buffer_size < required_size) {
+        _mkl_debug(ctx, "Buffer of size [%zu] is smaller than the [%zu] bytes needed to index the symbol table.", buffer_size, required_size);
+        return MK_ESIZE;
+    }
+    
+    symbol_name_index->symbol_table = symbol_table;
+    symbol_name_index->string_table = string_table;
+    symbol_name_index->entries = buffer;
+    symbol_name_index->capacity = capacity;
+    symbol_name_index->count = 0;
+    
+    for (uint32_t i = 0; i < capacity; i++)
+        symbol_name_index->entries[i].symbol_index = _MK_SYMBOL_NAME_INDEX_EMPTY;
+    
+    for (uint32_t index = first; index < first + count; index++)
+    {
+        size_t max_len;
+        const char *name = _mk_symbol_name_index_get_name(symbol_table, string_table, index, &max_len);
+        if (name == NULL)
+            continue;
+        
+        uint32_t hash = _mk_symbol_name_index_hash(name, max_len);
+        mk_symbol_name_index_entry_t *entry = _mk_symbol_name_index_probe(symbol_name_index, name, max_len, hash);
+        if (entry->symbol_index != _MK_SYMBOL_NAME_INDEX_EMPTY)
+            continue;
+        
+        entry->hash = hash;
+        entry->symbol_index = index;
+        symbol_name_index->count++;
+    }
+    
+    symbol_name_index->vtable = &_mk_symbol_name_index_class;
+    return MK_ESUCCESS;
+}
+
+//|++++++++++++++++++++++++++++++++++++|//
+void
+mk_symbol_name_index_free(mk_symbol_name_index_ref symbol_name_index)
+{
+    symbol_name_index.symbol_name_index->entries = NULL;
+    symbol_name_index.symbol_name_index->capacity = 0;
+    symbol_name_index.symbol_name_index->count = 0;
+    symbol_name_index.symbol_name_index->vtable = NULL;
+}
+
+//|++++++++++++++++++++++++++++++++++++|//
+mk_symbol_table_ref
+mk_symbol_name_index_get_symbol_table(mk_symbol_name_index_ref symbol_name_index)
+{ return symbol_name_index.symbol_name_index->symbol_table; }
+
+//|++++++++++++++++++++++++++++++++++++|//
+uint32_t
+mk_symbol_name_index_get_count(mk_symbol_name_index_ref symbol_name_index)
+{ return symbol_name_index.symbol_name_index->count; }
+
+//----------------------------------------------------------------------------//
+#pragma mark -  Looking Up Symbols
+//----------------------------------------------------------------------------//
+
+//|++++++++++++++++++++++++++++++++++++|//
+mk_macho_nlist_ptr
+mk_symbol_name_index_find_symbol(mk_symbol_name_index_ref symbol_name_index, const char *name, uint32_t *index, mk_vm_address_t* target_address)
+{
+    if (name == NULL) return (mk_macho_nlist_ptr)NULL;
+    if (symbol_name_index.symbol_name_index->capacity == 0) return (mk_macho_nlist_ptr)NULL;
+    
+    size_t name_len = strlen(name) + 1;
+    uint32_t hash = _mk_symbol_name_index_hash(name, name_len);
+    
+    mk_symbol_name_index_entry_t *entry = _mk_symbol_name_index_probe(symbol_name_index.symbol_name_index, name, name_len, hash);
+    if (entry->symbol_index == _MK_SYMBOL_NAME_INDEX_EMPTY)
+        return (mk_macho_nlist_ptr)NULL;
+    
+    if (index) *index = entry->symbol_index;
+    return mk_symbol_table_get_mach_symbol_at_index(symbol_name_index.symbol_name_index->symbol_table, entry->symbol_index, target_address);
+}
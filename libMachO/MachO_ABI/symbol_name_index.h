@@ -0,0 +1,144 @@
+//----------------------------------------------------------------------------//
+//|
+//|             MachOKit - A Lightweight Mach-O Parsing Library
+//! @file       symbol_name_index.h
+//!
+//! @author     D.V.
+//! @copyright  Copyright (c) 2014-2015 D.V. All rights reserved.
+//|
+//| Permission is hereby granted, free of charge, to any person obtaining a
+//| copy of this software and associated documentation files (the "Software"),
+//| to deal in the Software without restriction, including without limitation
+//| the rights to use, copy, modify, merge, publish, distribute, sublicense,
+//| and/or sell copies of the Software, and to permit persons to whom the
+//| Software is furnished to do so, subject to the following conditions:
+//|
+//| The above copyright notice and this permission notice shall be included
+//| in all copies or substantial portions of the Software.
+//|
+//| THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+//| OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+//| MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+//| IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+//| CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+//| TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+//| SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+//----------------------------------------------------------------------------//
+
+
+#ifndef _symbol_name_index_h
+#define _symbol_name_index_h
+
+//! @addtogroup MACH
+//! @{
+//!
+
+//----------------------------------------------------------------------------//
+#pragma mark -  Types
+//! @name       Types
+//----------------------------------------------------------------------------//
+
+//◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦//
+//! @internal
+//
+typedef struct mk_symbol_name_index_entry_s {
+    uint32_t hash;
+    uint32_t symbol_index;
+} mk_symbol_name_index_entry_t;
+
+//◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦//
+//! @internal
+//
+typedef struct mk_symbol_name_index_s {
+    __MK_RUNTIME_BASE
+    // The symbol table that was indexed.
+    mk_symbol_table_ref symbol_table;
+    // The string table holding the names of the symbols.
+    mk_string_table_ref string_table;
+    // Open addressed hash table, in caller provided memory.
+    mk_symbol_name_index_entry_t *entries;
+    // Always zero or a power of two.
+    uint32_t capacity;
+    uint32_t count;
+} mk_symbol_name_index_t;
+
+//◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦//
+//! The Symbol Name Index polymorphic type.
+//
+typedef union {
+    mk_type_ref type;
+    struct mk_symbol_name_index_s *symbol_name_index;
+} mk_symbol_name_index_ref _mk_transparent_union;
+
+//! The identifier for the Symbol Name Index type.
+_mk_export intptr_t mk_symbol_name_index_type;
+
+
+//----------------------------------------------------------------------------//
+#pragma mark -  Working With Symbol Name Indexes
+//! @name       Working With Symbol Name Indexes
+//----------------------------------------------------------------------------//
+
+//! Returns the size of the buffer needed to index \a symbol_table.
+_mk_export size_t
+mk_symbol_name_index_get_required_size(mk_symbol_table_ref symbol_table);
+
+//! Initializes a Symbol Name Index object, hashing the names of the external
+//! symbols of \a symbol_table into \a buffer.  If several external symbols
+//! share a name, the one with the lowest index is kept.
+//!
+//! Images whose symbols are not sorted by name, such as object files, can
+//! not be searched efficiently by \ref mk_symbol_table_find_symbol_named.
+//! A symbol name index provides constant time lookups in these images.
+//!
+//! @param  symbol_table
+//!         The symbol table to index.  Must remain valid for the lifetime of
+//!         the symbol name index object.
+//! @param  string_table
+//!         The string table containing the names of the symbols in
+//!         \a symbol_table.  Must remain valid for the lifetime of the
+//!         symbol name index object.
+//! @param  buffer
+//!         Memory to hold the index entries.  Must be aligned for
+//!         \c uint32_t and remain valid for the lifetime of the symbol name
+//!         index object.
+//! @param  buffer_size
+//!         The size of \a buffer, which must be at least the size returned
+//!         by \ref mk_symbol_name_index_get_required_size.
+//! @param  symbol_name_index
+//!         A valid \ref mk_symbol_name_index_t structure.
+//! @return
+//! \ref MK_ESIZE if \a buffer is too small.
+_mk_export mk_error_t
+mk_symbol_name_index_init(mk_symbol_table_ref symbol_table, mk_string_table_ref string_table, void *buffer, size_t buffer_size, mk_symbol_name_index_t *symbol_name_index);
+
+//! Cleans up any resources held by \a symbol_name_index.  It is no longer
+//! safe to use \a symbol_name_index after calling this function.  The
+//! buffer provided at initialization is not freed.
+_mk_export void
+mk_symbol_name_index_free(mk_symbol_name_index_ref symbol_name_index);
+
+//! Returns the symbol table that the specified symbol name index was built
+//! from.
+_mk_export mk_symbol_table_ref
+mk_symbol_name_index_get_symbol_table(mk_symbol_name_index_ref symbol_name_index);
+
+//! Returns the number of symbols in the specified symbol name index.
+_mk_export uint32_t
+mk_symbol_name_index_get_count(mk_symbol_name_index_ref symbol_name_index);
+
+
+//----------------------------------------------------------------------------//
+#pragma mark -  Looking Up Symbols
+//! @name       Looking Up Symbols
+//----------------------------------------------------------------------------//
+
+//! Finds the external symbol named \a name.  Behaves like
+//! \ref mk_symbol_table_find_symbol_named.
+_mk_export mk_macho_nlist_ptr
+mk_symbol_name_index_find_symbol(mk_symbol_name_index_ref symbol_name_index, const char *name, uint32_t *index, mk_vm_address_t* target_address);
+
+
+//! @} MACH !//
+
+#endif /* _symbol_name_index_h */
@@ -106,6 +106,7 @@ mk_symbol_table_init(mk_segment_ref segment, mk_load_command_ref symtab_load_com
     
     symbol_table->link_edit = segment;
     symbol_table->target_range = mk_vm_range_make(vm_address, vm_size);
+    symbol_table->name_order = _MK_SYMBOL_TABLE_NAME_ORDER_UNKNOWN;
     
     // Make sure the symbol table is completely within the link_edit segment
     if ((err = mk_vm_range_contains_range(mk_segment_get_target_range(segment), symbol_table->target_range, false))) {
@@ -118,6 +119,8 @@ mk_symbol_table_init(mk_segment_ref segment, mk_load_command_ref symtab_load_com
     mk_load_command_copy(symtab_load_command, &symbol_table->symtab_command);
     if (dysymtab_load_command.load_command)
         mk_load_command_copy(dysymtab_load_command, &symbol_table->dysymtab_command);
+    else
+        memset(&symbol_table->dysymtab_command, 0, sizeof(symbol_table->dysymtab_command));
     
     symbol_table->vtable = &_mk_symbol_table_class;
     return MK_ESUCCESS;
@@ -312,3 +315,319 @@ mk_symbol_table_enumerate_mach_symbols(mk_symbol_table_ref symbol_table, uint32_
     } while (index < mk_symbol_table_get_symbol_count(symbol_table));
 }
 #endif
+
+//|++++++++++++++++++++++++++++++++++++|//
+static inline bool
+_mk_symbol_filter_matches(const mk_symbol_filter_t *filter, uintptr_t symbol, bool is64, const mk_byteorder_t *byte_order, mk_vm_slide_t slide)
+{
+    // n_type and n_sect are at the same offsets in both nlist variants, and
+    // are tested first as they are single bytes that need no swapping.
+    const struct nlist *nlist = (const struct nlist*)symbol;
+    
+    if ((nlist->n_type & filter->n_type_mask) != filter->n_type)
+        return false;
+    if (filter->n_type_any_mask && !(nlist->n_type & filter->n_type_any_mask))
+        return false;
+    if (filter->n_sect != NO_SECT && nlist->n_sect != filter->n_sect)
+        return false;
+    
+    if (filter->address_range.length) {
+        mk_vm_address_t n_value = is64 ? byte_order->swap64(((const struct nlist_64*)symbol)->n_value) : byte_order->swap32(nlist->n_value);
+        if (mk_vm_address_apply_slide(n_value, slide, &n_value))
+            return false;
+        if (mk_vm_range_contains_address(filter->address_range, 0, n_value))
+            return false;
+    }
+    
+    return true;
+}
+
+//|++++++++++++++++++++++++++++++++++++|//
+// Maps the symbols from index to the end of the symbol table.
+static uintptr_t
+_mk_symbol_table_remap_symbols_from_index(mk_symbol_table_ref symbol_table, uint32_t index, size_t size, mk_vm_address_t *target_address)
+{
+    mk_vm_size_t length;
+    
+    if (index >= mk_symbol_table_get_symbol_count(symbol_table))
+        return UINTPTR_MAX;
+    
+    if (mk_vm_address_add(symbol_table.symbol_table->target_range.location, (mk_vm_size_t)index * size, target_address))
+        return UINTPTR_MAX;
+    
+    if (mk_vm_address_subtract(symbol_table.symbol_table->target_range.length, (mk_vm_size_t)index * size, &length))
+        return UINTPTR_MAX;
+    
+    return mk_memory_object_remap_address(mk_segment_get_mapping(symbol_table.symbol_table->link_edit), 0, *target_address, length, NULL);
+}
+
+//|++++++++++++++++++++++++++++++++++++|//
+mk_macho_nlist_ptr
+mk_symbol_table_next_mach_symbol_matching(mk_symbol_table_ref symbol_table, const mk_symbol_filter_t *filter, const mk_macho_nlist_ptr previous, uint32_t* index, mk_vm_address_t* target_address)
+{
+    if (filter == NULL)
+        return mk_symbol_table_next_mach_symbol(symbol_table, previous, index, target_address);
+    
+    mk_macho_ref image = mk_symbol_table_get_macho(symbol_table);
+    const mk_byteorder_t *byte_order = mk_macho_get_byte_order(image);
+    mk_vm_slide_t slide = mk_macho_get_slide(image);
+    bool is64 = mk_macho_is_64_bit(image);
+    size_t size = is64 ? sizeof(struct nlist_64) : sizeof(struct nlist);
+    
+    uint32_t idx = 0;
+    if (previous.any != NULL) {
+        // Let mk_symbol_table_next_mach_symbol() validate previous.
+        if (mk_symbol_table_next_mach_symbol(symbol_table, previous, &idx, NULL).any == NULL)
+            return (mk_macho_nlist_ptr)NULL;
+    }
+    
+    mk_vm_address_t addr;
+    uintptr_t symbol = _mk_symbol_table_remap_symbols_from_index(symbol_table, idx, size, &addr);
+    if (symbol == UINTPTR_MAX)
+        return (mk_macho_nlist_ptr)NULL;
+    
+    for (uint32_t nsyms = mk_symbol_table_get_symbol_count(symbol_table); idx < nsyms; idx++, symbol += size, addr += size)
+    {
+        if (_mk_symbol_filter_matches(filter, symbol, is64, byte_order, slide)) {
+            if (index) *index = idx;
+            if (target_address) *target_address = addr;
+            return (mk_macho_nlist_ptr)(void*)symbol;
+        }
+    }
+    
+    return (mk_macho_nlist_ptr)NULL;
+}
+
+//|++++++++++++++++++++++++++++++++++++|//
+#if __BLOCKS__
+void
+mk_symbol_table_enumerate_mach_symbols_matching(mk_symbol_table_ref symbol_table, const mk_symbol_filter_t *filter, uint32_t index, void (^enumerator)(const mk_macho_nlist_ptr symbol, uint32_t index, mk_vm_address_t target_address))
+{
+    if (filter == NULL) {
+        mk_symbol_table_enumerate_mach_symbols(symbol_table, index, enumerator);
+        return;
+    }
+    
+    mk_macho_ref image = mk_symbol_table_get_macho(symbol_table);
+    const mk_byteorder_t *byte_order = mk_macho_get_byte_order(image);
+    mk_vm_slide_t slide = mk_macho_get_slide(image);
+    bool is64 = mk_macho_is_64_bit(image);
+    size_t size = is64 ? sizeof(struct nlist_64) : sizeof(struct nlist);
+    
+    mk_vm_address_t target_address;
+    uintptr_t symbol = _mk_symbol_table_remap_symbols_from_index(symbol_table, index, size, &target_address);
+    if (symbol == UINTPTR_MAX)
+        return;
+    
+    for (uint32_t nsyms = mk_symbol_table_get_symbol_count(symbol_table); index < nsyms; index++, symbol += size, target_address += size)
+    {
+        if (_mk_symbol_filter_matches(filter, symbol, is64, byte_order, slide))
+            enumerator((mk_macho_nlist_ptr)(void*)symbol, index, target_address);
+    }
+}
+#endif
+
+//|++++++++++++++++++++++++++++++++++++|//
+// The symbol and string tables, each mapped once for a lookup by name.
+struct _mk_symbol_table_name_lookup {
+    uintptr_t nlists;
+    size_t nlist_size;
+    uint32_t nsyms;
+    const mk_byteorder_t *byte_order;
+    const char *strings;
+    size_t strings_size;
+};
+
+//|++++++++++++++++++++++++++++++++++++|//
+static bool
+_mk_symbol_table_name_lookup_init(mk_symbol_table_ref symbol_table, mk_string_table_ref string_table, struct _mk_symbol_table_name_lookup *lookup)
+{
+    mk_macho_ref image = mk_symbol_table_get_macho(symbol_table);
+    mk_vm_range_t strings_range = mk_string_table_get_target_range(string_table);
+    mk_vm_address_t target_address;
+    
+    lookup->nlist_size = mk_macho_is_64_bit(image) ? sizeof(struct nlist_64) : sizeof(struct nlist);
+    lookup->nsyms = mk_symbol_table_get_symbol_count(symbol_table);
+    lookup->byte_order = mk_macho_get_byte_order(image);
+    
+    if (lookup->nsyms == 0 || lookup->nsyms == UINT32_MAX || strings_range.length == 0)
+        return false;
+    
+    lookup->nlists = _mk_symbol_table_remap_symbols_from_index(symbol_table, 0, lookup->nlist_size, &target_address);
+    if (lookup->nlists == UINTPTR_MAX)
+        return false;
+    
+    uintptr_t strings = mk_memory_object_remap_address(mk_segment_get_mapping(mk_string_table_get_segment(string_table)), 0, strings_range.location, strings_range.length, NULL);
+    if (strings == UINTPTR_MAX)
+        return false;
+    
+    lookup->strings = (const char*)strings;
+    lookup->strings_size = (size_t)strings_range.length;
+    return true;
+}
+
+//|++++++++++++++++++++++++++++++++++++|//
+// Returns the name of the symbol at index, or NULL if its string table
+// offset is out of range.  max_len is populated with the number of bytes
+// remaining in the string table from the start of the name.
+static const char*
+_mk_symbol_table_name_lookup_get_name(const struct _mk_symbol_table_name_lookup *lookup, uint32_t index, size_t *max_len)
+{
+    // n_strx is at the same offset in both nlist variants.
+    const struct nlist *nlist = (const struct nlist*)(lookup->nlists + (size_t)index * lookup->nlist_size);
+    uint32_t strx = lookup->byte_order->swap32(nlist->n_un.n_strx);
+    if (strx >= lookup->strings_size)
+        return NULL;
+    
+    *max_len = lookup->strings_size - strx;
+    return lookup->strings + strx;
+}
+
+//|++++++++++++++++++++++++++++++++++++|//
+// Compares the name of the symbol at index with name, in the manner of
+// strcmp(3).  Symbols that can not be read sort after every name.
+static int
+_mk_symbol_table_name_lookup_compare(const struct _mk_symbol_table_name_lookup *lookup, uint32_t index, const char *name)
+{
+    size_t max_len;
+    const char *string = _mk_symbol_table_name_lookup_get_name(lookup, index, &max_len);
+    if (string == NULL)
+        return 1;
+    
+    int result = strncmp(string, name, max_len);
+    
+    // A name that runs to the end of the string table without a terminator
+    // only matches if name ends there too.  Otherwise it is a prefix of name,
+    // and sorts before it.
+    if (result == 0 && memchr(string, '\0', max_len) == NULL && name[max_len] != '\0')
+        return -1;
+    
+    return result;
+}
+
+//|++++++++++++++++++++++++++++++++++++|//
+// Returns true if the count symbols beginning at first are sorted by name
+// and can all be read.
+static bool
+_mk_symbol_table_name_lookup_range_is_sorted(const struct _mk_symbol_table_name_lookup *lookup, uint32_t first, uint32_t count)
+{
+    const char *previous = NULL;
+    size_t previous_max_len = 0;
+    
+    for (uint32_t index = first; index < first + count; index++) {
+        size_t max_len;
+        const char *string = _mk_symbol_table_name_lookup_get_name(lookup, index, &max_len);
+        if (string == NULL)
+            return false;
+        
+        if (previous && strncmp(previous, string, previous_max_len) > 0)
+            return false;
+        
+        previous = string;
+        previous_max_len = max_len;
+    }
+    
+    return true;
+}
+
+//|++++++++++++++++++++++++++++++++++++|//
+// Binary searches the count symbols beginning at first, which must be
+// sorted by name.
+static bool
+_mk_symbol_table_name_lookup_search_sorted_range(const struct _mk_symbol_table_name_lookup *lookup, uint32_t first, uint32_t count, const char *name, uint32_t *index)
+{
+    uint32_t lo = first, hi = first + count;
+    while (lo < hi) {
+        uint32_t mid = lo + (hi - lo) / 2;
+        int result = _mk_symbol_table_name_lookup_compare(lookup, mid, name);
+        if (result == 0) {
+            *index = mid;
+            return true;
+        } else if (result < 0)
+            lo = mid + 1;
+        else
+            hi = mid;
+    }
+    
+    return false;
+}
+
+//|++++++++++++++++++++++++++++++++++++|//
+mk_macho_nlist_ptr
+mk_symbol_table_find_symbol_named(mk_symbol_table_ref symbol_table, mk_string_table_ref string_table, const char *name, uint32_t *index, mk_vm_address_t* target_address)
+{
+    if (symbol_table.symbol_table == NULL) return (mk_macho_nlist_ptr)NULL;
+    if (string_table.string_table == NULL) return (mk_macho_nlist_ptr)NULL;
+    if (name == NULL) return (mk_macho_nlist_ptr)NULL;
+    
+    // Map the symbol and string tables once, rather than for each symbol
+    // compared.
+    struct _mk_symbol_table_name_lookup lookup;
+    if (!_mk_symbol_table_name_lookup_init(symbol_table, string_table, &lookup))
+        return (mk_macho_nlist_ptr)NULL;
+    
+    uint32_t nsyms = lookup.nsyms;
+    mk_load_command_ref dysymtab = mk_symbol_table_get_dysymtab_load_command(symbol_table);
+    uint32_t found;
+    
+    // Object files are not sorted.
+    if (dysymtab.load_command->vtable != NULL && mk_macho_get_filetype(mk_symbol_table_get_macho(symbol_table)) != MH_OBJECT)
+    {
+        uint32_t first[2] = { mk_load_command_dysymtab_get_iextdefsym(dysymtab), mk_load_command_dysymtab_get_iundefsym(dysymtab) };
+        uint32_t count[2] = { mk_load_command_dysymtab_get_nextdefsym(dysymtab), mk_load_command_dysymtab_get_nundefsym(dysymtab) };
+        
+        // Clamp the ranges to the symbol table.
+        for (int i = 0; i < 2; i++) {
+            first[i] = MIN(first[i], nsyms);
+            count[i] = MIN(count[i], nsyms - first[i]);
+        }
+        
+        // A malformed image may not be sorted, in which case a binary search
+        // could miss symbols.  Check once, and remember the result.  Lookups
+        // may run concurrently; every thread computes the same order, and
+        // the first to finish publishes it.
+        uint8_t name_order = __atomic_load_n(&symbol_table.symbol_table->name_order, __ATOMIC_ACQUIRE);
+        if (name_order == _MK_SYMBOL_TABLE_NAME_ORDER_UNKNOWN) {
+            bool sorted = _mk_symbol_table_name_lookup_range_is_sorted(&lookup, first[0], count[0]) &&
+                          _mk_symbol_table_name_lookup_range_is_sorted(&lookup, first[1], count[1]);
+            uint8_t expected = _MK_SYMBOL_TABLE_NAME_ORDER_UNKNOWN;
+            name_order = sorted ? _MK_SYMBOL_TABLE_NAME_ORDER_SORTED : _MK_SYMBOL_TABLE_NAME_ORDER_UNSORTED;
+            
+            if (!__atomic_compare_exchange_n(&symbol_table.symbol_table->name_order, &expected, name_order, false, __ATOMIC_RELEASE, __ATOMIC_ACQUIRE))
+                name_order = expected;
+            else if (!sorted)
+                _mkl_debug(mk_type_get_context(symbol_table.type), "External symbols are not sorted by name.  Falling back to a linear search.");
+        }
+        
+        if (name_order == _MK_SYMBOL_TABLE_NAME_ORDER_SORTED)
+        {
+            for (int i = 0; i < 2; i++) {
+                if (_mk_symbol_table_name_lookup_search_sorted_range(&lookup, first[i], count[i], name, &found))
+                    goto found;
+            }
+            
+            return (mk_macho_nlist_ptr)NULL;
+        }
+    }
+    
+    // Compare the name of every external symbol.
+    {
+        mk_symbol_filter_t filter = { .n_type_mask = N_STAB, .n_type = 0, .n_type_any_mask = N_EXT };
+        mk_vm_slide_t slide = mk_macho_get_slide(mk_symbol_table_get_macho(symbol_table));
+        bool is64 = (lookup.nlist_size == sizeof(struct nlist_64));
+        
+        for (found = 0; found < nsyms; found++) {
+            uintptr_t symbol = lookup.nlists + (size_t)found * lookup.nlist_size;
+            if (_mk_symbol_filter_matches(&filter, symbol, is64, lookup.byte_order, slide) &&
+                _mk_symbol_table_name_lookup_compare(&lookup, found, name) == 0)
+                goto found;
+        }
+    }
+    
+    return (mk_macho_nlist_ptr)NULL;
+    
+found:
+    if (index) *index = found;
+    if (target_address) *target_address = symbol_table.symbol_table->target_range.location + (mk_vm_offset_t)found * lookup.nlist_size;
+    return (mk_macho_nlist_ptr)(void*)(lookup.nlists + (size_t)found * lookup.nlist_size);
+}
@@ -50,6 +50,10 @@ typedef struct mk_symbol_table_s {
     mk_load_command_t symtab_command;
     //! Dynamic Symbol Table information.
     mk_load_command_t dysymtab_command;
+    //! Whether the external defined and undefined symbols are sorted by
+    //! name.  Determined by the first lookup by name, and published
+    //! atomically.
+    uint8_t name_order;
 } mk_symbol_table_t;
 
 
@@ -65,6 +69,35 @@ typedef union {
 _mk_export intptr_t mk_symbol_table_type;
 
 
+//◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦◦//
+//! Selects the symbols visited by
+//! \ref mk_symbol_table_enumerate_mach_symbols_matching and
+//! \ref mk_symbol_table_next_mach_symbol_matching.  A zeroed filter matches
+//! every symbol.
+//!
+//! For example, the defined external symbols are matched by a
+//! \c n_type_mask of <tt>N_STAB | N_TYPE | N_EXT</tt> and a \c n_type of
+//! <tt>N_SECT | N_EXT</tt>, and the debugging symbols by a
+//! \c n_type_any_mask of \c N_STAB.
+//
+typedef struct mk_symbol_filter_s {
+    //! The bits of \c n_type to compare with \c n_type.
+    uint8_t n_type_mask;
+    //! The value that <tt>n_type & n_type_mask</tt> must equal.
+    uint8_t n_type;
+    //! If not zero, at least one of these bits of \c n_type must be set.
+    uint8_t n_type_any_mask;
+    //! The ordinal of the section that symbols must be defined in, or
+    //! \c NO_SECT to match symbols in any section.
+    uint8_t n_sect;
+    //! If not empty, the range of addresses (in the target address space,
+    //! after applying the slide) that \c n_value must fall within.  Combine
+    //! with a \c n_type of \c N_SECT as \c n_value is not an address for
+    //! other types of symbols.
+    mk_vm_range_t address_range;
+} mk_symbol_filter_t;
+
+
 //----------------------------------------------------------------------------//
 #pragma mark -  Includes
 //----------------------------------------------------------------------------//
@@ -149,6 +182,30 @@ mk_symbol_table_get_mach_symbol_at_index(mk_symbol_table_ref symbol_table, uint3
 _mk_export mk_macho_nlist_ptr
 mk_symbol_table_next_mach_symbol(mk_symbol_table_ref symbol_table, const mk_macho_nlist_ptr previous, uint32_t* index, mk_vm_address_t* target_address);
 
+//! Finds the external (defined or undefined) symbol named \a name, returning
+//! a pointer to its nlist entry, or \c NULL if the symbol table does not
+//! contain an external symbol with that name.
+//!
+//! The linker sorts the external defined and undefined symbols of an image
+//! by name.  If the symbol table has an associated LC_DYSYMTAB and does not
+//! belong to an object file, those ranges are binary searched.  The first
+//! lookup verifies that they are sorted.  Otherwise every symbol is compared
+//! against \a name.  Use a
+//! \ref mk_symbol_name_index_t to perform repeated lookups in such images.
+//!
+//! @param  symbol_table
+//!         The symbol table to search.
+//! @param  string_table
+//!         The string table containing the names of the symbols in
+//!         \a symbol_table.
+//! @param  name
+//!         The (mangled) name of the symbol to find, including any leading
+//!         underscore.
+//! @param  index
+//!         If not \c NULL, populated with the index of the found symbol.
+_mk_export mk_macho_nlist_ptr
+mk_symbol_table_find_symbol_named(mk_symbol_table_ref symbol_table, mk_string_table_ref string_table, const char *name, uint32_t *index, mk_vm_address_t* target_address);
+
 #if __BLOCKS__
 //! Iterate over the symbols in the specified symbol table using a block.
 _mk_export void
@@ -156,6 +213,20 @@ mk_symbol_table_enumerate_mach_symbols(mk_symbol_table_ref symbol_table, uint32_
                                        void (^enumerator)(const mk_macho_nlist_ptr symbol, uint32_t index, mk_vm_address_t target_address));
 #endif
 
+//! Iterate over the symbols in the specified symbol table that match
+//! \a filter, skipping the rest without returning to the caller.
+_mk_export mk_macho_nlist_ptr
+mk_symbol_table_next_mach_symbol_matching(mk_symbol_table_ref symbol_table, const mk_symbol_filter_t *filter, const mk_macho_nlist_ptr previous, uint32_t* index, mk_vm_address_t* target_address);
+
+#if __BLOCKS__
+//! Iterate over the symbols in the specified symbol table that match
+//! \a filter using a block.  The remainder of the symbol table is mapped
+//! once, and \a enumerator is only invoked for matching symbols.
+_mk_export void
+mk_symbol_table_enumerate_mach_symbols_matching(mk_symbol_table_ref symbol_table, const mk_symbol_filter_t *filter, uint32_t index,
+                                                void (^enumerator)(const mk_macho_nlist_ptr symbol, uint32_t index, mk_vm_address_t target_address));
+#endif
+
 
 //! @} MACH !//
 
@@ -51,6 +51,13 @@ struct _mk_symbol_table_vtable {
 _mk_internal_extern
 const struct _mk_symbol_table_vtable _mk_symbol_table_class;
 
+//! Values of \c mk_symbol_table_t.name_order.
+enum {
+    _MK_SYMBOL_TABLE_NAME_ORDER_UNKNOWN = 0,
+    _MK_SYMBOL_TABLE_NAME_ORDER_SORTED,
+    _MK_SYMBOL_TABLE_NAME_ORDER_UNSORTED
+};
+
 
 //! @} MACH !//
 
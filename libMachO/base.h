@@ -55,6 +55,13 @@
 #   define _mk_unused
 #endif
 
+#ifndef __has_feature
+#   define __has_feature(x) 0
+#endif
+#ifndef __has_extension
+#   define __has_extension(x) __has_feature(x)
+#endif
+
 
 //----------------------------------------------------------------------------//
 #pragma mark -  Declarations
@@ -30,6 +30,19 @@
 
 #include <sys/param.h>
 #include <inttypes.h>
+#include <string.h>
+
+#ifdef __APPLE__
+#include <libkern/OSByteOrder.h>
+#else
+#define OSSwapInt16(x) __builtin_bswap16(x)
+#define OSSwapInt32(x) __builtin_bswap32(x)
+#define OSSwapInt64(x) __builtin_bswap64(x)
+#endif
+
+#ifndef __unused
+#define __unused __attribute__((__unused__))
+#endif
 
 #if __MACHOKIT__
 #include <objc/runtime.h>